@@ -52,6 +52,7 @@
 #     DEAL_II_WITH_COMPLEX_VALUES
 #     DEAL_II_DOXYGEN_USE_MATHJAX
 #     DEAL_II_COMPILE_EXAMPLES
+#     FE_EVAL_FACTORY_DEGREE_MAX
 #     DEAL_II_CPACK_BUNDLE_NAME
 #     DEAL_II_CPACK_EXTERNAL_LIBS
 #
@@ -396,6 +397,16 @@ OPTION(DEAL_II_DOXYGEN_USE_ONLINE_MATHJAX
   )
 MARK_AS_ADVANCED(DEAL_II_DOXYGEN_USE_ONLINE_MATHJAX)
 
+SET(FE_EVAL_FACTORY_DEGREE_MAX "9" CACHE STRING
+    "The maximal polynomial degree for which the matrix-free evaluators with the degree given at run time (FEEvaluation with fe_degree=-1) dispatch to precompiled sum factorization kernels. Higher degrees use a slower generic kernel. Increasing this value increases the compile time and size of the library."
+  )
+MARK_AS_ADVANCED(FE_EVAL_FACTORY_DEGREE_MAX)
+IF(NOT FE_EVAL_FACTORY_DEGREE_MAX MATCHES "^[0-9]+$")
+  MESSAGE(FATAL_ERROR
+    "FE_EVAL_FACTORY_DEGREE_MAX must be a non-negative integer, but is set to \"${FE_EVAL_FACTORY_DEGREE_MAX}\"."
+    )
+ENDIF()
+
 SET(DEAL_II_CPACK_EXTERNAL_LIBS "opt" CACHE STRING
     "A relative path to tree of external libraries that will be installed in bundle package. The path is relative to the /Applications/${DEAL_II_CPACK_BUNDLE_NAME}.app/Contents/Resources directory. It defaults to opt, but you may want to use a different value, for example if you want to distribute a brew based package."
   )
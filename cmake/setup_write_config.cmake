@@ -157,6 +157,7 @@ IF(CMAKE_BUILD_TYPE MATCHES "Debug")
   _detailed("#        DEAL_II_LIBRARIES_DEBUG:      ${BASE_LIBRARIES_DEBUG}\n")
 ENDIF()
 _detailed("#        DEAL_II_COMPILER_VECTORIZATION_LEVEL: ${DEAL_II_COMPILER_VECTORIZATION_LEVEL}\n")
+_detailed("#        FE_EVAL_FACTORY_DEGREE_MAX:   ${FE_EVAL_FACTORY_DEGREE_MAX}\n")
 
 _detailed("#\n")
 
@@ -558,6 +558,21 @@ namespace internal
   {
     return poly.get_numbering_inverse();
   }
+
+  template <int dim>
+  inline std::vector<unsigned int>
+  get_poly_space_numbering(const TensorProductPolynomialsBubbles<dim> &poly)
+  {
+    return poly.get_numbering();
+  }
+
+  template <int dim>
+  inline std::vector<unsigned int>
+  get_poly_space_numbering_inverse(
+    const TensorProductPolynomialsBubbles<dim> &poly)
+  {
+    return poly.get_numbering_inverse();
+  }
 } // namespace internal
 
 
@@ -21,11 +21,13 @@
 #include <deal.II/base/config.h>
 
 #include <deal.II/base/memory_space.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/parallel.h>
 #include <deal.II/base/smartpointer.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/vectorization.h>
 
 #include <deal.II/lac/diagonal_matrix.h>
 #include <deal.II/lac/solver_cg.h>
@@ -423,18 +425,39 @@ public:
     /**
      * Constructor.
      */
-    AdditionalData(const double relaxation = 1.);
+    AdditionalData(const double relaxation        = 1.,
+                   const bool   use_multicoloring = false);
 
     /**
      * Relaxation parameter.
      */
     double relaxation;
+
+    /**
+     * If true, PreconditionSOR and PreconditionSSOR do not visit the rows of
+     * the matrix in their natural order, but color them such that rows of
+     * the same color are not coupled, and relax the rows of one color in
+     * parallel before moving on to the next color. The coloring is computed
+     * by SparseMatrix::compute_multicoloring() when the preconditioner is
+     * initialized. This changes the order of the sweeps and therefore the
+     * result of the preconditioner, but typically not its quality as a
+     * smoother, and allows it to use all threads given by
+     * MultithreadInfo::n_threads(). This option is only available for
+     * SparseMatrix.
+     *
+     * PreconditionJacobi does not need this option since its rows are
+     * independent anyway, and PreconditionPSOR ignores it since it visits
+     * the rows in the order prescribed by its own permutation.
+     */
+    bool use_multicoloring;
   };
 
   /**
    * Initialize matrix and relaxation parameter. The matrix is just stored in
    * the preconditioner object. The relaxation parameter should be larger than
-   * zero and smaller than 2 for numerical reasons. It defaults to 1.
+   * zero and smaller than 2 for numerical reasons. It defaults to 1. If
+   * requested by the @p parameters, the coloring of the rows is computed
+   * here.
    */
   void
   initialize(const MatrixType &    A,
@@ -470,6 +493,23 @@ protected:
    * Relaxation parameter.
    */
   double relaxation;
+
+  /**
+   * The rows of the matrix sorted by their color if
+   * AdditionalData::use_multicoloring is set, and empty otherwise.
+   */
+  std::vector<types::global_dof_index> multicolor_permutation;
+
+  /**
+   * The inverse of #multicolor_permutation.
+   */
+  std::vector<types::global_dof_index> multicolor_inverse_permutation;
+
+  /**
+   * The position of the first row of each color in #multicolor_permutation,
+   * plus the number of rows as the last element.
+   */
+  std::vector<types::global_dof_index> color_starts;
 };
 
 
@@ -948,6 +988,32 @@ private:
  * AdditionalData::eig_cg_n_iterations to zero, and provide the variable
  * AdditionalData::max_eigenvalue instead. The minimal eigenvalue is
  * implicitly specified via `max_eigenvalue/smoothing_range`.
+ *
+ * <h4>Reusing the eigenvalue estimates</h4>
+ *
+ * The eigenvalue computation is repeated whenever initialize() is called,
+ * which can dominate the setup cost when the matrix changes only slightly
+ * between calls, e.g. for the multigrid smoothers in nonlinear or
+ * time-dependent problems. There are two ways to make repeated setups cheap:
+ * <ul>
+ * <li> The estimate obtained for a matrix can be queried by
+ * get_eigenvalue_information() (or as the return value of an explicit call
+ * to estimate_eigenvalues()), stored, and passed into later calls of
+ * initialize() via AdditionalData::max_eigenvalue together with
+ * AdditionalData::eig_cg_n_iterations set to zero.
+ * <li> The eigenvalues can be estimated by a power iteration by setting
+ * AdditionalData::eigenvalue_algorithm to
+ * AdditionalData::EigenvalueAlgorithm::power_iteration. With
+ * AdditionalData::eig_warm_start set, the iteration starts from the
+ * eigenvector approximation of the previous estimate, which is kept by
+ * initialize(), and usually stops after two or three matrix-vector products
+ * for a slightly changed matrix. If the initial vector is zero, as for the
+ * default initial guess on a single unknown, no iteration is performed and
+ * the largest eigenvalue is set to one, like for the Lanczos iteration when
+ * it does not return any eigenvalue.
+ * </ul>
+ * The EigenvalueInformation returned by get_eigenvalue_information() also
+ * reports the number of iterations spent in the last estimate.
 
  * <h4>Using the PreconditionChebyshev as a solver</h4>
  *
@@ -997,6 +1063,15 @@ private:
  * compatibility function that can extract the diagonal in case of a serial
  * computation.
  *
+ * If the vector type is LinearAlgebra::distributed::Vector, the
+ * preconditioner is a DiagonalMatrix, and the matrix provides a function
+ * <tt>vmult(dst, src, operation_before, operation_after)</tt> with two
+ * <tt>std::function<void(const unsigned int, const unsigned int)></tt>
+ * arguments as described in the documentation of SolverCG, e.g. implemented
+ * with MatrixFree::cell_loop(), the vector updates of the Chebyshev iteration
+ * are done inside the matrix-vector product on the entries the product has
+ * finished with, avoiding a separate sweep through the vectors.
+ *
  * @author Martin Kronbichler, 2009, 2016; extension for full compatibility with
  * LinearOperator class: Jean-Paul Pelteret, 2015
  */
@@ -1079,6 +1154,92 @@ public:
      * Stores the preconditioner object that the Chebyshev is wrapped around.
      */
     std::shared_ptr<PreconditionerType> preconditioner;
+
+    /**
+     * The algorithms available for estimating the eigenvalues.
+     */
+    enum class EigenvalueAlgorithm
+    {
+      /**
+       * The Lanczos iteration embedded in the conjugate gradient method,
+       * which estimates both the largest and the smallest eigenvalue.
+       */
+      lanczos,
+      /**
+       * The power iteration, which only estimates the largest eigenvalue and
+       * thus requires a @p smoothing_range larger than one. The iteration
+       * stops after @p eig_cg_n_iterations steps or as soon as the estimate
+       * changes by less than @p eig_cg_residual relative to its value. For a
+       * DiagonalMatrix as preconditioner and deal.II's own vectors, the
+       * application of the preconditioner and the two inner products of each
+       * step are fused into a single vectorized sweep through the vectors.
+       */
+      power_iteration
+    };
+
+    /**
+     * The algorithm used for estimating the eigenvalues. The default is
+     * EigenvalueAlgorithm::lanczos.
+     */
+    EigenvalueAlgorithm eigenvalue_algorithm;
+
+    /**
+     * If set to true and the eigenvalues are estimated by the power
+     * iteration, the iteration starts from the eigenvector approximation of
+     * the previous estimate, provided it is compatible with the vectors of
+     * the current matrix. Otherwise, the usual initial guess described in
+     * the class documentation is used. The default is false.
+     *
+     * For LinearAlgebra::distributed::Vector, all processes decide together
+     * whether their locally owned ranges are unchanged, and the estimate is
+     * copied into a vector with the layout of the current vectors. For other
+     * vector types, the warm start is only used if all entries of the
+     * vectors are stored on the present process.
+     */
+    bool eig_warm_start;
+  };
+
+  /**
+   * Information about the eigenvalue estimate and the resulting Chebyshev
+   * polynomial.
+   */
+  struct EigenvalueInformation
+  {
+    /**
+     * Estimate of the smallest eigenvalue.
+     */
+    double min_eigenvalue_estimate;
+
+    /**
+     * Estimate of the largest eigenvalue, including the safety factor
+     * applied to the result of the iterative eigenvalue algorithm. This is
+     * the value to be passed to AdditionalData::max_eigenvalue in order to
+     * reuse the estimate.
+     */
+    double max_eigenvalue_estimate;
+
+    /**
+     * Number of iterations performed by the eigenvalue algorithm, zero if
+     * the eigenvalues were given by AdditionalData::max_eigenvalue.
+     */
+    unsigned int cg_iterations;
+
+    /**
+     * Whether the power iteration started from the eigenvector approximation
+     * of a previous estimate.
+     */
+    bool warm_started;
+
+    /**
+     * The degree of the Chebyshev polynomial, which differs from
+     * AdditionalData::degree if the latter is numbers::invalid_unsigned_int.
+     */
+    unsigned int degree;
+
+    /**
+     * Constructor initializing with invalid values.
+     */
+    EigenvalueInformation();
   };
 
 
@@ -1145,7 +1306,33 @@ public:
   size_type
   n() const;
 
+  /**
+   * Estimate the eigenvalues of the preconditioned matrix and set up the
+   * coefficients of the Chebyshev polynomial. This function is called
+   * automatically by the first vmult(), Tvmult(), step() or Tstep() after
+   * initialize(), with @p src used as a template for the layout of the
+   * temporary vectors. It can also be called explicitly in order to move the
+   * cost out of the first application, or to obtain the estimate. Like
+   * vmult(), this function locks the temporary vectors of this object, so it
+   * may be called concurrently with the other operations.
+   */
+  EigenvalueInformation
+  estimate_eigenvalues(const VectorType &src) const;
+
+  /**
+   * Return the information of the last eigenvalue estimate, e.g. to reuse it
+   * in a later call to initialize() as described in the class documentation.
+   */
+  const EigenvalueInformation &
+  get_eigenvalue_information() const;
+
 private:
+  /**
+   * Implementation of estimate_eigenvalues(), called with #mutex held.
+   */
+  EigenvalueInformation
+  do_estimate_eigenvalues(const VectorType &src) const;
+
   /**
    * A pointer to the underlying matrix.
    */
@@ -1169,12 +1356,23 @@ private:
    */
   mutable VectorType temp_vector2;
 
+  /**
+   * The eigenvector approximation of the last power iteration, kept across
+   * calls to initialize() for warm starts.
+   */
+  mutable VectorType eigenvector_estimate;
+
   /**
    * Stores the additional data passed to the initialize function, obtained
    * through a copy operation.
    */
   AdditionalData data;
 
+  /**
+   * The information about the last eigenvalue estimate.
+   */
+  mutable EigenvalueInformation eigenvalue_information;
+
   /**
    * Average of the largest and smallest eigenvalue under consideration.
    */
@@ -1197,15 +1395,6 @@ private:
    * overwrite the temporary vectors.
    */
   mutable Threads::Mutex mutex;
-
-  /**
-   * Initializes the factors theta and delta based on an eigenvalue
-   * computation. If the user set provided values for the largest eigenvalue
-   * in AdditionalData, no computation is performed and the information given
-   * by the user is used.
-   */
-  void
-  estimate_eigenvalues(const VectorType &src) const;
 };
 
 
@@ -1381,6 +1570,132 @@ PreconditionRichardson::n() const
 
 //---------------------------------------------------------------------------
 
+namespace internal
+{
+  namespace PreconditionRelaxationImplementation
+  {
+    // The multicolored relaxation methods are only implemented for
+    // SparseMatrix and Vector, which are selected by the overloads below. For
+    // all other matrix and vector types, the generic versions throw an
+    // exception, also in release mode.
+    template <typename MatrixType>
+    void
+    compute_multicoloring(const MatrixType &,
+                          std::vector<types::global_dof_index> &,
+                          std::vector<types::global_dof_index> &,
+                          std::vector<types::global_dof_index> &)
+    {
+      AssertThrow(false,
+                  ExcMessage("Multicolored relaxation methods are only "
+                             "implemented for SparseMatrix."));
+    }
+
+    template <typename number>
+    void
+    compute_multicoloring(const SparseMatrix<number> &          A,
+                          std::vector<types::global_dof_index> &permutation,
+                          std::vector<types::global_dof_index> &inverse,
+                          std::vector<types::global_dof_index> &color_starts)
+    {
+      A.compute_multicoloring(permutation, inverse, color_starts);
+    }
+
+    template <typename MatrixType, typename VectorType>
+    void
+    multicolor_SOR(const MatrixType &,
+                   VectorType &,
+                   const VectorType &,
+                   const double,
+                   const bool,
+                   const std::vector<types::global_dof_index> &,
+                   const std::vector<types::global_dof_index> &,
+                   const std::vector<types::global_dof_index> &)
+    {
+      AssertThrow(false, ExcNotImplemented());
+    }
+
+    template <typename number, typename somenumber>
+    void
+    multicolor_SOR(const SparseMatrix<number> &                A,
+                   Vector<somenumber> &                        dst,
+                   const Vector<somenumber> &                  src,
+                   const double                                relaxation,
+                   const bool                                  transpose,
+                   const std::vector<types::global_dof_index> &permutation,
+                   const std::vector<types::global_dof_index> &inverse,
+                   const std::vector<types::global_dof_index> &color_starts)
+    {
+      dst = src;
+      if (transpose)
+        A.multicolor_TSOR(dst, permutation, inverse, color_starts, relaxation);
+      else
+        A.multicolor_SOR(dst, permutation, inverse, color_starts, relaxation);
+    }
+
+    template <typename MatrixType, typename VectorType>
+    void
+    multicolor_SSOR(const MatrixType &,
+                    VectorType &,
+                    const VectorType &,
+                    const double,
+                    const std::vector<types::global_dof_index> &,
+                    const std::vector<types::global_dof_index> &,
+                    const std::vector<types::global_dof_index> &)
+    {
+      AssertThrow(false, ExcNotImplemented());
+    }
+
+    template <typename number, typename somenumber>
+    void
+    multicolor_SSOR(const SparseMatrix<number> &                A,
+                    Vector<somenumber> &                        dst,
+                    const Vector<somenumber> &                  src,
+                    const double                                relaxation,
+                    const std::vector<types::global_dof_index> &permutation,
+                    const std::vector<types::global_dof_index> &inverse,
+                    const std::vector<types::global_dof_index> &color_starts)
+    {
+      A.precondition_multicolor_SSOR(
+        dst, src, permutation, inverse, color_starts, relaxation);
+    }
+
+    // Perform a forward, backward, or symmetric step, encoded in the two
+    // flags
+    template <typename MatrixType, typename VectorType>
+    void
+    multicolor_step(const MatrixType &,
+                    VectorType &,
+                    const VectorType &,
+                    const double,
+                    const bool,
+                    const bool,
+                    const std::vector<types::global_dof_index> &,
+                    const std::vector<types::global_dof_index> &)
+    {
+      AssertThrow(false, ExcNotImplemented());
+    }
+
+    template <typename number, typename somenumber>
+    void
+    multicolor_step(const SparseMatrix<number> &                A,
+                    Vector<somenumber> &                        v,
+                    const Vector<somenumber> &                  b,
+                    const double                                relaxation,
+                    const bool                                  forward,
+                    const bool                                  backward,
+                    const std::vector<types::global_dof_index> &permutation,
+                    const std::vector<types::global_dof_index> &color_starts)
+    {
+      if (forward)
+        A.multicolor_SOR_step(v, b, permutation, color_starts, relaxation);
+      if (backward)
+        A.multicolor_TSOR_step(v, b, permutation, color_starts, relaxation);
+    }
+  } // namespace PreconditionRelaxationImplementation
+} // namespace internal
+
+
+
 template <typename MatrixType>
 inline void
 PreconditionRelaxation<MatrixType>::initialize(const MatrixType &    rA,
@@ -1388,6 +1703,16 @@ PreconditionRelaxation<MatrixType>::initialize(const MatrixType &    rA,
 {
   A          = &rA;
   relaxation = parameters.relaxation;
+
+  if (parameters.use_multicoloring)
+    internal::PreconditionRelaxationImplementation::compute_multicoloring(
+      rA, multicolor_permutation, multicolor_inverse_permutation, color_starts);
+  else
+    {
+      multicolor_permutation.clear();
+      multicolor_inverse_permutation.clear();
+      color_starts.clear();
+    }
 }
 
 
@@ -1396,6 +1721,9 @@ inline void
 PreconditionRelaxation<MatrixType>::clear()
 {
   A = nullptr;
+  multicolor_permutation.clear();
+  multicolor_inverse_permutation.clear();
+  color_starts.clear();
 }
 
 template <typename MatrixType>
@@ -1495,7 +1823,18 @@ PreconditionSOR<MatrixType>::vmult(VectorType &dst, const VectorType &src) const
                 "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert(this->A != nullptr, ExcNotInitialized());
-  this->A->precondition_SOR(dst, src, this->relaxation);
+  if (this->color_starts.empty())
+    this->A->precondition_SOR(dst, src, this->relaxation);
+  else
+    internal::PreconditionRelaxationImplementation::multicolor_SOR(
+      *this->A,
+      dst,
+      src,
+      this->relaxation,
+      false,
+      this->multicolor_permutation,
+      this->multicolor_inverse_permutation,
+      this->color_starts);
 }
 
 
@@ -1511,7 +1850,18 @@ PreconditionSOR<MatrixType>::Tvmult(VectorType &      dst,
                 "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert(this->A != nullptr, ExcNotInitialized());
-  this->A->precondition_TSOR(dst, src, this->relaxation);
+  if (this->color_starts.empty())
+    this->A->precondition_TSOR(dst, src, this->relaxation);
+  else
+    internal::PreconditionRelaxationImplementation::multicolor_SOR(
+      *this->A,
+      dst,
+      src,
+      this->relaxation,
+      true,
+      this->multicolor_permutation,
+      this->multicolor_inverse_permutation,
+      this->color_starts);
 }
 
 
@@ -1526,7 +1876,18 @@ PreconditionSOR<MatrixType>::step(VectorType &dst, const VectorType &src) const
                 "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert(this->A != nullptr, ExcNotInitialized());
-  this->A->SOR_step(dst, src, this->relaxation);
+  if (this->color_starts.empty())
+    this->A->SOR_step(dst, src, this->relaxation);
+  else
+    internal::PreconditionRelaxationImplementation::multicolor_step(
+      *this->A,
+      dst,
+      src,
+      this->relaxation,
+      true,
+      false,
+      this->multicolor_permutation,
+      this->color_starts);
 }
 
 
@@ -1541,7 +1902,18 @@ PreconditionSOR<MatrixType>::Tstep(VectorType &dst, const VectorType &src) const
                 "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert(this->A != nullptr, ExcNotInitialized());
-  this->A->TSOR_step(dst, src, this->relaxation);
+  if (this->color_starts.empty())
+    this->A->TSOR_step(dst, src, this->relaxation);
+  else
+    internal::PreconditionRelaxationImplementation::multicolor_step(
+      *this->A,
+      dst,
+      src,
+      this->relaxation,
+      false,
+      true,
+      this->multicolor_permutation,
+      this->color_starts);
 }
 
 
@@ -1596,7 +1968,20 @@ PreconditionSSOR<MatrixType>::vmult(VectorType &      dst,
     "PreconditionSSOR and VectorType must have the same size_type.");
 
   Assert(this->A != nullptr, ExcNotInitialized());
-  this->A->precondition_SSOR(dst, src, this->relaxation, pos_right_of_diagonal);
+  if (this->color_starts.empty())
+    this->A->precondition_SSOR(dst,
+                               src,
+                               this->relaxation,
+                               pos_right_of_diagonal);
+  else
+    internal::PreconditionRelaxationImplementation::multicolor_SSOR(
+      *this->A,
+      dst,
+      src,
+      this->relaxation,
+      this->multicolor_permutation,
+      this->multicolor_inverse_permutation,
+      this->color_starts);
 }
 
 
@@ -1613,7 +1998,20 @@ PreconditionSSOR<MatrixType>::Tvmult(VectorType &      dst,
     "PreconditionSSOR and VectorType must have the same size_type.");
 
   Assert(this->A != nullptr, ExcNotInitialized());
-  this->A->precondition_SSOR(dst, src, this->relaxation, pos_right_of_diagonal);
+  if (this->color_starts.empty())
+    this->A->precondition_SSOR(dst,
+                               src,
+                               this->relaxation,
+                               pos_right_of_diagonal);
+  else
+    internal::PreconditionRelaxationImplementation::multicolor_SSOR(
+      *this->A,
+      dst,
+      src,
+      this->relaxation,
+      this->multicolor_permutation,
+      this->multicolor_inverse_permutation,
+      this->color_starts);
 }
 
 
@@ -1629,7 +2027,18 @@ PreconditionSSOR<MatrixType>::step(VectorType &dst, const VectorType &src) const
     "PreconditionSSOR and VectorType must have the same size_type.");
 
   Assert(this->A != nullptr, ExcNotInitialized());
-  this->A->SSOR_step(dst, src, this->relaxation);
+  if (this->color_starts.empty())
+    this->A->SSOR_step(dst, src, this->relaxation);
+  else
+    internal::PreconditionRelaxationImplementation::multicolor_step(
+      *this->A,
+      dst,
+      src,
+      this->relaxation,
+      true,
+      true,
+      this->multicolor_permutation,
+      this->color_starts);
 }
 
 
@@ -1749,8 +2158,10 @@ PreconditionUseMatrix<MatrixType, VectorType>::vmult(
 
 template <typename MatrixType>
 inline PreconditionRelaxation<MatrixType>::AdditionalData::AdditionalData(
-  const double relaxation)
+  const double relaxation,
+  const bool   use_multicoloring)
   : relaxation(relaxation)
+  , use_multicoloring(use_multicoloring)
 {}
 
 
@@ -1986,6 +2397,99 @@ namespace internal
         solution.swap(solution_old);
     }
 
+    // apply the matrix to the current solution and perform the vector
+    // updates of a step with iteration_index larger than zero. Generic
+    // version that runs the two operations one after the other
+    template <typename MatrixType,
+              typename VectorType,
+              typename PreconditionerType>
+    inline void
+    vmult_and_update(const MatrixType &        matrix,
+                     const PreconditionerType &preconditioner,
+                     const VectorType &        rhs,
+                     const unsigned int        iteration_index,
+                     const double              factor1,
+                     const double              factor2,
+                     VectorType &              solution_old,
+                     VectorType &              temp_vector1,
+                     VectorType &              temp_vector2,
+                     VectorType &              solution)
+    {
+      matrix.vmult(temp_vector1, solution);
+      vector_updates(rhs,
+                     preconditioner,
+                     iteration_index,
+                     factor1,
+                     factor2,
+                     solution_old,
+                     temp_vector1,
+                     temp_vector2,
+                     solution);
+    }
+
+    // selection for matrices that can run operations on ranges of the
+    // vectors before and after the matrix-vector product touches them, e.g.
+    // the ones based on MatrixFree::cell_loop(), and a diagonal matrix around
+    // a parallel deal.II vector. The vector updates are done on the entries
+    // of the vector as soon as the matrix-vector product has finished with
+    // them, while they are still in cache
+    template <typename MatrixType, typename Number>
+    inline typename std::enable_if<
+      internal::SolverCGImplementation::has_vmult_with_std_functions<
+        MatrixType,
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>::value>::
+      type
+      vmult_and_update(
+        const MatrixType &matrix,
+        const DiagonalMatrix<
+          LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>
+          &                jacobi,
+        const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>
+          &                rhs,
+        const unsigned int iteration_index,
+        const double       factor1,
+        const double       factor2,
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>
+          &solution_old,
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>
+          &temp_vector1,
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &,
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &solution)
+    {
+      Assert(iteration_index > 0, ExcInternalError());
+      const VectorUpdater<Number> updater(rhs.begin(),
+                                          jacobi.get_vector().begin(),
+                                          iteration_index,
+                                          factor1,
+                                          factor2,
+                                          solution_old.begin(),
+                                          temp_vector1.begin(),
+                                          solution.begin());
+      Number *const temp_ptr = temp_vector1.begin();
+
+      // the matrix adds into the destination vector, so we need to zero it
+      // (including the ghost entries used for the compress step) before
+      temp_vector1.zero_out_ghosts();
+      matrix.vmult(
+        temp_vector1,
+        solution,
+        [&](const unsigned int begin, const unsigned int end) {
+          std::fill(temp_ptr + begin, temp_ptr + end, Number());
+        },
+        [&](const unsigned int begin, const unsigned int end) {
+          updater.apply_to_subrange(begin, end);
+        });
+
+      // swap vectors x^{n+1}->x^{n}, given the updates in the function above
+      if (iteration_index == 1)
+        {
+          solution.swap(temp_vector1);
+          solution_old.swap(temp_vector1);
+        }
+      else
+        solution.swap(solution_old);
+    }
+
     template <typename MatrixType, typename PreconditionerType>
     inline void
     initialize_preconditioner(
@@ -2023,6 +2527,46 @@ namespace internal
         }
     }
 
+    // Check whether the previous eigenvector estimate in @p vector can be
+    // used as a starting guess for the vectors of the layout of @p src. This
+    // is only the case for vectors of the same size that are completely
+    // stored on the present process, because we can not tell in general
+    // whether all processes agree.
+    template <typename VectorType>
+    bool
+    keep_previous_eigenvector(VectorType &vector, const VectorType &src)
+    {
+      return vector.size() == src.size() &&
+             src.locally_owned_elements().n_elements() == src.size() &&
+             vector.locally_owned_elements() == src.locally_owned_elements();
+    }
+
+    // For distributed vectors, the processes decide together whether the
+    // locally owned ranges of the previous estimate match the ones of @p src.
+    // The vector is set up anew with the layout of @p src, including the
+    // ghost entries, and the locally owned values are copied over.
+    template <typename Number, typename MemorySpace>
+    bool
+    keep_previous_eigenvector(
+      ::dealii::LinearAlgebra::distributed::Vector<Number, MemorySpace> &vector,
+      const ::dealii::LinearAlgebra::distributed::Vector<Number, MemorySpace>
+        &src)
+    {
+      const bool is_compatible =
+        vector.size() == src.size() &&
+        vector.locally_owned_elements() == src.locally_owned_elements();
+      if (Utilities::MPI::min(is_compatible ? 1U : 0U,
+                              src.get_mpi_communicator()) == 0U)
+        return false;
+
+      ::dealii::LinearAlgebra::distributed::Vector<Number, MemorySpace>
+        previous;
+      previous.swap(vector);
+      vector.reinit(src, true);
+      vector.copy_locally_owned_data_from(previous);
+      return true;
+    }
+
     template <typename VectorType>
     void
     set_initial_guess(VectorType &vector)
@@ -2079,6 +2623,162 @@ namespace internal
 
       std::vector<double> values;
     };
+
+    // Apply a diagonal preconditioner to the vector matrix_times_eigenvector
+    // and compute the inner products of the result with the old eigenvector
+    // estimate and with itself in the same sweep
+    template <typename Number>
+    std::pair<double, double>
+    fused_power_iteration_step(const unsigned int size,
+                               const Number *     diagonal,
+                               const Number *     matrix_times_eigenvector,
+                               const Number *     eigenvector,
+                               Number *           new_eigenvector)
+    {
+      constexpr unsigned int n_lanes =
+        VectorizedArray<Number>::n_array_elements;
+      VectorizedArray<Number> products[2];
+      products[0] = Number();
+      products[1] = Number();
+      unsigned int i = 0;
+      for (; i + n_lanes <= size; i += n_lanes)
+        {
+          VectorizedArray<Number> d, ax, x;
+          d.load(diagonal + i);
+          ax.load(matrix_times_eigenvector + i);
+          x.load(eigenvector + i);
+          const VectorizedArray<Number> y = d * ax;
+          y.store(new_eigenvector + i);
+          products[0] += x * y;
+          products[1] += y * y;
+        }
+
+      std::pair<double, double> result(0., 0.);
+      for (unsigned int v = 0; v < n_lanes; ++v)
+        {
+          result.first += products[0][v];
+          result.second += products[1][v];
+        }
+      for (; i < size; ++i)
+        {
+          new_eigenvector[i] = diagonal[i] * matrix_times_eigenvector[i];
+          result.first += eigenvector[i] * new_eigenvector[i];
+          result.second += new_eigenvector[i] * new_eigenvector[i];
+        }
+      return result;
+    }
+
+    // Apply the preconditioner in one step of the power iteration and return
+    // the pair (eigenvector * new_eigenvector, new_eigenvector.norm_sqr())
+    template <typename PreconditionerType, typename VectorType>
+    std::pair<double, double>
+    power_iteration_step(const PreconditionerType &preconditioner,
+                         const VectorType &        matrix_times_eigenvector,
+                         const VectorType &        eigenvector,
+                         VectorType &              new_eigenvector)
+    {
+      preconditioner.vmult(new_eigenvector, matrix_times_eigenvector);
+      return std::make_pair(static_cast<double>(eigenvector * new_eigenvector),
+                            static_cast<double>(new_eigenvector.norm_sqr()));
+    }
+
+    template <typename Number>
+    std::pair<double, double>
+    power_iteration_step(
+      const DiagonalMatrix<::dealii::Vector<Number>> &preconditioner,
+      const ::dealii::Vector<Number> &                matrix_times_eigenvector,
+      const ::dealii::Vector<Number> &                eigenvector,
+      ::dealii::Vector<Number> &                      new_eigenvector)
+    {
+      AssertDimension(preconditioner.get_vector().size(), eigenvector.size());
+      return fused_power_iteration_step(eigenvector.size(),
+                                        preconditioner.get_vector().begin(),
+                                        matrix_times_eigenvector.begin(),
+                                        eigenvector.begin(),
+                                        new_eigenvector.begin());
+    }
+
+    template <typename Number>
+    std::pair<double, double>
+    power_iteration_step(
+      const DiagonalMatrix<
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>
+        &preconditioner,
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>
+        &matrix_times_eigenvector,
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>
+        &eigenvector,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>
+        &new_eigenvector)
+    {
+      AssertDimension(preconditioner.get_vector().local_size(),
+                      eigenvector.local_size());
+      const std::pair<double, double> local_products =
+        fused_power_iteration_step(eigenvector.local_size(),
+                                   preconditioner.get_vector().begin(),
+                                   matrix_times_eigenvector.begin(),
+                                   eigenvector.begin(),
+                                   new_eigenvector.begin());
+      double products[2] = {local_products.first, local_products.second};
+      Utilities::MPI::sum(ArrayView<const double>(products, 2),
+                          eigenvector.get_mpi_communicator(),
+                          ArrayView<double>(products, 2));
+      return std::make_pair(products[0], products[1]);
+    }
+
+    // Run the power iteration for the largest eigenvalue of the
+    // preconditioned matrix, starting from the given eigenvector estimate
+    // which is overwritten by the final one. Returns the estimate and the
+    // number of iterations performed. If the start vector is zero, which
+    // happens for the default initial guess on a single degree of freedom,
+    // no iteration is performed and the estimate is one. Since the norm is
+    // computed over all processes, they all take the same branch, also if
+    // some of them do not own any entries.
+    template <typename MatrixType,
+              typename VectorType,
+              typename PreconditionerType>
+    std::pair<double, unsigned int>
+    power_iteration(const MatrixType &        matrix,
+                    const PreconditionerType &preconditioner,
+                    const unsigned int        max_iterations,
+                    const double              tolerance,
+                    VectorType &              eigenvector,
+                    VectorType &              tmp_vector1,
+                    VectorType &              tmp_vector2)
+    {
+      const double norm = eigenvector.l2_norm();
+      if (norm == 0.)
+        return std::make_pair(1., 0U);
+      eigenvector *= 1. / norm;
+
+      double       eigenvalue   = 0.;
+      unsigned int n_iterations = 0;
+      while (n_iterations < max_iterations)
+        {
+          matrix.vmult(tmp_vector1, eigenvector);
+          const std::pair<double, double> products =
+            power_iteration_step(preconditioner,
+                                 tmp_vector1,
+                                 eigenvector,
+                                 tmp_vector2);
+          ++n_iterations;
+
+          // the new estimate is the Rayleigh quotient of the normalized
+          // eigenvector estimate
+          const double old_eigenvalue = eigenvalue;
+          eigenvalue                  = products.first;
+          if (products.second == 0.)
+            break;
+          tmp_vector2 *= 1. / std::sqrt(products.second);
+          eigenvector.swap(tmp_vector2);
+
+          if (n_iterations > 1 &&
+              std::abs(eigenvalue - old_eigenvalue) <=
+                tolerance * std::abs(eigenvalue))
+            break;
+        }
+      return std::make_pair(std::abs(eigenvalue), n_iterations);
+    }
   } // namespace PreconditionChebyshevImplementation
 } // namespace internal
 
@@ -2096,6 +2796,20 @@ inline PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
   , eig_cg_n_iterations(eig_cg_n_iterations)
   , eig_cg_residual(eig_cg_residual)
   , max_eigenvalue(max_eigenvalue)
+  , eigenvalue_algorithm(EigenvalueAlgorithm::lanczos)
+  , eig_warm_start(false)
+{}
+
+
+
+template <typename MatrixType, class VectorType, typename PreconditionerType>
+inline PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
+  EigenvalueInformation::EigenvalueInformation()
+  : min_eigenvalue_estimate(std::numeric_limits<double>::max())
+  , max_eigenvalue_estimate(std::numeric_limits<double>::lowest())
+  , cg_iterations(numbers::invalid_unsigned_int)
+  , warm_started(false)
+  , degree(numbers::invalid_unsigned_int)
 {}
 
 
@@ -2143,28 +2857,90 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::clear()
     solution_old.reinit(empty_vector);
     temp_vector1.reinit(empty_vector);
     temp_vector2.reinit(empty_vector);
+    eigenvector_estimate.reinit(empty_vector);
   }
   data.preconditioner.reset();
+  eigenvalue_information = EigenvalueInformation();
 }
 
 
 
 template <typename MatrixType, typename VectorType, typename PreconditionerType>
-inline void
+inline typename PreconditionChebyshev<MatrixType,
+                                      VectorType,
+                                      PreconditionerType>::EigenvalueInformation
 PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
   estimate_eigenvalues(const VectorType &src) const
 {
-  Assert(eigenvalues_are_initialized == false, ExcInternalError());
+  std::lock_guard<std::mutex> lock(mutex);
+  return do_estimate_eigenvalues(src);
+}
+
+
+
+template <typename MatrixType, typename VectorType, typename PreconditionerType>
+inline typename PreconditionChebyshev<MatrixType,
+                                      VectorType,
+                                      PreconditionerType>::EigenvalueInformation
+PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
+  do_estimate_eigenvalues(const VectorType &src) const
+{
   Assert(data.preconditioner.get() != nullptr, ExcNotInitialized());
 
   solution_old.reinit(src);
   temp_vector1.reinit(src, true);
 
+  EigenvalueInformation info;
+  info.cg_iterations = 0;
+
   // calculate largest eigenvalue using a hand-tuned CG iteration on the
   // matrix weighted by its diagonal. we start with a vector that consists of
   // ones only, weighted by the length.
   double max_eigenvalue, min_eigenvalue;
-  if (data.eig_cg_n_iterations > 0)
+  if (data.eig_cg_n_iterations > 0 &&
+      data.eigenvalue_algorithm ==
+        AdditionalData::EigenvalueAlgorithm::power_iteration)
+    {
+      Assert(data.smoothing_range > 1.,
+             ExcMessage("The power iteration only estimates the largest "
+                        "eigenvalue, so the smallest one must be given by "
+                        "a smoothing range larger than one."));
+
+      // start from the previous eigenvector estimate if requested and if it
+      // is compatible with the current vectors
+      info.warm_started =
+        data.eig_warm_start &&
+        internal::PreconditionChebyshevImplementation::
+          keep_previous_eigenvector(eigenvector_estimate, src);
+      if (info.warm_started == false)
+        {
+          eigenvector_estimate.reinit(src, true);
+          internal::PreconditionChebyshevImplementation::set_initial_guess(
+            eigenvector_estimate);
+        }
+
+      const std::pair<double, unsigned int> result =
+        internal::PreconditionChebyshevImplementation::power_iteration(
+          *matrix_ptr,
+          *data.preconditioner,
+          data.eig_cg_n_iterations,
+          data.eig_cg_residual,
+          eigenvector_estimate,
+          solution_old,
+          temp_vector1);
+      info.cg_iterations = result.second;
+
+      // include the same safety factor as for the Lanczos iteration since
+      // the power iteration approaches the largest eigenvalue from below,
+      // unless no iteration could be performed, in which case we use one as
+      // for an empty Lanczos estimate
+      if (result.second == 0)
+        max_eigenvalue = 1.;
+      else
+        max_eigenvalue = 1.2 * result.first;
+      min_eigenvalue = max_eigenvalue / data.smoothing_range;
+    }
+  else if (data.eig_cg_n_iterations > 0)
     {
       Assert(data.eig_cg_n_iterations > 2,
              ExcMessage(
@@ -2201,6 +2977,7 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
         }
       catch (SolverControl::NoConvergence &)
         {}
+      info.cg_iterations = control.last_step();
 
       // read the eigenvalues from the attached eigenvalue tracker
       if (eigenvalue_tracker.values.empty())
@@ -2220,6 +2997,9 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
       min_eigenvalue = data.max_eigenvalue / data.smoothing_range;
     }
 
+  info.min_eigenvalue_estimate = min_eigenvalue;
+  info.max_eigenvalue_estimate = max_eigenvalue;
+
   const double alpha = (data.smoothing_range > 1. ?
                           max_eigenvalue / data.smoothing_range :
                           std::min(0.9 * max_eigenvalue, min_eigenvalue));
@@ -2275,6 +3055,23 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
   const_cast<
     PreconditionChebyshev<MatrixType, VectorType, PreconditionerType> *>(this)
     ->eigenvalues_are_initialized = true;
+
+  info.degree            = data.degree;
+  eigenvalue_information = info;
+  return info;
+}
+
+
+
+template <typename MatrixType, typename VectorType, typename PreconditionerType>
+inline const typename PreconditionChebyshev<MatrixType,
+                                            VectorType,
+                                            PreconditionerType>::
+  EigenvalueInformation &
+  PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::
+    get_eigenvalue_information() const
+{
+  return eigenvalue_information;
 }
 
 
@@ -2287,7 +3084,7 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::vmult(
 {
   std::lock_guard<std::mutex> lock(mutex);
   if (eigenvalues_are_initialized == false)
-    estimate_eigenvalues(rhs);
+    do_estimate_eigenvalues(rhs);
 
   internal::PreconditionChebyshevImplementation::vector_updates(
     rhs,
@@ -2308,13 +3105,13 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::vmult(
   double rhok = delta / theta, sigma = theta / delta;
   for (unsigned int k = 0; k < data.degree - 1; ++k)
     {
-      matrix_ptr->vmult(temp_vector1, solution);
       const double rhokp   = 1. / (2. * sigma - rhok);
       const double factor1 = rhokp * rhok, factor2 = 2. * rhokp / delta;
       rhok = rhokp;
-      internal::PreconditionChebyshevImplementation::vector_updates(
-        rhs,
+      internal::PreconditionChebyshevImplementation::vmult_and_update(
+        *matrix_ptr,
         *data.preconditioner,
+        rhs,
         k + 1,
         factor1,
         factor2,
@@ -2335,7 +3132,7 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::Tvmult(
 {
   std::lock_guard<std::mutex> lock(mutex);
   if (eigenvalues_are_initialized == false)
-    estimate_eigenvalues(rhs);
+    do_estimate_eigenvalues(rhs);
 
   internal::PreconditionChebyshevImplementation::vector_updates(
     rhs,
@@ -2381,12 +3178,12 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::step(
 {
   std::lock_guard<std::mutex> lock(mutex);
   if (eigenvalues_are_initialized == false)
-    estimate_eigenvalues(rhs);
+    do_estimate_eigenvalues(rhs);
 
-  matrix_ptr->vmult(temp_vector1, solution);
-  internal::PreconditionChebyshevImplementation::vector_updates(
-    rhs,
+  internal::PreconditionChebyshevImplementation::vmult_and_update(
+    *matrix_ptr,
     *data.preconditioner,
+    rhs,
     1,
     0.,
     1. / theta,
@@ -2401,13 +3198,13 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::step(
   double rhok = delta / theta, sigma = theta / delta;
   for (unsigned int k = 0; k < data.degree - 1; ++k)
     {
-      matrix_ptr->vmult(temp_vector1, solution);
       const double rhokp   = 1. / (2. * sigma - rhok);
       const double factor1 = rhokp * rhok, factor2 = 2. * rhokp / delta;
       rhok = rhokp;
-      internal::PreconditionChebyshevImplementation::vector_updates(
-        rhs,
+      internal::PreconditionChebyshevImplementation::vmult_and_update(
+        *matrix_ptr,
         *data.preconditioner,
+        rhs,
         k + 2,
         factor1,
         factor2,
@@ -2428,7 +3225,7 @@ PreconditionChebyshev<MatrixType, VectorType, PreconditionerType>::Tstep(
 {
   std::lock_guard<std::mutex> lock(mutex);
   if (eigenvalues_are_initialized == false)
-    estimate_eigenvalues(rhs);
+    do_estimate_eigenvalues(rhs);
 
   matrix_ptr->Tvmult(temp_vector1, solution);
   internal::PreconditionChebyshevImplementation::vector_updates(
@@ -507,6 +507,19 @@ public:
   void
   invert();
 
+  /**
+   * Solve the linear system $\mathbf{A} \mathbf{X} = \mathbf{B}$ (or
+   * $\mathbf{A}^T \mathbf{X} = \mathbf{B}$ if @p transposed is true) with the
+   * Cholesky or LU factorization previously computed by
+   * compute_cholesky_factorization() or compute_lu_factorization(), using
+   * ScaLAPACK function <code>pXpotrs</code> or <code>pXgetrs</code>. The
+   * right hand sides are given by the columns of @p B, which are overwritten
+   * by the solution. The matrix @p B must be distributed over the same
+   * process grid as this matrix, with the same row block size.
+   */
+  void
+  solve(ScaLAPACKMatrix<NumberType> &B, const bool transposed = false) const;
+
   /**
    * Computing selected eigenvalues and, optionally, the eigenvectors of the
    * real symmetric matrix $\mathbf{A} \in \mathbb{R}^{M \times M}$.
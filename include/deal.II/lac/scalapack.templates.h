@@ -210,6 +210,76 @@ extern "C"
            int *      ipiv,
            int *      INFO);
 
+  /**
+   * Solve a system of linear equations sub( A ) * X = sub( B ) with a
+   * symmetric positive definite distributed matrix sub( A ) using the
+   * Cholesky factorization computed by PDPOTRF.
+   *
+   * http://www.netlib.org/scalapack/explore-html/d2/d53/pdpotrs_8f_source.html
+   */
+  void
+  pdpotrs_(const char *  UPLO,
+           const int *   N,
+           const int *   NRHS,
+           const double *A,
+           const int *   IA,
+           const int *   JA,
+           const int *   DESCA,
+           double *      B,
+           const int *   IB,
+           const int *   JB,
+           const int *   DESCB,
+           int *         INFO);
+  void
+  pspotrs_(const char * UPLO,
+           const int *  N,
+           const int *  NRHS,
+           const float *A,
+           const int *  IA,
+           const int *  JA,
+           const int *  DESCA,
+           float *      B,
+           const int *  IB,
+           const int *  JB,
+           const int *  DESCB,
+           int *        INFO);
+
+  /**
+   * Solve a system of linear equations sub( A ) * X = sub( B ) or
+   * sub( A )**T * X = sub( B ) with a general distributed matrix sub( A )
+   * using the LU factorization computed by PDGETRF.
+   *
+   * http://www.netlib.org/scalapack/explore-html/d4/d2a/pdgetrs_8f_source.html
+   */
+  void
+  pdgetrs_(const char *  TRANS,
+           const int *   N,
+           const int *   NRHS,
+           const double *A,
+           const int *   IA,
+           const int *   JA,
+           const int *   DESCA,
+           const int *   ipiv,
+           double *      B,
+           const int *   IB,
+           const int *   JB,
+           const int *   DESCB,
+           int *         INFO);
+  void
+  psgetrs_(const char * TRANS,
+           const int *  N,
+           const int *  NRHS,
+           const float *A,
+           const int *  IA,
+           const int *  JA,
+           const int *  DESCA,
+           const int *  ipiv,
+           float *      B,
+           const int *  IB,
+           const int *  JB,
+           const int *  DESCB,
+           int *        INFO);
+
   /**
    * Compute the inverse of a real symmetric positive definite
    * distributed matrix sub( A ) = A(IA:IA+N-1,JA:JA+N-1) using the
@@ -1067,6 +1137,115 @@ pgetrf(const int *m,
 }
 
 
+template <typename number>
+inline void
+ppotrs(const char * /*UPLO*/,
+       const int * /*N*/,
+       const int * /*NRHS*/,
+       const number * /*A*/,
+       const int * /*IA*/,
+       const int * /*JA*/,
+       const int * /*DESCA*/,
+       number * /*B*/,
+       const int * /*IB*/,
+       const int * /*JB*/,
+       const int * /*DESCB*/,
+       int * /*INFO*/)
+{
+  Assert(false, dealii::ExcNotImplemented());
+}
+
+inline void
+ppotrs(const char *  UPLO,
+       const int *   N,
+       const int *   NRHS,
+       const double *A,
+       const int *   IA,
+       const int *   JA,
+       const int *   DESCA,
+       double *      B,
+       const int *   IB,
+       const int *   JB,
+       const int *   DESCB,
+       int *         INFO)
+{
+  pdpotrs_(UPLO, N, NRHS, A, IA, JA, DESCA, B, IB, JB, DESCB, INFO);
+}
+
+inline void
+ppotrs(const char * UPLO,
+       const int *  N,
+       const int *  NRHS,
+       const float *A,
+       const int *  IA,
+       const int *  JA,
+       const int *  DESCA,
+       float *      B,
+       const int *  IB,
+       const int *  JB,
+       const int *  DESCB,
+       int *        INFO)
+{
+  pspotrs_(UPLO, N, NRHS, A, IA, JA, DESCA, B, IB, JB, DESCB, INFO);
+}
+
+
+template <typename number>
+inline void
+pgetrs(const char * /*TRANS*/,
+       const int * /*N*/,
+       const int * /*NRHS*/,
+       const number * /*A*/,
+       const int * /*IA*/,
+       const int * /*JA*/,
+       const int * /*DESCA*/,
+       const int * /*ipiv*/,
+       number * /*B*/,
+       const int * /*IB*/,
+       const int * /*JB*/,
+       const int * /*DESCB*/,
+       int * /*INFO*/)
+{
+  Assert(false, dealii::ExcNotImplemented());
+}
+
+inline void
+pgetrs(const char *  TRANS,
+       const int *   N,
+       const int *   NRHS,
+       const double *A,
+       const int *   IA,
+       const int *   JA,
+       const int *   DESCA,
+       const int *   ipiv,
+       double *      B,
+       const int *   IB,
+       const int *   JB,
+       const int *   DESCB,
+       int *         INFO)
+{
+  pdgetrs_(TRANS, N, NRHS, A, IA, JA, DESCA, ipiv, B, IB, JB, DESCB, INFO);
+}
+
+inline void
+pgetrs(const char * TRANS,
+       const int *  N,
+       const int *  NRHS,
+       const float *A,
+       const int *  IA,
+       const int *  JA,
+       const int *  DESCA,
+       const int *  ipiv,
+       float *      B,
+       const int *  IB,
+       const int *  JB,
+       const int *  DESCB,
+       int *        INFO)
+{
+  psgetrs_(TRANS, N, NRHS, A, IA, JA, DESCA, ipiv, B, IB, JB, DESCB, INFO);
+}
+
+
 template <typename number>
 inline void
 ppotri(const char * /*UPLO*/,
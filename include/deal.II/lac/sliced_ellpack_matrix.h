@@ -0,0 +1,355 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sliced_ellpack_matrix_h
+#define dealii_sliced_ellpack_matrix_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/lac/exceptions.h>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+template <typename number>
+class Vector;
+template <typename number>
+class SparseMatrix;
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+/**
+ * A sparse matrix stored in the sliced ELLPACK format, also known as
+ * SELL-C-$\sigma$, that is set up from a SparseMatrix and is intended to
+ * speed up matrix-vector products with matrices that do not change often.
+ *
+ * The compressed row storage of SparseMatrix processes one row after the
+ * other. Since the rows of typical finite element matrices are short, the
+ * inner loop over the entries of a row is too short to be vectorized. This
+ * class instead groups $C$ rows into a chunk, where $C$ is the number of
+ * lanes of VectorizedArray<number> (i.e., 4 doubles with AVX2 and 8 doubles
+ * with AVX-512), and stores the entries of a chunk in column-major order:
+ * First the first entry of each of the $C$ rows, then the second entry of
+ * each row, and so on. Rows shorter than the longest row of the chunk are
+ * padded with zeros. A matrix-vector product then processes all rows of a
+ * chunk at once, using one VectorizedArray product per stored column of the
+ * chunk together with a gather of the source vector entries.
+ *
+ * In order to keep the amount of padding small, the rows within windows of
+ * $\sigma$ consecutive rows are sorted by their lengths before they are
+ * grouped into chunks. Since the sorting only happens within these windows,
+ * the rows of a chunk are still close to each other, and so are, for matrices
+ * coming from finite element discretizations, the entries of the source
+ * vector they access. The permutation is undone when writing the result, so
+ * the vectors passed to the functions of this class are in the original
+ * numbering.
+ *
+ * The class provides the interface needed to use it as the matrix in
+ * iterative solvers like SolverCG and in preconditioners like
+ * PreconditionChebyshev, i.e., the functions m(), n(), el(), vmult(), and
+ * Tvmult(). The values are copied from the SparseMatrix given to reinit(),
+ * so the latter may be changed or deleted afterwards without affecting this
+ * object.
+ *
+ * Column indices are stored as <code>unsigned int</code> and are passed to
+ * the gather instructions of the processor, which interpret them as signed
+ * 32-bit integers. The number of columns of the matrix must therefore be
+ * less than $2^{31}$.
+ *
+ * @note Instantiations for this template are provided for <tt>@<float@> and
+ * @<double@></tt>.
+ */
+template <typename number>
+class SlicedEllpackMatrix : public virtual Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  using size_type = types::global_dof_index;
+
+  /**
+   * Type of the matrix entries.
+   */
+  using value_type = number;
+
+  /**
+   * The number of rows that are grouped into a chunk.
+   */
+  static constexpr unsigned int chunk_size =
+    VectorizedArray<number>::n_array_elements;
+
+  /**
+   * Constructor. Initializes an empty matrix.
+   */
+  SlicedEllpackMatrix();
+
+  /**
+   * Constructor. Copies the given matrix, see reinit().
+   */
+  explicit SlicedEllpackMatrix(const SparseMatrix<number> &matrix,
+                               const unsigned int sorting_window = 256);
+
+  /**
+   * Set up the sliced ELLPACK storage and copy the entries of @p matrix.
+   * The rows are sorted by their length within windows of
+   * @p sorting_window consecutive rows, which is rounded up to a multiple
+   * of the chunk size. Passing the chunk size disables the sorting.
+   */
+  void
+  reinit(const SparseMatrix<number> &matrix,
+         const unsigned int          sorting_window = 256);
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void
+  clear();
+
+  /**
+   * Return the dimension of the codomain (or range) space.
+   */
+  size_type
+  m() const;
+
+  /**
+   * Return the dimension of the domain space.
+   */
+  size_type
+  n() const;
+
+  /**
+   * Return the number of nonzero entries of the matrix this object was
+   * created from.
+   */
+  std::size_t
+  n_nonzero_elements() const;
+
+  /**
+   * Return the number of stored entries, including the zeros used to pad
+   * the rows of each chunk to the same length. The ratio between this number
+   * and n_nonzero_elements() is a measure of the overhead of the format.
+   */
+  std::size_t
+  n_stored_elements() const;
+
+  /**
+   * Return the value of the entry (<i>i,j</i>), or zero if the entry is not
+   * stored. This function needs to search the row and is therefore slow.
+   */
+  number
+  el(const size_type i, const size_type j) const;
+
+  /**
+   * Matrix-vector multiplication: let <i>dst = M*src</i> with <i>M</i>
+   * being this matrix.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  void
+  vmult(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Adding matrix-vector multiplication. Add <i>M*src</i> on <i>dst</i>
+   * with <i>M</i> being this matrix.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  void
+  vmult_add(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Matrix-vector multiplication with the transpose matrix: let <i>dst =
+   * M<sup>T</sup>*src</i> with <i>M</i> being this matrix. Since different
+   * rows write into the same entries of @p dst, this function runs on a
+   * single thread.
+   */
+  void
+  Tvmult(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Adding matrix-vector multiplication with the transpose matrix. Add
+   * <i>M<sup>T</sup>*src</i> to <i>dst</i> with <i>M</i> being this matrix.
+   */
+  void
+  Tvmult_add(Vector<number> &dst, const Vector<number> &src) const;
+
+  /**
+   * Compute the residual <i>dst = b - M*x</i> and return its $l_2$ norm.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  number
+  residual(Vector<number> &      dst,
+           const Vector<number> &x,
+           const Vector<number> &b) const;
+
+  /**
+   * Return the square of the norm of the vector $v$ with respect to the norm
+   * induced by this matrix, i.e. $\left(v,Mv\right)$.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  number
+  matrix_norm_square(const Vector<number> &v) const;
+
+  /**
+   * Return an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+  /**
+   * @addtogroup Exceptions
+   * @{
+   */
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg(ExcTooManyColumns,
+                   "The number of columns of the matrix is too large to be "
+                   "represented by the 32-bit indices used by this class.");
+  /**
+   * Exception
+   */
+  DeclExceptionMsg(ExcSourceEqualsDestination,
+                   "You are attempting an operation on two vectors that "
+                   "are the same object, but the operation requires that the "
+                   "two objects are in fact different.");
+  //@}
+
+private:
+  /**
+   * Compute the product of the rows in the chunks <code>[begin,
+   * end)</code> with @p src. If @p b is given, the product is subtracted
+   * from it, otherwise it is added to @p dst if @p add is set, or written
+   * into @p dst.
+   */
+  void
+  vmult_on_subrange(const unsigned int begin_chunk,
+                    const unsigned int end_chunk,
+                    const number *     src,
+                    number *           dst,
+                    const number *     b,
+                    const bool         add) const;
+
+  /**
+   * Number of rows of the matrix.
+   */
+  size_type n_rows;
+
+  /**
+   * Number of columns of the matrix.
+   */
+  size_type n_cols;
+
+  /**
+   * Number of nonzero entries of the matrix this object was created from.
+   */
+  std::size_t n_nonzero;
+
+  /**
+   * For each chunk, the index of its first column within #values. The last
+   * element holds the total number of stored columns.
+   */
+  std::vector<unsigned int> chunk_starts;
+
+  /**
+   * The original index of the row stored in each lane of each chunk, i.e.,
+   * <code>row_numbers[chunk * chunk_size + lane]</code> is the row stored in
+   * the given lane. Padding lanes of the last chunk point to row zero.
+   */
+  std::vector<unsigned int> row_numbers;
+
+  /**
+   * The position of each row, given as <code>chunk * chunk_size +
+   * lane</code>.
+   */
+  std::vector<unsigned int> row_positions;
+
+  /**
+   * The values of the matrix, one VectorizedArray per stored column of a
+   * chunk.
+   */
+  AlignedVector<VectorizedArray<number>> values;
+
+  /**
+   * The column indices of the entries in #values, with the index of the
+   * entry in lane <code>v</code> of <code>values[k]</code> stored at
+   * position <code>k * chunk_size + v</code>. Padding entries repeat the
+   * column of the last entry of their row.
+   */
+  AlignedVector<unsigned int> column_indices;
+};
+
+/*@}*/
+
+
+#ifndef DOXYGEN
+/*---------------------- Inline functions -----------------------------------*/
+
+
+
+template <typename number>
+inline typename SlicedEllpackMatrix<number>::size_type
+SlicedEllpackMatrix<number>::m() const
+{
+  return n_rows;
+}
+
+
+
+template <typename number>
+inline typename SlicedEllpackMatrix<number>::size_type
+SlicedEllpackMatrix<number>::n() const
+{
+  return n_cols;
+}
+
+
+
+template <typename number>
+inline std::size_t
+SlicedEllpackMatrix<number>::n_nonzero_elements() const
+{
+  return n_nonzero;
+}
+
+
+
+template <typename number>
+inline std::size_t
+SlicedEllpackMatrix<number>::n_stored_elements() const
+{
+  return values.size() * chunk_size;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -21,18 +21,34 @@
 
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/logstream.h>
+#include <deal.II/base/memory_space.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/subscriptor.h>
 
 #include <deal.II/lac/solver.h>
 #include <deal.II/lac/solver_control.h>
 #include <deal.II/lac/tridiagonal_matrix.h>
+#include <deal.II/lac/vector_operations_internal.h>
 
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
-// forward declaration
+// forward declarations
 class PreconditionIdentity;
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename, typename>
+    class Vector;
+  } // namespace distributed
+} // namespace LinearAlgebra
 
 
 /*!@addtogroup Solvers */
@@ -89,6 +105,29 @@ class PreconditionIdentity;
  * Solver base class to determine convergence. This mechanism can also be used
  * to observe the progress of the iteration.
  *
+ * <h3>Fusing vector updates into the matrix-vector product</h3>
+ *
+ * If the vector type is LinearAlgebra::distributed::Vector and the matrix
+ * provides a function
+ * @code
+ * void vmult(VectorType &dst,
+ *            const VectorType &src,
+ *            const std::function<void(const unsigned int,
+ *                                     const unsigned int)> &operation_before,
+ *            const std::function<void(const unsigned int,
+ *                                     const unsigned int)> &operation_after)
+ *   const;
+ * @endcode
+ * that calls the two functions on ranges <tt>[begin, end)</tt> of locally
+ * owned entries of the vectors before and after the matrix touches them,
+ * as done by MatrixFree::cell_loop() with the @p operation_before_loop and
+ * @p operation_after_loop arguments, the solver moves the update of the
+ * search direction into the first and the scalar product of the search
+ * direction with the matrix-vector product into the second function. This
+ * saves two sweeps through the vectors per iteration. Note that the matrix
+ * must not set the destination vector to zero in this function, as this is
+ * done within @p operation_before.
+ *
  *
  * @author W. Bangerth, G. Kanschat, R. Becker and F.-T. Suttmeier
  */
@@ -238,6 +277,130 @@ protected:
 
 #ifndef DOXYGEN
 
+namespace internal
+{
+  namespace SolverCGImplementation
+  {
+    // A trait class that determines whether the matrix type provides a vmult
+    // function with two additional functions that are run on ranges of the
+    // vectors before and after the product touches them, like the ones
+    // implemented with MatrixFree::cell_loop()
+    template <typename MatrixType, typename VectorType>
+    class has_vmult_with_std_functions
+    {
+      template <typename C>
+      static std::false_type
+      test(...);
+
+      template <typename C>
+      static auto
+      test(VectorType *v)
+        -> decltype(std::declval<const C>().vmult(
+                      *v,
+                      *v,
+                      std::function<void(const unsigned int,
+                                         const unsigned int)>(),
+                      std::function<void(const unsigned int,
+                                         const unsigned int)>()),
+                    std::true_type());
+
+    public:
+      static constexpr bool value =
+        decltype(test<MatrixType>(nullptr))::value;
+    };
+
+    // Updates the search direction d = beta * d - p, or d = -p for beta
+    // equal to zero, computes the product h = A * d and returns the scalar
+    // product of d and h. Generic version for all vector types.
+    template <typename MatrixType, typename VectorType>
+    typename VectorType::value_type
+    update_direction_and_vmult(const MatrixType &                    A,
+                               const typename VectorType::value_type beta,
+                               const VectorType &                    p,
+                               VectorType &                          d,
+                               VectorType &                          h)
+    {
+      if (beta == typename VectorType::value_type())
+        d.equ(-1., p);
+      else
+        d.sadd(beta, -1., p);
+      A.vmult(h, d);
+      return d * h;
+    }
+
+    // Same as above, but for matrices that can run operations on the vector
+    // entries while the matrix-vector product is in progress. The vector p
+    // might be the same as h, so it needs to be read before h is zeroed. The
+    // product of d and h is accumulated on each range with the pairwise
+    // summation of the vector classes, and the results of the ranges are
+    // combined pairwise in the order of the vector entries, independent of
+    // the order in which the matrix visits them.
+    template <typename MatrixType, typename Number>
+    typename std::enable_if<
+      has_vmult_with_std_functions<
+        MatrixType,
+        LinearAlgebra::distributed::Vector<Number, MemorySpace::Host>>::value,
+      Number>::type
+    update_direction_and_vmult(
+      const MatrixType &                                                   A,
+      const Number                                                         beta,
+      const LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &p,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &      d,
+      LinearAlgebra::distributed::Vector<Number, MemorySpace::Host> &      h)
+    {
+      const Number *p_ptr = p.begin();
+      Number *      d_ptr = d.begin();
+      Number *      h_ptr = h.begin();
+
+      std::vector<std::pair<unsigned int, Number>> partial_products;
+
+      h.zero_out_ghosts();
+      A.vmult(
+        h,
+        d,
+        [&](const unsigned int begin, const unsigned int end) {
+          if (beta == Number())
+            for (unsigned int i = begin; i < end; ++i)
+              d_ptr[i] = -p_ptr[i];
+          else
+            for (unsigned int i = begin; i < end; ++i)
+              d_ptr[i] = beta * d_ptr[i] - p_ptr[i];
+          for (unsigned int i = begin; i < end; ++i)
+            h_ptr[i] = Number();
+        },
+        [&](const unsigned int begin, const unsigned int end) {
+          Number product = Number();
+          if (end > begin)
+            ::dealii::internal::VectorOperations::accumulate_recursive(
+              ::dealii::internal::VectorOperations::Dot<Number, Number>(d_ptr,
+                                                                        h_ptr),
+              begin,
+              end,
+              product);
+          partial_products.emplace_back(begin, product);
+        });
+
+      std::sort(partial_products.begin(), partial_products.end());
+      std::vector<Number> sums(partial_products.size());
+      for (unsigned int i = 0; i < partial_products.size(); ++i)
+        sums[i] = partial_products[i].second;
+      while (sums.size() > 1)
+        {
+          for (unsigned int i = 0; i < sums.size() / 2; ++i)
+            sums[i] = sums[2 * i] + sums[2 * i + 1];
+          if (sums.size() % 2 == 1)
+            sums[sums.size() / 2] = sums.back();
+          sums.resize((sums.size() + 1) / 2);
+        }
+      const Number d_times_h = sums.empty() ? Number() : sums[0];
+
+      return Utilities::MPI::sum(d_times_h, d.get_mpi_communicator());
+    }
+  } // namespace SolverCGImplementation
+} // namespace internal
+
+
+
 template <typename VectorType>
 SolverCG<VectorType>::SolverCG(SolverControl &           cn,
                                VectorMemory<VectorType> &mem,
@@ -359,7 +522,7 @@ SolverCG<VectorType>::solve(const MatrixType &        A,
   d.reinit(x, true);
   h.reinit(x, true);
 
-  number gh, beta;
+  number gh, beta = number();
 
   // compute residual. if vector is
   // zero, then short-circuit the
@@ -377,26 +540,26 @@ SolverCG<VectorType>::solve(const MatrixType &        A,
   if (conv != SolverControl::iterate)
     return;
 
-  if (std::is_same<PreconditionerType, PreconditionIdentity>::value == false)
+  const bool use_preconditioner =
+    std::is_same<PreconditionerType, PreconditionIdentity>::value == false;
+  if (use_preconditioner)
     {
       preconditioner.vmult(h, g);
-
-      d.equ(-1., h);
-
       gh = g * h;
     }
   else
-    {
-      d.equ(-1., g);
-      gh = res * res;
-    }
+    gh = res * res;
 
   while (conv == SolverControl::iterate)
     {
       it++;
-      A.vmult(h, d);
 
-      number alpha = d * h;
+      // set the new search direction d = beta * d - P^{-1} g (or -P^{-1} g in
+      // the first iteration) and compute h = A * d, fused into one loop for
+      // suitable matrices and vectors
+      number alpha =
+        internal::SolverCGImplementation::update_direction_and_vmult(
+          A, beta, use_preconditioner ? h : g, d, h);
       Assert(std::abs(alpha) != 0., ExcDivideByZero());
       alpha = gh / alpha;
 
@@ -409,8 +572,7 @@ SolverCG<VectorType>::solve(const MatrixType &        A,
       if (conv != SolverControl::iterate)
         break;
 
-      if (std::is_same<PreconditionerType, PreconditionIdentity>::value ==
-          false)
+      if (use_preconditioner)
         {
           preconditioner.vmult(h, g);
 
@@ -418,14 +580,12 @@ SolverCG<VectorType>::solve(const MatrixType &        A,
           Assert(std::abs(beta) != 0., ExcDivideByZero());
           gh   = g * h;
           beta = gh / beta;
-          d.sadd(beta, -1., h);
         }
       else
         {
           beta = gh;
           gh   = res * res;
           beta = gh / beta;
-          d.sadd(beta, -1., g);
         }
 
       this->coefficients_signal(alpha, beta);
@@ -18,9 +18,13 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
+
 #include <deal.II/lac/sparse_matrix.h>
 
 #include <cmath>
+#include <vector>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -93,6 +97,35 @@ DEAL_II_NAMESPACE_OPEN
  * <code>*use_this_sparsity</code> is used to store the decomposed matrix. For
  * restrictions on the sparsity see section `Fill-in' above).
  *
+ * 5/ By default, the factorization and the forward and backward
+ * substitutions of vmult() run in parallel using level scheduling, see
+ * below. Setting <code>use_level_scheduling=false</code> selects the purely
+ * sequential algorithms.
+ *
+ *
+ * <h3>Parallelization by level scheduling</h3>
+ *
+ * The forward substitution with the lower triangular factor computes row
+ * $i$ of the result from the rows $j<i$ for which the entry $(i,j)$ is
+ * present in the sparsity pattern. Rows that do not depend on each other,
+ * directly or indirectly, can be computed at the same time. initialize()
+ * therefore sorts the rows into levels: Row $i$ is placed on the level
+ * following the highest level of the rows $j<i$ it depends on. The rows of
+ * one level only depend on rows of previous levels and are processed in
+ * parallel, one level after the other. The same is done for the backward
+ * substitution with the rows $j>i$, and for the factorization itself, whose
+ * row $i$ depends on the same rows as the forward substitution.
+ *
+ * Since every row is computed with exactly the same operations in the same
+ * order as in the sequential algorithm, the results are identical to the
+ * ones of the sequential algorithm, independently of the number of threads.
+ * How much parallelism is available depends on the numbering of the
+ * unknowns: For matrices from finite element discretizations in $d$ space
+ * dimensions with a Cuthill-McKee-like numbering, the number of levels grows
+ * like $N^{1/d}$, leaving many rows per level. Numberings that make every
+ * row depend on its predecessor, like a tridiagonal matrix in natural
+ * order, lead to one row per level and hence to sequential execution.
+ *
  *
  * <h3>Particular implementations</h3>
  *
@@ -150,7 +183,8 @@ public:
     AdditionalData(const double           strengthen_diagonal   = 0,
                    const unsigned int     extra_off_diagonals   = 0,
                    const bool             use_previous_sparsity = false,
-                   const SparsityPattern *use_this_sparsity     = nullptr);
+                   const SparsityPattern *use_this_sparsity     = nullptr,
+                   const bool             use_level_scheduling  = true);
 
     /**
      * <code>strengthen_diag</code> times the sum of absolute row entries is
@@ -193,6 +227,15 @@ public:
      * matrix.
      */
     const SparsityPattern *use_this_sparsity;
+
+    /**
+     * If this flag is true, the rows are grouped into levels of mutually
+     * independent rows, and the factorization as well as the forward and
+     * backward substitutions process the rows of each level in parallel.
+     * This does not change the results. If the flag is false, or if only one
+     * thread is available, the rows are processed one after the other.
+     */
+    bool use_level_scheduling;
   };
 
   /**
@@ -328,7 +371,75 @@ protected:
   void
   prebuild_lower_bound();
 
+  /**
+   * Whether the rows are processed in parallel by level scheduling, as set
+   * by AdditionalData::use_level_scheduling.
+   */
+  bool use_level_scheduling;
+
+  /**
+   * Sort the rows into the levels used for the parallel forward and
+   * backward substitutions, unless #use_level_scheduling is false. Needs the
+   * #prebuilt_lower_bound array.
+   */
+  void
+  compute_level_schedule();
+
+  /**
+   * Call <code>f(row)</code> for all rows such that every row is processed
+   * after all rows $j<i$ whose column is present in row $i$, i.e., in the
+   * order required by a forward substitution with the lower triangular part
+   * of the sparsity pattern. Rows of the same level are processed in
+   * parallel if level scheduling is enabled and more than one thread is
+   * available, otherwise the rows are processed in increasing order.
+   */
+  template <typename Function>
+  void
+  apply_in_forward_order(const Function &f) const;
+
+  /**
+   * Same as apply_in_forward_order(), but for the dependencies of a backward
+   * substitution with the upper triangular part of the sparsity pattern. The
+   * sequential fallback processes the rows in decreasing order.
+   */
+  template <typename Function>
+  void
+  apply_in_backward_order(const Function &f) const;
+
 private:
+  /**
+   * Process the rows of the given levels one level after the other, and the
+   * rows of each level in parallel.
+   */
+  template <typename Function>
+  void
+  apply_on_levels(const std::vector<size_type> &level_starts,
+                  const std::vector<size_type> &level_rows,
+                  const Function &              f) const;
+
+  /**
+   * The position of the first row of each level of the forward
+   * substitution within #forward_level_rows. The last element holds the
+   * number of rows. Empty if level scheduling is disabled.
+   */
+  std::vector<size_type> forward_level_starts;
+
+  /**
+   * The rows sorted by the levels of the forward substitution.
+   */
+  std::vector<size_type> forward_level_rows;
+
+  /**
+   * The position of the first row of each level of the backward
+   * substitution within #backward_level_rows.
+   */
+  std::vector<size_type> backward_level_starts;
+
+  /**
+   * The rows sorted by the levels of the backward substitution.
+   */
+  std::vector<size_type> backward_level_rows;
+
   /**
    * In general this pointer is zero except for the case that no
    * SparsityPattern is given to this class. Then, a SparsityPattern is
@@ -415,16 +526,80 @@ SparseLUDecomposition<number>::Tvmult_add(OutVector &     dst,
 //---------------------------------------------------------------------------
 
 
+template <typename number>
+template <typename Function>
+inline void
+SparseLUDecomposition<number>::apply_on_levels(
+  const std::vector<size_type> &level_starts,
+  const std::vector<size_type> &level_rows,
+  const Function &              f) const
+{
+  const size_type grain_size =
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size;
+  for (size_type level = 0; level + 1 < level_starts.size(); ++level)
+    {
+      const size_type begin = level_starts[level];
+      const size_type end   = level_starts[level + 1];
+
+      // do not spawn tasks for levels that are too small to be split
+      if (end - begin < 2 * grain_size)
+        for (size_type i = begin; i < end; ++i)
+          f(level_rows[i]);
+      else
+        parallel::apply_to_subranges(
+          begin,
+          end,
+          [&](const size_type range_begin, const size_type range_end) {
+            for (size_type i = range_begin; i < range_end; ++i)
+              f(level_rows[i]);
+          },
+          grain_size);
+    }
+}
+
+
+
+template <typename number>
+template <typename Function>
+inline void
+SparseLUDecomposition<number>::apply_in_forward_order(const Function &f) const
+{
+  if (forward_level_starts.size() > 0 && MultithreadInfo::n_threads() > 1)
+    apply_on_levels(forward_level_starts, forward_level_rows, f);
+  else
+    for (size_type row = 0; row < this->m(); ++row)
+      f(row);
+}
+
+
+
+template <typename number>
+template <typename Function>
+inline void
+SparseLUDecomposition<number>::apply_in_backward_order(const Function &f) const
+{
+  if (backward_level_starts.size() > 0 && MultithreadInfo::n_threads() > 1)
+    apply_on_levels(backward_level_starts, backward_level_rows, f);
+  else
+    for (size_type row = this->m(); row > 0;)
+      f(--row);
+}
+
+//---------------------------------------------------------------------------
+
+
 template <typename number>
 SparseLUDecomposition<number>::AdditionalData::AdditionalData(
   const double           strengthen_diag,
   const unsigned int     extra_off_diag,
   const bool             use_prev_sparsity,
-  const SparsityPattern *use_this_spars)
+  const SparsityPattern *use_this_spars,
+  const bool             use_level_sched)
   : strengthen_diagonal(strengthen_diag)
   , extra_off_diagonals(extra_off_diag)
   , use_previous_sparsity(use_prev_sparsity)
   , use_this_sparsity(use_this_spars)
+  , use_level_scheduling(use_level_sched)
 {}
 
 
@@ -33,6 +33,7 @@ template <typename number>
 SparseLUDecomposition<number>::SparseLUDecomposition()
   : SparseMatrix<number>()
   , strengthen_diagonal(0)
+  , use_level_scheduling(true)
   , own_sparsity(nullptr)
 {}
 
@@ -55,6 +56,11 @@ SparseLUDecomposition<number>::clear()
   std::vector<const size_type *> tmp;
   tmp.swap(prebuilt_lower_bound);
 
+  forward_level_starts.clear();
+  forward_level_rows.clear();
+  backward_level_starts.clear();
+  backward_level_rows.clear();
+
   SparseMatrix<number>::clear();
 
   if (own_sparsity)
@@ -75,6 +81,8 @@ SparseLUDecomposition<number>::initialize(
 {
   const SparsityPattern &matrix_sparsity = matrix.get_sparsity_pattern();
 
+  use_level_scheduling = data.use_level_scheduling;
+
   const SparsityPattern *sparsity_pattern_to_use = nullptr;
 
   if (data.use_this_sparsity)
@@ -157,6 +165,95 @@ SparseLUDecomposition<number>::prebuild_lower_bound()
     }
 }
 
+
+
+namespace internal
+{
+  namespace SparseLUDecompositionImplementation
+  {
+    /**
+     * Sort the rows by the given levels with a counting sort, keeping the
+     * rows of each level in increasing order.
+     */
+    template <typename size_type>
+    void
+    sort_rows_by_level(const std::vector<size_type> &levels,
+                       const size_type               n_levels,
+                       std::vector<size_type> &      level_starts,
+                       std::vector<size_type> &      level_rows)
+    {
+      level_starts.assign(n_levels + 1, 0);
+      for (const size_type level : levels)
+        ++level_starts[level + 1];
+      for (size_type level = 0; level < n_levels; ++level)
+        level_starts[level + 1] += level_starts[level];
+
+      level_rows.resize(levels.size());
+      std::vector<size_type> next_position(level_starts.begin(),
+                                           level_starts.end() - 1);
+      for (size_type row = 0; row < levels.size(); ++row)
+        level_rows[next_position[levels[row]]++] = row;
+    }
+  } // namespace SparseLUDecompositionImplementation
+} // namespace internal
+
+
+
+template <typename number>
+void
+SparseLUDecomposition<number>::compute_level_schedule()
+{
+  forward_level_starts.clear();
+  forward_level_rows.clear();
+  backward_level_starts.clear();
+  backward_level_rows.clear();
+
+  if (use_level_scheduling == false)
+    return;
+
+  Assert(prebuilt_lower_bound.size() == this->m(), ExcNotInitialized());
+
+  const size_type *const column_numbers =
+    this->get_sparsity_pattern().colnums.get();
+  const std::size_t *const rowstart_indices =
+    this->get_sparsity_pattern().rowstart.get();
+  const size_type N = this->m();
+
+  // the level of a row is one more than the highest level of the rows it
+  // depends on. the diagonal entry is stored first, the entries left of the
+  // diagonal are the ones before prebuilt_lower_bound[row] and the entries
+  // right of the diagonal the ones after
+  std::vector<size_type> levels(N);
+  size_type              n_levels = 0;
+  for (size_type row = 0; row < N; ++row)
+    {
+      size_type level = 0;
+      for (const size_type *col = &column_numbers[rowstart_indices[row] + 1];
+           col != prebuilt_lower_bound[row];
+           ++col)
+        level = std::max(level, levels[*col] + 1);
+      levels[row] = level;
+      n_levels    = std::max(n_levels, level + 1);
+    }
+  internal::SparseLUDecompositionImplementation::sort_rows_by_level(
+    levels, n_levels, forward_level_starts, forward_level_rows);
+
+  n_levels = 0;
+  for (size_type row = N; row > 0;)
+    {
+      --row;
+      size_type level = 0;
+      for (const size_type *col = prebuilt_lower_bound[row];
+           col != &column_numbers[rowstart_indices[row + 1]];
+           ++col)
+        level = std::max(level, levels[*col] + 1);
+      levels[row] = level;
+      n_levels    = std::max(n_levels, level + 1);
+    }
+  internal::SparseLUDecompositionImplementation::sort_rows_by_level(
+    levels, n_levels, backward_level_starts, backward_level_rows);
+}
+
 template <typename number>
 template <typename somenumber>
 void
@@ -237,7 +334,11 @@ std::size_t
 SparseLUDecomposition<number>::memory_consumption() const
 {
   return (SparseMatrix<number>::memory_consumption() +
-          MemoryConsumption::memory_consumption(prebuilt_lower_bound));
+          MemoryConsumption::memory_consumption(prebuilt_lower_bound) +
+          MemoryConsumption::memory_consumption(forward_level_starts) +
+          MemoryConsumption::memory_consumption(forward_level_rows) +
+          MemoryConsumption::memory_consumption(backward_level_starts) +
+          MemoryConsumption::memory_consumption(backward_level_rows));
 }
 
 
@@ -96,6 +96,8 @@ public:
    * decomposition.
    *
    * After this function is called the preconditioner is ready to be used.
+   *
+   * @dealiiOperationIsMultithreaded
    */
   template <typename somenumber>
   void
@@ -107,6 +109,8 @@ public:
    * $dst=(LU)^{-1}src$.
    *
    * The initialize() function needs to be called before.
+   *
+   * @dealiiOperationIsMultithreaded
    */
   template <typename somenumber>
   void
@@ -117,7 +121,8 @@ public:
    * Apply the transpose of the incomplete decomposition, i.e. do one forward-
    * backward step $dst=(LU)^{-T}src$.
    *
-   * The initialize() function needs to be called before.
+   * The initialize() function needs to be called before. Unlike vmult(), this
+   * function always runs on a single thread.
    */
   template <typename somenumber>
   void
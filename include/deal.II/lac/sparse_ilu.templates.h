@@ -20,6 +20,8 @@
 
 #  include <deal.II/base/config.h>
 
+#  include <deal.II/base/thread_local_storage.h>
+
 #  include <deal.II/lac/sparse_ilu.h>
 #  include <deal.II/lac/vector.h>
 
@@ -47,6 +49,7 @@ SparseILU<number>::initialize(const SparseMatrix<somenumber> &matrix,
 
   this->strengthen_diagonal = data.strengthen_diagonal;
   this->prebuild_lower_bound();
+  this->compute_level_schedule();
   this->copy_from(matrix);
 
   if (data.strengthen_diagonal > 0)
@@ -61,37 +64,35 @@ SparseILU<number>::initialize(const SparseMatrix<somenumber> &matrix,
 
   number *luval = this->SparseMatrix<number>::val.get();
 
-  const size_type N    = this->m();
-  size_type       jrow = 0;
-
-  std::vector<size_type> iw(N, numbers::invalid_size_type);
-
-  for (size_type k = 0; k < N; ++k)
-    {
-      const size_type j1 = ia[k], j2 = ia[k + 1] - 1;
-
-      for (size_type j = j1; j <= j2; ++j)
-        iw[ja[j]] = j;
+  const size_type N = this->m();
 
-      // the algorithm in the book works on the elements of row k left of the
-      // diagonal. however, since we store the diagonal element at the first
-      // position, start at the element after the diagonal and run as long as
-      // we don't walk into the right half
-      size_type j = j1 + 1;
+  // row k only modifies its own entries and reads the rows left of the
+  // diagonal, which have been finished before. this is the same dependency
+  // as the one of the forward substitution, so rows of the same level can be
+  // factorized in parallel, each thread using its own array iw that maps
+  // column indices to positions in the current row
+  Threads::ThreadLocalStorage<std::vector<size_type>> iw_storage;
 
-      // pathological case: the current row of the matrix has only the
-      // diagonal entry. then we have nothing to do.
-      if (j > j2)
-        goto label_200;
+  const auto factorize_row = [&](const size_type k) {
+    std::vector<size_type> &iw = iw_storage.get();
+    if (iw.size() != N)
+      iw.assign(N, numbers::invalid_size_type);
 
-    label_150:
+    const size_type j1 = ia[k], j2 = ia[k + 1] - 1;
 
-      jrow = ja[j];
-      if (jrow >= k)
-        goto label_200;
+    for (size_type j = j1; j <= j2; ++j)
+      iw[ja[j]] = j;
 
-      // actual computations:
+    // the algorithm in the book works on the elements of row k left of the
+    // diagonal. however, since we store the diagonal element at the first
+    // position, start at the element after the diagonal and run as long as
+    // we don't walk into the right half
+    size_type j = j1 + 1;
+    for (; j <= j2 && ja[j] < k; ++j)
       {
+        const size_type jrow = ja[j];
+
+        // actual computations:
         number t1 = luval[j] * luval[ia[jrow]];
         luval[j]  = t1;
 
@@ -105,30 +106,26 @@ SparseILU<number>::initialize(const SparseMatrix<somenumber> &matrix,
             if (jw != numbers::invalid_size_type)
               luval[jw] -= t1 * luval[jj];
           }
-
-        ++j;
-        if (j <= j2)
-          goto label_150;
       }
 
-    label_200:
+    // in the book there is an assertion that we have hit the diagonal
+    // element, i.e. that jrow==k. however, we store the diagonal element at
+    // the front, so the column of element j must actually be larger than k
+    // or j is already in the next row
+    Assert((j > j2) || (ja[j] > k), ExcInternalError());
 
-      // in the book there is an assertion that we have hit the diagonal
-      // element, i.e. that jrow==k. however, we store the diagonal element at
-      // the front, so jrow must actually be larger than k or j is already in
-      // the next row
-      Assert((jrow > k) || (j == ia[k + 1]), ExcInternalError());
+    // now we have to deal with the diagonal element. in the book it is
+    // located at position 'j', but here we use the convention of storing
+    // the diagonal element first, so instead of j we use uptr[k]=ia[k]
+    Assert(luval[ia[k]] != 0, ExcZeroPivot(k));
 
-      // now we have to deal with the diagonal element. in the book it is
-      // located at position 'j', but here we use the convention of storing
-      // the diagonal element first, so instead of j we use uptr[k]=ia[k]
-      Assert(luval[ia[k]] != 0, ExcZeroPivot(k));
+    luval[ia[k]] = 1. / luval[ia[k]];
 
-      luval[ia[k]] = 1. / luval[ia[k]];
+    for (size_type j = j1; j <= j2; ++j)
+      iw[ja[j]] = numbers::invalid_size_type;
+  };
 
-      for (size_type j = j1; j <= j2; ++j)
-        iw[ja[j]] = numbers::invalid_size_type;
-    }
+  this->apply_in_forward_order(factorize_row);
 }
 
 
@@ -143,7 +140,6 @@ SparseILU<number>::vmult(Vector<somenumber> &      dst,
          ExcDimensionMismatch(dst.size(), src.size()));
   Assert(dst.size() == this->m(), ExcDimensionMismatch(dst.size(), this->m()));
 
-  const size_type          N = dst.size();
   const std::size_t *const rowstart_indices =
     this->get_sparsity_pattern().rowstart.get();
   const size_type *const column_numbers =
@@ -162,25 +158,24 @@ SparseILU<number>::vmult(Vector<somenumber> &      dst,
   // perform it at the outset of the
   // loop
   dst = src;
-  for (size_type row = 0; row < N; ++row)
-    {
-      // get start of this row. skip the
-      // diagonal element
-      const size_type *const rowstart =
-        &column_numbers[rowstart_indices[row] + 1];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal =
-        this->prebuilt_lower_bound[row];
-
-      somenumber    dst_row = dst(row);
-      const number *luval =
-        this->SparseMatrix<number>::val.get() + (rowstart - column_numbers);
-      for (const size_type *col = rowstart; col != first_after_diagonal;
-           ++col, ++luval)
-        dst_row -= *luval * dst(*col);
-      dst(row) = dst_row;
-    }
+  this->apply_in_forward_order([&](const size_type row) {
+    // get start of this row. skip the
+    // diagonal element
+    const size_type *const rowstart =
+      &column_numbers[rowstart_indices[row] + 1];
+    // find the position where the part
+    // right of the diagonal starts
+    const size_type *const first_after_diagonal =
+      this->prebuilt_lower_bound[row];
+
+    somenumber    dst_row = dst(row);
+    const number *luval =
+      this->SparseMatrix<number>::val.get() + (rowstart - column_numbers);
+    for (const size_type *col = rowstart; col != first_after_diagonal;
+         ++col, ++luval)
+      dst_row -= *luval * dst(*col);
+    dst(row) = dst_row;
+  });
 
   // now the backward solve. same
   // procedure, but we need not set
@@ -190,28 +185,26 @@ SparseILU<number>::vmult(Vector<somenumber> &      dst,
   // note that we need to scale now,
   // since the diagonal is not equal to
   // one now
-  for (int row = N - 1; row >= 0; --row)
-    {
-      // get end of this row
-      const size_type *const rowend =
-        &column_numbers[rowstart_indices[row + 1]];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal =
-        this->prebuilt_lower_bound[row];
-
-      somenumber    dst_row = dst(row);
-      const number *luval   = this->SparseMatrix<number>::val.get() +
-                            (first_after_diagonal - column_numbers);
-      for (const size_type *col = first_after_diagonal; col != rowend;
-           ++col, ++luval)
-        dst_row -= *luval * dst(*col);
-
-      // scale by the diagonal element.
-      // note that the diagonal element
-      // was stored inverted
-      dst(row) = dst_row * this->diag_element(row);
-    }
+  this->apply_in_backward_order([&](const size_type row) {
+    // get end of this row
+    const size_type *const rowend = &column_numbers[rowstart_indices[row + 1]];
+    // find the position where the part
+    // right of the diagonal starts
+    const size_type *const first_after_diagonal =
+      this->prebuilt_lower_bound[row];
+
+    somenumber    dst_row = dst(row);
+    const number *luval   = this->SparseMatrix<number>::val.get() +
+                          (first_after_diagonal - column_numbers);
+    for (const size_type *col = first_after_diagonal; col != rowend;
+         ++col, ++luval)
+      dst_row -= *luval * dst(*col);
+
+    // scale by the diagonal element.
+    // note that the diagonal element
+    // was stored inverted
+    dst(row) = dst_row * this->diag_element(row);
+  });
 }
 
 
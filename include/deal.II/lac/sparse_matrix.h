@@ -21,6 +21,7 @@
 
 #  include <deal.II/base/smartpointer.h>
 #  include <deal.II/base/subscriptor.h>
+#  include <deal.II/base/thread_management.h>
 
 #  include <deal.II/lac/exceptions.h>
 #  include <deal.II/lac/identity_matrix.h>
@@ -31,6 +32,7 @@
 #  endif
 
 #  include <memory>
+#  include <vector>
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -480,6 +482,17 @@ namespace SparseMatrixIterators
  * SparseMatrix::end) you will find that the elements are not sorted by column
  * index within each row whenever the matrix is square.
  *
+ * The matrix-vector products are limited by the memory bandwidth, i.e., by
+ * the amount of data loaded for the matrix entries and the column indices.
+ * For matrices used in preconditioners and multigrid smoothers, it is often
+ * sufficient to store the entries in single precision. The functions vmult(),
+ * vmult_add(), Tvmult(), Tvmult_add(), and residual() of a
+ * SparseMatrix<float> accept vectors of type Vector<double> and accumulate
+ * the products in the precision of the destination vector, so only the
+ * storage of the matrix entries is in reduced precision. When deal.II is
+ * configured with 64-bit indices, the column indices can additionally be
+ * stored as 32-bit integers by calling compress_column_indices().
+ *
  * @note Instantiations for this template are provided for <tt>@<float@> and
  * @<double@></tt>; others can be generated in application programs (see the
  * section on
@@ -1075,6 +1088,33 @@ public:
    * @name Multiplications
    */
   //@{
+  /**
+   * Store a copy of the column indices of the sparsity pattern as 32-bit
+   * integers and use it in vmult(), vmult_add(), and residual(). Since these
+   * functions need to load one column index per matrix entry, this reduces
+   * the data they load per nonzero entry from 8+8 to 8+4 bytes, i.e., by a
+   * quarter, for a SparseMatrix<double> and from 4+8 to 4+4 bytes, i.e., by
+   * a third, for a SparseMatrix<float> when deal.II is configured with 64-bit
+   * indices. Without 64-bit indices, the sparsity pattern already stores
+   * 32-bit indices and this function does nothing.
+   *
+   * The copy is deleted when the matrix is re-initialized with a new
+   * sparsity pattern or cleared, so this function needs to be called again
+   * after reinit(). The number of columns of the matrix must be less than
+   * $2^{32}$.
+   *
+   * @note The 64-bit column indices of the SparsityPattern are not released,
+   * since the sparsity pattern may be shared with other matrices and all
+   * other functions of this class, e.g. Tvmult(), the preconditioners, and
+   * the element access, still use them. The 32-bit copy is kept in addition
+   * to them, so while the products transfer less data, the memory
+   * consumption of the matrix grows by four bytes per nonzero entry, which
+   * is included in memory_consumption(). It only pays off if the products
+   * with the matrix dominate the run time.
+   */
+  void
+  compress_column_indices();
+
   /**
    * Matrix-vector multiplication: let <i>dst = M*src</i> with <i>M</i> being
    * this matrix.
@@ -1109,6 +1149,23 @@ public:
    * a BlockSparseMatrix as well.
    *
    * Source and destination must not be the same vector.
+   *
+   * When run on several threads, this function computes the entries of
+   * @p dst independently of each other by walking the matrix column by
+   * column. The column-wise view of the sparsity pattern this requires is
+   * computed on the first call and stored until the matrix is associated
+   * with another sparsity pattern by reinit(). It consists of a row index and
+   * a position in the matrix for each nonzero entry, which adds about 16
+   * bytes per nonzero entry with 64-bit indices (12 bytes with 32-bit
+   * indices) to the memory consumption of the matrix for its lifetime.
+   *
+   * The entries of each column are summed in the order of increasing row
+   * indices, like on a single thread. If the matrix and both vectors use the
+   * same scalar type, the result is therefore the same bit by bit as the one
+   * computed on a single thread. This is not guaranteed for mixed scalar
+   * types.
+   *
+   * @dealiiOperationIsMultithreaded
    */
   template <class OutVector, class InVector>
   void
@@ -1148,6 +1205,10 @@ public:
    * a BlockSparseMatrix as well.
    *
    * Source and destination must not be the same vector.
+   *
+   * See Tvmult() for how this function is parallelized.
+   *
+   * @dealiiOperationIsMultithreaded
    */
   template <class OutVector, class InVector>
   void
@@ -1314,6 +1375,8 @@ public:
    * Apply the Jacobi preconditioner, which multiplies every element of the
    * <tt>src</tt> vector by the inverse of the respective diagonal element and
    * multiplies the result with the relaxation factor <tt>omega</tt>.
+   *
+   * @dealiiOperationIsMultithreaded
    */
   template <typename somenumber>
   void
@@ -1452,6 +1515,121 @@ public:
   SSOR_step(Vector<somenumber> &      v,
             const Vector<somenumber> &b,
             const number              om = 1.) const;
+
+  /**
+   * Compute a coloring of the rows of this matrix for use with the
+   * multicolor_*() functions below. Two rows get different colors whenever
+   * one of them has an entry in the column of the other one, so the rows of
+   * one color can be relaxed independently of each other. The rows are
+   * colored greedily in their natural order, which for example results in a
+   * red-black ordering for the five-point stencil.
+   *
+   * On return, @p permutation lists the rows sorted by their color and,
+   * within each color, by their index, and @p inverse_permutation is the
+   * inverse of this permutation. The rows of color <tt>c</tt> are the ones
+   * at positions <tt>color_starts[c]</tt> to <tt>color_starts[c+1]</tt> of
+   * @p permutation, i.e., <tt>color_starts</tt> has one more element than
+   * there are colors.
+   */
+  void
+  compute_multicoloring(std::vector<size_type> &permutation,
+                        std::vector<size_type> &inverse_permutation,
+                        std::vector<size_type> &color_starts) const;
+
+  /**
+   * Perform a multicolored SOR preconditioning in-place, using the coloring
+   * computed by compute_multicoloring(). This is the same operation as
+   * PSOR() with the given permutation, and gives the same result. Since the
+   * rows of one color are not coupled to each other, they are processed in
+   * parallel, one color after the other.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void
+  multicolor_SOR(Vector<somenumber> &          v,
+                 const std::vector<size_type> &permutation,
+                 const std::vector<size_type> &inverse_permutation,
+                 const std::vector<size_type> &color_starts,
+                 const number                  om = 1.) const;
+
+  /**
+   * Perform a multicolored transpose SOR preconditioning in-place, which
+   * gives the same result as TPSOR() with the given permutation. See
+   * multicolor_SOR() for the arguments.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void
+  multicolor_TSOR(Vector<somenumber> &          v,
+                  const std::vector<size_type> &permutation,
+                  const std::vector<size_type> &inverse_permutation,
+                  const std::vector<size_type> &color_starts,
+                  const number                  om = 1.) const;
+
+  /**
+   * Apply SSOR preconditioning to <tt>src</tt> with damping <tt>om</tt>,
+   * where the forward and backward sweeps visit the rows in the order of the
+   * coloring computed by compute_multicoloring(). See multicolor_SOR() for
+   * the arguments.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void
+  precondition_multicolor_SSOR(
+    Vector<somenumber> &          dst,
+    const Vector<somenumber> &    src,
+    const std::vector<size_type> &permutation,
+    const std::vector<size_type> &inverse_permutation,
+    const std::vector<size_type> &color_starts,
+    const number                  om = 1.) const;
+
+  /**
+   * Do one SOR step on <tt>v</tt> with right hand side <tt>b</tt>, visiting
+   * the rows in the order of the coloring computed by
+   * compute_multicoloring(). See multicolor_SOR() for the arguments.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void
+  multicolor_SOR_step(Vector<somenumber> &          v,
+                      const Vector<somenumber> &    b,
+                      const std::vector<size_type> &permutation,
+                      const std::vector<size_type> &color_starts,
+                      const number                  om = 1.) const;
+
+  /**
+   * Do one adjoint SOR step on <tt>v</tt> with right hand side <tt>b</tt>,
+   * visiting the colors computed by compute_multicoloring() in reverse
+   * order.
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void
+  multicolor_TSOR_step(Vector<somenumber> &          v,
+                       const Vector<somenumber> &    b,
+                       const std::vector<size_type> &permutation,
+                       const std::vector<size_type> &color_starts,
+                       const number                  om = 1.) const;
+
+  /**
+   * Do one multicolored SSOR step on <tt>v</tt> with right hand side
+   * <tt>b</tt> by performing multicolor_TSOR_step() after
+   * multicolor_SOR_step().
+   *
+   * @dealiiOperationIsMultithreaded
+   */
+  template <typename somenumber>
+  void
+  multicolor_SSOR_step(Vector<somenumber> &          v,
+                       const Vector<somenumber> &    b,
+                       const std::vector<size_type> &permutation,
+                       const std::vector<size_type> &color_starts,
+                       const number                  om = 1.) const;
   //@}
   /**
    * @name Iterators
@@ -1697,6 +1875,14 @@ protected:
   prepare_set();
 
 private:
+  /**
+   * Set up the column-wise view of the sparsity pattern that is used by the
+   * parallel implementation of Tvmult() and Tvmult_add(), unless it is
+   * already available.
+   */
+  void
+  compute_transposed_structure() const;
+
   /**
    * Pointer to the sparsity pattern used for this matrix. In order to
    * guarantee that it is not deleted while still in use, we subscribe to it
@@ -1721,6 +1907,39 @@ private:
    */
   std::size_t max_len;
 
+  /**
+   * For every column of the matrix, the position of its first entry in the
+   * arrays #transposed_rownums and #transposed_positions. The last element
+   * holds the number of nonzero entries.
+   */
+  mutable std::vector<std::size_t> transposed_colstart;
+
+  /**
+   * The row indices of the nonzero entries of the matrix, sorted by columns
+   * and, within each column, by rows.
+   */
+  mutable std::vector<size_type> transposed_rownums;
+
+  /**
+   * The positions within #val of the nonzero entries of the matrix, in the
+   * same order as #transposed_rownums.
+   */
+  mutable std::vector<std::size_t> transposed_positions;
+
+  /**
+   * A mutex that guards the computation of the column-wise view of the
+   * sparsity pattern when Tvmult() is called from several threads.
+   */
+  mutable Threads::Mutex transposed_structure_mutex;
+
+  /**
+   * A copy of the column indices of the sparsity pattern stored as 32-bit
+   * integers, set up by compress_column_indices(). Empty if the column
+   * indices of the sparsity pattern are used. The sparsity pattern keeps its
+   * own indices, which are needed by all other functions.
+   */
+  std::vector<unsigned int> compressed_colnums;
+
   // make all other sparse matrices friends
   template <typename somenumber>
   friend class SparseMatrix;
@@ -19,6 +19,8 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/parallel.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/thread_management.h>
@@ -37,6 +39,7 @@
 #include <cmath>
 #include <functional>
 #include <iomanip>
+#include <limits>
 #include <numeric>
 #include <ostream>
 #include <vector>
@@ -78,6 +81,10 @@ SparseMatrix<number>::SparseMatrix(SparseMatrix<number> &&m) noexcept
   , cols(m.cols)
   , val(std::move(m.val))
   , max_len(m.max_len)
+  , transposed_colstart(std::move(m.transposed_colstart))
+  , transposed_rownums(std::move(m.transposed_rownums))
+  , transposed_positions(std::move(m.transposed_positions))
+  , compressed_colnums(std::move(m.compressed_colnums))
 {
   m.cols    = nullptr;
   m.val     = nullptr;
@@ -106,9 +113,13 @@ template <typename number>
 SparseMatrix<number> &
 SparseMatrix<number>::operator=(SparseMatrix<number> &&m) noexcept
 {
-  cols    = m.cols;
-  val     = std::move(m.val);
-  max_len = m.max_len;
+  cols                 = m.cols;
+  val                  = std::move(m.val);
+  max_len              = m.max_len;
+  transposed_colstart  = std::move(m.transposed_colstart);
+  transposed_rownums   = std::move(m.transposed_rownums);
+  transposed_positions = std::move(m.transposed_positions);
+  compressed_colnums   = std::move(m.compressed_colnums);
 
   m.cols    = nullptr;
   m.val     = nullptr;
@@ -260,6 +271,11 @@ SparseMatrix<number>::reinit(const SparsityPattern &sparsity)
 {
   cols = &sparsity;
 
+  transposed_colstart.clear();
+  transposed_rownums.clear();
+  transposed_positions.clear();
+  compressed_colnums.clear();
+
   if (cols->empty())
     {
       val.reset();
@@ -286,6 +302,11 @@ SparseMatrix<number>::clear()
   cols = nullptr;
   val.reset();
   max_len = 0;
+
+  transposed_colstart.clear();
+  transposed_rownums.clear();
+  transposed_positions.clear();
+  compressed_colnums.clear();
 }
 
 
@@ -491,19 +512,22 @@ namespace internal
      * parallel case it may be called on a subrange, at the discretion of the
      * task scheduler.
      */
-    template <typename number, typename InVector, typename OutVector>
+    template <typename number,
+              typename InVector,
+              typename OutVector,
+              typename IndexType>
     void
     vmult_on_subrange(const size_type    begin_row,
                       const size_type    end_row,
                       const number *     values,
                       const std::size_t *rowstart,
-                      const size_type *  colnums,
+                      const IndexType *  colnums,
                       const InVector &   src,
                       OutVector &        dst,
                       const bool         add)
     {
       const number *               val_ptr    = &values[rowstart[begin_row]];
-      const size_type *            colnum_ptr = &colnums[rowstart[begin_row]];
+      const IndexType *            colnum_ptr = &colnums[rowstart[begin_row]];
       typename OutVector::iterator dst_ptr    = dst.begin() + begin_row;
 
       if (add == false)
@@ -527,6 +551,41 @@ namespace internal
             *dst_ptr++ = s;
           }
     }
+
+
+
+    /**
+     * Perform a Tvmult using the column-wise view of the sparsity pattern
+     * set up by SparseMatrix::compute_transposed_structure(), but only for
+     * a subinterval of the column indices, i.e., of the entries of @p dst.
+     *
+     * The entries of each column are summed in the order of increasing row
+     * indices, which is the order in which the sequential algorithm adds
+     * them to @p dst.
+     */
+    template <typename number, typename InVector, typename OutVector>
+    void
+    Tvmult_on_subrange(const size_type    begin_column,
+                       const size_type    end_column,
+                       const number *     values,
+                       const std::size_t *colstart,
+                       const size_type *  rownums,
+                       const std::size_t *positions,
+                       const InVector &   src,
+                       OutVector &        dst,
+                       const bool         add)
+    {
+      for (size_type column = begin_column; column < end_column; ++column)
+        {
+          typename OutVector::value_type s =
+            add ? typename OutVector::value_type(dst(column)) :
+                  typename OutVector::value_type();
+          for (std::size_t j = colstart[column]; j < colstart[column + 1]; ++j)
+            s += typename OutVector::value_type(values[positions[j]]) *
+                 typename OutVector::value_type(src(rownums[j]));
+          dst(column) = s;
+        }
+    }
   } // namespace SparseMatrixImplementation
 } // namespace internal
 
@@ -763,6 +822,28 @@ SparseMatrix<number>::set(const size_type  row,
 
 
 
+template <typename number>
+void
+SparseMatrix<number>::compress_column_indices()
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+
+  // with 32-bit indices, the sparsity pattern already stores the column
+  // indices in the format we want
+#ifdef DEAL_II_WITH_64BIT_INDICES
+  AssertThrow(n() <= std::numeric_limits<unsigned int>::max(),
+              ExcMessage("The number of columns of this matrix is too large "
+                         "to store the column indices as 32-bit integers."));
+
+  const std::size_t n_entries = cols->n_nonzero_elements();
+  compressed_colnums.resize(n_entries);
+  for (std::size_t i = 0; i < n_entries; ++i)
+    compressed_colnums[i] = static_cast<unsigned int>(cols->colnums[i]);
+#endif
+}
+
+
+
 template <typename number>
 template <class OutVector, class InVector>
 void
@@ -775,20 +856,36 @@ SparseMatrix<number>::vmult(OutVector &dst, const InVector &src) const
 
   Assert(!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
 
-  parallel::apply_to_subranges(
-    0U,
-    m(),
-    std::bind(&internal::SparseMatrixImplementation::
-                vmult_on_subrange<number, InVector, OutVector>,
-              std::placeholders::_1,
-              std::placeholders::_2,
-              val.get(),
-              cols->rowstart.get(),
-              cols->colnums.get(),
-              std::cref(src),
-              std::ref(dst),
-              false),
-    internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+  if (compressed_colnums.size() > 0)
+    parallel::apply_to_subranges(
+      0U,
+      m(),
+      std::bind(&internal::SparseMatrixImplementation::
+                  vmult_on_subrange<number, InVector, OutVector, unsigned int>,
+                std::placeholders::_1,
+                std::placeholders::_2,
+                val.get(),
+                cols->rowstart.get(),
+                compressed_colnums.data(),
+                std::cref(src),
+                std::ref(dst),
+                false),
+      internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+  else
+    parallel::apply_to_subranges(
+      0U,
+      m(),
+      std::bind(&internal::SparseMatrixImplementation::
+                  vmult_on_subrange<number, InVector, OutVector, size_type>,
+                std::placeholders::_1,
+                std::placeholders::_2,
+                val.get(),
+                cols->rowstart.get(),
+                cols->colnums.get(),
+                std::cref(src),
+                std::ref(dst),
+                false),
+      internal::SparseMatrixImplementation::minimum_parallel_grain_size);
 }
 
 
@@ -805,6 +902,28 @@ SparseMatrix<number>::Tvmult(OutVector &dst, const InVector &src) const
 
   Assert(!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
 
+  if (MultithreadInfo::n_threads() > 1 &&
+      n() > internal::SparseMatrixImplementation::minimum_parallel_grain_size)
+    {
+      compute_transposed_structure();
+      parallel::apply_to_subranges(
+        0U,
+        n(),
+        std::bind(&internal::SparseMatrixImplementation::
+                    Tvmult_on_subrange<number, InVector, OutVector>,
+                  std::placeholders::_1,
+                  std::placeholders::_2,
+                  val.get(),
+                  transposed_colstart.data(),
+                  transposed_rownums.data(),
+                  transposed_positions.data(),
+                  std::cref(src),
+                  std::ref(dst),
+                  false),
+        internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+      return;
+    }
+
   dst = 0;
 
   for (size_type i = 0; i < m(); i++)
@@ -832,20 +951,36 @@ SparseMatrix<number>::vmult_add(OutVector &dst, const InVector &src) const
 
   Assert(!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
 
-  parallel::apply_to_subranges(
-    0U,
-    m(),
-    std::bind(&internal::SparseMatrixImplementation::
-                vmult_on_subrange<number, InVector, OutVector>,
-              std::placeholders::_1,
-              std::placeholders::_2,
-              val.get(),
-              cols->rowstart.get(),
-              cols->colnums.get(),
-              std::cref(src),
-              std::ref(dst),
-              true),
-    internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+  if (compressed_colnums.size() > 0)
+    parallel::apply_to_subranges(
+      0U,
+      m(),
+      std::bind(&internal::SparseMatrixImplementation::
+                  vmult_on_subrange<number, InVector, OutVector, unsigned int>,
+                std::placeholders::_1,
+                std::placeholders::_2,
+                val.get(),
+                cols->rowstart.get(),
+                compressed_colnums.data(),
+                std::cref(src),
+                std::ref(dst),
+                true),
+      internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+  else
+    parallel::apply_to_subranges(
+      0U,
+      m(),
+      std::bind(&internal::SparseMatrixImplementation::
+                  vmult_on_subrange<number, InVector, OutVector, size_type>,
+                std::placeholders::_1,
+                std::placeholders::_2,
+                val.get(),
+                cols->rowstart.get(),
+                cols->colnums.get(),
+                std::cref(src),
+                std::ref(dst),
+                true),
+      internal::SparseMatrixImplementation::minimum_parallel_grain_size);
 }
 
 
@@ -862,6 +997,28 @@ SparseMatrix<number>::Tvmult_add(OutVector &dst, const InVector &src) const
 
   Assert(!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
 
+  if (MultithreadInfo::n_threads() > 1 &&
+      n() > internal::SparseMatrixImplementation::minimum_parallel_grain_size)
+    {
+      compute_transposed_structure();
+      parallel::apply_to_subranges(
+        0U,
+        n(),
+        std::bind(&internal::SparseMatrixImplementation::
+                    Tvmult_on_subrange<number, InVector, OutVector>,
+                  std::placeholders::_1,
+                  std::placeholders::_2,
+                  val.get(),
+                  transposed_colstart.data(),
+                  transposed_rownums.data(),
+                  transposed_positions.data(),
+                  std::cref(src),
+                  std::ref(dst),
+                  true),
+        internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+      return;
+    }
+
   for (size_type i = 0; i < m(); i++)
     for (size_type j = cols->rowstart[i]; j < cols->rowstart[i + 1]; j++)
       {
@@ -1292,13 +1449,16 @@ namespace internal
      * parallel case it may be called on a subrange, at the discretion of the
      * task scheduler.
      */
-    template <typename number, typename InVector, typename OutVector>
+    template <typename number,
+              typename InVector,
+              typename OutVector,
+              typename IndexType>
     typename OutVector::value_type
     residual_sqr_on_subrange(const size_type    begin_row,
                              const size_type    end_row,
                              const number *     values,
                              const std::size_t *rowstart,
-                             const size_type *  colnums,
+                             const IndexType *  colnums,
                              const InVector &   u,
                              const InVector &   b,
                              OutVector &        dst)
@@ -1336,22 +1496,42 @@ SparseMatrix<number>::residual(Vector<somenumber> &      dst,
 
   Assert(&u != &dst, ExcSourceEqualsDestination());
 
-  return std::sqrt(parallel::accumulate_from_subranges<somenumber>(
-    std::bind(&internal::SparseMatrixImplementation::residual_sqr_on_subrange<
-                number,
-                Vector<somenumber>,
-                Vector<somenumber>>,
-              std::placeholders::_1,
-              std::placeholders::_2,
-              val.get(),
-              cols->rowstart.get(),
-              cols->colnums.get(),
-              std::cref(u),
-              std::cref(b),
-              std::ref(dst)),
-    0,
-    m(),
-    internal::SparseMatrixImplementation::minimum_parallel_grain_size));
+  if (compressed_colnums.size() > 0)
+    return std::sqrt(parallel::accumulate_from_subranges<somenumber>(
+      std::bind(&internal::SparseMatrixImplementation::
+                  residual_sqr_on_subrange<number,
+                                           Vector<somenumber>,
+                                           Vector<somenumber>,
+                                           unsigned int>,
+                std::placeholders::_1,
+                std::placeholders::_2,
+                val.get(),
+                cols->rowstart.get(),
+                compressed_colnums.data(),
+                std::cref(u),
+                std::cref(b),
+                std::ref(dst)),
+      0,
+      m(),
+      internal::SparseMatrixImplementation::minimum_parallel_grain_size));
+  else
+    return std::sqrt(parallel::accumulate_from_subranges<somenumber>(
+      std::bind(&internal::SparseMatrixImplementation::
+                  residual_sqr_on_subrange<number,
+                                           Vector<somenumber>,
+                                           Vector<somenumber>,
+                                           size_type>,
+                std::placeholders::_1,
+                std::placeholders::_2,
+                val.get(),
+                cols->rowstart.get(),
+                cols->colnums.get(),
+                std::cref(u),
+                std::cref(b),
+                std::ref(dst)),
+      0,
+      m(),
+      internal::SparseMatrixImplementation::minimum_parallel_grain_size));
 }
 
 
@@ -1405,28 +1585,30 @@ SparseMatrix<number>::precondition_Jacobi(Vector<somenumber> &      dst,
 
   internal::SparseMatrixImplementation::AssertNoZerosOnDiagonal(*this);
 
-  const size_type    n            = src.size();
   somenumber *       dst_ptr      = dst.begin();
   const somenumber * src_ptr      = src.begin();
   const std::size_t *rowstart_ptr = cols->rowstart.get();
 
-  // optimize the following loop for
-  // the case that the relaxation
-  // factor is one. In that case, we
-  // can save one FP multiplication
-  // per row
+  // optimize the following loop for the case that the relaxation factor is
+  // one. In that case, we can save one FP multiplication per row
   //
-  // note that for square matrices,
-  // the diagonal entry is the first
-  // in each row, i.e. at index
-  // rowstart[i]. and we do have a
-  // square matrix by above assertion
-  if (om != number(1.))
-    for (size_type i = 0; i < n; ++i, ++dst_ptr, ++src_ptr, ++rowstart_ptr)
-      *dst_ptr = somenumber(om) * *src_ptr / somenumber(val[*rowstart_ptr]);
-  else
-    for (size_type i = 0; i < n; ++i, ++dst_ptr, ++src_ptr, ++rowstart_ptr)
-      *dst_ptr = *src_ptr / somenumber(val[*rowstart_ptr]);
+  // note that for square matrices, the diagonal entry is the first in each
+  // row, i.e. at index rowstart[i]. and we do have a square matrix by above
+  // assertion. the rows are independent of each other, so we can split them
+  // among threads
+  parallel::apply_to_subranges(
+    size_type(0),
+    src.size(),
+    [&](const size_type begin, const size_type end) {
+      if (om != number(1.))
+        for (size_type i = begin; i < end; ++i)
+          dst_ptr[i] =
+            somenumber(om) * src_ptr[i] / somenumber(val[rowstart_ptr[i]]);
+      else
+        for (size_type i = begin; i < end; ++i)
+          dst_ptr[i] = src_ptr[i] / somenumber(val[rowstart_ptr[i]]);
+    },
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size);
 }
 
 
@@ -1828,6 +2010,386 @@ SparseMatrix<number>::SSOR_step(Vector<somenumber> &      v,
 
 
 
+template <typename number>
+void
+SparseMatrix<number>::compute_multicoloring(
+  std::vector<size_type> &permutation,
+  std::vector<size_type> &inverse_permutation,
+  std::vector<size_type> &color_starts) const
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+  AssertDimension(m(), n());
+
+  const size_type n_rows = m();
+
+  // the rows coupled to a given row are the columns of that row plus the
+  // rows that have an entry in its column. the latter are only needed if
+  // they precede the row in the greedy coloring below, so collect, for each
+  // row, the smaller rows that have an entry in its column
+  std::vector<std::size_t> lower_rowstart(n_rows + 1, 0);
+  for (size_type row = 0; row < n_rows; ++row)
+    for (std::size_t j = cols->rowstart[row]; j < cols->rowstart[row + 1]; ++j)
+      if (cols->colnums[j] > row)
+        ++lower_rowstart[cols->colnums[j] + 1];
+  std::partial_sum(lower_rowstart.begin(),
+                   lower_rowstart.end(),
+                   lower_rowstart.begin());
+  std::vector<size_type> lower_rownums(lower_rowstart[n_rows]);
+  {
+    std::vector<std::size_t> next(lower_rowstart.begin(),
+                                  lower_rowstart.end() - 1);
+    for (size_type row = 0; row < n_rows; ++row)
+      for (std::size_t j = cols->rowstart[row]; j < cols->rowstart[row + 1];
+           ++j)
+        if (cols->colnums[j] > row)
+          lower_rownums[next[cols->colnums[j]]++] = row;
+  }
+
+  // give each row the smallest color not taken by a coupled row that is
+  // already colored. a color is taken for the current row if the row is
+  // recorded in color_blocked_for_row
+  std::vector<unsigned int> colors(n_rows);
+  std::vector<size_type>    color_blocked_for_row;
+  for (size_type row = 0; row < n_rows; ++row)
+    {
+      for (std::size_t j = cols->rowstart[row]; j < cols->rowstart[row + 1];
+           ++j)
+        if (cols->colnums[j] < row)
+          color_blocked_for_row[colors[cols->colnums[j]]] = row;
+      for (std::size_t j = lower_rowstart[row]; j < lower_rowstart[row + 1];
+           ++j)
+        color_blocked_for_row[colors[lower_rownums[j]]] = row;
+
+      unsigned int color = 0;
+      while (color < color_blocked_for_row.size() &&
+             color_blocked_for_row[color] == row)
+        ++color;
+      if (color == color_blocked_for_row.size())
+        color_blocked_for_row.push_back(numbers::invalid_size_type);
+      colors[row] = color;
+    }
+
+  // sort the rows by color, keeping the original order within each color
+  color_starts.clear();
+  color_starts.resize(color_blocked_for_row.size() + 1, 0);
+  for (size_type row = 0; row < n_rows; ++row)
+    ++color_starts[colors[row] + 1];
+  std::partial_sum(color_starts.begin(),
+                   color_starts.end(),
+                   color_starts.begin());
+
+  permutation.resize(n_rows);
+  inverse_permutation.resize(n_rows);
+  std::vector<size_type> next(color_starts.begin(), color_starts.end() - 1);
+  for (size_type row = 0; row < n_rows; ++row)
+    {
+      const size_type position = next[colors[row]]++;
+      permutation[position]    = row;
+      inverse_permutation[row] = position;
+    }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::multicolor_SOR(
+  Vector<somenumber> &          dst,
+  const std::vector<size_type> &permutation,
+  const std::vector<size_type> &inverse_permutation,
+  const std::vector<size_type> &color_starts,
+  const number                  om) const
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+  Assert(val != nullptr, ExcNotInitialized());
+  AssertDimension(m(), n());
+  AssertDimension(m(), dst.size());
+  AssertDimension(m(), permutation.size());
+  AssertDimension(m(), inverse_permutation.size());
+  Assert(!color_starts.empty() && color_starts.back() == m(),
+         ExcMessage("The coloring does not match the size of the matrix."));
+
+  internal::SparseMatrixImplementation::AssertNoZerosOnDiagonal(*this);
+
+  // same as PSOR. the rows of one color do not access each other's entries
+  // in dst, so they can be processed in any order
+  for (unsigned int color = 0; color + 1 < color_starts.size(); ++color)
+    parallel::apply_to_subranges(
+      color_starts[color],
+      color_starts[color + 1],
+      [&](const size_type begin, const size_type end) {
+        for (size_type urow = begin; urow < end; ++urow)
+          {
+            const size_type row = permutation[urow];
+            somenumber      s   = dst(row);
+
+            for (size_type j = cols->rowstart[row]; j < cols->rowstart[row + 1];
+                 ++j)
+              {
+                const size_type col = cols->colnums[j];
+                if (inverse_permutation[col] < urow)
+                  s -= somenumber(val[j]) * dst(col);
+              }
+
+            dst(row) =
+              s * somenumber(om) / somenumber(val[cols->rowstart[row]]);
+          }
+      },
+      internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::multicolor_TSOR(
+  Vector<somenumber> &          dst,
+  const std::vector<size_type> &permutation,
+  const std::vector<size_type> &inverse_permutation,
+  const std::vector<size_type> &color_starts,
+  const number                  om) const
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+  Assert(val != nullptr, ExcNotInitialized());
+  AssertDimension(m(), n());
+  AssertDimension(m(), dst.size());
+  AssertDimension(m(), permutation.size());
+  AssertDimension(m(), inverse_permutation.size());
+  Assert(!color_starts.empty() && color_starts.back() == m(),
+         ExcMessage("The coloring does not match the size of the matrix."));
+
+  internal::SparseMatrixImplementation::AssertNoZerosOnDiagonal(*this);
+
+  // same as TPSOR, running through the colors backwards
+  for (unsigned int color = color_starts.size() - 1; color != 0;)
+    {
+      --color;
+      parallel::apply_to_subranges(
+        color_starts[color],
+        color_starts[color + 1],
+        [&](const size_type begin, const size_type end) {
+          for (size_type urow = begin; urow < end; ++urow)
+            {
+              const size_type row = permutation[urow];
+              somenumber      s   = dst(row);
+
+              for (size_type j = cols->rowstart[row];
+                   j < cols->rowstart[row + 1];
+                   ++j)
+                {
+                  const size_type col = cols->colnums[j];
+                  if (inverse_permutation[col] > urow)
+                    s -= somenumber(val[j]) * dst(col);
+                }
+
+              dst(row) =
+                s * somenumber(om) / somenumber(val[cols->rowstart[row]]);
+            }
+        },
+        internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+    }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_multicolor_SSOR(
+  Vector<somenumber> &          dst,
+  const Vector<somenumber> &    src,
+  const std::vector<size_type> &permutation,
+  const std::vector<size_type> &inverse_permutation,
+  const std::vector<size_type> &color_starts,
+  const number                  om) const
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+  Assert(val != nullptr, ExcNotInitialized());
+  AssertDimension(m(), n());
+  AssertDimension(dst.size(), n());
+  AssertDimension(src.size(), n());
+  AssertDimension(m(), permutation.size());
+  AssertDimension(m(), inverse_permutation.size());
+  Assert(!color_starts.empty() && color_starts.back() == m(),
+         ExcMessage("The coloring does not match the size of the matrix."));
+
+  internal::SparseMatrixImplementation::AssertNoZerosOnDiagonal(*this);
+
+  const unsigned int n_colors = color_starts.size() - 1;
+
+  // forward sweep with the rows preceding the current one in the colored
+  // order, one color after the other
+  for (unsigned int color = 0; color < n_colors; ++color)
+    parallel::apply_to_subranges(
+      color_starts[color],
+      color_starts[color + 1],
+      [&](const size_type begin, const size_type end) {
+        for (size_type urow = begin; urow < end; ++urow)
+          {
+            const size_type row = permutation[urow];
+            number          s   = 0;
+            for (size_type j = cols->rowstart[row] + 1;
+                 j < cols->rowstart[row + 1];
+                 ++j)
+              {
+                const size_type col = cols->colnums[j];
+                if (inverse_permutation[col] < urow)
+                  s += val[j] * number(dst(col));
+              }
+
+            dst(row) = src(row);
+            dst(row) -= s * om;
+            dst(row) /= val[cols->rowstart[row]];
+          }
+      },
+      internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+
+  parallel::apply_to_subranges(
+    size_type(0),
+    m(),
+    [&](const size_type begin, const size_type end) {
+      for (size_type row = begin; row < end; ++row)
+        dst(row) *= somenumber(om * (number(2.) - om)) *
+                    somenumber(val[cols->rowstart[row]]);
+    },
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+
+  // backward sweep with the rows following the current one
+  for (unsigned int color = n_colors; color != 0;)
+    {
+      --color;
+      parallel::apply_to_subranges(
+        color_starts[color],
+        color_starts[color + 1],
+        [&](const size_type begin, const size_type end) {
+          for (size_type urow = begin; urow < end; ++urow)
+            {
+              const size_type row = permutation[urow];
+              number          s   = 0;
+              for (size_type j = cols->rowstart[row] + 1;
+                   j < cols->rowstart[row + 1];
+                   ++j)
+                {
+                  const size_type col = cols->colnums[j];
+                  if (inverse_permutation[col] > urow)
+                    s += val[j] * number(dst(col));
+                }
+
+              dst(row) -= s * om;
+              dst(row) /= val[cols->rowstart[row]];
+            }
+        },
+        internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+    }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::multicolor_SOR_step(
+  Vector<somenumber> &          v,
+  const Vector<somenumber> &    b,
+  const std::vector<size_type> &permutation,
+  const std::vector<size_type> &color_starts,
+  const number                  om) const
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+  Assert(val != nullptr, ExcNotInitialized());
+  AssertDimension(m(), n());
+  AssertDimension(m(), v.size());
+  AssertDimension(m(), b.size());
+  AssertDimension(m(), permutation.size());
+  Assert(!color_starts.empty() && color_starts.back() == m(),
+         ExcMessage("The coloring does not match the size of the matrix."));
+
+  internal::SparseMatrixImplementation::AssertNoZerosOnDiagonal(*this);
+
+  for (unsigned int color = 0; color + 1 < color_starts.size(); ++color)
+    parallel::apply_to_subranges(
+      color_starts[color],
+      color_starts[color + 1],
+      [&](const size_type begin, const size_type end) {
+        for (size_type urow = begin; urow < end; ++urow)
+          {
+            const size_type row = permutation[urow];
+            somenumber      s   = b(row);
+            for (size_type j = cols->rowstart[row]; j < cols->rowstart[row + 1];
+                 ++j)
+              s -= somenumber(val[j]) * v(cols->colnums[j]);
+            v(row) += s * somenumber(om) / somenumber(val[cols->rowstart[row]]);
+          }
+      },
+      internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::multicolor_TSOR_step(
+  Vector<somenumber> &          v,
+  const Vector<somenumber> &    b,
+  const std::vector<size_type> &permutation,
+  const std::vector<size_type> &color_starts,
+  const number                  om) const
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+  Assert(val != nullptr, ExcNotInitialized());
+  AssertDimension(m(), n());
+  AssertDimension(m(), v.size());
+  AssertDimension(m(), b.size());
+  AssertDimension(m(), permutation.size());
+  Assert(!color_starts.empty() && color_starts.back() == m(),
+         ExcMessage("The coloring does not match the size of the matrix."));
+
+  internal::SparseMatrixImplementation::AssertNoZerosOnDiagonal(*this);
+
+  for (unsigned int color = color_starts.size() - 1; color != 0;)
+    {
+      --color;
+      parallel::apply_to_subranges(
+        color_starts[color],
+        color_starts[color + 1],
+        [&](const size_type begin, const size_type end) {
+          for (size_type urow = begin; urow < end; ++urow)
+            {
+              const size_type row = permutation[urow];
+              somenumber      s   = b(row);
+              for (size_type j = cols->rowstart[row];
+                   j < cols->rowstart[row + 1];
+                   ++j)
+                s -= somenumber(val[j]) * v(cols->colnums[j]);
+              v(row) +=
+                s * somenumber(om) / somenumber(val[cols->rowstart[row]]);
+            }
+        },
+        internal::SparseMatrixImplementation::minimum_parallel_grain_size);
+    }
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::multicolor_SSOR_step(
+  Vector<somenumber> &          v,
+  const Vector<somenumber> &    b,
+  const std::vector<size_type> &permutation,
+  const std::vector<size_type> &color_starts,
+  const number                  om) const
+{
+  multicolor_SOR_step(v, b, permutation, color_starts, om);
+  multicolor_TSOR_step(v, b, permutation, color_starts, om);
+}
+
+
+
 template <typename number>
 template <typename somenumber>
 void
@@ -2073,7 +2635,51 @@ template <typename number>
 std::size_t
 SparseMatrix<number>::memory_consumption() const
 {
-  return max_len * static_cast<std::size_t>(sizeof(number)) + sizeof(*this);
+  return max_len * static_cast<std::size_t>(sizeof(number)) + sizeof(*this) +
+         MemoryConsumption::memory_consumption(transposed_colstart) +
+         MemoryConsumption::memory_consumption(transposed_rownums) +
+         MemoryConsumption::memory_consumption(transposed_positions) +
+         MemoryConsumption::memory_consumption(compressed_colnums);
+}
+
+
+
+template <typename number>
+void
+SparseMatrix<number>::compute_transposed_structure() const
+{
+  Assert(cols != nullptr, ExcNotInitialized());
+  Assert(cols->compressed || cols->empty(),
+         SparsityPattern::ExcNotCompressed());
+
+  Threads::Mutex::ScopedLock lock(transposed_structure_mutex);
+
+  const std::size_t n_entries = cols->rowstart[m()];
+  if (transposed_colstart.size() == n() + 1 &&
+      transposed_positions.size() == n_entries)
+    return;
+
+  // Count the entries in each column and convert the counts into the
+  // positions of the first entry of each column
+  transposed_colstart.assign(n() + 1, 0);
+  for (std::size_t j = 0; j < n_entries; ++j)
+    ++transposed_colstart[cols->colnums[j] + 1];
+  for (size_type column = 0; column < n(); ++column)
+    transposed_colstart[column + 1] += transposed_colstart[column];
+
+  // Distribute the entries into their columns. Going through the rows in
+  // order makes sure that the entries of each column are sorted by rows.
+  transposed_rownums.resize(n_entries);
+  transposed_positions.resize(n_entries);
+  std::vector<std::size_t> next_position(transposed_colstart.begin(),
+                                         transposed_colstart.end() - 1);
+  for (size_type row = 0; row < m(); ++row)
+    for (std::size_t j = cols->rowstart[row]; j < cols->rowstart[row + 1]; ++j)
+      {
+        const std::size_t position = next_position[cols->colnums[j]]++;
+        transposed_rownums[position]   = row;
+        transposed_positions[position] = j;
+      }
 }
 
 
@@ -92,6 +92,8 @@ public:
    * decomposition.
    *
    * After this function is called the preconditioner is ready to be used.
+   *
+   * @dealiiOperationIsMultithreaded
    */
   template <typename somenumber>
   void
@@ -103,6 +105,8 @@ public:
    * $dst=(LU)^{-1}src$.
    *
    * Call @p initialize before calling this function.
+   *
+   * @dealiiOperationIsMultithreaded
    */
   template <typename somenumber>
   void
@@ -77,6 +77,7 @@ SparseMIC<number>::initialize(const SparseMatrix<somenumber> &matrix,
   SparseLUDecomposition<number>::initialize(matrix, data);
   this->strengthen_diagonal = data.strengthen_diagonal;
   this->prebuild_lower_bound();
+  this->compute_level_schedule();
   this->copy_from(matrix);
 
   Assert(this->m() == this->n(), ExcNotQuadratic());
@@ -102,24 +103,32 @@ SparseMIC<number>::initialize(const SparseMatrix<somenumber> &matrix,
   for (size_type row = 0; row < this->m(); row++)
     inner_sums[row] = get_rowsum(row);
 
-  for (size_type row = 0; row < this->m(); row++)
-    {
-      const number temp  = this->begin(row)->value();
-      number       temp1 = 0;
-
-      // work on the lower left part of the matrix. we know
-      // it's symmetric, so we can work with this alone
-      for (typename SparseMatrix<somenumber>::const_iterator p =
-             matrix.begin(row) + 1;
-           (p != matrix.end(row)) && (p->column() < row);
-           ++p)
-        temp1 += p->value() / diag[p->column()] * inner_sums[p->column()];
-
-      Assert(temp - temp1 > 0, ExcStrengthenDiagonalTooSmall());
-      diag[row] = temp - temp1;
-
-      inv_diag[row] = 1.0 / diag[row];
-    }
+  const auto factorize_row = [&](const size_type row) {
+    const number temp  = this->begin(row)->value();
+    number       temp1 = 0;
+
+    // work on the lower left part of the matrix. we know
+    // it's symmetric, so we can work with this alone
+    for (typename SparseMatrix<somenumber>::const_iterator p =
+           matrix.begin(row) + 1;
+         (p != matrix.end(row)) && (p->column() < row);
+         ++p)
+      temp1 += p->value() / diag[p->column()] * inner_sums[p->column()];
+
+    Assert(temp - temp1 > 0, ExcStrengthenDiagonalTooSmall());
+    diag[row] = temp - temp1;
+
+    inv_diag[row] = 1.0 / diag[row];
+  };
+
+  // row i depends on the rows left of the diagonal in the sparsity pattern
+  // of the given matrix. the level schedule describes these dependencies
+  // only if the decomposition uses the same sparsity pattern
+  if (&this->get_sparsity_pattern() == &matrix.get_sparsity_pattern())
+    this->apply_in_forward_order(factorize_row);
+  else
+    for (size_type row = 0; row < this->m(); row++)
+      factorize_row(row);
 }
 
 
@@ -158,38 +167,36 @@ SparseMIC<number>::vmult(Vector<somenumber> &      dst,
   //
   // Solve (X-L)X{-1}(X-U) x = b in 3 steps:
   dst = src;
-  for (size_type row = 0; row < N; ++row)
-    {
-      // Now: (X-L)u = b
-
-      // get start of this row. skip
-      // the diagonal element
-      for (typename SparseMatrix<number>::const_iterator p =
-             this->begin(row) + 1;
-           (p != this->end(row)) && (p->column() < row);
-           ++p)
-        dst(row) -= p->value() * dst(p->column());
+  this->apply_in_forward_order([&](const size_type row) {
+    // Now: (X-L)u = b
+
+    // get start of this row. skip
+    // the diagonal element
+    for (typename SparseMatrix<number>::const_iterator p =
+           this->begin(row) + 1;
+         (p != this->end(row)) && (p->column() < row);
+         ++p)
+      dst(row) -= p->value() * dst(p->column());
 
-      dst(row) *= inv_diag[row];
-    }
+    dst(row) *= inv_diag[row];
+  });
 
   // Now: v = Xu
   for (size_type row = 0; row < N; row++)
     dst(row) *= diag[row];
 
   // x = (X-U)v
-  for (int row = N - 1; row >= 0; --row)
-    {
-      // get end of this row
-      for (typename SparseMatrix<number>::const_iterator p =
-             this->begin(row) + 1;
-           p != this->end(row);
-           ++p)
-        if (p->column() > static_cast<size_type>(row))
-          dst(row) -= p->value() * dst(p->column());
-
-      dst(row) *= inv_diag[row];
-    }
+  this->apply_in_backward_order([&](const size_type row) {
+    // get end of this row
+    for (typename SparseMatrix<number>::const_iterator p =
+           this->begin(row) + 1;
+         p != this->end(row);
+         ++p)
+      if (p->column() > row)
+        dst(row) -= p->value() * dst(p->column());
+
+    dst(row) *= inv_diag[row];
+  });
 }
 
 
@@ -196,12 +196,16 @@ namespace internal
       /**
        * Compute a renumbering of the degrees of freedom to improve the data
        * access patterns for this class that can be utilized by the categories
-       * in the IndexStorageVariants enum. For example, the index ordering can
-       * be improved for typical DG elements by interleaving the degrees of
-       * freedom from batches of cells, which avoids the explicit data
-       * transposition in IndexStorageVariants::contiguous. Currently, these
-       * more advanced features are not implemented, so there is only limited
-       * value of this function.
+       * in the IndexStorageVariants enum. The degrees of freedom of the cells
+       * in a batch are interleaved, i.e., the first degree of freedom of all
+       * cells of the batch is followed by the second one of all cells, and so
+       * on. For DG elements, this results in the storage variant
+       * IndexStorageVariants::interleaved_contiguous and avoids the explicit
+       * data transposition in IndexStorageVariants::contiguous. The batches
+       * where all lanes are filled are numbered before the partially filled
+       * ones, so that each of them starts at a multiple of the vectorization
+       * length and can be accessed with aligned loads and stores. Cells with
+       * constraints keep the order of their degrees of freedom.
        */
       void
       compute_dof_renumbering(
@@ -215,6 +219,12 @@ namespace internal
        * The intent of this pattern is to zero the vector entries in close
        * temporal proximity to the first access and thus keeping the vector
        * entries in cache.
+       *
+       * Furthermore, this function fills the lists of ranges of locally owned
+       * indices that are touched for the first and for the last time within
+       * each partition of the loop, @p cell_loop_pre_list and @p
+       * cell_loop_post_list, which are used for the operations passed to
+       * MatrixFree::cell_loop() that run before and after the loop.
        */
       template <int length>
       void
@@ -598,6 +608,42 @@ namespace internal
        * Stores the actual ranges in the vector to be cleared.
        */
       std::vector<unsigned int> vector_zero_range_list;
+
+      /**
+       * Stores an integer to each partition in TaskInfo that indicates when
+       * to run the operation before the loop, passed to the respective
+       * argument of MatrixFree::cell_loop(), on the ranges of locally owned
+       * indices in @p cell_loop_pre_list. The entry after the last partition
+       * refers to the ranges that must be processed before the loop starts,
+       * i.e., the ones that are sent to other processors in the ghost
+       * exchange.
+       */
+      std::vector<unsigned int> cell_loop_pre_list_index;
+
+      /**
+       * Stores the ranges of locally owned indices, as pairs of the first
+       * index and one past the last index, on which to run the operation
+       * before the loop.
+       */
+      std::vector<std::pair<unsigned int, unsigned int>> cell_loop_pre_list;
+
+      /**
+       * Stores an integer to each partition in TaskInfo that indicates when
+       * to run the operation after the loop, passed to the respective
+       * argument of MatrixFree::cell_loop(), on the ranges of locally owned
+       * indices in @p cell_loop_post_list. The entry after the last
+       * partition refers to the ranges that can only be processed after the
+       * loop has finished, i.e., the ones that receive contributions from
+       * other processors in the compress step.
+       */
+      std::vector<unsigned int> cell_loop_post_list_index;
+
+      /**
+       * Stores the ranges of locally owned indices, as pairs of the first
+       * index and one past the last index, on which to run the operation
+       * after the loop.
+       */
+      std::vector<std::pair<unsigned int, unsigned int>> cell_loop_post_list;
     };
 
 
@@ -1209,14 +1209,37 @@ namespace internal
       const std::vector<FaceToCellTopology<length>> &faces)
     {
       // compute a list that tells us the first time a degree of freedom is
-      // touched by a cell
+      // touched by a cell, and for the locally owned degrees of freedom also
+      // the first and last time a degree of freedom is touched by a cell or
+      // a face
       AssertDimension(length, vectorization_length);
       const unsigned int n_components = start_components.back();
-      const unsigned int n_dofs       = vector_partitioner->local_size() +
-                                  vector_partitioner->n_ghost_indices();
+      const unsigned int n_owned      = vector_partitioner->local_size();
+      const unsigned int n_dofs =
+        n_owned + vector_partitioner->n_ghost_indices();
       std::vector<unsigned int> touched_by(
         (n_dofs + chunk_size_zero_vector - 1) / chunk_size_zero_vector,
         numbers::invalid_unsigned_int);
+      std::vector<unsigned int> touched_first_by(
+        (n_owned + chunk_size_zero_vector - 1) / chunk_size_zero_vector,
+        numbers::invalid_unsigned_int);
+      std::vector<unsigned int> touched_last_by(
+        touched_first_by.size(), numbers::invalid_unsigned_int);
+      const auto touch_owned = [&](const unsigned int cell,
+                                   const unsigned int chunk) {
+        for (unsigned int it = row_starts[cell * n_components].first;
+             it != row_starts[(cell + 1) * n_components].first;
+             ++it)
+          if (dof_indices[it] < n_owned)
+            {
+              const unsigned int myindex =
+                dof_indices[it] / chunk_size_zero_vector;
+              if (touched_first_by[myindex] == numbers::invalid_unsigned_int)
+                touched_first_by[myindex] = chunk;
+              touched_last_by[myindex] = chunk;
+            }
+      };
+
       for (unsigned int part = 0;
            part < task_info.partition_row_index.size() - 2;
            ++part)
@@ -1241,39 +1264,71 @@ namespace internal
                     if (touched_by[myindex] == numbers::invalid_unsigned_int)
                       touched_by[myindex] = chunk;
                   }
+                for (unsigned int v = 0; v < vectorization_length; ++v)
+                  touch_owned(cell * vectorization_length + v, chunk);
               }
             if (faces.size() > 0)
-              for (unsigned int face = task_info.face_partition_data[chunk];
-                   face < task_info.face_partition_data[chunk + 1];
-                   ++face)
-                for (unsigned int v = 0;
-                     v < length && faces[face].cells_exterior[v] !=
-                                     numbers::invalid_unsigned_int;
-                     ++v)
-                  {
-                    const unsigned int cell = faces[face].cells_exterior[v];
-                    for (unsigned int it =
-                           row_starts[cell * n_components].first;
-                         it != row_starts[(cell + 1) * n_components].first;
-                         ++it)
-                      {
-                        const unsigned int myindex =
-                          dof_indices[it] / chunk_size_zero_vector;
-                        if (touched_by[myindex] ==
-                            numbers::invalid_unsigned_int)
-                          touched_by[myindex] = chunk;
-                      }
-                  }
+              {
+                for (unsigned int face = task_info.face_partition_data[chunk];
+                     face < task_info.face_partition_data[chunk + 1];
+                     ++face)
+                  for (unsigned int v = 0;
+                       v < length && faces[face].cells_exterior[v] !=
+                                       numbers::invalid_unsigned_int;
+                       ++v)
+                    {
+                      const unsigned int cell = faces[face].cells_exterior[v];
+                      for (unsigned int it =
+                             row_starts[cell * n_components].first;
+                           it != row_starts[(cell + 1) * n_components].first;
+                           ++it)
+                        {
+                          const unsigned int myindex =
+                            dof_indices[it] / chunk_size_zero_vector;
+                          if (touched_by[myindex] ==
+                              numbers::invalid_unsigned_int)
+                            touched_by[myindex] = chunk;
+                        }
+                      touch_owned(cell, chunk);
+                      touch_owned(faces[face].cells_interior[v], chunk);
+                    }
+                for (unsigned int face =
+                       task_info.boundary_partition_data[chunk];
+                     face < task_info.boundary_partition_data[chunk + 1];
+                     ++face)
+                  for (unsigned int v = 0;
+                       v < length && faces[face].cells_interior[v] !=
+                                       numbers::invalid_unsigned_int;
+                       ++v)
+                    touch_owned(faces[face].cells_interior[v], chunk);
+              }
           }
+
       // ensure that all indices are touched at least during the last round
+      const unsigned int n_chunks =
+        task_info.partition_row_index[task_info.partition_row_index.size() - 2];
+      const unsigned int last_chunk = n_chunks > 0 ? n_chunks - 1 : 0;
       for (auto &index : touched_by)
         if (index == numbers::invalid_unsigned_int)
-          index = task_info.cell_partition_data.back() - 1;
-
-      vector_zero_range_list_index.resize(
-        1 + task_info
-              .partition_row_index[task_info.partition_row_index.size() - 2],
-        numbers::invalid_unsigned_int);
+          index = last_chunk;
+      for (unsigned int i = 0; i < touched_first_by.size(); ++i)
+        if (touched_first_by[i] == numbers::invalid_unsigned_int)
+          touched_first_by[i] = touched_last_by[i] = last_chunk;
+
+      // the indices that are sent to other processors during the ghost
+      // exchange must be processed before the communication starts, and the
+      // ones that receive contributions from other processors in the
+      // compress step only after the communication has finished, which is
+      // expressed by the additional index n_chunks
+      for (const auto &range : vector_partitioner->import_indices())
+        for (unsigned int i = range.first / chunk_size_zero_vector;
+             i < (range.second + chunk_size_zero_vector - 1) /
+                   chunk_size_zero_vector;
+             ++i)
+          touched_first_by[i] = touched_last_by[i] = n_chunks;
+
+      vector_zero_range_list_index.resize(1 + n_chunks,
+                                          numbers::invalid_unsigned_int);
       std::map<unsigned int, std::vector<unsigned int>> chunk_must_zero_vector;
       for (unsigned int i = 0; i < touched_by.size(); ++i)
         chunk_must_zero_vector[touched_by[i]].push_back(i);
@@ -1295,6 +1350,40 @@ namespace internal
             vector_zero_range_list_index[chunk + 1] =
               vector_zero_range_list_index[chunk];
         }
+
+      // translate the chunks into ranges of indices, merging adjacent
+      // chunks, in a layout similar to a sparsity pattern
+      const auto convert_to_range_list =
+        [&](const std::vector<unsigned int> &touched,
+            std::vector<unsigned int> &      range_list_index,
+            std::vector<std::pair<unsigned int, unsigned int>> &range_list) {
+          std::vector<std::vector<unsigned int>> chunks_of_range(n_chunks + 1);
+          for (unsigned int i = 0; i < touched.size(); ++i)
+            chunks_of_range[touched[i]].push_back(i);
+          range_list_index.resize(n_chunks + 2);
+          range_list_index[0] = 0;
+          range_list.clear();
+          for (unsigned int chunk = 0; chunk < n_chunks + 1; ++chunk)
+            {
+              const std::vector<unsigned int> &list = chunks_of_range[chunk];
+              for (unsigned int i = 0; i < list.size(); ++i)
+                {
+                  const unsigned int first = list[i];
+                  while (i + 1 < list.size() && list[i + 1] == list[i] + 1)
+                    ++i;
+                  range_list.emplace_back(
+                    first * chunk_size_zero_vector,
+                    std::min((list[i] + 1) * chunk_size_zero_vector, n_owned));
+                }
+              range_list_index[chunk + 1] = range_list.size();
+            }
+        };
+      convert_to_range_list(touched_first_by,
+                            cell_loop_pre_list_index,
+                            cell_loop_pre_list);
+      convert_to_range_list(touched_last_by,
+                            cell_loop_post_list_index,
+                            cell_loop_post_list);
     }
 
 
@@ -1555,33 +1644,47 @@ namespace internal
       Assert(n_macro_cells <=
                (row_starts.size() - 1) / vectorization_length / n_components,
              ExcInternalError());
-      for (unsigned int cell_no = 0; cell_no < n_macro_cells; ++cell_no)
-        {
-          // do not renumber in case we have constraints
-          if (row_starts[cell_no * n_components * vectorization_length]
-                .second ==
-              row_starts[(cell_no + 1) * n_components * vectorization_length]
-                .second)
-            {
-              const unsigned int ndofs =
-                dofs_per_cell.size() == 1 ?
-                  dofs_per_cell[0] :
-                  (dofs_per_cell[cell_active_fe_index.size() > 0 ?
-                                   cell_active_fe_index[cell_no] :
-                                   0]);
-              const unsigned int *dof_ind =
-                dof_indices.data() +
-                row_starts[cell_no * n_components * vectorization_length].first;
-              for (unsigned int i = 0; i < ndofs; ++i)
-                for (unsigned int j = 0;
-                     j < n_vectorization_lanes_filled[dof_access_cell][cell_no];
-                     ++j)
-                  if (dof_ind[j * ndofs + i] < local_size)
-                    if (renumbering[dof_ind[j * ndofs + i]] ==
-                        numbers::invalid_dof_index)
-                      renumbering[dof_ind[j * ndofs + i]] = counter++;
-            }
-        }
+
+      // Number the degrees of freedom of the cell batches without
+      // constraints, interleaving the unknowns of the cells of a batch. The
+      // batches with all lanes filled go first: for DG elements, each of
+      // them then occupies a contiguous range that starts at a multiple of
+      // the vectorization length, so that FEEvaluation can access it with
+      // aligned vector loads and stores. Partially filled batches, e.g. at
+      // the end of a vectorization category or of a partition, go second, in
+      // order not to shift the ranges of the subsequent full batches.
+      for (const bool full_batches : {true, false})
+        for (unsigned int cell_no = 0; cell_no < n_macro_cells; ++cell_no)
+          {
+            const unsigned int n_lanes =
+              n_vectorization_lanes_filled[dof_access_cell][cell_no];
+            if ((n_lanes == vectorization_length) != full_batches)
+              continue;
+
+            // do not renumber in case we have constraints
+            if (row_starts[cell_no * n_components * vectorization_length]
+                  .second ==
+                row_starts[(cell_no + 1) * n_components * vectorization_length]
+                  .second)
+              {
+                const unsigned int ndofs =
+                  dofs_per_cell.size() == 1 ?
+                    dofs_per_cell[0] :
+                    (dofs_per_cell[cell_active_fe_index.size() > 0 ?
+                                     cell_active_fe_index[cell_no] :
+                                     0]);
+                const unsigned int *dof_ind =
+                  dof_indices.data() +
+                  row_starts[cell_no * n_components * vectorization_length]
+                    .first;
+                for (unsigned int i = 0; i < ndofs; ++i)
+                  for (unsigned int j = 0; j < n_lanes; ++j)
+                    if (dof_ind[j * ndofs + i] < local_size)
+                      if (renumbering[dof_ind[j * ndofs + i]] ==
+                          numbers::invalid_dof_index)
+                        renumbering[dof_ind[j * ndofs + i]] = counter++;
+              }
+          }
 
       AssertIndexRange(counter, local_size + 1);
       for (types::global_dof_index &dof_index : renumbering)
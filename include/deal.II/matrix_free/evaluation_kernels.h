@@ -58,7 +58,7 @@ namespace internal
   template <bool is_long>
   struct EvaluatorSelector<MatrixFreeFunctions::truncated_tensor, is_long>
   {
-    static const EvaluatorVariant variant = evaluate_general;
+    static const EvaluatorVariant variant = evaluate_truncated;
   };
 
   template <>
@@ -74,6 +74,20 @@ namespace internal
     static const EvaluatorVariant variant = evaluate_evenodd;
   };
 
+  template <>
+  struct EvaluatorSelector<MatrixFreeFunctions::tensor_symmetric_plus_bubbles,
+                           false>
+  {
+    static const EvaluatorVariant variant = evaluate_general;
+  };
+
+  template <>
+  struct EvaluatorSelector<MatrixFreeFunctions::tensor_symmetric_plus_bubbles,
+                           true>
+  {
+    static const EvaluatorVariant variant = evaluate_evenodd;
+  };
+
   template <bool is_long>
   struct EvaluatorSelector<MatrixFreeFunctions::tensor_symmetric_collocation,
                            is_long>
@@ -83,6 +97,187 @@ namespace internal
 
 
 
+  /**
+   * This struct adds the contribution of the bubble functions of
+   * FE_Q_Bubbles to the values, gradients and Hessians in the quadrature
+   * points, or integrates the respective test functions, for the element
+   * type MatrixFreeFunctions::tensor_symmetric_plus_bubbles. Since each
+   * bubble function is a product of one-dimensional factors, see
+   * MatrixFreeFunctions::ShapeInfo::bubble_factors, the shape functions
+   * are assembled on the fly from the one-dimensional data in each
+   * quadrature point. With at most @p dim bubble functions, the cost is
+   * proportional to the number of quadrature points and thus small compared
+   * to the sum factorization kernels for the tensor product part.
+   *
+   * The degrees of freedom of the bubble functions are the last entries of
+   * each component, following the tensor product degrees of freedom.
+   */
+  template <int dim, int n_components, typename Number>
+  struct FEEvaluationImplBubbles
+  {
+    static void
+    evaluate(const MatrixFreeFunctions::ShapeInfo<Number> &shape_info,
+             const Number *                                values_dofs,
+             Number *                                      values_quad,
+             Number *                                      gradients_quad,
+             Number *                                      hessians_quad,
+             const bool                                    evaluate_values,
+             const bool                                    evaluate_gradients,
+             const bool                                    evaluate_hessians)
+    {
+      const unsigned int n_q_points_1d = shape_info.n_q_points_1d;
+      const unsigned int n_q_points    = shape_info.n_q_points;
+      const unsigned int n_tensor_dofs =
+        Utilities::fixed_power<dim>(shape_info.fe_degree + 1);
+      const unsigned int n_bubbles =
+        shape_info.dofs_per_component_on_cell - n_tensor_dofs;
+      const Number *     factors    = shape_info.bubble_factors.begin();
+      constexpr unsigned int n_hessians = dim * (dim + 1) / 2;
+      AssertDimension(shape_info.bubble_factors.size(), 6 * n_q_points_1d);
+
+      for (unsigned int q = 0; q < n_q_points; ++q)
+        {
+          // offsets into the array of the 1D factors for the point q
+          unsigned int q_1d[dim];
+          for (unsigned int d = 0, qq = q; d < dim; ++d, qq /= n_q_points_1d)
+            q_1d[d] = qq % n_q_points_1d;
+
+          for (unsigned int b = 0; b < n_bubbles; ++b)
+            {
+              // factor for direction d with the given derivative order
+              const auto factor = [&](const unsigned int d,
+                                      const unsigned int derivative) {
+                return factors[((d == b ? 3 : 0) + derivative) *
+                                 n_q_points_1d +
+                               q_1d[d]];
+              };
+
+              if (evaluate_values)
+                {
+                  Number value = factor(0, 0);
+                  for (unsigned int d = 1; d < dim; ++d)
+                    value *= factor(d, 0);
+                  for (unsigned int c = 0; c < n_components; ++c)
+                    values_quad[c * n_q_points + q] +=
+                      value *
+                      values_dofs[c * shape_info.dofs_per_component_on_cell +
+                                  n_tensor_dofs + b];
+                }
+              if (evaluate_gradients)
+                for (unsigned int e = 0; e < dim; ++e)
+                  {
+                    Number gradient = factor(0, e == 0);
+                    for (unsigned int d = 1; d < dim; ++d)
+                      gradient *= factor(d, d == e);
+                    for (unsigned int c = 0; c < n_components; ++c)
+                      gradients_quad[(c * dim + e) * n_q_points + q] +=
+                        gradient *
+                        values_dofs[c * shape_info.dofs_per_component_on_cell +
+                                    n_tensor_dofs + b];
+                  }
+              if (evaluate_hessians)
+                {
+                  // diagonal entries first, then the off-diagonal ones in the
+                  // order xy, xz, yz as in FEEvaluationImpl
+                  unsigned int index = 0;
+                  for (unsigned int e = 0; e < dim; ++e)
+                    for (unsigned int f = e; f < dim; ++f)
+                      {
+                        Number hessian =
+                          factor(0, (e == 0 ? 1 : 0) + (f == 0 ? 1 : 0));
+                        for (unsigned int d = 1; d < dim; ++d)
+                          hessian *=
+                            factor(d, (e == d ? 1 : 0) + (f == d ? 1 : 0));
+                        const unsigned int component_index =
+                          e == f ? e : dim + index++;
+                        for (unsigned int c = 0; c < n_components; ++c)
+                          hessians_quad[(c * n_hessians + component_index) *
+                                          n_q_points +
+                                        q] +=
+                            hessian *
+                            values_dofs
+                              [c * shape_info.dofs_per_component_on_cell +
+                               n_tensor_dofs + b];
+                      }
+                }
+            }
+        }
+    }
+
+    static void
+    integrate(const MatrixFreeFunctions::ShapeInfo<Number> &shape_info,
+              Number *                                      values_dofs,
+              const Number *                                values_quad,
+              const Number *                                gradients_quad,
+              const bool                                    integrate_values,
+              const bool                                    integrate_gradients,
+              const bool add_into_values_array)
+    {
+      const unsigned int n_q_points_1d = shape_info.n_q_points_1d;
+      const unsigned int n_q_points    = shape_info.n_q_points;
+      const unsigned int n_tensor_dofs =
+        Utilities::fixed_power<dim>(shape_info.fe_degree + 1);
+      const unsigned int n_bubbles =
+        shape_info.dofs_per_component_on_cell - n_tensor_dofs;
+      const Number *factors = shape_info.bubble_factors.begin();
+      AssertDimension(shape_info.bubble_factors.size(), 6 * n_q_points_1d);
+      AssertIndexRange(n_bubbles, dim + 1);
+
+      Number sums[n_components][dim];
+      for (unsigned int c = 0; c < n_components; ++c)
+        for (unsigned int b = 0; b < n_bubbles; ++b)
+          sums[c][b] = Number();
+
+      for (unsigned int q = 0; q < n_q_points; ++q)
+        {
+          unsigned int q_1d[dim];
+          for (unsigned int d = 0, qq = q; d < dim; ++d, qq /= n_q_points_1d)
+            q_1d[d] = qq % n_q_points_1d;
+
+          for (unsigned int b = 0; b < n_bubbles; ++b)
+            {
+              const auto factor = [&](const unsigned int d,
+                                      const unsigned int derivative) {
+                return factors[((d == b ? 3 : 0) + derivative) *
+                                 n_q_points_1d +
+                               q_1d[d]];
+              };
+
+              if (integrate_values)
+                {
+                  Number value = factor(0, 0);
+                  for (unsigned int d = 1; d < dim; ++d)
+                    value *= factor(d, 0);
+                  for (unsigned int c = 0; c < n_components; ++c)
+                    sums[c][b] += value * values_quad[c * n_q_points + q];
+                }
+              if (integrate_gradients)
+                for (unsigned int e = 0; e < dim; ++e)
+                  {
+                    Number gradient = factor(0, e == 0);
+                    for (unsigned int d = 1; d < dim; ++d)
+                      gradient *= factor(d, d == e);
+                    for (unsigned int c = 0; c < n_components; ++c)
+                      sums[c][b] +=
+                        gradient *
+                        gradients_quad[(c * dim + e) * n_q_points + q];
+                  }
+            }
+        }
+
+      for (unsigned int c = 0; c < n_components; ++c)
+        for (unsigned int b = 0; b < n_bubbles; ++b)
+          if (add_into_values_array)
+            values_dofs[c * shape_info.dofs_per_component_on_cell +
+                        n_tensor_dofs + b] += sums[c][b];
+          else
+            values_dofs[c * shape_info.dofs_per_component_on_cell +
+                        n_tensor_dofs + b] = sums[c][b];
+    }
+  };
+
+
+
   /**
    * This struct performs the evaluation of function values, gradients and
    * Hessians for tensor-product finite elements. The operation is used for
@@ -99,6 +294,11 @@ namespace internal
    * transformed to a collocation space and can then use the identity in these
    * spaces), which both allow for shorter code.
    *
+   * The last template argument selects the variant of the 1D kernels. It
+   * defaults to the choice made by EvaluatorSelector but can be overridden
+   * to force a particular variant, which is used by the run time kernel
+   * selection in evaluation_selector.h.
+   *
    * @author Katharina Kormann, Martin Kronbichler, 2012, 2014, 2017
    */
   template <MatrixFreeFunctions::ElementType type,
@@ -106,7 +306,10 @@ namespace internal
             int                              fe_degree,
             int                              n_q_points_1d,
             int                              n_components,
-            typename Number>
+            typename Number,
+            EvaluatorVariant                 variant =
+              EvaluatorSelector<type,
+                                (fe_degree + n_q_points_1d > 4)>::variant>
   struct FEEvaluationImpl
   {
     static void
@@ -138,9 +341,16 @@ namespace internal
             int                              fe_degree,
             int                              n_q_points_1d,
             int                              n_components,
-            typename Number>
+            typename Number,
+            EvaluatorVariant                 variant>
   inline void
-  FEEvaluationImpl<type, dim, fe_degree, n_q_points_1d, n_components, Number>::
+  FEEvaluationImpl<type,
+                   dim,
+                   fe_degree,
+                   n_q_points_1d,
+                   n_components,
+                   Number,
+                   variant>::
     evaluate(const MatrixFreeFunctions::ShapeInfo<Number> &shape_info,
              const Number *                                values_dofs_actual,
              Number *                                      values_quad,
@@ -155,8 +365,6 @@ namespace internal
         evaluate_hessians == false)
       return;
 
-    const EvaluatorVariant variant =
-      EvaluatorSelector<type, (fe_degree + n_q_points_1d > 4)>::variant;
     using Eval = EvaluatorTensorProduct<variant,
                                         dim,
                                         fe_degree + 1,
@@ -216,14 +424,11 @@ namespace internal
                     values_dofs_tmp[c * dofs_per_comp + count_q] =
                       values_dofs_actual
                         [c * shape_info.dofs_per_component_on_cell + count_p];
-                for (int k = degree + 1 - j - i; k < degree + 1; ++k, ++count_q)
-                  for (unsigned int c = 0; c < n_components; ++c)
-                    values_dofs_tmp[c * dofs_per_comp + count_q] = Number();
+                // the entries outside the truncated index set are never read
+                // by the truncated tensor product kernels, so we skip them
+                count_q += j + i;
               }
-            for (int j = degree + 1 - i; j < degree + 1; ++j)
-              for (int k = 0; k < degree + 1; ++k, ++count_q)
-                for (unsigned int c = 0; c < n_components; ++c)
-                  values_dofs_tmp[c * dofs_per_comp + count_q] = Number();
+            count_q += i * (degree + 1);
           }
         AssertDimension(count_q, dofs_per_comp);
         values_dofs = values_dofs_tmp;
@@ -405,6 +610,18 @@ namespace internal
             values_quad[c * shape_info.n_q_points + q] +=
               values_dofs[(c + 1) * shape_info.dofs_per_component_on_cell - 1];
       }
+
+    // case FE_Q_Bubbles: add the contribution of the bubble functions
+    if (type == MatrixFreeFunctions::tensor_symmetric_plus_bubbles)
+      FEEvaluationImplBubbles<dim, n_components, Number>::evaluate(
+        shape_info,
+        values_dofs_actual,
+        values_quad - n_components * n_q_points,
+        gradients_quad - n_components * dim * n_q_points,
+        hessians_quad - n_components * (dim * (dim + 1) / 2) * n_q_points,
+        evaluate_values,
+        evaluate_gradients,
+        evaluate_hessians);
   }
 
 
@@ -414,9 +631,16 @@ namespace internal
             int                              fe_degree,
             int                              n_q_points_1d,
             int                              n_components,
-            typename Number>
+            typename Number,
+            EvaluatorVariant                 variant>
   inline void
-  FEEvaluationImpl<type, dim, fe_degree, n_q_points_1d, n_components, Number>::
+  FEEvaluationImpl<type,
+                   dim,
+                   fe_degree,
+                   n_q_points_1d,
+                   n_components,
+                   Number,
+                   variant>::
     integrate(const MatrixFreeFunctions::ShapeInfo<Number> &shape_info,
               Number *                                      values_dofs_actual,
               Number *                                      values_quad,
@@ -426,8 +650,6 @@ namespace internal
               const bool                                    integrate_gradients,
               const bool add_into_values_array)
   {
-    const EvaluatorVariant variant =
-      EvaluatorSelector<type, (fe_degree + n_q_points_1d > 4)>::variant;
     using Eval = EvaluatorTensorProduct<variant,
                                         dim,
                                         fe_degree + 1,
@@ -475,6 +697,11 @@ namespace internal
         scratch_data + 2 * (std::max(shape_info.dofs_per_component_on_cell,
                                      shape_info.n_q_points)) :
         values_dofs_actual;
+    // for truncated tensor products, the result is first computed in the
+    // temporary tensor product array and only added to the actual array
+    // when compressing the result below
+    const bool add_into_tensor_array =
+      type != MatrixFreeFunctions::truncated_tensor && add_into_values_array;
 
     switch (dim)
       {
@@ -483,7 +710,7 @@ namespace internal
             {
               if (integrate_values == true)
                 {
-                  if (add_into_values_array == false)
+                  if (add_into_tensor_array == false)
                     eval.template values<0, false, false>(values_quad,
                                                           values_dofs);
                   else
@@ -492,7 +719,7 @@ namespace internal
                 }
               if (integrate_gradients == true)
                 {
-                  if (integrate_values == true || add_into_values_array == true)
+                  if (integrate_values == true || add_into_tensor_array == true)
                     eval.template gradients<0, false, true>(gradients_quad,
                                                             values_dofs);
                   else
@@ -513,7 +740,7 @@ namespace internal
               if (integrate_values == true && integrate_gradients == false)
                 {
                   eval.template values<1, false, false>(values_quad, temp1);
-                  if (add_into_values_array == false)
+                  if (add_into_tensor_array == false)
                     eval.template values<0, false, false>(temp1, values_dofs);
                   else
                     eval.template values<0, false, true>(temp1, values_dofs);
@@ -525,7 +752,7 @@ namespace internal
                                                            temp1);
                   if (integrate_values)
                     eval.template values<1, false, true>(values_quad, temp1);
-                  if (add_into_values_array == false)
+                  if (add_into_tensor_array == false)
                     eval.template values<0, false, false>(temp1, values_dofs);
                   else
                     eval.template values<0, false, true>(temp1, values_dofs);
@@ -547,7 +774,7 @@ namespace internal
                 {
                   eval.template values<2, false, false>(values_quad, temp1);
                   eval.template values<1, false, false>(temp1, temp2);
-                  if (add_into_values_array == false)
+                  if (add_into_tensor_array == false)
                     eval.template values<0, false, false>(temp2, values_dofs);
                   else
                     eval.template values<0, false, true>(temp2, values_dofs);
@@ -564,7 +791,7 @@ namespace internal
                                                           n_q_points,
                                                         temp1);
                   eval.template gradients<1, false, true>(temp1, temp2);
-                  if (add_into_values_array == false)
+                  if (add_into_tensor_array == false)
                     eval.template values<0, false, false>(temp2, values_dofs);
                   else
                     eval.template values<0, false, true>(temp2, values_dofs);
@@ -607,6 +834,17 @@ namespace internal
           }
       }
 
+    // case FE_Q_Bubbles: integrate the bubble functions
+    if (type == MatrixFreeFunctions::tensor_symmetric_plus_bubbles)
+      FEEvaluationImplBubbles<dim, n_components, Number>::integrate(
+        shape_info,
+        values_dofs_actual,
+        values_quad - n_components * n_q_points,
+        gradients_quad - n_components * dim * n_q_points,
+        integrate_values,
+        integrate_gradients,
+        add_into_values_array);
+
     if (type == MatrixFreeFunctions::truncated_tensor)
       {
         values_dofs -= dofs_per_comp * n_components;
@@ -620,9 +858,14 @@ namespace internal
                      ++k, ++count_p, ++count_q)
                   {
                     for (unsigned int c = 0; c < n_components; ++c)
-                      values_dofs_actual
-                        [c * shape_info.dofs_per_component_on_cell + count_p] =
-                          values_dofs[c * dofs_per_comp + count_q];
+                      if (add_into_values_array)
+                        values_dofs_actual
+                          [c * shape_info.dofs_per_component_on_cell +
+                           count_p] += values_dofs[c * dofs_per_comp + count_q];
+                      else
+                        values_dofs_actual
+                          [c * shape_info.dofs_per_component_on_cell +
+                           count_p] = values_dofs[c * dofs_per_comp + count_q];
                   }
                 count_q += j + i;
               }
@@ -1357,6 +1600,11 @@ namespace internal
                      const bool         evaluate_grad,
                      const unsigned int subface_index)
     {
+      Assert(data.element_type !=
+                 MatrixFreeFunctions::tensor_symmetric_plus_bubbles &&
+               data.element_type != MatrixFreeFunctions::truncated_tensor,
+             ExcNotImplemented());
+
       const AlignedVector<Number> &val1 =
         symmetric_evaluate ?
           data.shape_values_eo :
@@ -1518,6 +1766,11 @@ namespace internal
                       const bool         integrate_grad,
                       const unsigned int subface_index)
     {
+      Assert(data.element_type !=
+                 MatrixFreeFunctions::tensor_symmetric_plus_bubbles &&
+               data.element_type != MatrixFreeFunctions::truncated_tensor,
+             ExcNotImplemented());
+
       const AlignedVector<Number> &val1 =
         symmetric_evaluate ?
           data.shape_values_eo :
@@ -1681,6 +1934,11 @@ namespace internal
                 const bool                                    do_gradients,
                 const unsigned int                            face_no)
     {
+      Assert(data.element_type !=
+                 MatrixFreeFunctions::tensor_symmetric_plus_bubbles &&
+               data.element_type != MatrixFreeFunctions::truncated_tensor,
+             ExcNotImplemented());
+
       internal::EvaluatorTensorProduct<internal::evaluate_general,
                                        dim,
                                        fe_degree + 1,
@@ -17,8 +17,15 @@
 #ifndef dealii_matrix_free_evaluation_selector_h
 #define dealii_matrix_free_evaluation_selector_h
 
+#include <deal.II/base/aligned_vector.h>
+
 #include <deal.II/matrix_free/evaluation_kernels.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+
 DEAL_II_NAMESPACE_OPEN
 
 #ifndef DOXYGEN
@@ -33,7 +40,8 @@ namespace internal
     // 1. Start with fe_degree=0, n_q_points_1d=0 and DEPTH=0.
     // 2. If the current assumption on fe_degree doesn't match the runtime
     //    parameter, increase fe_degree  by one and try again.
-    //    If fe_degree==10 use the class Default which serves as a fallback.
+    //    If fe_degree==FE_EVAL_FACTORY_DEGREE_MAX+1 use the class Default
+    //    which serves as a fallback.
     // 3. After fixing the fe_degree, DEPTH is increased (DEPTH=1) and we start
     // with
     //    n_q_points=fe_degree+1.
@@ -123,11 +131,16 @@ namespace internal
     /**
      * This specialization sets the maximal fe_degree for
      * which we want to determine the correct template parameters based at
-     * runtime.
+     * runtime. The value is set at configure time through the CMake
+     * variable FE_EVAL_FACTORY_DEGREE_MAX.
      */
     template <int n_q_points_1d, int dim, int n_components, typename Number>
-    struct Factory<dim, n_components, Number, 0, 10, n_q_points_1d>
-      : Default<dim, n_components, Number>
+    struct Factory<dim,
+                   n_components,
+                   Number,
+                   0,
+                   FE_EVAL_FACTORY_DEGREE_MAX + 1,
+                   n_q_points_1d> : Default<dim, n_components, Number>
     {};
 
     /**
@@ -235,21 +248,18 @@ namespace internal
     };
 
     /**
-     * This class chooses the correct template n_q_points_1d after degree was
-     * chosen.
+     * This class calls the sum factorization kernel selected by
+     * ShapeInfo::evaluation_kernel for a symmetric element once the degree
+     * and the number of quadrature points have been fixed. For
+     * MatrixFreeFunctions::kernel_default, the kernel is selected in the same
+     * way as for compile-time template arguments in SelectEvaluator.
      */
-    template <int degree,
+    template <int dim,
+              int degree,
               int n_q_points_1d,
-              int dim,
               int n_components,
               typename Number>
-    struct Factory<dim,
-                   n_components,
-                   Number,
-                   1,
-                   degree,
-                   n_q_points_1d,
-                   typename std::enable_if<(n_q_points_1d < degree + 3)>::type>
+    struct KernelSelector
     {
       /**
        * We enable a transformation to collocation for derivatives if it gives
@@ -262,6 +272,22 @@ namespace internal
         n_q_points_1d > degree &&n_q_points_1d <= 3 * degree / 2 + 1 &&
         n_q_points_1d < 200;
 
+      static inline internal::MatrixFreeFunctions::EvaluationKernel
+      get_kernel(
+        const internal::MatrixFreeFunctions::ShapeInfo<Number> &shape_info)
+      {
+        if (shape_info.evaluation_kernel !=
+            internal::MatrixFreeFunctions::kernel_default)
+          return shape_info.evaluation_kernel;
+        else if (use_collocation)
+          return internal::MatrixFreeFunctions::
+            kernel_transform_to_collocation;
+        else if (degree + n_q_points_1d > 4)
+          return internal::MatrixFreeFunctions::kernel_evenodd;
+        else
+          return internal::MatrixFreeFunctions::kernel_symmetric;
+      }
+
       static inline void
       evaluate(
         const internal::MatrixFreeFunctions::ShapeInfo<Number> &shape_info,
@@ -274,24 +300,65 @@ namespace internal
         const bool evaluate_gradients,
         const bool evaluate_hessians)
       {
-        const int runtime_n_q_points_1d = shape_info.n_q_points_1d;
-        if (runtime_n_q_points_1d == n_q_points_1d)
+        switch (get_kernel(shape_info))
           {
-            if (n_q_points_1d == degree + 1 &&
-                shape_info.element_type ==
-                  internal::MatrixFreeFunctions::tensor_symmetric_collocation)
-              internal::
-                FEEvaluationImplCollocation<dim, degree, n_components, Number>::
-                  evaluate(shape_info,
-                           values_dofs_actual,
-                           values_quad,
-                           gradients_quad,
-                           hessians_quad,
-                           scratch_data,
-                           evaluate_values,
-                           evaluate_gradients,
-                           evaluate_hessians);
-            else if (use_collocation)
+            case internal::MatrixFreeFunctions::kernel_general:
+              internal::FEEvaluationImpl<
+                internal::MatrixFreeFunctions::tensor_symmetric,
+                dim,
+                degree,
+                n_q_points_1d,
+                n_components,
+                Number,
+                internal::evaluate_general>::evaluate(shape_info,
+                                                      values_dofs_actual,
+                                                      values_quad,
+                                                      gradients_quad,
+                                                      hessians_quad,
+                                                      scratch_data,
+                                                      evaluate_values,
+                                                      evaluate_gradients,
+                                                      evaluate_hessians);
+              break;
+            case internal::MatrixFreeFunctions::kernel_symmetric:
+              internal::FEEvaluationImpl<
+                internal::MatrixFreeFunctions::tensor_symmetric,
+                dim,
+                degree,
+                n_q_points_1d,
+                n_components,
+                Number,
+                internal::evaluate_symmetric>::evaluate(shape_info,
+                                                        values_dofs_actual,
+                                                        values_quad,
+                                                        gradients_quad,
+                                                        hessians_quad,
+                                                        scratch_data,
+                                                        evaluate_values,
+                                                        evaluate_gradients,
+                                                        evaluate_hessians);
+              break;
+            case internal::MatrixFreeFunctions::kernel_evenodd:
+              internal::FEEvaluationImpl<
+                internal::MatrixFreeFunctions::tensor_symmetric,
+                dim,
+                degree,
+                n_q_points_1d,
+                n_components,
+                Number,
+                internal::evaluate_evenodd>::evaluate(shape_info,
+                                                      values_dofs_actual,
+                                                      values_quad,
+                                                      gradients_quad,
+                                                      hessians_quad,
+                                                      scratch_data,
+                                                      evaluate_values,
+                                                      evaluate_gradients,
+                                                      evaluate_hessians);
+              break;
+            case internal::MatrixFreeFunctions::
+              kernel_transform_to_collocation:
+              Assert(n_q_points_1d > degree, ExcInternalError());
               internal::FEEvaluationImplTransformToCollocation<
                 dim,
                 degree,
@@ -306,22 +373,157 @@ namespace internal
                                   evaluate_values,
                                   evaluate_gradients,
                                   evaluate_hessians);
-            else
+              break;
+            default:
+              Assert(false, ExcInternalError());
+          }
+      }
+
+      static inline void
+      integrate(
+        const internal::MatrixFreeFunctions::ShapeInfo<Number> &shape_info,
+        Number *   values_dofs_actual,
+        Number *   values_quad,
+        Number *   gradients_quad,
+        Number *   scratch_data,
+        const bool integrate_values,
+        const bool integrate_gradients,
+        const bool sum_into_values_array)
+      {
+        switch (get_kernel(shape_info))
+          {
+            case internal::MatrixFreeFunctions::kernel_general:
               internal::FEEvaluationImpl<
                 internal::MatrixFreeFunctions::tensor_symmetric,
                 dim,
                 degree,
                 n_q_points_1d,
                 n_components,
-                Number>::evaluate(shape_info,
-                                  values_dofs_actual,
-                                  values_quad,
-                                  gradients_quad,
-                                  hessians_quad,
-                                  scratch_data,
-                                  evaluate_values,
-                                  evaluate_gradients,
-                                  evaluate_hessians);
+                Number,
+                internal::evaluate_general>::integrate(shape_info,
+                                                       values_dofs_actual,
+                                                       values_quad,
+                                                       gradients_quad,
+                                                       scratch_data,
+                                                       integrate_values,
+                                                       integrate_gradients,
+                                                       sum_into_values_array);
+              break;
+            case internal::MatrixFreeFunctions::kernel_symmetric:
+              internal::FEEvaluationImpl<
+                internal::MatrixFreeFunctions::tensor_symmetric,
+                dim,
+                degree,
+                n_q_points_1d,
+                n_components,
+                Number,
+                internal::evaluate_symmetric>::
+                integrate(shape_info,
+                          values_dofs_actual,
+                          values_quad,
+                          gradients_quad,
+                          scratch_data,
+                          integrate_values,
+                          integrate_gradients,
+                          sum_into_values_array);
+              break;
+            case internal::MatrixFreeFunctions::kernel_evenodd:
+              internal::FEEvaluationImpl<
+                internal::MatrixFreeFunctions::tensor_symmetric,
+                dim,
+                degree,
+                n_q_points_1d,
+                n_components,
+                Number,
+                internal::evaluate_evenodd>::integrate(shape_info,
+                                                       values_dofs_actual,
+                                                       values_quad,
+                                                       gradients_quad,
+                                                       scratch_data,
+                                                       integrate_values,
+                                                       integrate_gradients,
+                                                       sum_into_values_array);
+              break;
+            case internal::MatrixFreeFunctions::
+              kernel_transform_to_collocation:
+              Assert(n_q_points_1d > degree, ExcInternalError());
+              internal::FEEvaluationImplTransformToCollocation<
+                dim,
+                degree,
+                n_q_points_1d,
+                n_components,
+                Number>::integrate(shape_info,
+                                   values_dofs_actual,
+                                   values_quad,
+                                   gradients_quad,
+                                   scratch_data,
+                                   integrate_values,
+                                   integrate_gradients,
+                                   sum_into_values_array);
+              break;
+            default:
+              Assert(false, ExcInternalError());
+          }
+      }
+    };
+
+    /**
+     * This class chooses the correct template n_q_points_1d after degree was
+     * chosen.
+     */
+    template <int degree,
+              int n_q_points_1d,
+              int dim,
+              int n_components,
+              typename Number>
+    struct Factory<dim,
+                   n_components,
+                   Number,
+                   1,
+                   degree,
+                   n_q_points_1d,
+                   typename std::enable_if<(n_q_points_1d < degree + 3)>::type>
+    {
+      static inline void
+      evaluate(
+        const internal::MatrixFreeFunctions::ShapeInfo<Number> &shape_info,
+        Number *   values_dofs_actual,
+        Number *   values_quad,
+        Number *   gradients_quad,
+        Number *   hessians_quad,
+        Number *   scratch_data,
+        const bool evaluate_values,
+        const bool evaluate_gradients,
+        const bool evaluate_hessians)
+      {
+        const int runtime_n_q_points_1d = shape_info.n_q_points_1d;
+        if (runtime_n_q_points_1d == n_q_points_1d)
+          {
+            if (n_q_points_1d == degree + 1 &&
+                shape_info.element_type ==
+                  internal::MatrixFreeFunctions::tensor_symmetric_collocation)
+              internal::
+                FEEvaluationImplCollocation<dim, degree, n_components, Number>::
+                  evaluate(shape_info,
+                           values_dofs_actual,
+                           values_quad,
+                           gradients_quad,
+                           hessians_quad,
+                           scratch_data,
+                           evaluate_values,
+                           evaluate_gradients,
+                           evaluate_hessians);
+            else
+              KernelSelector<dim, degree, n_q_points_1d, n_components, Number>::
+                evaluate(shape_info,
+                         values_dofs_actual,
+                         values_quad,
+                         gradients_quad,
+                         hessians_quad,
+                         scratch_data,
+                         evaluate_values,
+                         evaluate_gradients,
+                         evaluate_hessians);
           }
         else
           Factory<dim, n_components, Number, 1, degree, n_q_points_1d + 1>::
@@ -363,35 +565,16 @@ namespace internal
                             integrate_values,
                             integrate_gradients,
                             sum_into_values_array);
-            else if (use_collocation)
-              internal::FEEvaluationImplTransformToCollocation<
-                dim,
-                degree,
-                n_q_points_1d,
-                n_components,
-                Number>::integrate(shape_info,
-                                   values_dofs_actual,
-                                   values_quad,
-                                   gradients_quad,
-                                   scratch_data,
-                                   integrate_values,
-                                   integrate_gradients,
-                                   sum_into_values_array);
             else
-              internal::FEEvaluationImpl<
-                internal::MatrixFreeFunctions::tensor_symmetric,
-                dim,
-                degree,
-                n_q_points_1d,
-                n_components,
-                Number>::integrate(shape_info,
-                                   values_dofs_actual,
-                                   values_quad,
-                                   gradients_quad,
-                                   scratch_data,
-                                   integrate_values,
-                                   integrate_gradients,
-                                   sum_into_values_array);
+              KernelSelector<dim, degree, n_q_points_1d, n_components, Number>::
+                integrate(shape_info,
+                          values_dofs_actual,
+                          values_quad,
+                          gradients_quad,
+                          scratch_data,
+                          integrate_values,
+                          integrate_gradients,
+                          sum_into_values_array);
           }
         else
           Factory<dim, n_components, Number, 1, degree, n_q_points_1d + 1>::
@@ -407,7 +590,6 @@ namespace internal
     };
 
 
-
     /**
      * This is the entry point for choosing the correct runtime parameters
      * for the 'evaluate' function.
@@ -482,8 +664,12 @@ namespace internal
  * pass these values to the respective template specializations.
  * Otherwise, we perform a runtime matching of the runtime parameters to find
  * the correct specialization. This matching currently supports
- * $0\leq fe\_degree \leq 9$ and $degree+1\leq n\_q\_points\_1d\leq
- * fe\_degree+2$.
+ * $0\leq fe\_degree \leq$ FE_EVAL_FACTORY_DEGREE_MAX (a value set at
+ * configure time, 9 by default) and $degree+1\leq n\_q\_points\_1d\leq
+ * fe\_degree+2$. Within this range, the kernel variant is selected by
+ * ShapeInfo::evaluation_kernel, see
+ * internal::measure_evaluation_kernels() and
+ * MatrixFree::AdditionalData::tune_evaluation_kernels.
  */
 template <int dim,
           int fe_degree,
@@ -545,7 +731,7 @@ struct SelectEvaluator
  * the selection is done based on the shape_info variable which contains
  * the relevant runtime parameters.
  * In case these parameters do not satisfy
- * $0\leq fe\_degree \leq 9$ and
+ * $0\leq fe\_degree \leq$ FE_EVAL_FACTORY_DEGREE_MAX and
  * $degree+1\leq n\_q\_points\_1d\leq fe\_degree+2$, a non-optimized fallback
  * is used.
  */
@@ -686,6 +872,25 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::evaluate(
                           evaluate_gradients,
                           evaluate_hessians);
     }
+  else if (shape_info.element_type ==
+           internal::MatrixFreeFunctions::tensor_symmetric_plus_bubbles)
+    {
+      internal::FEEvaluationImpl<
+        internal::MatrixFreeFunctions::tensor_symmetric_plus_bubbles,
+        dim,
+        fe_degree,
+        n_q_points_1d,
+        n_components,
+        Number>::evaluate(shape_info,
+                          values_dofs_actual,
+                          values_quad,
+                          gradients_quad,
+                          hessians_quad,
+                          scratch_data,
+                          evaluate_values,
+                          evaluate_gradients,
+                          evaluate_hessians);
+    }
   else if (shape_info.element_type ==
            internal::MatrixFreeFunctions::truncated_tensor)
     {
@@ -817,6 +1022,24 @@ SelectEvaluator<dim, fe_degree, n_q_points_1d, n_components, Number>::integrate(
                            integrate_gradients,
                            sum_into_values_array);
     }
+  else if (shape_info.element_type ==
+           internal::MatrixFreeFunctions::tensor_symmetric_plus_bubbles)
+    {
+      internal::FEEvaluationImpl<
+        internal::MatrixFreeFunctions::tensor_symmetric_plus_bubbles,
+        dim,
+        fe_degree,
+        n_q_points_1d,
+        n_components,
+        Number>::integrate(shape_info,
+                           values_dofs_actual,
+                           values_quad,
+                           gradients_quad,
+                           scratch_data,
+                           integrate_values,
+                           integrate_gradients,
+                           sum_into_values_array);
+    }
   else if (shape_info.element_type ==
            internal::MatrixFreeFunctions::truncated_tensor)
     {
@@ -890,6 +1113,25 @@ SelectEvaluator<dim, -1, dummy, n_components, Number>::evaluate(
                           evaluate_gradients,
                           evaluate_hessians);
     }
+  else if (shape_info.element_type ==
+           internal::MatrixFreeFunctions::tensor_symmetric_plus_bubbles)
+    {
+      internal::FEEvaluationImpl<
+        internal::MatrixFreeFunctions::tensor_symmetric_plus_bubbles,
+        dim,
+        -1,
+        0,
+        n_components,
+        Number>::evaluate(shape_info,
+                          values_dofs_actual,
+                          values_quad,
+                          gradients_quad,
+                          hessians_quad,
+                          scratch_data,
+                          evaluate_values,
+                          evaluate_gradients,
+                          evaluate_hessians);
+    }
   else if (shape_info.element_type ==
            internal::MatrixFreeFunctions::truncated_tensor)
     {
@@ -970,6 +1212,24 @@ SelectEvaluator<dim, -1, dummy, n_components, Number>::integrate(
                            integrate_gradients,
                            sum_into_values_array);
     }
+  else if (shape_info.element_type ==
+           internal::MatrixFreeFunctions::tensor_symmetric_plus_bubbles)
+    {
+      internal::FEEvaluationImpl<
+        internal::MatrixFreeFunctions::tensor_symmetric_plus_bubbles,
+        dim,
+        -1,
+        0,
+        n_components,
+        Number>::integrate(shape_info,
+                           values_dofs_actual,
+                           values_quad,
+                           gradients_quad,
+                           scratch_data,
+                           integrate_values,
+                           integrate_gradients,
+                           sum_into_values_array);
+    }
   else if (shape_info.element_type ==
            internal::MatrixFreeFunctions::truncated_tensor)
     {
@@ -1017,6 +1277,111 @@ SelectEvaluator<dim, -1, dummy, n_components, Number>::integrate(
 }
 #endif // DOXYGEN
 
+
+namespace internal
+{
+  /**
+   * Measures the run time of the cell evaluation and integration of values
+   * and gradients on the element described by @p shape_info with each of
+   * the kernels listed in MatrixFreeFunctions::EvaluationKernel, going
+   * through the run time dispatch of SelectEvaluator for `fe_degree=-1`.
+   * The returned array is indexed by the values of EvaluationKernel and
+   * contains the best time per evaluate/integrate pair in seconds out of a
+   * few repetitions. Kernels that can not be selected for the given element
+   * get a negative number. The entry for
+   * MatrixFreeFunctions::kernel_default is always measured.
+   */
+  template <int dim, typename Number>
+  std::array<double, 5>
+  measure_evaluation_kernels(
+    const MatrixFreeFunctions::ShapeInfo<Number> &shape_info)
+  {
+    std::array<double, 5> times;
+    std::fill(times.begin(), times.end(), -1.);
+
+    MatrixFreeFunctions::ShapeInfo<Number> shape = shape_info;
+
+    // only symmetric elements with degree and number of quadrature points
+    // covered by EvaluationSelectorImplementation::Factory can pick a kernel,
+    // except for the collocation case that never involves a sum
+    // factorization
+    const unsigned int degree       = shape.fe_degree;
+    const unsigned int n_q_points_1d = shape.n_q_points_1d;
+    const bool         can_select =
+      shape.element_type <= MatrixFreeFunctions::tensor_symmetric &&
+      degree <= FE_EVAL_FACTORY_DEGREE_MAX && n_q_points_1d > degree &&
+      n_q_points_1d < degree + 3 &&
+      !(n_q_points_1d == degree + 1 &&
+        shape.element_type ==
+          MatrixFreeFunctions::tensor_symmetric_collocation);
+
+    const unsigned int n_q_points = shape.n_q_points;
+    const unsigned int n_dofs     = shape.dofs_per_component_on_cell;
+    const unsigned int tensor_dofs_per_component =
+      Utilities::fixed_power<dim>(degree + 1);
+    AlignedVector<Number> dofs(n_dofs);
+    AlignedVector<Number> dofs_out(n_dofs);
+    AlignedVector<Number> values(n_q_points);
+    AlignedVector<Number> gradients(dim * n_q_points);
+    AlignedVector<Number> hessians(dim * (dim + 1) / 2 * n_q_points);
+    AlignedVector<Number> scratch(
+      3 * std::max(tensor_dofs_per_component + 1, n_dofs) + 2 * n_q_points);
+    for (unsigned int i = 0; i < n_dofs; ++i)
+      dofs[i] = 0.1 + 0.01 * i;
+
+    // the integration writes into a separate array, such that the data does
+    // not grow or decay over the repetitions
+    const unsigned int n_repetitions = std::max(10U, 20000U / n_q_points);
+    for (unsigned int k = 0; k < times.size(); ++k)
+      {
+        const auto kernel =
+          static_cast<MatrixFreeFunctions::EvaluationKernel>(k);
+        if (kernel != MatrixFreeFunctions::kernel_default &&
+            (can_select == false ||
+             (kernel == MatrixFreeFunctions::kernel_transform_to_collocation &&
+              shape.shape_gradients_collocation_eo.size() == 0)))
+          continue;
+
+        shape.evaluation_kernel = kernel;
+        double best_time        = std::numeric_limits<double>::max();
+        for (unsigned int trial = 0; trial < 3; ++trial)
+          {
+            const auto start = std::chrono::steady_clock::now();
+            for (unsigned int r = 0; r < n_repetitions; ++r)
+              {
+                SelectEvaluator<dim, -1, 0, 1, Number>::evaluate(
+                  shape,
+                  dofs.begin(),
+                  values.begin(),
+                  gradients.begin(),
+                  hessians.begin(),
+                  scratch.begin(),
+                  true,
+                  true,
+                  false);
+                SelectEvaluator<dim, -1, 0, 1, Number>::integrate(
+                  shape,
+                  dofs_out.begin(),
+                  values.begin(),
+                  gradients.begin(),
+                  scratch.begin(),
+                  true,
+                  true,
+                  false);
+              }
+            best_time =
+              std::min(best_time,
+                       std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count());
+          }
+        times[k] = best_time / n_repetitions;
+      }
+
+    return times;
+  }
+} // namespace internal
+
 DEAL_II_NAMESPACE_CLOSE
 
 #endif
@@ -1047,6 +1047,15 @@ protected:
    */
   unsigned int subface_index;
 
+  /**
+   * After a call to the cell-based reinit() of FEFaceEvaluation on the
+   * exterior side of a face, stores the index of the neighboring cell of each
+   * lane, in the numbering `cell_batch * n_array_elements + lane`. Lanes
+   * without a neighbor, i.e., at the boundary, are set to
+   * numbers::invalid_unsigned_int.
+   */
+  unsigned int exterior_cells[VectorizedArrayType::n_array_elements];
+
   /**
    * Stores the type of the cell we are currently working with after a call to
    * reinit(). Valid values are @p cartesian, @p affine and @p general, which
@@ -2425,6 +2434,12 @@ public:
    * cell is generated in the reinit call, this function is very cheap since
    * all data is pre-computed in @p matrix_free, and only a few indices have
    * to be set appropriately.
+   *
+   * The exception are deformed cells of a @p matrix_free object set up with
+   * MatrixFree::AdditionalData::compute_geometry_on_the_fly, for which this
+   * function computes the inverse Jacobians and JxW values of all quadrature
+   * points. This is done eagerly, i.e., also if the subsequent evaluate() and
+   * integrate() calls only involve values and never access the geometry.
    */
   void
   reinit(const unsigned int cell_batch_index);
@@ -2599,6 +2614,45 @@ private:
   void
   check_template_arguments(const unsigned int fe_no,
                            const unsigned int first_selected_component);
+
+  /**
+   * Converts the inverse Jacobians and JxW values of the current cell batch
+   * from the single-precision storage of the MatrixFree object (see
+   * MatrixFree::AdditionalData::store_geometry_in_single_precision) into
+   * the buffers below and lets the pointers to the geometry data point to
+   * them.
+   */
+  void
+  read_single_precision_geometry(const unsigned int offset);
+
+  /**
+   * Copies the geometry of the current cell batch of @p other, used by the
+   * copy constructor and the copy assignment operator. If the pointers to
+   * the geometry data of @p other point into its buffers below, the pointers
+   * of this object are set to the same positions in its own copies of the
+   * buffers. Otherwise, they point to the same data of the MatrixFree
+   * object as the ones of @p other.
+   */
+  void
+  copy_geometry_from(const FEEvaluation &other);
+
+  /**
+   * Buffer for the inverse Jacobians of the current cell batch in case the
+   * geometry is stored in single precision or computed on the fly.
+   */
+  AlignedVector<Tensor<2, dim, VectorizedArrayType>> jacobians_buffer;
+
+  /**
+   * Buffer for the JxW values of the current cell batch in case the
+   * geometry is stored in single precision or computed on the fly.
+   */
+  AlignedVector<VectorizedArrayType> JxW_values_buffer;
+
+  /**
+   * Temporary storage for computing the geometry on the fly, see
+   * MatrixFree::AdditionalData::compute_geometry_on_the_fly.
+   */
+  AlignedVector<VectorizedArrayType> geometry_scratch;
 };
 
 
@@ -2775,6 +2829,22 @@ public:
     const unsigned int                                  quad_no          = 0,
     const unsigned int first_selected_component                          = 0);
 
+  /**
+   * Copy constructor. The new object is initialized on the same face as
+   * @p other. If @p other has been initialized on the exterior side of a
+   * face with the cell-based reinit() method, the geometry data collected
+   * from the neighboring cells is copied and the new object refers to its
+   * own copy, so it remains valid when @p other is destroyed.
+   */
+  FEFaceEvaluation(const FEFaceEvaluation &other);
+
+  /**
+   * Copy assignment operator, with the same semantics as the copy
+   * constructor.
+   */
+  FEFaceEvaluation &
+  operator=(const FEFaceEvaluation &other);
+
   /**
    * Initializes the operation pointer to the current face. This method is the
    * default choice for face integration as the data stored in MappingInfo is
@@ -2794,6 +2864,19 @@ public:
    * method is less efficient than the other reinit() method taking a
    * numbering of the faces because it needs to copy the data associated with
    * the faces to the cells in this call.
+   *
+   * If the object has been constructed with `is_interior_face == false`, the
+   * object accesses the neighbors of the cells in the batch across the given
+   * face, i.e., the degrees of freedom are read from and written to the
+   * neighbors lane by lane and the inverse Jacobians are collected from the
+   * neighbors' data, whereas the normal vectors and integration weights are
+   * the ones of the cells in the batch. This is the building block for the
+   * loops of MatrixFree::loop_cell_centric(). On boundary faces, the
+   * respective lanes are set to zero. This variant requires the face
+   * connectivity set up with
+   * MatrixFree::AdditionalData::hold_all_faces_to_owned_cells, and it is
+   * currently restricted to faces without hanging nodes in standard
+   * orientation where all lanes see the same face number on the neighbors.
    */
   void
   reinit(const unsigned int cell_batch_number, const unsigned int face_number);
@@ -2929,6 +3012,35 @@ protected:
   adjust_for_face_orientation(const bool integrate,
                               const bool values,
                               const bool gradients);
+
+  /**
+   * Part of the cell-based reinit() method on the exterior side: finds the
+   * neighbors of the cells in the batch across the given face and collects
+   * their geometry data into `exterior_mapping_data`.
+   */
+  void
+  reinit_exterior_cells(const unsigned int cell_batch_number,
+                        const unsigned int face_number);
+
+  /**
+   * Copies the face and geometry state of @p other, used by the copy
+   * constructor and the copy assignment operator after the base class and
+   * `exterior_mapping_data` have been copied. Pointers of @p other into its
+   * `exterior_mapping_data` are set to the same data in the copy held by
+   * this object, all other pointers refer to the data of the MatrixFree
+   * object and are taken over.
+   */
+  void
+  copy_geometry_from(const FEFaceEvaluation &other);
+
+  /**
+   * Storage for the geometry data of the exterior side of a face in the
+   * cell-based reinit() method, collected from the neighboring cells lane by
+   * lane.
+   */
+  internal::MatrixFreeFunctions::
+    MappingInfoStorage<dim - 1, dim, Number, VectorizedArrayType>
+      exterior_mapping_data;
 };
 
 
@@ -2953,6 +3065,30 @@ namespace internal
     {
       static constexpr unsigned int value = degree + 1;
     };
+
+
+    // a helper function to let the mapping data pointer of FEEvaluationBase
+    // refer to the data computed on the fly, which is only available on
+    // cells and never set up for FEFaceEvaluation
+    template <int dim, typename Number, typename VectorizedArrayType>
+    inline void
+    set_mapping_data_on_the_fly(
+      const MappingInfoStorage<dim, dim, Number, VectorizedArrayType>
+        *&mapping_data,
+      const MappingDataOnTheFly<dim, Number, VectorizedArrayType>
+        &mapped_geometry)
+    {
+      mapping_data = &mapped_geometry.get_data_storage();
+    }
+
+    template <int dim, typename Number, typename VectorizedArrayType>
+    inline void
+    set_mapping_data_on_the_fly(
+      const MappingInfoStorage<dim - 1, dim, Number, VectorizedArrayType> *&,
+      const MappingDataOnTheFly<dim, Number, VectorizedArrayType> &)
+    {
+      Assert(false, ExcNotImplemented());
+    }
   } // namespace MatrixFreeFunctions
 } // namespace internal
 
@@ -3129,9 +3265,9 @@ inline FEEvaluationBase<dim,
   , normal_x_jacobian(nullptr)
   , quadrature_weights(nullptr)
   , cell(0)
-  , cell_type(internal::MatrixFreeFunctions::general)
   , is_interior_face(true)
   , dof_access_index(internal::MatrixFreeFunctions::DoFInfo::dof_access_cell)
+  , cell_type(internal::MatrixFreeFunctions::general)
   , dof_values_initialized(false)
   , values_quad_initialized(false)
   , gradients_quad_initialized(false)
@@ -3213,9 +3349,9 @@ inline FEEvaluationBase<dim,
         nullptr :
         mapping_data->descriptor[active_quad_index].quadrature_weights.begin())
   , cell(numbers::invalid_unsigned_int)
-  , cell_type(internal::MatrixFreeFunctions::general)
   , is_interior_face(other.is_interior_face)
   , dof_access_index(other.dof_access_index)
+  , cell_type(internal::MatrixFreeFunctions::general)
   , dof_values_initialized(false)
   , values_quad_initialized(false)
   , gradients_quad_initialized(false)
@@ -3235,8 +3371,9 @@ inline FEEvaluationBase<dim,
             other.mapped_geometry->get_fe_values().get_mapping(),
             other.mapped_geometry->get_quadrature(),
             other.mapped_geometry->get_fe_values().get_update_flags()));
-      mapping_data = &mapped_geometry->get_data_storage();
-      cell         = 0;
+      internal::MatrixFreeFunctions::set_mapping_data_on_the_fly(
+        mapping_data, *mapped_geometry);
+      cell = 0;
 
       jacobian = mapped_geometry->get_data_storage().jacobians[0].begin();
       J_value  = mapped_geometry->get_data_storage().JxW_values.begin();
@@ -3313,10 +3450,11 @@ operator=(const FEEvaluationBase<dim,
             other.mapped_geometry->get_fe_values().get_mapping(),
             other.mapped_geometry->get_quadrature(),
             other.mapped_geometry->get_fe_values().get_update_flags()));
-      cell         = 0;
-      mapping_data = &mapped_geometry->get_data_storage();
-      jacobian     = mapped_geometry->get_data_storage().jacobians[0].begin();
-      J_value      = mapped_geometry->get_data_storage().JxW_values.begin();
+      cell = 0;
+      internal::MatrixFreeFunctions::set_mapping_data_on_the_fly(
+        mapping_data, *mapped_geometry);
+      jacobian = mapped_geometry->get_data_storage().jacobians[0].begin();
+      J_value  = mapped_geometry->get_data_storage().JxW_values.begin();
     }
 
   return *this;
@@ -4348,14 +4486,23 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
     }
 
   // Case 2: contiguous indices which use reduced storage of indices and can
-  // use vectorized load/store operations -> go to separate function
+  // use vectorized load/store operations -> go to separate function. The
+  // exterior side of a face accessed through the cell-based reinit() of
+  // FEFaceEvaluation reads from the neighbors of the cells in the batch,
+  // which are not collected in a batch of their own, so it always takes the
+  // path with indices per lane
   AssertIndexRange(cell,
                    dof_info->index_storage_variants[dof_access_index].size());
-  if (dof_info->index_storage_variants
-        [is_face ? dof_access_index :
-                   internal::MatrixFreeFunctions::DoFInfo::dof_access_cell]
-        [cell] >=
-      internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants::contiguous)
+  const bool access_neighbor_cells =
+    is_face && !is_interior_face &&
+    dof_access_index == internal::MatrixFreeFunctions::DoFInfo::dof_access_cell;
+  if (!access_neighbor_cells &&
+      dof_info->index_storage_variants
+          [is_face ? dof_access_index :
+                     internal::MatrixFreeFunctions::DoFInfo::dof_access_cell]
+          [cell] >=
+        internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants::
+          contiguous)
     {
       read_write_operation_contiguous(operation, src, mask);
       return;
@@ -4375,11 +4522,13 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
 
   const unsigned int dofs_per_component =
     this->data->dofs_per_component_on_cell;
-  if (dof_info->index_storage_variants
-        [is_face ? dof_access_index :
-                   internal::MatrixFreeFunctions::DoFInfo::dof_access_cell]
-        [cell] ==
-      internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants::interleaved)
+  if (!access_neighbor_cells &&
+      dof_info->index_storage_variants
+          [is_face ? dof_access_index :
+                     internal::MatrixFreeFunctions::DoFInfo::dof_access_cell]
+          [cell] ==
+        internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants::
+          interleaved)
     {
       const unsigned int *dof_indices =
         dof_info->dof_indices_interleaved.data() +
@@ -4414,12 +4563,16 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
   unsigned int        n_vectorization_actual =
     dof_info->n_vectorization_lanes_filled[dof_access_index][cell];
   bool has_constraints = false;
+  bool has_empty_lanes = n_vectorization_actual < n_vectorization;
   if (is_face)
     {
       if (dof_access_index ==
           internal::MatrixFreeFunctions::DoFInfo::dof_access_cell)
         for (unsigned int v = 0; v < n_vectorization_actual; ++v)
-          cells_copied[v] = cell * VectorizedArrayType::n_array_elements + v;
+          cells_copied[v] =
+            access_neighbor_cells ?
+              exterior_cells[v] :
+              cell * VectorizedArrayType::n_array_elements + v;
       cells = dof_access_index ==
                   internal::MatrixFreeFunctions::DoFInfo::dof_access_cell ?
                 &cells_copied[0] :
@@ -4428,6 +4581,13 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
                    &this->matrix_info->get_face_info(cell).cells_exterior[0]);
       for (unsigned int v = 0; v < n_vectorization_actual; ++v)
         {
+          // boundary faces have no neighbor to read from
+          if (cells[v] == numbers::invalid_unsigned_int)
+            {
+              dof_indices[v]  = nullptr;
+              has_empty_lanes = true;
+              continue;
+            }
           Assert(cells[v] < dof_info->row_starts.size() - 1,
                  ExcInternalError());
           has_constraints =
@@ -4500,28 +4660,30 @@ FEEvaluationBase<dim, n_components_, Number, is_face, VectorizedArrayType>::
   // through the list of DoFs directly
   if (!has_constraints)
     {
-      if (n_vectorization_actual < n_vectorization)
+      if (has_empty_lanes)
         for (unsigned int comp = 0; comp < n_components; ++comp)
           for (unsigned int i = 0; i < dofs_per_component; ++i)
             operation.process_empty(values_dofs[comp][i]);
       if (n_components == 1 || n_fe_components == 1)
         {
           for (unsigned int v = 0; v < n_vectorization_actual; ++v)
-            for (unsigned int i = 0; i < dofs_per_component; ++i)
-              for (unsigned int comp = 0; comp < n_components; ++comp)
-                operation.process_dof(dof_indices[v][i],
-                                      *src[comp],
-                                      values_dofs[comp][i][v]);
+            if (dof_indices[v] != nullptr)
+              for (unsigned int i = 0; i < dofs_per_component; ++i)
+                for (unsigned int comp = 0; comp < n_components; ++comp)
+                  operation.process_dof(dof_indices[v][i],
+                                        *src[comp],
+                                        values_dofs[comp][i][v]);
         }
       else
         {
           for (unsigned int comp = 0; comp < n_components; ++comp)
             for (unsigned int v = 0; v < n_vectorization_actual; ++v)
-              for (unsigned int i = 0; i < dofs_per_component; ++i)
-                operation.process_dof(
-                  dof_indices[v][comp * dofs_per_component + i],
-                  *src[0],
-                  values_dofs[comp][i][v]);
+              if (dof_indices[v] != nullptr)
+                for (unsigned int i = 0; i < dofs_per_component; ++i)
+                  operation.process_dof(
+                    dof_indices[v][comp * dofs_per_component + i],
+                    *src[0],
+                    values_dofs[comp][i][v]);
         }
       return;
     }
@@ -7151,6 +7313,7 @@ inline FEEvaluation<dim,
   , n_q_points(this->data->n_q_points)
 {
   check_template_arguments(numbers::invalid_unsigned_int, 0);
+  copy_geometry_from(other);
 }
 
 
@@ -7176,11 +7339,54 @@ FEEvaluation<dim,
 {
   BaseClass::operator=(other);
   check_template_arguments(numbers::invalid_unsigned_int, 0);
+  copy_geometry_from(other);
   return *this;
 }
 
 
 
+template <int dim,
+          int fe_degree,
+          int n_q_points_1d,
+          int n_components_,
+          typename Number,
+          typename VectorizedArrayType>
+inline void
+FEEvaluation<dim,
+             fe_degree,
+             n_q_points_1d,
+             n_components_,
+             Number,
+             VectorizedArrayType>::copy_geometry_from(const FEEvaluation &other)
+{
+  // the geometry evaluated with FEValues has been deep-copied by the base
+  // class
+  if (other.matrix_info == nullptr)
+    return;
+
+  jacobians_buffer  = other.jacobians_buffer;
+  JxW_values_buffer = other.JxW_values_buffer;
+
+  this->cell      = other.cell;
+  this->cell_type = other.cell_type;
+  if (other.jacobian != nullptr &&
+      other.jacobian >= other.jacobians_buffer.begin() &&
+      other.jacobian < other.jacobians_buffer.end())
+    this->jacobian = jacobians_buffer.begin() +
+                     (other.jacobian - other.jacobians_buffer.begin());
+  else
+    this->jacobian = other.jacobian;
+  if (other.J_value != nullptr &&
+      other.J_value >= other.JxW_values_buffer.begin() &&
+      other.J_value < other.JxW_values_buffer.end())
+    this->J_value = JxW_values_buffer.begin() +
+                    (other.J_value - other.JxW_values_buffer.begin());
+  else
+    this->J_value = other.J_value;
+}
+
+
+
 template <int dim,
           int fe_degree,
           int n_q_points_1d,
@@ -7371,8 +7577,26 @@ FEEvaluation<dim,
 
   const unsigned int offsets =
     this->mapping_data->data_index_offsets[cell_index];
-  this->jacobian = &this->mapping_data->jacobians[0][offsets];
-  this->J_value  = &this->mapping_data->JxW_values[offsets];
+  if (this->cell_type == internal::MatrixFreeFunctions::general &&
+      !this->matrix_info->get_mapping_info().mapping_support_points.empty())
+    {
+      this->matrix_info->get_mapping_info().compute_cell_geometry_on_the_fly(
+        offsets,
+        this->quad_no,
+        this->active_quad_index,
+        geometry_scratch,
+        jacobians_buffer,
+        JxW_values_buffer);
+      this->jacobian = jacobians_buffer.begin();
+      this->J_value  = JxW_values_buffer.begin();
+    }
+  else if (this->mapping_data->single_precision_geometry.empty())
+    {
+      this->jacobian = &this->mapping_data->jacobians[0][offsets];
+      this->J_value  = &this->mapping_data->JxW_values[offsets];
+    }
+  else
+    read_single_precision_geometry(offsets);
 
 #  ifdef DEBUG
   this->dof_values_initialized     = false;
@@ -7384,6 +7608,54 @@ FEEvaluation<dim,
 
 
 
+template <int dim,
+          int fe_degree,
+          int n_q_points_1d,
+          int n_components_,
+          typename Number,
+          typename VectorizedArrayType>
+inline void
+FEEvaluation<dim,
+             fe_degree,
+             n_q_points_1d,
+             n_components_,
+             Number,
+             VectorizedArrayType>::
+  read_single_precision_geometry(const unsigned int offset)
+{
+  constexpr unsigned int n_lanes  = VectorizedArrayType::n_array_elements;
+  constexpr unsigned int n_fields = dim * dim + 1;
+
+  // only cells with a general geometry store data on all quadrature points
+  const unsigned int n_entries =
+    this->cell_type == internal::MatrixFreeFunctions::general ? n_q_points : 1;
+  if (JxW_values_buffer.size() < n_entries)
+    {
+      jacobians_buffer.resize_fast(n_q_points);
+      JxW_values_buffer.resize_fast(n_q_points);
+    }
+
+  AssertIndexRange((offset + n_entries) * n_fields * n_lanes,
+                   this->mapping_data->single_precision_geometry.size() + 1);
+  const float *data =
+    this->mapping_data->single_precision_geometry.begin() +
+    static_cast<std::size_t>(offset) * n_fields * n_lanes;
+  for (unsigned int q = 0; q < n_entries; ++q, data += n_fields * n_lanes)
+    {
+      for (unsigned int d = 0; d < dim; ++d)
+        for (unsigned int e = 0; e < dim; ++e)
+          for (unsigned int v = 0; v < n_lanes; ++v)
+            jacobians_buffer[q][d][e][v] = data[(d * dim + e) * n_lanes + v];
+      for (unsigned int v = 0; v < n_lanes; ++v)
+        JxW_values_buffer[q][v] = data[dim * dim * n_lanes + v];
+    }
+
+  this->jacobian = jacobians_buffer.begin();
+  this->J_value  = JxW_values_buffer.begin();
+}
+
+
+
 template <int dim,
           int fe_degree,
           int n_q_points_1d,
@@ -7819,7 +8091,112 @@ inline FEFaceEvaluation<dim,
   , dofs_per_component(this->data->dofs_per_component_on_cell)
   , dofs_per_cell(this->data->dofs_per_component_on_cell * n_components_)
   , n_q_points(this->data->n_q_points_face)
-{}
+{
+  // the face kernels work on the full tensor product of the 1D basis and do
+  // not cover the bubble functions of FE_Q_Bubbles or the truncated basis of
+  // FE_DGP and FE_DGPMonomial
+  Assert(this->data->element_type !=
+             internal::MatrixFreeFunctions::tensor_symmetric_plus_bubbles &&
+           this->data->element_type !=
+             internal::MatrixFreeFunctions::truncated_tensor,
+         ExcNotImplemented());
+}
+
+
+
+template <int dim,
+          int fe_degree,
+          int n_q_points_1d,
+          int n_components_,
+          typename Number,
+          typename VectorizedArrayType>
+inline FEFaceEvaluation<dim,
+                        fe_degree,
+                        n_q_points_1d,
+                        n_components_,
+                        Number,
+                        VectorizedArrayType>::
+  FEFaceEvaluation(const FEFaceEvaluation &other)
+  : BaseClass(other)
+  , dofs_per_component(other.dofs_per_component)
+  , dofs_per_cell(other.dofs_per_cell)
+  , n_q_points(other.n_q_points)
+  , exterior_mapping_data(other.exterior_mapping_data)
+{
+  copy_geometry_from(other);
+}
+
+
+
+template <int dim,
+          int fe_degree,
+          int n_q_points_1d,
+          int n_components_,
+          typename Number,
+          typename VectorizedArrayType>
+inline FEFaceEvaluation<dim,
+                        fe_degree,
+                        n_q_points_1d,
+                        n_components_,
+                        Number,
+                        VectorizedArrayType> &
+FEFaceEvaluation<dim,
+                 fe_degree,
+                 n_q_points_1d,
+                 n_components_,
+                 Number,
+                 VectorizedArrayType>::operator=(const FEFaceEvaluation &other)
+{
+  BaseClass::operator=(other);
+  exterior_mapping_data = other.exterior_mapping_data;
+  copy_geometry_from(other);
+  return *this;
+}
+
+
+
+template <int dim,
+          int fe_degree,
+          int n_q_points_1d,
+          int n_components_,
+          typename Number,
+          typename VectorizedArrayType>
+inline void
+FEFaceEvaluation<dim,
+                 fe_degree,
+                 n_q_points_1d,
+                 n_components_,
+                 Number,
+                 VectorizedArrayType>::
+  copy_geometry_from(const FEFaceEvaluation &other)
+{
+  this->cell             = other.cell;
+  this->cell_type        = other.cell_type;
+  this->face_no          = other.face_no;
+  this->face_orientation = other.face_orientation;
+  this->subface_index    = other.subface_index;
+  for (unsigned int v = 0; v < VectorizedArrayType::n_array_elements; ++v)
+    this->exterior_cells[v] = other.exterior_cells[v];
+
+  // reinit_exterior_cells() lets all geometry pointers refer to the
+  // beginning of the arrays in exterior_mapping_data
+  if (other.J_value != nullptr &&
+      other.J_value == other.exterior_mapping_data.JxW_values.begin())
+    {
+      this->J_value        = exterior_mapping_data.JxW_values.begin();
+      this->jacobian       = exterior_mapping_data.jacobians[0].begin();
+      this->normal_vectors = exterior_mapping_data.normal_vectors.begin();
+      this->normal_x_jacobian =
+        exterior_mapping_data.normals_times_jacobians[0].begin();
+    }
+  else
+    {
+      this->J_value           = other.J_value;
+      this->jacobian          = other.jacobian;
+      this->normal_vectors    = other.normal_vectors;
+      this->normal_x_jacobian = other.normal_x_jacobian;
+    }
+}
 
 
 
@@ -7927,10 +8304,6 @@ FEFaceEvaluation<dim,
   Assert(this->mapped_geometry == nullptr,
          ExcMessage("FEEvaluation was initialized without a matrix-free object."
                     " Integer indexing is not possible"));
-  Assert(this->is_interior_face == true,
-         ExcMessage(
-           "Cell-based FEFaceEvaluation::reinit only possible for the "
-           "interior face with second argument to constructor as true"));
   if (this->mapped_geometry != nullptr)
     return;
   Assert(this->matrix_info != nullptr, ExcNotInitialized());
@@ -7965,6 +8338,9 @@ FEFaceEvaluation<dim,
                                .face_data_by_cells[this->quad_no]
                                .normals_times_jacobians[0][offsets];
 
+  if (this->is_interior_face == false)
+    reinit_exterior_cells(cell_index, face_number);
+
 #  ifdef DEBUG
   this->dof_values_initialized     = false;
   this->values_quad_initialized    = false;
@@ -7975,6 +8351,142 @@ FEFaceEvaluation<dim,
 
 
 
+template <int dim,
+          int fe_degree,
+          int n_q_points_1d,
+          int n_components_,
+          typename Number,
+          typename VectorizedArrayType>
+inline void
+FEFaceEvaluation<dim,
+                 fe_degree,
+                 n_q_points_1d,
+                 n_components_,
+                 Number,
+                 VectorizedArrayType>::
+  reinit_exterior_cells(const unsigned int cell_index,
+                        const unsigned int face_number)
+{
+  constexpr unsigned int n_lanes = VectorizedArrayType::n_array_elements;
+  const internal::MatrixFreeFunctions::MappingInfo<dim,
+                                                   Number,
+                                                   VectorizedArrayType>
+    &mapping_info = this->matrix_info->get_mapping_info();
+  const internal::MatrixFreeFunctions::
+    MappingInfoStorage<dim - 1, dim, Number, VectorizedArrayType> &data =
+      mapping_info.face_data_by_cells[this->quad_no];
+
+  // find the neighbor of each lane through the face batches that contain the
+  // face
+  const std::array<unsigned int, n_lanes> face_indices =
+    this->matrix_info->get_faces_by_cells_face_index(cell_index, face_number);
+  const unsigned int n_filled_lanes =
+    this->matrix_info->n_active_entries_per_cell_batch(cell_index);
+  unsigned int exterior_face_no = numbers::invalid_unsigned_int;
+  for (unsigned int v = 0; v < n_lanes; ++v)
+    {
+      this->exterior_cells[v] = numbers::invalid_unsigned_int;
+      if (v >= n_filled_lanes)
+        continue;
+
+      Assert(face_indices[v] != numbers::invalid_unsigned_int,
+             ExcMessage("The face is not stored on the present processor. "
+                        "You must set MatrixFree::AdditionalData::"
+                        "hold_all_faces_to_owned_cells to access the "
+                        "neighbors across all faces of the locally owned "
+                        "cells."));
+      const internal::MatrixFreeFunctions::FaceToCellTopology<n_lanes> &face =
+        this->matrix_info->get_face_info(face_indices[v] / n_lanes);
+      const unsigned int lane = face_indices[v] % n_lanes;
+      if (face.cells_exterior[lane] == numbers::invalid_unsigned_int)
+        continue;
+
+      Assert(face.subface_index >= GeometryInfo<dim>::max_children_per_cell,
+             ExcNotImplemented("Faces with hanging nodes are not supported"));
+      Assert(face.face_orientation % 8 == 0,
+             ExcNotImplemented("Faces in non-standard orientation are not "
+                               "supported"));
+      const bool cell_is_interior =
+        face.cells_interior[lane] == cell_index * n_lanes + v;
+      this->exterior_cells[v] = cell_is_interior ? face.cells_exterior[lane] :
+                                                   face.cells_interior[lane];
+      const unsigned int neighbor_face_no =
+        cell_is_interior ? face.exterior_face_no : face.interior_face_no;
+      Assert(exterior_face_no == numbers::invalid_unsigned_int ||
+               exterior_face_no == neighbor_face_no,
+             ExcNotImplemented("All lanes must see the same face number on "
+                               "the neighboring cells"));
+      exterior_face_no = neighbor_face_no;
+    }
+  this->face_no = exterior_face_no != numbers::invalid_unsigned_int ?
+                    exterior_face_no :
+                    GeometryInfo<dim>::opposite_face[face_number];
+
+  // The integration weights and normal vectors are the ones of the cells in
+  // the batch, whereas the inverse Jacobians come from the neighbors, whose
+  // geometry type can differ from lane to lane. Store everything in the
+  // general format with data at each quadrature point.
+  const unsigned int n_q = this->n_quadrature_points;
+  const bool has_normals = data.normal_vectors.size() > 0;
+  exterior_mapping_data.JxW_values.resize_fast(n_q);
+  exterior_mapping_data.jacobians[0].resize_fast(n_q);
+  if (has_normals)
+    {
+      exterior_mapping_data.normal_vectors.resize_fast(n_q);
+      exterior_mapping_data.normals_times_jacobians[0].resize_fast(n_q);
+    }
+  const bool is_affine =
+    this->cell_type <= internal::MatrixFreeFunctions::affine;
+  for (unsigned int q = 0; q < n_q; ++q)
+    {
+      exterior_mapping_data.JxW_values[q] =
+        is_affine ? this->J_value[0] * this->quadrature_weights[q] :
+                    this->J_value[q];
+      if (has_normals)
+        exterior_mapping_data.normal_vectors[q] =
+          this->normal_vectors[is_affine ? 0 : q];
+      exterior_mapping_data.jacobians[0][q] =
+        Tensor<2, dim, VectorizedArrayType>();
+    }
+  for (unsigned int v = 0; v < n_lanes; ++v)
+    if (this->exterior_cells[v] != numbers::invalid_unsigned_int)
+      {
+        const unsigned int neighbor_batch = this->exterior_cells[v] / n_lanes;
+        const unsigned int neighbor_lane  = this->exterior_cells[v] % n_lanes;
+        AssertIndexRange(neighbor_batch, mapping_info.cell_type.size());
+        const unsigned int offsets =
+          data.data_index_offsets[neighbor_batch *
+                                    GeometryInfo<dim>::faces_per_cell +
+                                  this->face_no];
+        const bool neighbor_is_affine =
+          mapping_info.cell_type[neighbor_batch] <=
+          internal::MatrixFreeFunctions::affine;
+        for (unsigned int q = 0; q < n_q; ++q)
+          {
+            const Tensor<2, dim, VectorizedArrayType> &jac =
+              data.jacobians[0][offsets + (neighbor_is_affine ? 0 : q)];
+            for (unsigned int d = 0; d < dim; ++d)
+              for (unsigned int e = 0; e < dim; ++e)
+                exterior_mapping_data.jacobians[0][q][d][e][v] =
+                  jac[d][e][neighbor_lane];
+          }
+      }
+  if (has_normals)
+    for (unsigned int q = 0; q < n_q; ++q)
+      exterior_mapping_data.normals_times_jacobians[0][q] =
+        exterior_mapping_data.normal_vectors[q] *
+        exterior_mapping_data.jacobians[0][q];
+
+  this->cell_type         = internal::MatrixFreeFunctions::general;
+  this->J_value           = exterior_mapping_data.JxW_values.begin();
+  this->jacobian          = exterior_mapping_data.jacobians[0].begin();
+  this->normal_vectors    = exterior_mapping_data.normal_vectors.begin();
+  this->normal_x_jacobian =
+    exterior_mapping_data.normals_times_jacobians[0].begin();
+}
+
+
+
 template <int dim,
           int fe_degree,
           int n_q_points_1d,
@@ -8235,6 +8747,17 @@ FEFaceEvaluation<
                                         const bool        evaluate_values,
                                         const bool        evaluate_gradients)
 {
+  // the neighbors on the exterior side of a cell-based face access are not
+  // grouped into batches, so the vectorized access paths below do not apply
+  if (this->is_interior_face == false &&
+      this->dof_access_index ==
+        internal::MatrixFreeFunctions::DoFInfo::dof_access_cell)
+    {
+      this->read_dof_values(input_vector);
+      evaluate(evaluate_values, evaluate_gradients);
+      return;
+    }
+
   const unsigned int side = this->face_no % 2;
 
   constexpr unsigned int static_dofs_per_face =
@@ -8759,6 +9282,15 @@ FEFaceEvaluation<
                                           const bool  integrate_gradients,
                                           VectorType &destination)
 {
+  if (this->is_interior_face == false &&
+      this->dof_access_index ==
+        internal::MatrixFreeFunctions::DoFInfo::dof_access_cell)
+    {
+      integrate(integrate_values, integrate_gradients);
+      this->distribute_local_to_global(destination);
+      return;
+    }
+
   const unsigned int side = this->face_no % 2;
   const unsigned int dofs_per_face =
     fe_degree > -1 ? Utilities::pow(fe_degree + 1, dim - 1) :
@@ -9343,6 +9875,9 @@ FEFaceEvaluation<dim,
                  .face_data_by_cells[this->quad_no]
                  .quadrature_point_offsets.empty() == false,
              ExcNotImplemented());
+      Assert(this->is_interior_face,
+             ExcNotImplemented("Use the interior side to query the quadrature "
+                               "points in the cell-based face access"));
       const unsigned int index =
         this->cell * GeometryInfo<dim>::faces_per_cell + this->face_no;
       AssertIndexRange(index,
@@ -29,6 +29,7 @@
 
 #include <deal.II/matrix_free/face_info.h>
 #include <deal.II/matrix_free/helper_functions.h>
+#include <deal.II/matrix_free/tensor_product_kernels.h>
 
 #include <memory>
 
@@ -183,7 +184,9 @@ namespace internal
        * Stores the index offset into the arrays @p jxw_values, @p jacobians,
        * @p normal_vectors and the second derivatives. Note that affine cells
        * have shorter fields of length 1, where the others have lengths equal
-       * to the number of quadrature points of the given cell.
+       * to the number of quadrature points of the given cell. If the geometry
+       * of the cells of general type is computed on the fly, the entries of
+       * those cells instead index into MappingInfo::mapping_support_points.
        */
       AlignedVector<unsigned int> data_index_offsets;
 
@@ -196,6 +199,19 @@ namespace internal
        */
       AlignedVector<VectorizedArrayType> JxW_values;
 
+      /**
+       * The inverse Jacobians (as stored in @p jacobians[0]) and the JxW
+       * values (as stored in @p JxW_values) in single precision, filled
+       * only for the cells and only if the geometry is to be stored in
+       * single precision, in which case the two other fields are empty. For
+       * each entry, the dim*dim components of the inverse Jacobian are
+       * stored followed by the JxW value, each for all lanes of the
+       * vectorized array.
+       *
+       * Indexed by @p data_index_offsets in units of entries.
+       */
+      AlignedVector<float> single_precision_geometry;
+
       /**
        * Stores the normal vectors.
        *
@@ -320,7 +336,9 @@ namespace internal
         const UpdateFlags                              update_flags_cells,
         const UpdateFlags update_flags_boundary_faces,
         const UpdateFlags update_flags_inner_faces,
-        const UpdateFlags update_flags_faces_by_cells);
+        const UpdateFlags update_flags_faces_by_cells,
+        const bool        store_geometry_in_single_precision = false,
+        const bool        compute_geometry_on_the_fly        = false);
 
       /**
        * Return the type of a given cell as detected during initialization.
@@ -425,6 +443,75 @@ namespace internal
         const std::vector<dealii::hp::QCollection<1>> &           quad,
         const UpdateFlags update_flags_faces_by_cells);
 
+      /**
+       * Converts the inverse Jacobians and JxW values of the cells to single
+       * precision and releases the data in the precision of @p Number,
+       * called within initialize.
+       */
+      void
+      store_cell_geometry_in_single_precision();
+
+      /**
+       * Replaces the inverse Jacobians and JxW values on the cells of general
+       * type by the support points of the mapping, from which the geometry
+       * is computed on the fly by compute_cell_geometry_on_the_fly(), called
+       * within initialize.
+       */
+      void
+      initialize_cell_geometry_on_the_fly(
+        const dealii::Triangulation<dim> &                        tria,
+        const std::vector<std::pair<unsigned int, unsigned int>> &cells,
+        const Mapping<dim> &                                      mapping,
+        const std::vector<dealii::hp::QCollection<1>> &           quad);
+
+      /**
+       * Computes the inverse Jacobians (transposed, as stored in
+       * MappingInfoStorage::jacobians) and the JxW values on all quadrature
+       * points of a cell batch of general type from the support points of
+       * the mapping, using sum factorization. The cell batch is identified
+       * by its entry in MappingInfoStorage::data_index_offsets. The array
+       * @p scratch is used for intermediate results. This function is called
+       * from FEEvaluation::reinit() for every cell batch of general type,
+       * independently of which quantities are later evaluated.
+       */
+      void
+      compute_cell_geometry_on_the_fly(
+        const unsigned int                                  offset,
+        const unsigned int                                  quad_no,
+        const unsigned int                                  hp_quad_index,
+        AlignedVector<VectorizedArrayType> &                scratch,
+        AlignedVector<Tensor<2, dim, VectorizedArrayType>> &inverse_jacobians,
+        AlignedVector<VectorizedArrayType> &                JxW_values) const;
+
+      /**
+       * The polynomial degree of the mapping used for computing the geometry
+       * of cells on the fly.
+       */
+      unsigned int mapping_degree;
+
+      /**
+       * The support points of the mapping on the cell batches of general
+       * type in case the geometry of those cells is computed on the fly, in
+       * which case the inverse Jacobians and JxW values are only stored for
+       * the other cells. The points are the tensor product of the
+       * (mapping_degree+1) Gauss-Lobatto points in lexicographic order,
+       * first all points of the x component, then the y component, and so
+       * on.
+       *
+       * Indexed by MappingInfoStorage::data_index_offsets of the cells in
+       * units of dim*(mapping_degree+1)^dim entries.
+       */
+      AlignedVector<VectorizedArrayType> mapping_support_points;
+
+      /**
+       * The values (first entry) and derivatives (second entry) of the
+       * Lagrange polynomials through the support points of the mapping on
+       * the one-dimensional quadrature points, for each quadrature formula
+       * and each quadrature index in the hp case.
+       */
+      std::vector<std::vector<std::array<AlignedVector<Number>, 2>>>
+        mapping_shape_data;
+
       /**
        * Helper function to determine which update flags must be set in the
        * internal functions to initialize all data as requested by the user.
@@ -556,6 +643,103 @@ namespace internal
       return cell_type[cell_no];
     }
 
+
+
+    template <int dim, typename Number, typename VectorizedArrayType>
+    inline void
+    MappingInfo<dim, Number, VectorizedArrayType>::
+      compute_cell_geometry_on_the_fly(
+        const unsigned int                                  offset,
+        const unsigned int                                  quad_no,
+        const unsigned int                                  hp_quad_index,
+        AlignedVector<VectorizedArrayType> &                scratch,
+        AlignedVector<Tensor<2, dim, VectorizedArrayType>> &inverse_jacobians,
+        AlignedVector<VectorizedArrayType> &                JxW_values) const
+    {
+      AssertIndexRange(quad_no, mapping_shape_data.size());
+      AssertIndexRange(hp_quad_index, mapping_shape_data[quad_no].size());
+      const AlignedVector<Number> &shape_values =
+        mapping_shape_data[quad_no][hp_quad_index][0];
+      const AlignedVector<Number> &shape_gradients =
+        mapping_shape_data[quad_no][hp_quad_index][1];
+      const AlignedVector<Number> &weights =
+        cell_data[quad_no].descriptor[hp_quad_index].quadrature_weights;
+
+      const unsigned int n_points_1d = mapping_degree + 1;
+      const unsigned int n_q_points_1d = shape_values.size() / n_points_1d;
+      const unsigned int n_points = Utilities::fixed_power<dim>(n_points_1d);
+      const unsigned int n_q_points =
+        Utilities::fixed_power<dim>(n_q_points_1d);
+      const unsigned int n_max =
+        Utilities::fixed_power<dim>(std::max(n_points_1d, n_q_points_1d));
+      AssertDimension(weights.size(), n_q_points);
+
+      if (JxW_values.size() < n_q_points)
+        {
+          inverse_jacobians.resize_fast(n_q_points);
+          JxW_values.resize_fast(n_q_points);
+        }
+      scratch.resize_fast(dim * dim * n_q_points + 2 * n_max);
+      VectorizedArrayType *tmp1 = scratch.begin() + dim * dim * n_q_points;
+      VectorizedArrayType *tmp2 = tmp1 + n_max;
+
+      const AlignedVector<Number> empty;
+      internal::EvaluatorTensorProduct<internal::evaluate_general,
+                                       dim,
+                                       0,
+                                       0,
+                                       VectorizedArrayType,
+                                       Number>
+        eval(shape_values, shape_gradients, empty, n_points_1d, n_q_points_1d);
+
+      // derivative of the component c of the position in direction e on the
+      // unit cell, i.e., the Jacobian entry (c,e) in all quadrature points
+      AssertIndexRange((offset + 1) * dim * n_points,
+                       mapping_support_points.size() + 1);
+      for (unsigned int c = 0; c < dim; ++c)
+        {
+          const VectorizedArrayType *in =
+            mapping_support_points.begin() +
+            (static_cast<std::size_t>(offset) * dim + c) * n_points;
+          VectorizedArrayType *jac = scratch.begin() + c * dim * n_q_points;
+          switch (dim)
+            {
+              case 1:
+                eval.template gradients<0, true, false>(in, jac);
+                break;
+              case 2:
+                eval.template gradients<0, true, false>(in, tmp1);
+                eval.template values<1, true, false>(tmp1, jac);
+                eval.template values<0, true, false>(in, tmp1);
+                eval.template gradients<1, true, false>(tmp1, jac + n_q_points);
+                break;
+              case 3:
+                eval.template gradients<0, true, false>(in, tmp1);
+                eval.template values<1, true, false>(tmp1, tmp2);
+                eval.template values<2, true, false>(tmp2, jac);
+                eval.template values<0, true, false>(in, tmp1);
+                eval.template gradients<1, true, false>(tmp1, tmp2);
+                eval.template values<2, true, false>(tmp2, jac + n_q_points);
+                eval.template values<1, true, false>(tmp1, tmp2);
+                eval.template gradients<2, true, false>(tmp2,
+                                                        jac + 2 * n_q_points);
+                break;
+              default:
+                Assert(false, ExcNotImplemented());
+            }
+        }
+
+      for (unsigned int q = 0; q < n_q_points; ++q)
+        {
+          Tensor<2, dim, VectorizedArrayType> jac;
+          for (unsigned int c = 0; c < dim; ++c)
+            for (unsigned int e = 0; e < dim; ++e)
+              jac[c][e] = scratch[(c * dim + e) * n_q_points + q];
+          JxW_values[q]        = determinant(jac) * weights[q];
+          inverse_jacobians[q] = transpose(invert(jac));
+        }
+    }
+
   } // end of namespace MatrixFreeFunctions
 } // end of namespace internal
 
@@ -18,11 +18,14 @@
 
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/multithread_info.h>
+#include <deal.II/base/polynomial.h>
+#include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/utilities.h>
 
 #include <deal.II/fe/fe_nothing.h>
 #include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q.h>
 #include <deal.II/fe/mapping_q1.h>
 
 #include <deal.II/matrix_free/mapping_info.h>
@@ -134,6 +137,7 @@ namespace internal
       return MemoryConsumption::memory_consumption(descriptor) +
              MemoryConsumption::memory_consumption(data_index_offsets) +
              MemoryConsumption::memory_consumption(JxW_values) +
+             MemoryConsumption::memory_consumption(single_precision_geometry) +
              MemoryConsumption::memory_consumption(normal_vectors) +
              MemoryConsumption::memory_consumption(jacobians[0]) +
              MemoryConsumption::memory_consumption(jacobians[1]) +
@@ -159,7 +163,9 @@ namespace internal
       // print_memory_statistics involves global communication, so we can
       // disable the check here only if no processor has any such data
       const std::size_t size =
-        Utilities::MPI::sum(jacobians[0].size(), task_info.communicator);
+        Utilities::MPI::sum(jacobians[0].size() +
+                              single_precision_geometry.size(),
+                            task_info.communicator);
       if (size > 0)
         {
           out << "      Memory JxW data:               ";
@@ -171,7 +177,8 @@ namespace internal
           task_info.print_memory_statistics(
             out,
             MemoryConsumption::memory_consumption(jacobians[0]) +
-              MemoryConsumption::memory_consumption(jacobians[1]));
+              MemoryConsumption::memory_consumption(jacobians[1]) +
+              MemoryConsumption::memory_consumption(single_precision_geometry));
           out << "      Memory second derivative data: ";
           task_info.print_memory_statistics(
             out,
@@ -217,6 +224,9 @@ namespace internal
       face_data_by_cells.clear();
       cell_type.clear();
       face_type.clear();
+      mapping_degree = 0;
+      mapping_support_points.clear();
+      mapping_shape_data.clear();
     }
 
 
@@ -280,7 +290,9 @@ namespace internal
       const UpdateFlags update_flags_cells,
       const UpdateFlags update_flags_boundary_faces,
       const UpdateFlags update_flags_inner_faces,
-      const UpdateFlags update_flags_faces_by_cells)
+      const UpdateFlags update_flags_faces_by_cells,
+      const bool        store_geometry_in_single_precision,
+      const bool        compute_geometry_on_the_fly)
     {
       clear();
 
@@ -297,6 +309,167 @@ namespace internal
                        update_flags_inner_faces);
       initialize_faces_by_cells(
         tria, cells, mapping, quad, update_flags_faces_by_cells);
+
+      if (compute_geometry_on_the_fly)
+        initialize_cell_geometry_on_the_fly(tria, cells, mapping, quad);
+
+      if (store_geometry_in_single_precision && sizeof(Number) > sizeof(float))
+        store_cell_geometry_in_single_precision();
+    }
+
+
+
+    template <int dim, typename Number, typename VectorizedArrayType>
+    void
+    MappingInfo<dim, Number, VectorizedArrayType>::
+      initialize_cell_geometry_on_the_fly(
+        const dealii::Triangulation<dim> &                        tria,
+        const std::vector<std::pair<unsigned int, unsigned int>> &cells,
+        const Mapping<dim> &                                      mapping,
+        const std::vector<dealii::hp::QCollection<1>> &           quad)
+    {
+      // the geometry is represented by a polynomial of the degree of the
+      // mapping, which we interpolate exactly with the Lagrange polynomials
+      // in the Gauss-Lobatto points
+      if (const auto *mapping_q_generic =
+            dynamic_cast<const MappingQGeneric<dim> *>(&mapping))
+        mapping_degree = mapping_q_generic->get_degree();
+      else if (const auto *mapping_q =
+                 dynamic_cast<const MappingQ<dim> *>(&mapping))
+        mapping_degree = mapping_q->get_degree();
+      else
+        AssertThrow(false,
+                    ExcMessage("Computing the geometry on the fly is only "
+                               "implemented for mappings of type "
+                               "MappingQGeneric or MappingQ."));
+      for (const auto &data : cell_data)
+        AssertThrow(data.jacobian_gradients[0].empty(),
+                    ExcMessage("Computing the geometry on the fly is not "
+                               "implemented for second derivatives."));
+
+      const QGaussLobatto<1> support_quadrature(mapping_degree + 1);
+      const std::vector<Polynomials::Polynomial<double>> lagrange =
+        Polynomials::generate_complete_Lagrange_basis(
+          support_quadrature.get_points());
+      const unsigned int n_points_1d = support_quadrature.size();
+
+      mapping_shape_data.resize(quad.size());
+      std::vector<double> values(2);
+      for (unsigned int my_q = 0; my_q < quad.size(); ++my_q)
+        {
+          mapping_shape_data[my_q].resize(quad[my_q].size());
+          for (unsigned int hpq = 0; hpq < quad[my_q].size(); ++hpq)
+            {
+              const Quadrature<1> &quad_1d = quad[my_q][hpq];
+              std::array<AlignedVector<Number>, 2> &shape_data =
+                mapping_shape_data[my_q][hpq];
+              shape_data[0].resize_fast(n_points_1d * quad_1d.size());
+              shape_data[1].resize_fast(n_points_1d * quad_1d.size());
+              for (unsigned int i = 0; i < n_points_1d; ++i)
+                for (unsigned int q = 0; q < quad_1d.size(); ++q)
+                  {
+                    lagrange[i].value(quad_1d.point(q)[0], values);
+                    shape_data[0][i * quad_1d.size() + q] = values[0];
+                    shape_data[1][i * quad_1d.size() + q] = values[1];
+                  }
+            }
+        }
+
+      // evaluate the mapping in the support points of all cells of general
+      // type and let the offsets of those cells point into the new array
+      constexpr unsigned int n_lanes = VectorizedArrayType::n_array_elements;
+
+      FE_Nothing<dim> dummy_fe;
+      FEValues<dim>   fe_values(mapping,
+                              dummy_fe,
+                              Quadrature<dim>(support_quadrature),
+                              update_quadrature_points);
+
+      const unsigned int n_points = fe_values.n_quadrature_points;
+
+      std::vector<unsigned int> general_index(cell_type.size(),
+                                              numbers::invalid_unsigned_int);
+      unsigned int              n_general = 0;
+      for (unsigned int cell = 0; cell < cell_type.size(); ++cell)
+        if (cell_type[cell] == general)
+          general_index[cell] = n_general++;
+
+      mapping_support_points.resize_fast(static_cast<std::size_t>(n_general) *
+                                         dim * n_points);
+      for (unsigned int cell = 0; cell < cell_type.size(); ++cell)
+        if (cell_type[cell] == general)
+          for (unsigned int v = 0; v < n_lanes; ++v)
+            {
+              typename dealii::Triangulation<dim>::cell_iterator cell_it(
+                &tria,
+                cells[cell * n_lanes + v].first,
+                cells[cell * n_lanes + v].second);
+              fe_values.reinit(cell_it);
+              VectorizedArrayType *points =
+                mapping_support_points.begin() +
+                static_cast<std::size_t>(general_index[cell]) * dim * n_points;
+              for (unsigned int d = 0; d < dim; ++d)
+                for (unsigned int q = 0; q < n_points; ++q)
+                  points[d * n_points + q][v] =
+                    fe_values.quadrature_point(q)[d];
+            }
+
+      // the data of cells with constant Jacobians is stored before the data
+      // of general cells, so we only need to keep the first entries
+      for (auto &data : cell_data)
+        {
+          std::size_t n_constant_entries = data.JxW_values.size();
+          for (unsigned int cell = 0; cell < cell_type.size(); ++cell)
+            if (cell_type[cell] == general)
+              {
+                n_constant_entries =
+                  std::min<std::size_t>(n_constant_entries,
+                                        data.data_index_offsets[cell]);
+                data.data_index_offsets[cell] = general_index[cell];
+              }
+
+          AlignedVector<VectorizedArrayType> JxW_values(n_constant_entries);
+          AlignedVector<Tensor<2, dim, VectorizedArrayType>> jacobians(
+            n_constant_entries);
+          for (std::size_t i = 0; i < n_constant_entries; ++i)
+            {
+              JxW_values[i] = data.JxW_values[i];
+              jacobians[i]  = data.jacobians[0][i];
+            }
+          data.JxW_values.swap(JxW_values);
+          data.jacobians[0].swap(jacobians);
+        }
+    }
+
+
+
+    template <int dim, typename Number, typename VectorizedArrayType>
+    void
+    MappingInfo<dim, Number, VectorizedArrayType>::
+      store_cell_geometry_in_single_precision()
+    {
+      constexpr unsigned int n_lanes = VectorizedArrayType::n_array_elements;
+      constexpr unsigned int n_fields = dim * dim + 1;
+      for (auto &data : cell_data)
+        {
+          AssertDimension(data.jacobians[0].size(), data.JxW_values.size());
+          data.single_precision_geometry.resize_fast(data.JxW_values.size() *
+                                                     n_fields * n_lanes);
+          float *out = data.single_precision_geometry.begin();
+          for (unsigned int i = 0; i < data.JxW_values.size();
+               ++i, out += n_fields * n_lanes)
+            {
+              for (unsigned int d = 0; d < dim; ++d)
+                for (unsigned int e = 0; e < dim; ++e)
+                  for (unsigned int v = 0; v < n_lanes; ++v)
+                    out[(d * dim + e) * n_lanes + v] =
+                      data.jacobians[0][i][d][e][v];
+              for (unsigned int v = 0; v < n_lanes; ++v)
+                out[dim * dim * n_lanes + v] = data.JxW_values[i][v];
+            }
+          data.JxW_values.clear();
+          data.jacobians[0].clear();
+        }
     }
 
 
@@ -2127,6 +2300,8 @@ namespace internal
       memory += MemoryConsumption::memory_consumption(face_data);
       memory += cell_type.capacity() * sizeof(GeometryType);
       memory += face_type.capacity() * sizeof(GeometryType);
+      memory += MemoryConsumption::memory_consumption(mapping_support_points);
+      memory += MemoryConsumption::memory_consumption(mapping_shape_data);
       memory += sizeof(*this);
       return memory;
     }
@@ -2148,6 +2323,15 @@ namespace internal
       task_info.print_memory_statistics(out,
                                         face_type.capacity() *
                                           sizeof(GeometryType));
+      const std::size_t support_points_size =
+        Utilities::MPI::sum(mapping_support_points.size(),
+                            task_info.communicator);
+      if (support_points_size > 0)
+        {
+          out << "    Mapping support points:          ";
+          task_info.print_memory_statistics(
+            out, MemoryConsumption::memory_consumption(mapping_support_points));
+        }
       for (unsigned int j = 0; j < cell_data.size(); ++j)
         {
           out << "    Data component " << j << std::endl;
@@ -224,7 +224,10 @@ public:
       const bool         initialize_mapping  = true,
       const bool         overlap_communication_computation    = true,
       const bool         hold_all_faces_to_owned_cells        = false,
-      const bool         cell_vectorization_categories_strict = false)
+      const bool         cell_vectorization_categories_strict = false,
+      const bool         store_geometry_in_single_precision   = false,
+      const bool         compute_geometry_on_the_fly          = false,
+      const bool         tune_evaluation_kernels              = false)
       : tasks_parallel_scheme(tasks_parallel_scheme)
       , tasks_block_size(tasks_block_size)
       , mapping_update_flags(mapping_update_flags)
@@ -239,6 +242,9 @@ public:
       , hold_all_faces_to_owned_cells(hold_all_faces_to_owned_cells)
       , cell_vectorization_categories_strict(
           cell_vectorization_categories_strict)
+      , store_geometry_in_single_precision(store_geometry_in_single_precision)
+      , compute_geometry_on_the_fly(compute_geometry_on_the_fly)
+      , tune_evaluation_kernels(tune_evaluation_kernels)
     {}
 
     /**
@@ -462,6 +468,82 @@ public:
      * them in a single vectorized array.
      */
     bool cell_vectorization_categories_strict;
+
+    /**
+     * If set to @p true, the inverse Jacobians and the JxW values on the
+     * cells are stored in single precision, even if the present class
+     * operates on a double-precision @p Number type. FEEvaluation converts
+     * the data of a cell batch back to @p Number in FEEvaluation::reinit()
+     * into a small buffer, so that the integration kernels run in the
+     * precision of @p Number. The geometry data of deformed cells with
+     * different Jacobians in each quadrature point is often larger than
+     * the solution vector, so this option reduces the memory footprint and
+     * the memory transfer in the operator evaluation at the price of a
+     * relative accuracy of the geometry of around 1e-7. This can be used for
+     * example in the ingredients of a multigrid preconditioner where double
+     * precision vectors are needed but single-precision geometry is
+     * accurate enough, without setting up a second MatrixFree object for
+     * float numbers.
+     *
+     * The data on faces and the derivatives of the Jacobians needed for
+     * second derivatives are not affected by this setting. The option has no
+     * effect if @p Number is float.
+     */
+    bool store_geometry_in_single_precision;
+
+    /**
+     * If set to @p true, the inverse Jacobians and JxW values are not stored
+     * on the quadrature points of deformed cells. Instead, the present class
+     * keeps the support points of the mapping on these cells and
+     * FEEvaluation::reinit() recomputes the geometry with sum factorization
+     * kernels in each quadrature point. For a mapping of degree $p$ and
+     * $(p+1)^d$ quadrature points, this reduces the geometry data per cell
+     * from $(d^2+1)(p+1)^d$ to $d(p+1)^d$ numbers, at the cost of $d^2$
+     * tensor-product interpolations and the inversion of the Jacobian in
+     * each quadrature point. On high-order curved meshes, where the operator
+     * evaluation is limited by the memory bandwidth, this is often faster
+     * than loading the precomputed data. Cells with constant Jacobians are
+     * stored as before.
+     *
+     * Note that the geometry is computed in FEEvaluation::reinit() and not
+     * lazily when it is first accessed, so the cost is paid for every cell
+     * batch that is visited, also by operations that do not need the
+     * inverse Jacobians, such as the interpolation of values to quadrature
+     * points. The geometry on faces is stored as before.
+     *
+     * This option requires a mapping of type MappingQGeneric (including
+     * derived classes such as MappingQCache) or MappingQ, whose geometry is
+     * represented exactly by the support points. It can not be combined
+     * with update_hessians in @p mapping_update_flags.
+     */
+    bool compute_geometry_on_the_fly;
+
+    /**
+     * If set to @p true, the sum factorization kernel used by FEEvaluation
+     * objects with the polynomial degree given at run time (template
+     * argument `fe_degree=-1`) is selected by measuring the kernels listed
+     * in internal::MatrixFreeFunctions::EvaluationKernel on the actual
+     * element during the setup, rather than by the operation counts. The
+     * measurement takes a few milliseconds per element and quadrature
+     * formula. The timings are summed over all MPI ranks of the
+     * communicator of the triangulation and the ranks agree on a single
+     * kernel, such that all of them compute with the same kernel.
+     *
+     * Since the kernels differ in the order of their arithmetic operations,
+     * the results of operator evaluations differ on the level of roundoff
+     * depending on the selected kernel. As the selection is based on wall
+     * clock timings, it can change between runs, e.g. due to the load on the
+     * machine, so results obtained with this option are not bitwise
+     * reproducible from one run to the next. Leave this option disabled if
+     * bitwise reproducibility is needed.
+     *
+     * This only affects elements with symmetric shape functions whose
+     * degree does not exceed FE_EVAL_FACTORY_DEGREE_MAX, set at configure
+     * time, and with between $k+1$ and $k+2$ quadrature points in 1D for
+     * degree $k$. FEEvaluation objects with compile-time degree always use
+     * the kernel selected by the operation counts.
+     */
+    bool tune_evaluation_kernels;
   };
 
   /**
@@ -802,6 +884,151 @@ public:
             const InVector &src,
             const bool      zero_dst_vector = false) const;
 
+  /**
+   * This function is similar to the cell_loop() with a `std::function`
+   * object to specify the operation to be performed on cells, but adds two
+   * additional functors to execute some additional work before and after the
+   * cell integrals are computed.
+   *
+   * The two additional functors work on a range of degrees of freedom,
+   * expressed in terms of the degree-of-freedom numbering of the selected
+   * DoFHandler `dof_handler_index_pre_post` in MPI-local indices. The
+   * arguments to the functors represent a range of degrees of freedom at a
+   * granularity of DoFInfo::chunk_size_zero_vector entries (except for the
+   * last chunk which is set to the number of locally owned entries) in the
+   * form `[first, last)`. The idea of these functors is
+   * to bring operations on vectors closer to the point where they are
+   * accessed in a matrix-free loop, with the goal to increase cache hits by
+   * temporal locality. This loop guarantees that the `operation_before_loop`
+   * hits all relevant unknowns before they are first touched in the
+   * cell_operation (including the MPI data exchange), allowing to execute
+   * some vector update that the `src` vector depends upon. The
+   * `operation_after_loop` is similar - it starts to execute on a range of
+   * DoFs once all DoFs in that range have been touched for the last time by
+   * the `cell_operation` (including the MPI data exchange), allowing e.g. to
+   * compute some vector operations that depend on the result of the current
+   * cell loop in `dst` or want to modify `src`. The efficiency of caching
+   * depends on the numbering of the degrees of freedom because of the
+   * granularity of the ranges.
+   *
+   * The interleaving of the vector operations with the cell work is only
+   * done for AdditionalData::tasks_parallel_scheme set to
+   * AdditionalData::none. For the threaded schemes, the cell work is not
+   * done in the order of the partitions, so `operation_before_loop` is run
+   * on all locally owned entries before the loop and `operation_after_loop`
+   * after the loop.
+   *
+   * @param cell_operation Pointer to member function of `CLASS` with the
+   * signature <tt>cell_operation (const MatrixFree<dim,Number> &, OutVector &,
+   * InVector &, std::pair<unsigned int,unsigned int> &)</tt> where the first
+   * argument passes the data of the calling class and the last argument
+   * defines the range of cells which should be worked on (typically more than
+   * one cell should be worked on in order to reduce overheads).
+   *
+   * @param owning_class The object which provides the `cell_operation`
+   * call. To be compatible with this interface, the class must allow to call
+   * `owning_class->cell_operation(...)`.
+   *
+   * @param dst Destination vector holding the result. If the vector is of
+   * type LinearAlgebra::distributed::Vector (or composite objects thereof
+   * such as LinearAlgebra::distributed::BlockVector), the loop calls
+   * LinearAlgebra::distributed::Vector::compress() at the end of the call
+   * internally. For other vectors, including parallel Trilinos or PETSc
+   * vectors, no such call is issued. Note that Trilinos/Epetra or PETSc
+   * vectors do currently not work in parallel because the present class uses
+   * MPI-local index addressing, as opposed to the global addressing implied
+   * by those external libraries.
+   *
+   * @param src Input vector. If the vector is of type
+   * LinearAlgebra::distributed::Vector (or composite objects thereof such as
+   * LinearAlgebra::distributed::BlockVector), the loop calls
+   * LinearAlgebra::distributed::Vector::update_ghost_values() at the start of
+   * the call internally to make sure all necessary data is locally
+   * available. Note, however, that the vector is reset to its original state
+   * at the end of the loop, i.e., if the vector was not ghosted upon entry of
+   * the loop, it will not be ghosted upon finishing the loop.
+   *
+   * @param operation_before_loop This functor can be used to perform an
+   * operation on entries of the `src` and `dst` vectors (or other vectors)
+   * before the operation on cells first touches a particular DoF according
+   * to the general description in the text above. This function is passed a
+   * range of the locally owned degrees of freedom on the selected
+   * `dof_handler_index_pre_post` (in MPI-local numbering).
+   *
+   * @param operation_after_loop This functor can be used to perform an
+   * operation on entries of the `src` and `dst` vectors (or other vectors)
+   * after the operation on cells last touches a particular DoF according to
+   * the general description in the text above. This function is passed a
+   * range of the locally owned degrees of freedom on the selected
+   * `dof_handler_index_pre_post` (in MPI-local numbering).
+   *
+   * @param dof_handler_index_pre_post Since MatrixFree can be initialized
+   * with a vector of DoFHandler objects, each of them will in general have
+   * vector sizes and thus different ranges returned to
+   * `operation_before_loop` and `operation_after_loop`. Use this variable to
+   * specify which one of the DoFHandler objects the index range should be
+   * associated to. Defaults to the `dof_handler_index` 0.
+   *
+   * @note The close locality of the `operation_before_loop` and
+   * `operation_after_loop` is currently only implemented for the MPI-only
+   * case. In case threading is enabled, the complete `operation_before_loop`
+   * is scheduled before the parallel loop, and `operation_after_loop` is
+   * scheduled strictly afterwards, due to the complicated dependencies.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void
+  cell_loop(void (CLASS::*cell_operation)(
+              const MatrixFree &,
+              OutVector &,
+              const InVector &,
+              const std::pair<unsigned int, unsigned int> &) const,
+            const CLASS *   owning_class,
+            OutVector &     dst,
+            const InVector &src,
+            const std::function<void(const unsigned int, const unsigned int)>
+              &operation_before_loop,
+            const std::function<void(const unsigned int, const unsigned int)>
+              &                operation_after_loop,
+            const unsigned int dof_handler_index_pre_post = 0) const;
+
+  /**
+   * Same as above, but for class member functions which are non-const.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void
+  cell_loop(void (CLASS::*cell_operation)(
+              const MatrixFree &,
+              OutVector &,
+              const InVector &,
+              const std::pair<unsigned int, unsigned int> &),
+            CLASS *         owning_class,
+            OutVector &     dst,
+            const InVector &src,
+            const std::function<void(const unsigned int, const unsigned int)>
+              &operation_before_loop,
+            const std::function<void(const unsigned int, const unsigned int)>
+              &                operation_after_loop,
+            const unsigned int dof_handler_index_pre_post = 0) const;
+
+  /**
+   * Same as above, but taking an `std::function` as the `cell_operation`
+   * rather than a class member function.
+   */
+  template <typename OutVector, typename InVector>
+  void
+  cell_loop(const std::function<void(
+              const MatrixFree<dim, Number, VectorizedArrayType> &,
+              OutVector &,
+              const InVector &,
+              const std::pair<unsigned int, unsigned int> &)> &cell_operation,
+            OutVector &                                        dst,
+            const InVector &                                   src,
+            const std::function<void(const unsigned int, const unsigned int)>
+              &operation_before_loop,
+            const std::function<void(const unsigned int, const unsigned int)>
+              &                operation_after_loop,
+            const unsigned int dof_handler_index_pre_post = 0) const;
+
   /**
    * This method runs a loop over all cells (in parallel) and performs the MPI
    * data exchange on the source vector and destination vector. As opposed to
@@ -1042,6 +1269,131 @@ public:
        const DataAccessOnFaces src_vector_face_access =
          DataAccessOnFaces::unspecified) const;
 
+  /**
+   * This function is similar to the loop() above with class member
+   * functions, but adds the two functors `operation_before_loop` and
+   * `operation_after_loop` that are run on ranges of the vector entries
+   * before they are first touched and after they are last touched by the
+   * operations on cells and faces, respectively. See the cell_loop() variant
+   * with these arguments for a detailed description. Note that the
+   * destination vector is not set to zero by this function, which can be
+   * done in `operation_before_loop` instead.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void
+  loop(
+    void (CLASS::*cell_operation)(const MatrixFree &,
+                                  OutVector &,
+                                  const InVector &,
+                                  const std::pair<unsigned int, unsigned int> &)
+      const,
+    void (CLASS::*face_operation)(const MatrixFree &,
+                                  OutVector &,
+                                  const InVector &,
+                                  const std::pair<unsigned int, unsigned int> &)
+      const,
+    void (CLASS::*boundary_operation)(
+      const MatrixFree &,
+      OutVector &,
+      const InVector &,
+      const std::pair<unsigned int, unsigned int> &) const,
+    const CLASS *   owning_class,
+    OutVector &     dst,
+    const InVector &src,
+    const std::function<void(const unsigned int, const unsigned int)>
+      &operation_before_loop,
+    const std::function<void(const unsigned int, const unsigned int)>
+      &                     operation_after_loop,
+    const unsigned int      dof_handler_index_pre_post = 0,
+    const DataAccessOnFaces dst_vector_face_access =
+      DataAccessOnFaces::unspecified,
+    const DataAccessOnFaces src_vector_face_access =
+      DataAccessOnFaces::unspecified) const;
+
+  /**
+   * This method runs a loop over all cells (in parallel) where the cell
+   * operation is also responsible for the integrals on all faces of the
+   * cells, as opposed to loop() that visits the interior and boundary faces
+   * separately. This is an alternative for discontinuous Galerkin methods:
+   * each cell batch is visited only once and computes all its face integrals
+   * from its own point of view, using FEFaceEvaluation objects initialized
+   * with the cell-based FEFaceEvaluation::reinit(cell_batch, face_number)
+   * method for both the cell itself (`is_interior_face == true`) and the
+   * neighbors across the face (`is_interior_face == false`). Thus, the
+   * degrees of freedom of a cell are read and written only once per loop and
+   * the results do not need to be accumulated from several face batches, at
+   * the cost of computing the face integrals twice, once from each side.
+   *
+   * The function requires the data structures for the cell-based face access
+   * to be set up, i.e., the flags in
+   * AdditionalData::mapping_update_flags_faces_by_cells must be set, and
+   * AdditionalData::hold_all_faces_to_owned_cells must be true for all faces
+   * of the locally owned cells to be available.
+   *
+   * @param cell_operation `std::function` with the signature
+   * <tt>cell_operation (const MatrixFree<dim,Number> &, OutVector &,
+   * InVector &, std::pair<unsigned int,unsigned int> &)</tt> as in
+   * cell_loop(). The operation must only write into the degrees of freedom
+   * of the cells in the given range, as several ranges are worked on in
+   * parallel.
+   *
+   * @param dst Destination vector holding the result. Since the loop only
+   * writes to the locally owned cells, no data exchange is done on this
+   * vector beyond the one of cell_loop().
+   *
+   * @param src Input vector. If the vector is of type
+   * LinearAlgebra::distributed::Vector (or composite objects thereof such as
+   * LinearAlgebra::distributed::BlockVector), the loop calls
+   * LinearAlgebra::distributed::Vector::update_ghost_values() at the start of
+   * the call internally to make the values of all neighbors locally
+   * available. The vector is reset to its original state at the end of the
+   * loop.
+   *
+   * @param zero_dst_vector If this flag is set to `true`, the vector `dst`
+   * will be set to zero inside the loop, see cell_loop().
+   */
+  template <typename OutVector, typename InVector>
+  void
+  loop_cell_centric(const std::function<void(
+                      const MatrixFree<dim, Number, VectorizedArrayType> &,
+                      OutVector &,
+                      const InVector &,
+                      const std::pair<unsigned int, unsigned int> &)>
+                      &             cell_operation,
+                    OutVector &     dst,
+                    const InVector &src,
+                    const bool      zero_dst_vector = false) const;
+
+  /**
+   * Same as above, but for a class member function which is const.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void
+  loop_cell_centric(void (CLASS::*cell_operation)(
+                      const MatrixFree &,
+                      OutVector &,
+                      const InVector &,
+                      const std::pair<unsigned int, unsigned int> &) const,
+                    const CLASS *   owning_class,
+                    OutVector &     dst,
+                    const InVector &src,
+                    const bool      zero_dst_vector = false) const;
+
+  /**
+   * Same as above, but for class member functions which are non-const.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void
+  loop_cell_centric(void (CLASS::*cell_operation)(
+                      const MatrixFree &,
+                      OutVector &,
+                      const InVector &,
+                      const std::pair<unsigned int, unsigned int> &),
+                    CLASS *         owning_class,
+                    OutVector &     dst,
+                    const InVector &src,
+                    const bool      zero_dst_vector = false) const;
+
   /**
    * In the hp adaptive case, a subrange of cells as computed during the cell
    * loop might contain elements of different degrees. Use this function to
@@ -1168,6 +1520,13 @@ public:
    * set up again using the renumbered DoFHandler and AffineConstraints. Note
    * that if a DoFHandler calls DoFHandler::renumber_dofs, all information in
    * MatrixFree becomes invalid.
+   *
+   * The renumbering interleaves the degrees of freedom of the cells within
+   * each cell batch. For DG elements, FEEvaluation can then read and write
+   * the unknowns of a full batch with plain vector loads and stores instead
+   * of transposing the data of the individual cells, and
+   * FEEvaluation::gather_evaluate() and FEEvaluation::integrate_scatter()
+   * even work directly on the vector entries.
    */
   void
   renumber_dofs(std::vector<types::global_dof_index> &renumbering,
@@ -1287,6 +1646,20 @@ public:
   get_faces_by_cells_boundary_id(const unsigned int macro_cell,
                                  const unsigned int face_number) const;
 
+  /**
+   * Return the faces within a cell, using the cells' sorting by lanes in the
+   * VectorizedArray. Each face is identified by the index `face_batch *
+   * VectorizedArrayType::n_array_elements + lane`, i.e., the batch of faces
+   * as used in the face loops and the lane within that batch, with the
+   * connectivity of the batch given by get_face_info(). Unfilled lanes and
+   * faces not stored on the present processor hold
+   * numbers::invalid_unsigned_int; the latter happens for faces towards ghost
+   * cells unless AdditionalData::hold_all_faces_to_owned_cells is set.
+   */
+  std::array<unsigned int, VectorizedArrayType::n_array_elements>
+  get_faces_by_cells_face_index(const unsigned int macro_cell,
+                                const unsigned int face_number) const;
+
   /**
    * Return the DoFHandler with the index as given to the respective
    * `std::vector` argument in the reinit() function.
@@ -1294,6 +1667,14 @@ public:
   const DoFHandler<dim> &
   get_dof_handler(const unsigned int dof_handler_index = 0) const;
 
+  /**
+   * Return the multigrid level this object was set up for, as given by
+   * AdditionalData::level_mg_handler, or numbers::invalid_unsigned_int when
+   * working on the active cells.
+   */
+  unsigned int
+  get_mg_level() const;
+
   /**
    * Return the cell iterator in deal.II speak to a given cell in the
    * renumbering of this structure.
@@ -1647,6 +2028,14 @@ private:
   void
   make_connectivity_graph_faces(DynamicSparsityPattern &connectivity);
 
+  /**
+   * Selects the sum factorization kernel of all elements in shape_info by
+   * measuring the available kernels, see
+   * AdditionalData::tune_evaluation_kernels.
+   */
+  void
+  tune_evaluation_kernels();
+
   /**
    * This struct defines which DoFHandler has actually been given at
    * construction, in order to define the correct behavior when querying the
@@ -1880,6 +2269,15 @@ MatrixFree<dim, Number, VectorizedArrayType>::n_macro_cells() const
 
 
 
+template <int dim, typename Number, typename VectorizedArrayType>
+inline unsigned int
+MatrixFree<dim, Number, VectorizedArrayType>::get_mg_level() const
+{
+  return dof_handlers.level;
+}
+
+
+
 template <int dim, typename Number, typename VectorizedArrayType>
 inline unsigned int
 MatrixFree<dim, Number, VectorizedArrayType>::n_physical_cells() const
@@ -1976,6 +2374,26 @@ MatrixFree<dim, Number, VectorizedArrayType>::get_faces_by_cells_boundary_id(
 
 
 
+template <int dim, typename Number, typename VectorizedArrayType>
+inline std::array<unsigned int, VectorizedArrayType::n_array_elements>
+MatrixFree<dim, Number, VectorizedArrayType>::get_faces_by_cells_face_index(
+  const unsigned int macro_cell,
+  const unsigned int face_number) const
+{
+  AssertIndexRange(macro_cell, n_macro_cells());
+  AssertIndexRange(face_number, GeometryInfo<dim>::faces_per_cell);
+  Assert(face_info.cell_and_face_to_plain_faces.size(0) >= n_macro_cells(),
+         ExcNotInitialized());
+  std::array<unsigned int, VectorizedArrayType::n_array_elements> result;
+  result.fill(numbers::invalid_unsigned_int);
+  for (unsigned int v = 0; v < n_active_entries_per_cell_batch(macro_cell); ++v)
+    result[v] =
+      face_info.cell_and_face_to_plain_faces(macro_cell, face_number, v);
+  return result;
+}
+
+
+
 template <int dim, typename Number, typename VectorizedArrayType>
 inline const internal::MatrixFreeFunctions::
   MappingInfo<dim, Number, VectorizedArrayType> &
@@ -4066,12 +4484,20 @@ namespace internal
              const typename MF::DataAccessOnFaces src_vector_face_access =
                MF::DataAccessOnFaces::none,
              const typename MF::DataAccessOnFaces dst_vector_face_access =
-               MF::DataAccessOnFaces::none)
+               MF::DataAccessOnFaces::none,
+             const std::function<void(const unsigned int, const unsigned int)>
+               &operation_before_loop = {},
+             const std::function<void(const unsigned int, const unsigned int)>
+               &                operation_after_loop       = {},
+             const unsigned int dof_handler_index_pre_post = 0)
       : matrix_free(matrix_free)
       , container(const_cast<Container &>(container))
       , cell_function(cell_function)
       , face_function(face_function)
       , boundary_function(boundary_function)
+      , operation_before_loop(operation_before_loop)
+      , operation_after_loop(operation_after_loop)
+      , dof_handler_index_pre_post(dof_handler_index_pre_post)
       , src(src)
       , dst(dst)
       , src_data_exchanger(matrix_free,
@@ -4159,13 +4585,78 @@ namespace internal
         internal::zero_vector_region(range_index, dst, dst_data_exchanger);
     }
 
+    // Runs the operation before the loop on the vector entries first touched
+    // in the given range
+    virtual void
+    cell_loop_pre_range(const unsigned int range_index) override
+    {
+      if (operation_before_loop)
+        run_on_index_ranges(operation_before_loop,
+                            range_index,
+                            matrix_free.get_dof_info(dof_handler_index_pre_post)
+                              .cell_loop_pre_list_index,
+                            matrix_free.get_dof_info(dof_handler_index_pre_post)
+                              .cell_loop_pre_list);
+    }
+
+    // Runs the operation after the loop on the vector entries last touched
+    // in the given range
+    virtual void
+    cell_loop_post_range(const unsigned int range_index) override
+    {
+      if (operation_after_loop)
+        run_on_index_ranges(operation_after_loop,
+                            range_index,
+                            matrix_free.get_dof_info(dof_handler_index_pre_post)
+                              .cell_loop_post_list_index,
+                            matrix_free.get_dof_info(dof_handler_index_pre_post)
+                              .cell_loop_post_list);
+    }
+
   private:
+    // Runs the given operation on the ranges of locally owned indices
+    // associated with a range index, or on all locally owned indices in
+    // chunks for numbers::invalid_unsigned_int
+    void
+    run_on_index_ranges(
+      const std::function<void(const unsigned int, const unsigned int)>
+        &                                                       operation,
+      const unsigned int                                        range_index,
+      const std::vector<unsigned int> &                         list_index,
+      const std::vector<std::pair<unsigned int, unsigned int>> &list) const
+    {
+      if (range_index == numbers::invalid_unsigned_int)
+        {
+          const unsigned int local_size =
+            matrix_free.get_dof_info(dof_handler_index_pre_post)
+              .vector_partitioner->local_size();
+          constexpr unsigned int chunk_size =
+            MatrixFreeFunctions::DoFInfo::chunk_size_zero_vector;
+          for (unsigned int i = 0; i < local_size; i += chunk_size)
+            operation(i, std::min(i + chunk_size, local_size));
+        }
+      else
+        {
+          AssertIndexRange(range_index + 1, list_index.size());
+          for (unsigned int id = list_index[range_index];
+               id != list_index[range_index + 1];
+               ++id)
+            operation(list[id].first, list[id].second);
+        }
+    }
+
     const MF &    matrix_free;
     Container &   container;
     function_type cell_function;
     function_type face_function;
     function_type boundary_function;
 
+    const std::function<void(const unsigned int, const unsigned int)>
+                       operation_before_loop;
+    const std::function<void(const unsigned int, const unsigned int)>
+                       operation_after_loop;
+    const unsigned int dof_handler_index_pre_post;
+
     const InVector &src;
     OutVector &     dst;
     VectorDataExchange<MF::dimension,
@@ -4485,6 +4976,304 @@ MatrixFree<dim, Number, VectorizedArrayType>::loop(
   task_info.loop(worker);
 }
 
+template <int dim, typename Number, typename VectorizedArrayType>
+template <typename CLASS, typename OutVector, typename InVector>
+inline void
+MatrixFree<dim, Number, VectorizedArrayType>::cell_loop(
+  void (CLASS::*function_pointer)(
+    const MatrixFree<dim, Number, VectorizedArrayType> &,
+    OutVector &,
+    const InVector &,
+    const std::pair<unsigned int, unsigned int> &) const,
+  const CLASS *   owning_class,
+  OutVector &     dst,
+  const InVector &src,
+  const std::function<void(const unsigned int, const unsigned int)>
+    &operation_before_loop,
+  const std::function<void(const unsigned int, const unsigned int)>
+    &                operation_after_loop,
+  const unsigned int dof_handler_index_pre_post) const
+{
+  internal::MFWorker<MatrixFree<dim, Number, VectorizedArrayType>,
+                     InVector,
+                     OutVector,
+                     CLASS,
+                     true>
+    worker(*this,
+           src,
+           dst,
+           false,
+           *owning_class,
+           function_pointer,
+           nullptr,
+           nullptr,
+           DataAccessOnFaces::none,
+           DataAccessOnFaces::none,
+           operation_before_loop,
+           operation_after_loop,
+           dof_handler_index_pre_post);
+  task_info.loop(worker);
+}
+
+
+
+template <int dim, typename Number, typename VectorizedArrayType>
+template <typename CLASS, typename OutVector, typename InVector>
+inline void
+MatrixFree<dim, Number, VectorizedArrayType>::cell_loop(
+  void (CLASS::*function_pointer)(
+    const MatrixFree<dim, Number, VectorizedArrayType> &,
+    OutVector &,
+    const InVector &,
+    const std::pair<unsigned int, unsigned int> &),
+  CLASS *         owning_class,
+  OutVector &     dst,
+  const InVector &src,
+  const std::function<void(const unsigned int, const unsigned int)>
+    &operation_before_loop,
+  const std::function<void(const unsigned int, const unsigned int)>
+    &                operation_after_loop,
+  const unsigned int dof_handler_index_pre_post) const
+{
+  internal::MFWorker<MatrixFree<dim, Number, VectorizedArrayType>,
+                     InVector,
+                     OutVector,
+                     CLASS,
+                     false>
+    worker(*this,
+           src,
+           dst,
+           false,
+           *owning_class,
+           function_pointer,
+           nullptr,
+           nullptr,
+           DataAccessOnFaces::none,
+           DataAccessOnFaces::none,
+           operation_before_loop,
+           operation_after_loop,
+           dof_handler_index_pre_post);
+  task_info.loop(worker);
+}
+
+
+
+template <int dim, typename Number, typename VectorizedArrayType>
+template <typename OutVector, typename InVector>
+inline void
+MatrixFree<dim, Number, VectorizedArrayType>::cell_loop(
+  const std::function<void(const MatrixFree<dim, Number, VectorizedArrayType> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int, unsigned int> &)>
+    &             cell_operation,
+  OutVector &     dst,
+  const InVector &src,
+  const std::function<void(const unsigned int, const unsigned int)>
+    &operation_before_loop,
+  const std::function<void(const unsigned int, const unsigned int)>
+    &                operation_after_loop,
+  const unsigned int dof_handler_index_pre_post) const
+{
+  using Wrapper =
+    internal::MFClassWrapper<MatrixFree<dim, Number, VectorizedArrayType>,
+                             InVector,
+                             OutVector>;
+  Wrapper wrap(cell_operation, nullptr, nullptr);
+  internal::MFWorker<MatrixFree<dim, Number, VectorizedArrayType>,
+                     InVector,
+                     OutVector,
+                     Wrapper,
+                     true>
+    worker(*this,
+           src,
+           dst,
+           false,
+           wrap,
+           &Wrapper::cell_integrator,
+           &Wrapper::face_integrator,
+           &Wrapper::boundary_integrator,
+           DataAccessOnFaces::none,
+           DataAccessOnFaces::none,
+           operation_before_loop,
+           operation_after_loop,
+           dof_handler_index_pre_post);
+
+  task_info.loop(worker);
+}
+
+
+
+template <int dim, typename Number, typename VectorizedArrayType>
+template <typename CLASS, typename OutVector, typename InVector>
+inline void
+MatrixFree<dim, Number, VectorizedArrayType>::loop(
+  void (CLASS::*cell_operation)(
+    const MatrixFree<dim, Number, VectorizedArrayType> &,
+    OutVector &,
+    const InVector &,
+    const std::pair<unsigned int, unsigned int> &) const,
+  void (CLASS::*face_operation)(
+    const MatrixFree<dim, Number, VectorizedArrayType> &,
+    OutVector &,
+    const InVector &,
+    const std::pair<unsigned int, unsigned int> &) const,
+  void (CLASS::*boundary_operation)(
+    const MatrixFree<dim, Number, VectorizedArrayType> &,
+    OutVector &,
+    const InVector &,
+    const std::pair<unsigned int, unsigned int> &) const,
+  const CLASS *   owning_class,
+  OutVector &     dst,
+  const InVector &src,
+  const std::function<void(const unsigned int, const unsigned int)>
+    &operation_before_loop,
+  const std::function<void(const unsigned int, const unsigned int)>
+    &                     operation_after_loop,
+  const unsigned int      dof_handler_index_pre_post,
+  const DataAccessOnFaces dst_vector_face_access,
+  const DataAccessOnFaces src_vector_face_access) const
+{
+  internal::MFWorker<MatrixFree<dim, Number, VectorizedArrayType>,
+                     InVector,
+                     OutVector,
+                     CLASS,
+                     true>
+    worker(*this,
+           src,
+           dst,
+           false,
+           *owning_class,
+           cell_operation,
+           face_operation,
+           boundary_operation,
+           src_vector_face_access,
+           dst_vector_face_access,
+           operation_before_loop,
+           operation_after_loop,
+           dof_handler_index_pre_post);
+  task_info.loop(worker);
+}
+
+
+
+template <int dim, typename Number, typename VectorizedArrayType>
+template <typename OutVector, typename InVector>
+inline void
+MatrixFree<dim, Number, VectorizedArrayType>::loop_cell_centric(
+  const std::function<void(const MatrixFree<dim, Number, VectorizedArrayType> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int, unsigned int> &)>
+    &             cell_operation,
+  OutVector &     dst,
+  const InVector &src,
+  const bool      zero_dst_vector) const
+{
+  Assert(face_info.cell_and_face_to_plain_faces.size(0) >= n_macro_cells(),
+         ExcMessage("The cell-centric loop needs the connectivity of faces, "
+                    "which is only set up when the flags for inner or "
+                    "boundary faces are set in MatrixFree::AdditionalData."));
+  using Wrapper =
+    internal::MFClassWrapper<MatrixFree<dim, Number, VectorizedArrayType>,
+                             InVector,
+                             OutVector>;
+  Wrapper wrap(cell_operation, nullptr, nullptr);
+  internal::MFWorker<MatrixFree<dim, Number, VectorizedArrayType>,
+                     InVector,
+                     OutVector,
+                     Wrapper,
+                     true>
+    worker(*this,
+           src,
+           dst,
+           zero_dst_vector,
+           wrap,
+           &Wrapper::cell_integrator,
+           &Wrapper::face_integrator,
+           &Wrapper::boundary_integrator,
+           DataAccessOnFaces::unspecified,
+           DataAccessOnFaces::none);
+
+  task_info.loop(worker);
+}
+
+
+
+template <int dim, typename Number, typename VectorizedArrayType>
+template <typename CLASS, typename OutVector, typename InVector>
+inline void
+MatrixFree<dim, Number, VectorizedArrayType>::loop_cell_centric(
+  void (CLASS::*function_pointer)(
+    const MatrixFree<dim, Number, VectorizedArrayType> &,
+    OutVector &,
+    const InVector &,
+    const std::pair<unsigned int, unsigned int> &) const,
+  const CLASS *   owning_class,
+  OutVector &     dst,
+  const InVector &src,
+  const bool      zero_dst_vector) const
+{
+  Assert(face_info.cell_and_face_to_plain_faces.size(0) >= n_macro_cells(),
+         ExcMessage("The cell-centric loop needs the connectivity of faces, "
+                    "which is only set up when the flags for inner or "
+                    "boundary faces are set in MatrixFree::AdditionalData."));
+  internal::MFWorker<MatrixFree<dim, Number, VectorizedArrayType>,
+                     InVector,
+                     OutVector,
+                     CLASS,
+                     true>
+    worker(*this,
+           src,
+           dst,
+           zero_dst_vector,
+           *owning_class,
+           function_pointer,
+           nullptr,
+           nullptr,
+           DataAccessOnFaces::unspecified,
+           DataAccessOnFaces::none);
+  task_info.loop(worker);
+}
+
+
+
+template <int dim, typename Number, typename VectorizedArrayType>
+template <typename CLASS, typename OutVector, typename InVector>
+inline void
+MatrixFree<dim, Number, VectorizedArrayType>::loop_cell_centric(
+  void (CLASS::*function_pointer)(
+    const MatrixFree<dim, Number, VectorizedArrayType> &,
+    OutVector &,
+    const InVector &,
+    const std::pair<unsigned int, unsigned int> &),
+  CLASS *         owning_class,
+  OutVector &     dst,
+  const InVector &src,
+  const bool      zero_dst_vector) const
+{
+  Assert(face_info.cell_and_face_to_plain_faces.size(0) >= n_macro_cells(),
+         ExcMessage("The cell-centric loop needs the connectivity of faces, "
+                    "which is only set up when the flags for inner or "
+                    "boundary faces are set in MatrixFree::AdditionalData."));
+  internal::MFWorker<MatrixFree<dim, Number, VectorizedArrayType>,
+                     InVector,
+                     OutVector,
+                     CLASS,
+                     false>
+    worker(*this,
+           src,
+           dst,
+           zero_dst_vector,
+           *owning_class,
+           function_pointer,
+           nullptr,
+           nullptr,
+           DataAccessOnFaces::unspecified,
+           DataAccessOnFaces::none);
+  task_info.loop(worker);
+}
+
 
 #endif // ifndef DOXYGEN
 
@@ -32,6 +32,7 @@
 #include <deal.II/hp/q_collection.h>
 
 #include <deal.II/matrix_free/dof_info.templates.h>
+#include <deal.II/matrix_free/evaluation_selector.h>
 #include <deal.II/matrix_free/face_info.h>
 #include <deal.II/matrix_free/face_setup_internal.h>
 #include <deal.II/matrix_free/matrix_free.h>
@@ -386,10 +387,15 @@ MatrixFree<dim, Number, VectorizedArrayType>::internal_reinit(
         additional_data.mapping_update_flags,
         additional_data.mapping_update_flags_boundary_faces,
         additional_data.mapping_update_flags_inner_faces,
-        additional_data.mapping_update_flags_faces_by_cells);
+        additional_data.mapping_update_flags_faces_by_cells,
+        additional_data.store_geometry_in_single_precision,
+        additional_data.compute_geometry_on_the_fly);
 
       mapping_is_initialized = true;
     }
+
+  if (additional_data.tune_evaluation_kernels)
+    tune_evaluation_kernels();
 }
 
 
@@ -553,10 +559,15 @@ MatrixFree<dim, Number, VectorizedArrayType>::internal_reinit(
         additional_data.mapping_update_flags,
         additional_data.mapping_update_flags_boundary_faces,
         additional_data.mapping_update_flags_inner_faces,
-        additional_data.mapping_update_flags_faces_by_cells);
+        additional_data.mapping_update_flags_faces_by_cells,
+        additional_data.store_geometry_in_single_precision,
+        additional_data.compute_geometry_on_the_fly);
 
       mapping_is_initialized = true;
     }
+
+  if (additional_data.tune_evaluation_kernels)
+    tune_evaluation_kernels();
 }
 
 
@@ -590,6 +601,10 @@ MatrixFree<dim, Number, VectorizedArrayType>::is_supported(
     return true;
   if (dynamic_cast<const FE_Q_DG0<dim, spacedim> *>(fe_ptr) != nullptr)
     return true;
+  if (dynamic_cast<const FE_DGPMonomial<dim> *>(fe_ptr) != nullptr)
+    return true;
+  if (dynamic_cast<const FE_Q_Bubbles<dim, spacedim> *>(fe_ptr) != nullptr)
+    return true;
 
   // if the base element is not in the above list it is not supported
   return false;
@@ -1915,6 +1930,48 @@ MatrixFree<dim, Number, VectorizedArrayType>::make_connectivity_graph_faces(
 
 
 
+template <int dim, typename Number, typename VectorizedArrayType>
+void
+MatrixFree<dim, Number, VectorizedArrayType>::tune_evaluation_kernels()
+{
+  for (unsigned int c = 0; c < shape_info.size(0); ++c)
+    for (unsigned int q = 0; q < shape_info.size(1); ++q)
+      for (unsigned int f = 0; f < shape_info.size(2); ++f)
+        for (unsigned int i = 0; i < shape_info.size(3); ++i)
+          {
+            internal::MatrixFreeFunctions::ShapeInfo<VectorizedArrayType>
+              &shape = shape_info(c, q, f, i);
+            if (shape.n_q_points == 0)
+              continue;
+
+            std::array<double, 5> times =
+              internal::measure_evaluation_kernels<dim>(shape);
+
+            // sum over all ranks to make sure that all processors select the
+            // same kernel; kernels not applicable on the element have
+            // negative times on all ranks
+            Utilities::MPI::sum(ArrayView<const double>(times.data(),
+                                                        times.size()),
+                                task_info.communicator,
+                                ArrayView<double>(times.data(), times.size()));
+
+            unsigned int best = internal::MatrixFreeFunctions::kernel_default;
+            for (unsigned int k = 0; k < times.size(); ++k)
+              if (times[k] >= 0. && times[k] < times[best])
+                best = k;
+
+            // MPI does not guarantee that the reduced sums are bitwise
+            // identical on all ranks, so a tie could still be broken
+            // differently; agree on a single kernel explicitly
+            best = Utilities::MPI::min(best, task_info.communicator);
+            shape.evaluation_kernel =
+              static_cast<internal::MatrixFreeFunctions::EvaluationKernel>(
+                best);
+          }
+}
+
+
+
 template <int dim, typename Number, typename VectorizedArrayType>
 std::size_t
 MatrixFree<dim, Number, VectorizedArrayType>::memory_consumption() const
@@ -89,7 +89,67 @@ namespace internal
        * of the unit interval 0.5 that additionally add a constant shape
        * function according to FE_Q_DG0.
        */
-      tensor_symmetric_plus_dg0 = 5
+      tensor_symmetric_plus_dg0 = 5,
+
+      /**
+       * Tensor product shape functions that are symmetric about the midpoint
+       * of the unit interval 0.5 that additionally add bubble functions
+       * according to FE_Q_Bubbles. The bubble functions are products of
+       * one-dimensional functions and are evaluated separately from the
+       * tensor product part, see ShapeInfo::bubble_factors.
+       */
+      tensor_symmetric_plus_bubbles = 6
+    };
+
+    /**
+     * An enum that encodes which sum factorization kernel is used by
+     * FEEvaluation objects whose polynomial degree and number of quadrature
+     * points are only known at run time, i.e., with template arguments
+     * `fe_degree=-1`. The value `kernel_default` selects the kernel based on
+     * operation counts as done for compile-time degrees, whereas the other
+     * values force a particular kernel. The latter are typically set by
+     * MatrixFree::reinit(), which measures the kernels on the actual element
+     * if MatrixFree::AdditionalData::tune_evaluation_kernels is enabled.
+     *
+     * All kernels compute the same result in exact arithmetic, but they
+     * perform the operations in different order and thus differ in
+     * roundoff. Since a tuned selection depends on timings, it is not
+     * guaranteed to be the same in every run, and neither are the results
+     * bitwise.
+     *
+     * @ingroup matrixfree
+     */
+    enum EvaluationKernel
+    {
+      /**
+       * Choose the kernel according to the operation counts.
+       */
+      kernel_default = 0,
+
+      /**
+       * Sum factorization with the full 1D matrices, see
+       * internal::EvaluatorVariant::evaluate_general.
+       */
+      kernel_general = 1,
+
+      /**
+       * Sum factorization exploiting the symmetry of the 1D matrices, see
+       * internal::EvaluatorVariant::evaluate_symmetric.
+       */
+      kernel_symmetric = 2,
+
+      /**
+       * Sum factorization with the even-odd decomposition of the 1D
+       * matrices, see internal::EvaluatorVariant::evaluate_evenodd.
+       */
+      kernel_evenodd = 3,
+
+      /**
+       * Change of basis to the collocation space of the quadrature points
+       * followed by collocation derivatives, see
+       * internal::FEEvaluationImplTransformToCollocation.
+       */
+      kernel_transform_to_collocation = 4
     };
 
     /**
@@ -145,6 +205,14 @@ namespace internal
        */
       ElementType element_type;
 
+      /**
+       * The sum factorization kernel used for FEEvaluation objects with run
+       * time degree. Only relevant for element types up to
+       * ElementType::tensor_symmetric. Defaults to
+       * EvaluationKernel::kernel_default.
+       */
+      EvaluationKernel evaluation_kernel;
+
       /**
        * Stores the shape values of the 1D finite element evaluated on all 1D
        * quadrature points in vectorized format, i.e., as an array of
@@ -207,6 +275,20 @@ namespace internal
        */
       AlignedVector<Number> shape_hessians_collocation_eo;
 
+      /**
+       * For elements of type ElementType::tensor_symmetric_plus_bubbles, the
+       * bubble functions of FE_Q_Bubbles of tensor degree $p$ are given by
+       * $b_c(\mathbf x) = (2x_c-1)^{p-1} \prod_{d=0}^{dim-1} 4 x_d (1-x_d)$
+       * and are thus products of the one-dimensional factors $4x(1-x)$ in
+       * all directions but $c$ and $4x(1-x)(2x-1)^{p-1}$ in direction $c$.
+       * This field stores the values, first and second derivatives of the
+       * first factor (first three rows) and of the second factor (last
+       * three rows) evaluated on all 1D quadrature points, with the
+       * quadrature points running fastest. The length of this array is
+       * <tt>6 * n_q_points_1d</tt>.
+       */
+      AlignedVector<Number> bubble_factors;
+
       /**
        * Collects all data of 1D shape values evaluated at the point 0 and 1
        * (the vertices) in one data structure. Sorting is first the values,
@@ -242,7 +324,10 @@ namespace internal
       std::vector<unsigned int> lexicographic_numbering;
 
       /**
-       * Stores the degree of the element.
+       * Stores the degree of the element. For elements of type
+       * ElementType::tensor_symmetric_plus_bubbles, this is the degree of the
+       * underlying tensor product space, i.e., one less than the degree of
+       * the FE_Q_Bubbles element.
        */
       unsigned int fe_degree;
 
@@ -383,6 +468,7 @@ namespace internal
                                         const FiniteElement<dim> &fe_in,
                                         const unsigned int base_element_number)
       : element_type(tensor_general)
+      , evaluation_kernel(kernel_default)
       , fe_degree(0)
       , n_q_points_1d(0)
       , n_q_points(0)
@@ -19,17 +19,21 @@
 
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/polynomial.h>
+#include <deal.II/base/polynomials_p.h>
 #include <deal.II/base/polynomials_piecewise.h>
 #include <deal.II/base/tensor_product_polynomials.h>
 #include <deal.II/base/utilities.h>
 
 #include <deal.II/fe/fe_dgp.h>
+#include <deal.II/fe/fe_dgp_monomial.h>
 #include <deal.II/fe/fe_dgq.h>
 #include <deal.II/fe/fe_poly.h>
+#include <deal.II/fe/fe_q_bubbles.h>
 #include <deal.II/fe/fe_q_dg0.h>
 
 #include <deal.II/matrix_free/shape_info.h>
 
+#include <map>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -57,6 +61,7 @@ namespace internal
     template <typename Number>
     ShapeInfo<Number>::ShapeInfo()
       : element_type(tensor_general)
+      , evaluation_kernel(kernel_default)
       , fe_degree(numbers::invalid_unsigned_int)
       , n_q_points_1d(0)
       , n_q_points(0)
@@ -83,8 +88,6 @@ namespace internal
       fe_degree     = fe->degree;
       n_q_points_1d = quad.size();
 
-      const unsigned int n_dofs_1d = std::min(fe->dofs_per_cell, fe_degree + 1);
-
       // renumber (this is necessary for FE_Q, for example, since there the
       // vertex DoFs come first, which is incompatible with the lexicographic
       // ordering necessary to apply tensor products efficiently)
@@ -112,8 +115,14 @@ namespace internal
 
         const FE_DGP<dim> *fe_dgp = dynamic_cast<const FE_DGP<dim> *>(fe);
 
+        const FE_DGPMonomial<dim> *fe_dgp_monomial =
+          dynamic_cast<const FE_DGPMonomial<dim> *>(fe);
+
         const FE_Q_DG0<dim> *fe_q_dg0 = dynamic_cast<const FE_Q_DG0<dim> *>(fe);
 
+        const FE_Q_Bubbles<dim> *fe_q_bubbles =
+          dynamic_cast<const FE_Q_Bubbles<dim> *>(fe);
+
         element_type = tensor_general;
         if (fe_poly != nullptr)
           scalar_lexicographic = fe_poly->get_poly_space_numbering_inverse();
@@ -127,11 +136,44 @@ namespace internal
               scalar_lexicographic[i] = i;
             element_type = truncated_tensor;
           }
+        else if (fe_dgp_monomial != nullptr)
+          {
+            // the monomials of PolynomialsP are sorted by their total degree,
+            // so we need to find the position of each of them in the
+            // truncated tensor product
+            const PolynomialsP<dim> poly_space(fe_degree);
+            std::map<std::array<unsigned int, dim>, unsigned int>
+              truncated_index;
+            for (unsigned int i = 0; i < fe_dgp_monomial->dofs_per_cell; ++i)
+              {
+                const std::array<unsigned int, dim> degrees =
+                  poly_space.directional_degrees(i);
+                std::array<unsigned int, dim> reversed_degrees;
+                for (unsigned int d = 0; d < dim; ++d)
+                  reversed_degrees[d] = degrees[dim - 1 - d];
+                truncated_index[reversed_degrees] = i;
+              }
+            // the truncated tensor product runs fastest in x direction, i.e.,
+            // it is the lexicographic ordering of the reversed degrees
+            scalar_lexicographic.clear();
+            for (const auto &index : truncated_index)
+              scalar_lexicographic.push_back(index.second);
+            element_type = truncated_tensor;
+          }
         else if (fe_q_dg0 != nullptr)
           {
             scalar_lexicographic = fe_q_dg0->get_poly_space_numbering_inverse();
             element_type         = tensor_symmetric_plus_dg0;
           }
+        else if (fe_q_bubbles != nullptr)
+          {
+            scalar_lexicographic =
+              fe_q_bubbles->get_poly_space_numbering_inverse();
+            element_type = tensor_symmetric_plus_bubbles;
+            // the sum factorization kernels work on the tensor product part
+            // of the element
+            fe_degree = fe->degree - 1;
+          }
         else if (fe->dofs_per_cell == 0)
           {
             // FE_Nothing case -> nothing to do here
@@ -192,6 +234,8 @@ namespace internal
                                 fe->get_name()));
       }
 
+      const unsigned int n_dofs_1d = std::min(fe->dofs_per_cell, fe_degree + 1);
+
       n_q_points = Utilities::fixed_power<dim>(n_q_points_1d);
       n_q_points_face =
         dim > 1 ? Utilities::fixed_power<dim - 1>(n_q_points_1d) : 1;
@@ -333,9 +377,64 @@ namespace internal
                   element_type = tensor_symmetric;
             }
         }
-      else if (element_type == tensor_symmetric_plus_dg0)
+      else if (element_type == tensor_symmetric_plus_dg0 ||
+               element_type == tensor_symmetric_plus_bubbles)
         check_1d_shapes_symmetric(n_q_points_1d);
 
+      if (element_type == tensor_symmetric_plus_bubbles)
+        {
+          // values and derivatives of 4x(1-x) and 4x(1-x)(2x-1)^(p-1), see the
+          // definition of TensorProductPolynomialsBubbles
+          const unsigned int p = fe_degree;
+          bubble_factors.resize_fast(6 * n_q_points_1d);
+          for (unsigned int q = 0; q < n_q_points_1d; ++q)
+            {
+              const double x   = quad.point(q)[0];
+              const double h   = 4. * x * (1. - x);
+              const double dh  = 4. - 8. * x;
+              const double d2h = -8.;
+              const double s   = 2. * x - 1.;
+              const double sp  = std::pow(s, static_cast<int>(p) - 1);
+              const double dsp =
+                p > 1 ? 2. * (p - 1) * std::pow(s, static_cast<int>(p) - 2) :
+                        0.;
+              const double d2sp =
+                p > 2 ? 4. * (p - 1) * (p - 2) *
+                          std::pow(s, static_cast<int>(p) - 3) :
+                        0.;
+              bubble_factors[q]                     = h;
+              bubble_factors[n_q_points_1d + q]     = dh;
+              bubble_factors[2 * n_q_points_1d + q] = d2h;
+              bubble_factors[3 * n_q_points_1d + q] = h * sp;
+              bubble_factors[4 * n_q_points_1d + q] = dh * sp + h * dsp;
+              bubble_factors[5 * n_q_points_1d + q] =
+                d2h * sp + 2. * dh * dsp + h * d2sp;
+            }
+
+#ifdef DEBUG
+          // check the product representation against the element at an
+          // arbitrary point in the interior of the cell
+          const unsigned int n_tensor_dofs =
+            Utilities::fixed_power<dim>(fe_degree + 1);
+          Point<dim> point;
+          for (unsigned int d = 0; d < dim; ++d)
+            point[d] = 0.31 + 0.17 * d;
+          for (unsigned int c = n_tensor_dofs; c < fe->dofs_per_cell; ++c)
+            {
+              double value = 1.;
+              for (unsigned int d = 0; d < dim; ++d)
+                value *= 4. * point[d] * (1. - point[d]);
+              value *= std::pow(2. * point[c - n_tensor_dofs] - 1.,
+                                static_cast<int>(p) - 1);
+              Assert(std::abs(fe->shape_value(scalar_lexicographic[c], point) -
+                              value) < 1e-12,
+                     ExcInternalError("Could not decode the bubble functions "
+                                      "of the element " +
+                                      fe->get_name()));
+            }
+#endif
+        }
+
       nodal_at_cell_boundaries = true;
       for (unsigned int i = 1; i < n_dofs_1d; ++i)
         if (std::abs(get_first_array_element(shape_data_on_face[0][i])) >
@@ -575,6 +674,7 @@ namespace internal
         MemoryConsumption::memory_consumption(shape_gradients_collocation_eo);
       memory +=
         MemoryConsumption::memory_consumption(shape_hessians_collocation_eo);
+      memory += MemoryConsumption::memory_consumption(bubble_factors);
       for (unsigned int i = 0; i < 2; ++i)
         {
           memory +=
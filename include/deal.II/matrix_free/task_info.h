@@ -67,6 +67,16 @@ namespace internal
     virtual void
     zero_dst_vector_range(const unsigned int range_index) = 0;
 
+    /// Runs the operation to be done before the first access to the vector
+    /// entries of the given range as stored in DoFInfo
+    virtual void
+    cell_loop_pre_range(const unsigned int range_index) = 0;
+
+    /// Runs the operation to be done after the last access to the vector
+    /// entries of the given range as stored in DoFInfo
+    virtual void
+    cell_loop_post_range(const unsigned int range_index) = 0;
+
     /// Runs the cell work specified by MatrixFree::loop or
     /// MatrixFree::cell_loop
     virtual void
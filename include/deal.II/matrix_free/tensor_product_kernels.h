@@ -20,8 +20,11 @@
 #include <deal.II/base/config.h>
 
 #include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/tensor.h>
 #include <deal.II/base/utilities.h>
 
+#include <utility>
+
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -62,7 +65,14 @@ namespace internal
      * coefficient arrays. See the documentation of the EvaluatorTensorProduct
      * specialization for more information.
      */
-    evaluate_symmetric_hierarchical
+    evaluate_symmetric_hierarchical,
+    /**
+     * Evaluate polynomial spaces of complete degree that are described by a
+     * truncated tensor product, skipping the coefficients outside the
+     * truncated index set. See the documentation of the
+     * EvaluatorTensorProduct specialization for more information.
+     */
+    evaluate_truncated
   };
 
 
@@ -2185,6 +2195,338 @@ namespace internal
       }
   }
 
+
+
+  /**
+   * Internal evaluator for polynomial spaces of complete degree like FE_DGP,
+   * where the expansion coefficients in $d$ dimensions are a subset of the
+   * full tensor product, namely those with the sum of the one-dimensional
+   * indices not exceeding the degree (truncated tensor product). The data
+   * arrays are stored in the layout of the full tensor product, but only
+   * the entries within the truncated index set are read and written
+   * (collapsed sum factorization).
+   *
+   * The implementation assumes that the contractions are performed in
+   * ascending order of the direction when contracting over the rows
+   * (evaluation) and in descending order when contracting over the columns
+   * (integration), as done by FEEvaluationImpl. This means that the data
+   * passed to a contraction in a given direction is in the space of the
+   * coefficients for all higher directions, which allows to only process
+   * the one-dimensional stripes whose outer indices are within the
+   * truncated index set and to shorten the stripes along the contracted
+   * direction. Compared to the full tensor product, this saves a factor of
+   * $d!$ of the arithmetic operations in the contraction along direction
+   * zero, a factor $(d-1)!$ in direction one and so on.
+   *
+   * @tparam dim Space dimension in which this class is applied
+   * @tparam n_rows Number of rows in the transformation matrix, i.e., the
+   *                degree of the polynomial space plus one, or zero if the
+   *                size is passed to the constructor at run time
+   * @tparam n_columns Number of columns in the transformation matrix, i.e.,
+   *                   the number of 1d quadrature points, or zero if the
+   *                   size is passed to the constructor at run time
+   * @tparam Number Abstract number type for input and output arrays
+   * @tparam Number2 Abstract number type for coefficient arrays (defaults to
+   *                 same type as the input/output arrays); must implement
+   *                 operator* with Number and produce Number as an output to
+   *                 be a valid type
+   */
+  template <int dim,
+            int n_rows,
+            int n_columns,
+            typename Number,
+            typename Number2>
+  struct EvaluatorTensorProduct<evaluate_truncated,
+                                dim,
+                                n_rows,
+                                n_columns,
+                                Number,
+                                Number2>
+  {
+    static constexpr unsigned int n_rows_of_product =
+      n_rows > 0 ? Utilities::pow(n_rows, dim) : numbers::invalid_unsigned_int;
+    static constexpr unsigned int n_columns_of_product =
+      n_columns > 0 ? Utilities::pow(n_columns, dim) :
+                      numbers::invalid_unsigned_int;
+
+    /**
+     * Constructor, taking the data from ShapeInfo. The sizes @p n_rows_in
+     * and @p n_columns_in are only used in case the respective template
+     * arguments are zero.
+     */
+    EvaluatorTensorProduct(const AlignedVector<Number2> &shape_values,
+                           const AlignedVector<Number2> &shape_gradients,
+                           const AlignedVector<Number2> &shape_hessians,
+                           const unsigned int            n_rows_in,
+                           const unsigned int            n_columns_in)
+      : shape_values(shape_values.begin())
+      , shape_gradients(shape_gradients.begin())
+      , shape_hessians(shape_hessians.begin())
+      , n_rows_runtime(n_rows > 0 ? n_rows : n_rows_in)
+      , n_columns_runtime(n_columns > 0 ? n_columns : n_columns_in)
+    {
+      Assert(shape_values.size() == 0 ||
+               shape_values.size() == n_rows_runtime * n_columns_runtime,
+             ExcDimensionMismatch(shape_values.size(),
+                                  n_rows_runtime * n_columns_runtime));
+      Assert(shape_gradients.size() == 0 ||
+               shape_gradients.size() == n_rows_runtime * n_columns_runtime,
+             ExcDimensionMismatch(shape_gradients.size(),
+                                  n_rows_runtime * n_columns_runtime));
+      Assert(shape_hessians.size() == 0 ||
+               shape_hessians.size() == n_rows_runtime * n_columns_runtime,
+             ExcDimensionMismatch(shape_hessians.size(),
+                                  n_rows_runtime * n_columns_runtime));
+    }
+
+    template <int direction, bool contract_over_rows, bool add>
+    void
+    values(const Number *in, Number *out) const
+    {
+      apply<direction, contract_over_rows, add>(shape_values, in, out);
+    }
+
+    template <int direction, bool contract_over_rows, bool add>
+    void
+    gradients(const Number *in, Number *out) const
+    {
+      apply<direction, contract_over_rows, add>(shape_gradients, in, out);
+    }
+
+    template <int direction, bool contract_over_rows, bool add>
+    void
+    hessians(const Number *in, Number *out) const
+    {
+      apply<direction, contract_over_rows, add>(shape_hessians, in, out);
+    }
+
+    /**
+     * This function applies the tensor product kernel along the given @p
+     * direction of the tensor data in the input array, restricted to the
+     * truncated index set. Entries of the output array outside the truncated
+     * index set are left untouched. In-place operation is supported for the
+     * case n_rows == n_columns.
+     *
+     * @tparam direction Direction that is evaluated
+     * @tparam contract_over_rows If true, the tensor contraction sums
+     *                            over the rows in the given @p shape_data
+     *                            array, otherwise it sums over the columns
+     * @tparam add If true, the result is added to the output vector, else
+     *             the computed values overwrite the content in the output
+     *
+     * @param shape_data Transformation matrix with @p n_rows rows and
+     *                   @p n_columns columns, stored in row-major format
+     * @param in Pointer to the start of the input data vector
+     * @param out Pointer to the start of the output data vector
+     */
+    template <int direction, bool contract_over_rows, bool add>
+    void
+    apply(const Number2 *DEAL_II_RESTRICT shape_data,
+          const Number *                  in,
+          Number *                        out) const;
+
+    const Number2 *    shape_values;
+    const Number2 *    shape_gradients;
+    const Number2 *    shape_hessians;
+    const unsigned int n_rows_runtime;
+    const unsigned int n_columns_runtime;
+  };
+
+
+
+  template <int dim,
+            int n_rows,
+            int n_columns,
+            typename Number,
+            typename Number2>
+  template <int direction, bool contract_over_rows, bool add>
+  inline void
+  EvaluatorTensorProduct<evaluate_truncated,
+                         dim,
+                         n_rows,
+                         n_columns,
+                         Number,
+                         Number2>::apply(const Number2 *DEAL_II_RESTRICT
+                                                        shape_data,
+                                         const Number * in,
+                                         Number *       out) const
+  {
+    Assert(shape_data != nullptr,
+           ExcMessage(
+             "The given array shape_data must not be the null pointer!"));
+    AssertIndexRange(direction, dim);
+
+    // use the compile-time sizes where available to let the compiler unroll
+    // the loops
+    const int n_r = n_rows > 0 ? n_rows : n_rows_runtime;
+    const int n_c = n_columns > 0 ? n_columns : n_columns_runtime;
+    Assert(dim == direction + 1 || n_r == n_c || in != out,
+           ExcMessage("In-place operation only supported for "
+                      "n_rows==n_columns"));
+    constexpr int max_size =
+      (n_rows > 0 && n_columns > 0) ?
+        (n_rows > n_columns ? n_rows : n_columns) :
+        129;
+    Assert(n_r <= max_size && n_c <= max_size, ExcNotImplemented());
+
+    const int mm = contract_over_rows ? n_r : n_c,
+              nn = contract_over_rows ? n_c : n_r;
+
+    const int stride =
+      direction == 0 ? 1 : Utilities::fixed_power<direction>(n_c);
+    const int n_blocks2 =
+      direction >= dim - 1 ? 1 :
+                             Utilities::fixed_power<dim - direction - 1>(n_r);
+
+    for (int i2 = 0; i2 < n_blocks2; ++i2)
+      {
+        // the outer indices are coefficient indices, so the sum of them
+        // determines the length of the stripe in the truncated index set
+        int index_sum = 0;
+        for (int i = i2; i > 0; i /= n_r)
+          index_sum += i % n_r;
+        const int n_truncated = n_r - index_sum;
+
+        if (n_truncated > 0)
+          {
+            const int m_active = contract_over_rows ? n_truncated : mm;
+            const int n_active = contract_over_rows ? nn : n_truncated;
+            for (int i1 = 0; i1 < stride; ++i1)
+              {
+                Number x[max_size];
+                for (int i = 0; i < m_active; ++i)
+                  x[i] = in[stride * i];
+                for (int col = 0; col < n_active; ++col)
+                  {
+                    Number2 val0;
+                    if (contract_over_rows == true)
+                      val0 = shape_data[col];
+                    else
+                      val0 = shape_data[col * n_c];
+                    Number res0 = val0 * x[0];
+                    for (int i = 1; i < m_active; ++i)
+                      {
+                        if (contract_over_rows == true)
+                          val0 = shape_data[i * n_c + col];
+                        else
+                          val0 = shape_data[col * n_c + i];
+                        res0 += val0 * x[i];
+                      }
+                    if (add == false)
+                      out[stride * col] = res0;
+                    else
+                      out[stride * col] += res0;
+                  }
+                ++in;
+                ++out;
+              }
+            in += stride * (mm - 1);
+            out += stride * (nn - 1);
+          }
+        else
+          {
+            in += stride * mm;
+            out += stride * nn;
+          }
+      }
+  }
+
+
+
+  /**
+   * Evaluate a function given as a tensor product expansion
+   * $u(\mathbf{x}) = \sum_{i} \varphi_{i_0}(x_0) \cdots
+   * \varphi_{i_{d-1}}(x_{d-1}) u_i$ and its gradient with respect to the
+   * coordinates $\mathbf{x}$ at a single point, given the values and first
+   * derivatives of the one-dimensional shape functions $\varphi_j$ in each
+   * coordinate direction of that point. As opposed to the evaluation at the
+   * tensor product quadrature points done by the EvaluatorTensorProduct
+   * classes, the point is arbitrary, so the sum over the coefficients is
+   * factorized dimension by dimension but involves all $n^d$ coefficients.
+   *
+   * The function is typically called with @p Number2 set to a
+   * VectorizedArray type, in which case the expansion is evaluated at
+   * several points at once, one per lane of the vectorized array.
+   *
+   * @param n_shapes The number of one-dimensional shape functions $n$.
+   * @param shape_values The values of the one-dimensional shape functions,
+   *   with the value of function $j$ in direction $d$ at position
+   *   <code>d * n_shapes + j</code>.
+   * @param shape_derivatives The first derivatives of the one-dimensional
+   *   shape functions, in the same layout as @p shape_values.
+   * @param coefficients The $n^d$ coefficients $u_i$ in lexicographic
+   *   order, i.e., with the index in direction 0 running fastest.
+   *
+   * @return A pair containing the value and the gradient of the expansion.
+   */
+  template <int dim, typename Number, typename Number2>
+  inline std::pair<Number2, Tensor<1, dim, Number2>>
+  evaluate_tensor_product_value_and_gradient(
+    const unsigned int             n_shapes,
+    const Number2 *DEAL_II_RESTRICT shape_values,
+    const Number2 *DEAL_II_RESTRICT shape_derivatives,
+    const Number *                  coefficients)
+  {
+    static_assert(dim >= 1 && dim <= 3, "Only dim=1,2,3 implemented");
+
+    const unsigned int n1 = dim > 1 ? n_shapes : 1;
+    const unsigned int n2 = dim > 2 ? n_shapes : 1;
+
+    Number2                 value = Number2();
+    Tensor<1, dim, Number2> gradient;
+    for (unsigned int i2 = 0; i2 < n2; ++i2)
+      {
+        // the value and the derivatives in directions 0 and 1 of the
+        // expansion restricted to the plane i2
+        Number2 value_2d = Number2(), deriv_2d_0 = Number2(),
+                deriv_2d_1 = Number2();
+        for (unsigned int i1 = 0; i1 < n1; ++i1)
+          {
+            const Number *line = coefficients + (i2 * n1 + i1) * n_shapes;
+
+            Number2 value_1d = Number2(), deriv_1d = Number2();
+            for (unsigned int i0 = 0; i0 < n_shapes; ++i0)
+              {
+                value_1d += shape_values[i0] * line[i0];
+                deriv_1d += shape_derivatives[i0] * line[i0];
+              }
+
+            if (dim > 1)
+              {
+                const Number2 phi_1  = shape_values[n_shapes + i1];
+                const Number2 dphi_1 = shape_derivatives[n_shapes + i1];
+                value_2d += phi_1 * value_1d;
+                deriv_2d_0 += phi_1 * deriv_1d;
+                deriv_2d_1 += dphi_1 * value_1d;
+              }
+            else
+              {
+                value_2d   = value_1d;
+                deriv_2d_0 = deriv_1d;
+              }
+          }
+
+        if (dim > 2)
+          {
+            const Number2 phi_2  = shape_values[2 * n_shapes + i2];
+            const Number2 dphi_2 = shape_derivatives[2 * n_shapes + i2];
+            value += phi_2 * value_2d;
+            gradient[0] += phi_2 * deriv_2d_0;
+            gradient[dim > 1 ? 1 : 0] += phi_2 * deriv_2d_1;
+            gradient[dim - 1] += dphi_2 * value_2d;
+          }
+        else
+          {
+            value       = value_2d;
+            gradient[0] = deriv_2d_0;
+            if (dim > 1)
+              gradient[dim > 1 ? 1 : 0] = deriv_2d_1;
+          }
+      }
+
+    return std::make_pair(value, gradient);
+  }
+
 } // end of namespace internal
 
 
@@ -0,0 +1,505 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_matrix_free_tools_h
+#define dealii_matrix_free_tools_h
+
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/table.h>
+#include <deal.II/base/template_constraints.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/**
+ * A namespace for utility functions in the context of matrix-free operator
+ * evaluation that derive matrix entries of an operator from its cell-wise
+ * action.
+ *
+ * The operator is given by a function @p local_vmult that gets an
+ * FEEvaluation object whose degrees of freedom, accessible through
+ * FEEvaluation::begin_dof_values(), hold the input vector on a batch of
+ * cells. The function applies the cell integral in place, i.e., it calls
+ * FEEvaluation::evaluate(), the operation at the quadrature points and
+ * FEEvaluation::integrate(), but neither FEEvaluation::reinit() nor
+ * FEEvaluation::read_dof_values() and
+ * FEEvaluation::distribute_local_to_global(). In step-37, the content of
+ * the loop over cells in `LaplaceOperator::local_apply()` between these
+ * calls is such a function.
+ *
+ * @ingroup matrixfree
+ */
+namespace MatrixFreeTools
+{
+  /**
+   * Compute the diagonal of the linear operator defined by @p local_vmult on
+   * the cells of @p matrix_free, and store it in @p diagonal_global.
+   *
+   * The diagonal is computed by applying the operator to the local basis
+   * vectors of the constrained space on each cell, using the same sum
+   * factorization kernels as the operator evaluation. Hanging node and
+   * periodicity constraints stored in @p matrix_free are taken into account
+   * through the constraint weights of the DoFInfo object, i.e., the result
+   * is the diagonal of $C^T A C$ with the constraint matrix $C$ and the
+   * unconstrained operator $A$. The entries of constrained degrees of
+   * freedom are set to one, as done by MatrixFreeOperators::Base. The
+   * computation runs in the cell loop of @p matrix_free and thus uses the
+   * same thread parallelization as the operator evaluation. Since
+   * MatrixFree objects on multigrid levels hold the constraints of that
+   * level, the function works for level operators as well.
+   *
+   * The vector @p diagonal_global is initialized by this function. The
+   * template arguments up to @p Number can not be deduced from the arguments
+   * and must be specified explicitly, whereas @p VectorizedArrayType is
+   * deduced from @p matrix_free. This allows to pass a function template
+   * such as `&local_vmult<dim, fe_degree>` as @p local_vmult.
+   *
+   * @note Only cell integrals are considered. Operators with face integrals
+   * such as the interior penalty method need to add their contribution
+   * separately. Vector-valued operators are supported for finite elements
+   * where all @p n_components components are contained in the DoFHandler
+   * described by @p dof_no.
+   */
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename VectorType>
+  void
+  compute_diagonal(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    VectorType &                                        diagonal_global,
+    const typename identity<std::function<void(FEEvaluation<dim,
+                                                            fe_degree,
+                                                            n_q_points_1d,
+                                                            n_components,
+                                                            Number,
+                                                            VectorizedArrayType>
+                                                 &)>>::type &local_vmult,
+    const unsigned int dof_no                   = 0,
+    const unsigned int quad_no                  = 0,
+    const unsigned int first_selected_component = 0);
+
+  /**
+   * Same as above, but with the cell operation given as a member function
+   * @p cell_operation of the class @p owning_class. In this case, all
+   * template arguments are deduced from the function arguments.
+   */
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename VectorType,
+            typename CLASS>
+  void
+  compute_diagonal(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    VectorType &                                        diagonal_global,
+    void (CLASS::*cell_operation)(FEEvaluation<dim,
+                                               fe_degree,
+                                               n_q_points_1d,
+                                               n_components,
+                                               Number,
+                                               VectorizedArrayType> &) const,
+    const CLASS *      owning_class,
+    const unsigned int dof_no                   = 0,
+    const unsigned int quad_no                  = 0,
+    const unsigned int first_selected_component = 0);
+
+  /**
+   * Compute the cell matrices of the linear operator defined by @p
+   * local_vmult, i.e., the blocks of a cell-wise block-diagonal
+   * approximation of the operator, for example for a block-Jacobi method
+   * with discontinuous elements. The matrices are computed by applying the
+   * operator to the unit vectors of each cell, interleaved over the cells
+   * of a batch in the same way as the data of FEEvaluation. They are stored
+   * in @p cell_matrices with the index `(cell_batch, i, j)` for the
+   * matrix entry in row @p i and column @p j, using the numbering of the
+   * degrees of freedom within FEEvaluation::begin_dof_values(). The
+   * constraints are not applied to the cell matrices.
+   *
+   * The table @p cell_matrices is resized by this function. The template
+   * arguments up to @p Number can not be deduced from the arguments and must
+   * be specified explicitly.
+   */
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType>
+  void
+  compute_cell_matrices(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    Table<3, VectorizedArrayType> &                     cell_matrices,
+    const typename identity<std::function<void(FEEvaluation<dim,
+                                                            fe_degree,
+                                                            n_q_points_1d,
+                                                            n_components,
+                                                            Number,
+                                                            VectorizedArrayType>
+                                                 &)>>::type &local_vmult,
+    const unsigned int dof_no                   = 0,
+    const unsigned int quad_no                  = 0,
+    const unsigned int first_selected_component = 0);
+
+
+
+  // ------------------------------- implementation ---------------------------
+
+#ifndef DOXYGEN
+
+  namespace internal
+  {
+    /**
+     * Extract the columns of the constraint matrix restricted to a cell,
+     * i.e., for each index of the local vector space the unconstrained
+     * local degrees of freedom together with the weights by which the
+     * global degree of freedom enters into them. The columns are sorted by
+     * the index of the global degree of freedom.
+     */
+    template <int dim, typename Number, typename VectorizedArrayType>
+    void
+    extract_constrained_columns(
+      const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+      const unsigned int                                  dof_no,
+      const unsigned int                                  first_component,
+      const unsigned int                                  n_components,
+      const unsigned int                                  dofs_per_component,
+      const unsigned int                                  cell_index,
+      std::vector<unsigned int> &                         column_indices,
+      std::vector<std::vector<std::pair<unsigned int, Number>>> &columns)
+    {
+      const dealii::internal::MatrixFreeFunctions::DoFInfo &dof_info =
+        matrix_free.get_dof_info(dof_no);
+      const unsigned int n_fe_components = dof_info.start_components.back();
+
+      std::vector<std::tuple<unsigned int, unsigned int, Number>> entries;
+      entries.reserve(n_components * dofs_per_component);
+      for (unsigned int comp = 0; comp < n_components; ++comp)
+        {
+          const unsigned int row =
+            cell_index * n_fe_components + first_component + comp;
+          const unsigned int *dof_indices =
+            dof_info.dof_indices.data() + dof_info.row_starts[row].first;
+          unsigned int       index_indicators = dof_info.row_starts[row].second;
+          const unsigned int next_index_indicators =
+            dof_info.row_starts[row + 1].second;
+          const unsigned int offset    = comp * dofs_per_component;
+          unsigned int       ind_local = 0;
+          for (; index_indicators != next_index_indicators; ++index_indicators)
+            {
+              const std::pair<unsigned short, unsigned short> indicator =
+                dof_info.constraint_indicator[index_indicators];
+              for (unsigned int j = 0; j < indicator.first;
+                   ++j, ++ind_local, ++dof_indices)
+                entries.emplace_back(*dof_indices,
+                                     offset + ind_local,
+                                     Number(1.));
+
+              const Number *data_val =
+                matrix_free.constraint_pool_begin(indicator.second);
+              const Number *end_pool =
+                matrix_free.constraint_pool_end(indicator.second);
+              for (; data_val != end_pool; ++data_val, ++dof_indices)
+                entries.emplace_back(*dof_indices,
+                                     offset + ind_local,
+                                     *data_val);
+              ++ind_local;
+            }
+
+          AssertIndexRange(ind_local, dofs_per_component + 1);
+          for (; ind_local < dofs_per_component; ++ind_local, ++dof_indices)
+            entries.emplace_back(*dof_indices, offset + ind_local, Number(1.));
+        }
+
+      std::sort(entries.begin(), entries.end());
+
+      column_indices.clear();
+      columns.clear();
+      for (const auto &entry : entries)
+        {
+          if (column_indices.empty() ||
+              column_indices.back() != std::get<0>(entry))
+            {
+              column_indices.push_back(std::get<0>(entry));
+              columns.emplace_back();
+            }
+          columns.back().emplace_back(std::get<1>(entry), std::get<2>(entry));
+        }
+    }
+  } // namespace internal
+
+
+
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename VectorType>
+  void
+  compute_diagonal(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    VectorType &                                        diagonal_global,
+    const typename identity<std::function<void(FEEvaluation<dim,
+                                                            fe_degree,
+                                                            n_q_points_1d,
+                                                            n_components,
+                                                            Number,
+                                                            VectorizedArrayType>
+                                                 &)>>::type &local_vmult,
+    const unsigned int dof_no,
+    const unsigned int quad_no,
+    const unsigned int first_selected_component)
+  {
+    using FEEvalType = FEEvaluation<dim,
+                                    fe_degree,
+                                    n_q_points_1d,
+                                    n_components,
+                                    Number,
+                                    VectorizedArrayType>;
+    constexpr unsigned int n_lanes = VectorizedArrayType::n_array_elements;
+
+    const dealii::internal::MatrixFreeFunctions::DoFInfo &dof_info =
+      matrix_free.get_dof_info(dof_no);
+    (void)dof_info;
+    Assert(dof_info.dofs_per_cell.size() == 1,
+           ExcNotImplemented("The computation of the diagonal is not "
+                             "implemented for hp elements."));
+    Assert(dof_info.start_components.back() >=
+             first_selected_component + n_components,
+           ExcNotImplemented("The computation of the diagonal requires all "
+                             "components of FEEvaluation to be part of the "
+                             "same finite element."));
+
+    matrix_free.initialize_dof_vector(diagonal_global, dof_no);
+
+    const auto cell_operation =
+      [&](const MatrixFree<dim, Number, VectorizedArrayType> &data,
+          VectorType &                                        diagonal,
+          const unsigned int &,
+          const std::pair<unsigned int, unsigned int> &cell_range) {
+        FEEvalType phi(data, dof_no, quad_no, first_selected_component);
+
+        std::vector<unsigned int> column_indices[n_lanes];
+        std::vector<std::vector<std::pair<unsigned int, Number>>>
+          columns[n_lanes];
+
+        for (unsigned int cell = cell_range.first; cell < cell_range.second;
+             ++cell)
+          {
+            phi.reinit(cell);
+            const unsigned int n_filled = data.n_components_filled(cell);
+
+            unsigned int n_columns = 0;
+            for (unsigned int v = 0; v < n_filled; ++v)
+              {
+                internal::extract_constrained_columns(
+                  data,
+                  dof_no,
+                  first_selected_component,
+                  n_components,
+                  phi.dofs_per_component,
+                  cell * n_lanes + v,
+                  column_indices[v],
+                  columns[v]);
+                n_columns = std::max<unsigned int>(n_columns,
+                                                   column_indices[v].size());
+              }
+
+            // apply the operator to one column of the constraint matrix per
+            // lane at a time and extract the diagonal entry as the product
+            // with the same column
+            for (unsigned int j = 0; j < n_columns; ++j)
+              {
+                for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+                  phi.begin_dof_values()[i] = VectorizedArrayType();
+                for (unsigned int v = 0; v < n_filled; ++v)
+                  if (j < columns[v].size())
+                    for (const auto &entry : columns[v][j])
+                      phi.begin_dof_values()[entry.first][v] = entry.second;
+
+                local_vmult(phi);
+
+                for (unsigned int v = 0; v < n_filled; ++v)
+                  if (j < columns[v].size())
+                    {
+                      Number diagonal_entry = 0;
+                      for (const auto &entry : columns[v][j])
+                        diagonal_entry +=
+                          entry.second * phi.begin_dof_values()[entry.first][v];
+                      dealii::internal::vector_access(diagonal,
+                                                      column_indices[v][j]) +=
+                        diagonal_entry;
+                    }
+              }
+          }
+      };
+
+    unsigned int dummy = 0;
+    matrix_free.template cell_loop<VectorType, unsigned int>(cell_operation,
+                                                             diagonal_global,
+                                                             dummy);
+
+    for (const unsigned int i : matrix_free.get_constrained_dofs(dof_no))
+      dealii::internal::vector_access(diagonal_global, i) = Number(1.);
+  }
+
+
+
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType,
+            typename VectorType,
+            typename CLASS>
+  void
+  compute_diagonal(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    VectorType &                                        diagonal_global,
+    void (CLASS::*cell_operation)(FEEvaluation<dim,
+                                               fe_degree,
+                                               n_q_points_1d,
+                                               n_components,
+                                               Number,
+                                               VectorizedArrayType> &) const,
+    const CLASS *      owning_class,
+    const unsigned int dof_no,
+    const unsigned int quad_no,
+    const unsigned int first_selected_component)
+  {
+    compute_diagonal<dim,
+                     fe_degree,
+                     n_q_points_1d,
+                     n_components,
+                     Number,
+                     VectorizedArrayType,
+                     VectorType>(
+      matrix_free,
+      diagonal_global,
+      [&](FEEvaluation<dim,
+                       fe_degree,
+                       n_q_points_1d,
+                       n_components,
+                       Number,
+                       VectorizedArrayType> &phi) {
+        (owning_class->*cell_operation)(phi);
+      },
+      dof_no,
+      quad_no,
+      first_selected_component);
+  }
+
+
+
+  template <int dim,
+            int fe_degree,
+            int n_q_points_1d,
+            int n_components,
+            typename Number,
+            typename VectorizedArrayType>
+  void
+  compute_cell_matrices(
+    const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+    Table<3, VectorizedArrayType> &                     cell_matrices,
+    const typename identity<std::function<void(FEEvaluation<dim,
+                                                            fe_degree,
+                                                            n_q_points_1d,
+                                                            n_components,
+                                                            Number,
+                                                            VectorizedArrayType>
+                                                 &)>>::type &local_vmult,
+    const unsigned int dof_no,
+    const unsigned int quad_no,
+    const unsigned int first_selected_component)
+  {
+    using FEEvalType = FEEvaluation<dim,
+                                    fe_degree,
+                                    n_q_points_1d,
+                                    n_components,
+                                    Number,
+                                    VectorizedArrayType>;
+
+    Assert(matrix_free.get_dof_info(dof_no).dofs_per_cell.size() == 1,
+           ExcNotImplemented("The computation of cell matrices is not "
+                             "implemented for hp elements."));
+
+    {
+      FEEvalType phi(matrix_free, dof_no, quad_no, first_selected_component);
+      cell_matrices.reinit(TableIndices<3>(matrix_free.n_macro_cells(),
+                                           phi.dofs_per_cell,
+                                           phi.dofs_per_cell));
+    }
+
+    const auto cell_operation =
+      [&](const MatrixFree<dim, Number, VectorizedArrayType> &data,
+          unsigned int &,
+          const unsigned int &,
+          const std::pair<unsigned int, unsigned int> &cell_range) {
+        FEEvalType phi(data, dof_no, quad_no, first_selected_component);
+        for (unsigned int cell = cell_range.first; cell < cell_range.second;
+             ++cell)
+          {
+            phi.reinit(cell);
+            for (unsigned int j = 0; j < phi.dofs_per_cell; ++j)
+              {
+                for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+                  phi.begin_dof_values()[i] = VectorizedArrayType();
+                phi.begin_dof_values()[j] = Number(1.);
+
+                local_vmult(phi);
+
+                for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+                  cell_matrices(cell, i, j) = phi.begin_dof_values()[i];
+              }
+          }
+      };
+
+    unsigned int dummy = 0;
+    matrix_free.template cell_loop<unsigned int, unsigned int>(cell_operation,
+                                                               dummy,
+                                                               dummy);
+  }
+
+#endif // DOXYGEN
+
+} // namespace MatrixFreeTools
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+
+#endif
@@ -0,0 +1,253 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mg_coarse_scalapack_h
+#define dealii_mg_coarse_scalapack_h
+
+
+#include <deal.II/base/config.h>
+
+#ifdef DEAL_II_WITH_SCALAPACK
+
+#  include <deal.II/base/partitioner.h>
+#  include <deal.II/base/process_grid.h>
+
+#  include <deal.II/lac/la_parallel_vector.h>
+#  include <deal.II/lac/scalapack.h>
+
+#  include <deal.II/multigrid/mg_base.h>
+
+#  include <limits>
+#  include <memory>
+#  include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup mg */
+/*@{*/
+
+/**
+ * Direct coarse grid solver for coarse levels that are distributed over
+ * many MPI processes, based on the dense linear algebra of ScaLAPACKMatrix
+ * and thus available without the PETSc or Trilinos wrappers.
+ *
+ * Upon initialization, the coarse matrix is extracted from an arbitrary
+ * operator providing a <tt>vmult()</tt> function by multiplication with
+ * unit vectors. Each process sends the entries of its locally owned rows
+ * directly to the processes that own them in the block-cyclic distribution
+ * of a ScaLAPACKMatrix. The process grid is chosen by
+ * Utilities::MPI::ProcessGrid according to the size of the matrix and the
+ * block size, so small coarse problems only involve a subset of the
+ * processes. There, the matrix is factorized once, using a Cholesky
+ * factorization for symmetric matrices and an LU factorization otherwise,
+ * and the factors are kept.
+ *
+ * Each application of operator() sends the entries of the right hand side
+ * to the processes of the first column of the process grid, which hold the
+ * right hand side in the block-cyclic distribution, solves with the factors
+ * on the process grid by ScaLAPACK's triangular solves, and sends the
+ * entries of the solution back to the owners of the respective vector
+ * entries.
+ *
+ * Every process of the grid stores its share of the dense factors, i.e.,
+ * about $n^2/P$ numbers for $n$ unknowns and a grid of $P$ processes. Thus,
+ * this class is meant for coarse problems with up to a few ten thousand
+ * unknowns. Constrained degrees of freedom must be represented by identity
+ * rows in the operator, as done by the operators in MatrixFreeOperators.
+ */
+template <typename Number>
+class MGCoarseGridScaLAPACK
+  : public MGCoarseGridBase<LinearAlgebra::distributed::Vector<Number>>
+{
+public:
+  /**
+   * The vector type this class operates on.
+   */
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+
+  /**
+   * Collection of settings for the factorization.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData(const bool         symmetric  = true,
+                   const unsigned int block_size = 32);
+
+    /**
+     * Whether the coarse matrix is symmetric and positive definite, in which
+     * case a Cholesky factorization is used. Otherwise, an LU factorization
+     * is computed.
+     */
+    bool symmetric;
+
+    /**
+     * The block size of the block-cyclic distribution of the matrix onto
+     * the process grid.
+     */
+    unsigned int block_size;
+  };
+
+  /**
+   * Constructor leaving an uninitialized object.
+   */
+  MGCoarseGridScaLAPACK() = default;
+
+  /**
+   * Extract the matrix of the operator @p matrix for vectors with the
+   * layout given by @p partitioner, and factorize it. The operator is not
+   * referenced after this call.
+   */
+  template <typename MatrixType>
+  void
+  initialize(
+    const MatrixType &                                        matrix,
+    const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+    const AdditionalData &additional_data = AdditionalData());
+
+  /**
+   * Release all memory.
+   */
+  void
+  clear();
+
+  /**
+   * Apply the inverse of the coarse matrix to @p src.
+   */
+  virtual void
+  operator()(const unsigned int level,
+             VectorType &       dst,
+             const VectorType & src) const override;
+
+  /**
+   * Memory used by this object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+private:
+  /**
+   * Distribute the locally owned rows of the matrix, given as a dense
+   * row-major array, onto the process grid and factorize the matrix there.
+   * Also set up the communication pattern of the vectors in operator().
+   */
+  void
+  compute_factorization(const std::vector<Number> &local_rows,
+                        const AdditionalData &     additional_data);
+
+  /**
+   * The layout of the coarse level vectors.
+   */
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
+
+  /**
+   * The Cholesky or LU factors of the coarse matrix on the process grid.
+   */
+  std::unique_ptr<ScaLAPACKMatrix<Number>> factorization;
+
+  /**
+   * The right hand side and solution of operator(), distributed over the
+   * first column of the process grid.
+   */
+  mutable std::unique_ptr<ScaLAPACKMatrix<Number>> grid_vector;
+
+  /**
+   * The locally owned vector entries, given as local indices, in the order
+   * they are sent to the processes of the grid, grouped by the receiving
+   * process.
+   */
+  std::vector<unsigned int> send_indices;
+
+  /**
+   * The number of vector entries sent to each process.
+   */
+  std::vector<int> send_counts;
+
+  /**
+   * The offsets of the entries sent to each process in #send_indices.
+   */
+  std::vector<int> send_displacements;
+
+  /**
+   * The local rows of #grid_vector in the order in which the vector entries
+   * are received from the other processes.
+   */
+  std::vector<unsigned int> receive_rows;
+
+  /**
+   * The number of vector entries received from each process.
+   */
+  std::vector<int> receive_counts;
+
+  /**
+   * The offsets of the entries received from each process in
+   * #receive_rows.
+   */
+  std::vector<int> receive_displacements;
+
+  /**
+   * Buffers for the entries sent and received in operator().
+   */
+  mutable std::vector<Number> send_buffer, receive_buffer;
+};
+
+/*@}*/
+
+#  ifndef DOXYGEN
+/* ------------------ Functions for MGCoarseGridScaLAPACK -------------- */
+
+template <typename Number>
+template <typename MatrixType>
+void
+MGCoarseGridScaLAPACK<Number>::initialize(
+  const MatrixType &                                        matrix,
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+  const AdditionalData &                                    additional_data)
+{
+  this->partitioner = partitioner;
+
+  const types::global_dof_index n       = partitioner->size();
+  const unsigned int            n_local = partitioner->local_size();
+  AssertThrow(static_cast<std::size_t>(n) * n <
+                static_cast<std::size_t>(std::numeric_limits<int>::max()),
+              ExcMessage("The coarse matrix is too large to be stored as "
+                         "a dense matrix."));
+
+  // extract the locally owned rows of the matrix column by column through
+  // products with unit vectors
+  std::vector<Number> local_rows(static_cast<std::size_t>(n_local) * n);
+  VectorType          unit_vector(partitioner), column(partitioner);
+  for (types::global_dof_index j = 0; j < n; ++j)
+    {
+      unit_vector = 0.;
+      if (partitioner->in_local_range(j))
+        unit_vector(j) = 1.;
+      matrix.vmult(column, unit_vector);
+      for (unsigned int i = 0; i < n_local; ++i)
+        local_rows[i * n + j] = column.local_element(i);
+    }
+
+  compute_factorization(local_rows, additional_data);
+}
+
+#  endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // DEAL_II_WITH_SCALAPACK
+
+#endif
@@ -18,7 +18,10 @@
 
 #include <deal.II/base/config.h>
 
+#include <deal.II/base/std_cxx14/memory.h>
 #include <deal.II/base/subscriptor.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/base/timer.h>
 
 #include <deal.II/lac/affine_constraints.h>
 
@@ -61,10 +64,19 @@ public:
    * not support rotation matrices in the periodicity definition, i.e., the
    * respective argument in the GridTools::collect_periodic_faces() may not
    * be different from the identity matrix.
+   *
+   * The cells of all levels are worked on in parallel, with separate output
+   * buffers for chunks of cells that are merged once per level, and the
+   * levels are set up by independent tasks. If a TimerOutput object is
+   * given as @p timer_output, the time spent in the setup of the level
+   * constraints and of the refinement edge indices is recorded in the
+   * sections "MG setup: level constraints" and "MG setup: refinement edge
+   * dofs", respectively.
    */
   template <int dim, int spacedim>
   void
-  initialize(const DoFHandler<dim, spacedim> &dof);
+  initialize(const DoFHandler<dim, spacedim> &dof,
+             TimerOutput *                    timer_output = nullptr);
 
   /**
    * Fill the internal data structures with values extracted from the dof
@@ -92,13 +104,17 @@ public:
    *
    * This function can be called multiple times to allow considering
    * different sets of boundary_ids for different components.
+   *
+   * If a TimerOutput object is given as @p timer_output, the time spent in
+   * this function is recorded in the section "MG setup: boundary dofs".
    */
   template <int dim, int spacedim>
   void
   make_zero_boundary_constraints(
     const DoFHandler<dim, spacedim> &   dof,
     const std::set<types::boundary_id> &boundary_ids,
-    const ComponentMask &               component_mask = ComponentMask());
+    const ComponentMask &               component_mask = ComponentMask(),
+    TimerOutput *                       timer_output   = nullptr);
 
   /**
    * Fill the internal data structures with information
@@ -215,7 +231,8 @@ private:
 
 template <int dim, int spacedim>
 inline void
-MGConstrainedDoFs::initialize(const DoFHandler<dim, spacedim> &dof)
+MGConstrainedDoFs::initialize(const DoFHandler<dim, spacedim> &dof,
+                              TimerOutput *                    timer_output)
 {
   boundary_indices.clear();
   refinement_edge_indices.clear();
@@ -226,75 +243,114 @@ MGConstrainedDoFs::initialize(const DoFHandler<dim, spacedim> &dof)
   // At this point level_constraint and refinement_edge_indices are empty.
   level_constraints.resize(nlevels);
   refinement_edge_indices.resize(nlevels);
-  for (unsigned int l = 0; l < nlevels; ++l)
-    {
+
+  {
+    std::unique_ptr<TimerOutput::Scope> scope;
+    if (timer_output != nullptr)
+      scope = std_cxx14::make_unique<TimerOutput::Scope>(
+        *timer_output, "MG setup: level constraints");
+
+    // The search for periodic neighbors visits all faces of all level cells,
+    // so skip it if the triangulation does not have any periodic faces
+    const bool have_periodic_faces =
+      !dof.get_triangulation().get_periodic_face_map().empty();
+
+    // Find the pairs of dofs on periodic faces. The cells of all levels are
+    // worked on in parallel, and the pairs are returned in the order of the
+    // cells, so that the constraints entered below do not depend on the
+    // number of threads
+    std::vector<
+      std::vector<std::pair<types::global_dof_index, types::global_dof_index>>>
+      periodic_dofs;
+    if (have_periodic_faces)
+      periodic_dofs = internal::MGToolsImplementation::collect_on_level_cells<
+        std::pair<types::global_dof_index, types::global_dof_index>>(
+        dof,
+        0,
+        [](const typename DoFHandler<dim, spacedim>::level_cell_iterator &cell,
+           std::vector<std::pair<types::global_dof_index,
+                                 types::global_dof_index>> &dof_pairs) {
+          if (cell->level_subdomain_id() == numbers::artificial_subdomain_id)
+            return;
+
+          for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+            if (cell->has_periodic_neighbor(f) &&
+                cell->periodic_neighbor(f)->level() == cell->level())
+              {
+                if (cell->is_locally_owned_on_level())
+                  {
+                    Assert(
+                      cell->periodic_neighbor(f)->level_subdomain_id() !=
+                        numbers::artificial_subdomain_id,
+                      ExcMessage(
+                        "Periodic neighbor of a locally owned cell must either be owned or ghost."));
+                  }
+                // Cell is a level-ghost and its neighbor is a
+                // level-artificial cell nothing to do here
+                else if (cell->periodic_neighbor(f)->level_subdomain_id() ==
+                         numbers::artificial_subdomain_id)
+                  {
+                    Assert(cell->is_locally_owned_on_level() == false,
+                           ExcInternalError());
+                    continue;
+                  }
+
+                const unsigned int dofs_per_face =
+                  cell->face(f)->get_fe(0).dofs_per_face;
+                std::vector<types::global_dof_index> dofs_1(dofs_per_face);
+                std::vector<types::global_dof_index> dofs_2(dofs_per_face);
+
+                cell->periodic_neighbor(f)
+                  ->face(cell->periodic_neighbor_face_no(f))
+                  ->get_mg_dof_indices(cell->level(), dofs_1, 0);
+                cell->face(f)->get_mg_dof_indices(cell->level(), dofs_2, 0);
+                for (unsigned int i = 0; i < dofs_per_face; ++i)
+                  dof_pairs.emplace_back(dofs_2[i], dofs_1[i]);
+              }
+        });
+
+    const auto setup_level = [&](const unsigned int l) {
       IndexSet relevant_dofs;
       DoFTools::extract_locally_relevant_level_dofs(dof, l, relevant_dofs);
       level_constraints[l].reinit(relevant_dofs);
 
-      // Loop through relevant cells and faces finding those which are periodic
-      // neighbors.
-      typename DoFHandler<dim, spacedim>::cell_iterator cell = dof.begin(l),
-                                                        endc = dof.end(l);
-      for (; cell != endc; ++cell)
-        if (cell->level_subdomain_id() != numbers::artificial_subdomain_id)
-          {
-            for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
-              if (cell->has_periodic_neighbor(f) &&
-                  cell->periodic_neighbor(f)->level() == cell->level())
-                {
-                  if (cell->is_locally_owned_on_level())
-                    {
-                      Assert(
-                        cell->periodic_neighbor(f)->level_subdomain_id() !=
-                          numbers::artificial_subdomain_id,
-                        ExcMessage(
-                          "Periodic neighbor of a locally owned cell must either be owned or ghost."));
-                    }
-                  // Cell is a level-ghost and its neighbor is a
-                  // level-artificial cell nothing to do here
-                  else if (cell->periodic_neighbor(f)->level_subdomain_id() ==
-                           numbers::artificial_subdomain_id)
-                    {
-                      Assert(cell->is_locally_owned_on_level() == false,
-                             ExcInternalError());
-                      continue;
-                    }
-
-                  const unsigned int dofs_per_face =
-                    cell->face(f)->get_fe(0).dofs_per_face;
-                  std::vector<types::global_dof_index> dofs_1(dofs_per_face);
-                  std::vector<types::global_dof_index> dofs_2(dofs_per_face);
-
-                  cell->periodic_neighbor(f)
-                    ->face(cell->periodic_neighbor_face_no(f))
-                    ->get_mg_dof_indices(l, dofs_1, 0);
-                  cell->face(f)->get_mg_dof_indices(l, dofs_2, 0);
-                  // Store periodicity information in the level
-                  // AffineConstraints object. Skip DoFs for which we've
-                  // previously entered periodicity constraints already; this
-                  // can happen, for example, for a vertex dof at a periodic
-                  // boundary that we visit from more than one cell
-                  for (unsigned int i = 0; i < dofs_per_face; ++i)
-                    if (level_constraints[l].can_store_line(dofs_2[i]) &&
-                        level_constraints[l].can_store_line(dofs_1[i]) &&
-                        !level_constraints[l].is_constrained(dofs_2[i]) &&
-                        !level_constraints[l].is_constrained(dofs_1[i]))
-                      {
-                        level_constraints[l].add_line(dofs_2[i]);
-                        level_constraints[l].add_entry(dofs_2[i],
-                                                       dofs_1[i],
-                                                       1.);
-                      }
-                }
-          }
+      // Store periodicity information in the level AffineConstraints
+      // object. Skip DoFs for which we've previously entered periodicity
+      // constraints already; this can happen, for example, for a vertex dof
+      // at a periodic boundary that we visit from more than one cell
+      if (l < periodic_dofs.size())
+        for (const auto &dof_pair : periodic_dofs[l])
+          if (level_constraints[l].can_store_line(dof_pair.first) &&
+              level_constraints[l].can_store_line(dof_pair.second) &&
+              !level_constraints[l].is_constrained(dof_pair.first) &&
+              !level_constraints[l].is_constrained(dof_pair.second))
+            {
+              level_constraints[l].add_line(dof_pair.first);
+              level_constraints[l].add_entry(dof_pair.first,
+                                             dof_pair.second,
+                                             1.);
+            }
       level_constraints[l].close();
 
       // Initialize with empty IndexSet of correct size
       refinement_edge_indices[l] = IndexSet(dof.n_dofs(l));
-    }
-
-  MGTools::extract_inner_interface_dofs(dof, refinement_edge_indices);
+    };
+
+    // the levels are independent of each other
+    Threads::TaskGroup<void> tasks;
+    for (unsigned int l = 0; l < nlevels; ++l)
+      tasks += Threads::new_task([&, l]() { setup_level(l); });
+    tasks.join_all();
+  }
+
+  {
+    std::unique_ptr<TimerOutput::Scope> scope;
+    if (timer_output != nullptr)
+      scope = std_cxx14::make_unique<TimerOutput::Scope>(
+        *timer_output, "MG setup: refinement edge dofs");
+
+    MGTools::extract_inner_interface_dofs(dof, refinement_edge_indices);
+  }
 }
 
 
@@ -325,8 +381,14 @@ inline void
 MGConstrainedDoFs::make_zero_boundary_constraints(
   const DoFHandler<dim, spacedim> &   dof,
   const std::set<types::boundary_id> &boundary_ids,
-  const ComponentMask &               component_mask)
+  const ComponentMask &               component_mask,
+  TimerOutput *                       timer_output)
 {
+  std::unique_ptr<TimerOutput::Scope> scope;
+  if (timer_output != nullptr)
+    scope = std_cxx14::make_unique<TimerOutput::Scope>(
+      *timer_output, "MG setup: boundary dofs");
+
   // allocate an IndexSet for each global level. Contents will be
   // overwritten inside make_boundary_list.
   const unsigned int n_levels = dof.get_triangulation().n_global_levels();
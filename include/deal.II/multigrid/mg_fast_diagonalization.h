@@ -0,0 +1,1053 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mg_fast_diagonalization_h
+#define dealii_mg_fast_diagonalization_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_tools.h>
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/tensor_product_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup mg */
+/*@{*/
+
+/**
+ * An additive Schwarz smoother for matrix-free operators of Laplace type
+ * (possibly with a mass term) based on the fast diagonalization method. On
+ * each patch, the operator
+ * @f[
+ *   A_\text{patch} = c_\text{Laplace} \sum_{d=1}^{\text{dim}}
+ *   M_1 \otimes \ldots \otimes K_d \otimes \ldots \otimes M_\text{dim}
+ *   + c_\text{mass} M_1 \otimes \ldots \otimes M_\text{dim}
+ * @f]
+ * built from one-dimensional mass matrices $M_d$ and Laplace matrices $K_d$
+ * is inverted with TensorProductMatrixSymmetricSum. The class computes the
+ * one-dimensional matrices from the finite element and the cell sizes of
+ * the mesh, where the cell extent in each coordinate direction of the
+ * reference cell is the norm of the respective column of the Jacobian. The
+ * representation is exact on meshes of (possibly rotated) rectangular cells
+ * and an approximation of the operator on other meshes. The patches are
+ * processed in batches of the width of VectorizedArray, with one
+ * TensorProductMatrixSymmetricSum over VectorizedArray per batch.
+ *
+ * Two kinds of patches are supported:
+ * <ul>
+ * <li> Cell patches (PatchType::cell_patch) for discontinuous elements of
+ * type FE_DGQ and related ones. The one-dimensional Laplace matrices contain
+ * the face terms of the symmetric interior penalty method with the weight
+ * 1/2 on all faces, as described in step-59, so the smoother is a
+ * block-Jacobi method with approximate cell blocks. The cell operation is
+ * run through MatrixFree::cell_loop() and thus uses its thread
+ * parallelization.
+ * <li> Vertex patches (PatchType::vertex_patch) for continuous elements of
+ * type FE_Q. A patch consists of the $2^\text{dim}$ cells around a vertex
+ * of the mesh and contains the degrees of freedom in the interior of the
+ * patch, with homogeneous Dirichlet conditions on the patch boundary. Only
+ * patches whose cells are all part of the MatrixFree object and on the same
+ * level are used. Furthermore, the cells must form a lexicographic
+ * arrangement of $2^\text{dim}$ cells with the same orientation, such that
+ * the coordinate directions of the reference cell agree across the patch.
+ * Vertices with a different number of cells around them, as e.g. at the
+ * transition between the inner and the outer cells of a ball, and vertices
+ * at which cells of different orientations meet are not used as patches.
+ * Interior degrees of freedom of a patch that are constrained or not owned
+ * by the present process are excluded from it, and the patch contributes
+ * $(R A_\text{patch} R^T)^{-1}$ with the restriction $R$ to the remaining
+ * degrees of freedom. Since the restricted matrix is no longer of tensor
+ * product form, its inverse is computed as a dense matrix for these patches,
+ * at a cost of $O(n^3)$ operations in the setup and $O(n^2)$ memory and
+ * operations per application for $n$ remaining degrees of freedom, which
+ * typically only concerns the patches at the boundary of the domain or of
+ * the locally owned part of the mesh. Degrees of freedom that are not in the
+ * interior of any patch, for example on the boundary with Neumann
+ * conditions, are not smoothed.
+ * The patches are colored such that patches of the same color do not
+ * overlap, and the patches of one color are worked on in parallel with
+ * parallel::apply_to_subranges(). The overlap of the patches typically
+ * requires a relaxation parameter smaller than one, e.g. $1/2$ in 2D.
+ * </ul>
+ *
+ * The class provides the interface of a preconditioner with vmult() and
+ * Tvmult() and an initialize() function taking an operator with a
+ * `get_matrix_free()` function such as the classes in the
+ * MatrixFreeOperators namespace. It can therefore be used as the
+ * preconditioner type of MGSmootherPrecondition or as the inner
+ * preconditioner of PreconditionChebyshev. The vectors need to be of type
+ * LinearAlgebra::distributed::Vector.
+ *
+ * @tparam dim The space dimension.
+ * @tparam fe_degree The polynomial degree of the finite element.
+ * @tparam Number The number type of the vectors and the MatrixFree object.
+ */
+template <int dim, int fe_degree, typename Number>
+class PreconditionFastDiagonalization : public Subscriptor
+{
+public:
+  /**
+   * The number type of the vectors.
+   */
+  using value_type = Number;
+
+  /**
+   * The vector type this class works on.
+   */
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+
+  /**
+   * The type of the patches.
+   */
+  enum PatchType
+  {
+    /**
+     * Patches consisting of a single cell, for discontinuous elements.
+     */
+    cell_patch,
+    /**
+     * Patches consisting of the cells around a vertex, for continuous
+     * elements.
+     */
+    vertex_patch
+  };
+
+  /**
+   * Collection of parameters of the smoother.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData(const PatchType    patch_type          = cell_patch,
+                   const double       relaxation          = 1.,
+                   const double       laplace_coefficient = 1.,
+                   const double       mass_coefficient    = 0.,
+                   const double       penalty_factor      = -1.,
+                   const unsigned int dof_no              = 0,
+                   const unsigned int quad_no             = 0)
+      : patch_type(patch_type)
+      , relaxation(relaxation)
+      , laplace_coefficient(laplace_coefficient)
+      , mass_coefficient(mass_coefficient)
+      , penalty_factor(penalty_factor)
+      , dof_no(dof_no)
+      , quad_no(quad_no)
+    {}
+
+    /**
+     * The type of the patches.
+     */
+    PatchType patch_type;
+
+    /**
+     * The factor by which the result of the patch inverses is multiplied.
+     */
+    double relaxation;
+
+    /**
+     * The coefficient $c_\text{Laplace}$ of the Laplace operator.
+     */
+    double laplace_coefficient;
+
+    /**
+     * The coefficient $c_\text{mass}$ of the mass term.
+     */
+    double mass_coefficient;
+
+    /**
+     * The penalty factor of the interior penalty method used for cell
+     * patches, which gets multiplied by the inverse cell size in the
+     * respective direction. A negative value selects the value
+     * <tt>fe_degree*(fe_degree+1)</tt>.
+     */
+    double penalty_factor;
+
+    /**
+     * The index of the DoFHandler within the MatrixFree object.
+     */
+    unsigned int dof_no;
+
+    /**
+     * The index of the quadrature formula within the MatrixFree object,
+     * which must have <tt>fe_degree+1</tt> points in each direction. It is
+     * only used for cell patches.
+     */
+    unsigned int quad_no;
+  };
+
+  /**
+   * Initialize the smoother with the MatrixFree object of the operator @p
+   * matrix, which must provide a function `get_matrix_free()`.
+   */
+  template <typename MatrixType>
+  void
+  initialize(const MatrixType &    matrix,
+             const AdditionalData &additional_data = AdditionalData());
+
+  /**
+   * Initialize the smoother with the given MatrixFree object.
+   */
+  void
+  initialize(const std::shared_ptr<const MatrixFree<dim, Number>> &matrix_free,
+             const AdditionalData &additional_data = AdditionalData());
+
+  /**
+   * Release all memory.
+   */
+  void
+  clear();
+
+  /**
+   * Apply the additive Schwarz method, i.e., the sum of the patch inverses
+   * applied to the restrictions of @p src to the patches, multiplied by the
+   * relaxation parameter. The previous content of @p dst is overwritten.
+   */
+  void
+  vmult(VectorType &dst, const VectorType &src) const;
+
+  /**
+   * Apply the transpose, which is the same as vmult() because the patch
+   * matrices are symmetric.
+   */
+  void
+  Tvmult(VectorType &dst, const VectorType &src) const;
+
+  /**
+   * Return the number of patches (vertex patches) or cell batches (cell
+   * patches) with an inverse on the present process.
+   */
+  unsigned int
+  n_patches() const;
+
+  /**
+   * Return the memory consumption of this class in bytes.
+   */
+  std::size_t
+  memory_consumption() const;
+
+private:
+  /**
+   * Compute the one-dimensional mass and Laplace matrices on the unit
+   * interval in lexicographic numbering, including the interior penalty face
+   * terms for discontinuous elements.
+   */
+  void
+  compute_unit_matrices(FullMatrix<double> &mass_matrix,
+                        FullMatrix<double> &laplace_matrix) const;
+
+  /**
+   * Set up the inverses on cell patches.
+   */
+  void
+  setup_cell_patches();
+
+  /**
+   * Set up the inverses on vertex patches.
+   */
+  void
+  setup_vertex_patches();
+
+  /**
+   * Apply the inverses on a range of cell batches.
+   */
+  void
+  local_apply_cell(
+    const MatrixFree<dim, Number> &              data,
+    VectorType &                                 dst,
+    const VectorType &                           src,
+    const std::pair<unsigned int, unsigned int> &cell_range) const;
+
+  /**
+   * Make sure that the vector @p vec has the layout of the MatrixFree
+   * object as needed by MatrixFree::cell_loop().
+   */
+  void
+  adjust_ghost_range_if_necessary(const VectorType &vec) const;
+
+  /**
+   * The MatrixFree object the smoother works on.
+   */
+  std::shared_ptr<const MatrixFree<dim, Number>> matrix_free;
+
+  /**
+   * The parameters of the smoother.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * The inverses on cell patches. Cell batches with the same geometry as
+   * given by FEEvaluation::get_cell_type() and
+   * FEEvaluation::get_mapping_data_index_offset() share the same entry. The
+   * type is needed because the offsets of cells of different types index
+   * different arrays and can thus coincide.
+   */
+  std::vector<TensorProductMatrixSymmetricSum<dim,
+                                              VectorizedArray<Number>,
+                                              fe_degree + 1>>
+    cell_matrices;
+
+  /**
+   * The index into cell_matrices for each cell batch.
+   */
+  std::vector<unsigned int> cell_matrix_indices;
+
+  /**
+   * The inverses on batches of vertex patches.
+   */
+  std::vector<TensorProductMatrixSymmetricSum<dim,
+                                              VectorizedArray<Number>,
+                                              2 * fe_degree - 1>>
+    patch_matrices;
+
+  /**
+   * The MPI-local indices of the degrees of freedom in the interior of the
+   * vertex patches in lexicographic ordering, with the entries of all lanes
+   * of a batch stored contiguously. The entries of unfilled lanes are
+   * marked by numbers::invalid_unsigned_int.
+   */
+  std::vector<unsigned int> patch_dof_indices;
+
+  /**
+   * The range of patch batches within patch_matrices of each color.
+   */
+  std::vector<unsigned int> color_batch_starts;
+
+  /**
+   * The inverses of the patch matrices restricted to the remaining degrees
+   * of freedom, for the vertex patches from which degrees of freedom are
+   * excluded.
+   */
+  std::vector<FullMatrix<Number>> restricted_patch_inverses;
+
+  /**
+   * The MPI-local indices of the remaining degrees of freedom of the
+   * patches in restricted_patch_inverses.
+   */
+  std::vector<std::vector<unsigned int>> restricted_patch_dof_indices;
+
+  /**
+   * The range of patches within restricted_patch_inverses of each color.
+   */
+  std::vector<unsigned int> color_restricted_starts;
+
+  /**
+   * The number of vertex patches.
+   */
+  unsigned int n_vertex_patches;
+};
+
+/*@}*/
+
+
+// ------------------------------ implementation ------------------------------
+
+#ifndef DOXYGEN
+
+template <int dim, int fe_degree, typename Number>
+template <typename MatrixType>
+inline void
+PreconditionFastDiagonalization<dim, fe_degree, Number>::initialize(
+  const MatrixType &    matrix,
+  const AdditionalData &additional_data)
+{
+  initialize(matrix.get_matrix_free(), additional_data);
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+inline void
+PreconditionFastDiagonalization<dim, fe_degree, Number>::initialize(
+  const std::shared_ptr<const MatrixFree<dim, Number>> &matrix_free_in,
+  const AdditionalData &                                additional_data_in)
+{
+  clear();
+  matrix_free     = matrix_free_in;
+  additional_data = additional_data_in;
+  Assert(additional_data.laplace_coefficient != 0. ||
+           additional_data.mass_coefficient != 0.,
+         ExcMessage("The patch operator must not be zero."));
+
+  if (additional_data.patch_type == cell_patch)
+    setup_cell_patches();
+  else
+    setup_vertex_patches();
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+inline void
+PreconditionFastDiagonalization<dim, fe_degree, Number>::clear()
+{
+  matrix_free.reset();
+  cell_matrices.clear();
+  cell_matrix_indices.clear();
+  patch_matrices.clear();
+  patch_dof_indices.clear();
+  color_batch_starts.clear();
+  restricted_patch_inverses.clear();
+  restricted_patch_dof_indices.clear();
+  color_restricted_starts.clear();
+  n_vertex_patches = 0;
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+inline void
+PreconditionFastDiagonalization<dim, fe_degree, Number>::compute_unit_matrices(
+  FullMatrix<double> &mass_matrix,
+  FullMatrix<double> &laplace_matrix) const
+{
+  // create a 1D copy of the finite element by replacing the dimension in its
+  // name
+  std::string name = matrix_free->get_dof_handler(additional_data.dof_no)
+                       .get_fe()
+                       .base_element(0)
+                       .get_name();
+  name.replace(name.find('<') + 1, 1, "1");
+  const std::unique_ptr<FiniteElement<1>> fe_1d =
+    FETools::get_fe_by_name<1, 1>(name);
+  AssertDimension(fe_1d->dofs_per_cell, fe_degree + 1);
+  AssertIndexRange(fe_1d->dofs_per_vertex, 2);
+
+  // lexicographic numbering of the 1D element
+  const unsigned int        N = fe_degree + 1;
+  std::vector<unsigned int> lexicographic(N);
+  for (unsigned int i = 0; i < N; ++i)
+    lexicographic[i] = i;
+  if (fe_1d->dofs_per_vertex > 0 && N > 1)
+    {
+      for (unsigned int i = 1; i < N - 1; ++i)
+        lexicographic[i] = i + 1;
+      lexicographic[N - 1] = 1;
+    }
+
+  mass_matrix.reinit(N, N);
+  laplace_matrix.reinit(N, N);
+  const QGauss<1> quadrature(N);
+  const double    penalty = additional_data.penalty_factor < 0 ?
+                           fe_degree * (fe_degree + 1.) :
+                           additional_data.penalty_factor;
+  for (unsigned int i = 0; i < N; ++i)
+    for (unsigned int j = 0; j < N; ++j)
+      {
+        const unsigned int ii = lexicographic[i], jj = lexicographic[j];
+        double             sum_mass = 0, sum_laplace = 0;
+        for (unsigned int q = 0; q < quadrature.size(); ++q)
+          {
+            sum_mass += (fe_1d->shape_value(ii, quadrature.point(q)) *
+                         fe_1d->shape_value(jj, quadrature.point(q))) *
+                        quadrature.weight(q);
+            sum_laplace += (fe_1d->shape_grad(ii, quadrature.point(q))[0] *
+                            fe_1d->shape_grad(jj, quadrature.point(q))[0]) *
+                           quadrature.weight(q);
+          }
+
+        // interior penalty terms on the left and right face with the
+        // weight 1/2 of interior faces, see step-59
+        if (fe_1d->dofs_per_vertex == 0)
+          {
+            sum_laplace +=
+              (penalty * fe_1d->shape_value(ii, Point<1>()) *
+                 fe_1d->shape_value(jj, Point<1>()) +
+               0.5 * fe_1d->shape_grad(ii, Point<1>())[0] *
+                 fe_1d->shape_value(jj, Point<1>()) +
+               0.5 * fe_1d->shape_grad(jj, Point<1>())[0] *
+                 fe_1d->shape_value(ii, Point<1>()));
+            sum_laplace +=
+              (penalty * fe_1d->shape_value(ii, Point<1>(1.0)) *
+                 fe_1d->shape_value(jj, Point<1>(1.0)) -
+               0.5 * fe_1d->shape_grad(ii, Point<1>(1.0))[0] *
+                 fe_1d->shape_value(jj, Point<1>(1.0)) -
+               0.5 * fe_1d->shape_grad(jj, Point<1>(1.0))[0] *
+                 fe_1d->shape_value(ii, Point<1>(1.0)));
+          }
+
+        mass_matrix(i, j)    = sum_mass;
+        laplace_matrix(i, j) = sum_laplace;
+      }
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+inline void
+PreconditionFastDiagonalization<dim, fe_degree, Number>::setup_cell_patches()
+{
+  Assert(matrix_free->get_dof_handler(additional_data.dof_no)
+             .get_fe()
+             .dofs_per_vertex == 0,
+         ExcMessage("Cell patches are only implemented for discontinuous "
+                    "elements, use vertex patches for continuous ones."));
+
+  FullMatrix<double> mass_unit, laplace_unit;
+  compute_unit_matrices(mass_unit, laplace_unit);
+
+  const unsigned int N = fe_degree + 1;
+  std::array<Table<2, VectorizedArray<Number>>, dim> mass_matrices;
+  std::array<Table<2, VectorizedArray<Number>>, dim> laplace_matrices;
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      mass_matrices[d].reinit(N, N);
+      laplace_matrices[d].reinit(N, N);
+    }
+
+  // cell batches with the same geometry share the same matrix
+  std::map<std::pair<internal::MatrixFreeFunctions::GeometryType, unsigned int>,
+           unsigned int>
+    mapping_index_to_matrix;
+  cell_matrix_indices.resize(matrix_free->n_macro_cells());
+
+  FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number> phi(
+    *matrix_free, additional_data.dof_no, additional_data.quad_no);
+  for (unsigned int cell = 0; cell < matrix_free->n_macro_cells(); ++cell)
+    {
+      phi.reinit(cell);
+      const auto entry = mapping_index_to_matrix.insert(
+        std::make_pair(std::make_pair(phi.get_cell_type(),
+                                      phi.get_mapping_data_index_offset()),
+                       static_cast<unsigned int>(cell_matrices.size())));
+      cell_matrix_indices[cell] = entry.first->second;
+      if (entry.second == false)
+        continue;
+
+      // the cell extent in direction d of the reference cell is the norm of
+      // the d-th column of the Jacobian, i.e., of the d-th row of the
+      // inverse of the transposed inverse Jacobian stored by FEEvaluation
+      const Tensor<2, dim, VectorizedArray<Number>> jacobian_transpose =
+        invert(phi.inverse_jacobian(0));
+      for (unsigned int d = 0; d < dim; ++d)
+        {
+          const VectorizedArray<Number> h =
+            std::sqrt(jacobian_transpose[d] * jacobian_transpose[d]);
+          for (unsigned int i = 0; i < N; ++i)
+            for (unsigned int j = 0; j < N; ++j)
+              {
+                mass_matrices[d](i, j) = h * Number(mass_unit(i, j));
+                laplace_matrices[d](i, j) =
+                  Number(additional_data.laplace_coefficient) /
+                    h * Number(laplace_unit(i, j)) +
+                  Number(additional_data.mass_coefficient / dim) *
+                    mass_matrices[d](i, j);
+              }
+        }
+      cell_matrices.emplace_back();
+      cell_matrices.back().reinit(mass_matrices, laplace_matrices);
+    }
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+inline void
+PreconditionFastDiagonalization<dim, fe_degree, Number>::setup_vertex_patches()
+{
+  Assert(fe_degree > 0, ExcNotImplemented());
+  const DoFHandler<dim> &dof_handler =
+    matrix_free->get_dof_handler(additional_data.dof_no);
+  Assert(dof_handler.get_fe().dofs_per_vertex > 0,
+         ExcMessage("Vertex patches are only implemented for continuous "
+                    "elements, use cell patches for discontinuous ones."));
+  AssertDimension(dof_handler.get_fe().n_components(), 1);
+
+  FullMatrix<double> mass_unit, laplace_unit;
+  compute_unit_matrices(mass_unit, laplace_unit);
+
+  constexpr unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  constexpr unsigned int n_patch_cells = GeometryInfo<dim>::vertices_per_cell;
+  const unsigned int     N             = 2 * fe_degree - 1;
+  const unsigned int     n_patch_dofs  = Utilities::fixed_power<dim>(N);
+  const unsigned int     level         = matrix_free->get_mg_level();
+  const Utilities::MPI::Partitioner &partitioner =
+    *matrix_free->get_vector_partitioner(additional_data.dof_no);
+  const std::vector<unsigned int> &lexicographic =
+    matrix_free->get_shape_info(additional_data.dof_no).lexicographic_numbering;
+
+  // collect the cells around each vertex, where the position of a cell
+  // within the patch is the opposite of the position of the vertex within
+  // the cell. Two cells claiming the same position happen for vertices with
+  // more than 2^dim cells or with cells of different orientations, so these
+  // vertices are marked as invalid patches
+  using CellIterator = typename DoFHandler<dim>::cell_iterator;
+  std::map<unsigned int, std::array<CellIterator, n_patch_cells>> patch_cells;
+  std::set<unsigned int> invalid_patches;
+  for (unsigned int cell = 0; cell < matrix_free->n_macro_cells(); ++cell)
+    for (unsigned int v = 0;
+         v < matrix_free->n_active_entries_per_cell_batch(cell);
+         ++v)
+      {
+        const CellIterator dcell =
+          matrix_free->get_cell_iterator(cell, v, additional_data.dof_no);
+        for (unsigned int i = 0; i < n_patch_cells; ++i)
+          {
+            CellIterator &position =
+              patch_cells[dcell->vertex_index(i)][n_patch_cells - 1 - i];
+            if (position.state() == IteratorState::valid)
+              invalid_patches.insert(dcell->vertex_index(i));
+            position = dcell;
+          }
+      }
+
+  std::vector<bool> is_constrained(partitioner.local_size() +
+                                     partitioner.n_ghost_indices(),
+                                   false);
+  for (const unsigned int i :
+       matrix_free->get_constrained_dofs(additional_data.dof_no))
+    is_constrained[i] = true;
+
+  // extract the interior degrees of freedom of the complete patches and
+  // the cell extents to the left and right of the vertex. Constrained and
+  // non-owned degrees of freedom are excluded from the patch
+  std::vector<unsigned int>                         all_indices;
+  std::vector<std::array<std::array<double, 2>, dim>> all_extents;
+  std::vector<types::global_dof_index> local_dof_indices(
+    dof_handler.get_fe().dofs_per_cell);
+  std::vector<unsigned int> indices(n_patch_dofs);
+  for (const auto &patch : patch_cells)
+    {
+      if (invalid_patches.find(patch.first) != invalid_patches.end())
+        continue;
+
+      bool is_valid = true;
+      for (unsigned int c = 0; c < n_patch_cells; ++c)
+        if (patch.second[c].state() != IteratorState::valid ||
+            patch.second[c]->level() != patch.second[0]->level())
+          is_valid = false;
+      if (is_valid == false)
+        continue;
+
+      // the cells are arranged lexicographically with the same orientation
+      // if each pair of cells adjacent in direction d shares the face
+      // between them with the vertices on the face in the same order,
+      // which also rules out vertices with more than 2^dim cells of which
+      // only 2^dim are part of the MatrixFree object
+      for (unsigned int c = 0; c < n_patch_cells; ++c)
+        for (unsigned int d = 0; d < dim; ++d)
+          if ((c & (1U << d)) == 0)
+            for (unsigned int v = 0; v < n_patch_cells; ++v)
+              if ((v & (1U << d)) != 0 &&
+                  patch.second[c]->vertex_index(v) !=
+                    patch.second[c | (1U << d)]->vertex_index(v - (1U << d)))
+                is_valid = false;
+      if (is_valid == false)
+        continue;
+
+      bool has_dofs = false;
+      for (unsigned int c = 0; c < n_patch_cells; ++c)
+        {
+          if (level == numbers::invalid_unsigned_int)
+            patch.second[c]->get_dof_indices(local_dof_indices);
+          else
+            patch.second[c]->get_mg_dof_indices(local_dof_indices);
+
+          for (unsigned int i = 0; i < local_dof_indices.size(); ++i)
+            {
+              unsigned int index = 0, stride = 1;
+              bool         is_interior = true;
+              for (unsigned int d = 0, ii = i; d < dim; ++d)
+                {
+                  const unsigned int position =
+                    ((c >> d) & 1) * fe_degree + ii % (fe_degree + 1);
+                  ii /= fe_degree + 1;
+                  if (position == 0 || position == 2 * fe_degree)
+                    is_interior = false;
+                  index += (position - 1) * stride;
+                  stride *= N;
+                }
+              if (is_interior == false)
+                continue;
+
+              const types::global_dof_index global_index =
+                local_dof_indices[lexicographic[i]];
+              if (partitioner.in_local_range(global_index) == false ||
+                  is_constrained[partitioner.global_to_local(global_index)])
+                indices[index] = numbers::invalid_unsigned_int;
+              else
+                {
+                  indices[index] = partitioner.global_to_local(global_index);
+                  has_dofs       = true;
+                }
+            }
+        }
+      if (has_dofs == false)
+        continue;
+
+      all_indices.insert(all_indices.end(), indices.begin(), indices.end());
+      // the extents are the norms of the columns of the Jacobian of the
+      // bilinear cell at vertex 0, which agree with the cell extents on
+      // (possibly rotated) rectangular cells
+      std::array<std::array<double, 2>, dim> extents;
+      for (unsigned int d = 0; d < dim; ++d)
+        for (unsigned int side = 0; side < 2; ++side)
+          {
+            const CellIterator &cell = patch.second[side << d];
+            extents[d][side] =
+              (cell->vertex(1U << d) - cell->vertex(0)).norm();
+          }
+      all_extents.push_back(extents);
+    }
+  n_vertex_patches = all_extents.size();
+
+  // color the patches such that patches of the same color do not share
+  // degrees of freedom, using a bit mask of the colors a degree of freedom
+  // is already part of
+  std::vector<unsigned int> used_colors(partitioner.local_size(), 0U);
+  std::vector<std::vector<unsigned int>> patches_of_color;
+  for (unsigned int p = 0; p < n_vertex_patches; ++p)
+    {
+      unsigned int mask = 0;
+      for (unsigned int i = 0; i < n_patch_dofs; ++i)
+        if (all_indices[p * n_patch_dofs + i] != numbers::invalid_unsigned_int)
+          mask |= used_colors[all_indices[p * n_patch_dofs + i]];
+      unsigned int color = 0;
+      while (mask & (1U << color))
+        ++color;
+      AssertIndexRange(color, 32);
+      for (unsigned int i = 0; i < n_patch_dofs; ++i)
+        if (all_indices[p * n_patch_dofs + i] != numbers::invalid_unsigned_int)
+          used_colors[all_indices[p * n_patch_dofs + i]] |= (1U << color);
+      if (color >= patches_of_color.size())
+        patches_of_color.resize(color + 1);
+      patches_of_color[color].push_back(p);
+    }
+
+  // assemble the 1D mass matrix and the 1D Laplace matrix including the
+  // mass term on the two cells of patch p in direction d, restricted to the
+  // interior degrees of freedom
+  const auto compute_1d_matrices = [&](const unsigned int  p,
+                                       const unsigned int  d,
+                                       FullMatrix<double> &mass_1d,
+                                       FullMatrix<double> &laplace_1d) {
+    FullMatrix<double> mass(2 * fe_degree + 1), laplace(2 * fe_degree + 1);
+    for (unsigned int side = 0; side < 2; ++side)
+      {
+        const double h = all_extents[p][d][side];
+        for (unsigned int i = 0; i <= fe_degree; ++i)
+          for (unsigned int j = 0; j <= fe_degree; ++j)
+            {
+              mass(side * fe_degree + i, side * fe_degree + j) +=
+                h * mass_unit(i, j);
+              laplace(side * fe_degree + i, side * fe_degree + j) +=
+                laplace_unit(i, j) / h;
+            }
+      }
+    mass_1d.reinit(N, N);
+    laplace_1d.reinit(N, N);
+    for (unsigned int i = 0; i < N; ++i)
+      for (unsigned int j = 0; j < N; ++j)
+        {
+          mass_1d(i, j) = mass(i + 1, j + 1);
+          laplace_1d(i, j) =
+            additional_data.laplace_coefficient * laplace(i + 1, j + 1) +
+            additional_data.mass_coefficient / dim * mass(i + 1, j + 1);
+        }
+  };
+
+  // pass the 1D matrices to the tensor product matrices of each batch of
+  // patches without excluded degrees of freedom. For the other patches,
+  // assemble the patch matrix from the 1D matrices, restrict it to the
+  // remaining degrees of freedom and invert it
+  std::array<Table<2, VectorizedArray<Number>>, dim> mass_matrices;
+  std::array<Table<2, VectorizedArray<Number>>, dim> laplace_matrices;
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      mass_matrices[d].reinit(N, N);
+      laplace_matrices[d].reinit(N, N);
+    }
+  std::array<FullMatrix<double>, dim> mass_1d, laplace_1d;
+  color_batch_starts.push_back(0);
+  color_restricted_starts.push_back(0);
+  for (const std::vector<unsigned int> &color_patches : patches_of_color)
+    {
+      std::vector<unsigned int> patches;
+      for (const unsigned int p : color_patches)
+        {
+          std::vector<unsigned int> remaining;
+          for (unsigned int i = 0; i < n_patch_dofs; ++i)
+            if (all_indices[p * n_patch_dofs + i] !=
+                numbers::invalid_unsigned_int)
+              remaining.push_back(i);
+          if (remaining.size() == n_patch_dofs)
+            {
+              patches.push_back(p);
+              continue;
+            }
+
+          for (unsigned int d = 0; d < dim; ++d)
+            compute_1d_matrices(p, d, mass_1d[d], laplace_1d[d]);
+          FullMatrix<double> restricted_matrix(remaining.size(),
+                                               remaining.size());
+          for (unsigned int i = 0; i < remaining.size(); ++i)
+            for (unsigned int j = 0; j < remaining.size(); ++j)
+              for (unsigned int d = 0; d < dim; ++d)
+                {
+                  double       product = 1.;
+                  unsigned int ii = remaining[i], jj = remaining[j];
+                  for (unsigned int e = 0; e < dim; ++e, ii /= N, jj /= N)
+                    product *= e == d ? laplace_1d[e](ii % N, jj % N) :
+                                        mass_1d[e](ii % N, jj % N);
+                  restricted_matrix(i, j) += product;
+                }
+          restricted_matrix.gauss_jordan();
+
+          restricted_patch_inverses.emplace_back();
+          restricted_patch_inverses.back().copy_from(restricted_matrix);
+          restricted_patch_dof_indices.emplace_back(remaining.size());
+          for (unsigned int i = 0; i < remaining.size(); ++i)
+            restricted_patch_dof_indices.back()[i] =
+              all_indices[p * n_patch_dofs + remaining[i]];
+        }
+      color_restricted_starts.push_back(restricted_patch_inverses.size());
+
+      for (unsigned int batch = 0; batch < patches.size(); batch += n_lanes)
+        {
+          for (unsigned int v = 0; v < n_lanes; ++v)
+            {
+              // fill unused lanes with the data of the first patch to keep
+              // the eigenvalue problem well-defined
+              const unsigned int p =
+                patches[batch + v < patches.size() ? batch + v : batch];
+              for (unsigned int i = 0; i < n_patch_dofs; ++i)
+                patch_dof_indices.push_back(
+                  batch + v < patches.size() ?
+                    all_indices[p * n_patch_dofs + i] :
+                    numbers::invalid_unsigned_int);
+
+              for (unsigned int d = 0; d < dim; ++d)
+                {
+                  compute_1d_matrices(p, d, mass_1d[d], laplace_1d[d]);
+                  for (unsigned int i = 0; i < N; ++i)
+                    for (unsigned int j = 0; j < N; ++j)
+                      {
+                        mass_matrices[d](i, j)[v]    = mass_1d[d](i, j);
+                        laplace_matrices[d](i, j)[v] = laplace_1d[d](i, j);
+                      }
+                }
+            }
+          patch_matrices.emplace_back();
+          patch_matrices.back().reinit(mass_matrices, laplace_matrices);
+        }
+      color_batch_starts.push_back(patch_matrices.size());
+    }
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+inline void
+PreconditionFastDiagonalization<dim, fe_degree, Number>::
+  adjust_ghost_range_if_necessary(const VectorType &vec) const
+{
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner =
+    matrix_free->get_vector_partitioner(additional_data.dof_no);
+  if (vec.get_partitioner().get() == partitioner.get())
+    return;
+
+  VectorType copy_vec(vec);
+  const_cast<VectorType &>(vec).reinit(partitioner);
+  const_cast<VectorType &>(vec).copy_locally_owned_data_from(copy_vec);
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+inline void
+PreconditionFastDiagonalization<dim, fe_degree, Number>::local_apply_cell(
+  const MatrixFree<dim, Number> &              data,
+  VectorType &                                 dst,
+  const VectorType &                           src,
+  const std::pair<unsigned int, unsigned int> &cell_range) const
+{
+  FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number> phi(
+    data, additional_data.dof_no, additional_data.quad_no);
+  const VectorizedArray<Number> relaxation =
+    make_vectorized_array<Number>(additional_data.relaxation);
+  for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi.reinit(cell);
+      phi.read_dof_values_plain(src);
+      cell_matrices[cell_matrix_indices[cell]].apply_inverse(
+        ArrayView<VectorizedArray<Number>>(phi.begin_dof_values(),
+                                           phi.dofs_per_cell),
+        ArrayView<const VectorizedArray<Number>>(phi.begin_dof_values(),
+                                                 phi.dofs_per_cell));
+      for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+        phi.begin_dof_values()[i] *= relaxation;
+      phi.distribute_local_to_global(dst);
+    }
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+inline void
+PreconditionFastDiagonalization<dim, fe_degree, Number>::vmult(
+  VectorType &      dst,
+  const VectorType &src) const
+{
+  Assert(matrix_free.get() != nullptr, ExcNotInitialized());
+
+  if (additional_data.patch_type == cell_patch)
+    {
+      adjust_ghost_range_if_necessary(dst);
+      adjust_ghost_range_if_necessary(src);
+      matrix_free->cell_loop(&PreconditionFastDiagonalization::local_apply_cell,
+                             this,
+                             dst,
+                             src,
+                             true);
+      return;
+    }
+
+  // vertex patches only contain locally owned degrees of freedom, so no
+  // communication is necessary
+  constexpr unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  const unsigned int     n_patch_dofs =
+    Utilities::fixed_power<dim>(2 * fe_degree - 1);
+  const Number relaxation = additional_data.relaxation;
+
+  dst = 0;
+  for (unsigned int color = 0; color + 1 < color_batch_starts.size(); ++color)
+    {
+      parallel::apply_to_subranges(
+        color_batch_starts[color],
+        color_batch_starts[color + 1],
+        [&](const unsigned int begin, const unsigned int end) {
+          AlignedVector<VectorizedArray<Number>> values(n_patch_dofs);
+          for (unsigned int batch = begin; batch < end; ++batch)
+            {
+              const unsigned int *indices =
+                &patch_dof_indices[batch * n_lanes * n_patch_dofs];
+              for (unsigned int v = 0; v < n_lanes; ++v)
+                for (unsigned int i = 0; i < n_patch_dofs; ++i)
+                  values[i][v] =
+                    indices[v * n_patch_dofs + i] ==
+                        numbers::invalid_unsigned_int ?
+                      Number() :
+                      src.local_element(indices[v * n_patch_dofs + i]);
+
+              patch_matrices[batch].apply_inverse(
+                ArrayView<VectorizedArray<Number>>(values.begin(),
+                                                   n_patch_dofs),
+                ArrayView<const VectorizedArray<Number>>(values.begin(),
+                                                         n_patch_dofs));
+
+              for (unsigned int v = 0; v < n_lanes; ++v)
+                for (unsigned int i = 0; i < n_patch_dofs; ++i)
+                  if (indices[v * n_patch_dofs + i] !=
+                      numbers::invalid_unsigned_int)
+                    dst.local_element(indices[v * n_patch_dofs + i]) +=
+                      relaxation * values[i][v];
+            }
+        },
+        8);
+
+      // the patches with excluded degrees of freedom of the same color
+      parallel::apply_to_subranges(
+        color_restricted_starts[color],
+        color_restricted_starts[color + 1],
+        [&](const unsigned int begin, const unsigned int end) {
+          Vector<Number> patch_src, patch_dst;
+          for (unsigned int p = begin; p < end; ++p)
+            {
+              const std::vector<unsigned int> &indices =
+                restricted_patch_dof_indices[p];
+              patch_src.reinit(indices.size(), true);
+              patch_dst.reinit(indices.size(), true);
+              for (unsigned int i = 0; i < indices.size(); ++i)
+                patch_src(i) = src.local_element(indices[i]);
+              restricted_patch_inverses[p].vmult(patch_dst, patch_src);
+              for (unsigned int i = 0; i < indices.size(); ++i)
+                dst.local_element(indices[i]) += relaxation * patch_dst(i);
+            }
+        },
+        8);
+    }
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+inline void
+PreconditionFastDiagonalization<dim, fe_degree, Number>::Tvmult(
+  VectorType &      dst,
+  const VectorType &src) const
+{
+  vmult(dst, src);
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+inline unsigned int
+PreconditionFastDiagonalization<dim, fe_degree, Number>::n_patches() const
+{
+  return additional_data.patch_type == cell_patch ? cell_matrix_indices.size() :
+                                                    n_vertex_patches;
+}
+
+
+
+template <int dim, int fe_degree, typename Number>
+inline std::size_t
+PreconditionFastDiagonalization<dim, fe_degree, Number>::memory_consumption()
+  const
+{
+  return MemoryConsumption::memory_consumption(cell_matrix_indices) +
+         MemoryConsumption::memory_consumption(patch_dof_indices) +
+         MemoryConsumption::memory_consumption(color_batch_starts) +
+         MemoryConsumption::memory_consumption(restricted_patch_inverses) +
+         MemoryConsumption::memory_consumption(restricted_patch_dof_indices) +
+         MemoryConsumption::memory_consumption(color_restricted_starts) +
+         (cell_matrices.size() + patch_matrices.size()) * dim * 3 *
+           Utilities::fixed_power<2>(2 * fe_degree + 1) *
+           sizeof(VectorizedArray<Number>);
+}
+
+#endif // DOXYGEN
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -19,10 +19,16 @@
 #include <deal.II/base/config.h>
 
 #include <deal.II/base/index_set.h>
+#include <deal.II/base/parallel.h>
 
+#include <deal.II/dofs/dof_accessor.h>
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/dofs/dof_tools.h>
 
+#include <deal.II/grid/tria_iterator.h>
+
+#include <algorithm>
+#include <array>
 #include <set>
 #include <vector>
 
@@ -283,6 +289,78 @@ namespace MGTools
 
 /* @} */
 
+
+namespace internal
+{
+  namespace MGToolsImplementation
+  {
+    /**
+     * Call @p collect with each used cell on the levels from @p min_level to
+     * the finest level of @p dof and an output buffer. The cells of each
+     * level are split into chunks of consecutive cells that are worked on in
+     * parallel, each with its own buffer. The buffers are merged once per
+     * level, such that the returned vector contains, for each level, the
+     * entries added by @p collect in the order of the cells, independently
+     * of the number of threads.
+     */
+    template <typename T, int dim, int spacedim, typename CollectFunction>
+    std::vector<std::vector<T>>
+    collect_on_level_cells(const DoFHandler<dim, spacedim> &dof,
+                           const unsigned int               min_level,
+                           const CollectFunction &          collect)
+    {
+      const Triangulation<dim, spacedim> &tria     = dof.get_triangulation();
+      const unsigned int                  n_levels = tria.n_levels();
+
+      constexpr unsigned int                   chunk_size = 64;
+      std::vector<std::array<unsigned int, 3>> chunks;
+      for (unsigned int level = min_level; level < n_levels; ++level)
+        for (unsigned int begin = 0; begin < tria.n_raw_cells(level);
+             begin += chunk_size)
+          chunks.push_back(
+            {{level,
+              begin,
+              std::min(begin + chunk_size, tria.n_raw_cells(level))}});
+
+      std::vector<std::vector<T>> chunk_buffers(chunks.size());
+      parallel::apply_to_subranges(
+        0U,
+        static_cast<unsigned int>(chunks.size()),
+        [&](const unsigned int begin, const unsigned int end) {
+          for (unsigned int c = begin; c < end; ++c)
+            for (unsigned int index = chunks[c][1]; index < chunks[c][2];
+                 ++index)
+              {
+                const TriaRawIterator<
+                  typename DoFHandler<dim, spacedim>::level_cell_accessor>
+                  cell(&tria, chunks[c][0], index, &dof);
+                if (cell->used())
+                  collect(
+                    typename DoFHandler<dim, spacedim>::level_cell_iterator(
+                      cell),
+                    chunk_buffers[c]);
+              }
+        },
+        1);
+
+      std::vector<std::vector<T>> level_buffers(n_levels);
+      std::vector<std::size_t>    level_sizes(n_levels);
+      for (unsigned int c = 0; c < chunks.size(); ++c)
+        level_sizes[chunks[c][0]] += chunk_buffers[c].size();
+      for (unsigned int level = min_level; level < n_levels; ++level)
+        level_buffers[level].reserve(level_sizes[level]);
+      for (unsigned int c = 0; c < chunks.size(); ++c)
+        {
+          level_buffers[chunks[c][0]].insert(level_buffers[chunks[c][0]].end(),
+                                             chunk_buffers[c].begin(),
+                                             chunk_buffers[c].end());
+          std::vector<T>().swap(chunk_buffers[c]);
+        }
+      return level_buffers;
+    }
+  } // namespace MGToolsImplementation
+} // namespace internal
+
 DEAL_II_NAMESPACE_CLOSE
 
 #endif
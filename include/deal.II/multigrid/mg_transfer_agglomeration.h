@@ -0,0 +1,1000 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mg_transfer_agglomeration_h
+#define dealii_mg_transfer_agglomeration_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/table.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/vector_operation.h>
+
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/tools.h>
+
+#include <deal.II/multigrid/mg_base.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup mg */
+/*@{*/
+
+/**
+ * A class that describes the agglomeration of the coarse levels of a
+ * multigrid hierarchy onto a decreasing number of MPI processes. On large
+ * process counts, the coarse levels only contain a few cells per process or
+ * none at all, and the level smoothers and the coarse grid solver are
+ * dominated by the latency of global reductions over all processes. This
+ * class selects, going from the finest to the coarsest level, a stride $s$
+ * per level such that only every $s$-th process of the communicator of the
+ * finest level holds level data: Whenever the number of cells per active
+ * process falls below AdditionalData::min_cells_per_process, the stride is
+ * multiplied by AdditionalData::reduction_factor.
+ *
+ * The degrees of freedom of a level are distributed contiguously among the
+ * processes as described by the level partitioners passed to initialize(),
+ * e.g. the ones of the MatrixFree objects on the levels. On an agglomerated
+ * level, the active process with rank $p$ in the original communicator owns
+ * the degrees of freedom owned by the processes $p, \ldots, p+s-1$ in the
+ * original distribution, so data only needs to be exchanged within groups
+ * of $s$ neighboring processes. The active processes of a level are joined
+ * into a subcommunicator that is used by the level vectors, so global
+ * reductions on that level only involve the active processes. On the
+ * inactive processes, the level vectors are empty vectors on
+ * MPI_COMM_SELF, so level operations there complete without any
+ * communication. Level operators and smoothers on agglomerated levels must
+ * therefore only communicate within the communicator returned by
+ * get_communicator(), which is the case for MGAgglomeratedLevelMatrix.
+ *
+ * The functions gather() and scatter() move the data of a level vector
+ * between the original and the agglomerated distribution. They are used by
+ * MGTransferAgglomeration to combine the transfer between the levels,
+ * which works on the original distribution, with agglomerated level
+ * vectors. Both functions need to be called by all processes of the
+ * original communicator.
+ */
+class MGLevelAgglomeration : public Subscriptor
+{
+public:
+  /**
+   * Collection of parameters of the agglomeration.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData(const unsigned int reduction_factor      = 8,
+                   const unsigned int min_cells_per_process = 32)
+      : reduction_factor(reduction_factor)
+      , min_cells_per_process(min_cells_per_process)
+    {}
+
+    /**
+     * The factor by which the number of active processes is reduced each
+     * time the number of cells per process falls below the threshold.
+     */
+    unsigned int reduction_factor;
+
+    /**
+     * The minimal number of cells per active process on a level. A value
+     * of zero disables the agglomeration.
+     */
+    unsigned int min_cells_per_process;
+  };
+
+  /**
+   * Constructor.
+   */
+  MGLevelAgglomeration();
+
+  /**
+   * Copying is not allowed because the object owns MPI communicators.
+   */
+  MGLevelAgglomeration(const MGLevelAgglomeration &) = delete;
+
+  /**
+   * Copying is not allowed because the object owns MPI communicators.
+   */
+  MGLevelAgglomeration &
+  operator=(const MGLevelAgglomeration &) = delete;
+
+  /**
+   * Destructor. Frees the subcommunicators.
+   */
+  ~MGLevelAgglomeration() override;
+
+  /**
+   * Set up the agglomeration for the levels of @p dof_handler, which must
+   * have its level degrees of freedom distributed. The vector @p
+   * level_partitioners contains the distribution of the level degrees of
+   * freedom among the processes, e.g. as given by
+   * MatrixFree::get_vector_partitioner() on each level, and defines the
+   * range of levels. The number of cells is counted on the locally owned
+   * level cells of the triangulation.
+   *
+   * This function must be called by all processes of the communicator of
+   * the partitioners.
+   */
+  template <int dim, int spacedim>
+  void
+  initialize(
+    const DoFHandler<dim, spacedim> &dof_handler,
+    const MGLevelObject<std::shared_ptr<const Utilities::MPI::Partitioner>>
+      &                   level_partitioners,
+    const AdditionalData &additional_data = AdditionalData());
+
+  /**
+   * Reset the object to the state it had right after the default
+   * constructor.
+   */
+  void
+  clear();
+
+  /**
+   * Return the coarsest level.
+   */
+  unsigned int
+  min_level() const;
+
+  /**
+   * Return the finest level.
+   */
+  unsigned int
+  max_level() const;
+
+  /**
+   * Return whether the data of @p level is held by fewer processes than
+   * in the original distribution.
+   */
+  bool
+  is_agglomerated(const unsigned int level) const;
+
+  /**
+   * Return whether the present process holds data on @p level.
+   */
+  bool
+  is_active(const unsigned int level) const;
+
+  /**
+   * Return the number of processes holding data on @p level.
+   */
+  unsigned int
+  n_active_processes(const unsigned int level) const;
+
+  /**
+   * Return the communicator of the level vectors on @p level. This is the
+   * original communicator on levels that are not agglomerated, a
+   * subcommunicator of the active processes on agglomerated levels, and
+   * MPI_COMM_SELF on processes that are not active on @p level.
+   */
+  const MPI_Comm &
+  get_communicator(const unsigned int level) const;
+
+  /**
+   * Return the partitioner of the level vectors on @p level in the
+   * agglomerated distribution.
+   */
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &
+  get_partitioner(const unsigned int level) const;
+
+  /**
+   * Return the partitioner of @p level in the original distribution, as
+   * passed to initialize().
+   */
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &
+  get_original_partitioner(const unsigned int level) const;
+
+  /**
+   * Return the rank within the original communicator of the process that
+   * owns the level degree of freedom @p index on @p level in the
+   * agglomerated distribution.
+   */
+  unsigned int
+  get_owner(const unsigned int            level,
+            const types::global_dof_index index) const;
+
+  /**
+   * Initialize @p vec as a vector on @p level in the agglomerated
+   * distribution.
+   */
+  template <typename Number>
+  void
+  initialize_dof_vector(const unsigned int                          level,
+                        LinearAlgebra::distributed::Vector<Number> &vec) const;
+
+  /**
+   * Move the vector @p src on @p level from the original distribution to
+   * the agglomerated distribution in @p dst. Depending on @p operation, the
+   * content of @p dst is overwritten or added to.
+   */
+  template <typename Number>
+  void
+  gather(
+    const unsigned int                                level,
+    LinearAlgebra::distributed::Vector<Number> &      dst,
+    const LinearAlgebra::distributed::Vector<Number> &src,
+    const VectorOperation::values operation = VectorOperation::insert) const;
+
+  /**
+   * Move the vector @p src on @p level from the agglomerated distribution
+   * to the original distribution in @p dst. Depending on @p operation, the
+   * content of @p dst is overwritten or added to.
+   */
+  template <typename Number>
+  void
+  scatter(
+    const unsigned int                                level,
+    LinearAlgebra::distributed::Vector<Number> &      dst,
+    const LinearAlgebra::distributed::Vector<Number> &src,
+    const VectorOperation::values operation = VectorOperation::insert) const;
+
+  /**
+   * Memory used by this object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+private:
+  /**
+   * The data stored per level.
+   */
+  struct LevelData
+  {
+    /**
+     * The stride between the active processes, one on levels that are not
+     * agglomerated.
+     */
+    unsigned int stride;
+
+    /**
+     * The communicator of the level vectors.
+     */
+    MPI_Comm communicator;
+
+    /**
+     * The partitioner of the original distribution.
+     */
+    std::shared_ptr<const Utilities::MPI::Partitioner> original_partitioner;
+
+    /**
+     * The partitioner of the agglomerated distribution.
+     */
+    std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
+
+    /**
+     * A partitioner on the original communicator that owns the indices of
+     * the agglomerated distribution and has the indices of the original
+     * distribution as ghosts, used to move data between the two.
+     */
+    std::shared_ptr<const Utilities::MPI::Partitioner> transfer_partitioner;
+
+    /**
+     * The first index owned by each process of the original communicator
+     * in the original distribution, with the global size as last entry.
+     */
+    std::vector<types::global_dof_index> original_range_starts;
+  };
+
+  /**
+   * The communicator of the finest level.
+   */
+  MPI_Comm original_communicator;
+
+  /**
+   * The subcommunicators created by this class, one per stride.
+   */
+  std::map<unsigned int, MPI_Comm> subcommunicators;
+
+  /**
+   * The data of the levels.
+   */
+  MGLevelObject<LevelData> level_data;
+};
+
+
+
+/**
+ * A sparse matrix representing a level operator on a level of
+ * MGLevelAgglomeration. Each process stores the rows of its locally owned
+ * degrees of freedom in the agglomerated distribution in compressed row
+ * storage, with columns numbered in the MPI-local index space of a
+ * partitioner on the level communicator, and all communication of vmult()
+ * happens within that communicator.
+ *
+ * The matrix is assembled from the cell matrices of a matrix-free
+ * operator, as computed by MatrixFreeTools::compute_cell_matrices(), on the
+ * cells of the MatrixFree object in the original distribution. The
+ * constraints stored in the MatrixFree object are applied to the cell
+ * matrices, and the constrained rows are replaced by rows of the identity
+ * matrix, which is the representation used by the level operators in the
+ * MatrixFreeOperators namespace. The entries are then sent to the owners of
+ * the rows in the agglomerated distribution.
+ *
+ * The class provides vmult() and Tvmult() and can be used as level operator
+ * for smoothers like PreconditionChebyshev (together with a diagonal
+ * computed by compute_diagonal()) and for coarse grid solvers.
+ */
+template <typename Number>
+class MGAgglomeratedLevelMatrix : public Subscriptor
+{
+public:
+  /**
+   * The number type of the matrix entries.
+   */
+  using value_type = Number;
+
+  /**
+   * The vector type this class works on.
+   */
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+
+  /**
+   * Assemble the matrix on @p level of @p agglomeration from the cell
+   * matrices @p cell_matrices on the cell batches of @p matrix_free, which
+   * must be set up on the same level in the original distribution. The
+   * arguments @p dof_no and @p first_selected_component need to match the
+   * ones used for computing the cell matrices.
+   *
+   * This function must be called by all processes of the original
+   * communicator of @p agglomeration.
+   */
+  template <int dim, typename VectorizedArrayType>
+  void
+  reinit(const MGLevelAgglomeration &                        agglomeration,
+         const unsigned int                                  level,
+         const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+         const Table<3, VectorizedArrayType> &               cell_matrices,
+         const unsigned int                                  dof_no = 0,
+         const unsigned int first_selected_component              = 0);
+
+  /**
+   * Release all memory.
+   */
+  void
+  clear();
+
+  /**
+   * Return the number of rows of the global matrix.
+   */
+  types::global_dof_index
+  m() const;
+
+  /**
+   * Return the number of columns of the global matrix.
+   */
+  types::global_dof_index
+  n() const;
+
+  /**
+   * Initialize @p vec with the locally owned rows as locally owned entries
+   * and the ghost entries needed for vmult().
+   */
+  void
+  initialize_dof_vector(VectorType &vec) const;
+
+  /**
+   * Matrix-vector multiplication. The vectors need to have the locally
+   * owned range of the agglomerated distribution, ghost entries are
+   * handled internally.
+   */
+  void
+  vmult(VectorType &dst, const VectorType &src) const;
+
+  /**
+   * Matrix-vector multiplication with the transpose matrix.
+   */
+  void
+  Tvmult(VectorType &dst, const VectorType &src) const;
+
+  /**
+   * Compute the diagonal of the matrix.
+   */
+  void
+  compute_diagonal(VectorType &diagonal) const;
+
+  /**
+   * Return the partitioner of the columns, which owns the locally owned
+   * rows and has the columns of other processes as ghost entries.
+   */
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &
+  get_partitioner() const;
+
+  /**
+   * Return the start of the locally owned rows in the arrays returned by
+   * get_column_indices() and get_values(), with one additional entry at
+   * the end.
+   */
+  const std::vector<unsigned int> &
+  get_row_starts() const;
+
+  /**
+   * Return the column indices of the locally owned rows in the MPI-local
+   * numbering of get_partitioner(), sorted within each row.
+   */
+  const std::vector<unsigned int> &
+  get_column_indices() const;
+
+  /**
+   * Return the entries of the locally owned rows.
+   */
+  const std::vector<Number> &
+  get_values() const;
+
+  /**
+   * Memory used by this object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+private:
+  /**
+   * Set up the compressed row storage from the entries of the locally
+   * owned rows, given as triplets of global row and column indices and
+   * values and sorted by row and column, with duplicates already summed.
+   */
+  void
+  build_rows(
+    const std::vector<std::pair<std::pair<types::global_dof_index,
+                                          types::global_dof_index>,
+                                Number>> &entries,
+    const std::shared_ptr<const Utilities::MPI::Partitioner>
+      &               owned_partitioner,
+    const MPI_Comm &communicator);
+
+  /**
+   * The partitioner of the columns.
+   */
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
+
+  /**
+   * The start of each row in column_indices and values.
+   */
+  std::vector<unsigned int> row_starts;
+
+  /**
+   * The MPI-local column indices.
+   */
+  std::vector<unsigned int> column_indices;
+
+  /**
+   * The matrix entries.
+   */
+  std::vector<Number> values;
+
+  /**
+   * A vector with ghost entries to import the columns of other processes.
+   */
+  mutable VectorType ghosted_vector;
+};
+
+
+
+/**
+ * A transfer class for the Multigrid class that combines MGTransferMatrixFree
+ * with the agglomeration of coarse levels described by MGLevelAgglomeration.
+ * The level vectors passed to and returned from this class are in the
+ * agglomerated distribution on all levels. Before the transfer between two
+ * levels, the vectors of agglomerated levels are moved to the original
+ * distribution, where the transfer of MGTransferMatrixFree is applied, and
+ * the result is moved back to the agglomerated distribution. On levels
+ * that are not agglomerated, the vectors are passed through unchanged.
+ *
+ * Since the transfer communicates within the original communicator, all
+ * processes need to take part in each transfer operation, which is the
+ * case in Multigrid::vcycle().
+ */
+template <int dim, typename Number>
+class MGTransferAgglomeration
+  : public MGTransferBase<LinearAlgebra::distributed::Vector<Number>>
+{
+public:
+  /**
+   * Constructor taking the transfer in the original distribution and the
+   * description of the agglomeration, which must already be initialized.
+   * Both objects need to be alive as long as this class is in use.
+   */
+  MGTransferAgglomeration(const MGTransferMatrixFree<dim, Number> &transfer,
+                          const MGLevelAgglomeration &agglomeration);
+
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt>. The previous content of <tt>dst</tt> is overwritten.
+   */
+  virtual void
+  prolongate(
+    const unsigned int                                to_level,
+    LinearAlgebra::distributed::Vector<Number> &      dst,
+    const LinearAlgebra::distributed::Vector<Number> &src) const override;
+
+  /**
+   * Restrict a vector from level <tt>from_level</tt> to level
+   * <tt>from_level-1</tt> and add the result to @p dst.
+   */
+  virtual void
+  restrict_and_add(
+    const unsigned int                                from_level,
+    LinearAlgebra::distributed::Vector<Number> &      dst,
+    const LinearAlgebra::distributed::Vector<Number> &src) const override;
+
+  /**
+   * Transfer from a vector on the global grid to the level vectors in the
+   * agglomerated distribution, see MGTransferMatrixFree::copy_to_mg().
+   */
+  template <typename Number2, int spacedim>
+  void
+  copy_to_mg(const DoFHandler<dim, spacedim> &                          dof,
+             MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &dst,
+             const LinearAlgebra::distributed::Vector<Number2> &src) const;
+
+  /**
+   * Transfer from the level vectors in the agglomerated distribution to a
+   * vector on the global grid, see MGTransferMatrixFree::copy_from_mg().
+   */
+  template <typename Number2, int spacedim>
+  void
+  copy_from_mg(
+    const DoFHandler<dim, spacedim> &                                dof,
+    LinearAlgebra::distributed::Vector<Number2> &                    dst,
+    const MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &src) const;
+
+  /**
+   * Add the level vectors in the agglomerated distribution to a vector on
+   * the global grid, see MGTransferMatrixFree::copy_from_mg_add().
+   */
+  template <typename Number2, int spacedim>
+  void
+  copy_from_mg_add(
+    const DoFHandler<dim, spacedim> &                                dof,
+    LinearAlgebra::distributed::Vector<Number2> &                    dst,
+    const MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &src) const;
+
+  /**
+   * Memory used by this object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+private:
+  /**
+   * Copy the level vectors @p src in the agglomerated distribution into
+   * original_vectors.
+   */
+  void
+  scatter_level_vectors(
+    const MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &src) const;
+
+  /**
+   * The transfer in the original distribution.
+   */
+  SmartPointer<const MGTransferMatrixFree<dim, Number>,
+               MGTransferAgglomeration<dim, Number>>
+    transfer;
+
+  /**
+   * The description of the agglomeration.
+   */
+  SmartPointer<const MGLevelAgglomeration, MGTransferAgglomeration<dim, Number>>
+    agglomeration;
+
+  /**
+   * Level vectors in the original distribution.
+   */
+  mutable MGLevelObject<LinearAlgebra::distributed::Vector<Number>>
+    original_vectors;
+};
+
+/*@}*/
+
+
+//------------------------ inline and templated functions ---------------------
+#ifndef DOXYGEN
+
+
+inline unsigned int
+MGLevelAgglomeration::min_level() const
+{
+  return level_data.min_level();
+}
+
+
+
+inline unsigned int
+MGLevelAgglomeration::max_level() const
+{
+  return level_data.max_level();
+}
+
+
+
+inline bool
+MGLevelAgglomeration::is_agglomerated(const unsigned int level) const
+{
+  return level_data[level].stride > 1;
+}
+
+
+
+inline bool
+MGLevelAgglomeration::is_active(const unsigned int level) const
+{
+  return Utilities::MPI::this_mpi_process(original_communicator) %
+           level_data[level].stride ==
+         0;
+}
+
+
+
+inline unsigned int
+MGLevelAgglomeration::n_active_processes(const unsigned int level) const
+{
+  return (Utilities::MPI::n_mpi_processes(original_communicator) +
+          level_data[level].stride - 1) /
+         level_data[level].stride;
+}
+
+
+
+inline const MPI_Comm &
+MGLevelAgglomeration::get_communicator(const unsigned int level) const
+{
+  return level_data[level].communicator;
+}
+
+
+
+inline const std::shared_ptr<const Utilities::MPI::Partitioner> &
+MGLevelAgglomeration::get_partitioner(const unsigned int level) const
+{
+  return level_data[level].partitioner;
+}
+
+
+
+inline const std::shared_ptr<const Utilities::MPI::Partitioner> &
+MGLevelAgglomeration::get_original_partitioner(const unsigned int level) const
+{
+  return level_data[level].original_partitioner;
+}
+
+
+
+inline unsigned int
+MGLevelAgglomeration::get_owner(const unsigned int            level,
+                                const types::global_dof_index index) const
+{
+  const std::vector<types::global_dof_index> &starts =
+    level_data[level].original_range_starts;
+  AssertIndexRange(index, starts.back());
+
+  // the last process whose range starts at or before the index is the
+  // owner, which skips processes without any indices
+  const unsigned int original_owner =
+    std::upper_bound(starts.begin(), starts.end(), index) - starts.begin() -
+    1;
+  return original_owner - original_owner % level_data[level].stride;
+}
+
+
+
+template <typename Number>
+void
+MGLevelAgglomeration::initialize_dof_vector(
+  const unsigned int                          level,
+  LinearAlgebra::distributed::Vector<Number> &vec) const
+{
+  vec.reinit(level_data[level].partitioner);
+}
+
+
+
+template <typename Number>
+void
+MGLevelAgglomeration::gather(
+  const unsigned int                                level,
+  LinearAlgebra::distributed::Vector<Number> &      dst,
+  const LinearAlgebra::distributed::Vector<Number> &src,
+  const VectorOperation::values                     operation) const
+{
+  const LevelData &data = level_data[level];
+  AssertDimension(src.local_size(), data.original_partitioner->local_size());
+  AssertDimension(dst.local_size(), data.partitioner->local_size());
+  Assert(operation == VectorOperation::insert ||
+           operation == VectorOperation::add,
+         ExcNotImplemented());
+
+  if (data.stride == 1)
+    {
+      if (operation == VectorOperation::insert)
+        dst.copy_locally_owned_data_from(src);
+      else
+        for (unsigned int i = 0; i < src.local_size(); ++i)
+          dst.local_element(i) += src.local_element(i);
+      return;
+    }
+
+  // write the locally owned entries of the original distribution into the
+  // ghost entries of the transfer vector (or directly into its owned
+  // entries in case the index stays on the present process) and send them
+  // to their new owner
+  LinearAlgebra::distributed::Vector<Number> transfer_vector(
+    data.transfer_partitioner);
+  const types::global_dof_index first_index =
+    data.original_partitioner->local_range().first;
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    transfer_vector(first_index + i) = src.local_element(i);
+  transfer_vector.compress(VectorOperation::add);
+
+  if (operation == VectorOperation::insert)
+    for (unsigned int i = 0; i < dst.local_size(); ++i)
+      dst.local_element(i) = transfer_vector.local_element(i);
+  else
+    for (unsigned int i = 0; i < dst.local_size(); ++i)
+      dst.local_element(i) += transfer_vector.local_element(i);
+}
+
+
+
+template <typename Number>
+void
+MGLevelAgglomeration::scatter(
+  const unsigned int                                level,
+  LinearAlgebra::distributed::Vector<Number> &      dst,
+  const LinearAlgebra::distributed::Vector<Number> &src,
+  const VectorOperation::values                     operation) const
+{
+  const LevelData &data = level_data[level];
+  AssertDimension(src.local_size(), data.partitioner->local_size());
+  AssertDimension(dst.local_size(), data.original_partitioner->local_size());
+  Assert(operation == VectorOperation::insert ||
+           operation == VectorOperation::add,
+         ExcNotImplemented());
+
+  if (data.stride == 1)
+    {
+      if (operation == VectorOperation::insert)
+        dst.copy_locally_owned_data_from(src);
+      else
+        for (unsigned int i = 0; i < src.local_size(); ++i)
+          dst.local_element(i) += src.local_element(i);
+      return;
+    }
+
+  LinearAlgebra::distributed::Vector<Number> transfer_vector(
+    data.transfer_partitioner);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    transfer_vector.local_element(i) = src.local_element(i);
+  transfer_vector.update_ghost_values();
+
+  const types::global_dof_index first_index =
+    data.original_partitioner->local_range().first;
+  if (operation == VectorOperation::insert)
+    for (unsigned int i = 0; i < dst.local_size(); ++i)
+      dst.local_element(i) = transfer_vector(first_index + i);
+  else
+    for (unsigned int i = 0; i < dst.local_size(); ++i)
+      dst.local_element(i) += transfer_vector(first_index + i);
+}
+
+
+
+template <typename Number>
+template <int dim, typename VectorizedArrayType>
+void
+MGAgglomeratedLevelMatrix<Number>::reinit(
+  const MGLevelAgglomeration &                        agglomeration,
+  const unsigned int                                  level,
+  const MatrixFree<dim, Number, VectorizedArrayType> &matrix_free,
+  const Table<3, VectorizedArrayType> &               cell_matrices,
+  const unsigned int                                  dof_no,
+  const unsigned int                                  first_selected_component)
+{
+  using EntryType =
+    std::pair<std::pair<types::global_dof_index, types::global_dof_index>,
+              Number>;
+
+  const Utilities::MPI::Partitioner &mf_partitioner =
+    *matrix_free.get_vector_partitioner(dof_no);
+  AssertDimension(mf_partitioner.size(),
+                  agglomeration.get_original_partitioner(level)->size());
+  AssertDimension(mf_partitioner.local_size(),
+                  agglomeration.get_original_partitioner(level)->local_size());
+  AssertDimension(cell_matrices.size(0), matrix_free.n_macro_cells());
+
+  const unsigned int dofs_per_component =
+    matrix_free.get_shape_info(dof_no).dofs_per_component_on_cell;
+  const unsigned int dofs_per_cell = cell_matrices.size(1);
+  AssertDimension(dofs_per_cell % dofs_per_component, 0);
+  const unsigned int n_components = dofs_per_cell / dofs_per_component;
+
+  // compute the entries of the cell matrices with the constraints applied,
+  // as given by the columns of the constraint matrix on each cell
+  std::vector<EntryType>                                    entries;
+  std::vector<unsigned int>                                 local_columns;
+  std::vector<std::vector<std::pair<unsigned int, Number>>> columns;
+  for (unsigned int cell = 0; cell < matrix_free.n_macro_cells(); ++cell)
+    for (unsigned int v = 0; v < matrix_free.n_components_filled(cell); ++v)
+      {
+        MatrixFreeTools::internal::extract_constrained_columns(
+          matrix_free,
+          dof_no,
+          first_selected_component,
+          n_components,
+          dofs_per_component,
+          cell * VectorizedArrayType::n_array_elements + v,
+          local_columns,
+          columns);
+
+        for (unsigned int i = 0; i < local_columns.size(); ++i)
+          for (unsigned int j = 0; j < local_columns.size(); ++j)
+            {
+              Number value = 0;
+              for (const auto &row_entry : columns[i])
+                for (const auto &column_entry : columns[j])
+                  value += row_entry.second *
+                           cell_matrices(cell,
+                                         row_entry.first,
+                                         column_entry.first)[v] *
+                           column_entry.second;
+              entries.emplace_back(
+                std::make_pair(mf_partitioner.local_to_global(
+                                 local_columns[i]),
+                               mf_partitioner.local_to_global(
+                                 local_columns[j])),
+                value);
+            }
+      }
+  for (const unsigned int i : matrix_free.get_constrained_dofs(dof_no))
+    entries.emplace_back(std::make_pair(mf_partitioner.local_to_global(i),
+                                        mf_partitioner.local_to_global(i)),
+                         Number(1.));
+
+  // send the entries to the owner of the row in the agglomerated
+  // distribution, keeping the ones owned by the present process
+  const MPI_Comm &original_communicator =
+    agglomeration.get_original_partitioner(level)->get_mpi_communicator();
+  const unsigned int my_rank =
+    Utilities::MPI::this_mpi_process(original_communicator);
+  std::map<unsigned int, std::vector<types::global_dof_index>> send_indices;
+  std::map<unsigned int, std::vector<Number>>                  send_values;
+  std::vector<EntryType>                                       owned_entries;
+  for (const EntryType &entry : entries)
+    {
+      const unsigned int owner =
+        agglomeration.get_owner(level, entry.first.first);
+      if (owner == my_rank)
+        owned_entries.push_back(entry);
+      else
+        {
+          send_indices[owner].push_back(entry.first.first);
+          send_indices[owner].push_back(entry.first.second);
+          send_values[owner].push_back(entry.second);
+        }
+    }
+  entries.clear();
+
+  const std::map<unsigned int, std::vector<types::global_dof_index>>
+    received_indices =
+      Utilities::MPI::some_to_some(original_communicator, send_indices);
+  const std::map<unsigned int, std::vector<Number>> received_values =
+    Utilities::MPI::some_to_some(original_communicator, send_values);
+  for (const auto &received : received_indices)
+    {
+      const std::vector<Number> &values_of_process =
+        received_values.find(received.first)->second;
+      AssertDimension(received.second.size(), 2 * values_of_process.size());
+      for (unsigned int i = 0; i < values_of_process.size(); ++i)
+        owned_entries.emplace_back(std::make_pair(received.second[2 * i],
+                                                  received.second[2 * i + 1]),
+                                   values_of_process[i]);
+    }
+
+  // sort the entries and sum up the contributions of different cells
+  std::sort(owned_entries.begin(),
+            owned_entries.end(),
+            [](const EntryType &a, const EntryType &b) {
+              return a.first < b.first;
+            });
+  unsigned int n_unique = 0;
+  for (unsigned int i = 0; i < owned_entries.size(); ++i)
+    if (n_unique > 0 &&
+        owned_entries[n_unique - 1].first == owned_entries[i].first)
+      owned_entries[n_unique - 1].second += owned_entries[i].second;
+    else
+      owned_entries[n_unique++] = owned_entries[i];
+  owned_entries.resize(n_unique);
+
+  build_rows(owned_entries,
+             agglomeration.get_partitioner(level),
+             agglomeration.get_communicator(level));
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2, int spacedim>
+void
+MGTransferAgglomeration<dim, Number>::copy_to_mg(
+  const DoFHandler<dim, spacedim> &                          dof,
+  MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &dst,
+  const LinearAlgebra::distributed::Vector<Number2> &        src) const
+{
+  transfer->copy_to_mg(dof, original_vectors, src);
+
+  const unsigned int min_level = agglomeration->min_level();
+  const unsigned int max_level = agglomeration->max_level();
+  if (dst.min_level() != min_level || dst.max_level() != max_level)
+    dst.resize(min_level, max_level);
+  for (unsigned int level = min_level; level <= max_level; ++level)
+    {
+      if (dst[level].get_partitioner().get() !=
+          agglomeration->get_partitioner(level).get())
+        agglomeration->initialize_dof_vector(level, dst[level]);
+      agglomeration->gather(level, dst[level], original_vectors[level]);
+    }
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2, int spacedim>
+void
+MGTransferAgglomeration<dim, Number>::copy_from_mg(
+  const DoFHandler<dim, spacedim> &                                dof,
+  LinearAlgebra::distributed::Vector<Number2> &                    dst,
+  const MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &src) const
+{
+  scatter_level_vectors(src);
+  transfer->copy_from_mg(dof, dst, original_vectors);
+}
+
+
+
+template <int dim, typename Number>
+template <typename Number2, int spacedim>
+void
+MGTransferAgglomeration<dim, Number>::copy_from_mg_add(
+  const DoFHandler<dim, spacedim> &                                dof,
+  LinearAlgebra::distributed::Vector<Number2> &                    dst,
+  const MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &src) const
+{
+  scatter_level_vectors(src);
+  transfer->copy_from_mg_add(dof, dst, original_vectors);
+}
+
+#endif // DOXYGEN
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
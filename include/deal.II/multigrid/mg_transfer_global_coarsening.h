@@ -0,0 +1,391 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_mg_transfer_global_coarsening_h
+#define dealii_mg_transfer_global_coarsening_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/multigrid/mg_base.h>
+
+#include <memory>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/*!@addtogroup mg */
+/*@{*/
+
+/**
+ * A class implementing the transfer between two DoFHandler objects that are
+ * defined on the same (active) mesh but use finite elements of different
+ * polynomial degree, as used in polynomial (p-) multigrid. Prolongation is
+ * the interpolation of the coarse-space function into the fine space, and
+ * restriction is its transpose.
+ *
+ * The transfer is implemented in a matrix-free way: On each cell, the
+ * degrees of freedom of the coarse element are read from the coarse vector,
+ * the tensor product of the one-dimensional interpolation matrices is
+ * applied with the sum factorization kernels also used by
+ * MGTransferMatrixFree, and the result is written into the fine vector. The
+ * operations are vectorized over several cells. Hanging node constraints of
+ * the coarse space are resolved when reading the coarse degrees of freedom
+ * (and by the transpose operation during restriction). Constrained degrees
+ * of freedom of the fine space are set to zero in prolongation and ignored
+ * in restriction, which is the setting used by matrix-free level operators
+ * that apply the constraints themselves.
+ *
+ * This class currently only works for tensor-product finite elements based
+ * on FE_Q and FE_DGQ (and related) elements, including systems of several
+ * components of one of these elements. Both DoFHandler objects need to have
+ * the same number of components, and the fine element must not have a lower
+ * polynomial degree than the coarse one. The vectors passed to prolongate()
+ * and restrict_and_add() need to have the locally owned degrees of freedom
+ * of the respective DoFHandler; ghost entries are handled internally.
+ *
+ * A hierarchy of such transfers, one per level, can be combined into a
+ * transfer for the Multigrid class with MGTransferGlobalCoarsening.
+ */
+template <int dim, typename Number>
+class MGTwoLevelTransfer : public Subscriptor
+{
+public:
+  /**
+   * Set up the transfer between the finite element spaces described by @p
+   * dof_handler_fine and @p dof_handler_coarse, including their constraints
+   * @p constraint_fine and @p constraint_coarse. The constraints must only
+   * contain homogeneous constraints (inhomogeneities are ignored) and be
+   * closed. For parallel computations, the constraints need to include the
+   * locally relevant degrees of freedom.
+   */
+  template <typename Number2>
+  void
+  reinit_polynomial_transfer(
+    const DoFHandler<dim> &           dof_handler_fine,
+    const DoFHandler<dim> &           dof_handler_coarse,
+    const AffineConstraints<Number2> &constraint_fine,
+    const AffineConstraints<Number2> &constraint_coarse);
+
+  /**
+   * Perform the prolongation of the coarse vector @p src to the fine vector
+   * @p dst. The previous content of @p dst is overwritten.
+   */
+  void
+  prolongate(LinearAlgebra::distributed::Vector<Number> &      dst,
+             const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Perform the restriction of the fine vector @p src and add the result to
+   * the coarse vector @p dst.
+   */
+  void
+  restrict_and_add(LinearAlgebra::distributed::Vector<Number> &      dst,
+                   const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Return the partitioner of the fine space, including the ghost entries
+   * needed by the transfer.
+   */
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &
+  get_partitioner_fine() const;
+
+  /**
+   * Return the partitioner of the coarse space, including the ghost entries
+   * needed by the transfer.
+   */
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &
+  get_partitioner_coarse() const;
+
+  /**
+   * Memory used by this object.
+   */
+  std::size_t
+  memory_consumption() const;
+
+private:
+  /**
+   * The polynomial degree of the fine element.
+   */
+  unsigned int degree_fine;
+
+  /**
+   * The polynomial degree of the coarse element.
+   */
+  unsigned int degree_coarse;
+
+  /**
+   * The number of components of the two elements.
+   */
+  unsigned int n_components;
+
+  /**
+   * The number of locally owned cells.
+   */
+  unsigned int n_cells;
+
+  /**
+   * The one-dimensional interpolation matrix from the coarse to the fine
+   * element in lexicographic numbering, with the coarse basis functions
+   * running along the rows.
+   */
+  AlignedVector<VectorizedArray<Number>> prolongation_matrix_1d;
+
+  /**
+   * The MPI-local indices of the degrees of freedom of the fine element on
+   * all locally owned cells, in lexicographic ordering.
+   */
+  std::vector<unsigned int> dof_indices_fine;
+
+  /**
+   * The weights of the degrees of freedom of the fine element, given by the
+   * inverse of the number of cells a degree of freedom belongs to, or zero
+   * for constrained degrees of freedom. The weights are stored in vectorized
+   * form for each batch of cells.
+   */
+  AlignedVector<VectorizedArray<Number>> weights_fine;
+
+  /**
+   * For each degree of freedom of the coarse element on the locally owned
+   * cells in lexicographic ordering, the start of the entries in
+   * coarse_entries that describe it. Unconstrained degrees of freedom have
+   * one entry with weight one, constrained degrees of freedom the entries of
+   * their constraint.
+   */
+  std::vector<unsigned int> coarse_row_starts;
+
+  /**
+   * The MPI-local indices and weights of the unconstrained coarse degrees of
+   * freedom indexed by coarse_row_starts.
+   */
+  std::vector<std::pair<unsigned int, Number>> coarse_entries;
+
+  /**
+   * The partitioner of the fine space.
+   */
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner_fine;
+
+  /**
+   * The partitioner of the coarse space.
+   */
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner_coarse;
+
+  /**
+   * Internal vector on the fine space with ghost entries.
+   */
+  mutable LinearAlgebra::distributed::Vector<Number> vec_fine;
+
+  /**
+   * Internal vector on the coarse space with ghost entries.
+   */
+  mutable LinearAlgebra::distributed::Vector<Number> vec_coarse;
+
+  /**
+   * Temporary values for the tensor evaluation.
+   */
+  mutable AlignedVector<VectorizedArray<Number>> evaluation_data;
+
+  /**
+   * Perform the cell loop of the prolongation.
+   */
+  template <int degree_fine_, int degree_coarse_>
+  void
+  do_prolongate_add(
+    LinearAlgebra::distributed::Vector<Number> &      dst,
+    const LinearAlgebra::distributed::Vector<Number> &src) const;
+
+  /**
+   * Perform the cell loop of the restriction.
+   */
+  template <int degree_fine_, int degree_coarse_>
+  void
+  do_restrict_add(LinearAlgebra::distributed::Vector<Number> &      dst,
+                  const LinearAlgebra::distributed::Vector<Number> &src) const;
+};
+
+
+
+/**
+ * Implementation of the MGTransferBase interface for a multigrid hierarchy
+ * whose levels are given by independent DoFHandler objects, for example
+ * polynomial multigrid with the degrees $k, k/2, \ldots, 1$ on the same
+ * mesh. The transfer between two levels is given by an MGTwoLevelTransfer
+ * object, where the object on level $l$ describes the transfer between
+ * levels $l-1$ and $l$. The object on the minimal level is not used.
+ *
+ * The finest level must be described by the same DoFHandler as the vectors
+ * passed to copy_to_mg() and copy_from_mg().
+ */
+template <int dim, typename Number>
+class MGTransferGlobalCoarsening
+  : public MGTransferBase<LinearAlgebra::distributed::Vector<Number>>
+{
+public:
+  /**
+   * Constructor taking the two-level transfer objects. The object @p
+   * transfer needs to be alive as long as this class is in use.
+   */
+  MGTransferGlobalCoarsening(
+    const MGLevelObject<MGTwoLevelTransfer<dim, Number>> &transfer);
+
+  /**
+   * Prolongate a vector from level <tt>to_level-1</tt> to level
+   * <tt>to_level</tt>. The previous content of <tt>dst</tt> is overwritten.
+   */
+  virtual void
+  prolongate(
+    const unsigned int                                to_level,
+    LinearAlgebra::distributed::Vector<Number> &      dst,
+    const LinearAlgebra::distributed::Vector<Number> &src) const override;
+
+  /**
+   * Restrict a vector from level <tt>from_level</tt> to level
+   * <tt>from_level-1</tt> and add the result to @p dst.
+   */
+  virtual void
+  restrict_and_add(
+    const unsigned int                                from_level,
+    LinearAlgebra::distributed::Vector<Number> &      dst,
+    const LinearAlgebra::distributed::Vector<Number> &src) const override;
+
+  /**
+   * Initialize the level vectors in @p dst and copy the vector @p src to
+   * the finest level.
+   */
+  template <class InVector, int spacedim>
+  void
+  copy_to_mg(const DoFHandler<dim, spacedim> &                          dof,
+             MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &dst,
+             const InVector &src) const;
+
+  /**
+   * Copy the finest level of @p src to the vector @p dst.
+   */
+  template <class OutVector, int spacedim>
+  void
+  copy_from_mg(
+    const DoFHandler<dim, spacedim> &                                dof,
+    OutVector &                                                      dst,
+    const MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &src) const;
+
+  /**
+   * Add the finest level of @p src to the vector @p dst.
+   */
+  template <class OutVector, int spacedim>
+  void
+  copy_from_mg_add(
+    const DoFHandler<dim, spacedim> &                                dof,
+    OutVector &                                                      dst,
+    const MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &src) const;
+
+private:
+  /**
+   * The two-level transfer objects.
+   */
+  SmartPointer<const MGLevelObject<MGTwoLevelTransfer<dim, Number>>,
+               MGTransferGlobalCoarsening<dim, Number>>
+    transfer;
+};
+
+/*@}*/
+
+
+//------------------------ templated functions -------------------------
+#ifndef DOXYGEN
+
+
+template <int dim, typename Number>
+template <class InVector, int spacedim>
+void
+MGTransferGlobalCoarsening<dim, Number>::copy_to_mg(
+  const DoFHandler<dim, spacedim> &                          dof,
+  MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &dst,
+  const InVector &                                           src) const
+{
+  (void)dof;
+  const unsigned int min_level = transfer->min_level();
+  const unsigned int max_level = transfer->max_level();
+  Assert(max_level > min_level, ExcMessage("At least two levels are needed"));
+
+  if (dst.min_level() != min_level || dst.max_level() != max_level)
+    dst.resize(min_level, max_level);
+  for (unsigned int level = min_level; level <= max_level; ++level)
+    {
+      const Utilities::MPI::Partitioner &partitioner =
+        level == min_level ?
+          *(*transfer)[min_level + 1].get_partitioner_coarse() :
+          *(*transfer)[level].get_partitioner_fine();
+      if (dst[level].local_size() != partitioner.local_size())
+        dst[level].reinit(partitioner.locally_owned_range(),
+                          partitioner.get_mpi_communicator());
+      else
+        dst[level] = 0;
+    }
+
+  AssertDimension(dof.n_dofs(), dst[max_level].size());
+  dst[max_level].copy_locally_owned_data_from(src);
+}
+
+
+
+template <int dim, typename Number>
+template <class OutVector, int spacedim>
+void
+MGTransferGlobalCoarsening<dim, Number>::copy_from_mg(
+  const DoFHandler<dim, spacedim> &                                dof,
+  OutVector &                                                      dst,
+  const MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &src) const
+{
+  (void)dof;
+  AssertDimension(dof.n_dofs(), src[src.max_level()].size());
+  dst.copy_locally_owned_data_from(src[src.max_level()]);
+}
+
+
+
+template <int dim, typename Number>
+template <class OutVector, int spacedim>
+void
+MGTransferGlobalCoarsening<dim, Number>::copy_from_mg_add(
+  const DoFHandler<dim, spacedim> &                                dof,
+  OutVector &                                                      dst,
+  const MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &src) const
+{
+  (void)dof;
+  AssertDimension(dof.n_dofs(), src[src.max_level()].size());
+  AssertDimension(dst.local_size(), src[src.max_level()].local_size());
+  for (unsigned int i = 0; i < dst.local_size(); ++i)
+    dst.local_element(i) += src[src.max_level()].local_element(i);
+}
+
+
+#endif // DOXYGEN
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -31,6 +31,8 @@
 #include <deal.II/multigrid/mg_transfer.h>
 #include <deal.II/multigrid/mg_transfer_internal.h>
 
+#include <array>
+
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -246,7 +248,23 @@ private:
   std::vector<std::vector<std::vector<unsigned short>>> dirichlet_indices;
 
   /**
-   * Perform the prolongation operation.
+   * The cell batches of each level (outer index) sorted into four groups
+   * according to the ghost entries they access: Group 0 holds the batches
+   * that only touch locally owned entries on both the fine and the coarse
+   * level, group 1 those that touch ghost entries on the fine level only,
+   * group 2 those that touch ghost entries on the coarse level only, and
+   * group 3 those that touch ghost entries on both levels. This allows
+   * do_prolongate_add() and do_restrict_add() to work on the first groups
+   * while the ghost values are still being imported, and on half of group 0
+   * while the contributions to ghost entries are sent to their owners.
+   */
+  std::vector<std::array<std::vector<unsigned int>, 4>> cell_batch_groups;
+
+  /**
+   * Perform the prolongation operation. The ghost values of @p src must have
+   * been requested by update_ghost_values_start() on entry, and the function
+   * calls update_ghost_values_finish() on @p src and the compress() operation
+   * on @p dst as soon as the cell batches allow.
    */
   template <int degree>
   void
@@ -256,7 +274,8 @@ private:
     const LinearAlgebra::distributed::Vector<Number> &src) const;
 
   /**
-   * Performs the restriction operation.
+   * Performs the restriction operation, with the same split of communication
+   * as in do_prolongate_add().
    */
   template <int degree>
   void
@@ -0,0 +1,459 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_particles_fe_field_evaluator_h
+#define dealii_particles_fe_field_evaluator_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/vectorization.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/mapping.h>
+#include <deal.II/fe/mapping_cartesian.h>
+#include <deal.II/fe/mapping_q.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/matrix_free/shape_info.h>
+#include <deal.II/matrix_free/tensor_product_kernels.h>
+
+#include <deal.II/particles/particle_arrays.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Particles
+{
+  /**
+   * A class that evaluates a finite element field and its gradient at the
+   * locations of all particles stored in a ParticleArrays object, e.g., the
+   * one returned by ParticleHandler::get_particle_arrays(), and writes the
+   * result into the properties of the particles.
+   *
+   * Evaluating a finite element solution at particle locations with
+   * FEValues requires a new Quadrature object and a call to FEValues::reinit()
+   * for every cell, and FEFieldFunction additionally has to search for the
+   * cell around every point. This class instead exploits the tensor product
+   * structure of the finite element: On each cell, the solution is first
+   * interpolated to the $(k+1)^d$ Gauss points with the sum factorization
+   * kernels of the matrix-free framework. Then, the resulting polynomial is
+   * evaluated at the reference locations of the particles of that cell, using
+   * the one-dimensional Lagrange polynomials in each coordinate direction and
+   * processing as many particles at once as there are lanes in a
+   * VectorizedArray<double>.
+   *
+   * The class supports scalar and vector-valued finite elements whose base
+   * element is a tensor product element supported by the matrix-free
+   * framework, like FE_Q, FE_DGQ, and FE_DGQLegendre (or FESystem objects
+   * consisting of a single such base element). The evaluation of gradients
+   * requires a mapping that is d-linear on every cell, i.e., MappingCartesian,
+   * MappingQGeneric or MappingQ of degree one, because the Jacobian of the
+   * transformation is computed from the vertices of the cell.
+   *
+   * A typical use looks as follows:
+   * @code
+   *   Particles::FEFieldEvaluator<dim> evaluator(mapping, fe);
+   *   // write the velocity into the properties 0 to dim-1 of all particles
+   *   evaluator.evaluate(dof_handler,
+   *                      velocity,
+   *                      particle_handler.get_particle_arrays(),
+   *                      0);
+   * @endcode
+   *
+   * @ingroup Particle
+   */
+  template <int dim>
+  class FEFieldEvaluator
+  {
+  public:
+    /**
+     * Constructor. Sets up the one-dimensional shape information of the
+     * given finite element.
+     */
+    FEFieldEvaluator(const Mapping<dim> &mapping, const FiniteElement<dim> &fe);
+
+    /**
+     * Evaluate the finite element function given by @p dof_handler and
+     * @p solution at the reference locations of all particles in
+     * @p particle_arrays and store the results in the particle properties.
+     *
+     * If @p evaluate_values is set, the values of the $n_c$ components of
+     * the field are written into the properties with indices
+     * <code>[first_property, first_property + n_c)</code>. If
+     * @p evaluate_gradients is set, the $d n_c$ components of the gradients
+     * (with the derivative index running fastest) are written into the
+     * following properties.
+     *
+     * The vector @p solution must allow read access to all degrees of
+     * freedom on the locally owned cells, i.e., parallel vectors must have
+     * their ghost values updated.
+     */
+    template <typename VectorType>
+    void
+    evaluate(const DoFHandler<dim> &dof_handler,
+             const VectorType &     solution,
+             ParticleArrays<dim> &  particle_arrays,
+             const unsigned int     first_property,
+             const bool             evaluate_values    = true,
+             const bool             evaluate_gradients = false) const;
+
+    /**
+     * Return the number of components of the finite element.
+     */
+    unsigned int
+    n_components() const;
+
+    /**
+     * Exception.
+     */
+    DeclExceptionMsg(ExcGradientsNeedLinearMapping,
+                     "The evaluation of gradients with this class is only "
+                     "implemented for mappings that are d-linear on every "
+                     "cell, i.e., MappingCartesian, MappingQGeneric(1), or "
+                     "MappingQ(1).");
+
+  private:
+    /**
+     * Evaluate the Lagrange polynomials in the Gauss points of the shape
+     * info object and their derivatives at the given coordinate.
+     */
+    void
+    evaluate_lagrange_basis(const VectorizedArray<double> &x,
+                            VectorizedArray<double> *      values,
+                            VectorizedArray<double> *      derivatives) const;
+
+    /**
+     * The mapping used to compute the Jacobian of the transformation from
+     * the reference cell for the evaluation of gradients.
+     */
+    SmartPointer<const Mapping<dim>> mapping;
+
+    /**
+     * Whether the mapping is d-linear on every cell.
+     */
+    bool mapping_is_d_linear;
+
+    /**
+     * The number of components of the finite element.
+     */
+    unsigned int n_fe_components;
+
+    /**
+     * The number of degrees of freedom per cell of the finite element.
+     */
+    unsigned int dofs_per_cell;
+
+    /**
+     * The one-dimensional shape functions of the base element evaluated in
+     * the Gauss points, together with the renumbering to lexicographic order.
+     */
+    dealii::internal::MatrixFreeFunctions::ShapeInfo<double> shape_info;
+
+    /**
+     * The one-dimensional Gauss points used as interpolation nodes.
+     */
+    std::vector<double> nodes;
+
+    /**
+     * The inverse of the product of differences between one node and all
+     * others, i.e., the normalization factors of the Lagrange polynomials.
+     */
+    std::vector<double> lagrange_weights;
+  };
+
+
+
+  /* ---------------------- inline and template functions ------------------ */
+
+  template <int dim>
+  FEFieldEvaluator<dim>::FEFieldEvaluator(const Mapping<dim> &      mapping,
+                                          const FiniteElement<dim> &fe)
+    : mapping(&mapping)
+    , mapping_is_d_linear(false)
+    , n_fe_components(fe.n_components())
+    , dofs_per_cell(fe.dofs_per_cell)
+  {
+    AssertThrow(fe.n_base_elements() == 1,
+                ExcMessage("This class only supports finite elements with a "
+                           "single base element."));
+
+    if (dynamic_cast<const MappingCartesian<dim> *>(&mapping) != nullptr)
+      mapping_is_d_linear = true;
+    else if (const MappingQGeneric<dim> *mapping_q_generic =
+               dynamic_cast<const MappingQGeneric<dim> *>(&mapping))
+      mapping_is_d_linear = mapping_q_generic->get_degree() == 1;
+    else if (const MappingQ<dim> *mapping_q =
+               dynamic_cast<const MappingQ<dim> *>(&mapping))
+      mapping_is_d_linear = mapping_q->get_degree() == 1;
+
+    const unsigned int n_points_1d = fe.degree + 1;
+    const QGauss<1>    quadrature(n_points_1d);
+    shape_info.reinit(quadrature, fe, 0);
+
+    AssertThrow(shape_info.element_type <=
+                  dealii::internal::MatrixFreeFunctions::tensor_general,
+                ExcMessage("This class only supports finite elements with a "
+                           "tensor product structure."));
+    AssertDimension(shape_info.n_q_points_1d, shape_info.fe_degree + 1);
+
+    nodes.resize(n_points_1d);
+    lagrange_weights.resize(n_points_1d);
+    for (unsigned int i = 0; i < n_points_1d; ++i)
+      nodes[i] = quadrature.point(i)[0];
+    for (unsigned int i = 0; i < n_points_1d; ++i)
+      {
+        double weight = 1.;
+        for (unsigned int j = 0; j < n_points_1d; ++j)
+          if (j != i)
+            weight *= nodes[i] - nodes[j];
+        lagrange_weights[i] = 1. / weight;
+      }
+  }
+
+
+
+  template <int dim>
+  inline unsigned int
+  FEFieldEvaluator<dim>::n_components() const
+  {
+    return n_fe_components;
+  }
+
+
+
+  template <int dim>
+  inline void
+  FEFieldEvaluator<dim>::evaluate_lagrange_basis(
+    const VectorizedArray<double> &x,
+    VectorizedArray<double> *      values,
+    VectorizedArray<double> *      derivatives) const
+  {
+    // Expand the product of (x - x_j) for all j != i together with its
+    // derivative by the product rule
+    const unsigned int n_nodes = nodes.size();
+    for (unsigned int i = 0; i < n_nodes; ++i)
+      {
+        VectorizedArray<double> value      = 1.;
+        VectorizedArray<double> derivative = 0.;
+        for (unsigned int j = 0; j < n_nodes; ++j)
+          if (j != i)
+            {
+              const VectorizedArray<double> difference = x - nodes[j];
+              derivative = derivative * difference + value;
+              value *= difference;
+            }
+        values[i]      = value * lagrange_weights[i];
+        derivatives[i] = derivative * lagrange_weights[i];
+      }
+  }
+
+
+
+  template <int dim>
+  template <typename VectorType>
+  void
+  FEFieldEvaluator<dim>::evaluate(const DoFHandler<dim> &dof_handler,
+                                  const VectorType &     solution,
+                                  ParticleArrays<dim> &  particle_arrays,
+                                  const unsigned int     first_property,
+                                  const bool             evaluate_values,
+                                  const bool evaluate_gradients) const
+  {
+    constexpr unsigned int n_lanes = VectorizedArray<double>::n_array_elements;
+
+    AssertDimension(dof_handler.get_fe().dofs_per_cell, dofs_per_cell);
+    AssertThrow(evaluate_gradients == false || mapping_is_d_linear,
+                ExcGradientsNeedLinearMapping());
+
+    const unsigned int n_properties =
+      particle_arrays.n_properties_per_particle();
+    const unsigned int first_gradient_property =
+      first_property + (evaluate_values ? n_fe_components : 0);
+    AssertIndexRange(first_gradient_property +
+                       (evaluate_gradients ? dim * n_fe_components : 0),
+                     n_properties + 1);
+
+    const unsigned int n_points_1d = nodes.size();
+    const unsigned int dofs_per_component =
+      Utilities::fixed_power<dim>(n_points_1d);
+
+    using Evaluator = dealii::internal::EvaluatorTensorProduct<
+      dealii::internal::evaluate_general,
+      dim,
+      0,
+      0,
+      double>;
+    const Evaluator eval(shape_info.shape_values,
+                         AlignedVector<double>(),
+                         AlignedVector<double>(),
+                         shape_info.fe_degree + 1,
+                         shape_info.n_q_points_1d);
+
+    Vector<double>        cell_dof_values(dofs_per_cell);
+    AlignedVector<double> point_values(n_fe_components * dofs_per_component);
+    AlignedVector<double> scratch(2 * dofs_per_component);
+
+    AlignedVector<VectorizedArray<double>> shape_values(dim * n_points_1d);
+    AlignedVector<VectorizedArray<double>> shape_derivatives(dim *
+                                                             n_points_1d);
+
+    std::vector<Point<dim>> vertices(GeometryInfo<dim>::vertices_per_cell);
+
+    for (const auto &cell : dof_handler.active_cell_iterators())
+      {
+        const unsigned int n_particles_in_cell =
+          particle_arrays.n_particles_in_cell(cell->active_cell_index());
+        if (n_particles_in_cell == 0)
+          continue;
+
+        // Interpolate the solution on this cell to the tensor product Gauss
+        // points with sum factorization, one component at a time
+        cell->get_dof_values(solution, cell_dof_values);
+        for (unsigned int c = 0; c < n_fe_components; ++c)
+          {
+            double *in  = scratch.begin();
+            double *out = scratch.begin() + dofs_per_component;
+            for (unsigned int i = 0; i < dofs_per_component; ++i)
+              in[i] = cell_dof_values(
+                shape_info.lexicographic_numbering[c * dofs_per_component + i]);
+
+            if (dim == 1)
+              eval.template values<0, true, false>(
+                in, point_values.begin() + c * dofs_per_component);
+            else if (dim == 2)
+              {
+                eval.template values<0, true, false>(in, out);
+                eval.template values<1, true, false>(
+                  out, point_values.begin() + c * dofs_per_component);
+              }
+            else
+              {
+                eval.template values<0, true, false>(in, out);
+                eval.template values<1, true, false>(out, in);
+                eval.template values<2, true, false>(
+                  in, point_values.begin() + c * dofs_per_component);
+              }
+          }
+
+        if (evaluate_gradients)
+          {
+            const auto cell_vertices = mapping->get_vertices(cell);
+            std::copy(cell_vertices.begin(),
+                      cell_vertices.end(),
+                      vertices.begin());
+          }
+
+        const ArrayView<const Point<dim>> reference_locations =
+          particle_arrays.get_reference_locations(cell->active_cell_index());
+        const ArrayView<double> properties =
+          particle_arrays.get_properties(cell->active_cell_index());
+
+        for (unsigned int p = 0; p < n_particles_in_cell; p += n_lanes)
+          {
+            const unsigned int n_filled_lanes =
+              std::min(n_lanes, n_particles_in_cell - p);
+
+            // Gather the reference locations of the next batch of particles
+            // and fill unused lanes with the last particle
+            Point<dim, VectorizedArray<double>> reference_point;
+            for (unsigned int v = 0; v < n_lanes; ++v)
+              for (unsigned int d = 0; d < dim; ++d)
+                reference_point[d][v] =
+                  reference_locations[p + std::min(v, n_filled_lanes - 1)][d];
+
+            for (unsigned int d = 0; d < dim; ++d)
+              evaluate_lagrange_basis(reference_point[d],
+                                      shape_values.begin() + d * n_points_1d,
+                                      shape_derivatives.begin() +
+                                        d * n_points_1d);
+
+            // The inverse transpose Jacobian of the d-linear mapping, built
+            // from the derivatives of the d-linear interpolation of the
+            // vertex positions
+            Tensor<2, dim, VectorizedArray<double>> inverse_jacobian;
+            if (evaluate_gradients)
+              {
+                VectorizedArray<double> linear_values[2 * dim];
+                VectorizedArray<double> linear_derivatives[2 * dim];
+                for (unsigned int d = 0; d < dim; ++d)
+                  {
+                    linear_values[2 * d]          = 1. - reference_point[d];
+                    linear_values[2 * d + 1]      = reference_point[d];
+                    linear_derivatives[2 * d]     = -1.;
+                    linear_derivatives[2 * d + 1] = 1.;
+                  }
+
+                Tensor<2, dim, VectorizedArray<double>> jacobian;
+                double
+                  vertex_coordinates[GeometryInfo<dim>::vertices_per_cell];
+                for (unsigned int e = 0; e < dim; ++e)
+                  {
+                    for (unsigned int v = 0;
+                         v < GeometryInfo<dim>::vertices_per_cell;
+                         ++v)
+                      vertex_coordinates[v] = vertices[v][e];
+                    jacobian[e] = dealii::internal::
+                      evaluate_tensor_product_value_and_gradient<dim>(
+                        2,
+                        linear_values,
+                        linear_derivatives,
+                        vertex_coordinates)
+                        .second;
+                  }
+                inverse_jacobian = transpose(invert(jacobian));
+              }
+
+            for (unsigned int c = 0; c < n_fe_components; ++c)
+              {
+                const std::pair<VectorizedArray<double>,
+                                Tensor<1, dim, VectorizedArray<double>>>
+                  result = dealii::internal::
+                    evaluate_tensor_product_value_and_gradient<dim>(
+                      n_points_1d,
+                      shape_values.begin(),
+                      shape_derivatives.begin(),
+                      point_values.begin() + c * dofs_per_component);
+
+                if (evaluate_values)
+                  for (unsigned int v = 0; v < n_filled_lanes; ++v)
+                    properties[(p + v) * n_properties + first_property + c] =
+                      result.first[v];
+
+                if (evaluate_gradients)
+                  {
+                    const Tensor<1, dim, VectorizedArray<double>> gradient =
+                      inverse_jacobian * result.second;
+                    for (unsigned int v = 0; v < n_filled_lanes; ++v)
+                      for (unsigned int d = 0; d < dim; ++d)
+                        properties[(p + v) * n_properties +
+                                   first_gradient_property + c * dim + d] =
+                          gradient[d][v];
+                  }
+              }
+          }
+      }
+  }
+} // namespace Particles
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
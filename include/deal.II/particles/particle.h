@@ -236,6 +236,9 @@ namespace Particles
      * since the particle does not know about the properties,
      * we want to do it not at construction time. Another use for this
      * function is after particle transfer to a new process.
+     *
+     * If the particle already stores properties, they are copied into a
+     * newly allocated slot of @p property_pool and the old slot is released.
      */
     void
     set_property_pool(PropertyPool &property_pool);
@@ -345,7 +348,13 @@ namespace Particles
 
     if (n_properties > 0)
       {
-        properties = new double[n_properties];
+        // If this particle is not yet associated with a property pool, the
+        // properties are stored in temporary memory that is moved into the
+        // pool by a later call to set_property_pool().
+        if (properties == PropertyPool::invalid_handle)
+          properties = (property_pool != nullptr) ?
+                         property_pool->allocate_properties_array() :
+                         new double[n_properties];
         ar &boost::serialization::make_array(properties, n_properties);
       }
   }
@@ -21,6 +21,7 @@
 #include <deal.II/grid/tria.h>
 
 #include <deal.II/particles/particle.h>
+#include <deal.II/particles/particle_arrays.h>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -93,18 +94,20 @@ namespace Particles
     get_id() const;
 
     /**
-     * Tell the particle where to store its properties (even if it does not
-     * own properties). Usually this is only done once per particle, but
-     * since the particle generator does not know about the properties
-     * we want to do it not at construction time. Another use for this
-     * function is after particle transfer to a new process.
+     * Tell the particle where to store its properties. Since the properties
+     * of the particles accessed by this class are stored in the
+     * ParticleArrays container the particle lives in, this function only
+     * checks that @p property_pool provides the same number of properties
+     * per particle as the container. It is kept for compatibility with the
+     * interface of the Particle class.
      */
     void
     set_property_pool(PropertyPool &property_pool);
 
     /**
-     * Return whether this particle has a valid property pool and a valid
-     * handle to properties.
+     * Return whether properties are stored for this particle, i.e., whether
+     * the container the particle lives in stores a nonzero number of
+     * properties per particle.
      */
     bool
     has_properties() const;
@@ -189,10 +192,23 @@ namespace Particles
      */
     ParticleAccessor();
 
+    /**
+     * Construct an accessor from a reference to a particle container and the
+     * position of the particle within the container. This constructor is
+     * protected so that it can only be accessed by friend classes.
+     */
+    ParticleAccessor(const ParticleArrays<dim, spacedim> &particles,
+                     const unsigned int                   particle_index);
+
     /**
      * Construct an accessor from a reference to a map and an iterator to the
      * map. This constructor is protected so that it can only be accessed by
      * friend classes.
+     *
+     * @deprecated Particles are no longer stored in a map by the
+     * ParticleHandler. Accessors created by this constructor work on the
+     * given map, which is kept for compatibility with the previous particle
+     * storage.
      */
     ParticleAccessor(
       const std::multimap<internal::LevelInd, Particle<dim, spacedim>> &map,
@@ -205,12 +221,25 @@ namespace Particles
      * A pointer to the container that stores the particles. Obviously,
      * this accessor is invalidated if the container changes.
      */
-    std::multimap<internal::LevelInd, Particle<dim, spacedim>> *map;
+    ParticleArrays<dim, spacedim> *particles;
 
     /**
-     * An iterator into the container of particles. Obviously,
+     * The position of the particle within the container. Obviously,
      * this accessor is invalidated if the container changes.
      */
+    unsigned int particle_index;
+
+    /**
+     * A pointer to the map that stores the particles if this accessor was
+     * created by the deprecated constructor above, and a null pointer
+     * otherwise.
+     */
+    std::multimap<internal::LevelInd, Particle<dim, spacedim>> *map;
+
+    /**
+     * An iterator into the map of particles, only used if @p map is not a
+     * null pointer.
+     */
     typename std::multimap<internal::LevelInd,
                            Particle<dim, spacedim>>::iterator particle;
 
@@ -230,7 +259,24 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::serialize(Archive &          ar,
                                              const unsigned int version)
   {
-    return particle->second.serialize(ar, version);
+    (void)version;
+    if (map != nullptr)
+      return particle->second.serialize(ar, version);
+
+    AssertIndexRange(particle_index, particles->n_particles());
+
+    // this has to match the format written by Particle::serialize()
+    unsigned int n_properties = particles->n_properties;
+    ar &particles->locations[particle_index]
+      &particles->reference_locations[particle_index]
+        &particles->ids[particle_index] &n_properties;
+
+    AssertDimension(n_properties, particles->n_properties);
+    if (n_properties > 0)
+      ar &boost::serialization::make_array(
+        particles->properties.begin() +
+          static_cast<std::size_t>(particle_index) * n_properties,
+        n_properties);
   }
 
 
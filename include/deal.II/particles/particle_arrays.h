@@ -0,0 +1,519 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_particles_particle_arrays_h
+#define dealii_particles_particle_arrays_h
+
+#include <deal.II/base/config.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/point.h>
+
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/particles/particle.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Particles
+{
+  // Forward declarations
+#ifndef DOXYGEN
+  template <int, int>
+  class ParticleAccessor;
+  template <int, int>
+  class ParticleHandler;
+#endif
+
+  /**
+   * The container in which a ParticleHandler stores its particles. Rather
+   * than storing every particle as a separate object, this class stores the
+   * locations, reference locations, ids, and properties of all particles in
+   * separate arrays ("structure of arrays"). The particles are sorted by the
+   * active cell index of their surrounding cell, and the particles of each
+   * cell form a contiguous range within each of the arrays whose position
+   * can be queried in constant time.
+   *
+   * This layout is suitable for algorithms that touch every particle in a
+   * tight loop, like the evaluation of a finite element field at the
+   * particle locations or the update of particle locations in an advection
+   * step: the data of consecutive particles is adjacent in memory and the
+   * arrays are exposed as ArrayView objects that can be handed to
+   * vectorized kernels. The arrays of the locally owned particles of a
+   * ParticleHandler are accessible through
+   * ParticleHandler::get_particle_arrays(), and a typical use looks as
+   * follows:
+   * @code
+   *   Particles::ParticleArrays<dim> &particle_arrays =
+   *     particle_handler.get_particle_arrays();
+   *
+   *   const ArrayView<Point<dim>> locations = particle_arrays.get_locations();
+   *   for (unsigned int i = 0; i < locations.size(); ++i)
+   *     locations[i] += time_step * velocities[i];
+   *
+   *   particle_handler.sort_particles_into_subdomains_and_cells();
+   * @endcode
+   *
+   * The ParticleIterator and ParticleAccessor classes provide the
+   * particle-by-particle interface on top of this class. Since the data of
+   * all particles is stored in arrays, inserting or removing particles
+   * invalidates all iterators and views into this object, just like for
+   * std::vector.
+   *
+   * Inserting or removing single particles with insert() and erase() keeps
+   * the particles sorted by cells. Both functions move the particles behind
+   * the inserted or removed one by one position and are therefore of $O(N)$
+   * complexity for $N$ particles. Particles in front of the inserted or
+   * removed particle keep their position. The ParticleHandler adds many
+   * particles at once by appending them at the end of the arrays and
+   * sorting all particles into their cells in a single pass afterwards.
+   * Since this happens within a single call to a ParticleHandler function,
+   * the particles are always sorted when they are accessed from outside.
+   *
+   * @ingroup Particle
+   */
+  template <int dim, int spacedim = dim>
+  class ParticleArrays
+  {
+  public:
+    /**
+     * Constructor. Creates an empty object that stores @p n_properties
+     * properties for each particle.
+     */
+    explicit ParticleArrays(const unsigned int n_properties = 0);
+
+    /**
+     * Remove all particles and set the number of properties stored for each
+     * particle to @p n_properties.
+     */
+    void
+    reinit(const unsigned int n_properties);
+
+    /**
+     * Remove all particles. The number of properties per particle is kept.
+     */
+    void
+    clear();
+
+    /**
+     * Insert a copy of @p particle that lives in the cell @p cell behind the
+     * other particles of that cell and return its position. If the particle
+     * has no properties, the properties stored for it are set to zero.
+     *
+     * This function keeps the particles sorted, but moves all particles
+     * behind the new one, see the documentation of this class.
+     */
+    unsigned int
+    insert(
+      const Particle<dim, spacedim> &particle,
+      const typename Triangulation<dim, spacedim>::active_cell_iterator &cell);
+
+    /**
+     * Remove the particle at position @p index. The particles behind it are
+     * moved forward by one position, so that they keep their relative order
+     * and sorted particles stay sorted. Afterwards, the position @p index
+     * holds the particle that followed the removed one.
+     */
+    void
+    erase(const unsigned int index);
+
+    /**
+     * Remove the particles at the positions given by @p indices. All
+     * particles are removed in a single pass over the arrays, so this
+     * function is of $O(N)$ complexity for $N$ particles regardless of the
+     * number of particles removed. The remaining particles keep their
+     * relative order, and sorted particles stay sorted.
+     */
+    void
+    erase(const std::vector<unsigned int> &indices);
+
+    /**
+     * Return the number of particles stored in this object.
+     */
+    unsigned int
+    n_particles() const;
+
+    /**
+     * Return the number of properties stored for each particle.
+     */
+    unsigned int
+    n_properties_per_particle() const;
+
+    /**
+     * Return whether the particles are sorted by the active cell index of
+     * their cells. This is only false while a ParticleHandler adds many
+     * particles at once, see the documentation of this class.
+     */
+    bool
+    is_sorted() const;
+
+    /**
+     * Return the number of particles in the cell with the given active cell
+     * index.
+     */
+    unsigned int
+    n_particles_in_cell(const unsigned int active_cell_index) const;
+
+    /**
+     * Return the position of the first particle of the cell with the given
+     * active cell index within the arrays of this object. The particles of
+     * the cell are stored at the positions
+     * <code>[first_particle_in_cell(c), first_particle_in_cell(c) +
+     * n_particles_in_cell(c))</code>.
+     */
+    unsigned int
+    first_particle_in_cell(const unsigned int active_cell_index) const;
+
+    /**
+     * Return a view to the locations of all particles.
+     */
+    ArrayView<Point<spacedim>>
+    get_locations();
+
+    /**
+     * Return a view to the locations of all particles.
+     */
+    ArrayView<const Point<spacedim>>
+    get_locations() const;
+
+    /**
+     * Return a view to the locations of the particles in the cell with the
+     * given active cell index.
+     */
+    ArrayView<Point<spacedim>>
+    get_locations(const unsigned int active_cell_index);
+
+    /**
+     * Return a view to the locations of the particles in reference
+     * coordinates of their surrounding cell.
+     */
+    ArrayView<Point<dim>>
+    get_reference_locations();
+
+    /**
+     * Return a view to the locations of the particles in reference
+     * coordinates of their surrounding cell.
+     */
+    ArrayView<const Point<dim>>
+    get_reference_locations() const;
+
+    /**
+     * Return a view to the reference locations of the particles in the cell
+     * with the given active cell index.
+     */
+    ArrayView<Point<dim>>
+    get_reference_locations(const unsigned int active_cell_index);
+
+    /**
+     * Return a view to the ids of all particles.
+     */
+    ArrayView<const types::particle_index>
+    get_ids() const;
+
+    /**
+     * Return a view to the properties of all particles. The properties of
+     * the particle at position @p i are stored at the positions
+     * <code>[i * n_properties_per_particle(), (i + 1) *
+     * n_properties_per_particle())</code>.
+     */
+    ArrayView<double>
+    get_properties();
+
+    /**
+     * Return a view to the properties of all particles.
+     */
+    ArrayView<const double>
+    get_properties() const;
+
+    /**
+     * Return a view to the properties of the particles in the cell with the
+     * given active cell index.
+     */
+    ArrayView<double>
+    get_properties(const unsigned int active_cell_index);
+
+    /**
+     * Return an estimate for the memory consumption (in bytes) of this
+     * object.
+     */
+    std::size_t
+    memory_consumption() const;
+
+  private:
+    /**
+     * Append a particle with the given data at the end of the arrays,
+     * regardless of the cell it lives in. If @p particle_properties is a
+     * null pointer, the properties are set to zero. The arrays need to be
+     * sorted by sort_into_cells() before the particles can be accessed by
+     * cell again.
+     */
+    void
+    push_back(const internal::LevelInd &  cell,
+              const Point<spacedim> &     location,
+              const Point<dim> &          reference_location,
+              const types::particle_index id,
+              const double *const         particle_properties);
+
+    /**
+     * Append the particle at position @p index of @p other, see above.
+     */
+    void
+    push_back(const internal::LevelInd &           cell,
+              const ParticleArrays<dim, spacedim> &other,
+              const unsigned int                   index);
+
+    /**
+     * Append a particle whose data was written by
+     * ParticleAccessor::write_data(), see above. Return a pointer to the
+     * first byte after the data of the particle.
+     */
+    const void *
+    push_back(const internal::LevelInd &cell, const void *data);
+
+    /**
+     * Sort the particles by the active cell index of their cells in
+     * @p triangulation and set up the ranges of particles of each cell. The
+     * sort is stable, i.e., particles within the same cell keep their
+     * relative order. Its cost is linear in the number of particles and the
+     * number of active cells, unless the particles are already sorted for
+     * the current state of @p triangulation, in which case this function
+     * returns immediately.
+     */
+    void
+    sort_into_cells(const Triangulation<dim, spacedim> &triangulation);
+
+    /**
+     * The number of properties stored for each particle.
+     */
+    unsigned int n_properties;
+
+    /**
+     * The position of the first particle of each active cell within the
+     * arrays below. The last entry holds the total number of particles. The
+     * vector is empty as long as no particle has been inserted.
+     */
+    std::vector<unsigned int> cell_offsets;
+
+    /**
+     * Whether the particles are sorted by cells and @p cell_offsets
+     * describes their ranges, see is_sorted().
+     */
+    bool sorted;
+
+    /**
+     * The level and index of the cell each particle lives in.
+     */
+    std::vector<internal::LevelInd> cells;
+
+    /**
+     * The locations of all particles.
+     */
+    AlignedVector<Point<spacedim>> locations;
+
+    /**
+     * The reference locations of all particles.
+     */
+    AlignedVector<Point<dim>> reference_locations;
+
+    /**
+     * The ids of all particles.
+     */
+    std::vector<types::particle_index> ids;
+
+    /**
+     * The properties of all particles.
+     */
+    AlignedVector<double> properties;
+
+    template <int, int>
+    friend class ParticleAccessor;
+    template <int, int>
+    friend class ParticleHandler;
+  };
+
+
+
+  /* ---------------------- inline and template functions ------------------ */
+
+  template <int dim, int spacedim>
+  inline unsigned int
+  ParticleArrays<dim, spacedim>::n_particles() const
+  {
+    return ids.size();
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline unsigned int
+  ParticleArrays<dim, spacedim>::n_properties_per_particle() const
+  {
+    return n_properties;
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline bool
+  ParticleArrays<dim, spacedim>::is_sorted() const
+  {
+    return sorted;
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline unsigned int
+  ParticleArrays<dim, spacedim>::n_particles_in_cell(
+    const unsigned int active_cell_index) const
+  {
+    Assert(sorted,
+           ExcMessage("The particles need to be sorted into their cells "
+                      "before they can be accessed by cell."));
+    if (cell_offsets.empty())
+      return 0;
+
+    AssertIndexRange(active_cell_index + 1, cell_offsets.size());
+    return cell_offsets[active_cell_index + 1] -
+           cell_offsets[active_cell_index];
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline unsigned int
+  ParticleArrays<dim, spacedim>::first_particle_in_cell(
+    const unsigned int active_cell_index) const
+  {
+    Assert(sorted,
+           ExcMessage("The particles need to be sorted into their cells "
+                      "before they can be accessed by cell."));
+    if (cell_offsets.empty())
+      return 0;
+
+    AssertIndexRange(active_cell_index + 1, cell_offsets.size());
+    return cell_offsets[active_cell_index];
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline ArrayView<Point<spacedim>>
+  ParticleArrays<dim, spacedim>::get_locations()
+  {
+    return make_array_view(locations.begin(), locations.end());
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline ArrayView<const Point<spacedim>>
+  ParticleArrays<dim, spacedim>::get_locations() const
+  {
+    return make_array_view(locations.begin(), locations.end());
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline ArrayView<Point<spacedim>>
+  ParticleArrays<dim, spacedim>::get_locations(
+    const unsigned int active_cell_index)
+  {
+    return ArrayView<Point<spacedim>>(
+      locations.begin() + first_particle_in_cell(active_cell_index),
+      n_particles_in_cell(active_cell_index));
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline ArrayView<Point<dim>>
+  ParticleArrays<dim, spacedim>::get_reference_locations()
+  {
+    return make_array_view(reference_locations.begin(),
+                           reference_locations.end());
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline ArrayView<const Point<dim>>
+  ParticleArrays<dim, spacedim>::get_reference_locations() const
+  {
+    return make_array_view(reference_locations.begin(),
+                           reference_locations.end());
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline ArrayView<Point<dim>>
+  ParticleArrays<dim, spacedim>::get_reference_locations(
+    const unsigned int active_cell_index)
+  {
+    return ArrayView<Point<dim>>(reference_locations.begin() +
+                                   first_particle_in_cell(active_cell_index),
+                                 n_particles_in_cell(active_cell_index));
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline ArrayView<const types::particle_index>
+  ParticleArrays<dim, spacedim>::get_ids() const
+  {
+    return make_array_view(ids);
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline ArrayView<double>
+  ParticleArrays<dim, spacedim>::get_properties()
+  {
+    return make_array_view(properties.begin(), properties.end());
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline ArrayView<const double>
+  ParticleArrays<dim, spacedim>::get_properties() const
+  {
+    return make_array_view(properties.begin(), properties.end());
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline ArrayView<double>
+  ParticleArrays<dim, spacedim>::get_properties(
+    const unsigned int active_cell_index)
+  {
+    return ArrayView<double>(
+      properties.begin() +
+        static_cast<std::size_t>(first_particle_in_cell(active_cell_index)) *
+          n_properties,
+      n_particles_in_cell(active_cell_index) * n_properties);
+  }
+} // namespace Particles
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -25,7 +25,10 @@
 
 #include <deal.II/fe/mapping.h>
 
+#include <deal.II/grid/grid_tools_cache.h>
+
 #include <deal.II/particles/particle.h>
+#include <deal.II/particles/particle_arrays.h>
 #include <deal.II/particles/particle_iterator.h>
 #include <deal.II/particles/property_pool.h>
 
@@ -59,6 +62,50 @@ namespace Particles
      */
     using particle_iterator = ParticleIterator<dim, spacedim>;
 
+    /**
+     * A structure that records how the particles were found in their cells
+     * during the last call to sort_particles_into_subdomains_and_cells().
+     * All numbers refer to the locally owned particles of this process
+     * before the particles were exchanged with other processes.
+     */
+    struct SortingStatistics
+    {
+      /**
+       * Constructor. Sets all counters to zero.
+       */
+      SortingStatistics();
+
+      /**
+       * The number of particles that were still inside their previous cell.
+       */
+      types::particle_index n_particles_in_old_cell;
+
+      /**
+       * The number of particles that were found in one of the face
+       * neighbors of their previous cell.
+       */
+      types::particle_index n_particles_in_face_neighbor;
+
+      /**
+       * The number of particles that were found in one of the cells
+       * adjacent to the vertex of their previous cell that is closest to
+       * the particle.
+       */
+      types::particle_index n_particles_in_vertex_neighbor;
+
+      /**
+       * The number of particles whose cell had to be determined by a search
+       * through the whole mesh.
+       */
+      types::particle_index n_particles_found_by_global_search;
+
+      /**
+       * The number of particles that could not be found in any cell and
+       * were removed.
+       */
+      types::particle_index n_particles_lost;
+    };
+
     /**
      * A type that represents a range of particles.
      */
@@ -191,16 +238,43 @@ namespace Particles
       const;
 
     /**
-     * Remove a particle pointed to by the iterator.
+     * Remove a particle pointed to by the iterator. Only locally owned
+     * particles can be removed. The particles behind the removed one are
+     * moved forward by one position in the particle storage, so this
+     * function is of $O(N)$ complexity for $N$ particles. Iterators to
+     * particles in front of the removed one stay valid, and @p particle
+     * points to the particle that followed the removed one afterwards. This
+     * allows to remove particles while iterating over them:
+     * @code
+     *   for (auto particle = particle_handler.begin();
+     *        particle != particle_handler.end();)
+     *     if (particle->get_location()[0] > 1.)
+     *       particle_handler.remove_particle(particle);
+     *     else
+     *       ++particle;
+     * @endcode
+     * Use remove_particles() to remove many particles at once.
      */
     void
     remove_particle(const particle_iterator &particle);
 
+    /**
+     * Remove all particles pointed to by the iterators in @p particles in a
+     * single pass over the particle storage, i.e., at $O(N)$ complexity for
+     * $N$ particles regardless of the number of removed particles. All
+     * particle iterators are invalidated by this function.
+     */
+    void
+    remove_particles(const std::vector<particle_iterator> &particles);
+
     /**
      * Insert a particle into the collection of particles. Return an iterator
      * to the new position of the particle. This function involves a copy of
-     * the particle and its properties. Note that this function is of $O(N \log
-     * N)$ complexity for $N$ particles.
+     * the particle and its properties. The particle is stored behind the
+     * other particles of @p cell, and the particles behind it are moved by
+     * one position, so this function is of $O(N)$ complexity for $N$
+     * particles. Iterators to particles in front of the new one stay valid.
+     * Use insert_particles() to insert many particles at once.
      */
     particle_iterator
     insert_particle(
@@ -313,6 +387,24 @@ namespace Particles
     PropertyPool &
     get_property_pool() const;
 
+    /**
+     * Return a reference to the container that stores the locally owned
+     * particles in arrays sorted by the active cell index of their cells,
+     * see the documentation of the ParticleArrays class. The locations,
+     * reference locations, and properties of the particles can be modified
+     * through this reference. If particles are moved, call
+     * sort_particles_into_subdomains_and_cells() afterwards.
+     */
+    ParticleArrays<dim, spacedim> &
+    get_particle_arrays();
+
+    /**
+     * Return a reference to the container that stores the locally owned
+     * particles.
+     */
+    const ParticleArrays<dim, spacedim> &
+    get_particle_arrays() const;
+
     /**
      * Return the number of particles in the given cell.
      */
@@ -328,10 +420,38 @@ namespace Particles
      * After this function call every particle is either on its current
      * process and in its current cell, or deleted (if it could not find
      * its new process or cell).
+     *
+     * The search for the new cell of a particle that has left its cell
+     * proceeds in stages of increasing cost: First, the face neighbors of
+     * the old cell across the faces that the particle crossed are checked,
+     * then all cells that share the vertex of the old cell that is closest
+     * to the particle, and only if both fail a search through the whole mesh
+     * is started. For particles that move less than one cell per time step,
+     * the cost of this function is therefore proportional to the number of
+     * particles. The search through the whole mesh starts from the vertex
+     * closest to the particle, which is found with a search tree of the
+     * vertices that is only built once for every mesh. How many particles
+     * were found in each of these stages can be queried with
+     * get_sorting_statistics().
+     *
+     * The search for the cells of the particles, as well as the packing and
+     * unpacking of particles that are sent to other processes, is done in
+     * parallel on the threads available to this process (see
+     * MultithreadInfo). The result does not depend on the number of threads.
+     * If a store callback was registered with
+     * register_additional_store_load_functions(), the particles are packed
+     * sequentially because the callback is not required to be thread-safe.
      */
     void
     sort_particles_into_subdomains_and_cells();
 
+    /**
+     * Return the statistics of the last call to
+     * sort_particles_into_subdomains_and_cells().
+     */
+    const SortingStatistics &
+    get_sorting_statistics() const;
+
     /**
      * Exchange all particles that live in cells that are ghost cells to
      * other processes. Clears and re-populates the ghost_neighbors
@@ -378,17 +498,32 @@ namespace Particles
       mapping;
 
     /**
-     * Set of particles currently living in the local domain, organized by
-     * the level/index of the cell they are in.
+     * A cache of the vertex-to-cell maps and the vertex search tree of the
+     * triangulation, which are used to find the cells of particles that
+     * moved. The cache is updated automatically when the triangulation
+     * changes.
+     */
+    std::unique_ptr<GridTools::Cache<dim, spacedim>> triangulation_cache;
+
+    /**
+     * The statistics of the last call to
+     * sort_particles_into_subdomains_and_cells().
+     */
+    SortingStatistics sorting_statistics;
+
+    /**
+     * Set of particles currently living in the local domain, stored in
+     * arrays sorted by the active cell index of the cell they are in.
      */
-    std::multimap<internal::LevelInd, Particle<dim, spacedim>> particles;
+    ParticleArrays<dim, spacedim> particles;
 
     /**
      * Set of particles that currently live in the ghost cells of the local
-     * domain, organized by the level/index of the cell they are in. These
-     * particles are equivalent to the ghost entries in distributed vectors.
+     * domain, stored in arrays sorted by the active cell index of the cell
+     * they are in. These particles are equivalent to the ghost entries in
+     * distributed vectors.
      */
-    std::multimap<internal::LevelInd, Particle<dim, spacedim>> ghost_particles;
+    ParticleArrays<dim, spacedim> ghost_particles;
 
     /**
      * This variable stores how many particles are stored globally. It is
@@ -413,8 +548,10 @@ namespace Particles
     types::particle_index next_free_particle_index;
 
     /**
-     * This object owns and organizes the memory for all particle
-     * properties.
+     * This object owns and organizes the memory for the properties of
+     * particles that are created outside of this class, see
+     * get_property_pool(). The properties of the particles stored in this
+     * class live in the arrays of #particles and #ghost_particles.
      */
     std::unique_ptr<PropertyPool> property_pool;
 
@@ -469,15 +606,17 @@ namespace Particles
      * Transfer particles that have crossed subdomain boundaries to other
      * processors.
      * All received particles and their new cells will be appended to the
-     * @p received_particles vector.
+     * @p received_particles container.
      *
      * @param [in] particles_to_send All particles that should be sent and
      * their new subdomain_ids are in this map.
      *
-     * @param [in,out] received_particles Vector that stores all received
-     * particles. Note that it is not required nor checked that the list
+     * @param [in,out] received_particles Container that stores all received
+     * particles. Note that it is not required nor checked that the container
      * is empty, received particles are simply attached to the end of
-     * the vector.
+     * the arrays without sorting them into their cells. The caller needs to
+     * call ParticleArrays::sort_into_cells() once all particles have been
+     * added.
      *
      * @param [in] new_cells_for_particles Optional vector of cell
      * iterators with the same structure as @p particles_to_send. If this
@@ -490,8 +629,7 @@ namespace Particles
     send_recv_particles(
       const std::map<types::subdomain_id, std::vector<particle_iterator>>
         &particles_to_send,
-      std::multimap<internal::LevelInd, Particle<dim, spacedim>>
-        &received_particles,
+      ParticleArrays<dim, spacedim> &received_particles,
       const std::map<
         types::subdomain_id,
         std::vector<
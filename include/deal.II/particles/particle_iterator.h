@@ -43,8 +43,21 @@ namespace Particles
 
     /**
      * Constructor of the iterator. Takes a reference to the particle
-     * container, and an iterator to the cell-particle pair.
+     * container, and the position of the particle within the container.
      */
+    ParticleIterator(const ParticleArrays<dim, spacedim> &particles,
+                     const unsigned int                   particle_index);
+
+    /**
+     * Constructor of the iterator. Takes a reference to a map of particles,
+     * and an iterator to the cell-particle pair.
+     *
+     * @deprecated The ParticleHandler no longer stores its particles in a
+     * map, but in a ParticleArrays object. Use the constructor above
+     * instead. Iterators created by this constructor still work on the
+     * particles stored in @p map.
+     */
+    DEAL_II_DEPRECATED
     ParticleIterator(
       const std::multimap<internal::LevelInd, Particle<dim, spacedim>> &map,
       const typename std::multimap<internal::LevelInd,
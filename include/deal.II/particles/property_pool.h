@@ -16,8 +16,13 @@
 #ifndef dealii_particles_property_pool_h
 #define dealii_particles_property_pool_h
 
+#include <deal.II/base/config.h>
+
 #include <deal.II/base/array_view.h>
 
+#include <memory>
+#include <vector>
+
 DEAL_II_NAMESPACE_OPEN
 
 namespace Particles
@@ -28,15 +33,29 @@ namespace Particles
    * needs the same amount, it is more efficient to let this be handled by a
    * central manager that does not need to allocate/deallocate memory every
    * time a particle is constructed/destroyed.
-   * The current implementation uses simple new/delete allocation for every
-   * block. Additionally, the current implementation
-   * assumes the same number of properties per particle, but of course the
-   * PropertyType could contain a pointer to dynamically allocated memory
-   * with varying sizes per particle (this memory would not be managed by this
-   * class).
+   *
+   * The current implementation allocates memory in large contiguous chunks,
+   * each of which is subdivided into slots of n_properties_per_slot()
+   * doubles. Handles to released slots are kept in a free list and are handed
+   * out again by subsequent calls to allocate_properties_array(), with slots
+   * at lower addresses being preferred after a call to compact(). This keeps
+   * the properties of many particles close together in memory and avoids
+   * one call to the system allocator per particle. The size of the chunks
+   * grows geometrically with the number of slots in use, but the whole
+   * memory can also be allocated up front by a call to reserve().
+   *
+   * The current implementation assumes the same number of properties per
+   * particle, but of course the PropertyType could contain a pointer to
+   * dynamically allocated memory with varying sizes per particle (this memory
+   * would not be managed by this class).
    * Because PropertyPool only returns handles it could be enhanced internally
    * (e.g. to allow for varying number of properties per handle) without
    * affecting its interface.
+   *
+   * @note Since handles point directly into the memory owned by this class,
+   * all handles become invalid when the pool is destroyed. Furthermore, the
+   * functions of this class are not thread-safe, i.e., allocation and
+   * deallocation of handles must not happen concurrently.
    */
   class PropertyPool
   {
@@ -58,6 +77,11 @@ namespace Particles
      */
     PropertyPool(const unsigned int n_properties_per_slot);
 
+    /**
+     * Destructor. Releases all memory owned by the pool.
+     */
+    ~PropertyPool();
+
     /**
      * Return a new handle that allows accessing the reserved block
      * of memory. If the number of properties is zero this will return an
@@ -83,25 +107,127 @@ namespace Particles
 
     /**
      * Reserve the dynamic memory needed for storing the properties of
-     * @p size particles.
+     * @p size particles. If the pool already provides at least @p size
+     * slots, this function does nothing. Otherwise, the missing slots are
+     * allocated as a single contiguous block of memory.
      */
     void
     reserve(const std::size_t size);
 
+    /**
+     * Release all chunks of memory that do not contain any slot that is
+     * currently in use, and reorder the list of free slots so that
+     * subsequent allocations fill the remaining chunks starting from their
+     * lowest address. This is useful after a large number of particles has
+     * been deleted, e.g., after particles have left the domain or have been
+     * transferred to another process.
+     *
+     * Since the handles that are currently in use are addresses of the
+     * respective slots, this function does not move any properties and all
+     * handles that are currently in use remain valid.
+     */
+    void
+    compact();
+
     /**
      * Return how many properties are stored per slot in the pool.
      */
     unsigned int
     n_properties_per_slot() const;
 
+    /**
+     * Return the number of slots that are currently handed out to callers of
+     * allocate_properties_array(), i.e., that have not been released yet.
+     */
+    std::size_t
+    n_allocated_slots() const;
+
+    /**
+     * Return the number of slots for which the pool currently holds memory,
+     * i.e., the sum of allocated and free slots.
+     */
+    std::size_t
+    n_reserved_slots() const;
+
+    /**
+     * Return an estimate for the memory consumption (in bytes) of this
+     * object.
+     */
+    std::size_t
+    memory_consumption() const;
+
   private:
+    /**
+     * Allocate a new chunk of memory that can hold the properties of
+     * @p n_slots particles and add all of its slots to the list of free
+     * slots.
+     */
+    void
+    allocate_chunk(const std::size_t n_slots);
+
     /**
      * The number of properties that are reserved per particle.
      */
     const unsigned int n_properties;
+
+    /**
+     * The chunks of contiguous memory that are subdivided into slots. Each
+     * chunk stores the properties of chunk_sizes[c] particles.
+     */
+    std::vector<std::unique_ptr<double[]>> chunks;
+
+    /**
+     * The number of slots stored in each of the entries in @p chunks.
+     */
+    std::vector<std::size_t> chunk_sizes;
+
+    /**
+     * A list of handles to slots that are currently not in use. New handles
+     * are taken from the end of this list.
+     */
+    std::vector<Handle> free_slots;
+
+    /**
+     * The total number of slots in all chunks.
+     */
+    std::size_t n_reserved;
   };
 
 
+
+  /* ---------------------- inline and template functions ------------------ */
+
+  inline ArrayView<double>
+  PropertyPool::get_properties(const Handle handle)
+  {
+    return ArrayView<double>(handle, n_properties);
+  }
+
+
+
+  inline unsigned int
+  PropertyPool::n_properties_per_slot() const
+  {
+    return n_properties;
+  }
+
+
+
+  inline std::size_t
+  PropertyPool::n_allocated_slots() const
+  {
+    return n_reserved - free_slots.size();
+  }
+
+
+
+  inline std::size_t
+  PropertyPool::n_reserved_slots() const
+  {
+    return n_reserved;
+  }
+
+
 } // namespace Particles
 
 DEAL_II_NAMESPACE_CLOSE
@@ -114,6 +114,7 @@ namespace GridTools
         for (const auto &it : used_vertices)
           vertices[i++] = std::make_pair(it.second, it.first);
         used_vertices_rtree = pack_rtree(vertices);
+        update_flags        = update_flags & ~update_used_vertices_rtree;
       }
     return used_vertices_rtree;
   }
@@ -137,6 +138,7 @@ namespace GridTools
           boxes[i++] = std::make_pair(mapping->get_bounding_box(cell), cell);
 
         cell_bounding_boxes_rtree = pack_rtree(boxes);
+        update_flags = update_flags & ~update_cell_bounding_boxes_rtree;
       }
     return cell_bounding_boxes_rtree;
   }
@@ -1302,6 +1302,72 @@ ScaLAPACKMatrix<NumberType>::compute_lu_factorization()
 
 
 
+template <typename NumberType>
+void
+ScaLAPACKMatrix<NumberType>::solve(ScaLAPACKMatrix<NumberType> &B,
+                                   const bool transposed) const
+{
+  Assert(state == LAPACKSupport::State::cholesky ||
+           state == LAPACKSupport::State::lu,
+         ExcMessage("The matrix has to be factorized by "
+                    "compute_cholesky_factorization() or "
+                    "compute_lu_factorization() before calling this "
+                    "function."));
+  Assert(B.state == LAPACKSupport::State::matrix,
+         ExcMessage("The right hand side has to be in matrix state."));
+  Assert(grid == B.grid,
+         ExcMessage("The matrices A and B need to have the same process grid"));
+  Assert(n_rows == n_columns, ExcNotQuadratic());
+  AssertDimension(n_rows, B.n_rows);
+  AssertDimension(row_block_size, B.row_block_size);
+
+  if (grid->mpi_process_is_active)
+    {
+      int               info  = 0;
+      const NumberType *A_loc = this->values.data();
+      NumberType *      B_loc = B.values.data();
+
+      if (state == LAPACKSupport::State::cholesky)
+        ppotrs(&uplo,
+               &n_rows,
+               &B.n_columns,
+               A_loc,
+               &submatrix_row,
+               &submatrix_column,
+               descriptor,
+               B_loc,
+               &B.submatrix_row,
+               &B.submatrix_column,
+               B.descriptor,
+               &info);
+      else
+        {
+          const char trans = transposed ? 'T' : 'N';
+          pgetrs(&trans,
+                 &n_rows,
+                 &B.n_columns,
+                 A_loc,
+                 &submatrix_row,
+                 &submatrix_column,
+                 descriptor,
+                 ipiv.data(),
+                 B_loc,
+                 &B.submatrix_row,
+                 &B.submatrix_column,
+                 B.descriptor,
+                 &info);
+        }
+      AssertThrow(info == 0,
+                  LAPACKSupport::ExcErrorCode(state ==
+                                                  LAPACKSupport::State::cholesky ?
+                                                "ppotrs" :
+                                                "pgetrs",
+                                              info));
+    }
+}
+
+
+
 template <typename NumberType>
 void
 ScaLAPACKMatrix<NumberType>::invert()
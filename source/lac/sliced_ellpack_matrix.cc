@@ -0,0 +1,385 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+
+#include <deal.II/lac/sliced_ellpack_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <limits>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <typename number>
+SlicedEllpackMatrix<number>::SlicedEllpackMatrix()
+  : n_rows(0)
+  , n_cols(0)
+  , n_nonzero(0)
+{}
+
+
+
+template <typename number>
+SlicedEllpackMatrix<number>::SlicedEllpackMatrix(
+  const SparseMatrix<number> &matrix,
+  const unsigned int          sorting_window)
+  : SlicedEllpackMatrix()
+{
+  reinit(matrix, sorting_window);
+}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::reinit(const SparseMatrix<number> &matrix,
+                                    const unsigned int          sorting_window)
+{
+  AssertThrow(matrix.n() <=
+                static_cast<size_type>(std::numeric_limits<int>::max()),
+              ExcTooManyColumns());
+  AssertThrow(matrix.m() <=
+                static_cast<size_type>(std::numeric_limits<int>::max()),
+              ExcTooManyColumns());
+
+  n_rows    = matrix.m();
+  n_cols    = matrix.n();
+  n_nonzero = matrix.n_nonzero_elements();
+
+  const unsigned int n_chunks = (n_rows + chunk_size - 1) / chunk_size;
+  const unsigned int window =
+    std::max(1U, (sorting_window + chunk_size - 1) / chunk_size) * chunk_size;
+
+  std::vector<unsigned int> row_lengths(n_rows);
+  for (unsigned int row = 0; row < n_rows; ++row)
+    row_lengths[row] = matrix.get_row_length(row);
+
+  // Sort the rows by decreasing length within each window. A stable sort
+  // keeps rows of equal length in their original order. Padding lanes of the
+  // last chunk point to row zero so that gathering from the vectors in the
+  // original numbering stays valid.
+  row_numbers.resize(n_chunks * chunk_size);
+  for (unsigned int i = 0; i < n_rows; ++i)
+    row_numbers[i] = i;
+  std::fill(row_numbers.begin() + n_rows, row_numbers.end(), 0U);
+  const auto longer_row = [&row_lengths](const unsigned int a,
+                                         const unsigned int b) {
+    return row_lengths[a] > row_lengths[b];
+  };
+  for (unsigned int start = 0; start < n_rows; start += window)
+    std::stable_sort(row_numbers.begin() + start,
+                     row_numbers.begin() +
+                       std::min<std::size_t>(start + window, n_rows),
+                     longer_row);
+
+  row_positions.resize(n_rows);
+  for (unsigned int i = 0; i < n_rows; ++i)
+    row_positions[row_numbers[i]] = i;
+
+  chunk_starts.resize(n_chunks + 1);
+  chunk_starts[0] = 0;
+  for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+    {
+      unsigned int max_length = 0;
+      for (unsigned int v = 0; v < chunk_size; ++v)
+        if (chunk * chunk_size + v < n_rows)
+          max_length =
+            std::max(max_length,
+                     row_lengths[row_numbers[chunk * chunk_size + v]]);
+      chunk_starts[chunk + 1] = chunk_starts[chunk] + max_length;
+    }
+
+  values.resize_fast(chunk_starts.back());
+  column_indices.resize_fast(chunk_starts.back() * chunk_size);
+
+  // Copy the entries of each row into its lane. Padding entries get a zero
+  // value and repeat the last column index of the row, so that the gather
+  // operations access a vector entry that is already in cache.
+  for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+    for (unsigned int v = 0; v < chunk_size; ++v)
+      {
+        const unsigned int slot   = chunk * chunk_size + v;
+        unsigned int       k      = chunk_starts[chunk];
+        unsigned int       column = 0;
+        if (slot < n_rows)
+          {
+            const unsigned int row = row_numbers[slot];
+            for (auto entry = matrix.begin(row); entry != matrix.end(row);
+                 ++entry, ++k)
+              {
+                column                             = entry->column();
+                values[k][v]                       = entry->value();
+                column_indices[k * chunk_size + v] = column;
+              }
+          }
+        for (; k < chunk_starts[chunk + 1]; ++k)
+          {
+            values[k][v]                       = number();
+            column_indices[k * chunk_size + v] = column;
+          }
+      }
+}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::clear()
+{
+  n_rows    = 0;
+  n_cols    = 0;
+  n_nonzero = 0;
+  chunk_starts.clear();
+  row_numbers.clear();
+  row_positions.clear();
+  values.clear();
+  column_indices.clear();
+}
+
+
+
+template <typename number>
+number
+SlicedEllpackMatrix<number>::el(const size_type i, const size_type j) const
+{
+  AssertIndexRange(i, n_rows);
+  AssertIndexRange(j, n_cols);
+
+  const unsigned int slot  = row_positions[i];
+  const unsigned int chunk = slot / chunk_size;
+  const unsigned int lane  = slot % chunk_size;
+
+  // The padding entries repeat the last column of the row, so the first
+  // match is the actual entry
+  for (unsigned int k = chunk_starts[chunk]; k < chunk_starts[chunk + 1]; ++k)
+    if (column_indices[k * chunk_size + lane] == j)
+      return values[k][lane];
+
+  return number();
+}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::vmult_on_subrange(const unsigned int begin_chunk,
+                                               const unsigned int end_chunk,
+                                               const number *     src,
+                                               number *           dst,
+                                               const number *     b,
+                                               const bool         add) const
+{
+  for (unsigned int chunk = begin_chunk; chunk < end_chunk; ++chunk)
+    {
+      VectorizedArray<number> sum = number();
+      for (unsigned int k = chunk_starts[chunk]; k < chunk_starts[chunk + 1];
+           ++k)
+        {
+          VectorizedArray<number> src_values;
+          src_values.gather(src, &column_indices[k * chunk_size]);
+          sum += values[k] * src_values;
+        }
+
+      const unsigned int first_slot = chunk * chunk_size;
+      const unsigned int n_lanes =
+        std::min<unsigned int>(chunk_size, n_rows - first_slot);
+      const unsigned int *rows = &row_numbers[first_slot];
+      if (b != nullptr)
+        for (unsigned int v = 0; v < n_lanes; ++v)
+          dst[rows[v]] = b[rows[v]] - sum[v];
+      else if (add)
+        for (unsigned int v = 0; v < n_lanes; ++v)
+          dst[rows[v]] += sum[v];
+      else
+        for (unsigned int v = 0; v < n_lanes; ++v)
+          dst[rows[v]] = sum[v];
+    }
+}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::vmult(Vector<number> &      dst,
+                                   const Vector<number> &src) const
+{
+  AssertDimension(dst.size(), m());
+  AssertDimension(src.size(), n());
+  Assert(&src != &dst, ExcSourceEqualsDestination());
+
+  parallel::apply_to_subranges(
+    0U,
+    static_cast<unsigned int>(chunk_starts.size() - 1),
+    [&](const unsigned int begin, const unsigned int end) {
+      vmult_on_subrange(begin, end, src.begin(), dst.begin(), nullptr, false);
+    },
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size /
+        chunk_size +
+      1);
+}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::vmult_add(Vector<number> &      dst,
+                                       const Vector<number> &src) const
+{
+  AssertDimension(dst.size(), m());
+  AssertDimension(src.size(), n());
+  Assert(&src != &dst, ExcSourceEqualsDestination());
+
+  parallel::apply_to_subranges(
+    0U,
+    static_cast<unsigned int>(chunk_starts.size() - 1),
+    [&](const unsigned int begin, const unsigned int end) {
+      vmult_on_subrange(begin, end, src.begin(), dst.begin(), nullptr, true);
+    },
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size /
+        chunk_size +
+      1);
+}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::Tvmult(Vector<number> &      dst,
+                                    const Vector<number> &src) const
+{
+  dst = number();
+  Tvmult_add(dst, src);
+}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::Tvmult_add(Vector<number> &      dst,
+                                        const Vector<number> &src) const
+{
+  AssertDimension(dst.size(), n());
+  AssertDimension(src.size(), m());
+  Assert(&src != &dst, ExcSourceEqualsDestination());
+
+  // The entries of one chunk are scattered into different entries of dst,
+  // but the lanes may hit the same column, so the scatter is done one lane
+  // at a time. Padding entries add zero to the last column of their row.
+  const unsigned int n_chunks = chunk_starts.size() - 1;
+  for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+    {
+      VectorizedArray<number> src_values;
+      src_values.gather(src.begin(), &row_numbers[chunk * chunk_size]);
+      for (unsigned int k = chunk_starts[chunk]; k < chunk_starts[chunk + 1];
+           ++k)
+        {
+          const VectorizedArray<number> products = values[k] * src_values;
+          const unsigned int *columns = &column_indices[k * chunk_size];
+          for (unsigned int v = 0; v < chunk_size; ++v)
+            dst(columns[v]) += products[v];
+        }
+    }
+}
+
+
+
+template <typename number>
+number
+SlicedEllpackMatrix<number>::residual(Vector<number> &      dst,
+                                      const Vector<number> &x,
+                                      const Vector<number> &b) const
+{
+  AssertDimension(dst.size(), m());
+  AssertDimension(x.size(), n());
+  AssertDimension(b.size(), m());
+  Assert(&x != &dst, ExcSourceEqualsDestination());
+
+  parallel::apply_to_subranges(
+    0U,
+    static_cast<unsigned int>(chunk_starts.size() - 1),
+    [&](const unsigned int begin, const unsigned int end) {
+      vmult_on_subrange(begin, end, x.begin(), dst.begin(), b.begin(), false);
+    },
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size /
+        chunk_size +
+      1);
+
+  return dst.l2_norm();
+}
+
+
+
+template <typename number>
+number
+SlicedEllpackMatrix<number>::matrix_norm_square(const Vector<number> &v) const
+{
+  AssertDimension(m(), n());
+  AssertDimension(v.size(), m());
+
+  return parallel::accumulate_from_subranges<number>(
+    [&](const unsigned int begin, const unsigned int end) {
+      VectorizedArray<number> result = number();
+      for (unsigned int chunk = begin; chunk < end; ++chunk)
+        {
+          VectorizedArray<number> sum = number();
+          for (unsigned int k = chunk_starts[chunk];
+               k < chunk_starts[chunk + 1];
+               ++k)
+            {
+              VectorizedArray<number> src_values;
+              src_values.gather(v.begin(), &column_indices[k * chunk_size]);
+              sum += values[k] * src_values;
+            }
+
+          // The padding lanes of the last chunk only contain zeros, so they
+          // do not contribute
+          VectorizedArray<number> row_values;
+          row_values.gather(v.begin(), &row_numbers[chunk * chunk_size]);
+          result += sum * row_values;
+        }
+
+      number sum = number();
+      for (unsigned int l = 0; l < chunk_size; ++l)
+        sum += result[l];
+      return sum;
+    },
+    0U,
+    static_cast<unsigned int>(chunk_starts.size() - 1),
+    internal::SparseMatrixImplementation::minimum_parallel_grain_size /
+        chunk_size +
+      1);
+}
+
+
+
+template <typename number>
+std::size_t
+SlicedEllpackMatrix<number>::memory_consumption() const
+{
+  return sizeof(*this) + MemoryConsumption::memory_consumption(chunk_starts) +
+         MemoryConsumption::memory_consumption(row_numbers) +
+         MemoryConsumption::memory_consumption(row_positions) +
+         values.memory_consumption() + column_indices.memory_consumption();
+}
+
+
+#include "sliced_ellpack_matrix.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -336,6 +336,20 @@ namespace internal
     void
     TaskInfo::loop(MFWorkerInterface &funct) const
     {
+      // the index after the last partition refers to the operations on
+      // vector entries that are exchanged with other processors
+      const unsigned int n_chunks =
+        partition_row_index[partition_row_index.size() - 2];
+
+#ifdef DEAL_II_WITH_THREADS
+      // the threaded schedules do not follow the order of the partitions,
+      // so run the operations before and after the loop on the whole vector
+      if (scheme != none)
+        funct.cell_loop_pre_range(numbers::invalid_unsigned_int);
+      else
+#endif
+        funct.cell_loop_pre_range(n_chunks);
+
       funct.vector_update_ghosts_start();
 
 #ifdef DEAL_II_WITH_THREADS
@@ -585,6 +599,7 @@ namespace internal
                    ++i)
                 {
                   AssertIndexRange(i + 1, cell_partition_data.size());
+                  funct.cell_loop_pre_range(i);
                   if (cell_partition_data[i + 1] > cell_partition_data[i])
                     {
                       funct.zero_dst_vector_range(i);
@@ -603,6 +618,7 @@ namespace internal
                           std::make_pair(boundary_partition_data[i],
                                          boundary_partition_data[i + 1]));
                     }
+                  funct.cell_loop_post_range(i);
                 }
 
               if (part == 1)
@@ -610,6 +626,13 @@ namespace internal
             }
         }
       funct.vector_compress_finish();
+
+#ifdef DEAL_II_WITH_THREADS
+      if (scheme != none)
+        funct.cell_loop_post_range(numbers::invalid_unsigned_int);
+      else
+#endif
+        funct.cell_loop_post_range(n_chunks);
     }
 
 
@@ -0,0 +1,320 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/multigrid/mg_coarse_scalapack.h>
+
+#ifdef DEAL_II_WITH_SCALAPACK
+
+#  include <deal.II/base/memory_consumption.h>
+#  include <deal.II/base/mpi.h>
+#  include <deal.II/base/mpi.templates.h>
+#  include <deal.II/base/process_grid.h>
+#  include <deal.II/base/std_cxx14/memory.h>
+
+#  include <deal.II/lac/scalapack.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <typename Number>
+MGCoarseGridScaLAPACK<Number>::AdditionalData::AdditionalData(
+  const bool         symmetric,
+  const unsigned int block_size)
+  : symmetric(symmetric)
+  , block_size(block_size)
+{}
+
+
+
+template <typename Number>
+void
+MGCoarseGridScaLAPACK<Number>::clear()
+{
+  partitioner.reset();
+  factorization.reset();
+  grid_vector.reset();
+  send_indices.clear();
+  send_counts.clear();
+  send_displacements.clear();
+  receive_rows.clear();
+  receive_counts.clear();
+  receive_displacements.clear();
+  send_buffer.clear();
+  receive_buffer.clear();
+}
+
+
+
+template <typename Number>
+void
+MGCoarseGridScaLAPACK<Number>::compute_factorization(
+  const std::vector<Number> &local_rows,
+  const AdditionalData &     additional_data)
+{
+  const MPI_Comm     communicator = partitioner->get_mpi_communicator();
+  const unsigned int n            = partitioner->size();
+  const unsigned int n_local      = partitioner->local_size();
+  const unsigned int first_row    = partitioner->local_range().first;
+  AssertDimension(local_rows.size(), static_cast<std::size_t>(n_local) * n);
+
+  // set up the process grid for a matrix of this size. The factorization
+  // and the right hand side of operator() are stored block-cyclically on it
+  const unsigned int block_size =
+    std::max(1U, std::min(additional_data.block_size, n));
+  const auto grid = std::make_shared<Utilities::MPI::ProcessGrid>(
+    communicator, n, n, block_size, block_size);
+  factorization = std_cxx14::make_unique<ScaLAPACKMatrix<Number>>(
+    n,
+    grid,
+    block_size,
+    additional_data.symmetric ? LAPACKSupport::Property::symmetric :
+                                LAPACKSupport::Property::general);
+  grid_vector = std_cxx14::make_unique<ScaLAPACKMatrix<Number>>(
+    n, 1, grid, block_size, 1, LAPACKSupport::Property::general);
+
+  // collect the locally owned ranges of all processes and the position of
+  // the active processes in the grid
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes(communicator);
+  const int          n_process_rows    = grid->get_process_grid_rows();
+  const int          n_process_columns = grid->get_process_grid_columns();
+  const int          my_process_row    = grid->get_this_process_row();
+  const int          my_process_column = grid->get_this_process_column();
+  const bool         is_active         = grid->is_process_active();
+  int my_data[4] = {static_cast<int>(n_local),
+                    static_cast<int>(first_row),
+                    is_active ? my_process_row : -1,
+                    is_active ? my_process_column : -1};
+  std::vector<int> all_data(4 * n_procs);
+  int              ierr = MPI_Allgather(
+    my_data, 4, MPI_INT, all_data.data(), 4, MPI_INT, communicator);
+  AssertThrowMPI(ierr);
+
+  std::vector<int> grid_ranks(n_process_rows * n_process_columns, -1);
+  for (unsigned int p = 0; p < n_procs; ++p)
+    if (all_data[4 * p + 2] >= 0)
+      grid_ranks[all_data[4 * p + 2] * n_process_columns +
+                 all_data[4 * p + 3]] = p;
+
+  // the block-cyclic distribution with the first block on the first
+  // process row and column
+  const auto owning_rank = [&](const unsigned int row,
+                               const unsigned int column) {
+    return grid_ranks[((row / block_size) % n_process_rows) *
+                        n_process_columns +
+                      (column / block_size) % n_process_columns];
+  };
+  const auto local_index = [&](const unsigned int index,
+                               const int          n_processes) {
+    return (index / (block_size * n_processes)) * block_size +
+           index % block_size;
+  };
+
+  // send the matrix entries to their owners in the block-cyclic
+  // distribution. The receiving processes know the rows of all processes
+  // and thus the order of the entries, so only the values are sent
+  const MPI_Datatype mpi_type =
+    Utilities::MPI::internal::mpi_type_id(local_rows.data());
+  {
+    std::vector<int> matrix_send_counts(n_procs), matrix_send_offsets(n_procs);
+    std::vector<int> matrix_receive_counts(n_procs),
+      matrix_receive_offsets(n_procs);
+    for (unsigned int i = 0; i < n_local; ++i)
+      for (unsigned int j = 0; j < n; ++j)
+        ++matrix_send_counts[owning_rank(first_row + i, j)];
+    for (unsigned int p = 1; p < n_procs; ++p)
+      matrix_send_offsets[p] =
+        matrix_send_offsets[p - 1] + matrix_send_counts[p - 1];
+
+    std::vector<Number> send_data(local_rows.size());
+    std::vector<int>    position(matrix_send_offsets);
+    for (unsigned int i = 0; i < n_local; ++i)
+      for (unsigned int j = 0; j < n; ++j)
+        send_data[position[owning_rank(first_row + i, j)]++] =
+          local_rows[static_cast<std::size_t>(i) * n + j];
+
+    // count the entries received from each process
+    const unsigned int n_my_columns =
+      is_active ? factorization->local_n() : 0;
+    unsigned int n_received = 0;
+    for (unsigned int p = 0; p < n_procs; ++p)
+      {
+        matrix_receive_offsets[p] = n_received;
+        unsigned int n_my_rows    = 0;
+        if (is_active)
+          for (int i = all_data[4 * p + 1];
+               i < all_data[4 * p + 1] + all_data[4 * p];
+               ++i)
+            if (static_cast<int>((i / block_size) % n_process_rows) ==
+                my_process_row)
+              ++n_my_rows;
+        matrix_receive_counts[p] = n_my_rows * n_my_columns;
+        n_received += matrix_receive_counts[p];
+      }
+
+    std::vector<Number> receive_data(n_received);
+    ierr = MPI_Alltoallv(send_data.data(),
+                         matrix_send_counts.data(),
+                         matrix_send_offsets.data(),
+                         mpi_type,
+                         receive_data.data(),
+                         matrix_receive_counts.data(),
+                         matrix_receive_offsets.data(),
+                         mpi_type,
+                         communicator);
+    AssertThrowMPI(ierr);
+
+    // the entries of each process arrive row by row in the order of
+    // increasing column indices
+    if (is_active)
+      {
+        unsigned int index = 0;
+        for (unsigned int p = 0; p < n_procs; ++p)
+          for (int i = all_data[4 * p + 1];
+               i < all_data[4 * p + 1] + all_data[4 * p];
+               ++i)
+            if (static_cast<int>((i / block_size) % n_process_rows) ==
+                my_process_row)
+              for (unsigned int j = 0; j < n; ++j)
+                if (static_cast<int>((j / block_size) % n_process_columns) ==
+                    my_process_column)
+                  factorization->local_el(local_index(i, n_process_rows),
+                                          local_index(j, n_process_columns)) =
+                    receive_data[index++];
+        AssertDimension(index, n_received);
+      }
+  }
+
+  if (additional_data.symmetric)
+    factorization->compute_cholesky_factorization();
+  else
+    factorization->compute_lu_factorization();
+
+  // set up the communication pattern for the vectors in operator(). The
+  // right hand side lives on the first column of the process grid
+  send_counts.assign(n_procs, 0);
+  send_displacements.assign(n_procs, 0);
+  for (unsigned int i = 0; i < n_local; ++i)
+    ++send_counts[owning_rank(first_row + i, 0)];
+  for (unsigned int p = 1; p < n_procs; ++p)
+    send_displacements[p] = send_displacements[p - 1] + send_counts[p - 1];
+  send_indices.resize(n_local);
+  {
+    std::vector<int> position(send_displacements);
+    for (unsigned int i = 0; i < n_local; ++i)
+      send_indices[position[owning_rank(first_row + i, 0)]++] = i;
+  }
+
+  receive_counts.assign(n_procs, 0);
+  receive_displacements.assign(n_procs, 0);
+  receive_rows.clear();
+  for (unsigned int p = 0; p < n_procs; ++p)
+    {
+      receive_displacements[p] = receive_rows.size();
+      if (is_active && my_process_column == 0)
+        for (int i = all_data[4 * p + 1];
+             i < all_data[4 * p + 1] + all_data[4 * p];
+             ++i)
+          if (static_cast<int>((i / block_size) % n_process_rows) ==
+              my_process_row)
+            receive_rows.push_back(local_index(i, n_process_rows));
+      receive_counts[p] = receive_rows.size() - receive_displacements[p];
+    }
+
+  send_buffer.resize(send_indices.size());
+  receive_buffer.resize(receive_rows.size());
+}
+
+
+
+template <typename Number>
+void
+MGCoarseGridScaLAPACK<Number>::operator()(const unsigned int /*level*/,
+                                          VectorType &      dst,
+                                          const VectorType &src) const
+{
+  Assert(factorization.get() != nullptr, ExcNotInitialized());
+  AssertDimension(src.local_size(), send_indices.size());
+  AssertDimension(dst.local_size(), send_indices.size());
+
+  const MPI_Comm     communicator = partitioner->get_mpi_communicator();
+  const MPI_Datatype mpi_type =
+    Utilities::MPI::internal::mpi_type_id(send_buffer.data());
+
+  // send the right hand side to the first column of the process grid
+  for (unsigned int i = 0; i < send_indices.size(); ++i)
+    send_buffer[i] = src.local_element(send_indices[i]);
+  int ierr = MPI_Alltoallv(send_buffer.data(),
+                           DEAL_II_MPI_CONST_CAST(send_counts.data()),
+                           DEAL_II_MPI_CONST_CAST(send_displacements.data()),
+                           mpi_type,
+                           receive_buffer.data(),
+                           DEAL_II_MPI_CONST_CAST(receive_counts.data()),
+                           DEAL_II_MPI_CONST_CAST(receive_displacements.data()),
+                           mpi_type,
+                           communicator);
+  AssertThrowMPI(ierr);
+  for (unsigned int i = 0; i < receive_rows.size(); ++i)
+    grid_vector->local_el(receive_rows[i], 0) = receive_buffer[i];
+
+  factorization->solve(*grid_vector);
+
+  // and return the solution to the owners of the vector entries
+  for (unsigned int i = 0; i < receive_rows.size(); ++i)
+    receive_buffer[i] = grid_vector->local_el(receive_rows[i], 0);
+  ierr = MPI_Alltoallv(receive_buffer.data(),
+                       DEAL_II_MPI_CONST_CAST(receive_counts.data()),
+                       DEAL_II_MPI_CONST_CAST(receive_displacements.data()),
+                       mpi_type,
+                       send_buffer.data(),
+                       DEAL_II_MPI_CONST_CAST(send_counts.data()),
+                       DEAL_II_MPI_CONST_CAST(send_displacements.data()),
+                       mpi_type,
+                       communicator);
+  AssertThrowMPI(ierr);
+  for (unsigned int i = 0; i < send_indices.size(); ++i)
+    dst.local_element(send_indices[i]) = send_buffer[i];
+}
+
+
+
+template <typename Number>
+std::size_t
+MGCoarseGridScaLAPACK<Number>::memory_consumption() const
+{
+  std::size_t memory =
+    MemoryConsumption::memory_consumption(send_indices) +
+    MemoryConsumption::memory_consumption(send_counts) +
+    MemoryConsumption::memory_consumption(send_displacements) +
+    MemoryConsumption::memory_consumption(receive_rows) +
+    MemoryConsumption::memory_consumption(receive_counts) +
+    MemoryConsumption::memory_consumption(receive_displacements) +
+    MemoryConsumption::memory_consumption(send_buffer) +
+    MemoryConsumption::memory_consumption(receive_buffer);
+  if (factorization.get() != nullptr && factorization->local_m() > 0)
+    memory += static_cast<std::size_t>(factorization->local_m()) *
+                factorization->local_n() * sizeof(Number) +
+              static_cast<std::size_t>(grid_vector->local_m()) *
+                grid_vector->local_n() * sizeof(Number);
+  return memory;
+}
+
+
+// explicit instantiations
+#  include "mg_coarse_scalapack.inst"
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // DEAL_II_WITH_SCALAPACK
@@ -16,6 +16,7 @@
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/mg_level_object.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/work_stream.h>
 
 #include <deal.II/dofs/dof_accessor.h>
 #include <deal.II/dofs/dof_handler.h>
@@ -582,22 +583,46 @@ namespace MGTools
     Assert(sparsity.n_cols() == n_dofs,
            ExcDimensionMismatch(sparsity.n_cols(), n_dofs));
 
+    // the dof indices of the cells are extracted and sorted in parallel,
+    // whereas the copier adds them to the sparsity pattern one cell at a
+    // time, because adding entries is not thread-safe
     const unsigned int dofs_per_cell = dof.get_fe().dofs_per_cell;
-    std::vector<types::global_dof_index>   dofs_on_this_cell(dofs_per_cell);
-    typename DoFHandlerType::cell_iterator cell = dof.begin(level),
-                                           endc = dof.end(level);
-    for (; cell != endc; ++cell)
-      if (dof.get_triangulation().locally_owned_subdomain() ==
-            numbers::invalid_subdomain_id ||
-          cell->level_subdomain_id() ==
-            dof.get_triangulation().locally_owned_subdomain())
-        {
-          cell->get_mg_dof_indices(dofs_on_this_cell);
-          // make sparsity pattern for this cell
-          for (unsigned int i = 0; i < dofs_per_cell; ++i)
-            for (unsigned int j = 0; j < dofs_per_cell; ++j)
-              sparsity.add(dofs_on_this_cell[i], dofs_on_this_cell[j]);
-        }
+    const auto         worker =
+      [&dof, dofs_per_cell](
+        const typename DoFHandlerType::level_cell_iterator &cell,
+        void *,
+        std::vector<types::global_dof_index> &dofs_on_this_cell) {
+        if (dof.get_triangulation().locally_owned_subdomain() ==
+              numbers::invalid_subdomain_id ||
+            cell->level_subdomain_id() ==
+              dof.get_triangulation().locally_owned_subdomain())
+          {
+            dofs_on_this_cell.resize(dofs_per_cell);
+            cell->get_mg_dof_indices(dofs_on_this_cell);
+            std::sort(dofs_on_this_cell.begin(), dofs_on_this_cell.end());
+          }
+        else
+          dofs_on_this_cell.clear();
+      };
+    const auto copier =
+      [&sparsity](
+        const std::vector<types::global_dof_index> &dofs_on_this_cell) {
+        // make sparsity pattern for this cell
+        for (const types::global_dof_index row : dofs_on_this_cell)
+          sparsity.add_entries(row,
+                               dofs_on_this_cell.begin(),
+                               dofs_on_this_cell.end(),
+                               true);
+      };
+
+    WorkStream::run(dof.begin(level),
+                    dof.end(level),
+                    worker,
+                    copier,
+                    /* scratch_data */ nullptr,
+                    std::vector<types::global_dof_index>(dofs_per_cell),
+                    2 * MultithreadInfo::n_threads(),
+                    /* chunk_size = */ 32);
   }
 
 
@@ -1315,138 +1340,124 @@ namespace MGTools
 
     const unsigned int n_components = DoFTools::n_components(dof);
     const bool         fe_is_system = (n_components != 1);
-
-    std::vector<types::global_dof_index> local_dofs;
-    local_dofs.reserve(DoFTools::max_dofs_per_face(dof));
-    std::fill(local_dofs.begin(), local_dofs.end(), numbers::invalid_dof_index);
-
-    // First, deal with the simpler case when we have to identify all boundary
-    // dofs
-    if (component_mask.n_selected_components(n_components) == n_components)
-      {
-        typename DoFHandler<dim, spacedim>::cell_iterator cell = dof.begin(),
-                                                          endc = dof.end();
-        for (; cell != endc; ++cell)
+    const bool         all_components_selected =
+      component_mask.n_selected_components(n_components) == n_components;
+    const unsigned int max_dofs_per_face = DoFTools::max_dofs_per_face(dof);
+
+    Assert(component_mask.n_selected_components(n_components) > 0,
+           ExcMessage(
+             "It's probably worthwhile to select at least one component."));
+
+    // The cells of all levels are worked on in parallel, with the boundary
+    // dofs collected in plain vectors that are merged and sorted once per
+    // level. This avoids adding the indices face by face to the IndexSet,
+    // which repeatedly needs to merge overlapping ranges.
+    const auto collect_cell =
+      [&](const typename DoFHandler<dim, spacedim>::level_cell_iterator &cell,
+          std::vector<types::global_dof_index> &boundary_dofs) {
+        if (dof.get_triangulation().locally_owned_subdomain() !=
+              numbers::invalid_subdomain_id &&
+            cell->level_subdomain_id() == numbers::artificial_subdomain_id)
+          return;
+        if (cell->at_boundary() == false)
+          return;
+
+        const unsigned int                  level = cell->level();
+        const FiniteElement<dim, spacedim> &fe    = cell->get_fe();
+        std::vector<types::global_dof_index> local_dofs;
+        local_dofs.reserve(max_dofs_per_face);
+
+        for (unsigned int face_no = 0;
+             face_no < GeometryInfo<dim>::faces_per_cell;
+             ++face_no)
           {
-            if (dof.get_triangulation().locally_owned_subdomain() !=
-                  numbers::invalid_subdomain_id &&
-                cell->level_subdomain_id() == numbers::artificial_subdomain_id)
+            if (cell->at_boundary(face_no) == false)
+              continue;
+
+            const typename DoFHandler<dim, spacedim>::face_iterator face =
+              cell->face(face_no);
+            // only consider faces listed in the boundary map
+            if (boundary_ids.find(face->boundary_id()) == boundary_ids.end())
               continue;
-            const FiniteElement<dim> &fe    = cell->get_fe();
-            const unsigned int        level = cell->level();
+
             local_dofs.resize(fe.dofs_per_face);
+            face->get_mg_dof_indices(level, local_dofs);
 
-            for (unsigned int face_no = 0;
-                 face_no < GeometryInfo<dim>::faces_per_cell;
-                 ++face_no)
-              if (cell->at_boundary(face_no) == true)
-                {
-                  const typename DoFHandler<dim, spacedim>::face_iterator face =
-                    cell->face(face_no);
-                  const types::boundary_id bi = face->boundary_id();
-                  // Face is listed in boundary map
-                  if (boundary_ids.find(bi) != boundary_ids.end())
-                    {
-                      face->get_mg_dof_indices(level, local_dofs);
-                      boundary_indices[level].add_indices(local_dofs.begin(),
-                                                          local_dofs.end());
-                    }
-                }
-          }
-      }
-    else
-      {
-        Assert(component_mask.n_selected_components(n_components) > 0,
-               ExcMessage(
-                 "It's probably worthwhile to select at least one component."));
-
-        typename DoFHandler<dim, spacedim>::cell_iterator cell = dof.begin(),
-                                                          endc = dof.end();
-        for (; cell != endc; ++cell)
-          if (dof.get_triangulation().locally_owned_subdomain() ==
-                numbers::invalid_subdomain_id ||
-              cell->level_subdomain_id() != numbers::artificial_subdomain_id)
-            for (unsigned int face_no = 0;
-                 face_no < GeometryInfo<dim>::faces_per_cell;
-                 ++face_no)
+            // First, deal with the simpler case when we have to identify
+            // all boundary dofs
+            if (all_components_selected || !fe_is_system)
               {
-                if (cell->at_boundary(face_no) == false)
-                  continue;
+                boundary_dofs.insert(boundary_dofs.end(),
+                                     local_dofs.begin(),
+                                     local_dofs.end());
+                continue;
+              }
 
-                const FiniteElement<dim> &fe    = cell->get_fe();
-                const unsigned int        level = cell->level();
+            for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+              {
+                const ComponentMask &nonzero_component_array =
+                  fe.get_nonzero_components(i);
+                // if we want to constrain one of the nonzero
+                // components, we have to constrain all of them
+
+                bool selected = false;
+                for (unsigned int c = 0; c < n_components; ++c)
+                  if (nonzero_component_array[c] == true &&
+                      component_mask[c] == true)
+                    {
+                      selected = true;
+                      break;
+                    }
+                if (selected)
+                  for (unsigned int c = 0; c < n_components; ++c)
+                    Assert(
+                      nonzero_component_array[c] == false ||
+                        component_mask[c] == true,
+                      ExcMessage(
+                        "You are using a non-primitive FiniteElement "
+                        "and try to constrain just some of its components!"));
+              }
 
-                typename DoFHandler<dim, spacedim>::face_iterator face =
-                  cell->face(face_no);
-                const types::boundary_id boundary_component =
-                  face->boundary_id();
-                if (boundary_ids.find(boundary_component) != boundary_ids.end())
-                  // we want to constrain this boundary
+            for (unsigned int i = 0; i < local_dofs.size(); ++i)
+              {
+                unsigned int component = numbers::invalid_unsigned_int;
+                if (fe.is_primitive())
+                  component = fe.face_system_to_component_index(i).first;
+                else
                   {
-                    for (unsigned int i = 0; i < cell->get_fe().dofs_per_cell;
-                         ++i)
-                      {
-                        const ComponentMask &nonzero_component_array =
-                          cell->get_fe().get_nonzero_components(i);
-                        // if we want to constrain one of the nonzero
-                        // components, we have to constrain all of them
-
-                        bool selected = false;
-                        for (unsigned int c = 0; c < n_components; ++c)
-                          if (nonzero_component_array[c] == true &&
-                              component_mask[c] == true)
-                            {
-                              selected = true;
-                              break;
-                            }
-                        if (selected)
-                          for (unsigned int c = 0; c < n_components; ++c)
-                            Assert(
-                              nonzero_component_array[c] == false ||
-                                component_mask[c] == true,
-                              ExcMessage(
-                                "You are using a non-primitive FiniteElement "
-                                "and try to constrain just some of its components!"));
-                      }
-
-                    // get indices, physical location and boundary values of
-                    // dofs on this face
-                    local_dofs.resize(fe.dofs_per_face);
-                    face->get_mg_dof_indices(level, local_dofs);
-                    if (fe_is_system)
-                      {
-                        for (unsigned int i = 0; i < local_dofs.size(); ++i)
-                          {
-                            unsigned int component =
-                              numbers::invalid_unsigned_int;
-                            if (fe.is_primitive())
-                              component =
-                                fe.face_system_to_component_index(i).first;
-                            else
-                              {
-                                // Just pick the first of the components
-                                // We already know that either all or none
-                                // of the components are selected
-                                const ComponentMask &nonzero_component_array =
-                                  cell->get_fe().get_nonzero_components(i);
-                                for (unsigned int c = 0; c < n_components; ++c)
-                                  if (nonzero_component_array[c] == true)
-                                    {
-                                      component = c;
-                                      break;
-                                    }
-                              }
-                            Assert(component != numbers::invalid_unsigned_int,
-                                   ExcInternalError());
-                            if (component_mask[component] == true)
-                              boundary_indices[level].add_index(local_dofs[i]);
-                          }
-                      }
-                    else
-                      boundary_indices[level].add_indices(local_dofs.begin(),
-                                                          local_dofs.end());
+                    // Just pick the first of the components
+                    // We already know that either all or none
+                    // of the components are selected
+                    const ComponentMask &nonzero_component_array =
+                      fe.get_nonzero_components(i);
+                    for (unsigned int c = 0; c < n_components; ++c)
+                      if (nonzero_component_array[c] == true)
+                        {
+                          component = c;
+                          break;
+                        }
                   }
+                Assert(component != numbers::invalid_unsigned_int,
+                       ExcInternalError());
+                if (component_mask[component] == true)
+                  boundary_dofs.push_back(local_dofs[i]);
               }
+          }
+      };
+
+    std::vector<std::vector<types::global_dof_index>> level_boundary_dofs =
+      internal::MGToolsImplementation::collect_on_level_cells<
+        types::global_dof_index>(dof, 0, collect_cell);
+
+    for (unsigned int level = 0; level < level_boundary_dofs.size(); ++level)
+      {
+        std::vector<types::global_dof_index> &boundary_dofs =
+          level_boundary_dofs[level];
+        std::sort(boundary_dofs.begin(), boundary_dofs.end());
+        boundary_indices[level].add_indices(
+          boundary_dofs.begin(),
+          std::unique(boundary_dofs.begin(), boundary_dofs.end()));
+        boundary_indices[level].compress();
       }
   }
 
@@ -1542,34 +1553,26 @@ namespace MGTools
              interface_dofs.size(),
              mg_dof_handler.get_triangulation().n_global_levels()));
 
-    std::vector<std::vector<types::global_dof_index>> tmp_interface_dofs(
-      interface_dofs.size());
-
     const FiniteElement<dim, spacedim> &fe = mg_dof_handler.get_fe();
 
     const unsigned int dofs_per_cell = fe.dofs_per_cell;
     const unsigned int dofs_per_face = fe.dofs_per_face;
 
-    std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
-
-    std::vector<bool> cell_dofs(dofs_per_cell, false);
-
-    typename DoFHandler<dim>::cell_iterator cell = mg_dof_handler.begin(),
-                                            endc = mg_dof_handler.end();
-
-    for (; cell != endc; ++cell)
-      {
+    // Cells only contribute to the interface dofs of their own level, so the
+    // cells of all levels can be worked on in parallel with separate output
+    // buffers that are merged once per level
+    const auto collect_cell =
+      [&](const typename DoFHandler<dim, spacedim>::level_cell_iterator &cell,
+          std::vector<types::global_dof_index> &level_interface_dofs) {
         // Do not look at artificial level cells (in a serial computation we
         // need to ignore the level_subdomain_id() because it is never set).
         if (mg_dof_handler.get_triangulation().locally_owned_subdomain() !=
               numbers::invalid_subdomain_id &&
             cell->level_subdomain_id() == numbers::artificial_subdomain_id)
-          continue;
-
-        bool has_coarser_neighbor = false;
-
-        std::fill(cell_dofs.begin(), cell_dofs.end(), false);
+          return;
 
+        // bit mask of the faces to a coarser neighbor
+        unsigned int coarser_faces = 0;
         for (unsigned int face_nr = 0;
              face_nr < GeometryInfo<dim>::faces_per_cell;
              ++face_nr)
@@ -1579,11 +1582,11 @@ namespace MGTools
             if (!face->at_boundary() || cell->has_periodic_neighbor(face_nr))
               {
                 // interior face
-                const typename DoFHandler<dim>::cell_iterator neighbor =
-                  cell->neighbor_or_periodic_neighbor(face_nr);
+                const typename DoFHandler<dim, spacedim>::cell_iterator
+                  neighbor = cell->neighbor_or_periodic_neighbor(face_nr);
 
-                // only process cell pairs if one or both of them are owned by
-                // me (ignore if running in serial)
+                // only process cell pairs if one or both of them are owned
+                // by me (ignore if running in serial)
                 if (mg_dof_handler.get_triangulation()
                         .locally_owned_subdomain() !=
                       numbers::invalid_subdomain_id &&
@@ -1593,33 +1596,37 @@ namespace MGTools
 
                 // Do refinement face from the coarse side
                 if (neighbor->level() < cell->level())
-                  {
-                    for (unsigned int j = 0; j < dofs_per_face; ++j)
-                      cell_dofs[fe.face_to_cell_index(j, face_nr)] = true;
-
-                    has_coarser_neighbor = true;
-                  }
+                  coarser_faces |= 1U << face_nr;
               }
           }
 
-        if (has_coarser_neighbor == false)
-          continue;
+        if (coarser_faces == 0)
+          return;
 
-        const unsigned int level = cell->level();
+        std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
         cell->get_mg_dof_indices(local_dof_indices);
 
-        for (unsigned int i = 0; i < dofs_per_cell; ++i)
-          {
-            if (cell_dofs[i])
-              tmp_interface_dofs[level].push_back(local_dof_indices[i]);
-          }
-      }
+        for (unsigned int face_nr = 0;
+             face_nr < GeometryInfo<dim>::faces_per_cell;
+             ++face_nr)
+          if (coarser_faces & (1U << face_nr))
+            for (unsigned int j = 0; j < dofs_per_face; ++j)
+              level_interface_dofs.push_back(
+                local_dof_indices[fe.face_to_cell_index(j, face_nr)]);
+      };
+
+    // the coarsest level cannot have a coarser neighbor
+    std::vector<std::vector<types::global_dof_index>> tmp_interface_dofs =
+      internal::MGToolsImplementation::collect_on_level_cells<
+        types::global_dof_index>(mg_dof_handler, 1, collect_cell);
 
     for (unsigned int l = 0;
          l < mg_dof_handler.get_triangulation().n_global_levels();
          ++l)
       {
         interface_dofs[l].clear();
+        if (l >= tmp_interface_dofs.size())
+          continue;
         std::sort(tmp_interface_dofs[l].begin(), tmp_interface_dofs[l].end());
         interface_dofs[l].add_indices(tmp_interface_dofs[l].begin(),
                                       std::unique(tmp_interface_dofs[l].begin(),
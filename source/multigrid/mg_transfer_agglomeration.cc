@@ -0,0 +1,515 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/memory_consumption.h>
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <deal.II/multigrid/mg_transfer_agglomeration.h>
+
+#include <set>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+MGLevelAgglomeration::MGLevelAgglomeration()
+  : original_communicator(MPI_COMM_SELF)
+{}
+
+
+
+MGLevelAgglomeration::~MGLevelAgglomeration()
+{
+  clear();
+}
+
+
+
+void
+MGLevelAgglomeration::clear()
+{
+#ifdef DEAL_II_WITH_MPI
+  for (auto &communicator : subcommunicators)
+    if (communicator.second != MPI_COMM_NULL)
+      {
+        const int ierr = MPI_Comm_free(&communicator.second);
+        AssertThrowMPI(ierr);
+      }
+#endif
+  subcommunicators.clear();
+  level_data.resize(0, 0);
+  original_communicator = MPI_COMM_SELF;
+}
+
+
+
+template <int dim, int spacedim>
+void
+MGLevelAgglomeration::initialize(
+  const DoFHandler<dim, spacedim> &dof_handler,
+  const MGLevelObject<std::shared_ptr<const Utilities::MPI::Partitioner>>
+    &                   level_partitioners,
+  const AdditionalData &additional_data)
+{
+  clear();
+
+  const unsigned int min_level = level_partitioners.min_level();
+  const unsigned int max_level = level_partitioners.max_level();
+  AssertThrow(additional_data.reduction_factor > 1,
+              ExcMessage("The reduction factor must be at least two."));
+
+  original_communicator =
+    level_partitioners[max_level]->get_mpi_communicator();
+  const unsigned int n_procs =
+    Utilities::MPI::n_mpi_processes(original_communicator);
+  const unsigned int my_rank =
+    Utilities::MPI::this_mpi_process(original_communicator);
+  level_data.resize(min_level, max_level);
+
+  // choose the stride between the active processes, going from the finest
+  // to the coarsest level
+  const Triangulation<dim, spacedim> &tria = dof_handler.get_triangulation();
+  unsigned int                        stride = 1;
+  for (int level = max_level; level >= static_cast<int>(min_level); --level)
+    {
+      unsigned int n_owned_cells = 0;
+      if (static_cast<unsigned int>(level) < tria.n_levels())
+        for (auto cell = tria.begin(level); cell != tria.end(level); ++cell)
+          if (cell->is_locally_owned_on_level())
+            ++n_owned_cells;
+      const types::global_dof_index n_cells =
+        Utilities::MPI::sum<types::global_dof_index>(n_owned_cells,
+                                                     original_communicator);
+
+      unsigned int n_active = (n_procs + stride - 1) / stride;
+      while (n_active > 1 &&
+             n_cells < static_cast<types::global_dof_index>(
+                         additional_data.min_cells_per_process) *
+                         n_active)
+        {
+          stride   = std::min(stride * additional_data.reduction_factor,
+                            n_procs);
+          n_active = (n_procs + stride - 1) / stride;
+        }
+      level_data[level].stride = stride;
+    }
+
+  // create one subcommunicator per stride, in the same order on all
+  // processes
+  std::set<unsigned int> strides;
+  for (unsigned int level = min_level; level <= max_level; ++level)
+    if (level_data[level].stride > 1)
+      strides.insert(level_data[level].stride);
+  for (const unsigned int s : strides)
+    {
+#ifdef DEAL_II_WITH_MPI
+      MPI_Comm   communicator;
+      const int  color = (my_rank % s == 0) ? 0 : MPI_UNDEFINED;
+      const int  ierr  = MPI_Comm_split(original_communicator,
+                                      color,
+                                      my_rank,
+                                      &communicator);
+      AssertThrowMPI(ierr);
+      subcommunicators[s] = communicator;
+#else
+      (void)s;
+      Assert(false, ExcInternalError());
+#endif
+    }
+
+  for (unsigned int level = min_level; level <= max_level; ++level)
+    {
+      LevelData &data           = level_data[level];
+      data.original_partitioner = level_partitioners[level];
+      const Utilities::MPI::Partitioner &original = *data.original_partitioner;
+      AssertThrow(original.get_mpi_communicator() == original_communicator,
+                  ExcMessage("The level partitioners must all be based on "
+                             "the same communicator."));
+
+      // collect the ranges of the original distribution, which must be
+      // ordered by the rank of the processes
+      data.original_range_starts.resize(n_procs + 1);
+      data.original_range_starts[0] = 0;
+#ifdef DEAL_II_WITH_MPI
+      const types::global_dof_index local_size = original.local_size();
+      const int ierr = MPI_Allgather(&local_size,
+                                     1,
+                                     DEAL_II_DOF_INDEX_MPI_TYPE,
+                                     &data.original_range_starts[1],
+                                     1,
+                                     DEAL_II_DOF_INDEX_MPI_TYPE,
+                                     original_communicator);
+      AssertThrowMPI(ierr);
+#else
+      data.original_range_starts[1] = original.local_size();
+#endif
+      for (unsigned int p = 0; p < n_procs; ++p)
+        data.original_range_starts[p + 1] += data.original_range_starts[p];
+      AssertDimension(data.original_range_starts.back(), original.size());
+      Assert(original.local_size() == 0 ||
+               original.local_range().first ==
+                 data.original_range_starts[my_rank],
+             ExcMessage("The level degrees of freedom must be numbered "
+                        "contiguously in the order of the MPI ranks."));
+
+      if (data.stride == 1)
+        {
+          data.communicator = original_communicator;
+          data.partitioner  = data.original_partitioner;
+          continue;
+        }
+
+      const bool active = my_rank % data.stride == 0;
+      IndexSet   owned_indices(original.size());
+      if (active)
+        owned_indices.add_range(
+          data.original_range_starts[my_rank],
+          data.original_range_starts[std::min(my_rank + data.stride,
+                                              n_procs)]);
+      data.communicator =
+        active ? subcommunicators[data.stride] : MPI_COMM_SELF;
+      data.partitioner =
+        std::make_shared<Utilities::MPI::Partitioner>(owned_indices,
+                                                      data.communicator);
+      data.transfer_partitioner =
+        std::make_shared<Utilities::MPI::Partitioner>(
+          owned_indices,
+          original.locally_owned_range(),
+          original_communicator);
+    }
+}
+
+
+
+std::size_t
+MGLevelAgglomeration::memory_consumption() const
+{
+  std::size_t memory = sizeof(*this);
+  for (unsigned int level = level_data.min_level();
+       level <= level_data.max_level();
+       ++level)
+    {
+      const LevelData &data = level_data[level];
+      memory +=
+        MemoryConsumption::memory_consumption(data.original_range_starts);
+      if (data.stride > 1)
+        memory += data.partitioner->memory_consumption() +
+                  data.transfer_partitioner->memory_consumption();
+    }
+  return memory;
+}
+
+
+
+template <typename Number>
+void
+MGAgglomeratedLevelMatrix<Number>::build_rows(
+  const std::vector<
+    std::pair<std::pair<types::global_dof_index, types::global_dof_index>,
+              Number>> &                                  entries,
+  const std::shared_ptr<const Utilities::MPI::Partitioner> &owned_partitioner,
+  const MPI_Comm &                                          communicator)
+{
+  const IndexSet &owned_indices = owned_partitioner->locally_owned_range();
+  const std::pair<types::global_dof_index, types::global_dof_index> range =
+    owned_partitioner->local_range();
+
+  IndexSet ghost_indices(owned_indices.size());
+  {
+    std::vector<types::global_dof_index> ghosts;
+    for (const auto &entry : entries)
+      if (!owned_indices.is_element(entry.first.second))
+        ghosts.push_back(entry.first.second);
+    std::sort(ghosts.begin(), ghosts.end());
+    ghost_indices.add_indices(ghosts.begin(),
+                              std::unique(ghosts.begin(), ghosts.end()));
+  }
+  partitioner = std::make_shared<Utilities::MPI::Partitioner>(owned_indices,
+                                                              ghost_indices,
+                                                              communicator);
+  ghosted_vector.reinit(partitioner);
+
+  row_starts.clear();
+  row_starts.resize(owned_partitioner->local_size() + 1, 0);
+  column_indices.resize(entries.size());
+  values.resize(entries.size());
+  for (unsigned int i = 0; i < entries.size(); ++i)
+    {
+      Assert(entries[i].first.first >= range.first &&
+               entries[i].first.first < range.second,
+             ExcInternalError());
+      ++row_starts[entries[i].first.first - range.first + 1];
+      column_indices[i] = partitioner->global_to_local(entries[i].first.second);
+      values[i]         = entries[i].second;
+    }
+  for (unsigned int row = 0; row < owned_partitioner->local_size(); ++row)
+    row_starts[row + 1] += row_starts[row];
+  (void)range;
+}
+
+
+
+template <typename Number>
+void
+MGAgglomeratedLevelMatrix<Number>::clear()
+{
+  partitioner.reset();
+  row_starts.clear();
+  column_indices.clear();
+  values.clear();
+  ghosted_vector.reinit(0);
+}
+
+
+
+template <typename Number>
+types::global_dof_index
+MGAgglomeratedLevelMatrix<Number>::m() const
+{
+  Assert(partitioner.get() != nullptr, ExcNotInitialized());
+  return partitioner->size();
+}
+
+
+
+template <typename Number>
+types::global_dof_index
+MGAgglomeratedLevelMatrix<Number>::n() const
+{
+  return m();
+}
+
+
+
+template <typename Number>
+void
+MGAgglomeratedLevelMatrix<Number>::initialize_dof_vector(VectorType &vec) const
+{
+  Assert(partitioner.get() != nullptr, ExcNotInitialized());
+  vec.reinit(partitioner);
+}
+
+
+
+template <typename Number>
+void
+MGAgglomeratedLevelMatrix<Number>::vmult(VectorType &      dst,
+                                         const VectorType &src) const
+{
+  AssertDimension(src.local_size(), row_starts.size() - 1);
+  AssertDimension(dst.local_size(), row_starts.size() - 1);
+
+  ghosted_vector.copy_locally_owned_data_from(src);
+  ghosted_vector.update_ghost_values();
+  for (unsigned int row = 0; row < row_starts.size() - 1; ++row)
+    {
+      Number sum = 0;
+      for (unsigned int i = row_starts[row]; i < row_starts[row + 1]; ++i)
+        sum += values[i] * ghosted_vector.local_element(column_indices[i]);
+      dst.local_element(row) = sum;
+    }
+  ghosted_vector.zero_out_ghosts();
+}
+
+
+
+template <typename Number>
+void
+MGAgglomeratedLevelMatrix<Number>::Tvmult(VectorType &      dst,
+                                          const VectorType &src) const
+{
+  AssertDimension(src.local_size(), row_starts.size() - 1);
+  AssertDimension(dst.local_size(), row_starts.size() - 1);
+
+  ghosted_vector = Number();
+  for (unsigned int row = 0; row < row_starts.size() - 1; ++row)
+    {
+      const Number src_value = src.local_element(row);
+      for (unsigned int i = row_starts[row]; i < row_starts[row + 1]; ++i)
+        ghosted_vector.local_element(column_indices[i]) +=
+          values[i] * src_value;
+    }
+  ghosted_vector.compress(VectorOperation::add);
+  dst.copy_locally_owned_data_from(ghosted_vector);
+}
+
+
+
+template <typename Number>
+void
+MGAgglomeratedLevelMatrix<Number>::compute_diagonal(VectorType &diagonal) const
+{
+  initialize_dof_vector(diagonal);
+  for (unsigned int row = 0; row < row_starts.size() - 1; ++row)
+    for (unsigned int i = row_starts[row]; i < row_starts[row + 1]; ++i)
+      if (column_indices[i] == row)
+        diagonal.local_element(row) = values[i];
+}
+
+
+
+template <typename Number>
+const std::shared_ptr<const Utilities::MPI::Partitioner> &
+MGAgglomeratedLevelMatrix<Number>::get_partitioner() const
+{
+  return partitioner;
+}
+
+
+
+template <typename Number>
+const std::vector<unsigned int> &
+MGAgglomeratedLevelMatrix<Number>::get_row_starts() const
+{
+  return row_starts;
+}
+
+
+
+template <typename Number>
+const std::vector<unsigned int> &
+MGAgglomeratedLevelMatrix<Number>::get_column_indices() const
+{
+  return column_indices;
+}
+
+
+
+template <typename Number>
+const std::vector<Number> &
+MGAgglomeratedLevelMatrix<Number>::get_values() const
+{
+  return values;
+}
+
+
+
+template <typename Number>
+std::size_t
+MGAgglomeratedLevelMatrix<Number>::memory_consumption() const
+{
+  return MemoryConsumption::memory_consumption(row_starts) +
+         MemoryConsumption::memory_consumption(column_indices) +
+         MemoryConsumption::memory_consumption(values) +
+         ghosted_vector.memory_consumption() +
+         (partitioner.get() != nullptr ? partitioner->memory_consumption() :
+                                         0);
+}
+
+
+
+template <int dim, typename Number>
+MGTransferAgglomeration<dim, Number>::MGTransferAgglomeration(
+  const MGTransferMatrixFree<dim, Number> &transfer,
+  const MGLevelAgglomeration &             agglomeration)
+  : transfer(&transfer)
+  , agglomeration(&agglomeration)
+{
+  original_vectors.resize(agglomeration.min_level(),
+                          agglomeration.max_level());
+  for (unsigned int level = agglomeration.min_level();
+       level <= agglomeration.max_level();
+       ++level)
+    original_vectors[level].reinit(
+      agglomeration.get_original_partitioner(level));
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTransferAgglomeration<dim, Number>::prolongate(
+  const unsigned int                                to_level,
+  LinearAlgebra::distributed::Vector<Number> &      dst,
+  const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  const LinearAlgebra::distributed::Vector<Number> *src_original = &src;
+  if (agglomeration->is_agglomerated(to_level - 1))
+    {
+      agglomeration->scatter(to_level - 1, original_vectors[to_level - 1], src);
+      src_original = &original_vectors[to_level - 1];
+    }
+
+  if (agglomeration->is_agglomerated(to_level))
+    {
+      transfer->prolongate(to_level, original_vectors[to_level], *src_original);
+      agglomeration->gather(to_level, dst, original_vectors[to_level]);
+    }
+  else
+    transfer->prolongate(to_level, dst, *src_original);
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTransferAgglomeration<dim, Number>::restrict_and_add(
+  const unsigned int                                from_level,
+  LinearAlgebra::distributed::Vector<Number> &      dst,
+  const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  const LinearAlgebra::distributed::Vector<Number> *src_original = &src;
+  if (agglomeration->is_agglomerated(from_level))
+    {
+      agglomeration->scatter(from_level, original_vectors[from_level], src);
+      src_original = &original_vectors[from_level];
+    }
+
+  if (agglomeration->is_agglomerated(from_level - 1))
+    {
+      original_vectors[from_level - 1] = Number();
+      transfer->restrict_and_add(from_level,
+                                 original_vectors[from_level - 1],
+                                 *src_original);
+      agglomeration->gather(from_level - 1,
+                            dst,
+                            original_vectors[from_level - 1],
+                            VectorOperation::add);
+    }
+  else
+    transfer->restrict_and_add(from_level, dst, *src_original);
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTransferAgglomeration<dim, Number>::scatter_level_vectors(
+  const MGLevelObject<LinearAlgebra::distributed::Vector<Number>> &src) const
+{
+  for (unsigned int level = agglomeration->min_level();
+       level <= agglomeration->max_level();
+       ++level)
+    agglomeration->scatter(level, original_vectors[level], src[level]);
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+MGTransferAgglomeration<dim, Number>::memory_consumption() const
+{
+  return original_vectors.memory_consumption();
+}
+
+
+// explicit instantiations
+#include "mg_transfer_agglomeration.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
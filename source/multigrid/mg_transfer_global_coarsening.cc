@@ -0,0 +1,529 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/quadrature.h>
+
+#include <deal.II/distributed/tria_base.h>
+
+#include <deal.II/dofs/dof_accessor.h>
+
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_tools.h>
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <deal.II/matrix_free/evaluation_kernels.h>
+#include <deal.II/matrix_free/shape_info.h>
+
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, typename Number>
+template <typename Number2>
+void
+MGTwoLevelTransfer<dim, Number>::reinit_polynomial_transfer(
+  const DoFHandler<dim> &           dof_handler_fine,
+  const DoFHandler<dim> &           dof_handler_coarse,
+  const AffineConstraints<Number2> &constraint_fine,
+  const AffineConstraints<Number2> &constraint_coarse)
+{
+  const Triangulation<dim> &tria = dof_handler_fine.get_triangulation();
+  Assert(&tria == &dof_handler_coarse.get_triangulation(),
+         ExcMessage("The polynomial transfer requires both DoFHandler objects "
+                    "to be defined on the same triangulation."));
+
+  const FiniteElement<dim> &fe_fine   = dof_handler_fine.get_fe();
+  const FiniteElement<dim> &fe_coarse = dof_handler_coarse.get_fe();
+  AssertDimension(fe_fine.n_base_elements(), 1);
+  AssertDimension(fe_coarse.n_base_elements(), 1);
+  AssertDimension(fe_fine.n_components(), fe_coarse.n_components());
+  AssertThrow(fe_fine.degree >= fe_coarse.degree,
+              ExcMessage("The fine element must not have a lower polynomial "
+                         "degree than the coarse element."));
+
+  degree_fine   = fe_fine.degree;
+  degree_coarse = fe_coarse.degree;
+  n_components  = fe_fine.element_multiplicity(0);
+
+  // ---------------------------- 1. Extract the 1D interpolation matrix
+  // step 1.1: create a 1D copy of the fine element from FETools where we
+  // substitute the template argument and collect its support points in
+  // lexicographic ordering
+  std::string fe_name = fe_fine.base_element(0).get_name();
+  {
+    const std::size_t template_starts = fe_name.find_first_of('<');
+    Assert(fe_name[template_starts + 1] ==
+             (dim == 1 ? '1' : (dim == 2 ? '2' : '3')),
+           ExcInternalError());
+    fe_name[template_starts + 1] = '1';
+  }
+  const std::unique_ptr<FiniteElement<1>> fe_1d(
+    FETools::get_fe_by_name<1, 1>(fe_name));
+  AssertThrow(fe_1d->has_support_points(),
+              ExcMessage("The polynomial transfer is only implemented for "
+                         "nodal elements."));
+  AssertIndexRange(fe_1d->dofs_per_vertex, 2);
+
+  const std::vector<Point<1>> &support_points =
+    fe_1d->get_unit_support_points();
+  std::vector<Point<1>> support_points_lex(fe_1d->dofs_per_cell);
+  if (fe_1d->dofs_per_vertex > 0)
+    {
+      support_points_lex.front() = support_points[0];
+      for (unsigned int i = 0; i < fe_1d->dofs_per_line; ++i)
+        support_points_lex[i + 1] = support_points[i + 2];
+      support_points_lex.back() = support_points[1];
+    }
+  else
+    support_points_lex = support_points;
+
+  // step 1.2: evaluate the coarse basis functions in the support points of
+  // the fine element, which gives the interpolation matrix in the layout
+  // needed by the sum factorization kernels
+  internal::MatrixFreeFunctions::ShapeInfo<Number> shape_info_coarse;
+  shape_info_coarse.reinit(Quadrature<1>(support_points_lex), fe_coarse, 0);
+  AssertDimension(shape_info_coarse.shape_values.size(),
+                  (degree_coarse + 1) * (degree_fine + 1));
+  prolongation_matrix_1d.resize(shape_info_coarse.shape_values.size());
+  for (unsigned int i = 0; i < shape_info_coarse.shape_values.size(); ++i)
+    prolongation_matrix_1d[i] = shape_info_coarse.shape_values[i];
+
+  internal::MatrixFreeFunctions::ShapeInfo<Number> shape_info_fine;
+  shape_info_fine.reinit(Quadrature<1>(std::vector<Point<1>>(1, Point<1>())),
+                         fe_fine,
+                         0);
+  const std::vector<unsigned int> &lexicographic_fine =
+    shape_info_fine.lexicographic_numbering;
+  const std::vector<unsigned int> &lexicographic_coarse =
+    shape_info_coarse.lexicographic_numbering;
+  AssertDimension(lexicographic_fine.size(), fe_fine.dofs_per_cell);
+  AssertDimension(lexicographic_coarse.size(), fe_coarse.dofs_per_cell);
+
+  // ---------------------------- 2. Collect the indices on the cells
+  const parallel::Triangulation<dim, dim> *ptria =
+    dynamic_cast<const parallel::Triangulation<dim, dim> *>(&tria);
+  const MPI_Comm communicator =
+    ptria != nullptr ? ptria->get_communicator() : MPI_COMM_SELF;
+
+  std::vector<types::global_dof_index> global_indices_fine;
+  std::vector<std::pair<types::global_dof_index, Number>> global_entries;
+  std::vector<types::global_dof_index> local_dof_indices_fine(
+    fe_fine.dofs_per_cell);
+  std::vector<types::global_dof_index> local_dof_indices_coarse(
+    fe_coarse.dofs_per_cell);
+
+  IndexSet ghosts_fine(dof_handler_fine.n_dofs());
+  IndexSet ghosts_coarse(dof_handler_coarse.n_dofs());
+  const IndexSet &owned_fine   = dof_handler_fine.locally_owned_dofs();
+  const IndexSet &owned_coarse = dof_handler_coarse.locally_owned_dofs();
+
+  coarse_row_starts.clear();
+  coarse_row_starts.push_back(0);
+  n_cells = 0;
+  for (const auto &cell : dof_handler_fine.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        const typename DoFHandler<dim>::active_cell_iterator cell_coarse(
+          &tria, cell->level(), cell->index(), &dof_handler_coarse);
+
+        cell->get_dof_indices(local_dof_indices_fine);
+        for (unsigned int i = 0; i < fe_fine.dofs_per_cell; ++i)
+          {
+            const types::global_dof_index index =
+              local_dof_indices_fine[lexicographic_fine[i]];
+            global_indices_fine.push_back(index);
+            if (!owned_fine.is_element(index))
+              ghosts_fine.add_index(index);
+          }
+
+        cell_coarse->get_dof_indices(local_dof_indices_coarse);
+        for (unsigned int i = 0; i < fe_coarse.dofs_per_cell; ++i)
+          {
+            const types::global_dof_index index =
+              local_dof_indices_coarse[lexicographic_coarse[i]];
+            if (constraint_coarse.is_constrained(index))
+              {
+                for (const auto &entry :
+                     *constraint_coarse.get_constraint_entries(index))
+                  global_entries.emplace_back(entry.first,
+                                              Number(entry.second));
+              }
+            else
+              global_entries.emplace_back(index, Number(1.));
+            coarse_row_starts.push_back(global_entries.size());
+          }
+        ++n_cells;
+      }
+
+  for (const auto &entry : global_entries)
+    if (!owned_coarse.is_element(entry.first))
+      ghosts_coarse.add_index(entry.first);
+
+  partitioner_fine = std::make_shared<const Utilities::MPI::Partitioner>(
+    owned_fine, ghosts_fine, communicator);
+  partitioner_coarse = std::make_shared<const Utilities::MPI::Partitioner>(
+    owned_coarse, ghosts_coarse, communicator);
+  vec_fine.reinit(partitioner_fine);
+  vec_coarse.reinit(partitioner_coarse);
+
+  dof_indices_fine.resize(global_indices_fine.size());
+  for (unsigned int i = 0; i < global_indices_fine.size(); ++i)
+    dof_indices_fine[i] =
+      partitioner_fine->global_to_local(global_indices_fine[i]);
+
+  coarse_entries.resize(global_entries.size());
+  for (unsigned int i = 0; i < global_entries.size(); ++i)
+    coarse_entries[i] =
+      std::make_pair(partitioner_coarse->global_to_local(
+                       global_entries[i].first),
+                     global_entries[i].second);
+
+  // ---------------------------- 3. Compute the weights of the fine dofs as
+  // the inverse of their valence, zeroing out the constrained ones
+  for (const unsigned int index : dof_indices_fine)
+    vec_fine.local_element(index) += Number(1.);
+  vec_fine.compress(VectorOperation::add);
+  vec_fine.update_ghost_values();
+
+  const unsigned int vec_size = VectorizedArray<Number>::n_array_elements;
+  weights_fine.resize(((n_cells + vec_size - 1) / vec_size) *
+                      fe_fine.dofs_per_cell);
+  for (unsigned int c = 0; c < n_cells; ++c)
+    for (unsigned int i = 0; i < fe_fine.dofs_per_cell; ++i)
+      {
+        const unsigned int index =
+          dof_indices_fine[c * fe_fine.dofs_per_cell + i];
+        weights_fine[(c / vec_size) * fe_fine.dofs_per_cell + i][c % vec_size] =
+          constraint_fine.is_constrained(
+            partitioner_fine->local_to_global(index)) ?
+            Number(0.) :
+            Number(1.) / vec_fine.local_element(index);
+      }
+  vec_fine.zero_out_ghosts();
+  vec_fine = 0;
+
+  evaluation_data.resize(std::max(fe_fine.dofs_per_cell,
+                                  fe_coarse.dofs_per_cell));
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransfer<dim, Number>::prolongate(
+  LinearAlgebra::distributed::Vector<Number> &      dst,
+  const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  AssertDimension(vec_fine.local_size(), dst.local_size());
+  AssertDimension(vec_coarse.local_size(), src.local_size());
+
+  vec_coarse.copy_locally_owned_data_from(src);
+  vec_coarse.update_ghost_values();
+  vec_fine = 0.;
+
+  // select a kernel templated on the degrees for the most common pairs of
+  // p-multigrid and the run time version otherwise
+  if (degree_fine == 2 && degree_coarse == 1)
+    do_prolongate_add<2, 1>(vec_fine, vec_coarse);
+  else if (degree_fine == 3 && degree_coarse == 1)
+    do_prolongate_add<3, 1>(vec_fine, vec_coarse);
+  else if (degree_fine == 3 && degree_coarse == 2)
+    do_prolongate_add<3, 2>(vec_fine, vec_coarse);
+  else if (degree_fine == 4 && degree_coarse == 2)
+    do_prolongate_add<4, 2>(vec_fine, vec_coarse);
+  else if (degree_fine == 4 && degree_coarse == 3)
+    do_prolongate_add<4, 3>(vec_fine, vec_coarse);
+  else if (degree_fine == 5 && degree_coarse == 2)
+    do_prolongate_add<5, 2>(vec_fine, vec_coarse);
+  else if (degree_fine == 6 && degree_coarse == 3)
+    do_prolongate_add<6, 3>(vec_fine, vec_coarse);
+  else if (degree_fine == 7 && degree_coarse == 3)
+    do_prolongate_add<7, 3>(vec_fine, vec_coarse);
+  else if (degree_fine == 8 && degree_coarse == 4)
+    do_prolongate_add<8, 4>(vec_fine, vec_coarse);
+  else
+    do_prolongate_add<-1, -1>(vec_fine, vec_coarse);
+
+  vec_fine.compress(VectorOperation::add);
+  vec_coarse.zero_out_ghosts();
+  dst.copy_locally_owned_data_from(vec_fine);
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTwoLevelTransfer<dim, Number>::restrict_and_add(
+  LinearAlgebra::distributed::Vector<Number> &      dst,
+  const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  AssertDimension(vec_fine.local_size(), src.local_size());
+  AssertDimension(vec_coarse.local_size(), dst.local_size());
+
+  vec_fine.copy_locally_owned_data_from(src);
+  vec_fine.update_ghost_values();
+  vec_coarse = 0.;
+
+  if (degree_fine == 2 && degree_coarse == 1)
+    do_restrict_add<2, 1>(vec_coarse, vec_fine);
+  else if (degree_fine == 3 && degree_coarse == 1)
+    do_restrict_add<3, 1>(vec_coarse, vec_fine);
+  else if (degree_fine == 3 && degree_coarse == 2)
+    do_restrict_add<3, 2>(vec_coarse, vec_fine);
+  else if (degree_fine == 4 && degree_coarse == 2)
+    do_restrict_add<4, 2>(vec_coarse, vec_fine);
+  else if (degree_fine == 4 && degree_coarse == 3)
+    do_restrict_add<4, 3>(vec_coarse, vec_fine);
+  else if (degree_fine == 5 && degree_coarse == 2)
+    do_restrict_add<5, 2>(vec_coarse, vec_fine);
+  else if (degree_fine == 6 && degree_coarse == 3)
+    do_restrict_add<6, 3>(vec_coarse, vec_fine);
+  else if (degree_fine == 7 && degree_coarse == 3)
+    do_restrict_add<7, 3>(vec_coarse, vec_fine);
+  else if (degree_fine == 8 && degree_coarse == 4)
+    do_restrict_add<8, 4>(vec_coarse, vec_fine);
+  else
+    do_restrict_add<-1, -1>(vec_coarse, vec_fine);
+
+  vec_coarse.compress(VectorOperation::add);
+  vec_fine.zero_out_ghosts();
+  dst += vec_coarse;
+}
+
+
+
+template <int dim, typename Number>
+template <int degree_fine_, int degree_coarse_>
+void
+MGTwoLevelTransfer<dim, Number>::do_prolongate_add(
+  LinearAlgebra::distributed::Vector<Number> &      dst,
+  const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  const unsigned int vec_size = VectorizedArray<Number>::n_array_elements;
+  const unsigned int n_dofs_coarse =
+    Utilities::fixed_power<dim>(degree_coarse + 1);
+  const unsigned int n_dofs_fine = Utilities::fixed_power<dim>(degree_fine + 1);
+  const unsigned int n_cell_dofs_coarse = n_components * n_dofs_coarse;
+  const unsigned int n_cell_dofs_fine   = n_components * n_dofs_fine;
+
+  for (unsigned int cell = 0; cell < n_cells; cell += vec_size)
+    {
+      const unsigned int n_lanes =
+        cell + vec_size > n_cells ? n_cells - cell : vec_size;
+
+      // read from source vector, resolving the constraints
+      for (unsigned int v = 0; v < n_lanes; ++v)
+        {
+          const unsigned int *row_starts =
+            &coarse_row_starts[(cell + v) * n_cell_dofs_coarse];
+          for (unsigned int i = 0; i < n_cell_dofs_coarse; ++i)
+            {
+              Number value = 0;
+              for (unsigned int j = row_starts[i]; j < row_starts[i + 1]; ++j)
+                value += coarse_entries[j].second *
+                         src.local_element(coarse_entries[j].first);
+              evaluation_data[i][v] = value;
+            }
+        }
+
+      // perform tensorized operation, going through the components backwards
+      // because the output is written into the same array as the input
+      for (int c = n_components - 1; c >= 0; --c)
+        internal::FEEvaluationImplBasisChange<internal::evaluate_general,
+                                              dim,
+                                              degree_coarse_ + 1,
+                                              degree_fine_ + 1,
+                                              1,
+                                              VectorizedArray<Number>,
+                                              VectorizedArray<Number>>::
+          do_forward(prolongation_matrix_1d,
+                     evaluation_data.begin() + c * n_dofs_coarse,
+                     evaluation_data.begin() + c * n_dofs_fine,
+                     degree_coarse + 1,
+                     degree_fine + 1);
+
+      const VectorizedArray<Number> *weights =
+        &weights_fine[(cell / vec_size) * n_cell_dofs_fine];
+      for (unsigned int i = 0; i < n_cell_dofs_fine; ++i)
+        evaluation_data[i] *= weights[i];
+
+      // write into dst vector
+      const unsigned int *indices = &dof_indices_fine[cell * n_cell_dofs_fine];
+      for (unsigned int v = 0; v < n_lanes; ++v)
+        {
+          for (unsigned int i = 0; i < n_cell_dofs_fine; ++i)
+            dst.local_element(indices[i]) += evaluation_data[i][v];
+          indices += n_cell_dofs_fine;
+        }
+    }
+}
+
+
+
+template <int dim, typename Number>
+template <int degree_fine_, int degree_coarse_>
+void
+MGTwoLevelTransfer<dim, Number>::do_restrict_add(
+  LinearAlgebra::distributed::Vector<Number> &      dst,
+  const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  const unsigned int vec_size = VectorizedArray<Number>::n_array_elements;
+  const unsigned int n_dofs_coarse =
+    Utilities::fixed_power<dim>(degree_coarse + 1);
+  const unsigned int n_dofs_fine = Utilities::fixed_power<dim>(degree_fine + 1);
+  const unsigned int n_cell_dofs_coarse = n_components * n_dofs_coarse;
+  const unsigned int n_cell_dofs_fine   = n_components * n_dofs_fine;
+
+  for (unsigned int cell = 0; cell < n_cells; cell += vec_size)
+    {
+      const unsigned int n_lanes =
+        cell + vec_size > n_cells ? n_cells - cell : vec_size;
+
+      // read from source vector
+      {
+        const unsigned int *indices =
+          &dof_indices_fine[cell * n_cell_dofs_fine];
+        for (unsigned int v = 0; v < n_lanes; ++v)
+          {
+            for (unsigned int i = 0; i < n_cell_dofs_fine; ++i)
+              evaluation_data[i][v] = src.local_element(indices[i]);
+            indices += n_cell_dofs_fine;
+          }
+      }
+
+      const VectorizedArray<Number> *weights =
+        &weights_fine[(cell / vec_size) * n_cell_dofs_fine];
+      for (unsigned int i = 0; i < n_cell_dofs_fine; ++i)
+        evaluation_data[i] *= weights[i];
+
+      // perform tensorized operation
+      for (unsigned int c = 0; c < n_components; ++c)
+        internal::FEEvaluationImplBasisChange<internal::evaluate_general,
+                                              dim,
+                                              degree_coarse_ + 1,
+                                              degree_fine_ + 1,
+                                              1,
+                                              VectorizedArray<Number>,
+                                              VectorizedArray<Number>>::
+          do_backward(prolongation_matrix_1d,
+                      false,
+                      evaluation_data.begin() + c * n_dofs_fine,
+                      evaluation_data.begin() + c * n_dofs_coarse,
+                      degree_coarse + 1,
+                      degree_fine + 1);
+
+      // write into dst vector, applying the transpose of the constraints
+      for (unsigned int v = 0; v < n_lanes; ++v)
+        {
+          const unsigned int *row_starts =
+            &coarse_row_starts[(cell + v) * n_cell_dofs_coarse];
+          for (unsigned int i = 0; i < n_cell_dofs_coarse; ++i)
+            for (unsigned int j = row_starts[i]; j < row_starts[i + 1]; ++j)
+              dst.local_element(coarse_entries[j].first) +=
+                coarse_entries[j].second * evaluation_data[i][v];
+        }
+    }
+}
+
+
+
+template <int dim, typename Number>
+const std::shared_ptr<const Utilities::MPI::Partitioner> &
+MGTwoLevelTransfer<dim, Number>::get_partitioner_fine() const
+{
+  return partitioner_fine;
+}
+
+
+
+template <int dim, typename Number>
+const std::shared_ptr<const Utilities::MPI::Partitioner> &
+MGTwoLevelTransfer<dim, Number>::get_partitioner_coarse() const
+{
+  return partitioner_coarse;
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+MGTwoLevelTransfer<dim, Number>::memory_consumption() const
+{
+  std::size_t memory = MemoryConsumption::memory_consumption(dof_indices_fine);
+  memory += MemoryConsumption::memory_consumption(prolongation_matrix_1d);
+  memory += MemoryConsumption::memory_consumption(weights_fine);
+  memory += MemoryConsumption::memory_consumption(coarse_row_starts);
+  memory += MemoryConsumption::memory_consumption(coarse_entries);
+  memory += MemoryConsumption::memory_consumption(evaluation_data);
+  memory += vec_fine.memory_consumption();
+  memory += vec_coarse.memory_consumption();
+  return memory;
+}
+
+
+
+template <int dim, typename Number>
+MGTransferGlobalCoarsening<dim, Number>::MGTransferGlobalCoarsening(
+  const MGLevelObject<MGTwoLevelTransfer<dim, Number>> &transfer)
+  : transfer(&transfer, typeid(*this).name())
+{}
+
+
+
+template <int dim, typename Number>
+void
+MGTransferGlobalCoarsening<dim, Number>::prolongate(
+  const unsigned int                                to_level,
+  LinearAlgebra::distributed::Vector<Number> &      dst,
+  const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  Assert(to_level > transfer->min_level() && to_level <= transfer->max_level(),
+         ExcIndexRange(to_level,
+                       transfer->min_level() + 1,
+                       transfer->max_level() + 1));
+  (*transfer)[to_level].prolongate(dst, src);
+}
+
+
+
+template <int dim, typename Number>
+void
+MGTransferGlobalCoarsening<dim, Number>::restrict_and_add(
+  const unsigned int                                from_level,
+  LinearAlgebra::distributed::Vector<Number> &      dst,
+  const LinearAlgebra::distributed::Vector<Number> &src) const
+{
+  Assert(from_level > transfer->min_level() &&
+           from_level <= transfer->max_level(),
+         ExcIndexRange(from_level,
+                       transfer->min_level() + 1,
+                       transfer->max_level() + 1));
+  (*transfer)[from_level].restrict_and_add(dst, src);
+}
+
+
+
+// explicit instantiation
+#include "mg_transfer_global_coarsening.inst"
+
+
+DEAL_II_NAMESPACE_CLOSE
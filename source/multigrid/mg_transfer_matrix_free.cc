@@ -89,6 +89,7 @@ MGTransferMatrixFree<dim, Number>::clear()
   prolongation_matrix_1d.clear();
   evaluation_data.clear();
   weights_on_refined.clear();
+  cell_batch_groups.clear();
 }
 
 
@@ -148,6 +149,48 @@ MGTransferMatrixFree<dim, Number>::build(const DoFHandler<dim, dim> &mg_dof)
         }
     }
 
+  // sort the cell batches according to the ghost entries they access on the
+  // fine and on the coarse level, see the description of cell_batch_groups
+  cell_batch_groups.clear();
+  cell_batch_groups.resize(n_levels - 1);
+  for (unsigned int level = 1; level < n_levels; ++level)
+    {
+      const unsigned int n_fine_owned =
+        this->ghosted_level_vector[level].local_size();
+      const unsigned int n_coarse_owned =
+        this->ghosted_level_vector[level - 1].local_size();
+      for (unsigned int cell = 0; cell < n_owned_level_cells[level - 1];
+           cell += vec_size)
+        {
+          const unsigned int n_lanes =
+            std::min(vec_size, n_owned_level_cells[level - 1] - cell);
+          bool touches_fine_ghosts = false, touches_coarse_ghosts = false;
+          for (unsigned int v = 0; v < n_lanes; ++v)
+            {
+              // on the coarse level, check all indices of the family the
+              // parent belongs to, which is a superset of the ones accessed
+              const unsigned int *fine_indices =
+                &level_dof_indices[level][(cell + v) * n_child_cell_dofs];
+              const unsigned int *coarse_indices =
+                &level_dof_indices[level - 1]
+                                  [parent_child_connect[level - 1][cell + v]
+                                     .first *
+                                   n_child_cell_dofs];
+              for (unsigned int i = 0; i < n_child_cell_dofs; ++i)
+                {
+                  if (fine_indices[i] >= n_fine_owned)
+                    touches_fine_ghosts = true;
+                  if (coarse_indices[i] >= n_coarse_owned)
+                    touches_coarse_ghosts = true;
+                }
+            }
+          cell_batch_groups[level - 1]
+                           [(touches_fine_ghosts ? 1 : 0) +
+                            (touches_coarse_ghosts ? 2 : 0)]
+                             .push_back(cell / vec_size);
+        }
+    }
+
   evaluation_data.resize(n_child_cell_dofs);
 }
 
@@ -168,8 +211,10 @@ MGTransferMatrixFree<dim, Number>::prolongate(
   AssertDimension(this->ghosted_level_vector[to_level - 1].local_size(),
                   src.local_size());
 
+  // only start the import of ghost values here, do_prolongate_add() finishes
+  // it once the cells not depending on ghost values have been processed
   this->ghosted_level_vector[to_level - 1].copy_locally_owned_data_from(src);
-  this->ghosted_level_vector[to_level - 1].update_ghost_values();
+  this->ghosted_level_vector[to_level - 1].update_ghost_values_start();
   this->ghosted_level_vector[to_level] = 0.;
 
   // the implementation in do_prolongate_add is templated in the degree of the
@@ -224,7 +269,6 @@ MGTransferMatrixFree<dim, Number>::prolongate(
                           this->ghosted_level_vector[to_level],
                           this->ghosted_level_vector[to_level - 1]);
 
-  this->ghosted_level_vector[to_level].compress(VectorOperation::add);
   dst.copy_locally_owned_data_from(this->ghosted_level_vector[to_level]);
 }
 
@@ -246,7 +290,7 @@ MGTransferMatrixFree<dim, Number>::restrict_and_add(
                   dst.local_size());
 
   this->ghosted_level_vector[from_level].copy_locally_owned_data_from(src);
-  this->ghosted_level_vector[from_level].update_ghost_values();
+  this->ghosted_level_vector[from_level].update_ghost_values_start();
   this->ghosted_level_vector[from_level - 1] = 0.;
 
   if (fe_degree == 0)
@@ -299,7 +343,6 @@ MGTransferMatrixFree<dim, Number>::restrict_and_add(
                         this->ghosted_level_vector[from_level - 1],
                         this->ghosted_level_vector[from_level]);
 
-  this->ghosted_level_vector[from_level - 1].compress(VectorOperation::add);
   dst += this->ghosted_level_vector[from_level - 1];
 }
 
@@ -355,102 +398,122 @@ MGTransferMatrixFree<dim, Number>::do_prolongate_add(
     Utilities::fixed_power<dim>(n_child_dofs_1d);
   constexpr unsigned int three_to_dim = Utilities::pow(3, dim);
 
-  for (unsigned int cell = 0; cell < n_owned_level_cells[to_level - 1];
-       cell += vec_size)
-    {
-      const unsigned int n_lanes =
-        cell + vec_size > n_owned_level_cells[to_level - 1] ?
-          n_owned_level_cells[to_level - 1] - cell :
-          vec_size;
+  const auto prolongate_batch = [&](const unsigned int batch) {
+    const unsigned int cell = batch * vec_size;
+    const unsigned int n_lanes =
+      cell + vec_size > n_owned_level_cells[to_level - 1] ?
+        n_owned_level_cells[to_level - 1] - cell :
+        vec_size;
 
-      // read from source vector
-      for (unsigned int v = 0; v < n_lanes; ++v)
-        {
-          const unsigned int shift =
-            internal::MGTransfer::compute_shift_within_children<dim>(
-              parent_child_connect[to_level - 1][cell + v].second,
-              fe_degree + 1 - element_is_continuous,
-              fe_degree);
-          const unsigned int *indices =
-            &level_dof_indices[to_level - 1]
-                              [parent_child_connect[to_level - 1][cell + v]
-                                   .first *
-                                 n_child_cell_dofs +
-                               shift];
-          for (unsigned int c = 0, m = 0; c < n_components; ++c)
-            {
-              for (unsigned int k = 0; k < (dim > 2 ? degree_size : 1); ++k)
-                for (unsigned int j = 0; j < (dim > 1 ? degree_size : 1); ++j)
-                  for (unsigned int i = 0; i < degree_size; ++i, ++m)
-                    evaluation_data[m][v] = src.local_element(
-                      indices[c * n_scalar_cell_dofs +
-                              k * n_child_dofs_1d * n_child_dofs_1d +
-                              j * n_child_dofs_1d + i]);
-
-              // apply Dirichlet boundary conditions on parent cell
-              for (std::vector<unsigned short>::const_iterator i =
-                     dirichlet_indices[to_level - 1][cell + v].begin();
-                   i != dirichlet_indices[to_level - 1][cell + v].end();
-                   ++i)
-                evaluation_data[*i][v] = 0.;
-            }
-        }
+    // read from source vector
+    for (unsigned int v = 0; v < n_lanes; ++v)
+      {
+        const unsigned int shift =
+          internal::MGTransfer::compute_shift_within_children<dim>(
+            parent_child_connect[to_level - 1][cell + v].second,
+            fe_degree + 1 - element_is_continuous,
+            fe_degree);
+        const unsigned int *indices =
+          &level_dof_indices[to_level - 1]
+                            [parent_child_connect[to_level - 1][cell + v]
+                                 .first *
+                               n_child_cell_dofs +
+                             shift];
+        for (unsigned int c = 0, m = 0; c < n_components; ++c)
+          {
+            for (unsigned int k = 0; k < (dim > 2 ? degree_size : 1); ++k)
+              for (unsigned int j = 0; j < (dim > 1 ? degree_size : 1); ++j)
+                for (unsigned int i = 0; i < degree_size; ++i, ++m)
+                  evaluation_data[m][v] = src.local_element(
+                    indices[c * n_scalar_cell_dofs +
+                            k * n_child_dofs_1d * n_child_dofs_1d +
+                            j * n_child_dofs_1d + i]);
+
+            // apply Dirichlet boundary conditions on parent cell
+            for (std::vector<unsigned short>::const_iterator i =
+                   dirichlet_indices[to_level - 1][cell + v].begin();
+                 i != dirichlet_indices[to_level - 1][cell + v].end();
+                 ++i)
+              evaluation_data[*i][v] = 0.;
+          }
+      }
 
-      AssertDimension(prolongation_matrix_1d.size(),
-                      degree_size * n_child_dofs_1d);
-      // perform tensorized operation
-      if (element_is_continuous)
-        {
-          // must go through the components backwards because we want to write
-          // the output to the same array as the input
-          for (int c = n_components - 1; c >= 0; --c)
-            internal::FEEvaluationImplBasisChange<internal::evaluate_general,
-                                                  dim,
-                                                  degree + 1,
-                                                  2 * degree + 1,
-                                                  1,
-                                                  VectorizedArray<Number>,
-                                                  VectorizedArray<Number>>::
-              do_forward(prolongation_matrix_1d,
-                         evaluation_data.begin() +
-                           c * Utilities::fixed_power<dim>(degree_size),
-                         evaluation_data.begin() + c * n_scalar_cell_dofs,
-                         fe_degree + 1,
-                         2 * fe_degree + 1);
-          weight_dofs_on_child<dim, degree, Number>(
-            &weights_on_refined[to_level - 1][(cell / vec_size) * three_to_dim],
-            n_components,
-            fe_degree,
-            evaluation_data.begin());
-        }
-      else
-        {
-          for (int c = n_components - 1; c >= 0; --c)
-            internal::FEEvaluationImplBasisChange<internal::evaluate_general,
-                                                  dim,
-                                                  degree + 1,
-                                                  2 * degree + 2,
-                                                  1,
-                                                  VectorizedArray<Number>,
-                                                  VectorizedArray<Number>>::
-              do_forward(prolongation_matrix_1d,
-                         evaluation_data.begin() +
-                           c * Utilities::fixed_power<dim>(degree_size),
-                         evaluation_data.begin() + c * n_scalar_cell_dofs,
-                         fe_degree + 1,
-                         2 * fe_degree + 2);
-        }
+    AssertDimension(prolongation_matrix_1d.size(),
+                    degree_size * n_child_dofs_1d);
+    // perform tensorized operation
+    if (element_is_continuous)
+      {
+        // must go through the components backwards because we want to write
+        // the output to the same array as the input
+        for (int c = n_components - 1; c >= 0; --c)
+          internal::FEEvaluationImplBasisChange<internal::evaluate_general,
+                                                dim,
+                                                degree + 1,
+                                                2 * degree + 1,
+                                                1,
+                                                VectorizedArray<Number>,
+                                                VectorizedArray<Number>>::
+            do_forward(prolongation_matrix_1d,
+                       evaluation_data.begin() +
+                         c * Utilities::fixed_power<dim>(degree_size),
+                       evaluation_data.begin() + c * n_scalar_cell_dofs,
+                       fe_degree + 1,
+                       2 * fe_degree + 1);
+        weight_dofs_on_child<dim, degree, Number>(
+          &weights_on_refined[to_level - 1][(cell / vec_size) * three_to_dim],
+          n_components,
+          fe_degree,
+          evaluation_data.begin());
+      }
+    else
+      {
+        for (int c = n_components - 1; c >= 0; --c)
+          internal::FEEvaluationImplBasisChange<internal::evaluate_general,
+                                                dim,
+                                                degree + 1,
+                                                2 * degree + 2,
+                                                1,
+                                                VectorizedArray<Number>,
+                                                VectorizedArray<Number>>::
+            do_forward(prolongation_matrix_1d,
+                       evaluation_data.begin() +
+                         c * Utilities::fixed_power<dim>(degree_size),
+                       evaluation_data.begin() + c * n_scalar_cell_dofs,
+                       fe_degree + 1,
+                       2 * fe_degree + 2);
+      }
 
-      // write into dst vector
-      const unsigned int *indices =
-        &level_dof_indices[to_level][cell * n_child_cell_dofs];
-      for (unsigned int v = 0; v < n_lanes; ++v)
-        {
-          for (unsigned int i = 0; i < n_child_cell_dofs; ++i)
-            dst.local_element(indices[i]) += evaluation_data[i][v];
-          indices += n_child_cell_dofs;
-        }
-    }
+    // write into dst vector
+    const unsigned int *indices =
+      &level_dof_indices[to_level][cell * n_child_cell_dofs];
+    for (unsigned int v = 0; v < n_lanes; ++v)
+      {
+        for (unsigned int i = 0; i < n_child_cell_dofs; ++i)
+          dst.local_element(indices[i]) += evaluation_data[i][v];
+        indices += n_child_cell_dofs;
+      }
+  };
+
+  // the batches touching ghost entries on the fine level only and the first
+  // half of the batches without ghost access run while the ghost values of
+  // the coarse level are imported, the second half overlaps with sending the
+  // contributions to the ghost entries of the fine level to their owners
+  const std::array<std::vector<unsigned int>, 4> &groups =
+    cell_batch_groups[to_level - 1];
+  const unsigned int n_half_interior = groups[0].size() / 2;
+  for (const unsigned int batch : groups[1])
+    prolongate_batch(batch);
+  for (unsigned int b = 0; b < n_half_interior; ++b)
+    prolongate_batch(groups[0][b]);
+  src.update_ghost_values_finish();
+  for (const unsigned int batch : groups[2])
+    prolongate_batch(batch);
+  for (const unsigned int batch : groups[3])
+    prolongate_batch(batch);
+  dst.compress_start(VectorOperation::add);
+  for (unsigned int b = n_half_interior; b < groups[0].size(); ++b)
+    prolongate_batch(groups[0][b]);
+  dst.compress_finish(VectorOperation::add);
 }
 
 
@@ -470,111 +533,130 @@ MGTransferMatrixFree<dim, Number>::do_restrict_add(
     Utilities::fixed_power<dim>(n_child_dofs_1d);
   constexpr unsigned int three_to_dim = Utilities::pow(3, dim);
 
-  for (unsigned int cell = 0; cell < n_owned_level_cells[from_level - 1];
-       cell += vec_size)
+  const auto restrict_batch = [&](const unsigned int batch) {
+    const unsigned int cell = batch * vec_size;
+    const unsigned int n_lanes =
+      cell + vec_size > n_owned_level_cells[from_level - 1] ?
+        n_owned_level_cells[from_level - 1] - cell :
+        vec_size;
+
+    // read from source vector
     {
-      const unsigned int n_lanes =
-        cell + vec_size > n_owned_level_cells[from_level - 1] ?
-          n_owned_level_cells[from_level - 1] - cell :
-          vec_size;
+      const unsigned int *indices =
+        &level_dof_indices[from_level][cell * n_child_cell_dofs];
+      for (unsigned int v = 0; v < n_lanes; ++v)
+        {
+          for (unsigned int i = 0; i < n_child_cell_dofs; ++i)
+            evaluation_data[i][v] = src.local_element(indices[i]);
+          indices += n_child_cell_dofs;
+        }
+    }
+
+    AssertDimension(prolongation_matrix_1d.size(),
+                    degree_size * n_child_dofs_1d);
+    // perform tensorized operation
+    if (element_is_continuous)
+      {
+        weight_dofs_on_child<dim, degree, Number>(
+          &weights_on_refined[from_level - 1]
+                             [(cell / vec_size) * three_to_dim],
+          n_components,
+          fe_degree,
+          evaluation_data.data());
+        for (unsigned int c = 0; c < n_components; ++c)
+          internal::FEEvaluationImplBasisChange<internal::evaluate_general,
+                                                dim,
+                                                degree + 1,
+                                                2 * degree + 1,
+                                                1,
+                                                VectorizedArray<Number>,
+                                                VectorizedArray<Number>>::
+            do_backward(prolongation_matrix_1d,
+                        false,
+                        evaluation_data.begin() + c * n_scalar_cell_dofs,
+                        evaluation_data.begin() +
+                          c * Utilities::fixed_power<dim>(degree_size),
+                        fe_degree + 1,
+                        2 * fe_degree + 1);
+      }
+    else
+      {
+        for (unsigned int c = 0; c < n_components; ++c)
+          internal::FEEvaluationImplBasisChange<internal::evaluate_general,
+                                                dim,
+                                                degree + 1,
+                                                2 * degree + 2,
+                                                1,
+                                                VectorizedArray<Number>,
+                                                VectorizedArray<Number>>::
+            do_backward(prolongation_matrix_1d,
+                        false,
+                        evaluation_data.begin() + c * n_scalar_cell_dofs,
+                        evaluation_data.begin() +
+                          c * Utilities::fixed_power<dim>(degree_size),
+                        fe_degree + 1,
+                        2 * fe_degree + 2);
+      }
 
-      // read from source vector
+    // write into dst vector
+    for (unsigned int v = 0; v < n_lanes; ++v)
       {
+        const unsigned int shift =
+          internal::MGTransfer::compute_shift_within_children<dim>(
+            parent_child_connect[from_level - 1][cell + v].second,
+            fe_degree + 1 - element_is_continuous,
+            fe_degree);
+        AssertIndexRange(
+          parent_child_connect[from_level - 1][cell + v].first *
+              n_child_cell_dofs +
+            n_child_cell_dofs - 1,
+          level_dof_indices[from_level - 1].size());
         const unsigned int *indices =
-          &level_dof_indices[from_level][cell * n_child_cell_dofs];
-        for (unsigned int v = 0; v < n_lanes; ++v)
+          &level_dof_indices[from_level - 1]
+                            [parent_child_connect[from_level - 1][cell + v]
+                                 .first *
+                               n_child_cell_dofs +
+                             shift];
+        for (unsigned int c = 0, m = 0; c < n_components; ++c)
           {
-            for (unsigned int i = 0; i < n_child_cell_dofs; ++i)
-              evaluation_data[i][v] = src.local_element(indices[i]);
-            indices += n_child_cell_dofs;
+            // apply Dirichlet boundary conditions on parent cell
+            for (std::vector<unsigned short>::const_iterator i =
+                   dirichlet_indices[from_level - 1][cell + v].begin();
+                 i != dirichlet_indices[from_level - 1][cell + v].end();
+                 ++i)
+              evaluation_data[*i][v] = 0.;
+
+            for (unsigned int k = 0; k < (dim > 2 ? degree_size : 1); ++k)
+              for (unsigned int j = 0; j < (dim > 1 ? degree_size : 1); ++j)
+                for (unsigned int i = 0; i < degree_size; ++i, ++m)
+                  dst.local_element(
+                    indices[c * n_scalar_cell_dofs +
+                            k * n_child_dofs_1d * n_child_dofs_1d +
+                            j * n_child_dofs_1d + i]) +=
+                    evaluation_data[m][v];
           }
       }
-
-      AssertDimension(prolongation_matrix_1d.size(),
-                      degree_size * n_child_dofs_1d);
-      // perform tensorized operation
-      if (element_is_continuous)
-        {
-          weight_dofs_on_child<dim, degree, Number>(
-            &weights_on_refined[from_level - 1]
-                               [(cell / vec_size) * three_to_dim],
-            n_components,
-            fe_degree,
-            evaluation_data.data());
-          for (unsigned int c = 0; c < n_components; ++c)
-            internal::FEEvaluationImplBasisChange<internal::evaluate_general,
-                                                  dim,
-                                                  degree + 1,
-                                                  2 * degree + 1,
-                                                  1,
-                                                  VectorizedArray<Number>,
-                                                  VectorizedArray<Number>>::
-              do_backward(prolongation_matrix_1d,
-                          false,
-                          evaluation_data.begin() + c * n_scalar_cell_dofs,
-                          evaluation_data.begin() +
-                            c * Utilities::fixed_power<dim>(degree_size),
-                          fe_degree + 1,
-                          2 * fe_degree + 1);
-        }
-      else
-        {
-          for (unsigned int c = 0; c < n_components; ++c)
-            internal::FEEvaluationImplBasisChange<internal::evaluate_general,
-                                                  dim,
-                                                  degree + 1,
-                                                  2 * degree + 2,
-                                                  1,
-                                                  VectorizedArray<Number>,
-                                                  VectorizedArray<Number>>::
-              do_backward(prolongation_matrix_1d,
-                          false,
-                          evaluation_data.begin() + c * n_scalar_cell_dofs,
-                          evaluation_data.begin() +
-                            c * Utilities::fixed_power<dim>(degree_size),
-                          fe_degree + 1,
-                          2 * fe_degree + 2);
-        }
-
-      // write into dst vector
-      for (unsigned int v = 0; v < n_lanes; ++v)
-        {
-          const unsigned int shift =
-            internal::MGTransfer::compute_shift_within_children<dim>(
-              parent_child_connect[from_level - 1][cell + v].second,
-              fe_degree + 1 - element_is_continuous,
-              fe_degree);
-          AssertIndexRange(
-            parent_child_connect[from_level - 1][cell + v].first *
-                n_child_cell_dofs +
-              n_child_cell_dofs - 1,
-            level_dof_indices[from_level - 1].size());
-          const unsigned int *indices =
-            &level_dof_indices[from_level - 1]
-                              [parent_child_connect[from_level - 1][cell + v]
-                                   .first *
-                                 n_child_cell_dofs +
-                               shift];
-          for (unsigned int c = 0, m = 0; c < n_components; ++c)
-            {
-              // apply Dirichlet boundary conditions on parent cell
-              for (std::vector<unsigned short>::const_iterator i =
-                     dirichlet_indices[from_level - 1][cell + v].begin();
-                   i != dirichlet_indices[from_level - 1][cell + v].end();
-                   ++i)
-                evaluation_data[*i][v] = 0.;
-
-              for (unsigned int k = 0; k < (dim > 2 ? degree_size : 1); ++k)
-                for (unsigned int j = 0; j < (dim > 1 ? degree_size : 1); ++j)
-                  for (unsigned int i = 0; i < degree_size; ++i, ++m)
-                    dst.local_element(
-                      indices[c * n_scalar_cell_dofs +
-                              k * n_child_dofs_1d * n_child_dofs_1d +
-                              j * n_child_dofs_1d + i]) +=
-                      evaluation_data[m][v];
-            }
-        }
-    }
+  };
+
+  // same split as in do_prolongate_add(), with the roles of the fine and the
+  // coarse level exchanged: the ghost values are imported on the fine level
+  // and the contributions to ghost entries are sent from the coarse level
+  const std::array<std::vector<unsigned int>, 4> &groups =
+    cell_batch_groups[from_level - 1];
+  const unsigned int n_half_interior = groups[0].size() / 2;
+  for (const unsigned int batch : groups[2])
+    restrict_batch(batch);
+  for (unsigned int b = 0; b < n_half_interior; ++b)
+    restrict_batch(groups[0][b]);
+  src.update_ghost_values_finish();
+  for (const unsigned int batch : groups[1])
+    restrict_batch(batch);
+  for (const unsigned int batch : groups[3])
+    restrict_batch(batch);
+  dst.compress_start(VectorOperation::add);
+  for (unsigned int b = n_half_interior; b < groups[0].size(); ++b)
+    restrict_batch(groups[0][b]);
+  dst.compress_finish(VectorOperation::add);
 }
 
 
@@ -592,6 +674,9 @@ MGTransferMatrixFree<dim, Number>::memory_consumption() const
   memory += MemoryConsumption::memory_consumption(evaluation_data);
   memory += MemoryConsumption::memory_consumption(weights_on_refined);
   memory += MemoryConsumption::memory_consumption(dirichlet_indices);
+  for (const auto &groups : cell_batch_groups)
+    for (const auto &group : groups)
+      memory += MemoryConsumption::memory_consumption(group);
   return memory;
 }
 
@@ -123,6 +123,16 @@ namespace Particles
   {
     if (this != &particle)
       {
+        // Release the properties this particle currently owns before taking
+        // over the ones of the other particle
+        if (properties != PropertyPool::invalid_handle)
+          {
+            if (property_pool != nullptr)
+              property_pool->deallocate_properties_array(properties);
+            else
+              delete[] properties;
+          }
+
         location           = particle.location;
         reference_location = particle.reference_location;
         id                 = particle.id;
@@ -155,6 +165,14 @@ namespace Particles
   {
     if (this != &particle)
       {
+        if (properties != PropertyPool::invalid_handle)
+          {
+            if (property_pool != nullptr)
+              property_pool->deallocate_properties_array(properties);
+            else
+              delete[] properties;
+          }
+
         location            = particle.location;
         reference_location  = particle.reference_location;
         id                  = particle.id;
@@ -170,8 +188,15 @@ namespace Particles
   template <int dim, int spacedim>
   Particle<dim, spacedim>::~Particle()
   {
-    if (property_pool != nullptr && properties != PropertyPool::invalid_handle)
-      property_pool->deallocate_properties_array(properties);
+    if (properties != PropertyPool::invalid_handle)
+      {
+        if (property_pool != nullptr)
+          property_pool->deallocate_properties_array(properties);
+        else
+          // The properties were created during deserialization, before the
+          // particle was associated with a property pool
+          delete[] properties;
+      }
   }
 
 
@@ -274,6 +299,37 @@ namespace Particles
   void
   Particle<dim, spacedim>::set_property_pool(PropertyPool &new_property_pool)
   {
+    if (property_pool == &new_property_pool)
+      return;
+
+    // If the particle already stores properties, either in another pool or
+    // in memory that was allocated during deserialization, move them into a
+    // slot of the new pool, since the handle is only meaningful for the pool
+    // that created it.
+    if (properties != PropertyPool::invalid_handle)
+      {
+        const PropertyPool::Handle new_handle =
+          new_property_pool.allocate_properties_array();
+        const ArrayView<double> new_properties =
+          new_property_pool.get_properties(new_handle);
+
+        const unsigned int n_old_properties =
+          (property_pool != nullptr) ? property_pool->n_properties_per_slot() :
+                                       new_properties.size();
+        std::copy(properties,
+                  properties +
+                    std::min<unsigned int>(n_old_properties,
+                                           new_properties.size()),
+                  new_properties.begin());
+
+        if (property_pool != nullptr)
+          property_pool->deallocate_properties_array(properties);
+        else
+          delete[] properties;
+
+        properties = new_handle;
+      }
+
     property_pool = &new_property_pool;
   }
 
@@ -21,7 +21,21 @@ namespace Particles
 {
   template <int dim, int spacedim>
   ParticleAccessor<dim, spacedim>::ParticleAccessor()
-    : map(nullptr)
+    : particles(nullptr)
+    , particle_index(numbers::invalid_unsigned_int)
+    , map(nullptr)
+    , particle()
+  {}
+
+
+
+  template <int dim, int spacedim>
+  ParticleAccessor<dim, spacedim>::ParticleAccessor(
+    const ParticleArrays<dim, spacedim> &particles,
+    const unsigned int                   particle_index)
+    : particles(const_cast<ParticleArrays<dim, spacedim> *>(&particles))
+    , particle_index(particle_index)
+    , map(nullptr)
     , particle()
   {}
 
@@ -32,7 +46,9 @@ namespace Particles
     const std::multimap<internal::LevelInd, Particle<dim, spacedim>> &map,
     const typename std::multimap<internal::LevelInd,
                                  Particle<dim, spacedim>>::iterator & particle)
-    : map(const_cast<
+    : particles(nullptr)
+    , particle_index(numbers::invalid_unsigned_int)
+    , map(const_cast<
           std::multimap<internal::LevelInd, Particle<dim, spacedim>> *>(&map))
     , particle(particle)
   {}
@@ -43,9 +59,35 @@ namespace Particles
   void
   ParticleAccessor<dim, spacedim>::write_data(void *&data) const
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    particle->second.write_data(data);
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        particle->second.write_data(data);
+        return;
+      }
+
+    AssertIndexRange(particle_index, particles->n_particles());
+
+    // this has to match the format written by Particle::write_data()
+    types::particle_index *id_data = static_cast<types::particle_index *>(data);
+    *id_data                       = particles->ids[particle_index];
+    ++id_data;
+    double *pdata = reinterpret_cast<double *>(id_data);
+
+    const Point<spacedim> &location = particles->locations[particle_index];
+    for (unsigned int i = 0; i < spacedim; ++i, ++pdata)
+      *pdata = location(i);
+
+    const Point<dim> &reference_location =
+      particles->reference_locations[particle_index];
+    for (unsigned int i = 0; i < dim; ++i, ++pdata)
+      *pdata = reference_location(i);
+
+    const ArrayView<const double> particle_properties = get_properties();
+    for (unsigned int i = 0; i < particle_properties.size(); ++i, ++pdata)
+      *pdata = particle_properties[i];
+
+    data = static_cast<void *>(pdata);
   }
 
 
@@ -54,9 +96,16 @@ namespace Particles
   void
   ParticleAccessor<dim, spacedim>::set_location(const Point<spacedim> &new_loc)
   {
-    Assert(particle != map->end(), ExcInternalError());
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        particle->second.set_location(new_loc);
+        return;
+      }
+
+    AssertIndexRange(particle_index, particles->n_particles());
 
-    particle->second.set_location(new_loc);
+    particles->locations[particle_index] = new_loc;
   }
 
 
@@ -65,9 +114,15 @@ namespace Particles
   const Point<spacedim> &
   ParticleAccessor<dim, spacedim>::get_location() const
   {
-    Assert(particle != map->end(), ExcInternalError());
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        return particle->second.get_location();
+      }
 
-    return particle->second.get_location();
+    AssertIndexRange(particle_index, particles->n_particles());
+
+    return particles->locations[particle_index];
   }
 
 
@@ -77,9 +132,16 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::set_reference_location(
     const Point<dim> &new_loc)
   {
-    Assert(particle != map->end(), ExcInternalError());
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        particle->second.set_reference_location(new_loc);
+        return;
+      }
+
+    AssertIndexRange(particle_index, particles->n_particles());
 
-    particle->second.set_reference_location(new_loc);
+    particles->reference_locations[particle_index] = new_loc;
   }
 
 
@@ -88,9 +150,15 @@ namespace Particles
   const Point<dim> &
   ParticleAccessor<dim, spacedim>::get_reference_location() const
   {
-    Assert(particle != map->end(), ExcInternalError());
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        return particle->second.get_reference_location();
+      }
 
-    return particle->second.get_reference_location();
+    AssertIndexRange(particle_index, particles->n_particles());
+
+    return particles->reference_locations[particle_index];
   }
 
 
@@ -99,9 +167,15 @@ namespace Particles
   types::particle_index
   ParticleAccessor<dim, spacedim>::get_id() const
   {
-    Assert(particle != map->end(), ExcInternalError());
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        return particle->second.get_id();
+      }
+
+    AssertIndexRange(particle_index, particles->n_particles());
 
-    return particle->second.get_id();
+    return particles->ids[particle_index];
   }
 
 
@@ -111,9 +185,21 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::set_property_pool(
     PropertyPool &new_property_pool)
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    particle->second.set_property_pool(new_property_pool);
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        particle->second.set_property_pool(new_property_pool);
+        return;
+      }
+
+    AssertIndexRange(particle_index, particles->n_particles());
+
+    Assert(new_property_pool.n_properties_per_slot() ==
+             particles->n_properties,
+           ExcMessage("The property pool does not provide the number of "
+                      "properties stored for the particles of this "
+                      "container."));
+    (void)new_property_pool;
   }
 
 
@@ -122,9 +208,15 @@ namespace Particles
   bool
   ParticleAccessor<dim, spacedim>::has_properties() const
   {
-    Assert(particle != map->end(), ExcInternalError());
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        return particle->second.has_properties();
+      }
 
-    return particle->second.has_properties();
+    AssertIndexRange(particle_index, particles->n_particles());
+
+    return particles->n_properties > 0;
   }
 
 
@@ -134,10 +226,19 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::set_properties(
     const std::vector<double> &new_properties)
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    particle->second.set_properties(new_properties);
-    return;
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        particle->second.set_properties(new_properties);
+        return;
+      }
+
+    AssertIndexRange(particle_index, particles->n_particles());
+    AssertDimension(new_properties.size(), particles->n_properties);
+
+    std::copy(new_properties.begin(),
+              new_properties.end(),
+              get_properties().begin());
   }
 
 
@@ -146,9 +247,18 @@ namespace Particles
   const ArrayView<const double>
   ParticleAccessor<dim, spacedim>::get_properties() const
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    return particle->second.get_properties();
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        return particle->second.get_properties();
+      }
+
+    AssertIndexRange(particle_index, particles->n_particles());
+
+    return ArrayView<const double>(
+      particles->properties.begin() +
+        static_cast<std::size_t>(particle_index) * particles->n_properties,
+      particles->n_properties);
   }
 
 
@@ -158,10 +268,19 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::get_surrounding_cell(
     const Triangulation<dim, spacedim> &triangulation) const
   {
-    Assert(particle != map->end(), ExcInternalError());
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        const typename Triangulation<dim, spacedim>::cell_iterator cell(
+          &triangulation, particle->first.first, particle->first.second);
+        return cell;
+      }
 
+    AssertIndexRange(particle_index, particles->n_particles());
+
+    const internal::LevelInd &level_index = particles->cells[particle_index];
     const typename Triangulation<dim, spacedim>::cell_iterator cell(
-      &triangulation, particle->first.first, particle->first.second);
+      &triangulation, level_index.first, level_index.second);
     return cell;
   }
 
@@ -171,9 +290,18 @@ namespace Particles
   const ArrayView<double>
   ParticleAccessor<dim, spacedim>::get_properties()
   {
-    Assert(particle != map->end(), ExcInternalError());
-
-    return particle->second.get_properties();
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        return particle->second.get_properties();
+      }
+
+    AssertIndexRange(particle_index, particles->n_particles());
+
+    return ArrayView<double>(
+      particles->properties.begin() +
+        static_cast<std::size_t>(particle_index) * particles->n_properties,
+      particles->n_properties);
   }
 
 
@@ -182,9 +310,16 @@ namespace Particles
   std::size_t
   ParticleAccessor<dim, spacedim>::serialized_size_in_bytes() const
   {
-    Assert(particle != map->end(), ExcInternalError());
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        return particle->second.serialized_size_in_bytes();
+      }
+
+    AssertIndexRange(particle_index, particles->n_particles());
 
-    return particle->second.serialized_size_in_bytes();
+    return sizeof(types::particle_index) + sizeof(Point<spacedim>) +
+           sizeof(Point<dim>) + sizeof(double) * particles->n_properties;
   }
 
 
@@ -193,8 +328,15 @@ namespace Particles
   void
   ParticleAccessor<dim, spacedim>::next()
   {
-    Assert(particle != map->end(), ExcInternalError());
-    ++particle;
+    if (map != nullptr)
+      {
+        Assert(particle != map->end(), ExcInternalError());
+        ++particle;
+        return;
+      }
+
+    AssertIndexRange(particle_index, particles->n_particles());
+    ++particle_index;
   }
 
 
@@ -203,8 +345,15 @@ namespace Particles
   void
   ParticleAccessor<dim, spacedim>::prev()
   {
-    Assert(particle != map->begin(), ExcInternalError());
-    --particle;
+    if (map != nullptr)
+      {
+        Assert(particle != map->begin(), ExcInternalError());
+        --particle;
+        return;
+      }
+
+    Assert(particle_index > 0, ExcInternalError());
+    --particle_index;
   }
 
 
@@ -214,7 +363,11 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::
   operator!=(const ParticleAccessor<dim, spacedim> &other) const
   {
-    return (map != other.map) || (particle != other.particle);
+    if (map != nullptr || other.map != nullptr)
+      return (map != other.map) || (particle != other.particle);
+
+    return (particles != other.particles) ||
+           (particle_index != other.particle_index);
   }
 
 
@@ -224,7 +377,11 @@ namespace Particles
   ParticleAccessor<dim, spacedim>::
   operator==(const ParticleAccessor<dim, spacedim> &other) const
   {
-    return (map == other.map) && (particle == other.particle);
+    if (map != nullptr || other.map != nullptr)
+      return (map == other.map) && (particle == other.particle);
+
+    return (particles == other.particles) &&
+           (particle_index == other.particle_index);
   }
 } // namespace Particles
 
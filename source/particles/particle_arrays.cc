@@ -0,0 +1,372 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+
+#include <deal.II/particles/particle_arrays.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace Particles
+{
+  template <int dim, int spacedim>
+  ParticleArrays<dim, spacedim>::ParticleArrays(
+    const unsigned int n_properties)
+    : n_properties(n_properties)
+    , sorted(true)
+  {}
+
+
+
+  template <int dim, int spacedim>
+  void
+  ParticleArrays<dim, spacedim>::reinit(const unsigned int new_n_properties)
+  {
+    clear();
+    n_properties = new_n_properties;
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  ParticleArrays<dim, spacedim>::clear()
+  {
+    cell_offsets.clear();
+    cells.clear();
+    locations.clear();
+    reference_locations.clear();
+    ids.clear();
+    properties.clear();
+    sorted = true;
+  }
+
+
+
+  template <int dim, int spacedim>
+  unsigned int
+  ParticleArrays<dim, spacedim>::insert(
+    const Particle<dim, spacedim> &                                    particle,
+    const typename Triangulation<dim, spacedim>::active_cell_iterator &cell)
+  {
+    Assert(particle.has_properties() == false ||
+             particle.get_properties().size() == n_properties,
+           ExcMessage("The number of properties of the particle does not "
+                      "match the number of properties stored in this "
+                      "object."));
+
+    // set up the cell ranges if this is the first particle or the mesh has
+    // changed, which returns immediately otherwise
+    sort_into_cells(cell->get_triangulation());
+
+    const unsigned int active_cell_index = cell->active_cell_index();
+    const unsigned int index = cell_offsets[active_cell_index + 1];
+
+    // append the particle and move it to the end of the range of its cell
+    push_back(internal::LevelInd(cell->level(), cell->index()),
+              particle.get_location(),
+              particle.get_reference_location(),
+              particle.get_id(),
+              particle.has_properties() ? particle.get_properties().data() :
+                                          nullptr);
+
+    const unsigned int last = n_particles() - 1;
+    if (index != last)
+      {
+        std::rotate(cells.begin() + index, cells.begin() + last, cells.end());
+        std::rotate(locations.begin() + index,
+                    locations.begin() + last,
+                    locations.end());
+        std::rotate(reference_locations.begin() + index,
+                    reference_locations.begin() + last,
+                    reference_locations.end());
+        std::rotate(ids.begin() + index, ids.begin() + last, ids.end());
+        std::rotate(properties.begin() +
+                      static_cast<std::size_t>(index) * n_properties,
+                    properties.begin() +
+                      static_cast<std::size_t>(last) * n_properties,
+                    properties.end());
+      }
+
+    for (unsigned int c = active_cell_index + 1; c < cell_offsets.size(); ++c)
+      ++cell_offsets[c];
+    sorted = true;
+
+    return index;
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  ParticleArrays<dim, spacedim>::erase(const unsigned int index)
+  {
+    AssertIndexRange(index, n_particles());
+
+    // move the particles behind the removed one forward by one position
+    const unsigned int last = n_particles() - 1;
+    cells.erase(cells.begin() + index);
+    std::copy(locations.begin() + index + 1,
+              locations.end(),
+              locations.begin() + index);
+    locations.resize(last);
+    std::copy(reference_locations.begin() + index + 1,
+              reference_locations.end(),
+              reference_locations.begin() + index);
+    reference_locations.resize(last);
+    ids.erase(ids.begin() + index);
+    std::copy(properties.begin() +
+                static_cast<std::size_t>(index + 1) * n_properties,
+              properties.end(),
+              properties.begin() +
+                static_cast<std::size_t>(index) * n_properties);
+    properties.resize(static_cast<std::size_t>(last) * n_properties);
+
+    // the ranges of all cells behind the removed particle start one
+    // position earlier
+    if (sorted)
+      for (unsigned int &offset : cell_offsets)
+        if (offset > index)
+          --offset;
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  ParticleArrays<dim, spacedim>::erase(const std::vector<unsigned int> &indices)
+  {
+    if (indices.empty())
+      return;
+
+    std::vector<bool> remove(n_particles(), false);
+    for (const unsigned int index : indices)
+      {
+        AssertIndexRange(index, n_particles());
+        remove[index] = true;
+      }
+
+    // compact the arrays in place, keeping the relative order of the
+    // remaining particles
+    unsigned int n_kept = 0;
+    for (unsigned int i = 0; i < remove.size(); ++i)
+      if (remove[i] == false)
+        {
+          if (i != n_kept)
+            {
+              cells[n_kept]               = cells[i];
+              locations[n_kept]           = locations[i];
+              reference_locations[n_kept] = reference_locations[i];
+              ids[n_kept]                 = ids[i];
+              std::copy(properties.begin() +
+                          static_cast<std::size_t>(i) * n_properties,
+                        properties.begin() +
+                          static_cast<std::size_t>(i + 1) * n_properties,
+                        properties.begin() +
+                          static_cast<std::size_t>(n_kept) * n_properties);
+            }
+          ++n_kept;
+        }
+
+    // if the particles were sorted, recompute the cell ranges from the
+    // number of particles removed in front of each range
+    if (sorted && !cell_offsets.empty())
+      {
+        unsigned int n_removed = 0;
+        unsigned int i         = 0;
+        for (unsigned int &offset : cell_offsets)
+          {
+            for (; i < offset; ++i)
+              if (remove[i])
+                ++n_removed;
+            offset -= n_removed;
+          }
+      }
+
+    cells.resize(n_kept);
+    locations.resize(n_kept);
+    reference_locations.resize(n_kept);
+    ids.resize(n_kept);
+    properties.resize(static_cast<std::size_t>(n_kept) * n_properties);
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  ParticleArrays<dim, spacedim>::push_back(
+    const internal::LevelInd &  cell,
+    const Point<spacedim> &     location,
+    const Point<dim> &          reference_location,
+    const types::particle_index id,
+    const double *const         particle_properties)
+  {
+    cells.push_back(cell);
+    locations.push_back(location);
+    reference_locations.push_back(reference_location);
+    ids.push_back(id);
+    sorted = false;
+
+    const std::size_t old_size = properties.size();
+    properties.resize(old_size + n_properties);
+    if (particle_properties != nullptr)
+      std::copy(particle_properties,
+                particle_properties + n_properties,
+                properties.begin() + old_size);
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  ParticleArrays<dim, spacedim>::push_back(
+    const internal::LevelInd &           cell,
+    const ParticleArrays<dim, spacedim> &other,
+    const unsigned int                   index)
+  {
+    AssertIndexRange(index, other.n_particles());
+    AssertDimension(other.n_properties, n_properties);
+
+    push_back(cell,
+              other.locations[index],
+              other.reference_locations[index],
+              other.ids[index],
+              other.properties.begin() +
+                static_cast<std::size_t>(index) * n_properties);
+  }
+
+
+
+  template <int dim, int spacedim>
+  const void *
+  ParticleArrays<dim, spacedim>::push_back(const internal::LevelInd &cell,
+                                           const void *              data)
+  {
+    // this has to match the layout written by ParticleAccessor::write_data()
+    const types::particle_index *id_data =
+      static_cast<const types::particle_index *>(data);
+    const types::particle_index id = *id_data++;
+
+    const double *pdata = reinterpret_cast<const double *>(id_data);
+
+    Point<spacedim> location;
+    for (unsigned int i = 0; i < spacedim; ++i)
+      location(i) = *pdata++;
+
+    Point<dim> reference_location;
+    for (unsigned int i = 0; i < dim; ++i)
+      reference_location(i) = *pdata++;
+
+    push_back(cell, location, reference_location, id, pdata);
+
+    return static_cast<const void *>(pdata + n_properties);
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  ParticleArrays<dim, spacedim>::sort_into_cells(
+    const Triangulation<dim, spacedim> &triangulation)
+  {
+    if (sorted && cell_offsets.size() == triangulation.n_active_cells() + 1)
+      return;
+
+    const unsigned int n_particles = this->n_particles();
+    sorted                         = true;
+
+    // counting sort by the active cell index: count the particles per cell
+    // and compute the new position of each particle from the prefix sums
+    cell_offsets.assign(triangulation.n_active_cells() + 1, 0);
+    std::vector<unsigned int> new_positions(n_particles);
+    for (unsigned int i = 0; i < n_particles; ++i)
+      {
+        const typename Triangulation<dim, spacedim>::active_cell_iterator cell(
+          &triangulation, cells[i].first, cells[i].second);
+        new_positions[i] = cell->active_cell_index();
+        ++cell_offsets[new_positions[i] + 1];
+      }
+
+    for (unsigned int c = 0; c + 1 < cell_offsets.size(); ++c)
+      cell_offsets[c + 1] += cell_offsets[c];
+
+    bool is_sorted = true;
+    {
+      std::vector<unsigned int> next_position(cell_offsets.begin(),
+                                              cell_offsets.end() - 1);
+      for (unsigned int i = 0; i < n_particles; ++i)
+        {
+          new_positions[i] = next_position[new_positions[i]]++;
+          if (new_positions[i] != i)
+            is_sorted = false;
+        }
+    }
+
+    if (is_sorted)
+      return;
+
+    std::vector<internal::LevelInd>    sorted_cells(n_particles);
+    AlignedVector<Point<spacedim>>     sorted_locations(n_particles);
+    AlignedVector<Point<dim>>          sorted_reference_locations(n_particles);
+    std::vector<types::particle_index> sorted_ids(n_particles);
+    AlignedVector<double>              sorted_properties(properties.size());
+    for (unsigned int i = 0; i < n_particles; ++i)
+      {
+        const unsigned int j          = new_positions[i];
+        sorted_cells[j]               = cells[i];
+        sorted_locations[j]           = locations[i];
+        sorted_reference_locations[j] = reference_locations[i];
+        sorted_ids[j]                 = ids[i];
+        std::copy(properties.begin() +
+                    static_cast<std::size_t>(i) * n_properties,
+                  properties.begin() +
+                    static_cast<std::size_t>(i + 1) * n_properties,
+                  sorted_properties.begin() +
+                    static_cast<std::size_t>(j) * n_properties);
+      }
+
+    cells.swap(sorted_cells);
+    locations.swap(sorted_locations);
+    reference_locations.swap(sorted_reference_locations);
+    ids.swap(sorted_ids);
+    properties.swap(sorted_properties);
+  }
+
+
+
+  template <int dim, int spacedim>
+  std::size_t
+  ParticleArrays<dim, spacedim>::memory_consumption() const
+  {
+    return MemoryConsumption::memory_consumption(n_properties) +
+           MemoryConsumption::memory_consumption(cell_offsets) +
+           MemoryConsumption::memory_consumption(sorted) +
+           MemoryConsumption::memory_consumption(cells) +
+           locations.memory_consumption() +
+           reference_locations.memory_consumption() +
+           MemoryConsumption::memory_consumption(ids) +
+           properties.memory_consumption();
+  }
+} // namespace Particles
+
+DEAL_II_NAMESPACE_CLOSE
+
+DEAL_II_NAMESPACE_OPEN
+
+#include "particle_arrays.inst"
+
+DEAL_II_NAMESPACE_CLOSE
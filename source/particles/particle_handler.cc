@@ -13,6 +13,7 @@
 //
 // ---------------------------------------------------------------------
 
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/std_cxx14/memory.h>
 
 #include <deal.II/grid/grid_tools.h>
@@ -28,6 +29,17 @@ DEAL_II_NAMESPACE_OPEN
 
 namespace Particles
 {
+  template <int dim, int spacedim>
+  ParticleHandler<dim, spacedim>::SortingStatistics::SortingStatistics()
+    : n_particles_in_old_cell(0)
+    , n_particles_in_face_neighbor(0)
+    , n_particles_in_vertex_neighbor(0)
+    , n_particles_found_by_global_search(0)
+    , n_particles_lost(0)
+  {}
+
+
+
   template <int dim, int spacedim>
   ParticleHandler<dim, spacedim>::ParticleHandler()
     : triangulation()
@@ -52,8 +64,11 @@ namespace Particles
     const unsigned int                                         n_properties)
     : triangulation(&triangulation, typeid(*this).name())
     , mapping(&mapping, typeid(*this).name())
-    , particles()
-    , ghost_particles()
+    , triangulation_cache(
+        std_cxx14::make_unique<GridTools::Cache<dim, spacedim>>(triangulation,
+                                                                mapping))
+    , particles(n_properties)
+    , ghost_particles(n_properties)
     , global_number_of_particles(0)
     , global_max_particles_per_cell(0)
     , next_free_particle_index(0)
@@ -77,8 +92,23 @@ namespace Particles
     triangulation = &new_triangulation;
     mapping       = &new_mapping;
 
+    triangulation_cache =
+      std_cxx14::make_unique<GridTools::Cache<dim, spacedim>>(new_triangulation,
+                                                              new_mapping);
+
     // Create the memory pool that will store all particle properties
     property_pool = std_cxx14::make_unique<PropertyPool>(n_properties);
+
+    if (particles.n_properties_per_particle() != n_properties)
+      {
+        Assert(particles.n_particles() == 0 &&
+                 ghost_particles.n_particles() == 0,
+               ExcMessage("The number of properties can not be changed "
+                          "while the particle handler still stores "
+                          "particles."));
+        particles.reinit(n_properties);
+        ghost_particles.reinit(n_properties);
+      }
   }
 
 
@@ -108,30 +138,19 @@ namespace Particles
   void
   ParticleHandler<dim, spacedim>::update_cached_numbers()
   {
-    types::particle_index locally_highest_index        = 0;
-    unsigned int          local_max_particles_per_cell = 0;
-    unsigned int          current_particles_per_cell   = 0;
-    typename Triangulation<dim, spacedim>::active_cell_iterator current_cell =
-      triangulation->begin_active();
+    types::particle_index locally_highest_index = 0;
+    for (const types::particle_index id : particles.get_ids())
+      locally_highest_index = std::max(locally_highest_index, id);
 
-    for (particle_iterator particle = begin(); particle != end(); ++particle)
-      {
-        locally_highest_index =
-          std::max(locally_highest_index, particle->get_id());
-
-        if (particle->get_surrounding_cell(*triangulation) != current_cell)
-          {
-            current_particles_per_cell = 0;
-            current_cell = particle->get_surrounding_cell(*triangulation);
-          }
-
-        ++current_particles_per_cell;
+    unsigned int local_max_particles_per_cell = 0;
+    if (particles.n_particles() > 0)
+      for (unsigned int c = 0; c < triangulation->n_active_cells(); ++c)
         local_max_particles_per_cell =
-          std::max(local_max_particles_per_cell, current_particles_per_cell);
-      }
+          std::max(local_max_particles_per_cell,
+                   particles.n_particles_in_cell(c));
 
     global_number_of_particles =
-      dealii::Utilities::MPI::sum(particles.size(),
+      dealii::Utilities::MPI::sum(particles.n_particles(),
                                   triangulation->get_communicator());
     next_free_particle_index =
       dealii::Utilities::MPI::max(locally_highest_index,
@@ -157,7 +176,7 @@ namespace Particles
   typename ParticleHandler<dim, spacedim>::particle_iterator
   ParticleHandler<dim, spacedim>::begin()
   {
-    return particle_iterator(particles, particles.begin());
+    return particle_iterator(particles, 0);
   }
 
 
@@ -175,7 +194,7 @@ namespace Particles
   typename ParticleHandler<dim, spacedim>::particle_iterator
   ParticleHandler<dim, spacedim>::end()
   {
-    return particle_iterator(particles, particles.end());
+    return particle_iterator(particles, particles.n_particles());
   }
 
 
@@ -193,7 +212,7 @@ namespace Particles
   typename ParticleHandler<dim, spacedim>::particle_iterator
   ParticleHandler<dim, spacedim>::begin_ghost()
   {
-    return particle_iterator(ghost_particles, ghost_particles.begin());
+    return particle_iterator(ghost_particles, 0);
   }
 
 
@@ -211,7 +230,7 @@ namespace Particles
   typename ParticleHandler<dim, spacedim>::particle_iterator
   ParticleHandler<dim, spacedim>::end_ghost()
   {
-    return particle_iterator(ghost_particles, ghost_particles.end());
+    return particle_iterator(ghost_particles, ghost_particles.n_particles());
   }
 
 
@@ -233,21 +252,17 @@ namespace Particles
   ParticleHandler<dim, spacedim>::particles_in_cell(
     const typename Triangulation<dim, spacedim>::active_cell_iterator &cell)
   {
-    const internal::LevelInd level_index =
-      std::make_pair(cell->level(), cell->index());
+    const ParticleArrays<dim, spacedim> &container =
+      cell->is_ghost() ? ghost_particles : particles;
 
-    if (cell->is_ghost())
-      {
-        const auto particles_in_cell = ghost_particles.equal_range(level_index);
-        return boost::make_iterator_range(
-          particle_iterator(ghost_particles, particles_in_cell.first),
-          particle_iterator(ghost_particles, particles_in_cell.second));
-      }
-
-    const auto particles_in_cell = particles.equal_range(level_index);
+    const unsigned int active_cell_index = cell->active_cell_index();
+    const unsigned int first =
+      container.first_particle_in_cell(active_cell_index);
     return boost::make_iterator_range(
-      particle_iterator(particles, particles_in_cell.first),
-      particle_iterator(particles, particles_in_cell.second));
+      particle_iterator(container, first),
+      particle_iterator(container,
+                        first +
+                          container.n_particles_in_cell(active_cell_index)));
   }
 
 
@@ -257,7 +272,29 @@ namespace Particles
   ParticleHandler<dim, spacedim>::remove_particle(
     const ParticleHandler<dim, spacedim>::particle_iterator &particle)
   {
-    particles.erase(particle->particle);
+    Assert(particle->particles == &particles,
+           ExcMessage("Only locally owned particles can be removed."));
+
+    particles.erase(particle->particle_index);
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  ParticleHandler<dim, spacedim>::remove_particles(
+    const std::vector<particle_iterator> &particles_to_remove)
+  {
+    std::vector<unsigned int> indices;
+    indices.reserve(particles_to_remove.size());
+    for (const particle_iterator &particle : particles_to_remove)
+      {
+        Assert(particle->particles == &particles,
+               ExcMessage("Only locally owned particles can be removed."));
+        indices.push_back(particle->particle_index);
+      }
+
+    particles.erase(indices);
   }
 
 
@@ -268,20 +305,8 @@ namespace Particles
     const Particle<dim, spacedim> &                                    particle,
     const typename Triangulation<dim, spacedim>::active_cell_iterator &cell)
   {
-    typename std::multimap<internal::LevelInd,
-                           Particle<dim, spacedim>>::iterator it =
-      particles.insert(
-        std::make_pair(internal::LevelInd(cell->level(), cell->index()),
-                       particle));
-
-    particle_iterator particle_it(particles, it);
-    particle_it->set_property_pool(*property_pool);
-
-    if (particle.has_properties())
-      for (unsigned int n = 0; n < particle.get_properties().size(); ++n)
-        particle_it->get_properties()[n] = particle.get_properties()[n];
-
-    return particle_it;
+    const unsigned int index = particles.insert(particle, cell);
+    return particle_iterator(particles, index);
   }
 
 
@@ -293,13 +318,29 @@ namespace Particles
       typename Triangulation<dim, spacedim>::active_cell_iterator,
       Particle<dim, spacedim>> &new_particles)
   {
+    // append all particles and sort them into their cells at once, which
+    // keeps the particles that were already stored in front of the new ones
+    // within each cell
     for (auto particle = new_particles.begin(); particle != new_particles.end();
          ++particle)
-      particles.insert(
-        particles.end(),
-        std::make_pair(internal::LevelInd(particle->first->level(),
-                                          particle->first->index()),
-                       particle->second));
+      {
+        Assert(particle->second.has_properties() == false ||
+                 particle->second.get_properties().size() ==
+                   particles.n_properties_per_particle(),
+               ExcMessage("The number of properties of the particle does not "
+                          "match the number of properties of the particle "
+                          "handler."));
+        particles.push_back(
+          internal::LevelInd(particle->first->level(),
+                             particle->first->index()),
+          particle->second.get_location(),
+          particle->second.get_reference_location(),
+          particle->second.get_id(),
+          particle->second.has_properties() ?
+            particle->second.get_properties().data() :
+            nullptr);
+      }
+    particles.sort_into_cells(*triangulation);
 
     update_cached_numbers();
   }
@@ -345,22 +386,18 @@ namespace Particles
     if (cells.size() == 0)
       return;
 
-    auto hint =
-      particles.find(std::make_pair(cells[0]->level(), cells[0]->index()));
     for (unsigned int i = 0; i < cells.size(); ++i)
       {
-        internal::LevelInd current_cell(cells[i]->level(), cells[i]->index());
+        const internal::LevelInd current_cell(cells[i]->level(),
+                                              cells[i]->index());
         for (unsigned int p = 0; p < local_positions[i].size(); ++p)
-          {
-            hint = particles.insert(
-              hint,
-              std::make_pair(current_cell,
-                             Particle<dim, spacedim>(positions[index_map[i][p]],
-                                                     local_positions[i][p],
-                                                     local_start_index +
-                                                       index_map[i][p])));
-          }
+          particles.push_back(current_cell,
+                              positions[index_map[i][p]],
+                              local_positions[i][p],
+                              local_start_index + index_map[i][p],
+                              nullptr);
       }
+    particles.sort_into_cells(*triangulation);
 
     update_cached_numbers();
   }
@@ -389,7 +426,7 @@ namespace Particles
   types::particle_index
   ParticleHandler<dim, spacedim>::n_locally_owned_particles() const
   {
-    return particles.size();
+    return particles.n_particles();
   }
 
 
@@ -409,13 +446,10 @@ namespace Particles
     const typename Triangulation<dim, spacedim>::active_cell_iterator &cell)
     const
   {
-    const internal::LevelInd found_cell =
-      std::make_pair(cell->level(), cell->index());
-
     if (cell->is_locally_owned())
-      return particles.count(found_cell);
+      return particles.n_particles_in_cell(cell->active_cell_index());
     else if (cell->is_ghost())
-      return ghost_particles.count(found_cell);
+      return ghost_particles.n_particles_in_cell(cell->active_cell_index());
     else if (cell->is_artificial())
       AssertThrow(false, ExcInternalError());
 
@@ -442,6 +476,33 @@ namespace Particles
 
 
 
+  template <int dim, int spacedim>
+  ParticleArrays<dim, spacedim> &
+  ParticleHandler<dim, spacedim>::get_particle_arrays()
+  {
+    return particles;
+  }
+
+
+
+  template <int dim, int spacedim>
+  const ParticleArrays<dim, spacedim> &
+  ParticleHandler<dim, spacedim>::get_particle_arrays() const
+  {
+    return particles;
+  }
+
+
+
+  template <int dim, int spacedim>
+  const typename ParticleHandler<dim, spacedim>::SortingStatistics &
+  ParticleHandler<dim, spacedim>::get_sorting_statistics() const
+  {
+    return sorting_statistics;
+  }
+
+
+
   namespace
   {
     /**
@@ -469,6 +530,28 @@ namespace Particles
       // therefore return if the scalar product of a is larger.
       return (scalar_product_a > scalar_product_b);
     }
+
+
+
+    /**
+     * The stages of the search for the new cell of a particle that has left
+     * its old cell in sort_particles_into_subdomains_and_cells().
+     */
+    enum CellSearchResult : unsigned char
+    {
+      found_in_face_neighbor,
+      found_in_vertex_neighbor,
+      found_by_global_search,
+      not_found
+    };
+
+
+
+    /**
+     * The minimal number of particles that are processed by one task in the
+     * parallel loops over particles.
+     */
+    const unsigned int particle_grain_size = 128;
   } // namespace
 
 
@@ -485,35 +568,73 @@ namespace Particles
     // TODO: Extend this function to allow keeping particles on other
     // processes around (with an invalid cell).
 
-    std::vector<particle_iterator> particles_out_of_cell;
-    particles_out_of_cell.reserve(n_locally_owned_particles());
+    sorting_statistics = SortingStatistics();
 
-    // Now update the reference locations of the moved particles
-    for (particle_iterator it = begin(); it != end(); ++it)
-      {
-        const typename Triangulation<dim, spacedim>::cell_iterator cell =
-          it->get_surrounding_cell(*triangulation);
+    // The particles are addressed by their position in the particle storage
+    // below, so they must not be reordered once we start. They are normally
+    // already sorted, in which case this call returns immediately.
+    particles.sort_into_cells(*triangulation);
+
+    // The loops below work on the particles in parallel. All results are
+    // written into arrays indexed by the position of a particle in the
+    // particle storage and are then collected in this order on a single
+    // thread, which makes the result independent of the number of threads.
+    const unsigned int n_particles = particles.n_particles();
+
+    // The reference locations of the particles with respect to their old
+    // cell. For particles that left their cell, they tell us across which
+    // faces the particles left. If the mapping could not compute a reference
+    // location, we store the center of the cell, which is not outside of any
+    // face.
+    std::vector<Point<dim>> unit_locations(n_particles);
+    std::vector<char>       in_old_cell(n_particles, 0);
+
+    Point<dim> cell_center;
+    for (unsigned int d = 0; d < dim; ++d)
+      cell_center[d] = 0.5;
 
-        try
+    // Now update the reference locations of the moved particles
+    parallel::apply_to_subranges(
+      0U,
+      n_particles,
+      [&](const unsigned int begin, const unsigned int end) {
+        for (unsigned int i = begin; i < end; ++i)
           {
-            const Point<dim> p_unit =
-              mapping->transform_real_to_unit_cell(cell, it->get_location());
-            if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
+            particle_iterator it(particles, i);
+            const typename Triangulation<dim, spacedim>::cell_iterator cell =
+              it->get_surrounding_cell(*triangulation);
+
+            try
               {
-                it->set_reference_location(p_unit);
+                unit_locations[i] =
+                  mapping->transform_real_to_unit_cell(cell,
+                                                       it->get_location());
+                if (GeometryInfo<dim>::is_inside_unit_cell(unit_locations[i]))
+                  {
+                    it->set_reference_location(unit_locations[i]);
+                    in_old_cell[i] = 1;
+                  }
               }
-            else
+            catch (typename Mapping<dim>::ExcTransformationFailed &)
               {
                 // The particle has left the cell
-                particles_out_of_cell.push_back(it);
+                unit_locations[i] = cell_center;
               }
           }
-        catch (typename Mapping<dim>::ExcTransformationFailed &)
-          {
-            // The particle has left the cell
-            particles_out_of_cell.push_back(it);
-          }
-      }
+      },
+      particle_grain_size);
+
+    std::vector<particle_iterator> particles_out_of_cell;
+    std::vector<Point<dim>>        unit_locations_out_of_cell;
+    for (unsigned int i = 0; i < n_particles; ++i)
+      if (in_old_cell[i])
+        ++sorting_statistics.n_particles_in_old_cell;
+      else
+        {
+          // The particle has left the cell
+          particles_out_of_cell.push_back(particle_iterator(particles, i));
+          unit_locations_out_of_cell.push_back(unit_locations[i]);
+        }
 
     // There are three reasons why a particle is not in its old cell:
     // It moved to another cell, to another subdomain or it left the mesh.
@@ -521,7 +642,7 @@ namespace Particles
     // sorted_particles vector, particles that moved to another domain are
     // collected in the moved_particles_domain vector. Particles that left
     // the mesh completely are ignored and removed.
-    std::vector<std::pair<internal::LevelInd, Particle<dim, spacedim>>>
+    std::vector<std::pair<internal::LevelInd, particle_iterator>>
       sorted_particles;
     std::map<types::subdomain_id, std::vector<particle_iterator>>
       moved_particles;
@@ -549,151 +670,265 @@ namespace Particles
       moved_cells[ghost_owner].reserve(
         static_cast<vector_size>(particles_out_of_cell.size() * 0.25));
 
-    {
-      // Create a map from vertices to adjacent cells
-      const std::vector<
-        std::set<typename Triangulation<dim, spacedim>::active_cell_iterator>>
-        vertex_to_cells(GridTools::vertex_to_cell_map(*triangulation));
+    if (!particles_out_of_cell.empty())
+      {
+        // The maps from vertices to adjacent cells and to the directions of
+        // the cell centers, as well as the search tree of the vertices, are
+        // only computed once for every mesh and then stored in the cache.
+        // Get them here, before the threads start, and only pass the
+        // references to the search functions below, such that the cache
+        // itself is not accessed from several threads.
+        const std::vector<
+          std::set<typename Triangulation<dim, spacedim>::active_cell_iterator>>
+          &vertex_to_cells = triangulation_cache->get_vertex_to_cell_map();
+        const std::vector<std::vector<Tensor<1, spacedim>>>
+          &vertex_to_cell_centers =
+            triangulation_cache->get_vertex_to_cell_centers_directions();
+        const RTree<std::pair<Point<spacedim>, unsigned int>>
+          &used_vertices_rtree = triangulation_cache->get_used_vertices_rtree();
+
+        std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>
+                                      new_cells(particles_out_of_cell.size());
+        std::vector<CellSearchResult> search_results(
+          particles_out_of_cell.size(), not_found);
+
+        // Find the cells that the particles moved to.
+        parallel::apply_to_subranges(
+          0U,
+          static_cast<unsigned int>(particles_out_of_cell.size()),
+          [&](const unsigned int begin, const unsigned int end) {
+            std::vector<unsigned int> neighbor_permutation;
+            std::vector<
+              typename Triangulation<dim, spacedim>::active_cell_iterator>
+              face_neighbors;
 
-      // Create a corresponding map of vectors from vertex to cell center
-      const std::vector<std::vector<Tensor<1, spacedim>>>
-        vertex_to_cell_centers(
-          GridTools::vertex_to_cell_centers_directions(*triangulation,
-                                                       vertex_to_cells));
+            for (unsigned int i = begin; i < end; ++i)
+              {
+                particle_iterator &   it       = particles_out_of_cell[i];
+                const Point<spacedim> location = it->get_location();
+
+                const typename Triangulation<dim,
+                                             spacedim>::active_cell_iterator
+                  old_cell = it->get_surrounding_cell(*triangulation);
+
+                // Collect the active neighbors of the old cell across all
+                // faces that the particle crossed according to its reference
+                // location in the old cell. For a particle that moved by less
+                // than one cell this is usually only a single cell.
+                face_neighbors.clear();
+                for (unsigned int d = 0; d < dim; ++d)
+                  {
+                    unsigned int face = numbers::invalid_unsigned_int;
+                    if (unit_locations_out_of_cell[i][d] < 0.)
+                      face = 2 * d;
+                    else if (unit_locations_out_of_cell[i][d] > 1.)
+                      face = 2 * d + 1;
+
+                    if (face == numbers::invalid_unsigned_int ||
+                        old_cell->at_boundary(face))
+                      continue;
+
+                    if (old_cell->neighbor(face)->has_children())
+                      for (unsigned int subface = 0;
+                           subface < old_cell->face(face)->n_children();
+                           ++subface)
+                        face_neighbors.push_back(
+                          old_cell->neighbor_child_on_subface(face, subface));
+                    else
+                      face_neighbors.push_back(old_cell->neighbor(face));
+                  }
 
-      std::vector<unsigned int> neighbor_permutation;
+                for (const auto &cell : face_neighbors)
+                  {
+                    try
+                      {
+                        const Point<dim> p_unit =
+                          mapping->transform_real_to_unit_cell(cell, location);
+                        if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
+                          {
+                            new_cells[i]      = cell;
+                            search_results[i] = found_in_face_neighbor;
+                            it->set_reference_location(p_unit);
+                            break;
+                          }
+                      }
+                    catch (typename Mapping<dim>::ExcTransformationFailed &)
+                      {}
+                  }
 
-      // Find the cells that the particles moved to.
-      typename std::vector<particle_iterator>::iterator
-        it           = particles_out_of_cell.begin(),
-        end_particle = particles_out_of_cell.end();
+                if (search_results[i] == not_found)
+                  {
+                    // Check if the particle is in one of the old cell's
+                    // neighbors that are adjacent to the closest vertex
+                    const unsigned int closest_vertex =
+                      GridTools::find_closest_vertex_of_cell<dim, spacedim>(
+                        old_cell, location);
+                    Tensor<1, spacedim> vertex_to_particle =
+                      location - old_cell->vertex(closest_vertex);
+                    vertex_to_particle /= vertex_to_particle.norm();
+
+                    const unsigned int closest_vertex_index =
+                      old_cell->vertex_index(closest_vertex);
+                    const unsigned int n_neighbor_cells =
+                      vertex_to_cells[closest_vertex_index].size();
+
+                    neighbor_permutation.resize(n_neighbor_cells);
+                    for (unsigned int n = 0; n < n_neighbor_cells; ++n)
+                      neighbor_permutation[n] = n;
+
+                    std::sort(neighbor_permutation.begin(),
+                              neighbor_permutation.end(),
+                              std::bind(&compare_particle_association<spacedim>,
+                                        std::placeholders::_1,
+                                        std::placeholders::_2,
+                                        std::cref(vertex_to_particle),
+                                        std::cref(vertex_to_cell_centers
+                                                    [closest_vertex_index])));
+
+                    // Search all of the cells adjacent to the closest vertex
+                    // of the previous cell, except for the cells that we
+                    // already checked. Most likely we will find the particle
+                    // in them.
+                    for (unsigned int n = 0; n < n_neighbor_cells; ++n)
+                      {
+                        typename std::set<
+                          typename Triangulation<dim, spacedim>::
+                            active_cell_iterator>::const_iterator cell =
+                          vertex_to_cells[closest_vertex_index].begin();
+                        std::advance(cell, neighbor_permutation[n]);
+
+                        if (*cell == old_cell ||
+                            std::find(face_neighbors.begin(),
+                                      face_neighbors.end(),
+                                      *cell) != face_neighbors.end())
+                          continue;
+
+                        try
+                          {
+                            const Point<dim> p_unit =
+                              mapping->transform_real_to_unit_cell(*cell,
+                                                                   location);
+                            if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
+                              {
+                                new_cells[i]      = *cell;
+                                search_results[i] = found_in_vertex_neighbor;
+                                it->set_reference_location(p_unit);
+                                break;
+                              }
+                          }
+                        catch (typename Mapping<dim>::ExcTransformationFailed &)
+                          {}
+                      }
+                  }
 
-      for (; it != end_particle; ++it)
-        {
-          // The cell the particle is in
-          Point<dim> current_reference_position;
-          bool       found_cell = false;
-
-          // Check if the particle is in one of the old cell's neighbors
-          // that are adjacent to the closest vertex
-          typename Triangulation<dim, spacedim>::active_cell_iterator
-            current_cell = (*it)->get_surrounding_cell(*triangulation);
-
-          const unsigned int closest_vertex =
-            GridTools::find_closest_vertex_of_cell<dim, spacedim>(
-              current_cell, (*it)->get_location());
-          Tensor<1, spacedim> vertex_to_particle =
-            (*it)->get_location() - current_cell->vertex(closest_vertex);
-          vertex_to_particle /= vertex_to_particle.norm();
-
-          const unsigned int closest_vertex_index =
-            current_cell->vertex_index(closest_vertex);
-          const unsigned int n_neighbor_cells =
-            vertex_to_cells[closest_vertex_index].size();
-
-          neighbor_permutation.resize(n_neighbor_cells);
-          for (unsigned int i = 0; i < n_neighbor_cells; ++i)
-            neighbor_permutation[i] = i;
-
-          std::sort(neighbor_permutation.begin(),
-                    neighbor_permutation.end(),
-                    std::bind(&compare_particle_association<spacedim>,
-                              std::placeholders::_1,
-                              std::placeholders::_2,
-                              std::cref(vertex_to_particle),
-                              std::cref(
-                                vertex_to_cell_centers[closest_vertex_index])));
-
-          // Search all of the cells adjacent to the closest vertex of the
-          // previous cell Most likely we will find the particle in them.
-          for (unsigned int i = 0; i < n_neighbor_cells; ++i)
-            {
-              try
-                {
-                  typename std::set<typename Triangulation<dim, spacedim>::
-                                      active_cell_iterator>::const_iterator
-                    cell = vertex_to_cells[closest_vertex_index].begin();
-
-                  std::advance(cell, neighbor_permutation[i]);
-                  const Point<dim> p_unit =
-                    mapping->transform_real_to_unit_cell(*cell,
-                                                         (*it)->get_location());
-                  if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
-                    {
-                      current_cell               = *cell;
-                      current_reference_position = p_unit;
-                      found_cell                 = true;
-                      break;
-                    }
-                }
-              catch (typename Mapping<dim>::ExcTransformationFailed &)
-                {}
-            }
-
-          if (!found_cell)
-            {
-              // The particle is not in a neighbor of the old cell.
-              // Look for the new cell in the whole local domain.
-              // This case is rare.
-              try
-                {
-                  const std::pair<const typename Triangulation<dim, spacedim>::
-                                    active_cell_iterator,
-                                  Point<dim>>
-                    current_cell_and_position =
-                      GridTools::find_active_cell_around_point<>(
-                        *mapping, *triangulation, (*it)->get_location());
-                  current_cell               = current_cell_and_position.first;
-                  current_reference_position = current_cell_and_position.second;
-                }
-              catch (GridTools::ExcPointNotFound<spacedim> &)
-                {
-                  // We can find no cell for this particle. It has left the
-                  // domain due to an integration error or an open boundary.
+                if (search_results[i] == not_found)
+                  {
+                    // The particle is not in a neighbor of the old cell.
+                    // Look for the new cell in the whole local domain,
+                    // starting from the vertex closest to the particle as
+                    // determined by the search tree of the cache. This case
+                    // is rare.
+                    try
+                      {
+                        const auto cell_and_position =
+                          GridTools::find_active_cell_around_point(
+                            *mapping,
+                            static_cast<const Triangulation<dim, spacedim> &>(
+                              *triangulation),
+                            location,
+                            vertex_to_cells,
+                            vertex_to_cell_centers,
+                            typename Triangulation<dim, spacedim>::
+                              active_cell_iterator(),
+                            std::vector<bool>(),
+                            used_vertices_rtree);
+                        new_cells[i]      = cell_and_position.first;
+                        search_results[i] = found_by_global_search;
+                        it->set_reference_location(cell_and_position.second);
+                      }
+                    catch (GridTools::ExcPointNotFound<spacedim> &)
+                      {
+                        // We can find no cell for this particle. It has left
+                        // the domain due to an integration error or an open
+                        // boundary.
+                      }
+                  }
+              }
+          },
+          particle_grain_size);
+
+        for (unsigned int i = 0; i < particles_out_of_cell.size(); ++i)
+          {
+            switch (search_results[i])
+              {
+                case found_in_face_neighbor:
+                  ++sorting_statistics.n_particles_in_face_neighbor;
+                  break;
+                case found_in_vertex_neighbor:
+                  ++sorting_statistics.n_particles_in_vertex_neighbor;
+                  break;
+                case found_by_global_search:
+                  ++sorting_statistics.n_particles_found_by_global_search;
+                  break;
+                case not_found:
+                  ++sorting_statistics.n_particles_lost;
                   continue;
-                }
-            }
-
-          // If we are here, we found a cell and reference position for this
-          // particle
-          (*it)->set_reference_location(current_reference_position);
-
-          // Reinsert the particle into our domain if we own its cell.
-          // Mark it for MPI transfer otherwise
-          if (current_cell->is_locally_owned())
-            {
-              sorted_particles.push_back(
-                std::make_pair(internal::LevelInd(current_cell->level(),
-                                                  current_cell->index()),
-                               (*it)->particle->second));
-            }
-          else
-            {
-              moved_particles[current_cell->subdomain_id()].push_back(*it);
-              moved_cells[current_cell->subdomain_id()].push_back(current_cell);
-            }
-        }
-    }
+              }
 
-    // Sort the updated particles. This pre-sort speeds up inserting
-    // them into particles to O(N) complexity.
-    std::multimap<internal::LevelInd, Particle<dim, spacedim>>
-      sorted_particles_map;
+            // Reinsert the particle into our domain if we own its cell.
+            // Mark it for MPI transfer otherwise
+            const typename Triangulation<dim, spacedim>::active_cell_iterator
+              &current_cell = new_cells[i];
+            if (current_cell->is_locally_owned())
+              {
+                sorted_particles.push_back(
+                  std::make_pair(internal::LevelInd(current_cell->level(),
+                                                    current_cell->index()),
+                                 particles_out_of_cell[i]));
+              }
+            else
+              {
+                moved_particles[current_cell->subdomain_id()].push_back(
+                  particles_out_of_cell[i]);
+                moved_cells[current_cell->subdomain_id()].push_back(
+                  current_cell);
+              }
+          }
+      }
 
     // Exchange particles between processors if we have more than one process
+    ParticleArrays<dim, spacedim> received_particles(
+      particles.n_properties_per_particle());
 #  ifdef DEAL_II_WITH_MPI
     if (dealii::Utilities::MPI::n_mpi_processes(
           triangulation->get_communicator()) > 1)
-      send_recv_particles(moved_particles, sorted_particles_map, moved_cells);
+      send_recv_particles(moved_particles, received_particles, moved_cells);
 #  endif
 
-    sorted_particles_map.insert(sorted_particles.begin(),
-                                sorted_particles.end());
-
-    for (unsigned int i = 0; i < particles_out_of_cell.size(); ++i)
-      remove_particle(particles_out_of_cell[i]);
+    // Rebuild the particle storage if any particle changed its cell: Within
+    // each cell, the particles that stayed come first, followed by the
+    // received ones and the ones that moved between local cells. The stable
+    // sort into cells then keeps this order.
+    if (!particles_out_of_cell.empty() || received_particles.n_particles() > 0)
+      {
+        ParticleArrays<dim, spacedim> new_particles(
+          particles.n_properties_per_particle());
+        for (unsigned int i = 0; i < n_particles; ++i)
+          if (in_old_cell[i])
+            new_particles.push_back(particles.cells[i], particles, i);
+        for (unsigned int i = 0; i < received_particles.n_particles(); ++i)
+          new_particles.push_back(received_particles.cells[i],
+                                  received_particles,
+                                  i);
+        for (const auto &particle : sorted_particles)
+          new_particles.push_back(particle.first,
+                                  particles,
+                                  particle.second->particle_index);
+
+        new_particles.sort_into_cells(*triangulation);
+        particles = std::move(new_particles);
+      }
 
-    particles.insert(sorted_particles_map.begin(), sorted_particles_map.end());
     update_cached_numbers();
   }
 
@@ -720,7 +955,7 @@ namespace Particles
     for (const auto ghost_owner : ghost_owners)
       ghost_particles_by_domain[ghost_owner].reserve(
         static_cast<typename std::vector<particle_iterator>::size_type>(
-          particles.size() * 0.25));
+          particles.n_particles() * 0.25));
 
     std::vector<std::set<unsigned int>> vertex_to_neighbor_subdomain(
       triangulation->n_vertices());
@@ -765,6 +1000,7 @@ namespace Particles
       }
 
     send_recv_particles(ghost_particles_by_domain, ghost_particles);
+    ghost_particles.sort_into_cells(*triangulation);
 #  endif
   }
 
@@ -776,8 +1012,7 @@ namespace Particles
   ParticleHandler<dim, spacedim>::send_recv_particles(
     const std::map<types::subdomain_id, std::vector<particle_iterator>>
       &particles_to_send,
-    std::multimap<internal::LevelInd, Particle<dim, spacedim>>
-      &received_particles,
+    ParticleArrays<dim, spacedim> &received_particles,
     const std::map<
       types::subdomain_id,
       std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>>
@@ -826,46 +1061,71 @@ namespace Particles
     // are send, because we might receive particles from other processes
     if (n_send_particles > 0)
       {
-        // Allocate space for sending particle data
+        // Allocate space for sending particle data. This has to match the
+        // data written by ParticleAccessor::write_data()
         const unsigned int particle_size =
-          begin()->serialized_size_in_bytes() + cellid_size +
-          (size_callback ? size_callback() : 0);
+          sizeof(types::particle_index) + sizeof(Point<spacedim>) +
+          sizeof(Point<dim>) +
+          particles.n_properties_per_particle() * sizeof(double) +
+          cellid_size + (size_callback ? size_callback() : 0);
         send_data.resize(n_send_particles * particle_size);
-        void *data = static_cast<void *>(&send_data.front());
 
-        // Serialize the data sorted by receiving process
+        // Serialize the data sorted by receiving process. Since every
+        // particle occupies the same number of bytes, we know where the data
+        // of each particle ends up in the buffer and can write it in
+        // parallel. We do not know whether a user-provided store_callback is
+        // thread-safe, so in that case the data is written sequentially.
+        unsigned int offset = 0;
         for (unsigned int i = 0; i < n_neighbors; ++i)
           {
-            send_offsets[i] = reinterpret_cast<std::size_t>(data) -
-                              reinterpret_cast<std::size_t>(&send_data.front());
-
-            for (unsigned int j = 0;
-                 j < particles_to_send.at(neighbors[i]).size();
-                 ++j)
-              {
-                // If no target cells are given, use the iterator information
-                typename Triangulation<dim, spacedim>::active_cell_iterator
-                  cell;
-                if (send_cells.size() == 0)
-                  cell =
-                    particles_to_send.at(neighbors[i])[j]->get_surrounding_cell(
-                      *triangulation);
-                else
-                  cell = send_cells.at(neighbors[i])[j];
-
-                const CellId::binary_type cellid =
-                  cell->id().template to_binary<dim>();
-                memcpy(data, &cellid, cellid_size);
-                data = static_cast<char *>(data) + cellid_size;
-
-                particles_to_send.at(neighbors[i])[j]->write_data(data);
-                if (store_callback)
-                  data =
-                    store_callback(particles_to_send.at(neighbors[i])[j], data);
-              }
-            n_send_data[i] = reinterpret_cast<std::size_t>(data) -
-                             send_offsets[i] -
-                             reinterpret_cast<std::size_t>(&send_data.front());
+            const std::vector<particle_iterator> &send_particles =
+              particles_to_send.at(neighbors[i]);
+
+            send_offsets[i] = offset;
+            n_send_data[i]  = send_particles.size() * particle_size;
+            offset += n_send_data[i];
+
+            const auto pack = [&](const unsigned int begin,
+                                  const unsigned int end) {
+              void *data = static_cast<void *>(
+                send_data.data() + send_offsets[i] + begin * particle_size);
+              for (unsigned int j = begin; j < end; ++j)
+                {
+                  // If no target cells are given, use the iterator
+                  // information
+                  typename Triangulation<dim, spacedim>::active_cell_iterator
+                    cell;
+                  if (send_cells.size() == 0)
+                    cell =
+                      send_particles[j]->get_surrounding_cell(*triangulation);
+                  else
+                    cell = send_cells.at(neighbors[i])[j];
+
+                  const CellId::binary_type cellid =
+                    cell->id().template to_binary<dim>();
+                  memcpy(data, &cellid, cellid_size);
+                  data = static_cast<char *>(data) + cellid_size;
+
+                  send_particles[j]->write_data(data);
+                  if (store_callback)
+                    data = store_callback(send_particles[j], data);
+                }
+              Assert(static_cast<char *>(data) ==
+                       send_data.data() + send_offsets[i] +
+                         end * particle_size,
+                     ExcMessage("The amount of data written for a particle "
+                                "does not match the size announced by "
+                                "the size_callback function."));
+            };
+
+            if (store_callback)
+              pack(0, send_particles.size());
+            else
+              parallel::apply_to_subranges(0U,
+                                           static_cast<unsigned int>(
+                                             send_particles.size()),
+                                           pack,
+                                           particle_grain_size);
           }
       }
 
@@ -953,31 +1213,48 @@ namespace Particles
     }
 
     // Put the received particles into the domain if they are in the
-    // triangulation
-    const void *recv_data_it = static_cast<const void *>(recv_data.data());
+    // triangulation. Every received particle occupies the same number of
+    // bytes, so we can first look up the cells of all particles in parallel
+    // before we insert the particles one after the other.
+    const std::size_t recv_particle_size =
+      cellid_size + sizeof(types::particle_index) + sizeof(Point<spacedim>) +
+      sizeof(Point<dim>) +
+      property_pool->n_properties_per_slot() * sizeof(double) +
+      (size_callback ? size_callback() : 0);
+    const unsigned int n_recv_particles = total_recv_data / recv_particle_size;
+    AssertDimension(n_recv_particles * recv_particle_size, total_recv_data);
+
+    std::vector<internal::LevelInd> recv_cells(n_recv_particles);
+    parallel::apply_to_subranges(
+      0U,
+      n_recv_particles,
+      [&](const unsigned int begin, const unsigned int end) {
+        for (unsigned int i = begin; i < end; ++i)
+          {
+            CellId::binary_type binary_cellid;
+            memcpy(&binary_cellid,
+                   recv_data.data() + i * recv_particle_size,
+                   cellid_size);
+            const typename Triangulation<dim, spacedim>::active_cell_iterator
+              cell = CellId(binary_cellid).to_cell(*triangulation);
+            recv_cells[i] = internal::LevelInd(cell->level(), cell->index());
+          }
+      },
+      particle_grain_size);
 
-    while (reinterpret_cast<std::size_t>(recv_data_it) -
-             reinterpret_cast<std::size_t>(recv_data.data()) <
-           total_recv_data)
+    const void *recv_data_it = static_cast<const void *>(recv_data.data());
+    for (unsigned int i = 0; i < n_recv_particles; ++i)
       {
-        CellId::binary_type binary_cellid;
-        memcpy(&binary_cellid, recv_data_it, cellid_size);
-        const CellId id(binary_cellid);
         recv_data_it = static_cast<const char *>(recv_data_it) + cellid_size;
 
-        const typename Triangulation<dim, spacedim>::active_cell_iterator cell =
-          id.to_cell(*triangulation);
-
-        typename std::multimap<internal::LevelInd,
-                               Particle<dim, spacedim>>::iterator
-          recv_particle = received_particles.insert(std::make_pair(
-            internal::LevelInd(cell->level(), cell->index()),
-            Particle<dim, spacedim>(recv_data_it, property_pool.get())));
+        recv_data_it =
+          received_particles.push_back(recv_cells[i], recv_data_it);
 
         if (load_callback)
-          recv_data_it =
-            load_callback(particle_iterator(received_particles, recv_particle),
-                          recv_data_it);
+          recv_data_it = load_callback(
+            particle_iterator(received_particles,
+                              received_particles.n_particles() - 1),
+            recv_data_it);
       }
 
     AssertThrow(recv_data_it == recv_data.data() + recv_data.size(),
@@ -1084,6 +1361,7 @@ namespace Particles
 
         non_const_triangulation->notify_ready_to_unpack(handle,
                                                         callback_function);
+        particles.sort_into_cells(*triangulation);
 
         // Reset handle and update global number of particles. The number
         // can change because of discarded or newly generated particles
@@ -1102,6 +1380,41 @@ namespace Particles
   {
     std::vector<Particle<dim, spacedim>> stored_particles_on_cell;
 
+    // The particles are stored as Particle objects, which keeps the format
+    // of the stored data independent of the layout of the particle storage.
+    const auto store_particles_of_cell =
+      [&](const typename Triangulation<dim, spacedim>::cell_iterator
+            &particle_cell) {
+        const ParticleArrays<dim, spacedim> &container =
+          particle_cell->is_ghost() ? ghost_particles : particles;
+        const unsigned int active_cell_index =
+          particle_cell->active_cell_index();
+        const unsigned int first =
+          container.first_particle_in_cell(active_cell_index);
+        const unsigned int end =
+          first + container.n_particles_in_cell(active_cell_index);
+        const unsigned int n_properties =
+          container.n_properties_per_particle();
+
+        for (unsigned int i = first; i < end; ++i)
+          {
+            stored_particles_on_cell.emplace_back(
+              container.locations[i],
+              container.reference_locations[i],
+              container.ids[i]);
+            if (n_properties > 0)
+              {
+                Particle<dim, spacedim> &particle =
+                  stored_particles_on_cell.back();
+                particle.set_property_pool(*property_pool);
+                particle.set_properties(ArrayView<const double>(
+                  container.properties.begin() +
+                    static_cast<std::size_t>(i) * n_properties,
+                  n_properties));
+              }
+          }
+      };
+
     switch (status)
       {
         case parallel::distributed::Triangulation<dim, spacedim>::CELL_PERSIST:
@@ -1109,25 +1422,10 @@ namespace Particles
           // If the cell persist or is refined store all particles of the
           // current cell.
           {
-            unsigned int n_particles = 0;
-
-            const internal::LevelInd level_index = {cell->level(),
-                                                    cell->index()};
-            const auto               particles_in_cell =
-              (cell->is_ghost() ? ghost_particles.equal_range(level_index) :
-                                  particles.equal_range(level_index));
-
-            n_particles = n_particles_in_cell(cell);
+            const unsigned int n_particles = n_particles_in_cell(cell);
             stored_particles_on_cell.reserve(n_particles);
 
-            std::for_each(
-              particles_in_cell.first,
-              particles_in_cell.second,
-              [&stored_particles_on_cell](
-                const std::pair<internal::LevelInd, Particle<dim, spacedim>>
-                  &particle) {
-                stored_particles_on_cell.push_back(particle.second);
-              });
+            store_particles_of_cell(cell);
 
             AssertDimension(n_particles, stored_particles_on_cell.size());
           }
@@ -1153,25 +1451,7 @@ namespace Particles
             for (unsigned int child_index = 0;
                  child_index < GeometryInfo<dim>::max_children_per_cell;
                  ++child_index)
-              {
-                const typename Triangulation<dim, spacedim>::cell_iterator
-                                         child       = cell->child(child_index);
-                const internal::LevelInd level_index = {child->level(),
-                                                        child->index()};
-                const auto               particles_in_cell =
-                  (child->is_ghost() ?
-                     ghost_particles.equal_range(level_index) :
-                     particles.equal_range(level_index));
-
-                std::for_each(
-                  particles_in_cell.first,
-                  particles_in_cell.second,
-                  [&stored_particles_on_cell](
-                    const std::pair<internal::LevelInd, Particle<dim, spacedim>>
-                      &particle) {
-                    stored_particles_on_cell.push_back(particle.second);
-                  });
-              }
+              store_particles_of_cell(cell->child(child_index));
 
             AssertDimension(n_particles, stored_particles_on_cell.size());
           }
@@ -1193,8 +1473,6 @@ namespace Particles
     const typename Triangulation<dim, spacedim>::CellStatus         status,
     const boost::iterator_range<std::vector<char>::const_iterator> &data_range)
   {
-    // We leave this container non-const to be able to `std::move`
-    // its contents directly into the particles multimap later.
     std::vector<Particle<dim, spacedim>> loaded_particles_on_cell =
       Utilities::unpack<std::vector<Particle<dim, spacedim>>>(
         data_range.begin(),
@@ -1207,91 +1485,55 @@ namespace Particles
     for (auto &particle : loaded_particles_on_cell)
       particle.set_property_pool(*property_pool);
 
+    // The particles are appended to the particle storage without sorting
+    // them into their cells, which happens once all cells have been loaded
+    // in register_load_callback_function().
+    const auto append_particle =
+      [&](const typename Triangulation<dim, spacedim>::cell_iterator
+            &                            particle_cell,
+          const Particle<dim, spacedim> &particle,
+          const Point<dim> &             reference_location) {
+        Assert(particle.has_properties() == false ||
+                 particle.get_properties().size() ==
+                   particles.n_properties_per_particle(),
+               ExcMessage("The number of properties of the stored particles "
+                          "does not match the number of properties of the "
+                          "particle handler."));
+        particles.push_back(
+          internal::LevelInd(particle_cell->level(), particle_cell->index()),
+          particle.get_location(),
+          reference_location,
+          particle.get_id(),
+          particle.has_properties() ? particle.get_properties().data() :
+                                      nullptr);
+      };
+
     switch (status)
       {
         case parallel::distributed::Triangulation<dim, spacedim>::CELL_PERSIST:
           {
-            auto position_hint = particles.end();
             for (const auto &particle : loaded_particles_on_cell)
-              {
-                // Use std::multimap::emplace_hint to speed up insertion of
-                // particles. This is a C++11 function, but not all compilers
-                // that report a -std=c++11 (like gcc 4.6) implement it, so
-                // require C++14 instead.
-#  ifdef DEAL_II_WITH_CXX14
-                position_hint =
-                  particles.emplace_hint(position_hint,
-                                         std::make_pair(cell->level(),
-                                                        cell->index()),
-                                         std::move(particle));
-#  else
-                position_hint =
-                  particles.insert(position_hint,
-                                   std::make_pair(std::make_pair(cell->level(),
-                                                                 cell->index()),
-                                                  std::move(particle)));
-#  endif
-                // Move the hint position forward by one, i.e., for the next
-                // particle. The 'hint' position will thus be right after the
-                // one just inserted.
-                ++position_hint;
-              }
+              append_particle(cell,
+                              particle,
+                              particle.get_reference_location());
           }
           break;
 
         case parallel::distributed::Triangulation<dim, spacedim>::CELL_COARSEN:
           {
-            typename std::multimap<internal::LevelInd,
-                                   Particle<dim, spacedim>>::iterator
-              position_hint = particles.end();
-            for (auto &particle : loaded_particles_on_cell)
+            for (const auto &particle : loaded_particles_on_cell)
               {
                 const Point<dim> p_unit =
                   mapping->transform_real_to_unit_cell(cell,
                                                        particle.get_location());
-                particle.set_reference_location(p_unit);
-                // Use std::multimap::emplace_hint to speed up insertion of
-                // particles. This is a C++11 function, but not all compilers
-                // that report a -std=c++11 (like gcc 4.6) implement it, so
-                // require C++14 instead.
-#  ifdef DEAL_II_WITH_CXX14
-                position_hint =
-                  particles.emplace_hint(position_hint,
-                                         std::make_pair(cell->level(),
-                                                        cell->index()),
-                                         std::move(particle));
-#  else
-                position_hint =
-                  particles.insert(position_hint,
-                                   std::make_pair(std::make_pair(cell->level(),
-                                                                 cell->index()),
-                                                  std::move(particle)));
-#  endif
-                // Move the hint position forward by one, i.e., for the next
-                // particle. The 'hint' position will thus be right after the
-                // one just inserted.
-                ++position_hint;
+                append_particle(cell, particle, p_unit);
               }
           }
           break;
 
         case parallel::distributed::Triangulation<dim, spacedim>::CELL_REFINE:
           {
-            std::vector<
-              typename std::multimap<internal::LevelInd,
-                                     Particle<dim, spacedim>>::iterator>
-              position_hints(GeometryInfo<dim>::max_children_per_cell);
-            for (unsigned int child_index = 0;
-                 child_index < GeometryInfo<dim>::max_children_per_cell;
-                 ++child_index)
-              {
-                const typename Triangulation<dim, spacedim>::cell_iterator
-                  child                     = cell->child(child_index);
-                position_hints[child_index] = particles.upper_bound(
-                  std::make_pair(child->level(), child->index()));
-              }
-
-            for (auto &particle : loaded_particles_on_cell)
+            for (const auto &particle : loaded_particles_on_cell)
               {
                 for (unsigned int child_index = 0;
                      child_index < GeometryInfo<dim>::max_children_per_cell;
@@ -1307,29 +1549,7 @@ namespace Particles
                             child, particle.get_location());
                         if (GeometryInfo<dim>::is_inside_unit_cell(p_unit))
                           {
-                            particle.set_reference_location(p_unit);
-                            // Use std::multimap::emplace_hint to speed up
-                            // insertion of particles. This is a C++11 function,
-                            // but not all compilers that report a -std=c++11
-                            // (like gcc 4.6) implement it, so require C++14
-                            // instead.
-#  ifdef DEAL_II_WITH_CXX14
-                            position_hints[child_index] =
-                              particles.emplace_hint(
-                                position_hints[child_index],
-                                std::make_pair(child->level(), child->index()),
-                                std::move(particle));
-#  else
-                            position_hints[child_index] = particles.insert(
-                              position_hints[child_index],
-                              std::make_pair(std::make_pair(child->level(),
-                                                            child->index()),
-                                             std::move(particle)));
-#  endif
-                            // Move the hint position forward by one, i.e., for
-                            // the next particle. The 'hint' position will thus
-                            // be right after the one just inserted.
-                            ++position_hints[child_index];
+                            append_particle(child, particle, p_unit);
                             break;
                           }
                       }
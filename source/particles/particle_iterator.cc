@@ -19,6 +19,15 @@ DEAL_II_NAMESPACE_OPEN
 
 namespace Particles
 {
+  template <int dim, int spacedim>
+  ParticleIterator<dim, spacedim>::ParticleIterator(
+    const ParticleArrays<dim, spacedim> &particles,
+    const unsigned int                   particle_index)
+    : accessor(particles, particle_index)
+  {}
+
+
+
   template <int dim, int spacedim>
   ParticleIterator<dim, spacedim>::ParticleIterator(
     const std::multimap<internal::LevelInd, Particle<dim, spacedim>> &map,
@@ -14,27 +14,56 @@
 // ---------------------------------------------------------------------
 
 
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+
 #include <deal.II/particles/property_pool.h>
 
+#include <algorithm>
+#include <functional>
+
 DEAL_II_NAMESPACE_OPEN
 
 namespace Particles
 {
+  namespace
+  {
+    /**
+     * The smallest number of slots that is allocated at once when the pool
+     * runs out of free slots.
+     */
+    const std::size_t min_slots_per_chunk = 1024;
+  } // namespace
+
+
+
   const PropertyPool::Handle PropertyPool::invalid_handle = nullptr;
 
 
   PropertyPool::PropertyPool(const unsigned int n_properties_per_slot)
     : n_properties(n_properties_per_slot)
+    , n_reserved(0)
   {}
 
 
 
+  PropertyPool::~PropertyPool() = default;
+
+
+
   PropertyPool::Handle
   PropertyPool::allocate_properties_array()
   {
-    PropertyPool::Handle handle = PropertyPool::invalid_handle;
-    if (n_properties > 0)
-      handle = new double[n_properties];
+    if (n_properties == 0)
+      return PropertyPool::invalid_handle;
+
+    // Grow the pool geometrically, so that the number of chunks only
+    // increases logarithmically with the number of slots in use.
+    if (free_slots.empty())
+      allocate_chunk(std::max(min_slots_per_chunk, n_reserved));
+
+    const Handle handle = free_slots.back();
+    free_slots.pop_back();
 
     return handle;
   }
@@ -42,33 +71,138 @@ namespace Particles
 
 
   void
-  PropertyPool::deallocate_properties_array(Handle handle)
+  PropertyPool::deallocate_properties_array(const Handle handle)
   {
-    delete[] handle;
+    if (handle == PropertyPool::invalid_handle)
+      return;
+
+#ifdef DEBUG
+    // Make sure the handle was actually handed out by this pool
+    bool found_chunk = false;
+    for (unsigned int c = 0; c < chunks.size(); ++c)
+      if (std::greater_equal<const double *>()(handle, chunks[c].get()) &&
+          std::less<const double *>()(handle,
+                                      chunks[c].get() +
+                                        chunk_sizes[c] * n_properties))
+        {
+          Assert((handle - chunks[c].get()) % n_properties == 0,
+                 ExcMessage("The given handle does not point to the "
+                            "beginning of a slot of this property pool."));
+          found_chunk = true;
+          break;
+        }
+    Assert(found_chunk,
+           ExcMessage("The given handle was not allocated by this "
+                      "property pool."));
+    Assert(free_slots.size() < n_reserved, ExcInternalError());
+#endif
+
+    free_slots.push_back(handle);
   }
 
 
 
-  ArrayView<double>
-  PropertyPool::get_properties(const Handle handle)
+  void
+  PropertyPool::reserve(const std::size_t size)
   {
-    return ArrayView<double>(handle, n_properties);
+    if (n_properties > 0 && size > n_reserved)
+      allocate_chunk(size - n_reserved);
   }
 
 
 
   void
-  PropertyPool::reserve(const std::size_t size)
+  PropertyPool::compact()
+  {
+    if (free_slots.empty())
+      return;
+
+    std::sort(free_slots.begin(),
+              free_slots.end(),
+              std::less<const double *>());
+
+    // Determine the chunks in which no slot is in use any more and remove
+    // their slots from the list of free slots. Since the free list is sorted,
+    // the slots of each chunk form a contiguous range in it.
+    std::vector<bool> release_chunk(chunks.size(), false);
+    bool              release_any = false;
+    for (unsigned int c = 0; c < chunks.size(); ++c)
+      {
+        const double *const chunk_begin = chunks[c].get();
+        const double *const chunk_end =
+          chunks[c].get() + chunk_sizes[c] * n_properties;
+
+        const auto first = std::lower_bound(free_slots.begin(),
+                                            free_slots.end(),
+                                            chunk_begin,
+                                            std::less<const double *>());
+        const auto last  = std::lower_bound(first,
+                                            free_slots.end(),
+                                            chunk_end,
+                                            std::less<const double *>());
+        if (static_cast<std::size_t>(last - first) == chunk_sizes[c])
+          {
+            // Mark the slots of this chunk as to be removed
+            std::fill(first, last, invalid_handle);
+            release_chunk[c] = true;
+            release_any      = true;
+          }
+      }
+
+    if (release_any)
+      {
+        free_slots.erase(std::remove(free_slots.begin(),
+                                     free_slots.end(),
+                                     invalid_handle),
+                         free_slots.end());
+
+        unsigned int n_kept_chunks = 0;
+        for (unsigned int c = 0; c < chunks.size(); ++c)
+          if (release_chunk[c] == false)
+            {
+              chunks[n_kept_chunks]      = std::move(chunks[c]);
+              chunk_sizes[n_kept_chunks] = chunk_sizes[c];
+              ++n_kept_chunks;
+            }
+          else
+            n_reserved -= chunk_sizes[c];
+        chunks.resize(n_kept_chunks);
+        chunk_sizes.resize(n_kept_chunks);
+      }
+
+    // Hand out the slots with the lowest addresses first to keep the
+    // properties of particles allocated from now on close together.
+    std::reverse(free_slots.begin(), free_slots.end());
+  }
+
+
+
+  std::size_t
+  PropertyPool::memory_consumption() const
   {
-    (void)size;
+    return sizeof(*this) + n_reserved * n_properties * sizeof(double) +
+           MemoryConsumption::memory_consumption(chunk_sizes) +
+           chunks.capacity() * sizeof(std::unique_ptr<double[]>) +
+           free_slots.capacity() * sizeof(Handle);
   }
 
 
 
-  unsigned int
-  PropertyPool::n_properties_per_slot() const
+  void
+  PropertyPool::allocate_chunk(const std::size_t n_slots)
   {
-    return n_properties;
+    Assert(n_properties > 0, ExcInternalError());
+
+    chunks.emplace_back(new double[n_slots * n_properties]);
+    chunk_sizes.push_back(n_slots);
+    n_reserved += n_slots;
+
+    // Add the new slots in reverse order, so that they are handed out in
+    // the order of increasing addresses
+    double *const chunk = chunks.back().get();
+    free_slots.reserve(free_slots.size() + n_slots);
+    for (std::size_t i = n_slots; i > 0; --i)
+      free_slots.push_back(chunk + (i - 1) * n_properties);
   }
 } // namespace Particles
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,73 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// test that GridTools::Cache builds the search trees of the used vertices
+// and of the cell bounding boxes only once for every mesh, i.e., repeated
+// calls return the same tree without building it again, and that the trees
+// are rebuilt after the triangulation has been refined
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools_cache.h>
+#include <deal.II/grid/tria.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+test()
+{
+  deallog << "dim=" << dim << std::endl;
+
+  Triangulation<dim> triangulation;
+  GridGenerator::hyper_cube(triangulation);
+  triangulation.refine_global(2);
+
+  GridTools::Cache<dim> cache(triangulation);
+
+  const auto *first_vertex = &*cache.get_used_vertices_rtree().begin();
+  const auto *first_box    = &*cache.get_cell_bounding_boxes_rtree().begin();
+  deallog << "Vertex tree built once: "
+          << (&*cache.get_used_vertices_rtree().begin() == first_vertex ?
+                "yes" :
+                "no")
+          << std::endl;
+  deallog << "Cell bounding box tree built once: "
+          << (&*cache.get_cell_bounding_boxes_rtree().begin() == first_box ?
+                "yes" :
+                "no")
+          << std::endl;
+  deallog << "Entries: " << cache.get_used_vertices_rtree().size()
+          << " vertices, " << cache.get_cell_bounding_boxes_rtree().size()
+          << " cells" << std::endl;
+
+  triangulation.refine_global(1);
+  deallog << "Entries after refinement: "
+          << cache.get_used_vertices_rtree().size() << " vertices, "
+          << cache.get_cell_bounding_boxes_rtree().size() << " cells"
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test<2>();
+  test<3>();
+}
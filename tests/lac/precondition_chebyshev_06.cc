@@ -0,0 +1,176 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Tests the eigenvalue estimates of PreconditionChebyshev: the power
+// iteration with and without warm start, the information returned by
+// get_eigenvalue_information(), the reuse of a stored estimate via
+// AdditionalData::max_eigenvalue, and the fallback of the power iteration
+// for a single degree of freedom where the default initial guess is zero
+
+
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+
+class FullMatrixModified : public FullMatrix<double>
+{
+public:
+  FullMatrixModified(unsigned int size1, unsigned int size2)
+    : FullMatrix<double>(size1, size2)
+  {}
+
+  double
+  el(unsigned int i, unsigned int j) const
+  {
+    return this->operator()(i, j);
+  }
+};
+
+
+
+template <typename InfoType>
+void
+print_info(const std::string &name, const InfoType &info)
+{
+  deallog << name << " estimate: " << info.max_eigenvalue_estimate
+          << ", iterations: " << info.cg_iterations
+          << ", warm start: " << (info.warm_started ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+void
+check()
+{
+  const unsigned int size = 10;
+  FullMatrixModified m(size, size), m_perturbed(size, size);
+  for (unsigned int i = 0; i < size; ++i)
+    {
+      m(i, i)           = i + 1;
+      m_perturbed(i, i) = 1.01 * (i + 1);
+    }
+
+  Vector<double> in(size), out(size), reference(size);
+  for (unsigned int i = 0; i < size; ++i)
+    in(i) = random_value<double>();
+
+  using Preconditioner = PreconditionChebyshev<FullMatrixModified,
+                                               Vector<double>,
+                                               DiagonalMatrix<Vector<double>>>;
+  Preconditioner                 prec;
+  Preconditioner::AdditionalData data;
+  data.smoothing_range = 2 * size;
+  data.degree          = 4;
+  {
+    Vector<double> matrix_diagonal(size);
+    matrix_diagonal     = 1;
+    auto preconditioner = std::make_shared<DiagonalMatrix<Vector<double>>>();
+    preconditioner->reinit(matrix_diagonal);
+    data.preconditioner = std::move(preconditioner);
+  }
+
+  // Lanczos iteration, the default
+  prec.initialize(m, data);
+  prec.vmult(out, in);
+  const Preconditioner::EigenvalueInformation &info =
+    prec.get_eigenvalue_information();
+  deallog << "Lanczos iterations: " << info.cg_iterations << std::endl;
+  deallog << "Lanczos estimate: "
+          << (info.max_eigenvalue_estimate > 1.2 * (size - 1) &&
+                  info.max_eigenvalue_estimate <= 1.2 * size + 1e-12 ?
+                "ok" :
+                "wrong")
+          << std::endl;
+
+  // power iteration, started from the default initial guess
+  data.eigenvalue_algorithm =
+    Preconditioner::AdditionalData::EigenvalueAlgorithm::power_iteration;
+  data.eig_cg_n_iterations = 100;
+  data.eig_cg_residual     = 1e-3;
+  prec.initialize(m, data);
+  prec.vmult(reference, in);
+  print_info("Power iteration", info);
+
+  // reuse the estimate: the result must be the same as before
+  const double max_eigenvalue = info.max_eigenvalue_estimate;
+  {
+    Preconditioner::AdditionalData data_reuse = data;
+    data_reuse.eig_cg_n_iterations            = 0;
+    data_reuse.max_eigenvalue                 = max_eigenvalue;
+    prec.initialize(m, data_reuse);
+    prec.vmult(out, in);
+    print_info("Stored", info);
+    out -= reference;
+    deallog << "Error reused estimate: "
+            << (out.linfty_norm() == 0. ? "ok" : "wrong") << std::endl;
+  }
+
+  // a perturbed matrix without and with warm start
+  prec.initialize(m_perturbed, data);
+  prec.estimate_eigenvalues(in);
+  print_info("Power iteration perturbed", info);
+
+  prec.initialize(m, data);
+  prec.estimate_eigenvalues(in);
+  data.eig_warm_start = true;
+  prec.initialize(m_perturbed, data);
+  prec.estimate_eigenvalues(in);
+  print_info("Power iteration perturbed", info);
+
+  // a single degree of freedom: the default initial guess is zero, so no
+  // iteration is performed
+  {
+    FullMatrixModified m_single(1, 1);
+    m_single(0, 0) = 2.;
+    Vector<double> in_single(1), out_single(1);
+    in_single(0) = 1.;
+
+    Preconditioner                 prec_single;
+    Preconditioner::AdditionalData data_single = data;
+    data_single.eig_warm_start                 = false;
+    {
+      Vector<double> matrix_diagonal(1);
+      matrix_diagonal(0)  = 2.;
+      auto preconditioner = std::make_shared<DiagonalMatrix<Vector<double>>>();
+      preconditioner->reinit(matrix_diagonal);
+      data_single.preconditioner = std::move(preconditioner);
+    }
+    prec_single.initialize(m_single, data_single);
+    prec_single.vmult(out_single, in_single);
+    print_info("Power iteration single dof",
+               prec_single.get_eigenvalue_information());
+  }
+}
+
+
+int
+main()
+{
+  std::ofstream logfile("output");
+  deallog << std::fixed;
+  deallog << std::setprecision(2);
+  deallog.attach(logfile);
+
+  check();
+
+  return 0;
+}
@@ -0,0 +1,237 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Same as precondition_chebyshev_06, but for the power iteration with
+// LinearAlgebra::distributed::Vector: the warm start must work when the
+// ghost entries of the vectors of the new operator differ from the ones of
+// the previous estimate, and all processes must fall back to the default
+// initial guess when the locally owned ranges change
+
+
+#include <deal.II/base/index_set.h>
+#include <deal.II/base/partitioner.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+
+#include "../tests.h"
+
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+
+// The matrix of a finite difference discretization of the 1d Laplacian,
+// scaled by a factor, that reads the neighboring entries from the ghosts of
+// the source vector. Like the matrix-free operators, it requires vectors with
+// the ghost entries of its own partitioner.
+class LaplaceOperator : public Subscriptor
+{
+public:
+  LaplaceOperator(
+    const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+    const double                                              scaling)
+    : partitioner(partitioner)
+    , scaling(scaling)
+  {}
+
+  types::global_dof_index
+  m() const
+  {
+    return partitioner->size();
+  }
+
+  types::global_dof_index
+  n() const
+  {
+    return partitioner->size();
+  }
+
+  double
+  el(const types::global_dof_index i, const types::global_dof_index j) const
+  {
+    return i == j ? 2. * scaling : 0.;
+  }
+
+  void
+  vmult(VectorType &dst, const VectorType &src) const
+  {
+    AssertThrow(src.get_partitioner()->ghost_indices() ==
+                  partitioner->ghost_indices(),
+                ExcMessage("The ghost entries of the vector do not match "
+                           "the ones of the operator."));
+
+    src.update_ghost_values();
+    const types::global_dof_index first = partitioner->local_range().first;
+    for (unsigned int i = 0; i < partitioner->local_size(); ++i)
+      {
+        const types::global_dof_index row   = first + i;
+        double                        value = 2. * src(row);
+        if (row > 0)
+          value -= src(row - 1);
+        if (row + 1 < partitioner->size())
+          value -= src(row + 1);
+        dst.local_element(i) = scaling * value;
+      }
+    src.zero_out_ghosts();
+  }
+
+private:
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
+  const double                                       scaling;
+};
+
+
+
+// Split the entries into two ranges, with the entries adjacent to the
+// boundary between the ranges and the given extra entries as ghosts
+std::shared_ptr<const Utilities::MPI::Partitioner>
+create_partitioner(const types::global_dof_index               size,
+                   const types::global_dof_index               split,
+                   const std::vector<types::global_dof_index> &extra_ghosts)
+{
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+
+  IndexSet owned(size), ghosts(size);
+  if (my_rank == 0)
+    {
+      owned.add_range(0, split);
+      ghosts.add_index(split);
+    }
+  else
+    {
+      owned.add_range(split, size);
+      ghosts.add_index(split - 1);
+    }
+  for (const types::global_dof_index index : extra_ghosts)
+    if (!owned.is_element(index))
+      ghosts.add_index(index);
+
+  return std::make_shared<Utilities::MPI::Partitioner>(owned,
+                                                       ghosts,
+                                                       MPI_COMM_WORLD);
+}
+
+
+
+template <typename InfoType>
+void
+print_info(const std::string &name,
+           const InfoType &   info,
+           const double       max_eigenvalue)
+{
+  // the power iteration approaches the largest eigenvalue from below, and
+  // the estimate includes a safety factor of 1.2
+  const double eigenvalue = info.max_eigenvalue_estimate / 1.2;
+  deallog << name << " estimate: "
+          << (eigenvalue > 0.9 * max_eigenvalue &&
+                  eigenvalue <= max_eigenvalue * (1. + 1e-12) ?
+                "ok" :
+                "wrong")
+          << ", iterations: " << info.cg_iterations
+          << ", warm start: " << (info.warm_started ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+void
+check()
+{
+  const unsigned int size = 200;
+
+  const auto partitioner = create_partitioner(size, size / 2, {});
+  const auto partitioner_more_ghosts =
+    create_partitioner(size, size / 2, {0, 150});
+  const auto partitioner_other_split = create_partitioner(size, 90, {});
+
+  const LaplaceOperator laplace(partitioner, 1.);
+  const LaplaceOperator laplace_perturbed(partitioner_more_ghosts, 1.01);
+  const LaplaceOperator laplace_other_split(partitioner_other_split, 1.01);
+
+  // the largest eigenvalue of the Laplacian preconditioned by the inverse of
+  // its diagonal
+  const double max_eigenvalue = 1. + std::cos(numbers::PI / (size + 1));
+
+  using Preconditioner =
+    PreconditionChebyshev<LaplaceOperator,
+                          VectorType,
+                          DiagonalMatrix<VectorType>>;
+  Preconditioner                 prec;
+  Preconditioner::AdditionalData data;
+  data.smoothing_range      = 20;
+  data.degree               = 4;
+  data.eigenvalue_algorithm = Preconditioner::AdditionalData::
+    EigenvalueAlgorithm::power_iteration;
+  data.eig_cg_n_iterations = 100;
+  data.eig_cg_residual     = 1e-3;
+
+  const auto set_preconditioner =
+    [&](const std::shared_ptr<const Utilities::MPI::Partitioner> &part) {
+      auto preconditioner = std::make_shared<DiagonalMatrix<VectorType>>();
+      preconditioner->get_vector().reinit(part);
+      preconditioner->get_vector() = 0.5;
+      data.preconditioner          = std::move(preconditioner);
+    };
+
+  VectorType in(partitioner), in_more_ghosts(partitioner_more_ghosts),
+    in_other_split(partitioner_other_split);
+  in             = 1.;
+  in_more_ghosts = 1.;
+  in_other_split = 1.;
+
+  const Preconditioner::EigenvalueInformation &info =
+    prec.get_eigenvalue_information();
+
+  set_preconditioner(partitioner);
+  prec.initialize(laplace, data);
+  prec.estimate_eigenvalues(in);
+  print_info("Power iteration", info, max_eigenvalue);
+
+  // a perturbed operator whose vectors have more ghost entries, first
+  // without and then with warm start
+  set_preconditioner(partitioner_more_ghosts);
+  prec.initialize(laplace_perturbed, data);
+  prec.estimate_eigenvalues(in_more_ghosts);
+  print_info("Power iteration perturbed", info, 1.01 * max_eigenvalue);
+
+  set_preconditioner(partitioner);
+  prec.initialize(laplace, data);
+  prec.estimate_eigenvalues(in);
+  data.eig_warm_start = true;
+  set_preconditioner(partitioner_more_ghosts);
+  prec.initialize(laplace_perturbed, data);
+  prec.estimate_eigenvalues(in_more_ghosts);
+  print_info("Power iteration perturbed", info, 1.01 * max_eigenvalue);
+
+  // when the locally owned ranges change, the previous estimate can not be
+  // used on any of the processes
+  set_preconditioner(partitioner_other_split);
+  prec.initialize(laplace_other_split, data);
+  prec.estimate_eigenvalues(in_other_split);
+  print_info("Power iteration other split", info, 1.01 * max_eigenvalue);
+}
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, testing_max_num_threads());
+  MPILogInitAll log;
+
+  check();
+}
@@ -0,0 +1,232 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the multicolored variants of PreconditionSOR and PreconditionSSOR:
+// the coloring must not couple rows of the same color, SOR must give the
+// same result as PSOR with the permutation of the coloring, and all
+// variants must give the same result on one and on several threads
+
+#include <deal.II/base/multithread_info.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+void
+check_coloring(const SparseMatrix<double> &A, const bool print_n_colors)
+{
+  std::vector<types::global_dof_index> permutation, inverse, color_starts;
+  A.compute_multicoloring(permutation, inverse, color_starts);
+
+  std::vector<unsigned int> colors(A.m());
+  for (unsigned int c = 0; c + 1 < color_starts.size(); ++c)
+    for (types::global_dof_index i = color_starts[c]; i < color_starts[c + 1];
+         ++i)
+      colors[permutation[i]] = c;
+
+  bool valid = color_starts.back() == A.m();
+  for (unsigned int row = 0; row < A.m(); ++row)
+    {
+      if (inverse[permutation[row]] != row)
+        valid = false;
+      for (auto entry = A.begin(row); entry != A.end(row); ++entry)
+        if (entry->column() != row && colors[entry->column()] == colors[row])
+          valid = false;
+    }
+
+  if (print_n_colors)
+    deallog << "Number of colors: " << color_starts.size() - 1 << std::endl;
+  deallog << "Coloring valid: " << (valid ? "true" : "false") << std::endl;
+}
+
+
+
+template <typename Preconditioner>
+void
+apply(const SparseMatrix<double> & A,
+      const Vector<double> &       src,
+      const unsigned int           n_threads,
+      std::vector<Vector<double>> &results)
+{
+  MultithreadInfo::set_thread_limit(n_threads);
+
+  Preconditioner                          preconditioner;
+  typename Preconditioner::AdditionalData data;
+  data.relaxation        = 1.2;
+  data.use_multicoloring = true;
+  preconditioner.initialize(A, data);
+
+  Vector<double> dst(src.size());
+  preconditioner.vmult(dst, src);
+  results.push_back(dst);
+  preconditioner.Tvmult(dst, src);
+  results.push_back(dst);
+  dst = 1.;
+  preconditioner.step(dst, src);
+  results.push_back(dst);
+  preconditioner.Tstep(dst, src);
+  results.push_back(dst);
+}
+
+
+
+template <typename Preconditioner>
+bool
+same_on_several_threads(const SparseMatrix<double> &A,
+                        const Vector<double> &      src)
+{
+  std::vector<Vector<double>> one_thread, four_threads;
+  apply<Preconditioner>(A, src, 1, one_thread);
+  apply<Preconditioner>(A, src, 4, four_threads);
+
+  for (unsigned int r = 0; r < one_thread.size(); ++r)
+    for (unsigned int i = 0; i < src.size(); ++i)
+      if (one_thread[r](i) != four_threads[r](i))
+        return false;
+  return true;
+}
+
+
+
+void
+check_preconditioners(const SparseMatrix<double> &A)
+{
+  Vector<double> src(A.m());
+  for (unsigned int i = 0; i < src.size(); ++i)
+    src(i) = random_value<double>();
+
+  // compare multicolored SOR with PSOR in the order of the coloring
+  std::vector<types::global_dof_index> permutation, inverse, color_starts;
+  A.compute_multicoloring(permutation, inverse, color_starts);
+
+  PreconditionSOR<SparseMatrix<double>> sor;
+  sor.initialize(A,
+                 PreconditionSOR<SparseMatrix<double>>::AdditionalData(1.2,
+                                                                       true));
+  Vector<double> dst(src.size()), reference(src);
+  sor.vmult(dst, src);
+  A.PSOR(reference, permutation, inverse, 1.2);
+  bool identical = true;
+  for (unsigned int i = 0; i < src.size(); ++i)
+    if (dst(i) != reference(i))
+      identical = false;
+  sor.Tvmult(dst, src);
+  reference = src;
+  A.TPSOR(reference, permutation, inverse, 1.2);
+  for (unsigned int i = 0; i < src.size(); ++i)
+    if (dst(i) != reference(i))
+      identical = false;
+  deallog << "SOR identical to PSOR: " << (identical ? "true" : "false")
+          << std::endl;
+
+  deallog << "SOR same on several threads: "
+          << (same_on_several_threads<PreconditionSOR<SparseMatrix<double>>>(
+                A, src) ?
+                "true" :
+                "false")
+          << std::endl;
+  deallog << "SSOR same on several threads: "
+          << (same_on_several_threads<PreconditionSSOR<SparseMatrix<double>>>(
+                A, src) ?
+                "true" :
+                "false")
+          << std::endl;
+}
+
+
+
+void
+check_solver(const SparseMatrix<double> &A)
+{
+  Vector<double> rhs(A.m()), solution(A.m());
+  rhs = 1.;
+
+  PreconditionSSOR<SparseMatrix<double>> ssor;
+  ssor.initialize(A,
+                  PreconditionSSOR<SparseMatrix<double>>::AdditionalData(1.2,
+                                                                         true));
+
+  SolverControl            control(1000, 1e-10 * rhs.l2_norm(), false, false);
+  SolverCG<Vector<double>> solver(control);
+  solver.solve(A, solution, rhs, ssor);
+
+  Vector<double> residual(A.m());
+  deallog << "CG with multicolored SSOR converged: "
+          << (A.residual(residual, solution, rhs) < 1e-9 * rhs.l2_norm() ?
+                "true" :
+                "false")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  {
+    deallog.push("FD");
+    const unsigned int size = 65;
+    const unsigned int dim  = (size - 1) * (size - 1);
+    FDMatrix           testproblem(size, size);
+    SparsityPattern    structure(dim, dim, 5);
+    testproblem.five_point_structure(structure);
+    structure.compress();
+    SparseMatrix<double> A(structure);
+    testproblem.five_point(A);
+
+    // the greedy coloring of the five-point stencil is a red-black ordering
+    check_coloring(A, true);
+    check_preconditioners(A);
+    check_solver(A);
+    deallog.pop();
+  }
+
+  {
+    // a matrix with a random, non-symmetric sparsity pattern
+    deallog.push("random");
+    const unsigned int     size = 5000;
+    DynamicSparsityPattern dsp(size, size);
+    for (unsigned int i = 0; i < size; ++i)
+      {
+        dsp.add(i, i);
+        for (unsigned int k = 0; k < 4; ++k)
+          dsp.add(i, Testing::rand() % size);
+      }
+    SparsityPattern sp;
+    sp.copy_from(dsp);
+    SparseMatrix<double> A(sp);
+    for (unsigned int i = 0; i < size; ++i)
+      for (auto entry = sp.begin(i); entry != sp.end(i); ++entry)
+        A.set(i,
+              entry->column(),
+              entry->column() == i ? 10. : -random_value<double>());
+
+    check_coloring(A, false);
+    check_preconditioners(A);
+    deallog.pop();
+  }
+}
@@ -0,0 +1,210 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that the products with SlicedEllpackMatrix agree with the ones of the
+// SparseMatrix it was created from, for matrices with rows of varying length,
+// and use it within SolverCG and PreconditionChebyshev
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/sliced_ellpack_matrix.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include "../testmatrix.h"
+#include "../tests.h"
+
+
+template <typename number>
+void
+check_products(const unsigned int size, const unsigned int sorting_window)
+{
+  // a symmetric matrix with a dominant diagonal and rows of varying length
+  DynamicSparsityPattern dsp(size, size);
+  for (unsigned int i = 0; i < size; ++i)
+    {
+      dsp.add(i, i);
+      const unsigned int n_entries = Testing::rand() % 12;
+      for (unsigned int k = 0; k < n_entries; ++k)
+        {
+          const unsigned int j = Testing::rand() % size;
+          dsp.add(i, j);
+          dsp.add(j, i);
+        }
+    }
+  SparsityPattern sp;
+  sp.copy_from(dsp);
+
+  SparseMatrix<number> A(sp);
+  for (unsigned int i = 0; i < size; ++i)
+    for (auto entry = sp.begin(i); entry != sp.end(i); ++entry)
+      if (entry->column() > i)
+        {
+          const number value = random_value<number>();
+          A.set(i, entry->column(), value);
+          A.set(entry->column(), i, value);
+        }
+  for (unsigned int i = 0; i < size; ++i)
+    A.set(i, i, 30.);
+
+  SlicedEllpackMatrix<number> B(A, sorting_window);
+  AssertDimension(B.m(), size);
+  AssertDimension(B.n(), size);
+  AssertDimension(B.n_nonzero_elements(), A.n_nonzero_elements());
+  AssertThrow(B.n_stored_elements() >= B.n_nonzero_elements(),
+              ExcInternalError());
+
+  bool entries_equal = true;
+  for (unsigned int i = 0; i < size; ++i)
+    for (unsigned int j = 0; j < size; ++j)
+      if (A.el(i, j) != B.el(i, j))
+        entries_equal = false;
+
+  Vector<number> src(size), b(size);
+  for (unsigned int i = 0; i < size; ++i)
+    {
+      src(i) = random_value<number>();
+      b(i)   = random_value<number>();
+    }
+
+  Vector<number> dst_A(size), dst_B(size);
+  A.vmult(dst_A, src);
+  B.vmult(dst_B, src);
+  dst_B -= dst_A;
+  const double error_vmult = dst_B.linfty_norm() / dst_A.linfty_norm();
+
+  dst_A = b;
+  dst_B = b;
+  A.vmult_add(dst_A, src);
+  B.vmult_add(dst_B, src);
+  dst_B -= dst_A;
+  const double error_vmult_add = dst_B.linfty_norm() / dst_A.linfty_norm();
+
+  A.Tvmult(dst_A, src);
+  B.Tvmult(dst_B, src);
+  dst_B -= dst_A;
+  const double error_Tvmult = dst_B.linfty_norm() / dst_A.linfty_norm();
+
+  dst_A = b;
+  dst_B = b;
+  A.Tvmult_add(dst_A, src);
+  B.Tvmult_add(dst_B, src);
+  dst_B -= dst_A;
+  const double error_Tvmult_add = dst_B.linfty_norm() / dst_A.linfty_norm();
+
+  const number residual_A = A.residual(dst_A, src, b);
+  const number residual_B = B.residual(dst_B, src, b);
+  dst_B -= dst_A;
+  const double error_residual =
+    (dst_B.linfty_norm() + std::abs(residual_A - residual_B)) / residual_A;
+
+  const double error_norm =
+    std::abs(A.matrix_norm_square(src) - B.matrix_norm_square(src)) /
+    A.matrix_norm_square(src);
+
+  // the products are summed in a different order, so allow for some
+  // roundoff relative to the size of the result
+  const double tolerance = std::numeric_limits<number>::epsilon() * 100.;
+  deallog << "Size " << size << ", sorting window " << sorting_window
+          << std::endl;
+  deallog << "el:                 " << (entries_equal ? "ok" : "wrong")
+          << std::endl;
+  deallog << "vmult:              "
+          << (error_vmult < tolerance ? "ok" : "wrong") << std::endl;
+  deallog << "vmult_add:          "
+          << (error_vmult_add < tolerance ? "ok" : "wrong") << std::endl;
+  deallog << "Tvmult:             "
+          << (error_Tvmult < tolerance ? "ok" : "wrong") << std::endl;
+  deallog << "Tvmult_add:         "
+          << (error_Tvmult_add < tolerance ? "ok" : "wrong") << std::endl;
+  deallog << "residual:           "
+          << (error_residual < tolerance ? "ok" : "wrong") << std::endl;
+  deallog << "matrix_norm_square: "
+          << (error_norm < tolerance ? "ok" : "wrong") << std::endl;
+}
+
+
+
+void
+check_solver()
+{
+  const unsigned int size = 33;
+  const unsigned int dim  = (size - 1) * (size - 1);
+
+  FDMatrix        testproblem(size, size);
+  SparsityPattern structure(dim, dim, 5);
+  testproblem.five_point_structure(structure);
+  structure.compress();
+  SparseMatrix<double> A(structure);
+  testproblem.five_point(A);
+
+  SlicedEllpackMatrix<double> B(A);
+
+  Vector<double> rhs(dim), solution_A(dim), solution_B(dim);
+  rhs = 1.;
+
+  using Chebyshev = PreconditionChebyshev<SlicedEllpackMatrix<double>>;
+  Chebyshev::AdditionalData data;
+  data.degree          = 3;
+  data.smoothing_range = 10.;
+  Chebyshev preconditioner;
+  preconditioner.initialize(B, data);
+
+  SolverControl            control(1000, 1e-10, false, false);
+  SolverCG<Vector<double>> solver(control);
+  solver.solve(B, solution_B, rhs, preconditioner);
+
+  using ChebyshevSparse = PreconditionChebyshev<SparseMatrix<double>>;
+  ChebyshevSparse::AdditionalData data_sparse;
+  data_sparse.degree          = data.degree;
+  data_sparse.smoothing_range = data.smoothing_range;
+  ChebyshevSparse preconditioner_sparse;
+  preconditioner_sparse.initialize(A, data_sparse);
+  solver.solve(A, solution_A, rhs, preconditioner_sparse);
+
+  solution_B -= solution_A;
+  deallog << "CG with Chebyshev, solution difference: "
+          << (solution_B.linfty_norm() < 1e-8 * solution_A.linfty_norm() ?
+                "ok" :
+                "too large")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("double");
+  check_products<double>(10, 256);
+  check_products<double>(1000, 256);
+  check_products<double>(1000, 1);
+  deallog.pop();
+
+  deallog.push("float");
+  check_products<float>(10, 256);
+  check_products<float>(1000, 256);
+  check_products<float>(1000, 1);
+  deallog.pop();
+
+  check_solver();
+}
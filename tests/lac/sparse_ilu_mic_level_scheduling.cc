@@ -0,0 +1,123 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that the factorization and vmult of SparseILU and SparseMIC give the
+// same results, bit by bit, with and without level scheduling and for
+// different numbers of threads
+
+#include <deal.II/base/multithread_info.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_ilu.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparse_mic.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+template <typename Preconditioner>
+Vector<double>
+apply(const SparseMatrix<double> &A,
+      const Vector<double> &      src,
+      const bool                  use_level_scheduling,
+      const unsigned int          n_threads)
+{
+  MultithreadInfo::set_thread_limit(n_threads);
+
+  typename Preconditioner::AdditionalData data;
+  data.use_level_scheduling = use_level_scheduling;
+  Preconditioner preconditioner;
+  preconditioner.initialize(A, data);
+
+  Vector<double> dst(src.size());
+  preconditioner.vmult(dst, src);
+  return dst;
+}
+
+
+
+template <typename Preconditioner>
+void
+test(const SparseMatrix<double> &A, const Vector<double> &src)
+{
+  const Vector<double> serial = apply<Preconditioner>(A, src, false, 1);
+  const Vector<double> levels_one_thread =
+    apply<Preconditioner>(A, src, true, 1);
+  const Vector<double> levels_four_threads =
+    apply<Preconditioner>(A, src, true, 4);
+
+  bool identical = true;
+  for (unsigned int i = 0; i < src.size(); ++i)
+    if (serial(i) != levels_one_thread(i) ||
+        serial(i) != levels_four_threads(i))
+      identical = false;
+
+  deallog << "Results identical: " << (identical ? "true" : "false")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  // a symmetric, diagonally dominant matrix whose rows only couple to rows
+  // at a distance of 1000 and 3000, so that the forward and backward
+  // substitutions have many independent rows per level
+  const unsigned int     size = 20000;
+  DynamicSparsityPattern dsp(size, size);
+  for (unsigned int i = 0; i < size; ++i)
+    {
+      dsp.add(i, i);
+      for (const unsigned int distance : {1000U, 3000U})
+        if (i + distance < size)
+          {
+            dsp.add(i, i + distance);
+            dsp.add(i + distance, i);
+          }
+    }
+  SparsityPattern sp;
+  sp.copy_from(dsp);
+
+  SparseMatrix<double> A(sp);
+  for (unsigned int i = 0; i < size; ++i)
+    for (auto entry = sp.begin(i); entry != sp.end(i); ++entry)
+      if (entry->column() > i)
+        {
+          const double value = -random_value<double>();
+          A.set(i, entry->column(), value);
+          A.set(entry->column(), i, value);
+        }
+  for (unsigned int i = 0; i < size; ++i)
+    A.set(i, i, 5. + random_value<double>());
+
+  Vector<double> src(size);
+  for (unsigned int i = 0; i < size; ++i)
+    src(i) = random_value<double>();
+
+  deallog.push("ILU");
+  test<SparseILU<double>>(A, src);
+  deallog.pop();
+
+  deallog.push("MIC");
+  test<SparseMIC<double>>(A, src);
+  deallog.pop();
+}
@@ -0,0 +1,91 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that SparseMatrix::Tvmult and SparseMatrix::Tvmult_add give the same
+// result, bit by bit, on one and on several threads
+
+#include <deal.II/base/multithread_info.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+void
+test(const unsigned int m, const unsigned int n)
+{
+  DynamicSparsityPattern dsp(m, n);
+  for (unsigned int i = 0; i < m; ++i)
+    for (unsigned int k = 0; k < 7; ++k)
+      dsp.add(i, Testing::rand() % n);
+  SparsityPattern sp;
+  sp.copy_from(dsp);
+
+  SparseMatrix<double> A(sp);
+  for (SparseMatrix<double>::iterator entry = A.begin(); entry != A.end();
+       ++entry)
+    entry->value() = random_value<double>();
+
+  Vector<double> src(m), dst_add(n);
+  for (unsigned int i = 0; i < m; ++i)
+    src(i) = random_value<double>();
+  for (unsigned int j = 0; j < n; ++j)
+    dst_add(j) = random_value<double>();
+
+  MultithreadInfo::set_thread_limit(1);
+  Vector<double> serial(n), serial_add(dst_add);
+  A.Tvmult(serial, src);
+  A.Tvmult_add(serial_add, src);
+
+  MultithreadInfo::set_thread_limit(4);
+  Vector<double> parallel(n), parallel_add(dst_add);
+  A.Tvmult(parallel, src);
+  A.Tvmult_add(parallel_add, src);
+
+  bool identical = true;
+  for (unsigned int j = 0; j < n; ++j)
+    if (serial(j) != parallel(j) || serial_add(j) != parallel_add(j))
+      identical = false;
+
+  // compare against the product with the transpose formed explicitly
+  Vector<double> reference(n);
+  for (SparseMatrix<double>::const_iterator entry = A.begin();
+       entry != A.end();
+       ++entry)
+    reference(entry->column()) += entry->value() * src(entry->row());
+  reference -= parallel;
+
+  deallog << "Size " << m << " x " << n
+          << ", results identical: " << (identical ? "true" : "false")
+          << ", error: " << (reference.l2_norm() < 1e-12 ? "ok" : "too large")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test(100, 80);
+  test(3000, 2000);
+  test(2000, 3000);
+}
@@ -0,0 +1,110 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that SparseMatrix::compress_column_indices does not change the
+// results of vmult, vmult_add, and residual, and that a SparseMatrix<float>
+// applied to Vector<double> accumulates in double precision, i.e., gives the
+// same result as a SparseMatrix<double> holding the rounded entries
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include "../tests.h"
+
+
+bool
+identical(const Vector<double> &a, const Vector<double> &b)
+{
+  for (unsigned int i = 0; i < a.size(); ++i)
+    if (a(i) != b(i))
+      return false;
+  return true;
+}
+
+
+
+void
+test(const unsigned int m, const unsigned int n)
+{
+  DynamicSparsityPattern dsp(m, n);
+  for (unsigned int i = 0; i < m; ++i)
+    for (unsigned int k = 0; k < 7; ++k)
+      dsp.add(i, Testing::rand() % n);
+  SparsityPattern sp;
+  sp.copy_from(dsp);
+
+  SparseMatrix<float>  A_float(sp);
+  SparseMatrix<double> A_double(sp);
+  for (unsigned int i = 0; i < m; ++i)
+    for (auto entry = sp.begin(i); entry != sp.end(i); ++entry)
+      {
+        const float value = random_value<float>();
+        A_float.set(i, entry->column(), value);
+        A_double.set(i, entry->column(), value);
+      }
+
+  Vector<double> src(n), b(m);
+  for (unsigned int j = 0; j < n; ++j)
+    src(j) = random_value<double>();
+  for (unsigned int i = 0; i < m; ++i)
+    b(i) = random_value<double>();
+
+  Vector<double> reference(m), reference_add(b), reference_residual(m);
+  A_double.vmult(reference, src);
+  A_double.vmult_add(reference_add, src);
+  const double reference_norm = A_double.residual(reference_residual, src, b);
+
+  Vector<double> result(m), result_add(b), result_residual(m);
+  A_float.vmult(result, src);
+  A_float.vmult_add(result_add, src);
+  double norm = A_float.residual(result_residual, src, b);
+  deallog << "Size " << m << " x " << n << ", float storage: "
+          << (identical(result, reference) &&
+                  identical(result_add, reference_add) &&
+                  identical(result_residual, reference_residual) &&
+                  std::abs(norm - reference_norm) < 1e-12 * reference_norm ?
+                "identical" :
+                "different")
+          << std::endl;
+
+  A_float.compress_column_indices();
+  result_add = b;
+  A_float.vmult(result, src);
+  A_float.vmult_add(result_add, src);
+  norm = A_float.residual(result_residual, src, b);
+  deallog << "Size " << m << " x " << n << ", compressed indices: "
+          << (identical(result, reference) &&
+                  identical(result_add, reference_add) &&
+                  identical(result_residual, reference_residual) &&
+                  std::abs(norm - reference_norm) < 1e-12 * reference_norm ?
+                "identical" :
+                "different")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test(100, 80);
+  test(3000, 2000);
+}
@@ -0,0 +1,148 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// SparseMatrix::compress_column_indices only stores a copy of the indices
+// when deal.II is configured with 64-bit indices. Call the kernels of the
+// matrix-vector product and the residual templated on the index type
+// directly with 32-bit and 64-bit column indices, such that both variants
+// are checked against SparseMatrix::vmult, vmult_add, and residual in either
+// configuration
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.templates.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../tests.h"
+
+
+bool
+identical(const Vector<double> &a, const Vector<double> &b)
+{
+  for (unsigned int i = 0; i < a.size(); ++i)
+    if (a(i) != b(i))
+      return false;
+  return true;
+}
+
+
+
+template <typename IndexType>
+void
+check_kernels(const SparseMatrix<float> &A,
+              const Vector<double> &     src,
+              const Vector<double> &     b)
+{
+  // copy the matrix into compressed row storage arrays in the order the
+  // entries are stored in the matrix
+  std::vector<std::size_t> rowstart(1, 0);
+  std::vector<IndexType>   colnums;
+  std::vector<float>       values;
+  for (unsigned int i = 0; i < A.m(); ++i)
+    {
+      for (auto entry = A.begin(i); entry != A.end(i); ++entry)
+        {
+          colnums.push_back(entry->column());
+          values.push_back(entry->value());
+        }
+      rowstart.push_back(colnums.size());
+    }
+
+  Vector<double> reference(A.m()), reference_add(b), reference_residual(A.m());
+  A.vmult(reference, src);
+  A.vmult_add(reference_add, src);
+  const double reference_norm = A.residual(reference_residual, src, b);
+
+  Vector<double> result(A.m()), result_add(b), result_residual(A.m());
+  internal::SparseMatrixImplementation::vmult_on_subrange(0,
+                                                          A.m(),
+                                                          values.data(),
+                                                          rowstart.data(),
+                                                          colnums.data(),
+                                                          src,
+                                                          result,
+                                                          false);
+  internal::SparseMatrixImplementation::vmult_on_subrange(0,
+                                                          A.m(),
+                                                          values.data(),
+                                                          rowstart.data(),
+                                                          colnums.data(),
+                                                          src,
+                                                          result_add,
+                                                          true);
+  const double norm = std::sqrt(
+    internal::SparseMatrixImplementation::residual_sqr_on_subrange(
+      0,
+      A.m(),
+      values.data(),
+      rowstart.data(),
+      colnums.data(),
+      src,
+      b,
+      result_residual));
+
+  deallog << "Size " << A.m() << " x " << A.n() << ", " << 8 * sizeof(IndexType)
+          << "-bit indices: "
+          << (identical(result, reference) &&
+                  identical(result_add, reference_add) &&
+                  identical(result_residual, reference_residual) &&
+                  std::abs(norm - reference_norm) < 1e-12 * reference_norm ?
+                "identical" :
+                "different")
+          << std::endl;
+}
+
+
+
+void
+test(const unsigned int m, const unsigned int n)
+{
+  DynamicSparsityPattern dsp(m, n);
+  for (unsigned int i = 0; i < m; ++i)
+    for (unsigned int k = 0; k < 7; ++k)
+      dsp.add(i, Testing::rand() % n);
+  SparsityPattern sp;
+  sp.copy_from(dsp);
+
+  SparseMatrix<float> A(sp);
+  for (unsigned int i = 0; i < m; ++i)
+    for (auto entry = sp.begin(i); entry != sp.end(i); ++entry)
+      A.set(i, entry->column(), random_value<float>());
+
+  Vector<double> src(n), b(m);
+  for (unsigned int j = 0; j < n; ++j)
+    src(j) = random_value<double>();
+  for (unsigned int i = 0; i < m; ++i)
+    b(i) = random_value<double>();
+
+  check_kernels<std::uint32_t>(A, src, b);
+  check_kernels<std::uint64_t>(A, src, b);
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  test(100, 80);
+  test(3000, 2000);
+}
@@ -0,0 +1,302 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check MatrixFree::cell_loop with operations before and after the loop:
+// the two operations must visit every locally owned entry exactly once, a
+// vector update in the operation before the loop and a scalar product in the
+// one after the loop must give the same result as separate vector
+// operations, and SolverCG and PreconditionChebyshev must give the same
+// results with an operator that fuses the vector updates into the
+// matrix-vector product as with one that does not, both for the serial and a
+// threaded loop schedule
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include "../tests.h"
+
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+
+// the operator M + L for a mass matrix M and a Laplace matrix L
+template <int dim, int fe_degree>
+class HelmholtzOperator : public Subscriptor
+{
+public:
+  HelmholtzOperator(const MatrixFree<dim, double> &data)
+    : data(data)
+  {}
+
+  types::global_dof_index
+  m() const
+  {
+    return data.get_vector_partitioner()->size();
+  }
+
+  double
+  el(const unsigned int, const unsigned int) const
+  {
+    AssertThrow(false, ExcNotImplemented());
+    return 0.;
+  }
+
+  void
+  vmult(VectorType &dst, const VectorType &src) const
+  {
+    data.cell_loop(&HelmholtzOperator::local_apply, this, dst, src, true);
+  }
+
+  // the inverse of the row sums as a cheap approximation of the diagonal
+  void
+  compute_inverse_lumped_diagonal(VectorType &diagonal) const
+  {
+    data.initialize_dof_vector(diagonal);
+    VectorType ones(diagonal);
+    ones = 1.;
+    vmult(diagonal, ones);
+    for (unsigned int i = 0; i < diagonal.local_size(); ++i)
+      diagonal.local_element(i) = 1. / diagonal.local_element(i);
+  }
+
+protected:
+  void
+  local_apply(const MatrixFree<dim, double> &              data,
+              VectorType &                                 dst,
+              const VectorType &                           src,
+              const std::pair<unsigned int, unsigned int> &cell_range) const
+  {
+    FEEvaluation<dim, fe_degree> phi(data);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+      {
+        phi.reinit(cell);
+        phi.gather_evaluate(src, true, true);
+        for (unsigned int q = 0; q < phi.n_q_points; ++q)
+          {
+            phi.submit_value(phi.get_value(q), q);
+            phi.submit_gradient(phi.get_gradient(q), q);
+          }
+        phi.integrate_scatter(true, true, dst);
+      }
+  }
+
+  const MatrixFree<dim, double> &data;
+};
+
+
+
+// the same operator with a matrix-vector product that runs additional
+// operations on the vectors before and after the cell loop
+template <int dim, int fe_degree>
+class HelmholtzOperatorFused : public HelmholtzOperator<dim, fe_degree>
+{
+public:
+  HelmholtzOperatorFused(const MatrixFree<dim, double> &data)
+    : HelmholtzOperator<dim, fe_degree>(data)
+  {}
+
+  using HelmholtzOperator<dim, fe_degree>::vmult;
+
+  void
+  vmult(VectorType &      dst,
+        const VectorType &src,
+        const std::function<void(const unsigned int, const unsigned int)>
+          &operation_before_loop,
+        const std::function<void(const unsigned int, const unsigned int)>
+          &operation_after_loop) const
+  {
+    this->data.cell_loop(&HelmholtzOperatorFused::local_apply,
+                         static_cast<const HelmholtzOperator<dim, fe_degree> *>(
+                           this),
+                         dst,
+                         src,
+                         operation_before_loop,
+                         operation_after_loop);
+  }
+};
+
+
+
+template <int dim, int fe_degree>
+void
+test(const typename MatrixFree<dim, double>::AdditionalData::TasksParallelScheme
+       scheme)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(6 - dim);
+
+  FE_Q<dim>       fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  typename MatrixFree<dim, double>::AdditionalData data;
+  data.tasks_parallel_scheme = scheme;
+  data.tasks_block_size      = 3;
+  data.mapping_update_flags  = update_values | update_gradients;
+
+  MatrixFree<dim, double> mf_data;
+  mf_data.reinit(dof, constraints, QGauss<1>(fe_degree + 1), data);
+
+  HelmholtzOperator<dim, fe_degree>      op(mf_data);
+  HelmholtzOperatorFused<dim, fe_degree> op_fused(mf_data);
+
+  VectorType src, src_scaled, dst, reference;
+  mf_data.initialize_dof_vector(src);
+  mf_data.initialize_dof_vector(src_scaled);
+  mf_data.initialize_dof_vector(dst);
+  mf_data.initialize_dof_vector(reference);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = random_value<double>();
+
+  // scale the source vector before the loop, compute the scalar product with
+  // the result after the loop, and count how often each entry is visited
+  std::vector<unsigned int> n_visits_before(src.local_size()),
+    n_visits_after(src.local_size());
+  double src_times_dst = 0;
+  op_fused.vmult(
+    dst,
+    src_scaled,
+    [&](const unsigned int begin, const unsigned int end) {
+      for (unsigned int i = begin; i < end; ++i)
+        {
+          ++n_visits_before[i];
+          src_scaled.local_element(i) = 2. * src.local_element(i);
+          dst.local_element(i)        = 0.;
+        }
+    },
+    [&](const unsigned int begin, const unsigned int end) {
+      for (unsigned int i = begin; i < end; ++i)
+        {
+          ++n_visits_after[i];
+          src_times_dst += src.local_element(i) * dst.local_element(i);
+        }
+    });
+
+  bool all_visited_once = true;
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    if (n_visits_before[i] != 1 || n_visits_after[i] != 1)
+      all_visited_once = false;
+  deallog << "All entries visited once: " << (all_visited_once ? "yes" : "no")
+          << std::endl;
+
+  src_scaled = 0;
+  src_scaled.add(2., src);
+  op.vmult(reference, src_scaled);
+  const double reference_product = src * reference;
+  reference -= dst;
+  deallog << "Fused operations agree with separate ones: "
+          << (reference.linfty_norm() < 1e-14 * dst.linfty_norm() &&
+                  std::abs(src_times_dst - reference_product) <
+                    1e-12 * std::abs(reference_product) ?
+                "yes" :
+                "no")
+          << std::endl;
+
+  // SolverCG
+  VectorType solution, solution_fused;
+  mf_data.initialize_dof_vector(solution);
+  mf_data.initialize_dof_vector(solution_fused);
+  {
+    SolverControl        control(200, 1e-10 * src.l2_norm(), false, false);
+    SolverCG<VectorType> solver(control);
+    solver.solve(op, solution, src, PreconditionIdentity());
+    const unsigned int n_iterations = control.last_step();
+    solver.solve(op_fused, solution_fused, src, PreconditionIdentity());
+    solution_fused -= solution;
+    deallog << "CG plain and fused agree: "
+            << (control.last_step() == n_iterations &&
+                    solution_fused.linfty_norm() <
+                      1e-8 * solution.linfty_norm() ?
+                  "yes" :
+                  "no")
+            << std::endl;
+  }
+
+  // PreconditionChebyshev with point-Jacobi, both through vmult and step
+  {
+    using Chebyshev =
+      PreconditionChebyshev<HelmholtzOperator<dim, fe_degree>,
+                            VectorType,
+                            DiagonalMatrix<VectorType>>;
+    using ChebyshevFused =
+      PreconditionChebyshev<HelmholtzOperatorFused<dim, fe_degree>,
+                            VectorType,
+                            DiagonalMatrix<VectorType>>;
+    typename Chebyshev::AdditionalData      cheb_data;
+    typename ChebyshevFused::AdditionalData cheb_data_fused;
+    cheb_data.preconditioner = std::make_shared<DiagonalMatrix<VectorType>>();
+    op.compute_inverse_lumped_diagonal(cheb_data.preconditioner->get_vector());
+    cheb_data.degree                    = 4;
+    cheb_data.smoothing_range           = 20.;
+    cheb_data.eig_cg_n_iterations       = 15;
+    cheb_data_fused.preconditioner      = cheb_data.preconditioner;
+    cheb_data_fused.degree              = cheb_data.degree;
+    cheb_data_fused.smoothing_range     = cheb_data.smoothing_range;
+    cheb_data_fused.eig_cg_n_iterations = cheb_data.eig_cg_n_iterations;
+
+    Chebyshev      chebyshev;
+    ChebyshevFused chebyshev_fused;
+    chebyshev.initialize(op, cheb_data);
+    chebyshev_fused.initialize(op_fused, cheb_data_fused);
+
+    chebyshev.vmult(solution, src);
+    chebyshev_fused.vmult(solution_fused, src);
+    chebyshev.step(solution, src);
+    chebyshev_fused.step(solution_fused, src);
+    solution_fused -= solution;
+    deallog << "Chebyshev plain and fused agree: "
+            << (solution_fused.linfty_norm() < 1e-10 * solution.linfty_norm() ?
+                  "yes" :
+                  "no")
+            << std::endl;
+  }
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2, 2>(MatrixFree<2, double>::AdditionalData::none);
+  test<2, 2>(MatrixFree<2, double>::AdditionalData::partition_partition);
+  deallog.pop();
+  deallog.push("3d");
+  test<3, 2>(MatrixFree<3, double>::AdditionalData::none);
+  deallog.pop();
+}
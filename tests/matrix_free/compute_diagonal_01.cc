@@ -0,0 +1,213 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// tests MatrixFreeTools::compute_diagonal on a mesh with hanging nodes and
+// Dirichlet conditions by comparing with the diagonal of an assembled sparse
+// matrix, and MatrixFreeTools::compute_cell_matrices by comparing the sum of
+// the diagonals of the cell matrices with the diagonal of the operator
+// without constraints
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/tools.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim, int fe_degree>
+void
+helmholtz_operator(FEEvaluation<dim, fe_degree> &phi)
+{
+  phi.evaluate(true, true);
+  for (unsigned int q = 0; q < phi.n_q_points; ++q)
+    {
+      phi.submit_value(10. * phi.get_value(q), q);
+      phi.submit_gradient(phi.get_gradient(q), q);
+    }
+  phi.integrate(true, true);
+}
+
+
+
+template <int dim, int fe_degree>
+class HelmholtzOperator
+{
+public:
+  void
+  local_apply(FEEvaluation<dim, fe_degree> &phi) const
+  {
+    helmholtz_operator(phi);
+  }
+};
+
+
+
+template <int dim, int fe_degree>
+void
+test()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(1);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+  tria.last()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  FE_Q<dim>       fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  deallog << "Testing " << fe.get_name() << std::endl;
+
+  AffineConstraints<double> constraints;
+  DoFTools::make_hanging_node_constraints(dof, constraints);
+  VectorTools::interpolate_boundary_values(dof,
+                                           0,
+                                           Functions::ZeroFunction<dim>(),
+                                           constraints);
+  constraints.close();
+
+  MappingQGeneric<dim> mapping(1);
+  MatrixFree<dim>      matrix_free;
+  matrix_free.reinit(mapping, dof, constraints, QGauss<1>(fe_degree + 1));
+
+  Vector<double>                     diagonal;
+  HelmholtzOperator<dim, fe_degree> op;
+  MatrixFreeTools::compute_diagonal(
+    matrix_free,
+    diagonal,
+    &HelmholtzOperator<dim, fe_degree>::local_apply,
+    &op);
+
+  SparsityPattern sparsity;
+  {
+    DynamicSparsityPattern dsp(dof.n_dofs(), dof.n_dofs());
+    DoFTools::make_sparsity_pattern(dof, dsp, constraints, true);
+    sparsity.copy_from(dsp);
+  }
+  SparseMatrix<double> sparse_matrix(sparsity);
+  {
+    QGauss<dim>   quadrature_formula(fe_degree + 1);
+    FEValues<dim> fe_values(mapping,
+                            fe,
+                            quadrature_formula,
+                            update_values | update_gradients |
+                              update_JxW_values);
+
+    FullMatrix<double> cell_matrix(fe.dofs_per_cell, fe.dofs_per_cell);
+    std::vector<types::global_dof_index> local_dof_indices(fe.dofs_per_cell);
+    for (const auto &cell : dof.active_cell_iterators())
+      {
+        cell_matrix = 0;
+        fe_values.reinit(cell);
+        for (unsigned int q = 0; q < quadrature_formula.size(); ++q)
+          for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+            for (unsigned int j = 0; j < fe.dofs_per_cell; ++j)
+              cell_matrix(i, j) +=
+                (fe_values.shape_grad(i, q) * fe_values.shape_grad(j, q) +
+                 10. * fe_values.shape_value(i, q) *
+                   fe_values.shape_value(j, q)) *
+                fe_values.JxW(q);
+
+        cell->get_dof_indices(local_dof_indices);
+        constraints.distribute_local_to_global(cell_matrix,
+                                               local_dof_indices,
+                                               sparse_matrix);
+      }
+  }
+
+  double error = 0;
+  for (unsigned int i = 0; i < dof.n_dofs(); ++i)
+    if (constraints.is_constrained(i))
+      error = std::max(error, std::abs(diagonal(i) - 1.));
+    else
+      error = std::max(error,
+                       std::abs(diagonal(i) - sparse_matrix.diag_element(i)) /
+                         sparse_matrix.diag_element(i));
+  deallog << "Error diagonal: " << (error < 1e-12 ? "ok" : "wrong")
+          << std::endl;
+
+  // without constraints, the diagonal is the sum of the diagonals of the
+  // cell matrices
+  AffineConstraints<double> empty_constraints;
+  empty_constraints.close();
+  matrix_free.reinit(mapping,
+                     dof,
+                     empty_constraints,
+                     QGauss<1>(fe_degree + 1));
+  MatrixFreeTools::compute_diagonal<dim, fe_degree, fe_degree + 1, 1, double>(
+    matrix_free, diagonal, helmholtz_operator<dim, fe_degree>);
+
+  Table<3, VectorizedArray<double>> cell_matrices;
+  MatrixFreeTools::
+    compute_cell_matrices<dim, fe_degree, fe_degree + 1, 1, double>(
+      matrix_free, cell_matrices, helmholtz_operator<dim, fe_degree>);
+
+  Vector<double>               diagonal_from_cells(dof.n_dofs());
+  FEEvaluation<dim, fe_degree> phi(matrix_free);
+  for (unsigned int cell = 0; cell < matrix_free.n_macro_cells(); ++cell)
+    {
+      phi.reinit(cell);
+      for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+        phi.begin_dof_values()[i] = cell_matrices(cell, i, i);
+      phi.distribute_local_to_global(diagonal_from_cells);
+    }
+  diagonal_from_cells -= diagonal;
+  deallog << "Error cell matrices: "
+          << (diagonal_from_cells.linfty_norm() < 1e-12 * diagonal.linfty_norm()
+                ? "ok"
+                : "wrong")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2, 1>();
+  test<2, 2>();
+  test<2, 3>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3, 1>();
+  test<3, 2>();
+  deallog.pop();
+}
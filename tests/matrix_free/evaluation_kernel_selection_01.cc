@@ -0,0 +1,153 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that all sum factorization kernels that can be selected through
+// ShapeInfo::evaluation_kernel for the run time degree evaluators give the
+// same result as the default kernel, and that measure_evaluation_kernels
+// reports timings for the applicable kernels
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/matrix_free/evaluation_selector.h>
+#include <deal.II/matrix_free/shape_info.h>
+
+#include "../tests.h"
+
+
+template <typename Number>
+double
+max_difference(const Number &a, const Number &b)
+{
+  double difference = 0;
+  for (unsigned int v = 0; v < Number::n_array_elements; ++v)
+    difference = std::max(difference, std::abs(a[v] - b[v]));
+  return difference;
+}
+
+
+
+template <int dim>
+void
+test(const unsigned int degree, const unsigned int n_q_points_1d)
+{
+  using Number = VectorizedArray<double>;
+
+  const FE_Q<dim>                                  fe(degree);
+  internal::MatrixFreeFunctions::ShapeInfo<Number> shape_info(
+    QGauss<1>(n_q_points_1d), fe);
+
+  const unsigned int    n_dofs     = shape_info.dofs_per_component_on_cell;
+  const unsigned int    n_q_points = shape_info.n_q_points;
+  AlignedVector<Number> dofs(n_dofs), dofs_ref(n_dofs), dofs_out(n_dofs);
+  AlignedVector<Number> values(n_q_points), values_ref(n_q_points);
+  AlignedVector<Number> gradients(dim * n_q_points),
+    gradients_ref(dim * n_q_points);
+  AlignedVector<Number> hessians(dim * (dim + 1) / 2 * n_q_points);
+  AlignedVector<Number> scratch(3 * (Utilities::fixed_power<dim>(degree + 1) +
+                                     1) +
+                                2 * n_q_points);
+  for (unsigned int i = 0; i < n_dofs; ++i)
+    for (unsigned int v = 0; v < Number::n_array_elements; ++v)
+      dofs[i][v] = random_value<double>();
+
+  const std::array<double, 5> times =
+    internal::measure_evaluation_kernels<dim>(shape_info);
+
+  // reference result with the default kernel
+  SelectEvaluator<dim, -1, 0, 1, Number>::evaluate(shape_info,
+                                                   dofs.begin(),
+                                                   values_ref.begin(),
+                                                   gradients_ref.begin(),
+                                                   hessians.begin(),
+                                                   scratch.begin(),
+                                                   true,
+                                                   true,
+                                                   false);
+  values    = values_ref;
+  gradients = gradients_ref;
+  SelectEvaluator<dim, -1, 0, 1, Number>::integrate(shape_info,
+                                                    dofs_ref.begin(),
+                                                    values.begin(),
+                                                    gradients.begin(),
+                                                    scratch.begin(),
+                                                    true,
+                                                    true,
+                                                    false);
+
+  deallog << "Testing " << fe.get_name() << " with " << n_q_points_1d
+          << " points:";
+  for (unsigned int k = 0; k < times.size(); ++k)
+    {
+      if (times[k] < 0)
+        continue;
+
+      shape_info.evaluation_kernel =
+        static_cast<internal::MatrixFreeFunctions::EvaluationKernel>(k);
+      SelectEvaluator<dim, -1, 0, 1, Number>::evaluate(shape_info,
+                                                       dofs.begin(),
+                                                       values.begin(),
+                                                       gradients.begin(),
+                                                       hessians.begin(),
+                                                       scratch.begin(),
+                                                       true,
+                                                       true,
+                                                       false);
+      double error = 0;
+      for (unsigned int q = 0; q < n_q_points; ++q)
+        error = std::max(error, max_difference(values[q], values_ref[q]));
+      for (unsigned int q = 0; q < dim * n_q_points; ++q)
+        error =
+          std::max(error, max_difference(gradients[q], gradients_ref[q]));
+
+      // the integration might work in-place on the quadrature data, so start
+      // from a copy of the reference data
+      values    = values_ref;
+      gradients = gradients_ref;
+      SelectEvaluator<dim, -1, 0, 1, Number>::integrate(shape_info,
+                                                        dofs_out.begin(),
+                                                        values.begin(),
+                                                        gradients.begin(),
+                                                        scratch.begin(),
+                                                        true,
+                                                        true,
+                                                        false);
+      for (unsigned int i = 0; i < n_dofs; ++i)
+        error = std::max(error, max_difference(dofs_out[i], dofs_ref[i]));
+
+      deallog << " " << k << (error < 1e-12 ? " ok" : " wrong");
+    }
+  deallog << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  for (unsigned int degree = 1; degree < 5; ++degree)
+    for (unsigned int n_q_points_1d = degree + 1;
+         n_q_points_1d < degree + 3;
+         ++n_q_points_1d)
+      {
+        test<2>(degree, n_q_points_1d);
+        test<3>(degree, n_q_points_1d);
+      }
+}
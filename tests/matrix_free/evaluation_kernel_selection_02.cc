@@ -0,0 +1,152 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check MatrixFree::AdditionalData::tune_evaluation_kernels in parallel:
+// all MPI ranks must select the same sum factorization kernel for the run
+// time degree evaluators, and a Laplace operator evaluated with the selected
+// kernel must give the same result as with the default kernel
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/distributed/shared_tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+void
+local_apply(const MatrixFree<dim, double> &                   data,
+            LinearAlgebra::distributed::Vector<double> &      dst,
+            const LinearAlgebra::distributed::Vector<double> &src,
+            const std::pair<unsigned int, unsigned int> &     cell_range)
+{
+  FEEvaluation<dim, -1, 0, 1, double> phi(data);
+  for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi.reinit(cell);
+      phi.read_dof_values(src);
+      phi.evaluate(true, true);
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+        {
+          phi.submit_value(phi.get_value(q), q);
+          phi.submit_gradient(phi.get_gradient(q), q);
+        }
+      phi.integrate(true, true);
+      phi.distribute_local_to_global(dst);
+    }
+}
+
+
+
+template <int dim>
+void
+test(const unsigned int degree, const unsigned int n_q_points_1d)
+{
+  parallel::shared::Triangulation<dim> tria(
+    MPI_COMM_WORLD,
+    Triangulation<dim>::none,
+    false,
+    parallel::shared::Triangulation<dim>::partition_zorder);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(5 - dim);
+
+  const FE_Q<dim> fe(degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  IndexSet locally_relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs(dof, locally_relevant_dofs);
+  AffineConstraints<double> constraints;
+  constraints.reinit(locally_relevant_dofs);
+  VectorTools::interpolate_boundary_values(dof,
+                                           0,
+                                           Functions::ZeroFunction<dim>(),
+                                           constraints);
+  constraints.close();
+
+  LinearAlgebra::distributed::Vector<double> src, dst[2];
+  for (unsigned int tune = 0; tune < 2; ++tune)
+    {
+      typename MatrixFree<dim, double>::AdditionalData additional_data;
+      additional_data.tune_evaluation_kernels = tune;
+      MatrixFree<dim, double> matrix_free;
+      matrix_free.reinit(dof,
+                         constraints,
+                         QGauss<1>(n_q_points_1d),
+                         additional_data);
+
+      if (tune == 0)
+        {
+          matrix_free.initialize_dof_vector(src);
+          for (unsigned int i = 0; i < src.local_size(); ++i)
+            src.local_element(i) = random_value<double>();
+        }
+      else
+        {
+          const unsigned int kernel =
+            matrix_free.get_shape_info().evaluation_kernel;
+          deallog << "Testing " << fe.get_name() << " with " << n_q_points_1d
+                  << " points: kernel "
+                  << (Utilities::MPI::min(kernel, MPI_COMM_WORLD) ==
+                          Utilities::MPI::max(kernel, MPI_COMM_WORLD) ?
+                        "agrees on all ranks" :
+                        "differs between ranks")
+                  << std::endl;
+        }
+
+      matrix_free.initialize_dof_vector(dst[tune]);
+      matrix_free.cell_loop(&local_apply<dim>, dst[tune], src);
+    }
+
+  dst[1] -= dst[0];
+  const double error = dst[1].linfty_norm() / dst[0].linfty_norm();
+  deallog << "Error vs. default kernel: " << (error < 1e-12 ? "ok" : "wrong")
+          << std::endl;
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  mpi_initlog();
+
+  for (unsigned int degree = 1; degree < 5; degree += 3)
+    for (unsigned int n_q_points_1d = degree + 1; n_q_points_1d < degree + 3;
+         ++n_q_points_1d)
+      {
+        test<2>(degree, n_q_points_1d);
+        test<3>(degree, n_q_points_1d);
+      }
+}
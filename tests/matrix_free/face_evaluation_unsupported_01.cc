@@ -0,0 +1,88 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that FEFaceEvaluation throws ExcNotImplemented for the elements
+// whose cell evaluation uses the kernels for bubble functions or for a
+// truncated tensor product basis, which have no face counterpart, while
+// FE_Q is accepted
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_dgp.h>
+#include <deal.II/fe/fe_dgp_monomial.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_q_bubbles.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+test(const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(1);
+
+  MappingQGeneric<dim> mapping(1);
+  DoFHandler<dim>      dof(tria);
+  dof.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  typename MatrixFree<dim, double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none;
+  data.mapping_update_flags_inner_faces    = update_values;
+  data.mapping_update_flags_boundary_faces = update_values;
+
+  MatrixFree<dim, double> matrix_free;
+  matrix_free.reinit(mapping, dof, constraints, QGauss<1>(fe.degree + 1), data);
+
+  deallog << "Testing " << fe.get_name() << ": ";
+  try
+    {
+      FEFaceEvaluation<dim, -1> phi(matrix_free, true);
+      deallog << "OK" << std::endl;
+    }
+  catch (ExceptionBase &e)
+    {
+      deallog << e.get_exc_name() << std::endl;
+    }
+}
+
+
+
+int
+main()
+{
+  deal_II_exceptions::disable_abort_on_exception();
+  initlog();
+
+  test<2>(FE_Q<2>(2));
+  test<2>(FE_Q_Bubbles<2>(2));
+  test<2>(FE_DGP<2>(2));
+  test<2>(FE_DGPMonomial<2>(2));
+}
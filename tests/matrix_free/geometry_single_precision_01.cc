@@ -0,0 +1,138 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that a double-precision operator on a MatrixFree object with
+// MatrixFree::AdditionalData::store_geometry_in_single_precision set gives
+// the same result as the one with the geometry in double precision up to
+// the accuracy of single precision, on a mesh with both affine and deformed
+// cells, and that the memory for the geometry data is reduced
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include "../tests.h"
+
+
+template <int dim, int fe_degree>
+void
+helmholtz_operator(
+  const MatrixFree<dim, double> &                   data,
+  LinearAlgebra::distributed::Vector<double> &      dst,
+  const LinearAlgebra::distributed::Vector<double> &src,
+  const std::pair<unsigned int, unsigned int> &     cell_range)
+{
+  FEEvaluation<dim, fe_degree> phi(data);
+  for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi.reinit(cell);
+      phi.gather_evaluate(src, true, true);
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+        {
+          phi.submit_value(phi.get_value(q), q);
+          phi.submit_gradient(phi.get_gradient(q), q);
+        }
+      phi.integrate_scatter(true, true, dst);
+    }
+}
+
+
+
+template <int dim, int fe_degree>
+void
+test()
+{
+  // a ball has deformed cells at the boundary and affine cells in the
+  // interior
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.refine_global(4 - dim);
+
+  FE_Q<dim>       fe(fe_degree);
+  MappingQ<dim>   mapping(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  typename MatrixFree<dim, double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none;
+  data.mapping_update_flags  = update_values | update_gradients;
+
+  MatrixFree<dim, double> mf_double, mf_float;
+  mf_double.reinit(mapping, dof, constraints, QGauss<1>(fe_degree + 1), data);
+  data.store_geometry_in_single_precision = true;
+  mf_float.reinit(mapping, dof, constraints, QGauss<1>(fe_degree + 1), data);
+
+  LinearAlgebra::distributed::Vector<double> src, dst_double, dst_float;
+  mf_double.initialize_dof_vector(src);
+  mf_double.initialize_dof_vector(dst_double);
+  mf_float.initialize_dof_vector(dst_float);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = random_value<double>();
+
+  mf_double.cell_loop(&helmholtz_operator<dim, fe_degree>,
+                      dst_double,
+                      src,
+                      true);
+  mf_float.cell_loop(&helmholtz_operator<dim, fe_degree>, dst_float, src, true);
+
+  dst_float -= dst_double;
+  const double relative_difference =
+    dst_float.linfty_norm() / dst_double.linfty_norm();
+  deallog << "Relative difference in the order of single precision: "
+          << (relative_difference < 1e-5 && relative_difference > 0. ? "yes" :
+                                                                       "no")
+          << std::endl;
+
+  deallog << "Memory for cell geometry reduced: "
+          << (mf_float.get_mapping_info().cell_data[0].memory_consumption() <
+                  0.6 * mf_double.get_mapping_info()
+                          .cell_data[0]
+                          .memory_consumption() ?
+                "yes" :
+                "no")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2, 2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3, 2>();
+  deallog.pop();
+}
@@ -0,0 +1,138 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that copies of an FEEvaluation object made with the copy constructor
+// and the copy assignment operator keep the geometry of the current cell
+// batch after the original has been destroyed, both with the geometry
+// stored in double precision and with
+// MatrixFree::AdditionalData::store_geometry_in_single_precision, where the
+// geometry is converted into buffers of the FEEvaluation object
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <memory>
+
+#include "../tests.h"
+
+
+template <int dim, int fe_degree>
+bool
+check_copies(const MatrixFree<dim, double> &matrix_free)
+{
+  using Evaluator = FEEvaluation<dim, fe_degree>;
+
+  bool all_equal = true;
+  for (unsigned int cell = 0; cell < matrix_free.n_macro_cells(); ++cell)
+    {
+      auto original = std::make_unique<Evaluator>(matrix_free);
+      original->reinit(cell);
+
+      std::vector<VectorizedArray<double>>                 JxW;
+      std::vector<Tensor<2, dim, VectorizedArray<double>>> inverse_jacobians;
+      for (unsigned int q = 0; q < original->n_q_points; ++q)
+        {
+          JxW.push_back(original->JxW(q));
+          inverse_jacobians.push_back(original->inverse_jacobian(q));
+        }
+
+      Evaluator copy(*original);
+      Evaluator assigned(matrix_free);
+      assigned.reinit((cell + 1) % matrix_free.n_macro_cells());
+      assigned = *original;
+      original.reset();
+
+      for (unsigned int q = 0; q < copy.n_q_points; ++q)
+        for (unsigned int v = 0; v < VectorizedArray<double>::n_array_elements;
+             ++v)
+          {
+            if (copy.JxW(q)[v] != JxW[q][v] || assigned.JxW(q)[v] != JxW[q][v])
+              all_equal = false;
+            for (unsigned int d = 0; d < dim; ++d)
+              for (unsigned int e = 0; e < dim; ++e)
+                if (copy.inverse_jacobian(q)[d][e][v] !=
+                      inverse_jacobians[q][d][e][v] ||
+                    assigned.inverse_jacobian(q)[d][e][v] !=
+                      inverse_jacobians[q][d][e][v])
+                  all_equal = false;
+          }
+    }
+  return all_equal;
+}
+
+
+
+template <int dim, int fe_degree>
+void
+test()
+{
+  // a ball has deformed cells at the boundary and affine cells in the
+  // interior
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.refine_global(4 - dim);
+
+  FE_Q<dim>       fe(fe_degree);
+  MappingQ<dim>   mapping(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  typename MatrixFree<dim, double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none;
+  data.mapping_update_flags  = update_values | update_gradients;
+
+  MatrixFree<dim, double> mf_double, mf_float;
+  mf_double.reinit(mapping, dof, constraints, QGauss<1>(fe_degree + 1), data);
+  data.store_geometry_in_single_precision = true;
+  mf_float.reinit(mapping, dof, constraints, QGauss<1>(fe_degree + 1), data);
+
+  deallog << "Copies keep geometry in double precision: "
+          << (check_copies<dim, fe_degree>(mf_double) ? "yes" : "no")
+          << std::endl;
+  deallog << "Copies keep geometry in single precision: "
+          << (check_copies<dim, fe_degree>(mf_float) ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2, 2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3, 2>();
+  deallog.pop();
+}
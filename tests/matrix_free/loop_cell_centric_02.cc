@@ -0,0 +1,338 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// like loop_cell_centric_01, but in parallel where the exterior side of the
+// faces at the processor boundaries is a ghost cell. Furthermore, the
+// exterior FEFaceEvaluation objects are set up on a temporary object and
+// handed over by the copy constructor and the copy assignment operator,
+// which must not refer to the geometry data of the destroyed temporary.
+
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/distributed/shared_tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_dgq.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include "../tests.h"
+
+
+template <int dim>
+Point<dim>
+deform(const Point<dim> &p)
+{
+  Point<dim> q = p;
+  for (unsigned int d = 0; d < dim; ++d)
+    q[d] += 0.05 * std::sin(numbers::PI * p[(d + 1) % dim]) *
+            std::sin(2. * numbers::PI * p[d]);
+  return q;
+}
+
+
+
+template <int dim, int fe_degree>
+class LaplaceOperator
+{
+public:
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+  LaplaceOperator(const MatrixFree<dim, double> &data)
+    : data(data)
+  {}
+
+  void
+  vmult_face_loop(VectorType &dst, const VectorType &src) const
+  {
+    data.loop(&LaplaceOperator::local_cell,
+              &LaplaceOperator::local_face,
+              &LaplaceOperator::local_boundary,
+              this,
+              dst,
+              src,
+              true);
+  }
+
+  void
+  vmult_cell_centric(VectorType &dst, const VectorType &src) const
+  {
+    data.loop_cell_centric(&LaplaceOperator::local_cell_centric,
+                           this,
+                           dst,
+                           src,
+                           true);
+  }
+
+private:
+  VectorizedArray<double>
+  penalty(const FEFaceEvaluation<dim, fe_degree> &phi_m,
+          const FEFaceEvaluation<dim, fe_degree> &phi_p) const
+  {
+    return 0.5 * (fe_degree + 1.) * (fe_degree + 1.) *
+           (std::abs((phi_m.get_normal_vector(0) *
+                      phi_m.inverse_jacobian(0))[dim - 1]) +
+            std::abs((phi_m.get_normal_vector(0) *
+                      phi_p.inverse_jacobian(0))[dim - 1]));
+  }
+
+  void
+  local_cell(const MatrixFree<dim, double> &              data,
+             VectorType &                                 dst,
+             const VectorType &                           src,
+             const std::pair<unsigned int, unsigned int> &cell_range) const
+  {
+    FEEvaluation<dim, fe_degree> phi(data);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+      {
+        phi.reinit(cell);
+        phi.gather_evaluate(src, false, true);
+        for (unsigned int q = 0; q < phi.n_q_points; ++q)
+          phi.submit_gradient(phi.get_gradient(q), q);
+        phi.integrate_scatter(false, true, dst);
+      }
+  }
+
+  void
+  local_face(const MatrixFree<dim, double> &              data,
+             VectorType &                                 dst,
+             const VectorType &                           src,
+             const std::pair<unsigned int, unsigned int> &face_range) const
+  {
+    FEFaceEvaluation<dim, fe_degree> phi_m(data, true);
+    FEFaceEvaluation<dim, fe_degree> phi_p(data, false);
+    for (unsigned int face = face_range.first; face < face_range.second; ++face)
+      {
+        phi_m.reinit(face);
+        phi_p.reinit(face);
+        phi_m.gather_evaluate(src, true, true);
+        phi_p.gather_evaluate(src, true, true);
+        const VectorizedArray<double> sigma = penalty(phi_m, phi_p);
+        for (unsigned int q = 0; q < phi_m.n_q_points; ++q)
+          {
+            const VectorizedArray<double> jump =
+              phi_m.get_value(q) - phi_p.get_value(q);
+            const VectorizedArray<double> flux =
+              sigma * jump - 0.5 * (phi_m.get_normal_derivative(q) +
+                                    phi_p.get_normal_derivative(q));
+            phi_m.submit_normal_derivative(-0.5 * jump, q);
+            phi_p.submit_normal_derivative(-0.5 * jump, q);
+            phi_m.submit_value(flux, q);
+            phi_p.submit_value(-flux, q);
+          }
+        phi_m.integrate_scatter(true, true, dst);
+        phi_p.integrate_scatter(true, true, dst);
+      }
+  }
+
+  void
+  local_boundary(const MatrixFree<dim, double> &              data,
+                 VectorType &                                 dst,
+                 const VectorType &                           src,
+                 const std::pair<unsigned int, unsigned int> &face_range) const
+  {
+    FEFaceEvaluation<dim, fe_degree> phi_m(data, true);
+    for (unsigned int face = face_range.first; face < face_range.second; ++face)
+      {
+        phi_m.reinit(face);
+        phi_m.gather_evaluate(src, true, true);
+        const VectorizedArray<double> sigma = penalty(phi_m, phi_m);
+        for (unsigned int q = 0; q < phi_m.n_q_points; ++q)
+          {
+            const VectorizedArray<double> jump = 2. * phi_m.get_value(q);
+            const VectorizedArray<double> flux =
+              sigma * jump - phi_m.get_normal_derivative(q);
+            phi_m.submit_normal_derivative(-0.5 * jump, q);
+            phi_m.submit_value(flux, q);
+          }
+        phi_m.integrate_scatter(true, true, dst);
+      }
+  }
+
+  void
+  local_cell_centric(
+    const MatrixFree<dim, double> &              data,
+    VectorType &                                 dst,
+    const VectorType &                           src,
+    const std::pair<unsigned int, unsigned int> &cell_range) const
+  {
+    FEEvaluation<dim, fe_degree>     phi(data);
+    FEFaceEvaluation<dim, fe_degree> phi_m(data, true);
+    FEFaceEvaluation<dim, fe_degree> phi_p(data, false);
+    AlignedVector<VectorizedArray<double>> cell_values(phi.dofs_per_cell);
+    AlignedVector<VectorizedArray<double>> result(phi.dofs_per_cell);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+      {
+        phi.reinit(cell);
+        phi.read_dof_values(src);
+        for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+          cell_values[i] = phi.begin_dof_values()[i];
+        phi.evaluate(false, true);
+        for (unsigned int q = 0; q < phi.n_q_points; ++q)
+          phi.submit_gradient(phi.get_gradient(q), q);
+        phi.integrate(false, true);
+        for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+          result[i] = phi.begin_dof_values()[i];
+
+        for (unsigned int face = 0; face < GeometryInfo<dim>::faces_per_cell;
+             ++face)
+          {
+            const std::array<types::boundary_id,
+                             VectorizedArray<double>::n_array_elements>
+              boundary_ids = data.get_faces_by_cells_boundary_id(cell, face);
+
+            phi_m.reinit(cell, face);
+            phi_m.evaluate(cell_values.begin(), true, true);
+
+            // set up the exterior side on a temporary object and copy it
+            // into phi_p, by the copy assignment operator on even faces and
+            // by the copy constructor on odd faces
+            std::unique_ptr<FEFaceEvaluation<dim, fe_degree>> phi_p_copy;
+            {
+              FEFaceEvaluation<dim, fe_degree> phi_tmp(data, false);
+              phi_tmp.reinit(cell, face);
+              if (face % 2 == 0)
+                phi_p = phi_tmp;
+              else
+                phi_p_copy =
+                  std_cxx14::make_unique<FEFaceEvaluation<dim, fe_degree>>(
+                    phi_tmp);
+            }
+            FEFaceEvaluation<dim, fe_degree> &phi_ext =
+              face % 2 == 0 ? phi_p : *phi_p_copy;
+            phi_ext.gather_evaluate(src, true, true);
+
+            VectorizedArray<double> at_boundary = 0.;
+            for (unsigned int v = 0;
+                 v < VectorizedArray<double>::n_array_elements;
+                 ++v)
+              if (boundary_ids[v] != numbers::invalid_boundary_id)
+                at_boundary[v] = 1.;
+            const VectorizedArray<double> sigma =
+              penalty(phi_m, phi_ext) * (1. - at_boundary) +
+              penalty(phi_m, phi_m) * at_boundary;
+
+            for (unsigned int q = 0; q < phi_m.n_q_points; ++q)
+              {
+                const VectorizedArray<double> value_p =
+                  phi_ext.get_value(q) - at_boundary * phi_m.get_value(q);
+                const VectorizedArray<double> normal_derivative_p =
+                  phi_ext.get_normal_derivative(q) +
+                  at_boundary * phi_m.get_normal_derivative(q);
+                const VectorizedArray<double> jump =
+                  phi_m.get_value(q) - value_p;
+                const VectorizedArray<double> flux =
+                  sigma * jump - 0.5 * (phi_m.get_normal_derivative(q) +
+                                        normal_derivative_p);
+                phi_m.submit_normal_derivative(-0.5 * jump, q);
+                phi_m.submit_value(flux, q);
+              }
+            phi_m.integrate(true, true);
+            for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+              result[i] += phi_m.begin_dof_values()[i];
+          }
+
+        for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+          phi.begin_dof_values()[i] = result[i];
+        phi.set_dof_values(dst);
+      }
+  }
+
+  const MatrixFree<dim, double> &data;
+};
+
+
+
+template <int dim, int fe_degree>
+void
+test(const bool deform_mesh)
+{
+  parallel::shared::Triangulation<dim> tria(
+    MPI_COMM_WORLD,
+    Triangulation<dim>::none,
+    false,
+    parallel::shared::Triangulation<dim>::partition_zorder);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(5 - dim);
+  if (deform_mesh)
+    GridTools::transform(&deform<dim>, tria);
+
+  FE_DGQ<dim>     fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  typename MatrixFree<dim, double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none;
+  data.mapping_update_flags  = update_gradients | update_JxW_values;
+  data.mapping_update_flags_inner_faces =
+    update_JxW_values | update_normal_vectors | update_jacobians;
+  data.mapping_update_flags_boundary_faces =
+    update_JxW_values | update_normal_vectors | update_jacobians;
+  data.mapping_update_flags_faces_by_cells =
+    update_JxW_values | update_normal_vectors | update_jacobians;
+  data.hold_all_faces_to_owned_cells = true;
+
+  MatrixFree<dim, double> mf_data;
+  mf_data.reinit(dof, constraints, QGauss<1>(fe_degree + 1), data);
+
+  LinearAlgebra::distributed::Vector<double> src, dst_face, dst_cell;
+  mf_data.initialize_dof_vector(src);
+  mf_data.initialize_dof_vector(dst_face);
+  mf_data.initialize_dof_vector(dst_cell);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = random_value<double>();
+
+  LaplaceOperator<dim, fe_degree> laplace(mf_data);
+  laplace.vmult_face_loop(dst_face, src);
+  laplace.vmult_cell_centric(dst_cell, src);
+
+  dst_cell -= dst_face;
+  deallog << (deform_mesh ? "Deformed mesh" : "Affine mesh")
+          << ", cell-centric loop agrees with face loop: "
+          << (dst_cell.linfty_norm() < 1e-12 * dst_face.linfty_norm() ?
+                "true" :
+                "false")
+          << std::endl;
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  mpi_initlog();
+
+  deallog.push("2d");
+  test<2, 2>(false);
+  test<2, 2>(true);
+  deallog.pop();
+  deallog.push("3d");
+  test<3, 2>(false);
+  test<3, 2>(true);
+  deallog.pop();
+}
@@ -0,0 +1,160 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that MatrixFree::renumber_dofs interleaves the degrees of freedom of
+// DG elements such that all full cell batches use the interleaved contiguous
+// storage starting at a multiple of the vectorization length, also when
+// vectorization categories create partially filled batches in the middle of
+// the cell range, and that a mass operator is not affected by the
+// renumbering
+
+#include <deal.II/base/function_lib.h>
+#include <deal.II/base/quadrature_lib.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_dgq.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim, int fe_degree>
+void
+mass_operator(const MatrixFree<dim, double> &                   data,
+              LinearAlgebra::distributed::Vector<double> &      dst,
+              const LinearAlgebra::distributed::Vector<double> &src,
+              const std::pair<unsigned int, unsigned int> &     cell_range)
+{
+  FEEvaluation<dim, fe_degree> phi(data);
+  for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi.reinit(cell);
+      phi.gather_evaluate(src, true, false);
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+        phi.submit_value(phi.get_value(q), q);
+      phi.integrate_scatter(true, false, dst);
+    }
+}
+
+
+
+template <int dim, int fe_degree>
+double
+apply_mass_operator(const DoFHandler<dim> &dof, MatrixFree<dim, double> &data)
+{
+  LinearAlgebra::distributed::Vector<double> src, dst;
+  data.initialize_dof_vector(src);
+  data.initialize_dof_vector(dst);
+  VectorTools::interpolate(dof, Functions::CosineFunction<dim>(), src);
+
+  data.cell_loop(&mass_operator<dim, fe_degree>, dst, src, true);
+  return dst.l2_norm();
+}
+
+
+
+template <int dim>
+void
+test()
+{
+  constexpr unsigned int fe_degree = 2;
+  Triangulation<dim>     tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(3);
+
+  FE_DGQ<dim>     fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  typename MatrixFree<dim, double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none;
+  data.cell_vectorization_category.resize(tria.n_active_cells());
+  for (const auto &cell : tria.active_cell_iterators())
+    data.cell_vectorization_category[cell->active_cell_index()] =
+      cell->active_cell_index() % 3;
+  data.cell_vectorization_categories_strict = true;
+
+  MatrixFree<dim, double> mf_data;
+  const QGauss<1>         quad(fe_degree + 1);
+  mf_data.reinit(dof, constraints, quad, data);
+  const double norm_original =
+    apply_mass_operator<dim, fe_degree>(dof, mf_data);
+
+  std::vector<types::global_dof_index> renumbering;
+  mf_data.renumber_dofs(renumbering);
+  dof.renumber_dofs(renumbering);
+  mf_data.reinit(dof, constraints, quad, data);
+
+  constexpr unsigned int n_lanes = VectorizedArray<double>::n_array_elements;
+  const internal::MatrixFreeFunctions::DoFInfo &dof_info =
+    mf_data.get_dof_info();
+  const auto cell = internal::MatrixFreeFunctions::DoFInfo::dof_access_cell;
+  bool       interleaved = true, aligned = true;
+  for (unsigned int batch = 0; batch < mf_data.n_macro_cells(); ++batch)
+    if (dof_info.n_vectorization_lanes_filled[cell][batch] == n_lanes)
+      {
+        if (dof_info.index_storage_variants[cell][batch] !=
+            internal::MatrixFreeFunctions::DoFInfo::IndexStorageVariants::
+              interleaved_contiguous)
+          interleaved = false;
+        else if (dof_info.dof_indices_contiguous[cell][batch * n_lanes] %
+                   n_lanes !=
+                 0)
+          aligned = false;
+      }
+  deallog << "Full batches interleaved: " << (interleaved ? "true" : "false")
+          << std::endl;
+  deallog << "Full batches aligned: " << (aligned ? "true" : "false")
+          << std::endl;
+
+  const double norm_renumbered =
+    apply_mass_operator<dim, fe_degree>(dof, mf_data);
+  deallog << "Mass operator unchanged: "
+          << (std::abs(norm_original - norm_renumbered) <
+                  1e-12 * norm_original ?
+                "true" :
+                "false")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
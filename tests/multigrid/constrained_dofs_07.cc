@@ -0,0 +1,148 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the boundary and refinement edge indices of MGConstrainedDoFs and the
+// level sparsity patterns of MGTools::make_sparsity_pattern() on an
+// adaptively refined mesh against a straight-forward computation over all
+// level cells, and check that the setup is recorded in the sections of a
+// TimerOutput object. The finer levels have enough cells to be split into
+// several chunks that are worked on in parallel.
+
+#include <deal.II/base/timer.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/multigrid/mg_tools.h>
+
+#include <set>
+#include <vector>
+
+#include "../tests.h"
+
+
+template <int dim>
+void
+check(const FiniteElement<dim> &fe, const ComponentMask &component_mask)
+{
+  Triangulation<dim> tria(
+    Triangulation<dim>::limit_level_difference_at_vertices);
+  GridGenerator::hyper_cube(tria, 0., 1., true);
+  tria.refine_global(dim == 2 ? 4 : 3);
+  for (unsigned int cycle = 0; cycle < 2; ++cycle)
+    {
+      tria.begin_active()->set_refine_flag();
+      tria.execute_coarsening_and_refinement();
+    }
+
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  dof.distribute_mg_dofs();
+
+  TimerOutput timer(deallog.get_file_stream(),
+                    TimerOutput::never,
+                    TimerOutput::wall_times);
+
+  MGConstrainedDoFs mg_constrained_dofs;
+  mg_constrained_dofs.initialize(dof, &timer);
+  mg_constrained_dofs.make_zero_boundary_constraints(dof,
+                                                     {0, 2},
+                                                     component_mask,
+                                                     &timer);
+
+  deallog << "Testing " << fe.get_name() << std::endl;
+  for (unsigned int level = 0; level < tria.n_levels(); ++level)
+    {
+      std::set<types::global_dof_index> boundary_dofs, refinement_edge_dofs;
+      std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+      DynamicSparsityPattern dsp_reference(dof.n_dofs(level));
+      for (auto cell = dof.begin(level); cell != dof.end(level); ++cell)
+        {
+          cell->get_mg_dof_indices(dof_indices);
+          for (const types::global_dof_index i : dof_indices)
+            for (const types::global_dof_index j : dof_indices)
+              dsp_reference.add(i, j);
+          for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+            for (unsigned int j = 0; j < fe.dofs_per_face; ++j)
+              {
+                const unsigned int i = fe.face_to_cell_index(j, f);
+                if (cell->at_boundary(f))
+                  {
+                    if ((cell->face(f)->boundary_id() == 0 ||
+                         cell->face(f)->boundary_id() == 2) &&
+                        component_mask[fe.system_to_component_index(i).first])
+                      boundary_dofs.insert(dof_indices[i]);
+                  }
+                else if (cell->neighbor(f)->level() < cell->level())
+                  refinement_edge_dofs.insert(dof_indices[i]);
+              }
+        }
+
+      IndexSet boundary_reference(dof.n_dofs(level));
+      boundary_reference.add_indices(boundary_dofs.begin(),
+                                     boundary_dofs.end());
+      IndexSet refinement_edge_reference(dof.n_dofs(level));
+      refinement_edge_reference.add_indices(refinement_edge_dofs.begin(),
+                                            refinement_edge_dofs.end());
+
+      DynamicSparsityPattern dsp(dof.n_dofs(level));
+      MGTools::make_sparsity_pattern(dof, dsp, level);
+      SparsityPattern sparsity, sparsity_reference;
+      sparsity.copy_from(dsp);
+      sparsity_reference.copy_from(dsp_reference);
+
+      deallog << "Level " << level << ": boundary dofs "
+              << (mg_constrained_dofs.get_boundary_indices(level) ==
+                      boundary_reference ?
+                    "ok" :
+                    "wrong")
+              << ", refinement edge dofs "
+              << (mg_constrained_dofs.get_refinement_edge_indices(level) ==
+                      refinement_edge_reference ?
+                    "ok" :
+                    "wrong")
+              << ", sparsity pattern "
+              << (sparsity == sparsity_reference ? "ok" : "wrong")
+              << std::endl;
+    }
+
+  for (const auto &section :
+       timer.get_summary_data(TimerOutput::total_wall_time))
+    deallog << "Timer section: " << section.first << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  check<2>(FE_Q<2>(2), ComponentMask());
+  check<2>(FESystem<2>(FE_Q<2>(1), 2),
+           ComponentMask(std::vector<bool>{false, true}));
+  check<3>(FE_Q<3>(1), ComponentMask());
+}
@@ -0,0 +1,197 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check PreconditionFastDiagonalization on Cartesian meshes with
+// anisotropic cells where the patch operators are exact: for a vertex patch
+// covering all free degrees of freedom of a FE_Q discretization of the
+// Laplacian, the smoother is the exact inverse, and for cell patches of a
+// FE_DGQ discretization with only a mass term, the smoother is the inverse
+// mass matrix
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+
+#include <deal.II/matrix_free/operators.h>
+
+#include <deal.II/multigrid/mg_fast_diagonalization.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+void
+create_mesh(Triangulation<dim> &tria, const unsigned int n_refinements)
+{
+  Point<dim> p2;
+  for (unsigned int d = 0; d < dim; ++d)
+    p2[d] = 2. / (d + 1);
+  GridGenerator::hyper_rectangle(tria, Point<dim>(), p2);
+  tria.refine_global(n_refinements);
+}
+
+
+
+template <typename OperatorType, typename PreconditionerType>
+double
+compute_error(const OperatorType &             op,
+              const PreconditionerType &       preconditioner,
+              const AffineConstraints<double> &constraints)
+{
+  LinearAlgebra::distributed::Vector<double> rhs, solution, result;
+  op.get_matrix_free()->initialize_dof_vector(rhs);
+  solution.reinit(rhs);
+  result.reinit(rhs);
+  for (unsigned int i = 0; i < rhs.local_size(); ++i)
+    if (!constraints.is_constrained(i))
+      rhs.local_element(i) = random_value<double>();
+
+  preconditioner.vmult(solution, rhs);
+  op.vmult(result, solution);
+
+  double error = 0;
+  for (unsigned int i = 0; i < rhs.local_size(); ++i)
+    if (!constraints.is_constrained(i))
+      error = std::max(error,
+                       std::abs(result.local_element(i) -
+                                rhs.local_element(i)));
+  return error / rhs.linfty_norm();
+}
+
+
+
+template <int dim, int fe_degree>
+void
+test_vertex_patch()
+{
+  Triangulation<dim> tria;
+  create_mesh(tria, 1);
+
+  FE_Q<dim>       fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  VectorTools::interpolate_boundary_values(dof,
+                                           0,
+                                           Functions::ZeroFunction<dim>(),
+                                           constraints);
+  constraints.close();
+
+  std::shared_ptr<MatrixFree<dim, double>> matrix_free(
+    new MatrixFree<dim, double>());
+  matrix_free->reinit(dof, constraints, QGauss<1>(fe_degree + 1));
+
+  MatrixFreeOperators::LaplaceOperator<
+    dim,
+    fe_degree,
+    fe_degree + 1,
+    1,
+    LinearAlgebra::distributed::Vector<double>>
+    laplace;
+  laplace.initialize(matrix_free);
+
+  using Smoother = PreconditionFastDiagonalization<dim, fe_degree, double>;
+  Smoother                          smoother;
+  typename Smoother::AdditionalData data;
+  data.patch_type = Smoother::vertex_patch;
+  smoother.initialize(laplace, data);
+
+  deallog << "Testing " << fe.get_name() << " on " << smoother.n_patches()
+          << " vertex patch(es)" << std::endl;
+  const double error = compute_error(laplace, smoother, constraints);
+  deallog << "Error Laplace inverse: " << (error < 1e-10 ? "ok" : "wrong")
+          << std::endl;
+}
+
+
+
+template <int dim, int fe_degree>
+void
+test_cell_patch()
+{
+  Triangulation<dim> tria;
+  create_mesh(tria, 2);
+
+  FE_DGQ<dim>     fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  std::shared_ptr<MatrixFree<dim, double>> matrix_free(
+    new MatrixFree<dim, double>());
+  matrix_free->reinit(dof, constraints, QGauss<1>(fe_degree + 1));
+
+  MatrixFreeOperators::MassOperator<dim,
+                                    fe_degree,
+                                    fe_degree + 1,
+                                    1,
+                                    LinearAlgebra::distributed::Vector<double>>
+    mass;
+  mass.initialize(matrix_free);
+
+  using Smoother = PreconditionFastDiagonalization<dim, fe_degree, double>;
+  Smoother                          smoother;
+  typename Smoother::AdditionalData data;
+  data.patch_type          = Smoother::cell_patch;
+  data.laplace_coefficient = 0.;
+  data.mass_coefficient    = 1.;
+  smoother.initialize(mass, data);
+
+  deallog << "Testing " << fe.get_name() << " on cell patches" << std::endl;
+  const double error = compute_error(mass, smoother, constraints);
+  deallog << "Error mass inverse: " << (error < 1e-10 ? "ok" : "wrong")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  {
+    deallog.push("2d");
+    test_vertex_patch<2, 1>();
+    test_vertex_patch<2, 2>();
+    test_vertex_patch<2, 3>();
+    test_cell_patch<2, 1>();
+    test_cell_patch<2, 3>();
+    deallog.pop();
+  }
+  {
+    deallog.push("3d");
+    test_vertex_patch<3, 1>();
+    test_vertex_patch<3, 2>();
+    test_cell_patch<3, 2>();
+    deallog.pop();
+  }
+}
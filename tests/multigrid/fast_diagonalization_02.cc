@@ -0,0 +1,414 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check PreconditionFastDiagonalization on graded Cartesian meshes against
+// the inverses of assembled matrices: for vertex patches, the sum of the
+// inverses of the global Laplace plus mass matrix restricted to the
+// unconstrained interior degrees of freedom of many colored patches, some of
+// which contain constrained degrees of freedom, and for cell patches, the
+// inverses of the cell blocks of the symmetric interior penalty method.
+// Finally, check that the cell patches give the same result on a mesh with
+// both Cartesian and deformed cells when the geometry is computed on the fly.
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <deal.II/multigrid/mg_fast_diagonalization.h>
+
+#include <deal.II/numerics/matrix_tools.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+void
+create_mesh(Triangulation<dim> &tria, const unsigned int n_cells_per_direction)
+{
+  // cells of different sizes such that many cells have different Jacobians
+  const std::vector<double> steps =
+    n_cells_per_direction == 8 ?
+      std::vector<double>{0.1, 0.15, 0.125, 0.075, 0.175, 0.1, 0.15, 0.125} :
+      std::vector<double>{0.3, 0.2, 0.35, 0.15};
+  AssertDimension(steps.size(), n_cells_per_direction);
+
+  std::vector<std::vector<double>> step_sizes(dim);
+  Point<dim>                       p2;
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      p2[d] = 2. / (d + 1);
+      for (const double step : steps)
+        step_sizes[d].push_back(step * p2[d]);
+    }
+  GridGenerator::subdivided_hyper_rectangle(tria, step_sizes, Point<dim>(), p2);
+}
+
+
+
+template <int dim, int fe_degree>
+void
+test_vertex_patch(const unsigned int n_cells_per_direction)
+{
+  Triangulation<dim> tria;
+  create_mesh(tria, n_cells_per_direction);
+
+  FE_Q<dim>       fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  // besides the boundary values, constrain the degrees of freedom on every
+  // third vertex, which get excluded from the patches around them
+  AffineConstraints<double> constraints;
+  VectorTools::interpolate_boundary_values(dof,
+                                           0,
+                                           Functions::ZeroFunction<dim>(),
+                                           constraints);
+  if (fe_degree > 1)
+    for (const auto &cell : dof.active_cell_iterators())
+      for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+        if (cell->vertex_index(v) % 3 == 0 &&
+            !constraints.is_constrained(cell->vertex_dof_index(v, 0)))
+          constraints.add_line(cell->vertex_dof_index(v, 0));
+  constraints.close();
+
+  std::shared_ptr<MatrixFree<dim, double>> matrix_free(
+    new MatrixFree<dim, double>());
+  matrix_free->reinit(dof, constraints, QGauss<1>(fe_degree + 1));
+
+  using Smoother = PreconditionFastDiagonalization<dim, fe_degree, double>;
+  Smoother                          smoother;
+  typename Smoother::AdditionalData data;
+  data.patch_type       = Smoother::vertex_patch;
+  data.relaxation       = 0.5;
+  data.mass_coefficient = 0.5;
+  smoother.initialize(
+    std::shared_ptr<const MatrixFree<dim, double>>(matrix_free), data);
+
+  deallog << "Testing " << fe.get_name() << " on " << smoother.n_patches()
+          << " vertex patch(es)" << std::endl;
+
+  LinearAlgebra::distributed::Vector<double> src, dst, reference;
+  matrix_free->initialize_dof_vector(src);
+  dst.reinit(src);
+  reference.reinit(src);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    if (!constraints.is_constrained(i))
+      src.local_element(i) = random_value<double>();
+  smoother.vmult(dst, src);
+
+  // assemble the global matrix without constraints
+  DynamicSparsityPattern dsp(dof.n_dofs());
+  DoFTools::make_sparsity_pattern(dof, dsp);
+  SparsityPattern sparsity;
+  sparsity.copy_from(dsp);
+  SparseMatrix<double> system_matrix(sparsity), mass_matrix(sparsity);
+  MatrixCreator::create_laplace_matrix(dof,
+                                       QGauss<dim>(fe_degree + 1),
+                                       system_matrix);
+  MatrixCreator::create_mass_matrix(dof,
+                                    QGauss<dim>(fe_degree + 1),
+                                    mass_matrix);
+  system_matrix.add(data.mass_coefficient, mass_matrix);
+
+  std::vector<Point<dim>> support_points(dof.n_dofs());
+  DoFTools::map_dofs_to_support_points(MappingQGeneric<dim>(1),
+                                       dof,
+                                       support_points);
+
+  // the interior degrees of freedom of a patch are the ones with support
+  // points strictly inside the bounding box of the cells around a vertex
+  std::map<unsigned int, std::vector<typename DoFHandler<dim>::cell_iterator>>
+    patch_cells;
+  for (const auto &cell : dof.active_cell_iterators())
+    for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+      patch_cells[cell->vertex_index(v)].push_back(cell);
+
+  std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+  for (const auto &patch : patch_cells)
+    if (patch.second.size() == GeometryInfo<dim>::vertices_per_cell)
+      {
+        Point<dim> lower = patch.second[0]->vertex(0), upper = lower;
+        for (const auto &cell : patch.second)
+          for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell;
+               ++v)
+            for (unsigned int d = 0; d < dim; ++d)
+              {
+                lower[d] = std::min(lower[d], cell->vertex(v)[d]);
+                upper[d] = std::max(upper[d], cell->vertex(v)[d]);
+              }
+
+        std::set<types::global_dof_index> interior_dofs;
+        for (const auto &cell : patch.second)
+          {
+            cell->get_dof_indices(dof_indices);
+            for (const types::global_dof_index i : dof_indices)
+              {
+                bool is_interior = true;
+                for (unsigned int d = 0; d < dim; ++d)
+                  if (support_points[i][d] < lower[d] + 1e-12 ||
+                      support_points[i][d] > upper[d] - 1e-12)
+                    is_interior = false;
+                if (is_interior && !constraints.is_constrained(i))
+                  interior_dofs.insert(i);
+              }
+          }
+
+        if (interior_dofs.empty())
+          continue;
+
+        // the exact inverse of the patch matrix restricted to the
+        // unconstrained degrees of freedom
+        const std::vector<types::global_dof_index> indices(
+          interior_dofs.begin(), interior_dofs.end());
+        FullMatrix<double> patch_matrix(indices.size(), indices.size());
+        Vector<double>     patch_src(indices.size()), patch_dst(indices.size());
+        for (unsigned int i = 0; i < indices.size(); ++i)
+          {
+            for (unsigned int j = 0; j < indices.size(); ++j)
+              patch_matrix(i, j) = system_matrix.el(indices[i], indices[j]);
+            patch_src(i) = src(indices[i]);
+          }
+        patch_matrix.gauss_jordan();
+        patch_matrix.vmult(patch_dst, patch_src);
+        for (unsigned int i = 0; i < indices.size(); ++i)
+          reference(indices[i]) += data.relaxation * patch_dst(i);
+      }
+
+  dst -= reference;
+  const double error = dst.linfty_norm() / reference.linfty_norm();
+  deallog << "Error vs. assembled patch inverses: "
+          << (error < 1e-10 ? "ok" : "wrong") << std::endl;
+}
+
+
+
+template <int dim, int fe_degree>
+void
+test_cell_patch()
+{
+  Triangulation<dim> tria;
+  create_mesh(tria, 4);
+
+  FE_DGQ<dim>     fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  std::shared_ptr<MatrixFree<dim, double>> matrix_free(
+    new MatrixFree<dim, double>());
+  matrix_free->reinit(dof, constraints, QGauss<1>(fe_degree + 1));
+
+  using Smoother = PreconditionFastDiagonalization<dim, fe_degree, double>;
+  Smoother                          smoother;
+  typename Smoother::AdditionalData data;
+  data.patch_type          = Smoother::cell_patch;
+  data.laplace_coefficient = 2.;
+  data.mass_coefficient    = 0.5;
+  smoother.initialize(
+    std::shared_ptr<const MatrixFree<dim, double>>(matrix_free), data);
+
+  deallog << "Testing " << fe.get_name() << " on cell patches" << std::endl;
+
+  LinearAlgebra::distributed::Vector<double> src, dst, reference;
+  matrix_free->initialize_dof_vector(src);
+  dst.reinit(src);
+  reference.reinit(src);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = random_value<double>();
+  smoother.vmult(dst, src);
+
+  // assemble the cell blocks of the symmetric interior penalty method with
+  // the weight 1/2 on all faces and the penalty parameter divided by the
+  // cell extent normal to the face
+  const double penalty = fe_degree * (fe_degree + 1.);
+  FEValues<dim>     fe_values(fe,
+                          QGauss<dim>(fe_degree + 1),
+                          update_values | update_gradients |
+                            update_JxW_values);
+  FEFaceValues<dim> fe_face_values(fe,
+                                   QGauss<dim - 1>(fe_degree + 1),
+                                   update_values | update_gradients |
+                                     update_JxW_values |
+                                     update_normal_vectors);
+  FullMatrix<double> cell_matrix(fe.dofs_per_cell, fe.dofs_per_cell);
+  Vector<double>     cell_src(fe.dofs_per_cell), cell_dst(fe.dofs_per_cell);
+  std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+  for (const auto &cell : dof.active_cell_iterators())
+    {
+      cell_matrix = 0;
+      fe_values.reinit(cell);
+      for (unsigned int q = 0; q < fe_values.n_quadrature_points; ++q)
+        for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+          for (unsigned int j = 0; j < fe.dofs_per_cell; ++j)
+            cell_matrix(i, j) +=
+              (data.laplace_coefficient * fe_values.shape_grad(i, q) *
+                 fe_values.shape_grad(j, q) +
+               data.mass_coefficient * fe_values.shape_value(i, q) *
+                 fe_values.shape_value(j, q)) *
+              fe_values.JxW(q);
+
+      for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+        {
+          fe_face_values.reinit(cell, f);
+          const double sigma =
+            penalty / (cell->vertex(1U << (f / 2))[f / 2] -
+                       cell->vertex(0)[f / 2]);
+          for (unsigned int q = 0; q < fe_face_values.n_quadrature_points;
+               ++q)
+            for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+              for (unsigned int j = 0; j < fe.dofs_per_cell; ++j)
+                cell_matrix(i, j) +=
+                  data.laplace_coefficient *
+                  (sigma * fe_face_values.shape_value(i, q) *
+                     fe_face_values.shape_value(j, q) -
+                   0.5 * (fe_face_values.shape_grad(i, q) *
+                            fe_face_values.normal_vector(q) *
+                            fe_face_values.shape_value(j, q) +
+                          fe_face_values.shape_grad(j, q) *
+                            fe_face_values.normal_vector(q) *
+                            fe_face_values.shape_value(i, q))) *
+                  fe_face_values.JxW(q);
+        }
+
+      cell_matrix.gauss_jordan();
+      cell->get_dof_indices(dof_indices);
+      for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+        cell_src(i) = src(dof_indices[i]);
+      cell_matrix.vmult(cell_dst, cell_src);
+      for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+        reference(dof_indices[i]) = data.relaxation * cell_dst(i);
+    }
+
+  dst -= reference;
+  const double error = dst.linfty_norm() / reference.linfty_norm();
+  deallog << "Error vs. assembled interior penalty cell inverses: "
+          << (error < 1e-10 ? "ok" : "wrong") << std::endl;
+}
+
+
+
+template <int dim, int fe_degree>
+void
+test_cell_patch_geometry_on_the_fly()
+{
+  // move one vertex such that the cells around it are deformed and all
+  // others are Cartesian
+  Triangulation<dim> tria;
+  create_mesh(tria, 4);
+  Point<dim> &vertex =
+    tria.begin_active()->vertex(GeometryInfo<dim>::vertices_per_cell - 1);
+  for (unsigned int d = 0; d < dim; ++d)
+    vertex[d] += 0.02;
+
+  FE_DGQ<dim>     fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  using Smoother = PreconditionFastDiagonalization<dim, fe_degree, double>;
+  typename Smoother::AdditionalData data;
+  data.patch_type = Smoother::cell_patch;
+
+  const MappingQGeneric<dim>                 mapping(1);
+  LinearAlgebra::distributed::Vector<double> src, dst[2];
+  for (unsigned int on_the_fly = 0; on_the_fly < 2; ++on_the_fly)
+    {
+      typename MatrixFree<dim, double>::AdditionalData mf_data;
+      mf_data.compute_geometry_on_the_fly = on_the_fly;
+      std::shared_ptr<MatrixFree<dim, double>> matrix_free(
+        new MatrixFree<dim, double>());
+      matrix_free->reinit(mapping,
+                          dof,
+                          constraints,
+                          QGauss<1>(fe_degree + 1),
+                          mf_data);
+
+      Smoother smoother;
+      smoother.initialize(
+        std::shared_ptr<const MatrixFree<dim, double>>(matrix_free), data);
+
+      if (on_the_fly == 0)
+        {
+          matrix_free->initialize_dof_vector(src);
+          for (unsigned int i = 0; i < src.local_size(); ++i)
+            src.local_element(i) = random_value<double>();
+        }
+      matrix_free->initialize_dof_vector(dst[on_the_fly]);
+      smoother.vmult(dst[on_the_fly], src);
+    }
+
+  deallog << "Testing " << fe.get_name()
+          << " on cell patches with geometry computed on the fly" << std::endl;
+  dst[1] -= dst[0];
+  const double error = dst[1].linfty_norm() / dst[0].linfty_norm();
+  deallog << "Error vs. stored geometry: " << (error < 1e-10 ? "ok" : "wrong")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  {
+    deallog.push("2d");
+    test_vertex_patch<2, 1>(8);
+    test_vertex_patch<2, 2>(8);
+    test_vertex_patch<2, 3>(8);
+    test_cell_patch<2, 1>();
+    test_cell_patch<2, 3>();
+    test_cell_patch_geometry_on_the_fly<2, 2>();
+    deallog.pop();
+  }
+  {
+    deallog.push("3d");
+    test_vertex_patch<3, 1>(4);
+    test_vertex_patch<3, 2>(4);
+    test_cell_patch<3, 2>();
+    test_cell_patch_geometry_on_the_fly<3, 2>();
+    deallog.pop();
+  }
+}
@@ -0,0 +1,425 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check PreconditionFastDiagonalization on meshes that are not Cartesian:
+// on a rotated graded mesh, where the cell extents are not aligned with the
+// coordinate axes, against the inverses of assembled matrices as in
+// fast_diagonalization_02, and on a ball in 2D, where four vertices have
+// three cells around them and at four vertices with four cells, cells of
+// different orientation meet. Only the remaining nine vertices may be used
+// as vertex patches, and the cell sizes must be positive also on the cells
+// whose coordinate directions are rotated against the others.
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <deal.II/multigrid/mg_fast_diagonalization.h>
+
+#include <deal.II/numerics/matrix_tools.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "../tests.h"
+
+
+
+template <int dim>
+Tensor<2, dim>
+get_rotation()
+{
+  // rotation around the z axis, followed by a rotation around the x axis in
+  // 3D
+  Tensor<2, dim> rotation;
+  rotation[0][0] = std::cos(0.3);
+  rotation[0][1] = -std::sin(0.3);
+  rotation[1][0] = std::sin(0.3);
+  rotation[1][1] = std::cos(0.3);
+  if (dim == 3)
+    {
+      rotation[dim - 1][dim - 1] = 1.;
+      Tensor<2, dim> rotation_x;
+      rotation_x[0][0]             = 1.;
+      rotation_x[1][1]             = std::cos(0.2);
+      rotation_x[1][dim - 1]       = -std::sin(0.2);
+      rotation_x[dim - 1][1]       = std::sin(0.2);
+      rotation_x[dim - 1][dim - 1] = std::cos(0.2);
+      rotation                     = rotation_x * rotation;
+    }
+  return rotation;
+}
+
+
+
+template <int dim>
+void
+create_rotated_mesh(Triangulation<dim> &tria)
+{
+  const std::vector<double> steps = {0.3, 0.2, 0.35, 0.15};
+  std::vector<std::vector<double>> step_sizes(dim);
+  Point<dim>                       p2;
+  for (unsigned int d = 0; d < dim; ++d)
+    {
+      p2[d] = 2. / (d + 1);
+      for (const double step : steps)
+        step_sizes[d].push_back(step * p2[d]);
+    }
+  GridGenerator::subdivided_hyper_rectangle(tria, step_sizes, Point<dim>(), p2);
+
+  const Tensor<2, dim> rotation = get_rotation<dim>();
+  GridTools::transform(
+    [&rotation](const Point<dim> &p) { return Point<dim>(rotation * p); },
+    tria);
+}
+
+
+
+template <int dim, int fe_degree>
+void
+test_vertex_patch_rotated()
+{
+  Triangulation<dim> tria;
+  create_rotated_mesh(tria);
+
+  FE_Q<dim>       fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  VectorTools::interpolate_boundary_values(dof,
+                                           0,
+                                           Functions::ZeroFunction<dim>(),
+                                           constraints);
+  constraints.close();
+
+  std::shared_ptr<MatrixFree<dim, double>> matrix_free(
+    new MatrixFree<dim, double>());
+  matrix_free->reinit(dof, constraints, QGauss<1>(fe_degree + 1));
+
+  using Smoother = PreconditionFastDiagonalization<dim, fe_degree, double>;
+  Smoother                          smoother;
+  typename Smoother::AdditionalData data;
+  data.patch_type       = Smoother::vertex_patch;
+  data.relaxation       = 0.5;
+  data.mass_coefficient = 0.5;
+  smoother.initialize(
+    std::shared_ptr<const MatrixFree<dim, double>>(matrix_free), data);
+
+  deallog << "Testing " << fe.get_name() << " on " << smoother.n_patches()
+          << " vertex patch(es) of a rotated mesh" << std::endl;
+
+  LinearAlgebra::distributed::Vector<double> src, dst, reference;
+  matrix_free->initialize_dof_vector(src);
+  dst.reinit(src);
+  reference.reinit(src);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    if (!constraints.is_constrained(i))
+      src.local_element(i) = random_value<double>();
+  smoother.vmult(dst, src);
+
+  DynamicSparsityPattern dsp(dof.n_dofs());
+  DoFTools::make_sparsity_pattern(dof, dsp);
+  SparsityPattern sparsity;
+  sparsity.copy_from(dsp);
+  SparseMatrix<double> system_matrix(sparsity), mass_matrix(sparsity);
+  MatrixCreator::create_laplace_matrix(dof,
+                                       QGauss<dim>(fe_degree + 1),
+                                       system_matrix);
+  MatrixCreator::create_mass_matrix(dof,
+                                    QGauss<dim>(fe_degree + 1),
+                                    mass_matrix);
+  system_matrix.add(data.mass_coefficient, mass_matrix);
+
+  // the interior degrees of freedom of a patch are the ones with support
+  // points strictly inside the bounding box of the cells around a vertex,
+  // computed on the mesh rotated back to the coordinate axes
+  const Tensor<2, dim>    inverse_rotation = transpose(get_rotation<dim>());
+  std::vector<Point<dim>> support_points(dof.n_dofs());
+  DoFTools::map_dofs_to_support_points(MappingQGeneric<dim>(1),
+                                       dof,
+                                       support_points);
+  for (Point<dim> &point : support_points)
+    point = Point<dim>(inverse_rotation * point);
+
+  std::map<unsigned int, std::vector<typename DoFHandler<dim>::cell_iterator>>
+    patch_cells;
+  for (const auto &cell : dof.active_cell_iterators())
+    for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+      patch_cells[cell->vertex_index(v)].push_back(cell);
+
+  std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+  for (const auto &patch : patch_cells)
+    if (patch.second.size() == GeometryInfo<dim>::vertices_per_cell)
+      {
+        Point<dim> lower(inverse_rotation * patch.second[0]->vertex(0));
+        Point<dim> upper = lower;
+        for (const auto &cell : patch.second)
+          for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell;
+               ++v)
+            {
+              const Point<dim> vertex(inverse_rotation * cell->vertex(v));
+              for (unsigned int d = 0; d < dim; ++d)
+                {
+                  lower[d] = std::min(lower[d], vertex[d]);
+                  upper[d] = std::max(upper[d], vertex[d]);
+                }
+            }
+
+        std::set<types::global_dof_index> interior_dofs;
+        for (const auto &cell : patch.second)
+          {
+            cell->get_dof_indices(dof_indices);
+            for (const types::global_dof_index i : dof_indices)
+              {
+                bool is_interior = true;
+                for (unsigned int d = 0; d < dim; ++d)
+                  if (support_points[i][d] < lower[d] + 1e-12 ||
+                      support_points[i][d] > upper[d] - 1e-12)
+                    is_interior = false;
+                if (is_interior && !constraints.is_constrained(i))
+                  interior_dofs.insert(i);
+              }
+          }
+
+        if (interior_dofs.empty())
+          continue;
+
+        const std::vector<types::global_dof_index> indices(
+          interior_dofs.begin(), interior_dofs.end());
+        FullMatrix<double> patch_matrix(indices.size(), indices.size());
+        Vector<double>     patch_src(indices.size()), patch_dst(indices.size());
+        for (unsigned int i = 0; i < indices.size(); ++i)
+          {
+            for (unsigned int j = 0; j < indices.size(); ++j)
+              patch_matrix(i, j) = system_matrix.el(indices[i], indices[j]);
+            patch_src(i) = src(indices[i]);
+          }
+        patch_matrix.gauss_jordan();
+        patch_matrix.vmult(patch_dst, patch_src);
+        for (unsigned int i = 0; i < indices.size(); ++i)
+          reference(indices[i]) += data.relaxation * patch_dst(i);
+      }
+
+  dst -= reference;
+  const double error = dst.linfty_norm() / reference.linfty_norm();
+  deallog << "Error vs. assembled patch inverses: "
+          << (error < 1e-10 ? "ok" : "wrong") << std::endl;
+}
+
+
+
+template <int dim, int fe_degree>
+void
+test_cell_patch_rotated()
+{
+  Triangulation<dim> tria;
+  create_rotated_mesh(tria);
+
+  FE_DGQ<dim>     fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  std::shared_ptr<MatrixFree<dim, double>> matrix_free(
+    new MatrixFree<dim, double>());
+  matrix_free->reinit(dof, constraints, QGauss<1>(fe_degree + 1));
+
+  using Smoother = PreconditionFastDiagonalization<dim, fe_degree, double>;
+  Smoother                          smoother;
+  typename Smoother::AdditionalData data;
+  data.patch_type          = Smoother::cell_patch;
+  data.laplace_coefficient = 2.;
+  data.mass_coefficient    = 0.5;
+  smoother.initialize(
+    std::shared_ptr<const MatrixFree<dim, double>>(matrix_free), data);
+
+  deallog << "Testing " << fe.get_name() << " on cell patches of a rotated mesh"
+          << std::endl;
+
+  LinearAlgebra::distributed::Vector<double> src, dst, reference;
+  matrix_free->initialize_dof_vector(src);
+  dst.reinit(src);
+  reference.reinit(src);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = random_value<double>();
+  smoother.vmult(dst, src);
+
+  // assemble the cell blocks of the symmetric interior penalty method with
+  // the penalty parameter divided by the cell extent normal to the face,
+  // which is the length of the cell edges in that direction
+  const double penalty = fe_degree * (fe_degree + 1.);
+  FEValues<dim>     fe_values(fe,
+                          QGauss<dim>(fe_degree + 1),
+                          update_values | update_gradients |
+                            update_JxW_values);
+  FEFaceValues<dim> fe_face_values(fe,
+                                   QGauss<dim - 1>(fe_degree + 1),
+                                   update_values | update_gradients |
+                                     update_JxW_values |
+                                     update_normal_vectors);
+  FullMatrix<double> cell_matrix(fe.dofs_per_cell, fe.dofs_per_cell);
+  Vector<double>     cell_src(fe.dofs_per_cell), cell_dst(fe.dofs_per_cell);
+  std::vector<types::global_dof_index> dof_indices(fe.dofs_per_cell);
+  for (const auto &cell : dof.active_cell_iterators())
+    {
+      cell_matrix = 0;
+      fe_values.reinit(cell);
+      for (unsigned int q = 0; q < fe_values.n_quadrature_points; ++q)
+        for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+          for (unsigned int j = 0; j < fe.dofs_per_cell; ++j)
+            cell_matrix(i, j) +=
+              (data.laplace_coefficient * fe_values.shape_grad(i, q) *
+                 fe_values.shape_grad(j, q) +
+               data.mass_coefficient * fe_values.shape_value(i, q) *
+                 fe_values.shape_value(j, q)) *
+              fe_values.JxW(q);
+
+      for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+        {
+          fe_face_values.reinit(cell, f);
+          const double sigma =
+            penalty / (cell->vertex(1U << (f / 2)) - cell->vertex(0)).norm();
+          for (unsigned int q = 0; q < fe_face_values.n_quadrature_points;
+               ++q)
+            for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+              for (unsigned int j = 0; j < fe.dofs_per_cell; ++j)
+                cell_matrix(i, j) +=
+                  data.laplace_coefficient *
+                  (sigma * fe_face_values.shape_value(i, q) *
+                     fe_face_values.shape_value(j, q) -
+                   0.5 * (fe_face_values.shape_grad(i, q) *
+                            fe_face_values.normal_vector(q) *
+                            fe_face_values.shape_value(j, q) +
+                          fe_face_values.shape_grad(j, q) *
+                            fe_face_values.normal_vector(q) *
+                            fe_face_values.shape_value(i, q))) *
+                  fe_face_values.JxW(q);
+        }
+
+      cell_matrix.gauss_jordan();
+      cell->get_dof_indices(dof_indices);
+      for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+        cell_src(i) = src(dof_indices[i]);
+      cell_matrix.vmult(cell_dst, cell_src);
+      for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+        reference(dof_indices[i]) = data.relaxation * cell_dst(i);
+    }
+
+  dst -= reference;
+  const double error = dst.linfty_norm() / reference.linfty_norm();
+  deallog << "Error vs. assembled interior penalty cell inverses: "
+          << (error < 1e-10 ? "ok" : "wrong") << std::endl;
+}
+
+
+
+template <int fe_degree>
+void
+test_ball(const FiniteElement<2> &fe)
+{
+  Triangulation<2> tria;
+  GridGenerator::hyper_ball(tria);
+  tria.refine_global(1);
+
+  DoFHandler<2> dof(tria);
+  dof.distribute_dofs(fe);
+
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  std::shared_ptr<MatrixFree<2, double>> matrix_free(
+    new MatrixFree<2, double>());
+  matrix_free->reinit(dof, constraints, QGauss<1>(fe_degree + 1));
+
+  using Smoother = PreconditionFastDiagonalization<2, fe_degree, double>;
+  Smoother                          smoother;
+  typename Smoother::AdditionalData data;
+  data.patch_type       = fe.dofs_per_vertex > 0 ? Smoother::vertex_patch :
+                                                   Smoother::cell_patch;
+  data.relaxation       = 0.5;
+  data.mass_coefficient = 0.5;
+  smoother.initialize(
+    std::shared_ptr<const MatrixFree<2, double>>(matrix_free), data);
+
+  if (fe.dofs_per_vertex > 0)
+    deallog << "Testing " << fe.get_name() << " on " << smoother.n_patches()
+            << " vertex patch(es) of a ball" << std::endl;
+  else
+    deallog << "Testing " << fe.get_name() << " on cell patches of a ball"
+            << std::endl;
+
+  LinearAlgebra::distributed::Vector<double> src, dst;
+  matrix_free->initialize_dof_vector(src);
+  dst.reinit(src);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = random_value<double>();
+  smoother.vmult(dst, src);
+
+  // the sum of the inverses of positive definite patch matrices must be
+  // positive semi-definite
+  const double product = src * dst;
+  deallog << "Positive energy: "
+          << (std::isfinite(product) && product > 0 ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  {
+    deallog.push("2d");
+    test_vertex_patch_rotated<2, 1>();
+    test_vertex_patch_rotated<2, 2>();
+    test_cell_patch_rotated<2, 2>();
+    test_ball<2>(FE_Q<2>(2));
+    test_ball<2>(FE_DGQ<2>(2));
+    deallog.pop();
+  }
+  {
+    deallog.push("3d");
+    test_vertex_patch_rotated<3, 2>();
+    test_cell_patch_rotated<3, 2>();
+    deallog.pop();
+  }
+}
@@ -0,0 +1,216 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check MGLevelAgglomeration, MGAgglomeratedLevelMatrix and
+// MGTransferAgglomeration: moving level vectors to the agglomerated
+// distribution and back must reproduce the original vector, the assembled
+// level matrices must agree with the matrix-free Laplace operator, and the
+// transfer must agree with MGTransferMatrixFree
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+#include <deal.II/matrix_free/tools.h>
+
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/multigrid/mg_transfer_agglomeration.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+
+#include "../tests.h"
+
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+
+template <typename FEEvaluationType>
+void
+local_laplace(FEEvaluationType &phi)
+{
+  phi.evaluate(false, true);
+  for (unsigned int q = 0; q < phi.n_q_points; ++q)
+    phi.submit_gradient(phi.get_gradient(q), q);
+  phi.integrate(false, true);
+}
+
+
+
+template <int dim, int fe_degree>
+void
+test()
+{
+  parallel::distributed::Triangulation<dim> tria(
+    MPI_COMM_WORLD,
+    Triangulation<dim>::limit_level_difference_at_vertices,
+    parallel::distributed::Triangulation<dim>::construct_multigrid_hierarchy);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(6 - dim);
+
+  FE_Q<dim>       fe(fe_degree);
+  DoFHandler<dim> dof(tria);
+  dof.distribute_dofs(fe);
+  dof.distribute_mg_dofs();
+
+  MGConstrainedDoFs mg_constrained_dofs;
+  mg_constrained_dofs.initialize(dof);
+  mg_constrained_dofs.make_zero_boundary_constraints(dof, {0});
+
+  const unsigned int max_level = tria.n_global_levels() - 1;
+  MGLevelObject<std::shared_ptr<MatrixFree<dim, double>>> matrix_free(
+    0, max_level);
+  MGLevelObject<MatrixFreeOperators::
+                  LaplaceOperator<dim, fe_degree, fe_degree + 1, 1, VectorType>>
+    laplace(0, max_level);
+  MGLevelObject<std::shared_ptr<const Utilities::MPI::Partitioner>>
+    partitioners(0, max_level);
+  for (unsigned int level = 0; level <= max_level; ++level)
+    {
+      IndexSet relevant_dofs;
+      DoFTools::extract_locally_relevant_level_dofs(dof, level, relevant_dofs);
+      AffineConstraints<double> level_constraints;
+      level_constraints.reinit(relevant_dofs);
+      level_constraints.add_lines(
+        mg_constrained_dofs.get_boundary_indices(level));
+      level_constraints.close();
+
+      typename MatrixFree<dim, double>::AdditionalData data;
+      data.level_mg_handler = level;
+      matrix_free[level].reset(new MatrixFree<dim, double>());
+      matrix_free[level]->reinit(dof,
+                                 level_constraints,
+                                 QGauss<1>(fe_degree + 1),
+                                 data);
+      laplace[level].initialize(matrix_free[level], mg_constrained_dofs, level);
+      partitioners[level] = matrix_free[level]->get_vector_partitioner();
+    }
+
+  // agglomerate as soon as there are fewer than 16 cells per process,
+  // halving the number of processes in each step
+  MGLevelAgglomeration agglomeration;
+  agglomeration.initialize(dof,
+                           partitioners,
+                           MGLevelAgglomeration::AdditionalData(2, 16));
+
+  MGTransferMatrixFree<dim, double> transfer(mg_constrained_dofs);
+  transfer.build(dof);
+  MGTransferAgglomeration<dim, double> transfer_agglomeration(transfer,
+                                                              agglomeration);
+
+  deallog << "Testing " << fe.get_name() << std::endl;
+  for (unsigned int level = 0; level <= max_level; ++level)
+    {
+      deallog << "Level " << level << ": "
+              << agglomeration.n_active_processes(level)
+              << " active process(es)" << std::endl;
+
+      // gather and scatter a random vector
+      VectorType original, agglomerated, result;
+      matrix_free[level]->initialize_dof_vector(original);
+      result.reinit(original);
+      for (unsigned int i = 0; i < original.local_size(); ++i)
+        original.local_element(i) = random_value<double>();
+      agglomeration.initialize_dof_vector(level, agglomerated);
+      agglomeration.gather(level, agglomerated, original);
+      agglomeration.scatter(level, result, agglomerated);
+      result -= original;
+      deallog << "Error gather/scatter: "
+              << (result.linfty_norm() < 1e-14 ? "ok" : "wrong") << std::endl;
+
+      // compare the assembled matrix with the matrix-free operator
+      Table<3, VectorizedArray<double>> cell_matrices;
+      MatrixFreeTools::compute_cell_matrices<dim,
+                                             fe_degree,
+                                             fe_degree + 1,
+                                             1,
+                                             double,
+                                             VectorizedArray<double>>(
+        *matrix_free[level],
+        cell_matrices,
+        local_laplace<FEEvaluation<dim, fe_degree, fe_degree + 1, 1, double>>);
+      MGAgglomeratedLevelMatrix<double> matrix;
+      matrix.reinit(agglomeration, level, *matrix_free[level], cell_matrices);
+
+      VectorType reference, agglomerated_result;
+      reference.reinit(original);
+      laplace[level].vmult(reference, original);
+      agglomeration.initialize_dof_vector(level, agglomerated_result);
+      matrix.vmult(agglomerated_result, agglomerated);
+      agglomeration.scatter(level, result, agglomerated_result);
+      result -= reference;
+      deallog << "Error matrix: "
+              << (result.linfty_norm() < 1e-12 * reference.linfty_norm() ?
+                    "ok" :
+                    "wrong")
+              << std::endl;
+
+      if (level == 0)
+        continue;
+
+      // compare the transfer from the next coarser level
+      VectorType coarse_original, coarse_agglomerated;
+      matrix_free[level - 1]->initialize_dof_vector(coarse_original);
+      for (unsigned int i = 0; i < coarse_original.local_size(); ++i)
+        coarse_original.local_element(i) = random_value<double>();
+      agglomeration.initialize_dof_vector(level - 1, coarse_agglomerated);
+      agglomeration.gather(level - 1, coarse_agglomerated, coarse_original);
+
+      transfer.prolongate(level, reference, coarse_original);
+      transfer_agglomeration.prolongate(level,
+                                        agglomerated_result,
+                                        coarse_agglomerated);
+      agglomeration.scatter(level, result, agglomerated_result);
+      result -= reference;
+      deallog << "Error prolongate: "
+              << (result.linfty_norm() < 1e-12 ? "ok" : "wrong") << std::endl;
+
+      VectorType coarse_reference(coarse_original);
+      transfer.restrict_and_add(level, coarse_reference, original);
+      transfer_agglomeration.restrict_and_add(level,
+                                              coarse_agglomerated,
+                                              agglomerated);
+      agglomeration.scatter(level - 1, coarse_original, coarse_agglomerated);
+      coarse_original -= coarse_reference;
+      deallog << "Error restrict_and_add: "
+              << (coarse_original.linfty_norm() < 1e-12 ? "ok" : "wrong")
+              << std::endl;
+    }
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi(argc, argv, 1);
+  mpi_initlog();
+
+  test<2, 1>();
+  test<2, 2>();
+  test<3, 1>();
+}
@@ -0,0 +1,139 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Check the polynomial transfer of MGTwoLevelTransfer on a mesh with hanging
+// nodes: the prolongation must give the interpolation of the coarse function
+// computed by FETools::interpolate, and the restriction must be its transpose
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_tools.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+template <int dim, typename Number>
+void
+check(const FiniteElement<dim> &fe_fine, const FiniteElement<dim> &fe_coarse)
+{
+  deallog << "Transfer " << fe_coarse.get_name() << " -> "
+          << fe_fine.get_name() << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+  tria.begin_active()->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  DoFHandler<dim> dof_fine(tria), dof_coarse(tria);
+  dof_fine.distribute_dofs(fe_fine);
+  dof_coarse.distribute_dofs(fe_coarse);
+
+  AffineConstraints<double> constraint_fine, constraint_coarse;
+  DoFTools::make_hanging_node_constraints(dof_fine, constraint_fine);
+  DoFTools::make_hanging_node_constraints(dof_coarse, constraint_coarse);
+  if (fe_fine.dofs_per_vertex > 0)
+    VectorTools::interpolate_boundary_values(dof_fine,
+                                             0,
+                                             Functions::ZeroFunction<dim>(),
+                                             constraint_fine);
+  if (fe_coarse.dofs_per_vertex > 0)
+    VectorTools::interpolate_boundary_values(dof_coarse,
+                                             0,
+                                             Functions::ZeroFunction<dim>(),
+                                             constraint_coarse);
+  constraint_fine.close();
+  constraint_coarse.close();
+
+  MGTwoLevelTransfer<dim, Number> transfer;
+  transfer.reinit_polynomial_transfer(dof_fine,
+                                      dof_coarse,
+                                      constraint_fine,
+                                      constraint_coarse);
+
+  LinearAlgebra::distributed::Vector<Number> u_coarse(dof_coarse.n_dofs()),
+    u_fine(dof_fine.n_dofs()), r_coarse(dof_coarse.n_dofs()),
+    r_fine(dof_fine.n_dofs());
+  for (unsigned int i = 0; i < dof_coarse.n_dofs(); ++i)
+    if (!constraint_coarse.is_constrained(i))
+      u_coarse(i) = random_value<Number>();
+  for (unsigned int i = 0; i < dof_fine.n_dofs(); ++i)
+    if (!constraint_fine.is_constrained(i))
+      r_fine(i) = random_value<Number>();
+
+  transfer.prolongate(u_fine, u_coarse);
+  transfer.restrict_and_add(r_coarse, r_fine);
+
+  // reference solution of the interpolation on unconstrained dofs
+  Vector<double> ref_coarse(dof_coarse.n_dofs()), ref_fine(dof_fine.n_dofs());
+  for (unsigned int i = 0; i < dof_coarse.n_dofs(); ++i)
+    ref_coarse(i) = u_coarse(i);
+  constraint_coarse.distribute(ref_coarse);
+  FETools::interpolate(dof_coarse, ref_coarse, dof_fine, ref_fine);
+
+  double error = 0;
+  for (unsigned int i = 0; i < dof_fine.n_dofs(); ++i)
+    if (constraint_fine.is_constrained(i))
+      error = std::max(error, std::abs(double(u_fine(i))));
+    else
+      error = std::max(error, std::abs(u_fine(i) - ref_fine(i)));
+  deallog << "Error prolongation: "
+          << (error < 100 * std::numeric_limits<Number>::epsilon() ? "ok" :
+                                                                     "wrong")
+          << std::endl;
+
+  const double difference = u_fine * r_fine - u_coarse * r_coarse;
+  deallog << "Error restriction as transpose: "
+          << (std::abs(difference) < 1000 *
+                                       std::numeric_limits<Number>::epsilon() *
+                                       std::abs(u_fine * r_fine) ?
+                "ok" :
+                "wrong")
+          << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+
+  check<2, double>(FE_Q<2>(2), FE_Q<2>(1));
+  check<2, double>(FE_Q<2>(4), FE_Q<2>(2));
+  check<2, double>(FE_Q<2>(5), FE_Q<2>(3));
+  check<2, double>(FE_DGQ<2>(3), FE_DGQ<2>(1));
+  check<2, float>(FE_Q<2>(3), FE_Q<2>(1));
+  check<3, double>(FE_Q<3>(2), FE_Q<3>(1));
+  check<3, double>(FE_Q<3>(3), FE_Q<3>(2));
+  check<3, float>(FE_Q<3>(4), FE_Q<3>(2));
+}
@@ -0,0 +1,378 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+// Solve a Poisson problem with FE_Q(4) on a distributed mesh with hanging
+// nodes by a conjugate gradient method preconditioned by polynomial
+// multigrid with the degrees 1, 2, 4 on the levels 1 to 3, using
+// MGTransferGlobalCoarsening within Multigrid and PreconditionMG. Check
+// that copy_to_mg() sets up the level vectors with the layout of the
+// respective DoFHandler, including the coarsest level whose layout is
+// taken from the coarse space of the transfer on the next level, that
+// PreconditionMG::vmult_add() (based on copy_from_mg_add()) adds the result
+// of PreconditionMG::vmult() (based on copy_from_mg()), and that the
+// solution agrees with the one of a Jacobi-preconditioned solver.
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/distributed/shared_tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/tools.h>
+
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_matrix.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_transfer_global_coarsening.h>
+#include <deal.II/multigrid/multigrid.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include "../tests.h"
+
+
+
+// a Laplace operator for the polynomial degrees 1, 2 and 4 selected at run
+// time, such that the operators of all levels have the same type
+template <int dim, typename Number>
+class LaplaceOperator : public Subscriptor
+{
+public:
+  using value_type = Number;
+  using VectorType = LinearAlgebra::distributed::Vector<Number>;
+
+  void
+  reinit(const DoFHandler<dim> &dof_handler,
+         const AffineConstraints<double> &constraints)
+  {
+    degree = dof_handler.get_fe().degree;
+    typename MatrixFree<dim, Number>::AdditionalData additional_data;
+    additional_data.tasks_parallel_scheme =
+      MatrixFree<dim, Number>::AdditionalData::none;
+    matrix_free.reinit(dof_handler,
+                       constraints,
+                       QGauss<1>(degree + 1),
+                       additional_data);
+
+    diagonal_inverse = std::make_shared<DiagonalMatrix<VectorType>>();
+    VectorType &diagonal = diagonal_inverse->get_vector();
+    if (degree == 1)
+      MatrixFreeTools::compute_diagonal(
+        matrix_free, diagonal, &LaplaceOperator::do_cell_integral<1>, this);
+    else if (degree == 2)
+      MatrixFreeTools::compute_diagonal(
+        matrix_free, diagonal, &LaplaceOperator::do_cell_integral<2>, this);
+    else if (degree == 4)
+      MatrixFreeTools::compute_diagonal(
+        matrix_free, diagonal, &LaplaceOperator::do_cell_integral<4>, this);
+    else
+      AssertThrow(false, ExcNotImplemented());
+    for (unsigned int i = 0; i < diagonal.local_size(); ++i)
+      diagonal.local_element(i) = Number(1.) / diagonal.local_element(i);
+  }
+
+  void
+  vmult(VectorType &dst, const VectorType &src) const
+  {
+    adjust_ghost_range_if_necessary(src);
+    adjust_ghost_range_if_necessary(dst);
+    if (degree == 1)
+      matrix_free.cell_loop(
+        &LaplaceOperator::local_apply<1>, this, dst, src, true);
+    else if (degree == 2)
+      matrix_free.cell_loop(
+        &LaplaceOperator::local_apply<2>, this, dst, src, true);
+    else
+      matrix_free.cell_loop(
+        &LaplaceOperator::local_apply<4>, this, dst, src, true);
+    for (const unsigned int i : matrix_free.get_constrained_dofs())
+      dst.local_element(i) = src.local_element(i);
+  }
+
+  void
+  Tvmult(VectorType &dst, const VectorType &src) const
+  {
+    vmult(dst, src);
+  }
+
+  types::global_dof_index
+  m() const
+  {
+    return matrix_free.get_vector_partitioner()->size();
+  }
+
+  Number
+  el(const types::global_dof_index row,
+     const types::global_dof_index col) const
+  {
+    AssertDimension(row, col);
+    return Number(1.) / diagonal_inverse->get_vector()(row);
+  }
+
+  void
+  initialize_dof_vector(VectorType &vec) const
+  {
+    matrix_free.initialize_dof_vector(vec);
+  }
+
+  const std::shared_ptr<DiagonalMatrix<VectorType>> &
+  get_matrix_diagonal_inverse() const
+  {
+    return diagonal_inverse;
+  }
+
+private:
+  template <int fe_degree>
+  void
+  do_cell_integral(
+    FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number> &phi) const
+  {
+    phi.evaluate(false, true);
+    for (unsigned int q = 0; q < phi.n_q_points; ++q)
+      phi.submit_gradient(phi.get_gradient(q), q);
+    phi.integrate(false, true);
+  }
+
+  template <int fe_degree>
+  void
+  local_apply(const MatrixFree<dim, Number> &              data,
+              VectorType &                                 dst,
+              const VectorType &                           src,
+              const std::pair<unsigned int, unsigned int> &cell_range) const
+  {
+    FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number> phi(data);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second;
+         ++cell)
+      {
+        phi.reinit(cell);
+        phi.read_dof_values(src);
+        do_cell_integral(phi);
+        phi.distribute_local_to_global(dst);
+      }
+  }
+
+  // the level vectors of the multigrid hierarchy are set up by the transfer
+  // without the ghost entries needed by the matrix-free loops
+  void
+  adjust_ghost_range_if_necessary(const VectorType &vec) const
+  {
+    if (vec.get_partitioner().get() ==
+        matrix_free.get_vector_partitioner().get())
+      return;
+
+    VectorType copy_vec(vec);
+    const_cast<VectorType &>(vec).reinit(matrix_free.get_vector_partitioner());
+    const_cast<VectorType &>(vec).copy_locally_owned_data_from(copy_vec);
+  }
+
+  unsigned int                                degree;
+  MatrixFree<dim, Number>                     matrix_free;
+  std::shared_ptr<DiagonalMatrix<VectorType>> diagonal_inverse;
+};
+
+
+
+template <int dim>
+void
+test()
+{
+  using VectorType       = LinearAlgebra::distributed::Vector<double>;
+  using LevelMatrixType  = LaplaceOperator<dim, double>;
+  const unsigned int min_level = 1;
+  const unsigned int max_level = 3;
+
+  parallel::shared::Triangulation<dim> tria(
+    MPI_COMM_WORLD,
+    Triangulation<dim>::none,
+    false,
+    parallel::shared::Triangulation<dim>::partition_zorder);
+  GridGenerator::hyper_cube(tria);
+  tria.refine_global(2);
+  for (const auto &cell : tria.active_cell_iterators())
+    if (cell->center()[0] < 0.5 && cell->center()[1] < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  // the polynomial degrees 1, 2, 4 on the levels 1, 2, 3
+  MGLevelObject<DoFHandler<dim>>           dof_handlers(min_level, max_level);
+  MGLevelObject<AffineConstraints<double>> constraints(min_level, max_level);
+  MGLevelObject<LevelMatrixType>           mg_matrices(min_level, max_level);
+  for (unsigned int level = min_level; level <= max_level; ++level)
+    {
+      const FE_Q<dim> fe(1U << (level - min_level));
+      dof_handlers[level].initialize(tria, fe);
+
+      IndexSet locally_relevant_dofs;
+      DoFTools::extract_locally_relevant_dofs(dof_handlers[level],
+                                              locally_relevant_dofs);
+      constraints[level].reinit(locally_relevant_dofs);
+      DoFTools::make_hanging_node_constraints(dof_handlers[level],
+                                              constraints[level]);
+      VectorTools::interpolate_boundary_values(dof_handlers[level],
+                                               0,
+                                               Functions::ZeroFunction<dim>(),
+                                               constraints[level]);
+      constraints[level].close();
+
+      mg_matrices[level].reinit(dof_handlers[level], constraints[level]);
+    }
+  const DoFHandler<dim> &dof_handler = dof_handlers[max_level];
+  deallog << "Number of degrees of freedom: " << dof_handler.n_dofs()
+          << std::endl;
+
+  MGLevelObject<MGTwoLevelTransfer<dim, double>> transfers(min_level,
+                                                           max_level);
+  for (unsigned int level = min_level + 1; level <= max_level; ++level)
+    transfers[level].reinit_polynomial_transfer(dof_handlers[level],
+                                                dof_handlers[level - 1],
+                                                constraints[level],
+                                                constraints[level - 1]);
+  MGTransferGlobalCoarsening<dim, double> mg_transfer(transfers);
+
+  VectorType rhs, solution;
+  mg_matrices[max_level].initialize_dof_vector(rhs);
+  mg_matrices[max_level].initialize_dof_vector(solution);
+  for (unsigned int i = 0; i < rhs.local_size(); ++i)
+    if (!constraints[max_level].is_constrained(
+          rhs.get_partitioner()->local_to_global(i)))
+      rhs.local_element(i) = 1.;
+
+  // the level vectors must have the locally owned degrees of freedom of the
+  // DoFHandler on each level, and the finest level must hold the vector
+  MGLevelObject<VectorType> level_vectors;
+  mg_transfer.copy_to_mg(dof_handler, level_vectors, rhs);
+  bool layout_is_correct = level_vectors.min_level() == min_level &&
+                           level_vectors.max_level() == max_level;
+  for (unsigned int level = min_level; level <= max_level; ++level)
+    layout_is_correct =
+      layout_is_correct &&
+      level_vectors[level].size() == dof_handlers[level].n_dofs() &&
+      level_vectors[level].locally_owned_elements() ==
+        dof_handlers[level].locally_owned_dofs();
+  for (unsigned int i = 0; i < rhs.local_size(); ++i)
+    layout_is_correct = layout_is_correct &&
+                        level_vectors[max_level].local_element(i) ==
+                          rhs.local_element(i);
+  deallog << "Level vectors of copy_to_mg: "
+          << (Utilities::MPI::min(layout_is_correct ? 1U : 0U,
+                                  MPI_COMM_WORLD) == 1U ?
+                "ok" :
+                "wrong")
+          << std::endl;
+
+  using SmootherType = PreconditionChebyshev<LevelMatrixType, VectorType>;
+  MGSmootherPrecondition<LevelMatrixType, SmootherType, VectorType> mg_smoother;
+  MGLevelObject<typename SmootherType::AdditionalData> smoother_data(
+    min_level, max_level);
+  for (unsigned int level = min_level; level <= max_level; ++level)
+    {
+      smoother_data[level].smoothing_range     = 20.;
+      smoother_data[level].degree              = 5;
+      smoother_data[level].eig_cg_n_iterations = 20;
+      smoother_data[level].preconditioner =
+        mg_matrices[level].get_matrix_diagonal_inverse();
+    }
+  mg_smoother.initialize(mg_matrices, smoother_data);
+
+  ReductionControl     coarse_control(1000, 1e-14, 1e-10, false, false);
+  SolverCG<VectorType> coarse_solver(coarse_control);
+  PreconditionIdentity coarse_preconditioner;
+  MGCoarseGridIterativeSolver<VectorType,
+                              SolverCG<VectorType>,
+                              LevelMatrixType,
+                              PreconditionIdentity>
+    mg_coarse(coarse_solver, mg_matrices[min_level], coarse_preconditioner);
+
+  mg::Matrix<VectorType> mg_matrix(mg_matrices);
+  Multigrid<VectorType>  mg(mg_matrix,
+                           mg_coarse,
+                           mg_transfer,
+                           mg_smoother,
+                           mg_smoother,
+                           min_level,
+                           max_level);
+  PreconditionMG<dim, VectorType, MGTransferGlobalCoarsening<dim, double>>
+    preconditioner(dof_handler, mg, mg_transfer);
+
+  {
+    SolverControl        control(100, 1e-12 * rhs.l2_norm(), false, false);
+    SolverCG<VectorType> solver(control);
+    solver.solve(mg_matrices[max_level], solution, rhs, preconditioner);
+    deallog << "Multigrid-preconditioned solver converged in at most 20 "
+            << "iterations: " << (control.last_step() <= 20 ? "yes" : "no")
+            << std::endl;
+  }
+
+  VectorType result, result_add;
+  result.reinit(rhs);
+  result_add.reinit(rhs);
+  preconditioner.vmult(result, rhs);
+  result_add = rhs;
+  preconditioner.vmult_add(result_add, rhs);
+  result_add -= rhs;
+  result_add -= result;
+  deallog << "Error vmult_add vs. vmult: "
+          << (result_add.linfty_norm() < 1e-12 * result.linfty_norm() ?
+                "ok" :
+                "wrong")
+          << std::endl;
+
+  VectorType reference;
+  reference.reinit(rhs);
+  {
+    ReductionControl     control(100000, 1e-20, 1e-14, false, false);
+    SolverCG<VectorType> solver(control);
+    solver.solve(mg_matrices[max_level],
+                 reference,
+                 rhs,
+                 *mg_matrices[max_level].get_matrix_diagonal_inverse());
+  }
+  reference -= solution;
+  deallog << "Error vs. Jacobi-preconditioned solver: "
+          << (reference.linfty_norm() < 1e-6 * solution.linfty_norm() ?
+                "ok" :
+                "wrong")
+          << std::endl;
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+  mpi_initlog();
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
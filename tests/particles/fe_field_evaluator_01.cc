@@ -0,0 +1,177 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that Particles::FEFieldEvaluator reproduces the values and gradients
+// of a quadratic function interpolated with FE_Q(2) at the particle
+// locations
+
+#include <deal.II/base/function.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/dofs/dof_handler.h>
+
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/lac/vector.h>
+
+#include <deal.II/numerics/vector_tools.h>
+
+#include <deal.II/particles/fe_field_evaluator.h>
+#include <deal.II/particles/particle_arrays.h>
+#include <deal.II/particles/particle_handler.h>
+
+#include "../tests.h"
+
+template <int dim>
+class QuadraticFunction : public Function<dim>
+{
+public:
+  virtual double
+  value(const Point<dim> &p, const unsigned int = 0) const override
+  {
+    double result = 1.;
+    for (unsigned int d = 0; d < dim; ++d)
+      result += (d + 1.) * p[d] * p[d] + 0.5 * p[d] * p[(d + 1) % dim];
+    return result;
+  }
+
+  virtual Tensor<1, dim>
+  gradient(const Point<dim> &p, const unsigned int = 0) const override
+  {
+    Tensor<1, dim> result;
+    for (unsigned int d = 0; d < dim; ++d)
+      {
+        result[d] += 2. * (d + 1.) * p[d] + 0.5 * p[(d + 1) % dim];
+        result[(d + 1) % dim] += 0.5 * p[d];
+      }
+    return result;
+  }
+};
+
+
+
+template <int dim>
+void
+test()
+{
+  {
+    parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+
+    Point<dim> upper_right;
+    for (unsigned int d = 0; d < dim; ++d)
+      upper_right[d] = d + 1.;
+    GridGenerator::hyper_rectangle(tr, Point<dim>(), upper_right);
+    tr.refine_global(1);
+    MappingQ<dim> mapping(1);
+
+    FE_Q<dim>       fe(2);
+    DoFHandler<dim> dof_handler(tr);
+    dof_handler.distribute_dofs(fe);
+
+    Vector<double> solution(dof_handler.n_dofs());
+    VectorTools::interpolate(mapping,
+                             dof_handler,
+                             QuadraticFunction<dim>(),
+                             solution);
+
+    Particles::ParticleHandler<dim> particle_handler(tr, mapping, 1 + dim);
+
+    // place particles on a regular lattice that does not coincide with the
+    // cell boundaries
+    const unsigned int n_points_1d = 5;
+    unsigned int       n_points    = 1;
+    for (unsigned int d = 0; d < dim; ++d)
+      n_points *= n_points_1d;
+    for (unsigned int i = 0; i < n_points; ++i)
+      {
+        Point<dim>   position;
+        unsigned int index = i;
+        for (unsigned int d = 0; d < dim; ++d)
+          {
+            position[d] =
+              upper_right[d] * (0.1 + 0.8 * (index % n_points_1d) /
+                                        (n_points_1d - 1.) +
+                                0.01 * d);
+            index /= n_points_1d;
+          }
+
+        const auto cell_and_reference_position =
+          GridTools::find_active_cell_around_point(mapping, tr, position);
+        Particles::Particle<dim> particle(position,
+                                          cell_and_reference_position.second,
+                                          i);
+        particle_handler.insert_particle(particle,
+                                         cell_and_reference_position.first);
+      }
+
+    Particles::FEFieldEvaluator<dim> evaluator(mapping, fe);
+    evaluator.evaluate(dof_handler,
+                       solution,
+                       particle_handler.get_particle_arrays(),
+                       0,
+                       true,
+                       true);
+
+    double value_error = 0., gradient_error = 0.;
+    for (const auto &particle : particle_handler)
+      {
+        const Point<dim> location = particle.get_location();
+        const ArrayView<const double> properties = particle.get_properties();
+        value_error =
+          std::max(value_error,
+                   std::abs(properties[0] -
+                            QuadraticFunction<dim>().value(location)));
+
+        const Tensor<1, dim> gradient =
+          QuadraticFunction<dim>().gradient(location);
+        for (unsigned int d = 0; d < dim; ++d)
+          gradient_error =
+            std::max(gradient_error, std::abs(properties[1 + d] - gradient[d]));
+      }
+
+    deallog << "Number of particles: " << particle_handler.n_global_particles()
+            << std::endl;
+    deallog << "Error in values below tolerance: "
+            << (value_error < 1e-12 ? "true" : "false") << std::endl;
+    deallog << "Error in gradients below tolerance: "
+            << (gradient_error < 1e-12 ? "true" : "false") << std::endl;
+  }
+
+  deallog << "OK" << std::endl;
+}
+
+
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  initlog();
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
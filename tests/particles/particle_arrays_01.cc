@@ -0,0 +1,143 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that Particles::ParticleArrays stores the particles of a particle
+// handler sorted by cells, that changes to the arrays are seen by the
+// particle iterators, and that the cell ranges are updated when particles
+// are removed, also while iterating over the particles
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/particles/particle_arrays.h>
+#include <deal.II/particles/particle_handler.h>
+
+#include "../tests.h"
+
+template <int dim>
+void
+test()
+{
+  {
+    parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+
+    GridGenerator::hyper_cube(tr);
+    tr.refine_global(1);
+    MappingQ<dim> mapping(1);
+
+    Particles::ParticleHandler<dim> particle_handler(tr, mapping, 1);
+
+    std::vector<Point<dim>> positions(4);
+    positions[0][0] = 0.75;
+    positions[0][1] = 0.25;
+    positions[1][0] = 0.25;
+    positions[1][1] = 0.75;
+    positions[2][0] = 0.8;
+    positions[2][1] = 0.3;
+    positions[3][0] = 0.6;
+    positions[3][1] = 0.9;
+
+    for (unsigned int i = 0; i < positions.size(); ++i)
+      {
+        const auto cell_and_reference_position =
+          GridTools::find_active_cell_around_point(mapping, tr, positions[i]);
+        Particles::Particle<dim> particle(positions[i],
+                                          cell_and_reference_position.second,
+                                          i);
+        auto particle_it =
+          particle_handler.insert_particle(particle,
+                                           cell_and_reference_position.first);
+        particle_it->get_properties()[0] = i + 0.5;
+      }
+
+    Particles::ParticleArrays<dim> &particle_arrays =
+      particle_handler.get_particle_arrays();
+
+    const auto print_cell_ranges = [&]() {
+      const Particles::ParticleArrays<dim> &arrays =
+        particle_handler.get_particle_arrays();
+      deallog << "Number of particles: " << arrays.n_particles() << std::endl;
+      for (const auto &cell : tr.active_cell_iterators())
+        deallog << "Cell " << cell->active_cell_index() << ": "
+                << arrays.n_particles_in_cell(cell->active_cell_index())
+                << " particles starting at "
+                << arrays.first_particle_in_cell(cell->active_cell_index())
+                << std::endl;
+    };
+    print_cell_ranges();
+
+    for (unsigned int i = 0; i < particle_arrays.n_particles(); ++i)
+      deallog << "Particle " << particle_arrays.get_ids()[i]
+              << " location: " << particle_arrays.get_locations()[i]
+              << " reference location: "
+              << particle_arrays.get_reference_locations()[i]
+              << " property: " << particle_arrays.get_properties()[i]
+              << std::endl;
+
+    // Move all particles and change their properties
+    for (auto &location : particle_arrays.get_locations())
+      location[0] += 0.1;
+    for (double &property : particle_arrays.get_properties())
+      property *= 2.;
+
+    for (const auto &particle : particle_handler)
+      deallog << "Particle " << particle.get_id()
+              << " location: " << particle.get_location()
+              << " property: " << particle.get_properties()[0] << std::endl;
+
+    // Remove the first particle of the second cell, which keeps the
+    // particles sorted
+    particle_handler.remove_particle(
+      particle_handler.particles_in_cell(std::next(tr.begin_active()))
+        .begin());
+    deallog << "Sorted after removal: "
+            << (particle_arrays.is_sorted() ? "yes" : "no") << std::endl;
+    print_cell_ranges();
+
+    // Remove all particles right of x=0.5 while iterating over them
+    for (auto particle = particle_handler.begin();
+         particle != particle_handler.end();)
+      if (particle->get_location()[0] > 0.5)
+        particle_handler.remove_particle(particle);
+      else
+        ++particle;
+    print_cell_ranges();
+    for (const auto &particle : particle_handler)
+      deallog << "Particle " << particle.get_id()
+              << " location: " << particle.get_location() << std::endl;
+  }
+
+  deallog << "OK" << std::endl;
+}
+
+
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  initlog();
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+}
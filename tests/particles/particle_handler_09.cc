@@ -0,0 +1,139 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the statistics of sort_particles_into_subdomains_and_cells() for
+// particles that stay in their cell, move to a face neighbor, move to a cell
+// that only shares a vertex with their old cell, move far away, and leave
+// the domain
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <deal.II/particles/particle_handler.h>
+
+#include "../tests.h"
+
+template <int dim>
+void
+test()
+{
+  {
+    parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+
+    GridGenerator::hyper_cube(tr);
+    tr.refine_global(2);
+    MappingQ<dim> mapping(1);
+
+    Particles::ParticleHandler<dim> particle_handler(tr, mapping);
+
+    const unsigned int      n_particles = 5;
+    std::vector<Point<dim>> old_positions(n_particles, Point<dim>());
+    std::vector<Point<dim>> new_positions(n_particles, Point<dim>());
+    for (unsigned int i = 0; i < n_particles; ++i)
+      for (unsigned int d = 2; d < dim; ++d)
+        {
+          old_positions[i][d] = 0.1;
+          new_positions[i][d] = 0.1;
+        }
+
+    // stays in its cell
+    old_positions[0][0] = 0.1;
+    old_positions[0][1] = 0.1;
+    new_positions[0][0] = 0.15;
+    new_positions[0][1] = 0.1;
+
+    // moves into the face neighbor in x-direction
+    old_positions[1][0] = 0.2;
+    old_positions[1][1] = 0.1;
+    new_positions[1][0] = 0.3;
+    new_positions[1][1] = 0.1;
+
+    // moves into the cell that shares only a vertex with its old cell
+    old_positions[2][0] = 0.2;
+    old_positions[2][1] = 0.2;
+    new_positions[2][0] = 0.3;
+    new_positions[2][1] = 0.3;
+
+    // moves far away
+    old_positions[3][0] = 0.1;
+    old_positions[3][1] = 0.6;
+    new_positions[3][0] = 0.9;
+    new_positions[3][1] = 0.9;
+
+    // leaves the domain
+    old_positions[4][0] = 0.9;
+    old_positions[4][1] = 0.6;
+    new_positions[4][0] = 1.2;
+    new_positions[4][1] = 0.6;
+
+    for (unsigned int i = 0; i < n_particles; ++i)
+      {
+        const auto cell_and_reference_position =
+          GridTools::find_active_cell_around_point(mapping,
+                                                   tr,
+                                                   old_positions[i]);
+        Particles::Particle<dim> particle(old_positions[i],
+                                          cell_and_reference_position.second,
+                                          i);
+        particle_handler.insert_particle(particle,
+                                         cell_and_reference_position.first);
+      }
+
+    for (auto &particle : particle_handler)
+      particle.set_location(new_positions[particle.get_id()]);
+
+    particle_handler.sort_particles_into_subdomains_and_cells();
+
+    const auto &statistics = particle_handler.get_sorting_statistics();
+    deallog << "In old cell: " << statistics.n_particles_in_old_cell
+            << std::endl;
+    deallog << "In face neighbor: " << statistics.n_particles_in_face_neighbor
+            << std::endl;
+    deallog << "In vertex neighbor: "
+            << statistics.n_particles_in_vertex_neighbor << std::endl;
+    deallog << "Found by global search: "
+            << statistics.n_particles_found_by_global_search << std::endl;
+    deallog << "Lost: " << statistics.n_particles_lost << std::endl;
+
+    for (const auto &particle : particle_handler)
+      deallog << "Particle " << particle.get_id() << " is in cell "
+              << particle.get_surrounding_cell(tr) << std::endl;
+  }
+
+  deallog << "OK" << std::endl;
+}
+
+
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  initlog();
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
@@ -0,0 +1,218 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that sorting particles into cells and exchanging ghost particles
+// gives the same ownership, order, and properties of the particles
+// regardless of the number of threads. Enough particles are created for the
+// threaded loops over particles to be split into several tasks, and some of
+// them leave the domain, such that the search through the whole mesh is run
+// from several threads. Since that search uses the vertex search tree of
+// GridTools::Cache, also check that the tree is only built once and not
+// rebuilt by every access from the threads.
+
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/thread_management.h>
+
+#include <deal.II/distributed/tria.h>
+
+#include <deal.II/fe/mapping_q.h>
+
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools_cache.h>
+
+#include <deal.II/particles/particle_handler.h>
+
+#include "../tests.h"
+
+template <int dim>
+std::string
+move_and_sort_particles(const unsigned int n_threads,
+                        const unsigned int n_particles_per_direction)
+{
+  MultithreadInfo::set_thread_limit(n_threads);
+
+  parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube(tr);
+  tr.refine_global(3);
+  MappingQ<dim> mapping(1);
+
+  Particles::ParticleHandler<dim> particle_handler(tr, mapping, 2);
+
+  // create the particles on a lattice with n_particles_per_direction points
+  // per cell and direction, numbered globally
+  const unsigned int n_cells_per_direction = 8;
+  const unsigned int n_points_per_direction =
+    n_particles_per_direction * n_cells_per_direction;
+  for (const auto &cell : tr.active_cell_iterators())
+    if (cell->is_locally_owned())
+      {
+        unsigned int n_particles_per_cell = 1;
+        for (unsigned int d = 0; d < dim; ++d)
+          n_particles_per_cell *= n_particles_per_direction;
+
+        for (unsigned int q = 0; q < n_particles_per_cell; ++q)
+          {
+            Point<dim>            location, reference_location;
+            types::particle_index id     = 0;
+            types::particle_index stride = 1;
+            unsigned int          index  = q;
+            for (unsigned int d = 0; d < dim; ++d)
+              {
+                const unsigned int q_d = index % n_particles_per_direction;
+                index /= n_particles_per_direction;
+                const unsigned int i_d =
+                  static_cast<unsigned int>(cell->center()[d] *
+                                            n_cells_per_direction) *
+                    n_particles_per_direction +
+                  q_d;
+
+                reference_location[d] =
+                  (q_d + 0.31) / n_particles_per_direction;
+                location[d] = (i_d + 0.31) / n_points_per_direction;
+                id += i_d * stride;
+                stride *= n_points_per_direction;
+              }
+
+            Particles::Particle<dim> particle(location,
+                                              reference_location,
+                                              id);
+            auto particle_it = particle_handler.insert_particle(particle, cell);
+            particle_it->get_properties()[0] = 0.5 * id;
+            particle_it->get_properties()[1] = location[0];
+          }
+      }
+  particle_handler.update_cached_numbers();
+
+  deallog << "Particles before sorting: "
+          << particle_handler.n_global_particles() << std::endl;
+
+  // move all particles, some of them across the boundaries of the
+  // subdomains and some out of the domain
+  Tensor<1, dim> shift;
+  shift[0] = 0.1;
+  shift[1] = 0.05;
+  if (dim == 3)
+    shift[2] = 0.03;
+  for (auto &location : particle_handler.get_particle_arrays().get_locations())
+    location += shift;
+
+  particle_handler.sort_particles_into_subdomains_and_cells();
+  particle_handler.exchange_ghost_particles();
+
+  deallog << "Particles after sorting: "
+          << particle_handler.n_global_particles() << std::endl;
+
+  const auto &statistics = particle_handler.get_sorting_statistics();
+  deallog << "Particles searched in the whole mesh: "
+          << (Utilities::MPI::sum(
+                statistics.n_particles_found_by_global_search +
+                  statistics.n_particles_lost,
+                MPI_COMM_WORLD) > 0 ?
+                "yes" :
+                "no")
+          << std::endl;
+
+  std::ostringstream result;
+  result << std::setprecision(16);
+  const auto print_particle =
+    [&](const Particles::ParticleAccessor<dim> &particle) {
+      result << particle.get_surrounding_cell(tr)->id() << ' '
+             << particle.get_id() << ' ' << particle.get_location() << ' '
+             << particle.get_reference_location() << ' '
+             << particle.get_properties()[0] << ' '
+             << particle.get_properties()[1] << '\n';
+    };
+  for (auto particle = particle_handler.begin();
+       particle != particle_handler.end();
+       ++particle)
+    print_particle(*particle);
+  result << "ghosts\n";
+  for (auto particle = particle_handler.begin_ghost();
+       particle != particle_handler.end_ghost();
+       ++particle)
+    print_particle(*particle);
+
+  return result.str();
+}
+
+
+
+template <int dim>
+void
+check_cache_search_tree()
+{
+  MultithreadInfo::set_thread_limit(4);
+
+  parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube(tr);
+  tr.refine_global(3);
+  MappingQ<dim> mapping(1);
+
+  GridTools::Cache<dim> cache(tr, mapping);
+  const auto *first_vertex = &*cache.get_used_vertices_rtree().begin();
+
+  // access the tree from several tasks at once: once the tree has been
+  // built, the cache must return it without building it again
+  std::vector<Threads::Task<bool>> tasks;
+  for (unsigned int t = 0; t < 4; ++t)
+    tasks.push_back(Threads::new_task([&]() {
+      return &*cache.get_used_vertices_rtree().begin() == first_vertex;
+    }));
+  bool same_tree = true;
+  for (auto &task : tasks)
+    if (task.return_value() == false)
+      same_tree = false;
+
+  deallog << "Search tree of the cache built once: "
+          << (same_tree ? "yes" : "no") << std::endl;
+}
+
+
+
+template <int dim>
+void
+test(const unsigned int n_particles_per_direction)
+{
+  const std::string result_serial =
+    move_and_sort_particles<dim>(1, n_particles_per_direction);
+  const std::string result_threaded =
+    move_and_sort_particles<dim>(4, n_particles_per_direction);
+
+  deallog << "Results with 1 and 4 threads agree: "
+          << (result_serial == result_threaded ? "true" : "false")
+          << std::endl;
+
+  check_cache_search_tree<dim>();
+}
+
+
+
+int
+main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(
+    argc, argv, numbers::invalid_unsigned_int);
+
+  MPILogInitAll all;
+
+  deallog.push("2d");
+  test<2>(4);
+  deallog.pop();
+  deallog.push("3d");
+  test<3>(1);
+  deallog.pop();
+}
@@ -0,0 +1,107 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// test that a property pool hands out contiguous slots, reuses released
+// slots, honors reserve(), and releases unused memory in compact()
+
+#include <deal.II/particles/property_pool.h>
+
+#include <fstream>
+#include <iomanip>
+
+#include "../tests.h"
+
+
+void
+test()
+{
+  {
+    const unsigned int      n_properties = 3;
+    Particles::PropertyPool pool(n_properties);
+
+    pool.reserve(5000);
+    deallog << "Reserved slots: " << pool.n_reserved_slots() << std::endl;
+
+    std::vector<Particles::PropertyPool::Handle> handles;
+    for (unsigned int i = 0; i < 5000; ++i)
+      {
+        handles.push_back(pool.allocate_properties_array());
+        for (unsigned int p = 0; p < n_properties; ++p)
+          pool.get_properties(handles.back())[p] = i + 0.1 * p;
+      }
+
+    // all slots of a reserved block must be adjacent in memory
+    bool contiguous = true;
+    for (unsigned int i = 1; i < handles.size(); ++i)
+      if (handles[i] != handles[i - 1] + n_properties)
+        contiguous = false;
+    deallog << "Contiguous: " << (contiguous ? "true" : "false") << std::endl;
+    deallog << "Reserved slots: " << pool.n_reserved_slots()
+            << ", allocated slots: " << pool.n_allocated_slots() << std::endl;
+
+    // allocating beyond the reserved size adds another chunk
+    handles.push_back(pool.allocate_properties_array());
+    deallog << "Reserved slots: " << pool.n_reserved_slots()
+            << ", allocated slots: " << pool.n_allocated_slots() << std::endl;
+
+    // a released slot is handed out again
+    Particles::PropertyPool::Handle released = handles[17];
+    pool.deallocate_properties_array(released);
+    handles[17] = pool.allocate_properties_array();
+    deallog << "Reused slot: " << (handles[17] == released ? "true" : "false")
+            << std::endl;
+
+    // release the last particle, which empties the second chunk, and every
+    // other particle of the first chunk
+    pool.deallocate_properties_array(handles.back());
+    handles.pop_back();
+    for (unsigned int i = 0; i < handles.size(); i += 2)
+      pool.deallocate_properties_array(handles[i]);
+
+    pool.compact();
+    deallog << "Reserved slots: " << pool.n_reserved_slots()
+            << ", allocated slots: " << pool.n_allocated_slots() << std::endl;
+
+    // the remaining properties are untouched
+    bool unchanged = true;
+    for (unsigned int i = 1; i < handles.size(); i += 2)
+      for (unsigned int p = 0; p < n_properties; ++p)
+        if (pool.get_properties(handles[i])[p] != i + 0.1 * p)
+          unchanged = false;
+    deallog << "Unchanged: " << (unchanged ? "true" : "false") << std::endl;
+
+    // after compaction, the slots with the lowest address are filled first
+    deallog << "Lowest slot first: "
+            << (pool.allocate_properties_array() == handles[0] ? "true" :
+                                                                 "false")
+            << std::endl;
+
+    deallog << "Reserved slots: " << pool.n_reserved_slots()
+            << ", allocated slots: " << pool.n_allocated_slots() << std::endl;
+  }
+
+  deallog << "OK" << std::endl;
+}
+
+
+
+int
+main()
+{
+  initlog();
+  test();
+}
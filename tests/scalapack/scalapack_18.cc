@@ -0,0 +1,144 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2019 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE.md at
+// the top level directory of deal.II.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check MGCoarseGridScaLAPACK for a symmetric and a nonsymmetric
+// tridiagonal operator distributed over all processes by verifying that the
+// residual of the coarse solution vanishes. The smallest size leads to a
+// process grid that only contains some of the processes
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/partitioner.h>
+
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <deal.II/multigrid/mg_coarse_scalapack.h>
+
+#include "../tests.h"
+
+
+using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+
+class TridiagonalOperator : public Subscriptor
+{
+public:
+  TridiagonalOperator(
+    const std::shared_ptr<const Utilities::MPI::Partitioner> &partitioner,
+    const double                                              lower,
+    const double                                              upper)
+    : partitioner(partitioner)
+    , lower(lower)
+    , upper(upper)
+    , ghosted_vector(partitioner)
+  {}
+
+  void
+  vmult(VectorType &dst, const VectorType &src) const
+  {
+    ghosted_vector.copy_locally_owned_data_from(src);
+    ghosted_vector.update_ghost_values();
+    const auto range = partitioner->local_range();
+    for (types::global_dof_index i = range.first; i < range.second; ++i)
+      {
+        double sum = 2.5 * ghosted_vector(i);
+        if (i > 0)
+          sum += lower * ghosted_vector(i - 1);
+        if (i + 1 < partitioner->size())
+          sum += upper * ghosted_vector(i + 1);
+        dst(i) = sum;
+      }
+  }
+
+private:
+  std::shared_ptr<const Utilities::MPI::Partitioner> partitioner;
+  const double                                       lower;
+  const double                                       upper;
+  mutable VectorType                                 ghosted_vector;
+};
+
+
+
+void
+test(const unsigned int size,
+     const unsigned int block_size,
+     const bool         symmetric)
+{
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+  const unsigned int local_size =
+    size / n_procs + (my_rank < size % n_procs ? 1 : 0);
+  const IndexSet owned =
+    Utilities::MPI::create_ascending_partitioning(MPI_COMM_WORLD,
+                                                  local_size)[my_rank];
+  IndexSet ghosts(size);
+  if (owned.n_elements() > 0)
+    {
+      if (owned.nth_index_in_set(0) > 0)
+        ghosts.add_index(owned.nth_index_in_set(0) - 1);
+      if (owned.nth_index_in_set(owned.n_elements() - 1) + 1 < size)
+        ghosts.add_index(owned.nth_index_in_set(owned.n_elements() - 1) + 1);
+    }
+  const auto partitioner =
+    std::make_shared<const Utilities::MPI::Partitioner>(owned,
+                                                        ghosts,
+                                                        MPI_COMM_WORLD);
+
+  const TridiagonalOperator matrix(partitioner,
+                                   symmetric ? -1. : -1.5,
+                                   symmetric ? -1. : -0.5);
+
+  MGCoarseGridScaLAPACK<double> coarse;
+  coarse.initialize(matrix,
+                    partitioner,
+                    MGCoarseGridScaLAPACK<double>::AdditionalData(symmetric,
+                                                                  block_size));
+
+  VectorType rhs(partitioner), solution(partitioner), residual(partitioner);
+  for (unsigned int i = 0; i < rhs.local_size(); ++i)
+    rhs.local_element(i) = random_value<double>();
+
+  // apply twice to check that the setup is reused
+  for (unsigned int repeat = 0; repeat < 2; ++repeat)
+    {
+      coarse(0, solution, rhs);
+      matrix.vmult(residual, solution);
+      residual -= rhs;
+      deallog << "Size " << size << ", block size " << block_size
+              << (symmetric ? ", symmetric" : ", nonsymmetric")
+              << ": residual "
+              << (residual.linfty_norm() < 1e-10 * rhs.linfty_norm() ? "ok" :
+                                                                        "wrong")
+              << std::endl;
+      rhs *= 2.;
+    }
+}
+
+
+
+int
+main(int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi(argc, argv, 1);
+  mpi_initlog();
+
+  test(100, 8, true);
+  test(100, 8, false);
+  test(257, 32, true);
+  test(257, 32, false);
+  test(10, 8, true);
+  test(10, 8, false);
+}